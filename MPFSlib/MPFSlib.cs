@@ -36,6 +36,8 @@
  * Author               Date   		Comment
  *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * Elliott Wood		4/17/2008	    Original
+ * VirtualFab		2026/10/17	    DynIdx.bin hash index of the MDD file records
+ * VirtualFab		2026/10/17	    DynIdx.bin version 2, buckets keyed by nameHash and nameKey
  ********************************************************************/
 using System;
 using System.Collections.Generic;
@@ -60,14 +62,16 @@ namespace Microchip
     {
  	    #region Fields
         public UInt16 nameHash;
+		public UInt32 nameKey;
 		public UInt32 fileRecordOffset;
 		public UInt32 dynVarCntr=0;
 		
         #endregion
  
- 	   public FileRecord(UInt16 nameHash, UInt32 fileRecordOffset,UInt32 dynVarCntr)
+ 	   public FileRecord(UInt16 nameHash, UInt32 nameKey, UInt32 fileRecordOffset,UInt32 dynVarCntr)
  	   {
  		   this.nameHash = nameHash;
+ 		   this.nameKey = nameKey;
  		   this.fileRecordOffset = fileRecordOffset;
 		   this.dynVarCntr = dynVarCntr;
  	   }
@@ -981,6 +985,7 @@ namespace Microchip
             UInt32 counter = 0;
             UInt32 loopCntr = 0;
             UInt32 numFileRecrds = 0;
+            UInt32 dynVarRcrdPos = 0;
 			
 	        FileRecrd = new FilesRecordWriter(localPath);
 			DynVarRecrd = new DynamicVarRecordWriter(localPath);
@@ -995,10 +1000,14 @@ namespace Microchip
 				loopCntr=0;
 	        	if(file.dynVarCntr >0)
 	        	{
+					// Position actually written: fileRecordOffset also counts the
+					// parsed pages that turned out to have no dynamic variables
 					FileRcrdList.Add(new FileRecord ((UInt16)file.nameHash,
-													 (UInt32)file.fileRecordOffset,
+													 file.nameKey,
+													 dynVarRcrdPos,
 													 (UInt32)file.dynVarCntr));
 					numFileRecrds++;
+					dynVarRcrdPos += 4 + 2 + file.dynVarCntr * 8;
 
 		
 					DynVarRecrd.Write((byte)(file.fileRecordLength));
@@ -1080,8 +1089,61 @@ namespace Microchip
 
 			FileRecrd.Close();
 			DynVarRecrd.Close();
-	     
+
+			DynVarIndexWriter(localPath, FileRcrdList);
 	    }
+
+		/// <summary>
+		/// Writes DynIdx.bin, a hash table of the file records, so that the
+		/// HTTP server finds the record of a page reading a single bucket
+		/// instead of scanning FileRcrd.bin.
+		/// Layout (little endian): "DVIX", version, bucket bits, number of
+		/// records, then 2^bits buckets of nameHash (2 bytes), dynVarCntr
+		/// (2 bytes, 0 = empty), the position of the first offset/ID pair
+		/// in DynRcrd.bin (4 bytes) and nameKey (4 bytes). Buckets are chosen
+		/// by HTTP_DYNIDX_BUCKET() in HTTP2_MDD.c, collisions go to the
+		/// following buckets; the server matches both nameHash and nameKey,
+		/// so pages sharing the name hash get their own records.
+		/// </summary>
+		/// <param name="localPath">Folder where FileRcrd.bin was written</param>
+		/// <param name="records">File records sorted by name hash</param>
+		private void DynVarIndexWriter(String localPath, List<FileRecord> records)
+		{
+			byte bits = 2;
+			while ((1 << bits) < records.Count * 2 && bits < 15)
+				bits++;
+			int buckets = 1 << bits;
+			byte[] table = new byte[buckets * 12];
+
+			foreach (FileRecord FR in records)
+			{
+				int bucket = (UInt16)(FR.nameHash * 0x9E37) >> (16 - bits);
+				while ((table[bucket * 12 + 2] | table[bucket * 12 + 3]) != 0)
+					bucket = (bucket + 1) & (buckets - 1);
+
+				UInt32 dynVarRcrdPos = FR.fileRecordOffset + 4 + 2; // skip record length and flags
+				table[bucket * 12 + 0] = (byte)(FR.nameHash);
+				table[bucket * 12 + 1] = (byte)(FR.nameHash >> 8);
+				table[bucket * 12 + 2] = (byte)(FR.dynVarCntr);
+				table[bucket * 12 + 3] = (byte)(FR.dynVarCntr >> 8);
+				table[bucket * 12 + 4] = (byte)(dynVarRcrdPos);
+				table[bucket * 12 + 5] = (byte)(dynVarRcrdPos >> 8);
+				table[bucket * 12 + 6] = (byte)(dynVarRcrdPos >> 16);
+				table[bucket * 12 + 7] = (byte)(dynVarRcrdPos >> 24);
+				table[bucket * 12 + 8] = (byte)(FR.nameKey);
+				table[bucket * 12 + 9] = (byte)(FR.nameKey >> 8);
+				table[bucket * 12 + 10] = (byte)(FR.nameKey >> 16);
+				table[bucket * 12 + 11] = (byte)(FR.nameKey >> 24);
+			}
+
+			BinaryWriter fout = new BinaryWriter(new FileStream(System.IO.Path.Combine(localPath, "DynIdx.bin"), FileMode.Create), Encoding.ASCII);
+			fout.Write(Encoding.ASCII.GetBytes("DVIX"));
+			fout.Write((byte)2);
+			fout.Write(bits);
+			fout.Write((UInt16)records.Count);
+			fout.Write(table);
+			fout.Close();
+		}
         #region Private Methods
         private bool FileMatches(String fileName, Collection<String> endings)
         {
@@ -1356,6 +1418,7 @@ namespace Microchip
         #region Fields
         private String fileName;
         public UInt16 nameHash;
+        public UInt32 nameKey;/*FNV-1a of the name, tells apart the files sharing nameHash*/
 	    public DateTime fileDate;
         public byte[] data;
         public UInt32 locStr;
@@ -1390,6 +1453,7 @@ namespace Microchip
             set 
             {
                 this.fileName = value;
+                this.nameKey = 0x811C9DC5;
                 if(value == "")
                     this.nameHash = 0xffff;
                 else
@@ -1399,6 +1463,7 @@ namespace Microchip
                     {
                         nameHash += b;
                         nameHash <<= 1;
+                        nameKey = (nameKey ^ b) * 0x01000193;
                     }
                 }
             }
@@ -44,6 +44,8 @@
  *              - changes for Graphics Library Version 3.00
  * 07/02/12     Modified PutImageXBPPYYY() functions to use new API.
  * 10/13/12     drvTFT001.c Adaptations for Olimex ILI9320 - PIC32-MAXI-WEB by VirtualFab
+ * 10/17/26     Bar() and ClearDevice() queued for a DMA channel (ILI9320_DMA_CHANNEL)
+ * 10/17/26     PMP interrupt flag off when the DMA queue empties
  *****************************************************************************/
 //#include "Graphics/Graphics.h"
 
@@ -150,6 +152,84 @@ SHORT _colorTransparentEnable;
 	}
 #endif
 
+#ifdef ILI9320_DMA_CHANNEL
+    #if !defined (__PIC32MX__) || !defined (USE_GFX_PMP)
+        #error ILI9320_DMA_CHANNEL needs a PIC32 with the PMP driving the WR line (USE_GFX_PMP)
+    #endif
+    #ifndef ILI9320_QUEUE_SIZE
+        #define ILI9320_QUEUE_SIZE  8       // Commands waiting for the DMA channel
+    #endif
+    #ifndef ILI9320_DMA_BLOCK
+        #define ILI9320_DMA_BLOCK   256     // Pixels written by each DMA block
+    #endif
+    #if (ILI9320_DMA_CHANNEL == 0)
+        #define ILI9320_DMA_VECTOR  _DMA0_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 1)
+        #define ILI9320_DMA_VECTOR  _DMA1_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 2)
+        #define ILI9320_DMA_VECTOR  _DMA2_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 3)
+        #define ILI9320_DMA_VECTOR  _DMA3_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 4)
+        #define ILI9320_DMA_VECTOR  _DMA4_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 5)
+        #define ILI9320_DMA_VECTOR  _DMA5_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 6)
+        #define ILI9320_DMA_VECTOR  _DMA6_VECTOR
+    #elif (ILI9320_DMA_CHANNEL == 7)
+        #define ILI9320_DMA_VECTOR  _DMA7_VECTOR
+    #else
+        #error ILI9320_DMA_CHANNEL must be 0 to 7
+    #endif
+
+// Rectangle filled with one color, written line by line from the GRAM
+// address of each line
+typedef struct {
+    DWORD address;                  // GRAM address of the next line
+    LONG step;                      // GRAM address difference between two lines
+    WORD width;                     // Pixels of a line
+    WORD lines;                     // Lines left
+    WORD pixels;                    // Pixels left in the line being written
+    GFX_COLOR color;                // Fill color
+} QUEUE_COMMAND;
+
+#ifdef USE_16BIT_PMP
+    #define QUEUE_CELL_SIZE 2               // Bytes of each PMP write
+static WORD _queueFill[ILI9320_DMA_BLOCK];
+#else
+    #define QUEUE_CELL_SIZE 1
+static BYTE _queueFill[ILI9320_DMA_BLOCK * 2];
+#endif
+static GFX_COLOR _queueFillColor;           // Color in _queueFill
+static BOOL _queueFillValid = FALSE;
+static QUEUE_COMMAND _queue[ILI9320_QUEUE_SIZE];
+static WORD _queueHead = 0;                 // Command being written
+static volatile WORD _queueCount = 0;       // Commands queued, 0 when the channel is idle
+#endif
+
+/*********************************************************************
+ * Macro:  WaitQueueEmpty()
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: waits for the end of the queued commands, so that the CPU
+ *           does not access the display while the DMA channel writes
+ *
+ * Note: nothing to wait for without ILI9320_DMA_CHANNEL
+ *
+ ********************************************************************/
+#ifdef ILI9320_DMA_CHANNEL
+    #define WaitQueueEmpty()    while (_queueCount);
+#else
+    #define WaitQueueEmpty()
+#endif
+
 /*********************************************************************
  * Function:  void  SetReg(WORD index, WORD value)
  *
@@ -168,6 +248,7 @@ SHORT _colorTransparentEnable;
  *
  ********************************************************************/
 void SetReg(WORD index, WORD value) {
+    WaitQueueEmpty();
 #ifdef USE_16BIT_PMP
     DisplayEnable();
     DisplaySetCommand();
@@ -207,6 +288,7 @@ void SetReg(WORD index, WORD value) {
  ********************************************************************/
 unsigned int GetReg(WORD index) {
     unsigned int value;
+    WaitQueueEmpty();
     while (PMMODEbits.BUSY);
     DisplayEnable();
     DisplaySetCommand();
@@ -424,6 +506,189 @@ void TransparentColorEnable(GFX_COLOR color) {
 #define mCalcAddressXY(x, y) ((DWORD) LINE_MEM_PITCH * (GetMaxX() - x) + y)
 #endif
 
+#ifdef ILI9320_DMA_CHANNEL
+
+// GRAM address difference between a pixel and the one below it
+#if (DISP_ORIENTATION == 0)
+    #define LINE_ADDRESS_STEP   ((LONG) LINE_MEM_PITCH)
+#elif (DISP_ORIENTATION == 90)
+    #define LINE_ADDRESS_STEP   (-1L)
+#elif (DISP_ORIENTATION == 180)
+    #define LINE_ADDRESS_STEP   (-(LONG) LINE_MEM_PITCH)
+#elif (DISP_ORIENTATION == 270)
+    #define LINE_ADDRESS_STEP   (1L)
+#endif
+
+/*********************************************************************
+ * Function: static void QueueNext(void)
+ *
+ * PreCondition: ILI9320 selected, DMA channel idle
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: deselects the ILI9320 and turns the PMP interrupt flag
+ *               off when the queue is empty
+ *
+ * Overview: starts the next DMA block of the command at the head of the
+ *           queue, at most ILI9320_DMA_BLOCK pixels of a line. The GRAM
+ *           address of each line is written by the CPU; the channel then
+ *           writes a cell each time the PMP ends a write cycle. Finished
+ *           commands are removed from the queue.
+ *
+ * Note: called by QueueCommand() and by the DMA interrupt
+ *
+ ********************************************************************/
+static void QueueNext(void) {
+    QUEUE_COMMAND *pCommand;
+    WORD count, i;
+
+    while (_queueCount) {
+        pCommand = &_queue[_queueHead];
+        if (pCommand->pixels == 0) {
+            if (pCommand->lines == 0) {
+                _queueHead = (_queueHead + 1) % ILI9320_QUEUE_SIZE;
+                _queueCount--;
+                continue;
+            }
+
+            // Next line
+            while (PMMODEbits.BUSY);
+            SetAddress(pCommand->address);
+            pCommand->address += pCommand->step;
+            pCommand->pixels = pCommand->width;
+            pCommand->lines--;
+
+            // The block is filled again only when the color changes
+            if (!_queueFillValid || _queueFillColor != pCommand->color) {
+                for (i = 0; i < ILI9320_DMA_BLOCK; i++) {
+#ifdef USE_16BIT_PMP
+                    _queueFill[i] = pCommand->color;
+#else
+                    _queueFill[2 * i] = ((WORD_VAL) pCommand->color).v[1];
+                    _queueFill[2 * i + 1] = ((WORD_VAL) pCommand->color).v[0];
+#endif
+                }
+                _queueFillColor = pCommand->color;
+                _queueFillValid = TRUE;
+            }
+        }
+
+        count = (pCommand->pixels < ILI9320_DMA_BLOCK) ? pCommand->pixels : ILI9320_DMA_BLOCK;
+        pCommand->pixels -= count;
+        while (PMMODEbits.BUSY);
+        INTClearFlag(INT_PMP);
+        DmaChnSetTxfer(ILI9320_DMA_CHANNEL, _queueFill, (void *) &PMDIN, count * 2, QUEUE_CELL_SIZE, QUEUE_CELL_SIZE);
+        DmaChnStartTxfer(ILI9320_DMA_CHANNEL, DMA_WAIT_NOT, 0); // Forces the first write
+        return;
+    }
+
+    // Queue empty
+    while (PMMODEbits.BUSY);
+    PMMODEbits.IRQM = 0; // PMP interrupt flag off again
+    DisplayDisable();
+}
+
+/*********************************************************************
+ * Function: static WORD QueueCommand(QUEUE_COMMAND *pCommand)
+ *
+ * PreCondition: none
+ *
+ * Input: pCommand - command, with pixels 0
+ *
+ * Output: For NON-Blocking configuration:
+ *         - Returns 0 when the queue is full and the command not queued.
+ *         - Returns 1 when the command is queued.
+ *         For Blocking configuration:
+ *         - Waits for room in the queue and always returns 1.
+ *
+ * Side Effects: none
+ *
+ * Overview: adds the command to the queue, starting the DMA channel
+ *           when it is idle. The DMA interrupt is disabled meanwhile,
+ *           so the queue is not changed under it.
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static WORD QueueCommand(QUEUE_COMMAND *pCommand) {
+#ifdef USE_NONBLOCKING_CONFIG
+    if (_queueCount == ILI9320_QUEUE_SIZE)
+        return (0);
+#else
+    while (_queueCount == ILI9320_QUEUE_SIZE);
+#endif
+
+    INTEnable(INT_SOURCE_DMA(ILI9320_DMA_CHANNEL), INT_DISABLED);
+    _queue[(_queueHead + _queueCount) % ILI9320_QUEUE_SIZE] = *pCommand;
+    if (_queueCount++ == 0) {
+        // Channel idle
+        PMMODEbits.IRQM = 1; // PMP interrupt flag at the end of each write cycle
+        DmaChnOpen(ILI9320_DMA_CHANNEL, DMA_CHN_PRI2, DMA_OPEN_DEFAULT);
+        DmaChnSetEventControl(ILI9320_DMA_CHANNEL, DMA_EV_START_IRQ(_PMP_IRQ));
+        DmaChnSetEvEnableFlags(ILI9320_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+        INTSetVectorPriority(INT_VECTOR_DMA(ILI9320_DMA_CHANNEL), INT_PRIORITY_LEVEL_5);
+        INTClearFlag(INT_SOURCE_DMA(ILI9320_DMA_CHANNEL));
+        DisplayEnable();
+        QueueNext();
+    }
+    INTEnable(INT_SOURCE_DMA(ILI9320_DMA_CHANNEL), INT_ENABLED);
+    return (1);
+}
+
+/*********************************************************************
+ * Function: ILI9320QueueHandler()
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: DMA block done interrupt, starts the next block
+ *
+ * Note: none
+ *
+ ********************************************************************/
+void __ISR(ILI9320_DMA_VECTOR, ipl5) ILI9320QueueHandler(void) {
+    DmaChnClrEvFlags(ILI9320_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+    INTClearFlag(INT_SOURCE_DMA(ILI9320_DMA_CHANNEL));
+    QueueNext();
+}
+
+/*********************************************************************
+ * Function: static WORD QueueFill(SHORT left, SHORT top, SHORT right, SHORT bottom)
+ *
+ * PreCondition: rectangle on the screen
+ *
+ * Input: left,top - top left corner coordinates,
+ *        right,bottom - bottom right corner coordinates
+ *
+ * Output: as QueueCommand()
+ *
+ * Side Effects: none
+ *
+ * Overview: queues a rectangle fill with the current color
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static WORD QueueFill(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+    QUEUE_COMMAND command;
+
+    command.address = mCalcAddressXY(left, top);
+    command.step = LINE_ADDRESS_STEP;
+    command.width = right - left + 1;
+    command.lines = bottom - top + 1;
+    command.pixels = 0;
+    command.color = _color;
+    return (QueueCommand(&command));
+}
+#endif // ILI9320_DMA_CHANNEL
+
 /*********************************************************************
  * Function: void PutPixel(SHORT x, SHORT y)
  *
@@ -455,6 +720,7 @@ void PutPixel(SHORT x, SHORT y) {
 
     address = mCalcAddressXY(x, y);
 
+    WaitQueueEmpty();
     DisplayEnable();
     SetAddress(address);
     WritePixel(_color);
@@ -486,6 +752,7 @@ WORD GetPixel(SHORT x, SHORT y) {
     WORD result;
     address = mCalcAddressXY(x, y);
 
+    WaitQueueEmpty();
     DisplayEnable();
 
     SetAddress(address);
@@ -541,6 +808,7 @@ WORD GetPixel(SHORT x, SHORT y) {
 
     address = mCalcAddressXY(x, y);
 
+    WaitQueueEmpty();
     DisplayEnable();
 
     SetAddress(address);
@@ -634,12 +902,15 @@ WORD GetPixel(SHORT x, SHORT y) {
  *
  * Side Effects: none
  *
- * Overview: draws rectangle filled with current color
+ * Overview: draws rectangle filled with current color. With
+ *           ILI9320_DMA_CHANNEL the rectangle is queued for the DMA
+ *           channel; busy then means the queue is full.
  *
  * Note: none
  *
  ********************************************************************/
 WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+#ifndef ILI9320_DMA_CHANNEL
     DWORD address;
     register SHORT x, y;
 
@@ -650,6 +921,7 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
 #else
     if (IsDeviceBusy() != 0)
         return (0);
+#endif
 #endif
     if (_clipRgn) {
         if (left < _clipLeft)
@@ -661,6 +933,20 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
         if (bottom > _clipBottom)
             bottom = _clipBottom;
     }
+
+#ifdef ILI9320_DMA_CHANNEL
+    if (left < 0)
+        left = 0;
+    if (top < 0)
+        top = 0;
+    if (right > GetMaxX())
+        right = GetMaxX();
+    if (bottom > GetMaxY())
+        bottom = GetMaxY();
+    if (left > right || top > bottom)
+        return (1);
+    return (QueueFill(left, top, right, bottom));
+#else
     address = mCalcAddressXY(left, top);
     DisplayEnable();
     for (y = top; y < bottom + 1; y++) {
@@ -681,6 +967,7 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
     DisplayDisable();
 
     return (1);
+#endif // ILI9320_DMA_CHANNEL
 }
 
 /*********************************************************************
@@ -696,10 +983,13 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
  *
  * Overview: clears screen with current color
  *
- * Note: none
+ * Note: queued for the DMA channel with ILI9320_DMA_CHANNEL
  *
  ********************************************************************/
 void ClearDevice(void) {
+#ifdef ILI9320_DMA_CHANNEL
+    while (!QueueFill(0, 0, GetMaxX(), GetMaxY()));
+#else
     DWORD counter;
 
     DisplayEnable();
@@ -709,6 +999,7 @@ void ClearDevice(void) {
     }
 
     DisplayDisable();
+#endif
 }
 
 /*********************************************************************
@@ -725,7 +1016,14 @@ void ClearDevice(void) {
  *
  * Side Effects: none
  *
+ * Note: the number of commands in the DMA queue (ILI9320_DMA_CHANNEL),
+ *       else always 0
+ *
  ********************************************************************/
 WORD IsDeviceBusy(void) {
+#ifdef ILI9320_DMA_CHANNEL
+    return (_queueCount);
+#else
     return (0);
+#endif
 }
@@ -40,6 +40,8 @@
  * 06/26/09		16-bit PMP support
  * 03/11/11     Changes for Graphics Library Version 3.00
  * 10/13/12     drvTFT001.h Adaptations for Olimex ILI9320 - PIC32-MAXI-WEB
+ * 10/17/26     DMA command queue (ILI9320_DMA_CHANNEL)
+ * 10/17/26     GFX_DRV_GETPIXEL
  *****************************************************************************/
 #ifndef _DRVTFT001_H
     #define _DRVTFT001_H
@@ -88,6 +90,30 @@
         #error This driver support 16 BPP color depth only.
     #endif
 
+/*********************************************************************
+* Overview: Command queue on a DMA channel (PIC32 with USE_GFX_PMP).
+*           Define ILI9320_DMA_CHANNEL (0 to 7) in HardwareProfile.h to
+*           enable it. Bar() and ClearDevice() fills are queued: the DMA
+*           interrupt sets the GRAM address of each line and the channel
+*           writes its pixels, while the CPU goes on. IsDeviceBusy()
+*           returns the commands queued. With USE_NONBLOCKING_CONFIG,
+*           Bar() returns 0 while the queue is full; the functions that
+*           use the CPU wait for the queue to empty.
+*           ILI9320_QUEUE_SIZE sets the commands queued (default 8),
+*           ILI9320_DMA_BLOCK the pixels of each DMA block (default 256);
+*           the block must fit the DMA size registers, 255 bytes on
+*           PIC32MX3xx/4xx.
+*********************************************************************/
+//#define ILI9320_DMA_CHANNEL 2
+//#define ILI9320_QUEUE_SIZE  8
+//#define ILI9320_DMA_BLOCK   256
+
+/*********************************************************************
+* Overview: GetPixel() reads the GRAM back, e.g. for SuperGauge
+*           SG_DIAL_CACHE.
+*********************************************************************/
+    #define GFX_DRV_GETPIXEL
+
 /*********************************************************************
 * Function:  void SetReg(WORD index, WORD value);
 *
@@ -86,6 +86,8 @@ static uint8_t  *data_line_even;
 static uint8_t  *data_line_odd;
 static uint8_t  *data_line_scan;
 static uint8_t  use_EPD_type_index;
+static uint16_t partial_y0=0;       //First line driven by the next partial update
+static uint16_t partial_y1=0xFFFF;  //Line after the last one driven by the next partial update
 
 static inline void nothing_frame (void) ;
 /**
@@ -312,7 +314,7 @@ inline void epd_line_data_partial_handle( uint16_t x0,uint16_t x1,uint8_t *previ
  *
  * \note
  * - Mark from (x0,y0) to (x1,y1) as update area to change data
- * - Default use whole area of EPD as update area currently
+ * - Lines out of y0..y1-1 are sent as Nothing lines without reading the images
  *
  * @param x0 (x0,y0) as the left/top coordinates
  * @param x1 (x1,y1) as the right/bottom coordinates
@@ -329,20 +331,18 @@ inline void epd_frame_partial_handle(uint16_t x0,uint16_t x1,uint16_t y0,uint16_
         /* Set charge pump voltage level reduce voltage shift */
         epd_spi_send_byte (0x04, COG_parameters[use_EPD_type_index].voltage_level);
 
-         //Read line data from external array
-        if(_On_EPD_read_handle!=NULL) {
-                _On_EPD_read_handle(previous_image_data_address,previous_line_array,
-                COG_parameters[use_EPD_type_index].horizontal_size);
-                _On_EPD_read_handle(new_image_data_address,new_line_array,
-                COG_parameters[use_EPD_type_index].horizontal_size);
-        }
          //epd_display_line_handle(x0,x1,line_array,stage_no);
 
-       // if(y0<=i && i<y1){
+        if(y0<=i && i<y1 && _On_EPD_read_handle!=NULL){
+            //Read line data from external array
+            _On_EPD_read_handle(previous_image_data_address,previous_line_array,
+            COG_parameters[use_EPD_type_index].horizontal_size);
+            _On_EPD_read_handle(new_image_data_address,new_line_array,
+            COG_parameters[use_EPD_type_index].horizontal_size);
             epd_line_data_partial_handle(x0,x1,previous_line_array,new_line_array);
-      // }else{
-       //     epd_display_line_dummy_handle();
-       // }
+        }else{
+            epd_display_line_dummy_handle();
+        }
 
         previous_image_data_address+=COG_parameters[use_EPD_type_index].horizontal_size;//LINE_SIZE;
         new_image_data_address+=COG_parameters[use_EPD_type_index].horizontal_size;//LINE_SIZE;
@@ -639,7 +639,8 @@ static inline void nothing_frame (void) {
  *
  * \note
  * - Mark from (x0,y0) to (x1,y1) as update area to change data
- * - Default use whole area of EPD as update area currently
+ * - Default use whole area of EPD as update area, EPD_set_partial_lines
+ *   restricts the next update to the lines that changed
  *
  * \param previous_image_memory_address The previous image address of memory
  * \param new_image_memory_address The new image address of memory
@@ -652,16 +653,35 @@ void EPD_image_data_partial_handle (EInt previous_image_memory_address,
 	_On_EPD_read_handle=On_EPD_read_memory;
 
         /* Standard 4 stages driving, update from (0,0) to (horizontal_size*8,vertical_size)  */
+	if(partial_y1>COG_parameters[use_EPD_type_index].vertical_size)
+		partial_y1=COG_parameters[use_EPD_type_index].vertical_size;
 	epd_stage_partial_handle(0,
                              COG_parameters[use_EPD_type_index].horizontal_size*8,
-                             0,
-                             COG_parameters[use_EPD_type_index].vertical_size,
+                             partial_y0,
+                             partial_y1,
                              previous_image_memory_address,new_image_memory_address);
+    partial_y0=0;
+    partial_y1=0xFFFF;
     nothing_frame();
     dummy_line(use_EPD_type_index);
     
 }
 
+/**
+ * \brief Restrict the next partial update to the lines y0..y1-1
+ *
+ * \note The other lines are sent as Nothing lines, so they must be the same
+ * in the previous and the new image. The area is reset to the whole EPD
+ * after the update.
+ *
+ * \param y0 The first line that changed
+ * \param y1 The line after the last one that changed
+ */
+void EPD_set_partial_lines(uint16_t y0,uint16_t y1) {
+	partial_y0=y0;
+	partial_y1=y1;
+}
+
 /**
  * \brief Write image data from memory to EPD by global update
  *
@@ -237,6 +237,8 @@ static uint8_t  *data_line_odd;
 static uint8_t  *data_line_scan;
 static uint8_t  *data_line_border_byte;
 static uint8_t  use_EPD_type_index;
+static uint16_t partial_y0=0;			//First line driven by the next partial update
+static uint16_t partial_y1=0xFFFF;		//Line after the last one driven by the next partial update
  void nothing_frame (uint8_t EPD_type_index);
  void stage_handle_ex(uint8_t EPD_type_index,long image_data_address,uint8_t stage_no,uint8_t lineoffset) ;
 /**
@@ -705,16 +707,27 @@ void stage_handle_Base(uint8_t EPD_type_index,uint8_t *image_prt,long image_data
 }
 
 
+/**
+* \brief The partial update stage, driving only the lines that changed
+*
+* \note Lines out of y0..y1-1 are sent as Nothing lines without reading the
+* images from memory
+*
+* \param EPD_type_index The defined EPD size
+* \param new_image_data_address The memory address of new image
+* \param previous_image_data_address The memory address of previous image
+* \param lineoffset Line offset
+* \param y0 The first line to update
+* \param y1 The line after the last one to update
+*/
 void partial_handle_Base(uint8_t EPD_type_index,long new_image_data_address,long previous_image_data_address
-						     ,uint8_t lineoffset)
+						     ,uint8_t lineoffset,uint16_t y0,uint16_t y1)
 {	
 	struct EPD_V230_G2_Struct S_epd_v230;
 	int16_t cycle,m,i; //m=number of steps
 	uint8_t isLastframe = 0;	//If it is the last frame to send Nothing at the fist scan line
 	uint8_t isLastBlock=0;		//If the beginning line of block is in active range of EPD
 	int16_t scanline_no=0;
-	uint8_t *action_block_prt,*action_block_prt2;
-	long action_block_address,action_block_address2;
 	//uint8_t byte_array[LINE_BUFFER_DATA_SIZE];
     uint8_t previous_line_array[LINE_BUFFER_DATA_SIZE];
     uint8_t new_line_array[LINE_BUFFER_DATA_SIZE];
@@ -750,18 +763,6 @@ void partial_handle_Base(uint8_t EPD_type_index,long new_image_data_address,long
 			/* if the beginning line of block is in active range of EPD */
 			 if (S_epd_v230.block_y1 == S_epd_v230.block_size) isLastBlock = 1;
 			 	
-			 if(_On_EPD_read_flash!=NULL)	//Read line data in range of block, read first
-			 {
-                action_block_address2=new_image_data_address+(long)(S_epd_v230.block_y0*lineoffset);
-                _On_EPD_read_flash(action_block_address2,(uint8_t *)&new_line_array,
-									COG_parameters[EPD_type_index].horizontal_size);
-                action_block_prt2=(uint8_t *)&new_line_array;
-                
-				action_block_address=previous_image_data_address+(long)(S_epd_v230.block_y0*lineoffset);
-				_On_EPD_read_flash(action_block_address,(uint8_t *)&previous_line_array,
-									COG_parameters[EPD_type_index].horizontal_size);
-				action_block_prt=(uint8_t *)&previous_line_array;
-			 }	
 			/* Update line data */
 		   	 for (i = S_epd_v230.block_y0; i < S_epd_v230.block_y1; i++)
 		   	 {		
@@ -773,24 +774,20 @@ void partial_handle_Base(uint8_t EPD_type_index,long new_image_data_address,long
 				  {
 					  nothing_line(EPD_type_index);		                       
 				  }
+				  else if (i < y0 || i >= y1 || _On_EPD_read_flash==NULL)
+				  {
+					  // unchanged line: nothing to read, nothing to drive
+					  nothing_line(EPD_type_index);
+				  }
 				  else	 
 				  {			
-					  partial_read_line_data_handle(EPD_type_index,action_block_prt2,action_block_prt);					
-				  }
-			   		
-				if(_On_EPD_read_flash!=NULL)	//Read line data in range of block
-				{
-					action_block_address +=lineoffset;
-					_On_EPD_read_flash(action_block_address,(uint8_t *)&previous_line_array,
-					COG_parameters[EPD_type_index].horizontal_size);
-					action_block_prt=(uint8_t *)&previous_line_array;
-
-                    action_block_address2+=lineoffset;
-                    _On_EPD_read_flash(action_block_address2,(uint8_t *)&new_line_array,
+					//Read line data of both images
+					_On_EPD_read_flash(new_image_data_address+(long)i*lineoffset,(uint8_t *)&new_line_array,
 									COG_parameters[EPD_type_index].horizontal_size);
-                     action_block_prt2=(uint8_t *)&new_line_array;
-				}
-				else action_block_prt+=lineoffset;
+					_On_EPD_read_flash(previous_image_data_address+(long)i*lineoffset,(uint8_t *)&previous_line_array,
+									COG_parameters[EPD_type_index].horizontal_size);
+					  partial_read_line_data_handle(EPD_type_index,(uint8_t *)&new_line_array,(uint8_t *)&previous_line_array);
+				  }
 					
 				scanline_no= (COG_parameters[EPD_type_index].vertical_size-1)-i;
 					
@@ -821,7 +818,7 @@ void partial_handle_Base(uint8_t EPD_type_index,long new_image_data_address,long
  *
  * \note
  * - Mark from (x0,y0) to (x1,y1) as update area to change data
- * - Default use whole area of EPD as update area currently
+ * - Only the lines y0..y1-1 are driven, the whole width is always updated
  *
  * @param x0 (x0,y0) as the left/top coordinates
  * @param x1 (x1,y1) as the right/bottom coordinates
@@ -834,7 +831,7 @@ inline void epd_stage_partial_handle(uint16_t x0,uint16_t x1,uint16_t y0,uint16_
                                           EInt previous_image_data_address,
                                           EInt new_image_data_address){
   
-	partial_handle_Base(use_EPD_type_index,new_image_data_address,previous_image_data_address,COG_parameters[use_EPD_type_index].horizontal_size);
+	partial_handle_Base(use_EPD_type_index,new_image_data_address,previous_image_data_address,COG_parameters[use_EPD_type_index].horizontal_size,y0,y1);
 }
 void stage_handle(uint8_t EPD_type_index,uint8_t *image_prt,uint8_t stage_no,uint8_t lineoffset)
 {
@@ -989,7 +986,8 @@ static void border_dummy_line(uint8_t EPD_type_index)
  *
  * \note
  * - Mark from (x0,y0) to (x1,y1) as update area to change data
- * - Default use whole area of EPD as update area currently
+ * - Default use whole area of EPD as update area, EPD_set_partial_lines
+ *   restricts the next update to the lines that changed
  *
  * \param previous_image_memory_address The previous image address of memory
  * \param new_image_memory_address The new image address of memory
@@ -1002,14 +1000,33 @@ void EPD_image_data_partial_handle (EInt previous_image_memory_address,
 
         /* Standard 4 stages driving, update from (0,0) to (horizontal_size*8,vertical_size)  */
    //nothing_frame(use_EPD_type_index);
+	if(partial_y1>COG_parameters[use_EPD_type_index].vertical_size)
+		partial_y1=COG_parameters[use_EPD_type_index].vertical_size;
 	epd_stage_partial_handle(0,
                              COG_parameters[use_EPD_type_index].horizontal_size*8,
-                             0,
-                             COG_parameters[use_EPD_type_index].vertical_size,
+                             partial_y0,
+                             partial_y1,
                              previous_image_memory_address,new_image_memory_address);
+	partial_y0=0;
+	partial_y1=0xFFFF;
 	//border_dummy_line(use_EPD_type_index);
 	//nothing_frame(use_EPD_type_index);
 }
+/**
+ * \brief Restrict the next partial update to the lines y0..y1-1
+ *
+ * \note The other lines are sent as Nothing lines, so they must be the same
+ * in the previous and the new image. The area is reset to the whole EPD
+ * after the update.
+ *
+ * \param y0 The first line that changed
+ * \param y1 The line after the last one that changed
+ */
+void EPD_set_partial_lines(uint16_t y0,uint16_t y1) {
+	partial_y0=y0;
+	partial_y1=y1;
+}
+
 uint8_t EPD_power_off (void) {
     uint8_t y;
      	if(use_EPD_type_index==EPD_144 || use_EPD_type_index==EPD_200) 	{
@@ -238,5 +238,6 @@ void EPD_image_data_partial_handle (EInt previous_image_flash_address,
 void EPD_image_data_globa_handle( EInt previous_image_flash_address,
                                             EInt new_image_flash_address,
                                             EPD_read_memory_handler On_EPD_read_handle);
+void EPD_set_partial_lines(uint16_t y0,uint16_t y1);
 #endif 	//DISPLAY_COG_PROCESS__H_INCLUDED
 
@@ -165,6 +165,24 @@ uint8_t SRAMWriteSeq(unsigned int address, unsigned char *WriteData,unsigned int
 	return(0);			//Return non -ve nuber indicating success
 }
 
+uint8_t SRAMFillSeq(unsigned int address, unsigned char FillData,unsigned int FillCnt)
+{
+	unsigned char DummyRead;
+	SRAMWriteStatusReg(SRAMSeqMode);
+	//Send Write command to SRAM along with address
+	EPD_flash_cs_low();
+	SRAMCommand(address,SRAMWrite);
+	//Send the same byte FillCnt times in a single transaction
+	for(;FillCnt > 0;FillCnt--)
+	{
+		WriteSPIx(FillData);
+		while(!SPIx_Rx_Buf_Full);
+		DummyRead = ReadSPIx();
+	}
+	EPD_flash_cs_high();
+	return(0);			//Return non -ve nuber indicating success
+}
+
 uint8_t SRAMReadSeq(unsigned int address,unsigned char *ReadData,unsigned int ReadCnt)
 {
 	SRAMWriteStatusReg(SRAMSeqMode);
@@ -60,5 +60,6 @@ uint8_t SRAMReadByte(unsigned int address);
 uint8_t SRAMWritePage(unsigned int address, unsigned char *WriteData);
 uint8_t SRAMReadPage(unsigned int address,unsigned char *ReadData);
 uint8_t SRAMWriteSeq(unsigned int address, unsigned char *WriteData,unsigned int WriteCnt);
+uint8_t SRAMFillSeq(unsigned int address, unsigned char FillData,unsigned int FillCnt);
 uint8_t SRAMReadSeq(unsigned int address,unsigned char *ReadData,unsigned int ReadCnt);
 #endif
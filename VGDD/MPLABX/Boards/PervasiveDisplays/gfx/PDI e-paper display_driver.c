@@ -57,34 +57,121 @@ GFX_COLOR   _color;
 long cur_image_index=0;
 long previous_image_address,new_image_address;
 
+/** Bytes per image line (the COG code reads the lines with this stride) */
+#define EPD_LINE_BYTES      (DISP_HOR_RESOLUTION/8)
+/** Bytes of one image in SRAM */
+#define EPD_IMAGE_BYTES     ((long)EPD_LINE_BYTES*DISP_VER_RESOLUTION)
+/** Bytes read beyond the one needed when the line cache grows */
+#define EPD_LINE_PREFETCH   3
+/** Size of the buffer used to copy the image inside SRAM */
+#define EPD_COPY_CHUNK      128
 
 /**
- * Reset the data and image address of SRAM for EPD
+ * Line cache: part of one line of the new image kept in RAM, so that PutPixel
+ * does not cost two SPI transactions per pixel.
+ * Bytes lineFirst..lineLast hold the SRAM content of line lineY, bytes
+ * dirtyFirst..dirtyLast have been changed and are written back by FlushLine()
+ * when another line is drawn or before the SRAM image is read or copied.
  */
-void ResetDevice(void)
+static uint8_t lineBuf[EPD_LINE_BYTES];
+static SHORT lineY=-1;
+static SHORT lineFirst=EPD_LINE_BYTES,lineLast=-1;
+static SHORT dirtyFirst=EPD_LINE_BYTES,dirtyLast=-1;
+
+/**
+ * Lines of the new image changed since the last StoreScreen: the others are
+ * the same in the previous image, so they are neither driven by the partial
+ * update nor copied back
+ */
+static SHORT changedTop=DISP_VER_RESOLUTION,changedBottom=-1;
+
+#define MarkChanged(top,bottom) {if((top)<changedTop) changedTop=(top); if((bottom)>changedBottom) changedBottom=(bottom);}
+
+/**
+ * Write the changed bytes of the line cache back to SRAM
+ */
+static void FlushLine(void)
 {
-    uint32_t i;
-    uint8_t ImgData[32];
-    //Sets 32 bytes of the block of memory pointed by ImgData to 0xFF
-     for(i=0;i<32;i++)
+    if(dirtyFirst<=dirtyLast)
     {
-        ImgData[i]=0xFF;
+        SRAMWriteSeq(new_image_address+(long)lineY*EPD_LINE_BYTES+dirtyFirst,
+                &lineBuf[dirtyFirst],dirtyLast-dirtyFirst+1);
     }
-    //Write 0xFF to SRAM
-    for(i=0;i<1024;i++){
-        SRAMWritePage((i*32),ImgData);
+    dirtyFirst=EPD_LINE_BYTES;
+    dirtyLast=-1;
+}
+
+/**
+ * Empty the line cache, discarding the changes not yet written back
+ */
+static void InvalidateLine(void)
+{
+    lineY=-1;
+    lineFirst=dirtyFirst=EPD_LINE_BYTES;
+    lineLast=dirtyLast=-1;
+}
+
+/**
+ * Return the cached image byte holding pixel x,y, reading it from SRAM if needed
+ * @param x pixel coordinate
+ * @param y pixel coordinate
+ * @return pointer to the byte in the line cache
+ */
+static uint8_t *LineByte(SHORT x, SHORT y)
+{
+    SHORT b,from,to;
+
+    if(y!=lineY)
+    {
+        FlushLine();
+        InvalidateLine();
+        lineY=y;
+    }
+    b=x>>3;
+    if(b<lineFirst || b>lineLast)
+    {
+        // read the missing bytes in a single transaction, plus a few more in
+        // the direction the line is being drawn
+        if(lineFirst>lineLast)
+        {
+            from=b-EPD_LINE_PREFETCH;
+            to=b+EPD_LINE_PREFETCH;
+        }
+        else if(b<lineFirst)
+        {
+            from=b-EPD_LINE_PREFETCH;
+            to=lineFirst-1;
+        }
+        else
+        {
+            from=lineLast+1;
+            to=b+EPD_LINE_PREFETCH;
+        }
+        if(from<0) from=0;
+        if(to>EPD_LINE_BYTES-1) to=EPD_LINE_BYTES-1;
+        SRAMReadSeq(new_image_address+(long)y*EPD_LINE_BYTES+from,&lineBuf[from],to-from+1);
+        if(from<lineFirst) lineFirst=from;
+        if(to>lineLast) lineLast=to;
     }
+    return &lineBuf[b];
+}
+
+/**
+ * Reset the data and image address of SRAM for EPD
+ */
+void ResetDevice(void)
+{
+    //Write 0xFF to the whole SRAM (32K bytes)
+    InvalidateLine();
+    SRAMFillSeq(0,0xFF,32768u);
+    changedTop=DISP_VER_RESOLUTION;
+    changedBottom=-1;
   
     cur_image_index=0;
     new_image_address=getAddress(cur_image_index);
     previous_image_address=getAddress((cur_image_index+1));
 }
 
-
-
-//static uint32_t bkaddress=0xffffff;
-static uint8_t bkdata=0xff;
-
 /**
  * Plots pixel at location *x,y)
  * @param x pixel coordinate
@@ -92,38 +179,138 @@ static uint8_t bkdata=0xff;
  */
 void PutPixel(SHORT x, SHORT y)
 {
-    uint32_t address;
-    uint8_t PixelBit,sdata;
-
-    PixelBit=(7-(x%8));
-    address=(uint32_t)(y*(DISP_HOR_RESOLUTION/8))+(x/8);
-    address+=new_image_address;//address page offset
-        bkdata=SRAMReadByte(address);
-      if(_color == BLACK)  {
-         sdata=(bkdata & (~_BV(PixelBit)));
-      }else{
-         sdata=(bkdata | _BV(PixelBit));
-      }
-
-   if(sdata!=bkdata)
-   {
-       SRAMWriteByte(address,sdata);
-       bkdata=sdata;
-   }
+    uint8_t *pData,sdata;
+
+    // check if point is in clipping region
+    if(_clipRgn)
+    {
+        if(x < _clipLeft || x > _clipRight || y < _clipTop || y > _clipBottom)
+            return;
+    }
+    if(x < 0 || x >= DISP_HOR_RESOLUTION || y < 0 || y >= DISP_VER_RESOLUTION)
+        return;
+
+    pData=LineByte(x,y);
+    if(_color == BLACK)  {
+        sdata=(*pData & (~_BV(7-(x&7))));
+    }else{
+        sdata=(*pData | _BV(7-(x&7)));
+    }
+
+    if(sdata!=*pData)
+    {
+        *pData=sdata;
+        if((x>>3)<dirtyFirst) dirtyFirst=x>>3;
+        if((x>>3)>dirtyLast) dirtyLast=x>>3;
+        MarkChanged(y,y);
+    }
 }
 
 /**
- * Store the last updated image to Previous image
+ * Fill a rectangle with the current color, writing whole image bytes:
+ * only the first and last byte of each line are read back from SRAM, and only
+ * when the rectangle does not start or end on a byte boundary
+ * @param left x of the top left corner
+ * @param top y of the top left corner
+ * @param right x of the bottom right corner
+ * @param bottom y of the bottom right corner
+ * @return always 1 (never busy)
+ */
+WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom)
+{
+    uint8_t fill,maskL,maskR;
+    uint8_t data[EPD_LINE_BYTES];
+    SHORT y,n;
+    long address;
+
+    if(_clipRgn)
+    {
+        if(left < _clipLeft)
+            left = _clipLeft;
+        if(right > _clipRight)
+            right = _clipRight;
+        if(top < _clipTop)
+            top = _clipTop;
+        if(bottom > _clipBottom)
+            bottom = _clipBottom;
+    }
+    if(left < 0) left = 0;
+    if(top < 0) top = 0;
+    if(right > DISP_HOR_RESOLUTION-1) right = DISP_HOR_RESOLUTION-1;
+    if(bottom > DISP_VER_RESOLUTION-1) bottom = DISP_VER_RESOLUTION-1;
+    if(left > right || top > bottom)
+        return (1);
+
+    // the cached line must not be overwritten later with stale bytes
+    if(lineY>=top && lineY<=bottom)
+    {
+        FlushLine();
+        InvalidateLine();
+    }
+
+    MarkChanged(top,bottom);
+    fill=(_color==BLACK)?0x00:0xFF;
+    maskL=0xFF>>(left&7);               // bits of the first byte inside the bar
+    maskR=(uint8_t)(0xFF<<(7-(right&7))); // bits of the last byte inside the bar
+    n=(right>>3)-(left>>3)+1;
+    if(n==1)
+        maskL=maskR=maskL&maskR;
+    address=new_image_address+(long)top*EPD_LINE_BYTES+(left>>3);
+
+    if(maskL==0xFF && maskR==0xFF)
+    {
+        if(n==EPD_LINE_BYTES)
+        {
+            // whole lines are contiguous in SRAM
+            SRAMFillSeq(address,fill,n*(bottom-top+1));
+        }
+        else
+        {
+            for(y=top;y<=bottom;y++,address+=EPD_LINE_BYTES)
+                SRAMFillSeq(address,fill,n);
+        }
+    }
+    else
+    {
+        for(y=top;y<=bottom;y++,address+=EPD_LINE_BYTES)
+        {
+            if(maskL!=0xFF)
+                data[0]=SRAMReadByte(address);
+            if(maskR!=0xFF && n>1)
+                data[n-1]=SRAMReadByte(address+n-1);
+            data[0]=(data[0]&~maskL)|(fill&maskL);
+            if(n>1)
+            {
+                memset(&data[1],fill,n-2);
+                data[n-1]=(data[n-1]&~maskR)|(fill&maskR);
+            }
+            SRAMWriteSeq(address,data,n);
+        }
+    }
+    return (1);
+}
+
+/**
+ * Store the last updated image to Previous image (only the lines changed since
+ * the last call)
  */
 void StoreScreen(void){
 
-    uint32_t i;
-    uint8_t ImgData[32];
+    long i,end;
+    uint8_t ImgData[EPD_COPY_CHUNK];
+    unsigned int n;
     // SpiRAM_Init();
-    for(i=0;i<_epd_page_size();i++){
-        SRAMReadPage((i*32),ImgData);
-        SRAMWritePage((i*32)+previous_image_address,ImgData);
+    FlushLine();
+    if(changedTop>changedBottom)
+        return;
+    end=(long)(changedBottom+1)*EPD_LINE_BYTES;
+    for(i=(long)changedTop*EPD_LINE_BYTES;i<end;i+=n){
+        n=(end-i>EPD_COPY_CHUNK)?EPD_COPY_CHUNK:(unsigned int)(end-i);
+        SRAMReadSeq(new_image_address+i,ImgData,n);
+        SRAMWriteSeq(previous_image_address+i,ImgData,n);
     }
+    changedTop=DISP_VER_RESOLUTION;
+    changedBottom=-1;
 }
 
 
@@ -168,18 +355,12 @@ WORD IsDeviceBusy(void)
  */
 void ClearDevice(void)
 {
-    uint32_t i;
     uint8_t tmp=0xFF;
-    uint8_t ImgData[32];
    // SpiRAM_Init();
     if(GetColor()==BLACK) tmp=0x00;
-    for(i=0;i<32;i++)
-    {
-        ImgData[i]=tmp;
-    }
-    for(i=0;i<_epd_page_size();i++){
-        SRAMWritePage((i*32),ImgData);
-    }   
+    InvalidateLine();
+    SRAMFillSeq(new_image_address,tmp,(unsigned int)EPD_IMAGE_BYTES);
+    MarkChanged(0,DISP_VER_RESOLUTION-1);
 }
 
 
@@ -191,9 +372,9 @@ void ClearDevice(void)
  */
 void read_SRAM_handle(EInt memory_address,uint8_t *target_buffer,
                               uint8_t byte_length) {
+    FlushLine();
     SRAMReadSeq(memory_address,target_buffer,byte_length);
 }
-
 /**
  * EPD global update function
  */
@@ -210,9 +391,14 @@ void EPD_PWD_Init(void){
 }
 
 /**
- * EPD partial update function
+ * EPD partial update function: only the lines changed since the last update
+ * are driven, nothing is done if none changed
  */
 void EPD_Partial_Update(void){
+    FlushLine();
+    if(changedTop>changedBottom)
+        return;
+    EPD_set_partial_lines(changedTop,changedBottom+1);
     EPD_display_partial(USE_EPD_Type,previous_image_address,new_image_address,read_SRAM_handle);
     StoreScreen();
 }
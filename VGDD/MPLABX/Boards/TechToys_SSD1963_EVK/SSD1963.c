@@ -216,6 +216,78 @@
  ******************************************************************************
  */
 
+/*
+ ******************************************************************************
+ * Revision:
+ * Bar() and ClearDevice() write the pixels with an unrolled loop through
+ * FillWindow(). With SSD1963_DMA_CHANNEL a DMA channel, started by the PMP
+ * at the end of each write, writes them from a block filled with the color:
+ * IsDeviceBusy() reports the transfer and the next command waits for it.
+ *
+ * Programmer: VirtualFab @ www.Virtualfab.it
+ * Date: 17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * RequestDisplayUpdate() flips the pages in the vertical blank: from the
+ * interrupt of the TE output (SSD1963_TE_INT), or after polling the scan
+ * line. SSD1963_FLIP_FRAMES caps the flip rate and GetFrameStats() reports
+ * the panel refreshes between the flips. A flip the TE interrupt does not do
+ * within SSD1963_FLIP_TIMEOUT ms is done by the waiting code.
+ *
+ * Programmer: VirtualFab @ www.Virtualfab.it
+ * Date: 17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * GetPixel() implemented, reading the SSD1963 memory back with
+ * CMD_RD_MEMSTART (USE_GFX_PMP only). New GetRow() reads a whole row in one
+ * burst, for the functions that save and restore the screen under a needle
+ * or a popup. SSD1963.h defines GFX_DRV_GETPIXEL when the memory can be
+ * read back.
+ *
+ * Programmer: VirtualFab @ www.Virtualfab.it
+ * Date: 17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * PutImage16BPPExt() clips the image once to the screen and to the clipping
+ * region, sets its window once and writes each line from a line buffer with
+ * an unrolled loop. Fixed the undeclared window corners, the stretched images
+ * (shrunk instead of enlarged), the transparent pixels (the next pixels were
+ * shifted) and the images with DISP_ORIENTATION 90 (transposed): these are
+ * written row by row, and the transparent ones run by run.
+ *
+ * Programmer: VirtualFab @ www.Virtualfab.it
+ * Date: 17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * The DMA fills are queued (SSD1963_QUEUE_SIZE): Bar() and ClearDevice()
+ * return as soon as the fill is queued, the DMA interrupt writes the window
+ * of each fill and starts its blocks. IsDeviceBusy() returns the fills
+ * queued and Bar() returns 0 with USE_NONBLOCKING_CONFIG only when the queue
+ * is full; the commands wait for the queue to empty. The default DMA block
+ * fits the 255 bytes of a DMA block on PIC32MX3xx/4xx, a larger
+ * SSD1963_FILL_BLOCK is an error there.
+ *
+ * Programmer: VirtualFab @ www.Virtualfab.it
+ * Date: 17th Oct 2026
+ ******************************************************************************
+ */
+
 #include "HardwareProfile.h"
 #include "TimeDelay.h"
 #include "Graphics/DisplayDriver.h"
@@ -233,6 +305,57 @@ volatile DWORD _drawbuffer;
 volatile BYTE blDisplayUpdatePending;
 
 static void ExchangeDrawAndFrameBuffers(void);
+
+#if !defined (SSD1963_FLIP_FRAMES)
+    #define SSD1963_FLIP_FRAMES 1           // Panel refreshes between two flips, at least
+#endif
+#if !defined (SSD1963_FLIP_TIMEOUT)
+    #define SSD1963_FLIP_TIMEOUT 100        // ms a queued flip waits for the TE interrupt
+#endif
+
+#if defined (SSD1963_TE_INT)
+    #if !defined (__PIC32MX__)
+        #error SSD1963_TE_INT needs a PIC32
+    #endif
+    #if (SSD1963_TE_INT == 0)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_0_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_0_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT0
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT0EP_MASK
+    #elif (SSD1963_TE_INT == 1)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_1_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_1_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT1
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT1EP_MASK
+    #elif (SSD1963_TE_INT == 2)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_2_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_2_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT2
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT2EP_MASK
+    #elif (SSD1963_TE_INT == 3)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_3_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_3_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT3
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT3EP_MASK
+    #elif (SSD1963_TE_INT == 4)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_4_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_4_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT4
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT4EP_MASK
+    #else
+        #error SSD1963_TE_INT must be 0 to 4
+    #endif
+static volatile WORD _framesSinceFlip = 0;  // TE pulses since the last flip
+#elif defined (USE_GFX_PMP)
+    // No TE interrupt: the scan line is read back through the PMP
+    #define SSD1963_TE_POLL
+    // Scan line 0 is the first line of the vertical sync pulse; the lines
+    // outside the active area are the vertical blank
+    #define VBLANK_END      (DISP_VER_PULSE_WIDTH + DISP_VER_BACK_PORCH)
+    #define InVBlank(line)  ((line) < VBLANK_END || (line) >= VBLANK_END + DISP_VER_RESOLUTION)
+#endif
+
+static volatile SSD1963_FRAME_STATS _frameStats;
 #endif //USE_DOUBLE_BUFFERING
 
 GFX_COLOR _color; // Color
@@ -256,6 +379,79 @@ BYTE _visualPage; // Visual Page
 
 BYTE _gpioStatus = 0; // ssd1963 specific
 
+#if defined (SSD1963_DMA_CHANNEL)
+    #if !defined (__PIC32MX__) || !defined (USE_GFX_PMP)
+        #error SSD1963_DMA_CHANNEL needs a PIC32 with the PMP driving the WR line (USE_GFX_PMP)
+    #endif
+    #if !defined (SSD1963_QUEUE_SIZE)
+        #define SSD1963_QUEUE_SIZE  8       // Fills waiting for the DMA channel
+    #endif
+    // The DMA blocks are 255 bytes at most on PIC32MX3xx/4xx
+    #if (defined (__PIC32_FEATURE_SET__) && (__PIC32_FEATURE_SET__ >= 300) && (__PIC32_FEATURE_SET__ < 500)) || \
+        defined (__32MX360F512L__) || defined (__32MX460F512L__)
+        #define SSD1963_DMA_MAX_BYTES   255
+    #else
+        #define SSD1963_DMA_MAX_BYTES   65535
+    #endif
+    #if defined (USE_16BIT_PMP)
+        #define FILL_PIXEL_BYTES    2       // Bytes of each pixel in _fillBuffer
+    #else
+        #define FILL_PIXEL_BYTES    3
+    #endif
+    #if !defined (SSD1963_FILL_BLOCK)
+        #if (SSD1963_DMA_MAX_BYTES < 256 * FILL_PIXEL_BYTES)
+            #define SSD1963_FILL_BLOCK  (SSD1963_DMA_MAX_BYTES / FILL_PIXEL_BYTES) // Pixels written by each DMA block
+        #else
+            #define SSD1963_FILL_BLOCK  256
+        #endif
+    #endif
+    #if (SSD1963_FILL_BLOCK * FILL_PIXEL_BYTES > SSD1963_DMA_MAX_BYTES)
+        #error SSD1963_FILL_BLOCK does not fit a DMA block of this PIC32
+    #endif
+    #if (SSD1963_DMA_CHANNEL == 0)
+        #define SSD1963_DMA_VECTOR  _DMA0_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 1)
+        #define SSD1963_DMA_VECTOR  _DMA1_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 2)
+        #define SSD1963_DMA_VECTOR  _DMA2_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 3)
+        #define SSD1963_DMA_VECTOR  _DMA3_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 4)
+        #define SSD1963_DMA_VECTOR  _DMA4_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 5)
+        #define SSD1963_DMA_VECTOR  _DMA5_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 6)
+        #define SSD1963_DMA_VECTOR  _DMA6_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 7)
+        #define SSD1963_DMA_VECTOR  _DMA7_VECTOR
+    #else
+        #error SSD1963_DMA_CHANNEL must be 0 to 7
+    #endif
+
+#if defined (USE_16BIT_PMP)
+    #define FILL_CELL_SIZE  2               // Bytes of each PMP write
+static WORD _fillBuffer[SSD1963_FILL_BLOCK];
+#else
+    #define FILL_CELL_SIZE  1
+static BYTE _fillBuffer[SSD1963_FILL_BLOCK * 3];
+#endif
+static GFX_COLOR _fillColor;                // Color in _fillBuffer
+static BOOL _fillValid = FALSE;
+
+// Window filled with one color; columns and pages as written by SetArea()
+typedef struct {
+    WORD startX, endX;              // Columns
+    WORD startY, endY;              // Pages, page offset included
+    DWORD pixels;                   // Pixels left
+    GFX_COLOR color;                // Fill color
+} QUEUE_COMMAND;
+
+static QUEUE_COMMAND _queue[SSD1963_QUEUE_SIZE];
+static WORD _queueHead = 0;                 // Fill being written
+static volatile WORD _queueCount = 0;       // Fills queued, 0 when the channel is idle
+static BOOL _queueWindow = FALSE;           // Window of the head fill written
+#endif
+
 void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
 void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
 void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
@@ -268,6 +464,9 @@ void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
 
 /**************** LOCAL FUNCTION PROTOTYPE (SSD1963 SPECIFIC) ****************/
 static void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y);
+#if defined (SSD1963_TE_POLL)
+static WORD GetScanLine(void);
+#endif
 static void GPIO_WR(BYTE pin, BOOL state);
 static void SPI_Write(BYTE byte);
 static void SPI_SetReg(BYTE reg, WORD cmd);
@@ -284,11 +483,16 @@ static void SPI_SetReg(BYTE reg, WORD cmd);
  *
  * Output: Busy status.
  *
- * Remarks: Not implemented yet
+ * Remarks: the number of Bar() and ClearDevice() fills queued for the
+ *          DMA channel (SSD1963_DMA_CHANNEL), else always 0
  *
  ********************************************************************/
 WORD IsDeviceBusy() {
+#if defined (SSD1963_DMA_CHANNEL)
+    return (_queueCount);
+#else
     return 0;
+#endif
 }
 
 #if defined (USE_DOUBLE_BUFFERING)
@@ -381,9 +585,11 @@ void SwitchOffDoubleBuffering(void) {
 }
 
 /*********************************************************************
- * Function:  void UpdateDisplayNow(void)
+ * Function:  static void FlipPages(void)
  *
- * Overview: Synchronizes the draw and frame buffers immediately
+ * Overview: Shows the draw buffer by moving the scroll start to it and
+ *			swaps the role of DrawBuffer with FrameBuffer with
+ *			ExchangeDrawAndFrameBuffers()
  *
  * PreCondition: none
  *
@@ -391,13 +597,11 @@ void SwitchOffDoubleBuffering(void) {
  *
  * Output: none
  *
- * Side Effects: none
+ * Side Effects: clears blDisplayUpdatePending
  *
- * Remarks:	For SSD1963, this is equivalent to updating the pointer
- *			to the DrawBuffer and swap the role of DrawBuffer with
- *			FrameBuffer with ExchangeDrawAndFrameBuffers()
  ********************************************************************/
-void UpdateDisplayNow(void) {
+static void FlipPages(void) {
+    blDisplayUpdatePending = 0;
     SetScrollArea(0, GetMaxY() + 1, 0);
     if (_drawbuffer == GFX_BUFFER1) {
         SetScrollStart(0);
@@ -405,6 +609,147 @@ void UpdateDisplayNow(void) {
         SetScrollStart(GetMaxY() + 1);
     }
     ExchangeDrawAndFrameBuffers();
+
+    _frameStats.Flips++;
+#if defined (SSD1963_TE_INT)
+    _frameStats.LastFrame = _framesSinceFlip;
+    if (_framesSinceFlip > _frameStats.MaxFrame)
+        _frameStats.MaxFrame = _framesSinceFlip;
+    _framesSinceFlip = 0;
+#endif
+}
+
+#if defined (SSD1963_TE_INT)
+
+/*********************************************************************
+ * Function:  SSD1963TeHandler()
+ *
+ * Overview: TE rising edge, start of the vertical blank. Applies the
+ *			flip queued by RequestDisplayUpdate() once SSD1963_FLIP_FRAMES
+ *			panel refreshes passed since the last one.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Remarks:	WriteCommand() holds the main code while a flip is pending,
+ *			so the bus is free here unless DMA fills are queued; the
+ *			flip then waits for the next blank.
+ ********************************************************************/
+void __ISR(SSD1963_TE_VECTOR, ipl4) SSD1963TeHandler(void) {
+    INTClearFlag(SSD1963_TE_SOURCE);
+    _frameStats.Refreshes++;
+    if (_framesSinceFlip != 0xFFFF)
+        _framesSinceFlip++;
+
+    if (blDisplayUpdatePending && _framesSinceFlip >= SSD1963_FLIP_FRAMES) {
+        if (IsDeviceBusy()) {
+            _frameStats.Deferred++;
+            return;
+        }
+        FlipPages();
+    }
+}
+
+/*********************************************************************
+ * Function:  static void WaitFlip(void)
+ *
+ * Overview: Waits for the TE interrupt to do the flip queued by
+ *			RequestDisplayUpdate(). If it is not done within
+ *			SSD1963_FLIP_TIMEOUT ms (interrupts disabled, TE not wired)
+ *			the pages are flipped here, out of the vertical blank, and
+ *			the flip is counted in Timeouts.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+static void WaitFlip(void) {
+    DWORD start = ReadCoreTimer();
+
+    while (blDisplayUpdatePending) {
+        // The core timer counts at half the system clock
+        if (ReadCoreTimer() - start >= SSD1963_FLIP_TIMEOUT * (GetSystemClock() / 2000)) {
+            INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+            if (blDisplayUpdatePending) {
+                _frameStats.Timeouts++;
+                FlipPages();
+            }
+            INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+        }
+    }
+}
+#endif // SSD1963_TE_INT
+
+#if defined (SSD1963_TE_POLL)
+
+/*********************************************************************
+ * Function:  static void WaitVBlank(void)
+ *
+ * Overview: Polls the scan line until the vertical blank. With
+ *			SSD1963_FLIP_FRAMES above 1 it waits for as many blanks.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+static void WaitVBlank(void) {
+    WORD frames;
+
+    for (frames = SSD1963_FLIP_FRAMES; frames > 1; frames--) {
+        while (InVBlank(GetScanLine()));
+        while (!InVBlank(GetScanLine()));
+        _frameStats.Refreshes++;
+    }
+    while (!InVBlank(GetScanLine()));
+    _frameStats.Refreshes++;
+}
+#endif // SSD1963_TE_POLL
+
+/*********************************************************************
+ * Function:  void UpdateDisplayNow(void)
+ *
+ * Overview: Synchronizes the draw and frame buffers immediately
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Remarks:	For SSD1963, this is equivalent to updating the pointer
+ *			to the DrawBuffer and swap the role of DrawBuffer with
+ *			FrameBuffer with ExchangeDrawAndFrameBuffers().
+ *			The flip is still done in the vertical blank: the function
+ *			returns after it, or after SSD1963_FLIP_TIMEOUT ms without
+ *			the TE interrupt (see WaitFlip()).
+ ********************************************************************/
+void UpdateDisplayNow(void) {
+#if defined (SSD1963_TE_INT)
+    blDisplayUpdatePending = 1;
+    WaitFlip();
+#else
+#if defined (SSD1963_TE_POLL)
+    WaitVBlank();
+#endif
+    FlipPages();
+#endif
 }
 
 /*********************************************************************
@@ -419,10 +764,74 @@ void UpdateDisplayNow(void) {
  * Output: none
  *
  * Side Effects: none
- * Remarks: Not implemented yet, may use tearing effect to achieve this
+ * Remarks: With SSD1963_TE_INT the flip is queued and done by the TE
+ *			interrupt: IsDisplayUpdatePending() is set until then and
+ *			the next command waits for it. Otherwise the scan line is
+ *			polled and the flip done before returning (immediately
+ *			without USE_GFX_PMP, as the scan line cannot be read).
  ********************************************************************/
 void RequestDisplayUpdate(void) {
-    //use tearing effect!
+    if (blEnableDoubleBuffering == 0) {
+        return;
+    }
+#if defined (SSD1963_TE_INT)
+    blDisplayUpdatePending = 1;
+#else
+    UpdateDisplayNow();
+#endif
+}
+
+/*********************************************************************
+ * Function:  void GetFrameStats(SSD1963_FRAME_STATS *pStats)
+ *
+ * Overview: Copies the page flip statistics
+ *
+ * PreCondition: none
+ *
+ * Input: pStats - destination
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void GetFrameStats(SSD1963_FRAME_STATS *pStats) {
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+#endif
+    *pStats = _frameStats;
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
+}
+
+/*********************************************************************
+ * Function:  void ResetFrameStats(void)
+ *
+ * Overview: Clears the page flip statistics
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void ResetFrameStats(void) {
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+#endif
+    _frameStats.Flips = 0;
+    _frameStats.Refreshes = 0;
+    _frameStats.Deferred = 0;
+    _frameStats.Timeouts = 0;
+    _frameStats.LastFrame = 0;
+    _frameStats.MaxFrame = 0;
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
 }
 
 #endif	//USE_DOUBLE_BUFFERING
@@ -452,6 +861,52 @@ void RequestDisplayUpdate(void) {
  ********************************************************************/
 #define PMPWaitBusy()  while(PMMODEbits.BUSY);
 
+/*********************************************************************
+ * Macros:  WaitQueueEmpty()
+ *
+ * Overview: waits for the end of the DMA fills queued by Bar() and
+ *			 ClearDevice(), so that no command is written while they run
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Note: nothing to wait for without SSD1963_DMA_CHANNEL
+ ********************************************************************/
+#if defined (SSD1963_DMA_CHANNEL)
+    #define WaitQueueEmpty()    while(_queueCount);
+#else
+    #define WaitQueueEmpty()
+#endif
+
+/*********************************************************************
+ * Macros:  WaitFlipDone()
+ *
+ * Overview: waits for the page flip queued by RequestDisplayUpdate(),
+ *			so that the TE interrupt has the bus and nothing is drawn
+ *			on the page about to be shown
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Note: nothing to wait for without SSD1963_TE_INT; bounded by
+ *		SSD1963_FLIP_TIMEOUT
+ ********************************************************************/
+#if defined (USE_DOUBLE_BUFFERING) && defined (SSD1963_TE_INT)
+    #define WaitFlipDone()  WaitFlip();
+#else
+    #define WaitFlipDone()
+#endif
+
 /*************************************************************************************
  * Macros:  WriteCommand(cmd)
  *
@@ -467,7 +922,7 @@ void RequestDisplayUpdate(void) {
  *
  * Note: none
  *************************************************************************************/
-#define WriteCommand(cmd) { DisplayEnable(); DisplaySetCommand(); DeviceWrite(cmd); DisplayDisable(); DisplaySetData(); }
+#define WriteCommand(cmd) { WaitQueueEmpty(); WaitFlipDone(); DisplayEnable(); DisplaySetCommand(); DeviceWrite(cmd); DisplayDisable(); DisplaySetData(); }
 
 /*********************************************************************
  * Macros:  WriteCommandSlow(cmd)
@@ -536,6 +991,48 @@ void RequestDisplayUpdate(void) {
 
 #endif		//defined (USE_16BIT_PMP) / USE_8BIT_PMP
 
+#if !defined (SSD1963_DMA_CHANNEL)
+
+/*********************************************************************
+ * Function:  static void FillWindow(DWORD count)
+ *
+ * PreCondition: Window set by SetArea(), CMD_WR_MEMSTART written and
+ *				SSD1963 selected by DisplayEnable()
+ *
+ * Input: count - number of pixels to write with the current color
+ *
+ * Output: none
+ *
+ * Side Effects: deselects the SSD1963
+ *
+ * Overview: writes the pixels with a loop unrolled by 8, with the color
+ *			bytes computed once
+ *
+ * Note: with SSD1963_DMA_CHANNEL the fills are queued by QueueFill()
+ ********************************************************************/
+static void FillWindow(DWORD count) {
+    DWORD n;
+#if defined (USE_16BIT_PMP)
+    WORD color = _color;
+    #define FillPixel() WriteData(color)
+#else
+    BYTE r = _color >> 8, g = _color >> 3, b = _color << 3;
+    #define FillPixel() { WriteData(r); WriteData(g); WriteData(b); }
+#endif
+
+    for (n = count >> 3; n; n--) {
+        FillPixel(); FillPixel(); FillPixel(); FillPixel();
+        FillPixel(); FillPixel(); FillPixel(); FillPixel();
+    }
+    for (n = count & 7; n; n--) {
+        FillPixel();
+    }
+#undef FillPixel
+
+    DisplayDisable();
+}
+#endif // !SSD1963_DMA_CHANNEL
+
 /*********************************************************************
  * Function: Set a GPIO pin to state high(1) or low(0)
  *
@@ -659,90 +1156,279 @@ void SetClipRgn(SHORT left, SHORT top, SHORT right, SHORT bottom) {
  *
  * PreCondition: none
  *
- * Input: control - Enables or disables the clipping.
- *			- 0: Disable clipping
- *			- 1: Enable clipping
+ * Input: control - Enables or disables the clipping.
+ *			- 0: Disable clipping
+ *			- 1: Enable clipping
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void SetClip(BYTE control) {
+    _clipRgn = control;
+}
+
+/*********************************************************************
+ * Function:
+ *
+ * PreCondition: GPIO pins for the SPI port set all output prior to
+ *               using this function
+ * Arguments:
+ *
+ * Return: none
+ *
+ * Note:
+ *********************************************************************/
+static void SPI_SetReg(BYTE reg, WORD cmd) {
+    GPIO_WR(LCD_SPENA, 0); // RS=0 for index read/write, RS=1 for instruction read/write
+    SPI_Write(0x70); // This is a bitwise for (Device ID|RS|RW), therefore 0b011100|RS|RW, with RS=0, RW=0
+    SPI_Write(0x00); // register in 0x00[reg]
+    SPI_Write(reg);
+    GPIO_WR(LCD_SPENA, 1);
+
+    GPIO_WR(LCD_SPENA, 0);
+    SPI_Write(0x72); // Now RS=1 & RW=0 for command set
+    SPI_Write(((WORD_VAL) cmd).v[1]);
+    SPI_Write(((WORD_VAL) cmd).v[0]);
+    GPIO_WR(LCD_SPENA, 1);
+}
+
+/*********************************************************************
+ * Function:  static DWORD PageOffset(void)
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: first row of the page drawn
+ *
+ * Side Effects: none
+ *
+ * Overview: row offset of the draw buffer (USE_DOUBLE_BUFFERING) or of
+ *			the active page in the SSD1963 memory
+ * Note: none
+ ********************************************************************/
+static DWORD PageOffset(void) {
+#if defined (USE_DOUBLE_BUFFERING)
+    if (_drawbuffer == GFX_BUFFER1)
+        return (0);
+    return ((DWORD) (GetMaxY() + 1));
+#else
+    return ((DWORD) _activePage * (GetMaxY() + 1));
+#endif
+}
+
+/*********************************************************************
+ * Function:  SetArea(start_x,start_y,end_x,end_y)
+ *
+ * PreCondition: SetActivePage(page)
+ *
+ * Input: start_x, end_x	- start column and end column
+ *		 start_y,end_y 	- start row and end row position (i.e. page address)
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: defines start/end columns and start/end rows for memory access
+ *			from host to SSD1963
+ * Note: none
+ ********************************************************************/
+static void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y) {
+    DWORD offset = PageOffset();
+
+    start_y = offset + start_y;
+    end_y = offset + end_y;
+
+    WriteCommand(CMD_SET_COLUMN);
+    DisplayEnable();
+    WriteData(start_x >> 8);
+    WriteData(start_x);
+    WriteData(end_x >> 8);
+    WriteData(end_x);
+    DisplayDisable();
+    WriteCommand(CMD_SET_PAGE);
+    DisplayEnable();
+    WriteData(start_y >> 8);
+    WriteData(start_y);
+    WriteData(end_y >> 8);
+    WriteData(end_y);
+    DisplayDisable();
+}
+
+#if defined (SSD1963_DMA_CHANNEL)
+
+/*********************************************************************
+ * Function:  static void QueueNext(void)
+ *
+ * PreCondition: SSD1963 selected, DMA channel idle
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: deselects the SSD1963 and turns the PMP interrupt flag
+ *				off when the queue is empty
+ *
+ * Overview: starts the next DMA block of the fill at the head of the
+ *			queue, at most SSD1963_FILL_BLOCK pixels. The window of each
+ *			fill and CMD_WR_MEMSTART are written by the CPU, as SetArea()
+ *			does but without waiting for the queue; the channel then
+ *			writes a cell each time the PMP ends a write cycle. Finished
+ *			fills are removed from the queue.
+ *
+ * Note: called by QueueFill() and by the DMA interrupt
+ ********************************************************************/
+static void QueueNext(void) {
+    QUEUE_COMMAND *pCommand;
+    WORD count, i;
+
+    while (_queueCount) {
+        pCommand = &_queue[_queueHead];
+        if (pCommand->pixels == 0) {
+            _queueHead = (_queueHead + 1) % SSD1963_QUEUE_SIZE;
+            _queueCount--;
+            _queueWindow = FALSE;
+            continue;
+        }
+
+        if (!_queueWindow) {
+            PMPWaitBusy();
+            DisplaySetCommand();
+            DeviceWrite(CMD_SET_COLUMN);
+            DisplaySetData();
+            WriteData(pCommand->startX >> 8);
+            WriteData(pCommand->startX);
+            WriteData(pCommand->endX >> 8);
+            WriteData(pCommand->endX);
+            PMPWaitBusy();
+            DisplaySetCommand();
+            DeviceWrite(CMD_SET_PAGE);
+            DisplaySetData();
+            WriteData(pCommand->startY >> 8);
+            WriteData(pCommand->startY);
+            WriteData(pCommand->endY >> 8);
+            WriteData(pCommand->endY);
+            PMPWaitBusy();
+            DisplaySetCommand();
+            DeviceWrite(CMD_WR_MEMSTART);
+            DisplaySetData();
+            _queueWindow = TRUE;
+
+            // The block is filled again only when the color changes
+            if (!_fillValid || _fillColor != pCommand->color) {
+                for (i = 0; i < SSD1963_FILL_BLOCK; i++) {
+#if defined (USE_16BIT_PMP)
+                    _fillBuffer[i] = pCommand->color;
+#else
+                    _fillBuffer[3 * i] = pCommand->color >> 8;
+                    _fillBuffer[3 * i + 1] = pCommand->color >> 3;
+                    _fillBuffer[3 * i + 2] = pCommand->color << 3;
+#endif
+                }
+                _fillColor = pCommand->color;
+                _fillValid = TRUE;
+            }
+        }
+
+        count = (pCommand->pixels < SSD1963_FILL_BLOCK) ? pCommand->pixels : SSD1963_FILL_BLOCK;
+        pCommand->pixels -= count;
+        PMPWaitBusy();
+        INTClearFlag(INT_PMP);
+        DmaChnSetTxfer(SSD1963_DMA_CHANNEL, _fillBuffer, (void*) &PMDIN, count * FILL_PIXEL_BYTES, FILL_CELL_SIZE, FILL_CELL_SIZE);
+        DmaChnStartTxfer(SSD1963_DMA_CHANNEL, DMA_WAIT_NOT, 0); // Forces the first write
+        return;
+    }
+
+    // Queue empty
+    PMPWaitBusy();
+    PMMODEbits.IRQM = 0; // PMP interrupt flag off again
+    DisplayDisable();
+}
+
+/*********************************************************************
+ * Function:  SSD1963QueueHandler()
+ *
+ * PreCondition: none
+ *
+ * Input: none
  *
  * Output: none
  *
  * Side Effects: none
  *
- ********************************************************************/
-void SetClip(BYTE control) {
-    _clipRgn = control;
-}
-
-/*********************************************************************
- * Function:
- *
- * PreCondition: GPIO pins for the SPI port set all output prior to
- *               using this function
- * Arguments:
- *
- * Return: none
+ * Overview: DMA block done interrupt, starts the next block
  *
- * Note:
- *********************************************************************/
-static void SPI_SetReg(BYTE reg, WORD cmd) {
-    GPIO_WR(LCD_SPENA, 0); // RS=0 for index read/write, RS=1 for instruction read/write
-    SPI_Write(0x70); // This is a bitwise for (Device ID|RS|RW), therefore 0b011100|RS|RW, with RS=0, RW=0
-    SPI_Write(0x00); // register in 0x00[reg]
-    SPI_Write(reg);
-    GPIO_WR(LCD_SPENA, 1);
-
-    GPIO_WR(LCD_SPENA, 0);
-    SPI_Write(0x72); // Now RS=1 & RW=0 for command set
-    SPI_Write(((WORD_VAL) cmd).v[1]);
-    SPI_Write(((WORD_VAL) cmd).v[0]);
-    GPIO_WR(LCD_SPENA, 1);
+ * Note: none
+ ********************************************************************/
+void __ISR(SSD1963_DMA_VECTOR, ipl5) SSD1963QueueHandler(void) {
+    DmaChnClrEvFlags(SSD1963_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+    INTClearFlag(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL));
+    QueueNext();
 }
 
 /*********************************************************************
- * Function:  SetArea(start_x,start_y,end_x,end_y)
+ * Function:  static WORD QueueFill(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y)
  *
  * PreCondition: SetActivePage(page)
  *
  * Input: start_x, end_x	- start column and end column
- *		 start_y,end_y 	- start row and end row position (i.e. page address)
+ *		 start_y,end_y 	- start row and end row position, as for SetArea()
  *
- * Output: none
+ * Output: For NON-Blocking configuration:
+ *         - Returns 0 when the queue is full and the fill not queued.
+ *         - Returns 1 when the fill is queued.
+ *         For Blocking configuration:
+ *         - Waits for room in the queue and always returns 1.
  *
  * Side Effects: none
  *
- * Overview: defines start/end columns and start/end rows for memory access
- *			from host to SSD1963
+ * Overview: queues the fill of the window with the current color,
+ *			starting the DMA channel when it is idle. The DMA interrupt
+ *			is disabled meanwhile, so the queue is not changed under it.
+ *			A pending page flip is waited for first, as by SetArea(),
+ *			so the page offset is the one of the page drawn.
+ *
  * Note: none
  ********************************************************************/
-static void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y) {
+static WORD QueueFill(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y) {
+    QUEUE_COMMAND *pCommand;
     DWORD offset;
 
-#if defined (USE_DOUBLE_BUFFERING)
-    if (_drawbuffer == GFX_BUFFER1)
-        offset = 0;
-    else
-        offset = (DWORD) (GetMaxY() + 1);
+#ifdef USE_NONBLOCKING_CONFIG
+    if (_queueCount == SSD1963_QUEUE_SIZE)
+        return (0);
 #else
-    offset = (DWORD) _activePage * (GetMaxY() + 1);
+    while (_queueCount == SSD1963_QUEUE_SIZE);
 #endif
-
-    start_y = offset + start_y;
-    end_y = offset + end_y;
-
-    WriteCommand(CMD_SET_COLUMN);
-    DisplayEnable();
-    WriteData(start_x >> 8);
-    WriteData(start_x);
-    WriteData(end_x >> 8);
-    WriteData(end_x);
-    DisplayDisable();
-    WriteCommand(CMD_SET_PAGE);
-    DisplayEnable();
-    WriteData(start_y >> 8);
-    WriteData(start_y);
-    WriteData(end_y >> 8);
-    WriteData(end_y);
-    DisplayDisable();
+    WaitFlipDone();
+    offset = PageOffset();
+
+    INTEnable(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL), INT_DISABLED);
+    pCommand = &_queue[(_queueHead + _queueCount) % SSD1963_QUEUE_SIZE];
+    pCommand->startX = start_x;
+    pCommand->endX = end_x;
+    pCommand->startY = offset + start_y;
+    pCommand->endY = offset + end_y;
+    pCommand->pixels = (DWORD) (end_x - start_x + 1) * (DWORD) (end_y - start_y + 1);
+    pCommand->color = _color;
+    if (_queueCount++ == 0) {
+        // Channel idle
+        PMPWaitBusy();
+        PMMODEbits.IRQM = 1; // PMP interrupt flag at the end of each write cycle
+        DmaChnOpen(SSD1963_DMA_CHANNEL, DMA_CHN_PRI2, DMA_OPEN_DEFAULT);
+        DmaChnSetEventControl(SSD1963_DMA_CHANNEL, DMA_EV_START_IRQ(_PMP_IRQ));
+        DmaChnSetEvEnableFlags(SSD1963_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+        INTSetVectorPriority(INT_VECTOR_DMA(SSD1963_DMA_CHANNEL), INT_PRIORITY_LEVEL_5);
+        INTClearFlag(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL));
+        DisplayEnable();
+        QueueNext();
+    }
+    INTEnable(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL), INT_ENABLED);
+    return (1);
 }
+#endif // SSD1963_DMA_CHANNEL
 
 /*********************************************************************
  * Function:  SetScrollArea(SHORT top, SHORT scroll, SHORT bottom)
@@ -804,6 +1490,35 @@ void SetScrollStart(SHORT line) {
     DisplayDisable();
 }
 
+#if defined (SSD1963_TE_POLL)
+
+/*********************************************************************
+ * Function:  static WORD GetScanLine(void)
+ *
+ * Overview: Reads the line the SSD1963 is scanning out to the panel
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: scan line, 0 at the start of the vertical sync pulse
+ *
+ * Side Effects: none
+ *
+ * Note: Reference: get_scanline (0x45), SSD1963 datasheet
+ ********************************************************************/
+static WORD GetScanLine(void) {
+    WORD line;
+
+    WriteCommand(CMD_GET_SCANLINE);
+    DisplayEnable();
+    line = (DeviceRead() & 0xFF) << 8;
+    line |= DeviceRead() & 0xFF;
+    DisplayDisable();
+    return (line);
+}
+#endif
+
 /*********************************************************************
  * Function:  void EnterSleepMode (void)
  * PreCondition: none
@@ -1220,6 +1935,15 @@ void ResetDevice(void) {
     NoOfInvalidatedRectangleAreas = 0;
     _drawbuffer = GFX_BUFFER1;
     SwitchOnDoubleBuffering();
+
+#if defined (SSD1963_TE_INT)
+    // TE output high in the vertical blank, rising edge interrupt
+    SetTearingCfg(1, 0);
+    INTCONSET = SSD1963_TE_EDGE_MASK;
+    INTSetVectorPriority(SSD1963_TE_INT_VECTOR, INT_PRIORITY_LEVEL_4);
+    INTClearFlag(SSD1963_TE_SOURCE);
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
 #endif //USE_DOUBLE_BUFFERING
 
 
@@ -1323,11 +2047,81 @@ void PutPixel(SHORT x, SHORT y) {
  *
  * Overview: returns pixel color at x,y position
  *
- * Note: none
+ * Note: 0 when the memory cannot be read back, see GetRow()
  *
  ********************************************************************/
 WORD GetPixel(SHORT x, SHORT y) {
-    return 0; // TODO: Implement GetPixel
+    GFX_COLOR color;
+
+    if (GetRow(x, y, x, &color) == 0)
+        return (0);
+    return (color);
+}
+
+/*********************************************************************
+ * Function: WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer)
+ *
+ * PreCondition: none
+ *
+ * Input: left,right - first and last column
+ *        y - row
+ *        pBuffer - destination of the right-left+1 pixels
+ *
+ * Output: number of pixels read, 0 if they are not all on the screen
+ *         or the memory cannot be read back
+ *
+ * Side Effects: none
+ *
+ * Overview: reads a row of the active page (of the draw buffer with
+ *           double buffering) with a single CMD_RD_MEMSTART
+ *
+ * Note: The PMP read is pipelined: each read returns the word of the
+ *       previous one and starts the next, so a first read only starts
+ *       the burst. With USE_8BIT_PMP each pixel is read as the three
+ *       bytes written by WriteColor(). The memory is read with
+ *       USE_GFX_PMP only.
+ *
+ ********************************************************************/
+WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer) {
+#if defined (USE_GFX_PMP)
+    WORD count;
+#if defined (USE_8BIT_PMP)
+    BYTE red, green, blue;
+#endif
+
+    if (left < 0 || right > GetMaxX() || left > right || y < 0 || y > GetMaxY())
+        return (0);
+
+#if (DISP_ORIENTATION == 0)
+    SetArea(left, y, right, y);
+#elif (DISP_ORIENTATION == 90)
+    // The row is a column of the SSD1963 memory, read from its right end
+    SetArea(y, GetMaxX() - right, y, GetMaxX() - left);
+    pBuffer += right - left;
+#endif
+    WriteCommand(CMD_RD_MEMSTART);
+    DisplayEnable();
+    SingleDeviceRead(); // starts the read of the first word
+    for (count = right - left + 1; count; count--) {
+#if defined (USE_16BIT_PMP)
+        *pBuffer = SingleDeviceRead();
+#elif defined (USE_8BIT_PMP)
+        red = SingleDeviceRead();
+        green = SingleDeviceRead();
+        blue = SingleDeviceRead();
+        *pBuffer = ((WORD) (red & 0xF8) << 8) | ((WORD) (green & 0xFC) << 3) | (blue >> 3);
+#endif
+#if (DISP_ORIENTATION == 0)
+        pBuffer++;
+#elif (DISP_ORIENTATION == 90)
+        pBuffer--;
+#endif
+    }
+    DisplayDisable();
+    return (right - left + 1);
+#else
+    return (0);
+#endif
 }
 
 /*********************************************************************
@@ -1343,7 +2137,9 @@ WORD GetPixel(SHORT x, SHORT y) {
  *
  * Side Effects: none
  *
- * Overview: draws rectangle filled with current color
+ * Overview: draws rectangle filled with current color. With
+ *           SSD1963_DMA_CHANNEL the rectangle is queued for the DMA
+ *           channel; busy then means the queue is full.
  *
  * Note: none
  *
@@ -1351,7 +2147,10 @@ WORD GetPixel(SHORT x, SHORT y) {
 //#ifdef USE_DRV_BAR
 
 WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
-    register SHORT x, y;
+#if defined (USE_NONBLOCKING_CONFIG) && !defined (SSD1963_DMA_CHANNEL)
+    if (IsDeviceBusy())
+        return (0);
+#endif
 
     if (_clipRgn) {
         if (left < _clipLeft)
@@ -1363,7 +2162,16 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
         if (bottom > _clipBottom)
             bottom = _clipBottom;
     }
+    if (left > right || top > bottom)
+        return (1);
 
+#if defined (SSD1963_DMA_CHANNEL)
+#if (DISP_ORIENTATION==0)
+    return (QueueFill(left, top, right, bottom));
+#elif (DISP_ORIENTATION==90)
+    return (QueueFill(top, GetMaxX()-right, bottom, GetMaxX()-left));
+#endif
+#else
 #if (DISP_ORIENTATION==0)
     SetArea(left, top, right, bottom);
 #elif (DISP_ORIENTATION==90)
@@ -1377,17 +2185,9 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
     WriteCommand(CMD_WR_MEMSTART);
 
     DisplayEnable();
-    for (y = top; y < bottom + 1; y++) {
-        for (x = left; x < right + 1; x++) {
-#if defined (USE_16BIT_PMP)
-            WriteData(_color);
-#elif defined (USE_8BIT_PMP)
-            WriteColor(_color);
-#endif
-        }
-    }
-    DisplayDisable();
+    FillWindow((DWORD) (right - left + 1) * (DWORD) (bottom - top + 1));
     return (1);
+#endif
 }
 //#endif
 
@@ -1404,12 +2204,17 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
  *
  * Overview: clears screen with current color
  *
- * Note: none
+ * Note: queued for the DMA channel with SSD1963_DMA_CHANNEL
  *
  ********************************************************************/
 void ClearDevice(void) {
-    //DWORD xcounter, ycounter, counter; //depreciated
-    DWORD counter;
+#if defined (SSD1963_DMA_CHANNEL)
+#if (DISP_ORIENTATION == 0) || (DISP_ORIENTATION == 180)	
+    while (!QueueFill(0, 0, GetMaxX(), GetMaxY()));
+#elif (DISP_ORIENTATION == 90)|| (DISP_ORIENTATION == 270)
+    while (!QueueFill(0, 0, GetMaxY(), GetMaxX()));
+#endif	
+#else
 #if (DISP_ORIENTATION == 0) || (DISP_ORIENTATION == 180)	
     SetArea(0, 0, GetMaxX(), GetMaxY());
 #elif (DISP_ORIENTATION == 90)|| (DISP_ORIENTATION == 270)
@@ -1419,33 +2224,8 @@ void ClearDevice(void) {
     WriteCommand(CMD_WR_MEMSTART);
 
     DisplayEnable();
-    for (counter = 0; counter < (DWORD)(GetMaxY() + 1)*(DWORD)(GetMaxX() + 1); counter++) {
-#if defined (USE_16BIT_PMP)
-        WriteData(_color);
-#elif defined (USE_8BIT_PMP)
-        WriteColor(_color);
+    FillWindow((DWORD)(GetMaxY() + 1)*(DWORD)(GetMaxX() + 1));
 #endif
-    }
-    DisplayDisable();
-
-    /*
-            //depreciated
-            for(ycounter=0;ycounter<GetMaxY()+1;ycounter++)
-            {
-                    for(xcounter=0;xcounter<GetMaxX()+1;xcounter++)
-                    {
-
-                            #if defined (USE_16BIT_PMP)
-                                    WriteData(_color+xcounter+ycounter);
-                            #elif defined (USE_8BIT_PMP)
-                                    WriteColor(_color);
-                            #endif
-
-                    }
-            }
-     */
-
-
 }
 
 
@@ -1742,6 +2522,162 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch)
  */
 //#endif
 
+// Part of a stretched image left on the screen by the clipping
+typedef struct {
+    SHORT left, top, right, bottom; // Screen window
+    WORD x, y;                      // First image column and line drawn
+    WORD columns;                   // Image columns drawn
+    BYTE skipX, skipY;              // Copies of the first column and line clipped away
+} IMAGE_CLIP;
+
+/*********************************************************************
+ * Function: static BOOL ClipImage(SHORT left, SHORT top, WORD width,
+ *                                 WORD height, BYTE stretch, IMAGE_CLIP *pClip)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, width,height - image size,
+ *        stretch - image stretch factor, pClip - part drawn
+ *
+ * Output: FALSE if no pixel of the image is on the screen
+ *
+ * Side Effects: none
+ *
+ * Overview: clips the stretched image once to the screen and to the
+ *           clipping region, and finds the image pixels left
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static BOOL ClipImage(SHORT left, SHORT top, WORD width, WORD height, BYTE stretch, IMAGE_CLIP *pClip) {
+    LONG right = left + (LONG) width * stretch - 1;
+    LONG bottom = top + (LONG) height * stretch - 1;
+    SHORT minX = 0, minY = 0, maxX = GetMaxX(), maxY = GetMaxY();
+
+    if (_clipRgn) {
+        if (_clipLeft > minX)
+            minX = _clipLeft;
+        if (_clipTop > minY)
+            minY = _clipTop;
+        if (_clipRight < maxX)
+            maxX = _clipRight;
+        if (_clipBottom < maxY)
+            maxY = _clipBottom;
+    }
+    if (right < minX || bottom < minY || left > maxX || top > maxY)
+        return (FALSE);
+
+    pClip->left = (left < minX) ? minX : left;
+    pClip->top = (top < minY) ? minY : top;
+    pClip->right = (right > maxX) ? maxX : (SHORT) right;
+    pClip->bottom = (bottom > maxY) ? maxY : (SHORT) bottom;
+    if (pClip->left > pClip->right || pClip->top > pClip->bottom)
+        return (FALSE);
+
+    pClip->x = (pClip->left - left) / stretch;
+    pClip->skipX = (pClip->left - left) % stretch;
+    pClip->y = (pClip->top - top) / stretch;
+    pClip->skipY = (pClip->top - top) % stretch;
+    pClip->columns = (pClip->right - left) / stretch - pClip->x + 1;
+    return (TRUE);
+}
+
+/*********************************************************************
+ * Function: static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip)
+ *
+ * PreCondition: none
+ *
+ * Input: pLine - image pixels, stretched in place, width - screen pixels,
+ *        stretch - image stretch factor, skip - copies of the first
+ *        pixel clipped away
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: repeats each pixel stretch times, from the end of the line
+ *           so that no pixel is overwritten before it is copied
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip) {
+    WORD src = (width - 1 + skip) / stretch;
+    BYTE copies = (width - 1 + skip) % stretch + 1;
+
+    while (width) {
+        pLine[--width] = pLine[src];
+        if (--copies == 0) {
+            src--;
+            copies = stretch;
+        }
+    }
+}
+
+/*********************************************************************
+ * Function: static void WriteLine(WORD *pLine, WORD count)
+ *
+ * PreCondition: Window set by SetArea(), CMD_WR_MEMSTART written and
+ *				SSD1963 selected by DisplayEnable()
+ *
+ * Input: pLine - pixels, count - number of pixels
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: writes the pixels with a loop unrolled by 8
+ *
+ * Note: none
+ ********************************************************************/
+static void WriteLine(WORD *pLine, WORD count) {
+    WORD n;
+#if defined (USE_16BIT_PMP)
+    #define LinePixel(i) WriteData(pLine[i])
+#else
+    #define LinePixel(i) WriteColor(pLine[i])
+#endif
+
+    for (n = count >> 3; n; n--, pLine += 8) {
+        LinePixel(0); LinePixel(1); LinePixel(2); LinePixel(3);
+        LinePixel(4); LinePixel(5); LinePixel(6); LinePixel(7);
+    }
+    for (n = count & 7; n; n--, pLine++) {
+        LinePixel(0);
+    }
+#undef LinePixel
+}
+
+/*********************************************************************
+ * Function: static void WriteRun(SHORT first, SHORT y, WORD *pLine, WORD count)
+ *
+ * PreCondition: none
+ *
+ * Input: first - first SSD1963 address of the run along the row,
+ *        y - row, pLine - pixels, count - number of pixels
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: writes a part of a row in its own window. With
+ *			DISP_ORIENTATION 90 the row is a column of the SSD1963
+ *			memory, written from its right end.
+ *
+ * Note: none
+ ********************************************************************/
+static void WriteRun(SHORT first, SHORT y, WORD *pLine, WORD count) {
+#if (DISP_ORIENTATION == 0)
+    SetArea(first, y, first + count - 1, y);
+#elif (DISP_ORIENTATION == 90)
+    SetArea(y, first, y, first + count - 1);
+#endif
+    WriteCommand(CMD_WR_MEMSTART);
+    DisplayEnable();
+    WriteLine(pLine, count);
+    DisplayDisable();
+}
+
 //#ifdef USE_BITMAP_EXTERNAL
 /*********************************************************************
  * Function: void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
@@ -1996,7 +2932,7 @@ void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: outputs hicolor image starting from left,top coordinates
  *
  * Note: image must be located in external memory
  *
@@ -2006,93 +2942,92 @@ void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
 {
     register DWORD  memOffset;
     BITMAP_HEADER   bmp;
+    IMAGE_CLIP      clip;
     WORD            lineBuffer[(GetMaxX() + 1)];
-    WORD            *pData;
-    WORD            byteWidth;
-
-    WORD            temp;
-    WORD            sizeX, sizeY;
-    WORD            x, y;
-    WORD            xc, yc;
-
+    DWORD           byteWidth;
+    WORD            width;
+    SHORT           first, y;
+    BYTE            copies;
+    BOOL            stream = TRUE;
 
     // Get image header
     ExternalMemoryCallback(bitmap, 0, sizeof(BITMAP_HEADER), &bmp);
-     
-    // Set offset to the image data
-    memOffset = sizeof(BITMAP_HEADER);
-    
-    // Get size
-
-    sizeX = bmp.width/stretch;          //   *stretch/100;
-    sizeY = bmp.height/stretch;        //   *stretch/100;
-    
-    byteWidth = bmp.width << 1;
-    
-#if (DISP_ORIENTATION==0)
-    SetArea(left, top, right, bottom);
-#elif (DISP_ORIENTATION==90)
-    SetArea(top, GetMaxX() - sizeX - left + 1, top + sizeY - 1, GetMaxX() - left);
-#endif    
+    if (!ClipImage(left, top, bmp.width, bmp.height, stretch, &clip))
+        return;
 
-    WriteCommand(CMD_WR_MEMSTART);
-    DisplayEnable(); //already enabled .. can be ignored
-///////////      
-   
-    if (stretch == IMAGE_NORMAL)
-    {
-        for(y = 0; y < sizeY; y++)
-        {
-            // Get line
-            ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-            memOffset += byteWidth;
-            
-            pData = lineBuffer;
-
-            for(x = 0; x < sizeX; x++)
-                {
-                temp = *pData++;
-                SetColor(temp);
-
-                #ifdef USE_TRANSPARENT_COLOR
-                    if (!((GetTransparentColor() == GetColor()) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)))
-                #endif
-                        WriteData(_color);
-            }          
-        }
-        DisplayDisable();
+    // Set offset to the first pixel drawn
+    byteWidth = (DWORD) bmp.width << 1;
+    memOffset = sizeof(BITMAP_HEADER) + clip.y * byteWidth + ((DWORD) clip.x << 1);
+
+    width = clip.right - clip.left + 1;
+    copies = stretch - clip.skipY;
+
+#if (DISP_ORIENTATION == 0)
+    first = clip.left;
+#elif (DISP_ORIENTATION == 90)
+    first = GetMaxX() - clip.right;
+    stream = FALSE;
+#endif
+#ifdef USE_TRANSPARENT_COLOR
+    if (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)
+        stream = FALSE;
+#endif
+
+    // Without transparent pixels the rows of the window are written in one go
+    if (stream) {
+        SetArea(clip.left, clip.top, clip.right, clip.bottom);
+        WriteCommand(CMD_WR_MEMSTART);
     }
-    else
-    {
-         ///stretch
-        
-        for(y = 0; y < sizeY; y++)
+
+    for (y = clip.top; y <= clip.bottom; ) {
+        // Get line
+        ExternalMemoryCallback(bitmap, memOffset, clip.columns << 1, lineBuffer);
+        memOffset += byteWidth;
+        if (stretch > 1)
+            StretchLine(lineBuffer, width, stretch, clip.skipX);
+#if (DISP_ORIENTATION == 90)
         {
-            // Get line
-            ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-            memOffset += byteWidth*stretch; 
-            pData = lineBuffer;
-            
-            xc = left;
-            for(x = 0; x < sizeX; x++)
-                {
-
-                pData+=stretch;
-                temp = *pData;
-                SetColor(temp);
-    
-                #ifdef USE_TRANSPARENT_COLOR
-                    if (!((GetTransparentColor() == GetColor()) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)))
-                #endif
-                    {
-                        WriteData(_color);
-
-                    }                    
+            // The row is written from its right end
+            WORD n, temp;
+
+            for (n = 0; n < width / 2; n++) {
+                temp = lineBuffer[n];
+                lineBuffer[n] = lineBuffer[width - 1 - n];
+                lineBuffer[width - 1 - n] = temp;
             }
-          
         }
-        DisplayDisable();
-    }    
+#endif
+
+        do {
+            if (stream) {
+                DisplayEnable();
+                WriteLine(lineBuffer, width);
+                DisplayDisable();
+            }
+#ifdef USE_TRANSPARENT_COLOR
+            else if (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE) {
+                // Each run of opaque pixels in its own window
+                WORD start = 0, n;
+
+                while (start < width) {
+                    if (lineBuffer[start] == GetTransparentColor()) {
+                        start++;
+                        continue;
+                    }
+                    for (n = start + 1; n < width && lineBuffer[n] != GetTransparentColor(); n++)
+                        ;
+                    WriteRun(first + start, y, lineBuffer + start, n - start);
+                    start = n;
+                }
+            }
+#endif
+            else {
+                WriteRun(first, y, lineBuffer, width);
+            }
+            y++;
+        } while (--copies && y <= clip.bottom);
+        copies = stretch;
+    }
 }
 
 //#endif
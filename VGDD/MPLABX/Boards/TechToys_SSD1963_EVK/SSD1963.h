@@ -179,6 +179,50 @@
 // Define this to implement PutImage function in the driver.
 //#define USE_DRV_PUTIMAGE
 
+/*********************************************************************
+* Overview: Bar() and ClearDevice() fills on a DMA channel (PIC32 with
+*           USE_GFX_PMP). Define SSD1963_DMA_CHANNEL (0 to 7) in
+*           HardwareProfile.h to enable them; the fills are queued and
+*           return while the channel writes the pixels. IsDeviceBusy()
+*           returns the fills queued; with USE_NONBLOCKING_CONFIG, Bar()
+*           returns 0 while the queue is full.
+*           SSD1963_QUEUE_SIZE sets the fills queued (default 8),
+*           SSD1963_FILL_BLOCK the pixels of each DMA block (default
+*           256; 127 on the 16 bit PMP and 85 on the 8 bit one on
+*           PIC32MX3xx/4xx, whose DMA blocks are 255 bytes at most, and a
+*           larger block is an error there).
+*********************************************************************/
+//#define SSD1963_DMA_CHANNEL 2
+//#define SSD1963_QUEUE_SIZE  8
+//#define SSD1963_FILL_BLOCK  256
+
+/*********************************************************************
+* Overview: GetPixel() and GetRow() read the memory back with
+*           USE_GFX_PMP only, and return 0 otherwise.
+*           GFX_DRV_GETPIXEL tells the widgets that save the screen
+*           (SuperGauge SG_DIAL_CACHE) that they can.
+*********************************************************************/
+#if defined (USE_GFX_PMP)
+#define GFX_DRV_GETPIXEL
+#endif
+
+/*********************************************************************
+* Overview: Page flip in the vertical blank (USE_DOUBLE_BUFFERING).
+*           Wire the TE output of the SSD1963 to an INTx pin and define
+*           SSD1963_TE_INT (0 to 4) in HardwareProfile.h: the flip
+*           requested by RequestDisplayUpdate() is done by the TE
+*           interrupt. Without it the scan line is polled through the
+*           PMP (USE_GFX_PMP) before each flip.
+*           SSD1963_FLIP_FRAMES (default 1) caps the flips to one every
+*           that many panel refreshes, e.g. 2 for 30 fps on a 60 Hz panel.
+*           A flip the TE interrupt does not do within SSD1963_FLIP_TIMEOUT
+*           ms (default 100) is done by the waiting code, so a missing TE
+*           wire or disabled interrupts cannot hang the drawing.
+*********************************************************************/
+//#define SSD1963_TE_INT      1
+//#define SSD1963_FLIP_FRAMES 2
+//#define SSD1963_FLIP_TIMEOUT 100
+
 
 /*********************************************************************
 * PARAMETERS VALIDATION
@@ -224,6 +268,16 @@ typedef struct
 	#define GFX_MAX_INVALIDATE_AREAS 5
     #define GFX_BUFFER1 (GFX_DISPLAY_BUFFER_START_ADDRESS)
     #define GFX_BUFFER2 (GFX_DISPLAY_BUFFER_START_ADDRESS + GFX_REQUIRED_DISPLAY_BUFFER_SIZE_IN_BYTES)
+
+typedef struct
+{
+    DWORD Flips;        // Pages flipped
+    DWORD Refreshes;    // Vertical blanks seen: every one with SSD1963_TE_INT, else the ones waited for
+    DWORD Deferred;     // Blanks in which a queued flip waited for a DMA fill
+    DWORD Timeouts;     // Queued flips done without the TE interrupt (SSD1963_FLIP_TIMEOUT)
+    WORD LastFrame;     // Panel refreshes between the last two flips (SSD1963_TE_INT)
+    WORD MaxFrame;      // Longest LastFrame since ResetFrameStats()
+} SSD1963_FRAME_STATS;
 #endif
 
 /*********************************************************************
@@ -382,6 +436,56 @@ void SetBacklight(BYTE intensity);
 ********************************************************************/
 void SetTearingCfg(BOOL state, BOOL mode);
 
+/*********************************************************************
+* Function: WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer)
+*
+* Overview: Reads the pixels left to right of row y of the active page
+*			in one burst, e.g. to save the screen under a popup
+*
+* PreCondition: none
+*
+* Input: left,right - first and last column
+*		 y - row
+*		 pBuffer - destination of the right-left+1 pixels
+*
+* Output: number of pixels read, 0 if they are not all on the screen
+*		  or the memory cannot be read back (needs USE_GFX_PMP)
+*
+* Note:
+********************************************************************/
+WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer);
+
+#if defined (USE_DOUBLE_BUFFERING)
+/*********************************************************************
+* Function: void GetFrameStats(SSD1963_FRAME_STATS *pStats)
+*
+* Overview: Copies the page flip statistics, see SSD1963_FRAME_STATS.
+*           LastFrame times the refresh period gives the frame time.
+*
+* PreCondition: none
+*
+* Input: pStats - destination
+*
+* Output: none
+*
+********************************************************************/
+void GetFrameStats(SSD1963_FRAME_STATS *pStats);
+
+/*********************************************************************
+* Function: void ResetFrameStats(void)
+*
+* Overview: Clears the page flip statistics
+*
+* PreCondition: none
+*
+* Input: none
+*
+* Output: none
+*
+********************************************************************/
+void ResetFrameStats(void);
+#endif
+
 
 /************************************************************************
 * Macro: Lo                                                             *
@@ -51,6 +51,34 @@ const unsigned int eedata_addr[NUM_DATA_EE_PAGES][NUMBER_OF_INSTRUCTIONS_IN_PAGE
 
 unsigned int lowerAddress = 0;     // to identify the read/write pointer address location
 DATA_EE_FLAGS dataEEFlags;         //Flags for the error/warning condition. 
+DATA_EE_STATS dataEEStats;         //Counters for the write buffer and the flash wear.
+
+#if (DATA_EE_WRITE_BUFFER < 1) || (DATA_EE_WRITE_BUFFER >= DATA_EE_SLOTS_IN_PAGE)
+#error "DATA_EE_WRITE_BUFFER must be between 1 and the number of entries in a page"
+#endif
+
+// An entry is a 16-bit address (checksum in the 6 MSBits) in the address region of a page
+// and the 32-bit data in the data region. Even entries use the upper half of the address word.
+#define DEE_ADDRESS_WORD(page, slot)    ((volatile const unsigned int *)&eedata_addr[(page)-1][4 + ((slot) >> 1)])
+#define DEE_DATA_WORD(page, slot)       ((volatile const unsigned int *)&eedata_addr[(page)-1][4 + DATA_OFFSET/4 + (slot)])
+
+// RAM index of the entry holding the most recent value of each address:
+// page in the 4 MSBits, entry in the page in the 12 LSBits.
+#define DEE_NO_ENTRY                    0xFFFF
+#define DEE_ENTRY(page, slot)           ((unsigned short)(((page) << 12) | (slot)))
+#define DEE_ENTRY_PAGE(entry)           ((entry) >> 12)
+#define DEE_ENTRY_SLOT(entry)           ((entry) & 0xFFF)
+
+static unsigned short deeIndex[DATA_EE_SIZE];
+static unsigned char deeIndexValid = 0;     // deeIndex matches the pages
+static unsigned char deeCurrentPage;
+static unsigned char deeActivePages;
+static unsigned int deeNextSlot;            // first free entry of the current page
+
+// Write buffer, one value per address
+static unsigned short deePendingAddr[DATA_EE_WRITE_BUFFER];
+static unsigned int deePendingData[DATA_EE_WRITE_BUFFER];
+static unsigned int deePendingCount = 0;
 
 /****************************************************************************
  * Function:        GetPageStatus
@@ -132,6 +160,7 @@ unsigned int ErasePage(unsigned char page)
         if(!retCode)
             retCode = NVMWriteWord((void*)eedata_addr[page-1], currentStatus); //update the status bits
     }
+    dataEEStats.eraseCount[page-1] = currentStatus & 0xFFFF;
     
     if(retCode & _NVMCON_LVDERR_MASK)
     {
@@ -276,6 +305,295 @@ unsigned char EmulationCheckSum(unsigned int data)
    return sum;
 }
 
+/****************************************************************************
+ * Function:        DEEWriteResult
+ *
+ * PreCondition:    None
+ *
+ * Input:           retCode : NVMCON error bits of a flash operation
+ *
+ * Output:          value 0 for success.
+ *                  Value 7 for write error.
+ *                  Value 8 for Low voltage operation.
+ *
+ * Side Effects:    Data EE flags may be updated.
+ *
+ * Overview:        This routine turns the error bits of a program/erase operation into
+ *                  the Data EE flags and error code.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEEWriteResult(unsigned int retCode)
+{
+    if(retCode & _NVMCON_LVDERR_MASK)
+    {
+        SetLowVoltageError(1);
+        return (8);
+    }
+    else if(retCode & _NVMCON_WRERR_MASK)
+    {
+        SetPageWriteError(1);
+        return (7);
+    }
+    return 0;
+}
+
+/****************************************************************************
+ * Function:        DEEIndexPage
+ *
+ * PreCondition:    None
+ *
+ * Input:           page : Page number
+ *
+ * Output:          Number of entries programmed in the page
+ *
+ * Side Effects:    None
+ *
+ * Overview:        This routine scans the address region of the page forward, so that the
+ *                  last entry of each address is the one left in the RAM index.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEEIndexPage(unsigned int page)
+{
+    unsigned int slot;
+    unsigned int addrRead;
+
+    for(slot = 0; slot < DATA_EE_SLOTS_IN_PAGE; slot++)
+    {
+        addrRead = *DEE_ADDRESS_WORD(page, slot);
+        if(!(slot & 1))
+            addrRead >>= 16;
+        if((addrRead & 0xFFFF) == 0xFFFF)
+            break; // first available location
+        if((addrRead & 0x3FF) < DATA_EE_SIZE)
+            deeIndex[addrRead & 0x3FF] = DEE_ENTRY(page, slot);
+    }
+    return slot;
+}
+
+/****************************************************************************
+ * Function:        DEELoadIndex
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          Check the dataEEFlags for the error status.
+ *                  value 0 for success.
+ *                  Value 3 for three active pages.
+ *                  Value 6 for page corrupt status.
+ *
+ * Side Effects:    Data EE flags may be updated.
+ *
+ * Overview:        This routine finds the active pages and builds the RAM index from them,
+ *                  the page before the current one first. It also finds the first
+ *                  available location of the current page and reads the erase counts.
+ *                  It is called by DataEEInit, and again after a failed write since the
+ *                  index may not match the pages any more.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEELoadIndex(void)
+{
+    unsigned int currentPage=0;
+    unsigned int activePage=0;
+    unsigned int pageCount;
+    unsigned int i;
+
+    deeIndexValid = 0;
+
+    // Find the current active page.
+    for (pageCount = 1; pageCount <= NUM_DATA_EE_PAGES; pageCount++)
+    {
+      if(GetPageStatus(pageCount, STATUS_ACTIVE) == PAGE_ACTIVE)
+      {
+         activePage++;
+         if(GetPageStatus(pageCount, STATUS_CURRENT) == PAGE_CURRENT)
+         {
+            currentPage = pageCount;
+         }
+      }
+    }
+
+    if(activePage == NUM_DATA_EE_PAGES)
+    {
+       SetPagePackBeforeInit(1);
+       return(3);
+    }
+    if((activePage == 0) || (currentPage == 0))
+    {
+       SetPageCorruptStatus(1);
+       return(6);
+    }
+
+    for(i = 0; i < DATA_EE_SIZE; i++)
+        deeIndex[i] = DEE_NO_ENTRY;
+    if(activePage == 2)
+        DEEIndexPage(PrevPage(currentPage));
+    deeNextSlot = DEEIndexPage(currentPage);
+    deeCurrentPage = currentPage;
+    deeActivePages = activePage;
+
+    for(i = 0; i < NUM_DATA_EE_PAGES; i++)
+        dataEEStats.eraseCount[i] = eedata_addr[i][0] & 0xFFFF;
+
+    deeIndexValid = 1;
+    return(0);
+}
+
+/****************************************************************************
+ * Function:        DEEReadEntry
+ *
+ * PreCondition:    None
+ *
+ * Input:           Read pointer and RAM index entry
+ *
+ * Output:          value 0 for success.
+ *                  Value 6 for page corrupt status.
+ *
+ * Side Effects:    Data EE flags may be updated.
+ *
+ * Overview:        This routine reads the data of the entry and checks it against the
+ *                  checksum stored with the address.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEEReadEntry(unsigned int *data, unsigned short entry)
+{
+    unsigned int page = DEE_ENTRY_PAGE(entry);
+    unsigned int slot = DEE_ENTRY_SLOT(entry);
+    unsigned int addrRead;
+
+    addrRead = *DEE_ADDRESS_WORD(page, slot);
+    if(!(slot & 1))
+        addrRead >>= 16;
+    *data = *DEE_DATA_WORD(page, slot);
+    if(((addrRead & 0xFC00)>>0xA) != EmulationCheckSum(*data))
+    {
+        SetPageCorruptStatus(1);
+        return(6);
+    }
+    return(0);
+}
+
+/****************************************************************************
+ * Function:        DEEProgramEntry
+ *
+ * PreCondition:    The entry is available
+ *
+ * Input:           page : Page number
+ *                  slot : Entry in the page
+ *                  Data EE data and address
+ *
+ * Output:          value 0 for success.
+ *                  Value 7 for write error.
+ *                  Value 8 for Low voltage operation.
+ *
+ * Side Effects:    Data EE flags may be updated. CPU stall occurs for flash
+ *                  programming.
+ *
+ * Overview:        This routine programs the address, with the data checksum in its 6
+ *                  MSBits, and the data of the entry, then verifies them.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEEProgramEntry(unsigned int page, unsigned int slot, unsigned int data, unsigned int addr)
+{
+    volatile const unsigned int *addrLoc = DEE_ADDRESS_WORD(page, slot);
+    volatile const unsigned int *dataLoc = DEE_DATA_WORD(page, slot);
+    unsigned int entry;
+    unsigned int addrRead;
+    unsigned int retCode;
+
+    entry = ((unsigned int)EmulationCheckSum(data) << 0xA) | addr;
+    Delay10us(2);
+    if(slot & 1)
+        retCode = NVMWriteWord((void*)addrLoc, entry | 0xFFFF0000); //Writing address to the lower half
+    else
+        retCode = NVMWriteWord((void*)addrLoc, (entry << 16) | 0xFFFF); //Writing address to the upper half
+    if(!retCode)
+    {
+        Delay10us(2);
+        retCode = NVMWriteWord((void*)dataLoc, data); //Writing data to the location
+    }
+    if((retCode = DEEWriteResult(retCode)) != 0)
+        return retCode;
+
+    //Check whether data and address are written correctly.
+    addrRead = *addrLoc;
+    if(!(slot & 1))
+        addrRead >>= 16;
+    if(((addrRead & 0xFFFF) != entry) || (data != *dataLoc))
+    {
+        SetPageWriteError(1);
+        return(7);  //Error - RAM does not match PM
+    }
+    dataEEStats.programmed++;
+    return(0);
+}
+
+/****************************************************************************
+ * Function:        DEEQueueWrite
+ *
+ * PreCondition:    None
+ *
+ * Input:           Data EE address and data
+ *
+ * Output:          Same as DataEEWrite
+ *
+ * Side Effects:    Data EE flags may be updated. The write buffer is programmed
+ *                  when full.
+ *
+ * Overview:        This routine replaces the value of the address in the write buffer, or
+ *                  adds it there if it differs from the programmed one.
+ *
+ * Note:            This is a private function.
+ *****************************************************************************/
+static unsigned int DEEQueueWrite(unsigned int data, unsigned int addr)
+{
+    unsigned int i;
+    unsigned int dataRead;
+    unsigned int retCode;
+
+    if(addr >= DATA_EE_SIZE)
+    {
+        SetPageIllegalAddress(1);
+        return(5);
+    }
+    if(!deeIndexValid && ((retCode = DEELoadIndex()) != 0))
+        return retCode;
+
+    dataEEStats.writes++;
+    for(i = 0; i < deePendingCount; i++)
+    {
+        if(deePendingAddr[i] == addr)
+        {
+            deePendingData[i] = data;
+            dataEEStats.coalesced++;
+            return(0);
+        }
+    }
+
+    //Do not write data if it did not change
+    if(deeIndex[addr] != DEE_NO_ENTRY)
+    {
+        if(DEEReadEntry(&dataRead, deeIndex[addr]) != 0)
+            return(6); //error condition
+        if(dataRead == data)
+        {
+            dataEEStats.unchanged++;
+            return(0);
+        }
+    }
+
+    if((deePendingCount == DATA_EE_WRITE_BUFFER) && ((retCode = DataEEFlush()) != 0))
+        return retCode;
+    deePendingAddr[deePendingCount] = addr;
+    deePendingData[deePendingCount++] = data;
+    return(0);
+}
+
 /****************************************************************************
  * Function:        DataEEInit
  *
@@ -297,7 +615,9 @@ unsigned char EmulationCheckSum(unsigned int data)
  *                  first unexpired page is initialized for emulation. If one or two active pages
  *                  found, it assumes a reset occurred and the function does nothing. If
  *                  three active pages are found, it is assumes a reset occurred during a pack.
- *                  The page after current is erased and a pack is called. This
+ *                  The page after current is erased and a pack is called. The RAM index
+ *                  of the entry holding each address is then built from the active
+ *                  pages, so that reads and writes do not search the pages. This
  *                  function must be called prior to any other operation.
  *
  * Note:            This is a public function.
@@ -312,6 +632,8 @@ unsigned int DataEEInit(void)
     int i;
     
     dataEEFlags.val = 0;
+    deeIndexValid = 0;
+    deePendingCount = 0;
     //Erase the whlole emulation page for the first time
     for(i=0; i<3; i++)
     {
@@ -385,7 +707,7 @@ unsigned int DataEEInit(void)
             SetPageWriteError(1);
             return (7);
         }
-        return(0);
+        return(DEELoadIndex());
     }
     //If Full active pages, erase the page after the current page
     else if(activePage == NUM_DATA_EE_PAGES)
@@ -396,12 +718,12 @@ unsigned int DataEEInit(void)
         {
             PackEE();
         }
-        return(0);
+        return(DEELoadIndex());
     }
-    //If some active pages, do nothing
+    //If some active pages, only build the index
     else if(activePage > 0)
     {
-        return(0);
+        return(DEELoadIndex());
     }
     else
     {
@@ -430,158 +752,27 @@ unsigned int DataEEInit(void)
  *                  programming. Pack may be generated.
  *
  * Overview:        This routine verifies the address is valid. If not, the Illegal Address
- *                  flag is set and an error code is returned. It then finds the active page.
- *                  If an active page can not be found, the Page Corrupt status bit is set
- *                  and an error code is returned. A read is performed, if the data was not
- *                  changed, the function exits. If the last location is programmed, the Pack
- *                  Skipped error flag is set (one location should always be available). The
- *                  data EE information address and data is programmed and verified. The data
- *                  checksum is written along with the address. 10 LSBits are allocated for 
- *                  address and 6 bits are allotted for checksum. If the verify fails, 
- *                  the Write Error flag is set. If the write went into the last location 
- *                  of the page, pack is called. This function can be called by the user.
+ *                  flag is set and an error code is returned. A write to an address still
+ *                  in the write buffer replaces its value there. Otherwise, if the data
+ *                  was not changed, the function exits, else it is added to the write
+ *                  buffer. A full buffer is programmed by DataEEFlush. Unless
+ *                  DATA_EE_WRITE_BACK is defined, DataEEFlush is also called before
+ *                  returning, so the data is programmed as it used to be. This function
+ *                  can be called by the user.
  *
  * Note:            This is a public function.
  *****************************************************************************/
 unsigned int DataEEWrite(unsigned int data, unsigned int addr)
 {
-    int currentPage=0;
-    int pageCount;
-    unsigned int nextAddLoc;
-    unsigned int addLoc;
-    int addrIndex;
-    unsigned int nextDataLoc;
-    unsigned int activePage=0;
-    unsigned int addCheckSum;
-    unsigned int dataRead;
     unsigned int retCode;
 
-    if(addr >= DATA_EE_SIZE)
-    {
-        SetPageIllegalAddress(1);
-        return(5);
-    }
-
-    // Find the current active page.
-    for (pageCount = 1; pageCount <= NUM_DATA_EE_PAGES; pageCount++)
-    {
-      if(GetPageStatus(pageCount, STATUS_ACTIVE) == PAGE_ACTIVE)
-      {
-         activePage++;
-         if(GetPageStatus(pageCount, STATUS_CURRENT) == PAGE_CURRENT)
-         {
-            currentPage = pageCount;
-         }
-      }
-    }
-
-    if(activePage == 0)
-    {
-        SetPageCorruptStatus(1);
-        return (6);
-    }
-    //Do not write data if it did not change
-    if((DataEERead(&dataRead,addr) != 0) && (dataEEFlags.val >1))
-    {
-        return (6); //error condition
-    }
-    if(dataRead == data)
-    {
-        return(0);
-    }
-    
-    addrIndex = GetNextAvailCount();
-    if(addrIndex == 0xFFFF)//Page Full
-    {
-        SetPagePackSkipped(1);
-        return(4);  //Error - Number of writes exceeds page size
-    }
-    addLoc = (unsigned int)eedata_addr[currentPage-1]+16;
-    nextAddLoc = addLoc + addrIndex;
-    addCheckSum = (unsigned int)EmulationCheckSum(data);
-    addCheckSum = addCheckSum << 0xA;
-    if(lowerAddress == 0)
-    {
-        addr = ((addCheckSum | addr)<<16)|0xFFFF;
-        Delay10us(2);
-        retCode = NVMWriteWord((void*)(nextAddLoc), addr); //Writing address to the location
-        nextDataLoc = (addrIndex*2) + DATA_OFFSET + addLoc;
-        if(!retCode)
-            Delay10us(2);
-            retCode = NVMWriteWord((void*)(nextDataLoc), data); //Writing data to the location
-        if(retCode & _NVMCON_LVDERR_MASK)
-        {
-            SetLowVoltageError(1);
-            return (8);
-        }
-        else if(retCode & _NVMCON_WRERR_MASK)
-        {
-            SetPageWriteError(1);
-            return (7);
-        }
-        //Check whether data and address are written correctly.
-        if((addr != (*(int *)(nextAddLoc))) || (data != (*(int *)(nextDataLoc))))
-        {
-            SetPageWriteError(1);
-            return(7);  //Error - RAM does not match PM
-        }
-    }
-    else if(lowerAddress == 1)
-    {
-        addr = addCheckSum | addr | 0xFFFF0000;
-        Delay10us(2);
-        retCode = NVMWriteWord((void*)(nextAddLoc), addr); //Writing address to the location
-        nextDataLoc = (addrIndex*2) + DATA_OFFSET + 4 + addLoc;
-        if(!retCode)
-            Delay10us(2);
-            retCode = NVMWriteWord((void*)(nextDataLoc), data); //Writing data to the location
-        if(retCode & _NVMCON_LVDERR_MASK)
-        {
-            SetLowVoltageError(1);
-            return (8);
-        }
-        else if(retCode & _NVMCON_WRERR_MASK)
-        {
-            SetPageWriteError(1);
-            return (7);
-        }
-        //Check whether data and address are written correctly.
-        if(((addr<<16) != ((*(int *)(nextAddLoc))<<16)) || (data != (*(int *)(nextDataLoc))))
-        {
-            SetPageWriteError(1);
-            return(7);  //Error - RAM does not match PM
-        }
-    }
-
-    //Pack if page is full
-    if(lowerAddress == 1)
-    {
-        if (((addrIndex + 4) == DATA_OFFSET)&&(activePage == 1))
-        {
-            //mark the page as not_current and active
-            Delay10us(2);
-            retCode = NVMWriteWord((void*)(addLoc-16), 0xFFF9FFFF);
-            //mark the next page as current and active.
-            if(!retCode)
-                Delay10us(2);
-                retCode = NVMWriteWord((void*)eedata_addr[currentPage % NUM_DATA_EE_PAGES], 0xFFFDFFFF); 
-            if(retCode & _NVMCON_LVDERR_MASK)
-            {
-                SetLowVoltageError(1);
-                return (8);
-            }
-            else if(retCode & _NVMCON_WRERR_MASK)
-            {
-                SetPageWriteError(1);
-                return (7);
-            }
-        }
-        else if (((addrIndex + 4) == DATA_OFFSET)&&(activePage == 2))// both active pages are full then pack the page.
-        {
-            PackEE();
-        }
-    }
+    if((retCode = DEEQueueWrite(data, addr)) != 0)
+        return retCode;
+#if defined(DATA_EE_WRITE_BACK)
     return(0);
+#else
+    return(DataEEFlush());
+#endif
 }
 
 /****************************************************************************
@@ -602,133 +793,42 @@ unsigned int DataEEWrite(unsigned int data, unsigned int addr)
  * Overview:        This routine verifies whether the address is valid. If not, the Illegal Address
  *                  flag is set and 0 is returned. It then finds the active page. If an
  *                  active page can not be found, the Page Corrupt status bit is set and
- *                  0 is returned. A reverse search of the active page attempts to find
- *                  the matching address in the program memory. If a match is found,
- *                  the corresponding data EEPROM data is returned, otherwise 0
- *                  is returned. This function can be called by the user.
+ *                  0 is returned. A value still in the write buffer is returned first,
+ *                  otherwise the RAM index gives the entry holding the address in the
+ *                  program memory. If there is one, the corresponding data EEPROM data
+ *                  is returned after checking its checksum, otherwise 1 is returned.
+ *                  This function can be called by the user.
  *
  * Note:            This is a public function.
  *****************************************************************************/
 unsigned int DataEERead(unsigned int *data, unsigned int addr)
 {
-    unsigned int currentPage=0;
-    unsigned int activePage=0;
-    unsigned int pageCount;
-    unsigned int addLoc;
-    unsigned int dataLoc;
-    int addrIndex;
-    unsigned int addrRead;
+    unsigned int i;
+    unsigned int retCode;
 
     if(addr >= DATA_EE_SIZE)
     {
         SetPageIllegalAddress(1);
         return(5);
     }
+    if(!deeIndexValid && ((retCode = DEELoadIndex()) != 0))
+        return retCode;
 
-    // Find the current active page.
-    for (pageCount = 1; pageCount <= NUM_DATA_EE_PAGES; pageCount++)
+    for(i = 0; i < deePendingCount; i++)
     {
-      if(GetPageStatus(pageCount, STATUS_ACTIVE) == PAGE_ACTIVE)
-      {
-         activePage++;
-         if(GetPageStatus(pageCount, STATUS_CURRENT) == PAGE_CURRENT)
-         {
-            currentPage = pageCount;
-         }
-      }
-    }
-
-    if(activePage == 0)
-    {
-       SetPageCorruptStatus(1);
-       return(6);
+        if(deePendingAddr[i] == addr)
+        {
+            *data = deePendingData[i];
+            return(0); //Success, not programmed yet
+        }
     }
 
-    addLoc = (unsigned int)eedata_addr[currentPage-1] + 16;
-    
-    addrIndex = 1356; // go to the end of the page where address is stored.
-    do // scan the current page
-    {
-       addrRead = (*(int*)(addrIndex+addLoc));
-       if((addrRead & 0x3FF)== addr)
-       {
-         dataLoc = (addrIndex*2) + DATA_OFFSET + 4 + addLoc;
-         *data = (*(int*)(dataLoc));
-         if(((addrRead & 0xFCFF)>>0xA) == EmulationCheckSum(*data))
-         {
-            return (0); //Success
-         }
-         else
-         {
-            SetPageCorruptStatus(1);
-            return(6);
-         } 
-       }
-       else if(((addrRead>>16)&0x3FF) == addr)
-       {
-         dataLoc = (addrIndex*2) + DATA_OFFSET + addLoc;
-         *data = (*(int*)(dataLoc));
-         if(((addrRead & 0xFCFFFFFF)>>0x1A) == EmulationCheckSum(*data))
-         {
-            return 0; //Success
-         }
-         else
-         {
-            SetPageCorruptStatus(1);
-            return(6);
-         } 
-       }
-       addrIndex -=4;
-    }while(addrIndex >= 0);
-
-    if((addrIndex < 0)&&(activePage == 2))
-    {
-      addLoc = (unsigned int)eedata_addr[PrevPage(currentPage)-1]+16;//go to the previous page starting
-    }
-
-    if(activePage == 2)
-    {
-       addrIndex = 1356; // go to the end of the page where address is stored.
-       do // scan the second active page.
-       {
-          addrRead = (*(int*)(addrIndex+addLoc));
-          if((addrRead & 0x3FF)== addr)
-          {
-            dataLoc = (addrIndex*2) + DATA_OFFSET + 4 + addLoc;
-            *data = (*(int*)(dataLoc));
-            if(((addrRead & 0xFCFF)>>0xA) == EmulationCheckSum(*data))
-            {
-               return 0; //Success
-            }
-            else
-            {
-               SetPageCorruptStatus(1);
-               return(6);
-            } 
-          }
-          else if(((addrRead>>16)&0x3FF) == addr)
-          {
-            dataLoc = (addrIndex*2) + DATA_OFFSET + addLoc;
-            *data = (*(int*)(dataLoc));
-            if(((addrRead & 0xFCFFFFFF)>>0x1A) == EmulationCheckSum(*data))
-            {
-               return 0; //Success
-            }
-            else
-            {
-               SetPageCorruptStatus(1);
-               return(6);
-            } 
-          }
-          addrIndex -=4;
-       }while(addrIndex >= 0);
-    }
-    if(addrIndex<0)
+    if(deeIndex[addr] == DEE_NO_ENTRY)
     {
         SetaddrNotFound(1);
         return(1);
     }
-    return 0;
+    return(DEEReadEntry(data, deeIndex[addr]));
 }
 
 /****************************************************************************
@@ -749,7 +849,8 @@ unsigned int DataEERead(unsigned int *data, unsigned int addr)
  *
  * Overview:        This routine finds the active page and an unexpired packed page. The most
  *                  recent data EEPROM values are located for each address will be read and 
- *                  written into pack page. Page status is read from active
+ *                  written into pack page, with the values in the write buffer replacing
+ *                  them, which empties the buffer. Page status is read from active
  *                  page and erase/write count is incremented if page 0 is packed. After all
  *                  information is programmed and verified, the current page is erased. The
  *                  packed page becomes the current page. This function can be called at any-
@@ -759,157 +860,172 @@ unsigned int DataEERead(unsigned int *data, unsigned int addr)
  *****************************************************************************/
 unsigned int PackEE(void)
 {
-    int currentPage;
-    int pageCount;
-    int activePage=0;
-    int i;
+    unsigned int packPage;
+    unsigned int addr;
+    unsigned int slot=0;
     unsigned int data;
-    unsigned int addr=0;
-    unsigned int addCount=0;
-    unsigned int addLoc;
-    unsigned int nextAddLoc;
-    unsigned int addrIndex=0;
-    unsigned int nextDataLoc;
-    unsigned int lowerAddr=0;
-    unsigned int addCheckSum;
+    unsigned int i;
     unsigned int retCode;
 
-    // Find the active page.
-    for (pageCount = 1; pageCount <= NUM_DATA_EE_PAGES; pageCount++)
+    if(!deeIndexValid && ((retCode = DEELoadIndex()) != 0))
+        return (retCode == 3) ? 0 : retCode; // Error - no active page
+    if(deeActivePages == 1)
+        return(DataEEFlush()); // Nothing to pack
+
+    // Write the most recent value of each address into the page after the current one,
+    // the write buffer replacing the programmed values.
+    packPage = (deeCurrentPage % NUM_DATA_EE_PAGES) + 1;
+    for(addr = 0; addr < DATA_EE_SIZE; addr++)
     {
-      if(GetPageStatus(pageCount, STATUS_ACTIVE) == PAGE_ACTIVE)
-      {
-         activePage++;
-         if(GetPageStatus(pageCount, STATUS_CURRENT) == PAGE_CURRENT)
-         {
-            currentPage = pageCount;
-         }
-      }
+        for(i = 0; (i < deePendingCount) && (deePendingAddr[i] != addr); i++)
+            ;
+        if(i < deePendingCount)
+        {
+            data = deePendingData[i];
+        }
+        else if(deeIndex[addr] == DEE_NO_ENTRY)
+        {
+            continue;
+        }
+        else if(DEEReadEntry(&data, deeIndex[addr]) != 0)
+        {
+            deeIndexValid = 0;
+            return (6);
+        }
+        if((retCode = DEEProgramEntry(packPage, slot, data, addr)) != 0)
+        {
+            deeIndexValid = 0;
+            return retCode;
+        }
+        deeIndex[addr] = DEE_ENTRY(packPage, slot);
+        slot++;
     }
+    deePendingCount = 0;
+    dataEEStats.packs++;
 
-    switch(activePage)
+    if(slot != DATA_EE_SLOTS_IN_PAGE)
+    {
+        retCode = NVMWriteWord((void*)eedata_addr[packPage-1], 0xFFFDFFFF); //mark the packed page as active and current.
+        ErasePage(deeCurrentPage);
+        ErasePage(PrevPage(deeCurrentPage));
+        deeCurrentPage = packPage;
+        deeActivePages = 1;
+        deeNextSlot = slot;
+    }
+    else
     {
-      case 1:
-         break;
-      case 2:
-         addLoc = (unsigned int)eedata_addr[currentPage %NUM_DATA_EE_PAGES]+16;
+        retCode = NVMWriteWord((void*)eedata_addr[packPage-1], 0xFFF9FFFF); //mark the packed page as active and not current.
+        ErasePage(deeCurrentPage);
+        ErasePage(PrevPage(deeCurrentPage));
+        //mark the next page as current and active.
+        if(!retCode)
+            retCode = NVMWriteWord((void*)eedata_addr[packPage % NUM_DATA_EE_PAGES], 0xFFFDFFFF);
+        deeCurrentPage = (packPage % NUM_DATA_EE_PAGES) + 1;
+        deeActivePages = 2;
+        deeNextSlot = 0;
+    }
+    if((retCode = DEEWriteResult(retCode)) != 0)
+        deeIndexValid = 0;
+    return retCode;
+}
 
-         do
-         {
-            addr = addCount;
-            if((DataEERead(&data,addr) != 0) && (dataEEFlags.val ==1))            
-            {
-                addCount++;
-                continue;
-            }
-            else if(dataEEFlags.val > 1)
-            {
-                SetPageCorruptStatus(1);
-                return (6);
-            }
-            nextAddLoc = addLoc + addrIndex;
-            addCheckSum = (unsigned int)EmulationCheckSum(data);
-            addCheckSum = addCheckSum << 0xA;
-            if(lowerAddr == 0)
-            {
-                addr = ((addCheckSum | addr)<<16)|0xFFFF;
-                retCode = NVMWriteWord((void*)(nextAddLoc), addr);
-                nextDataLoc = (addrIndex*2) + DATA_OFFSET + addLoc;
-                if(!retCode)
-                    retCode = NVMWriteWord((void*)(nextDataLoc), data);
-                if(retCode & _NVMCON_LVDERR_MASK)
-                {
-                    SetLowVoltageError(1);
-                    return (8);
-                }
-                else if(retCode & _NVMCON_WRERR_MASK)
-                {
-                    SetPageWriteError(1);
-                    return (7);
-                }
-                lowerAddr = 1;
-                //Check whether data and address are written correctly.
-                if((addr != (*(int *)(nextAddLoc))) || (data != (*(int *)(nextDataLoc))))
-                {
-                    SetPageWriteError(1);
-                    return(7);  //Error - RAM does not match PM
-                }
-            }
-            else if(lowerAddr == 1)
+/****************************************************************************
+ * Function:        DataEEFlush
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          Check the dataEEFlags for the error status.
+ *                  value 0 for success.
+ *                  Value 5 for Illegal address.
+ *                  Value 6 for page corrupt status.
+ *                  Value 7 for write error.
+ *                  Value 8 for Low voltage operation.
+ *
+ * Side Effects:    Data EE flags may be updated. CPU stall occurs for flash
+ *                  programming. Pack may be generated.
+ *
+ * Overview:        This routine programs the write buffer. Values equal to the programmed
+ *                  ones are dropped. If the rest does not fit in the free entries of the
+ *                  active pages, a single pack writes them with the other addresses,
+ *                  instead of filling the page and packing it. Otherwise each address and
+ *                  data is programmed into the next free entry and verified, the data
+ *                  checksum being written along with the address (10 LSBits for the
+ *                  address, 6 bits for the checksum). If the verify fails, the Write
+ *                  Error flag is set. With DATA_EE_WRITE_BACK defined, the user must call
+ *                  it before the values written have to survive a reset.
+ *
+ * Note:            This is a public function.
+ *****************************************************************************/
+unsigned int DataEEFlush(void)
+{
+    unsigned int i;
+    unsigned int count;
+    unsigned int freeSlots;
+    unsigned int dataRead;
+    unsigned int retCode;
+
+    if(deePendingCount == 0)
+        return(0);
+    if(!deeIndexValid && ((retCode = DEELoadIndex()) != 0))
+        return retCode;
+
+    // Drop the values written back to the programmed ones
+    for(i = 0, count = 0; i < deePendingCount; i++)
+    {
+        if((deeIndex[deePendingAddr[i]] != DEE_NO_ENTRY) &&
+           (DEEReadEntry(&dataRead, deeIndex[deePendingAddr[i]]) == 0) &&
+           (dataRead == deePendingData[i]))
+        {
+            dataEEStats.unchanged++;
+            continue;
+        }
+        deePendingAddr[count] = deePendingAddr[i];
+        deePendingData[count++] = deePendingData[i];
+    }
+    deePendingCount = count;
+    if(deePendingCount == 0)
+        return(0);
+
+    // Pack once if the buffer fills the last active page
+    freeSlots = DATA_EE_SLOTS_IN_PAGE - deeNextSlot;
+    if(deeActivePages == 1)
+        freeSlots += DATA_EE_SLOTS_IN_PAGE;
+    if(deePendingCount >= freeSlots)
+        return(PackEE());
+
+    for(i = 0; i < deePendingCount; i++)
+    {
+        if(deeNextSlot == DATA_EE_SLOTS_IN_PAGE)
+        {
+            //mark the page as not_current and active
+            Delay10us(2);
+            retCode = NVMWriteWord((void*)eedata_addr[deeCurrentPage-1], 0xFFF9FFFF);
+            //mark the next page as current and active.
+            if(!retCode)
             {
-                addr = addCheckSum | addr | 0xFFFF0000;
-                retCode = NVMWriteWord((void*)(nextAddLoc), addr);
-                nextDataLoc = (addrIndex*2) + DATA_OFFSET + 4 + addLoc;
-                if(!retCode)
-                   retCode = NVMWriteWord((void*)(nextDataLoc), data);
-                if(retCode & _NVMCON_LVDERR_MASK)
-                {
-                    SetLowVoltageError(1);
-                    return (8);
-                }
-                else if(retCode & _NVMCON_WRERR_MASK)
-                {
-                    SetPageWriteError(1);
-                    return (7);
-                }
-                addrIndex +=4;
-                lowerAddr = 0;
-                //Check whether data and address are written correctly.
-                if(((addr<<16) != ((*(int *)(nextAddLoc))<<16)) || (data != (*(int *)(nextDataLoc))))
-                {
-                    SetPageWriteError(1);
-                    return(7);  //Error - RAM does not match PM
-                }
+                Delay10us(2);
+                retCode = NVMWriteWord((void*)eedata_addr[deeCurrentPage % NUM_DATA_EE_PAGES], 0xFFFDFFFF);
             }
-            addCount++;
-         }while(addCount < DATA_EE_SIZE);
-
-         if(addrIndex != DATA_OFFSET)
-         {
-            retCode = NVMWriteWord((void*)(addLoc-16), 0xFFFDFFFF); //mark the packed page as active and current.
-            ErasePage(currentPage);
-            ErasePage(PrevPage(currentPage));
-         }
-         else
-         {
-            retCode = NVMWriteWord((void*)(addLoc-16), 0xFFF9FFFF); //mark the packed page as active and not current.
-            ErasePage(currentPage);
-            ErasePage(PrevPage(currentPage));
-            
-            switch(currentPage)//mark the next page as current and active.
+            if((retCode = DEEWriteResult(retCode)) != 0)
             {
-               case 1:
-                  retCode = NVMWriteWord((void*)eedata_addr[2], 0xFFFDFFFF);
-                  break;
-               case 2:
-                  retCode = NVMWriteWord((void*)eedata_addr[0], 0xFFFDFFFF);
-                  break;
-               case 3:
-                  retCode = NVMWriteWord((void*)eedata_addr[1], 0xFFFDFFFF);
-                  break;
-               default:
-                  break;
+                deeIndexValid = 0;
+                return retCode;
             }
-         }
-         if(retCode & _NVMCON_LVDERR_MASK)
-         {
-            SetLowVoltageError(1);
-            return (8);
-         }
-         else if(retCode & _NVMCON_WRERR_MASK)
-         {
-            SetPageWriteError(1);
-            return (7);
-         }
-            
-         break;
-      case 3:
-         SetPagePackBeforeInit(1);
-         break; // Error - no active page
-      default:
-         break;
+            deeCurrentPage = (deeCurrentPage % NUM_DATA_EE_PAGES) + 1;
+            deeActivePages = 2;
+            deeNextSlot = 0;
+        }
+        if((retCode = DEEProgramEntry(deeCurrentPage, deeNextSlot, deePendingData[i], deePendingAddr[i])) != 0)
+        {
+            deeIndexValid = 0; // the buffer is kept, DataEEFlush can be called again
+            return retCode;
+        }
+        deeIndex[deePendingAddr[i]] = DEE_ENTRY(deeCurrentPage, deeNextSlot);
+        deeNextSlot++;
     }
-
+    deePendingCount = 0;
     return(0);
 }
 
@@ -934,6 +1050,8 @@ unsigned int PackEE(void)
  *
  * Overview:        This routine will write a char array of data with a given 
  *                  starting address upto the array size specified by the user.
+ *                  The words go through the write buffer and are programmed by
+ *                  DataEEFlush before returning, whether DATA_EE_WRITE_BACK is defined or not.
  *                  Use DataEEWriteArray function to read the data written using this function
  *                  This is solely designed to write char array.
  *
@@ -961,13 +1079,13 @@ unsigned int DataEEWriteArray(unsigned char *data, unsigned int addr, unsigned i
    {
       writeData = (((unsigned int)*tempData)<<24) | (((unsigned int)*(tempData+1))<<16) | (((unsigned int)*(tempData+2)) << 8) | (*(tempData+3));
       tempData +=4;
-      if((status = DataEEWrite(writeData, addr))>0)
+      if((status = DEEQueueWrite(writeData, addr))>0)
       {
          return status;
       }
       addr++;
    }
-   return (0);
+   return (DataEEFlush());
 }
 
 /****************************************************************************
@@ -1070,4 +1188,4 @@ unsigned int DataEEReadArray(unsigned char *data, unsigned int addr, unsigned in
 //
 //	// Return Error Status
 //    return(NVMIsError());
-//}
\ No newline at end of file
+//}
\ No newline at end of file
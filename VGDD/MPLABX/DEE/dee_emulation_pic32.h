@@ -39,12 +39,16 @@
 // User defined constants
 #define DATA_EE_SIZE        (680) // Total number of 32-bit data
 #define NUM_DATA_EE_PAGES   (3) // Total number of pages reserved for the operation
+#define DATA_EE_WRITE_BUFFER (16) // Writes held in RAM and programmed together by DataEEFlush
+//#define DATA_EE_WRITE_BACK      // Keep DataEEWrite values in RAM until the buffer is full or
+                                  // DataEEFlush is called, instead of programming them on return
     
     // Internal constants
 #define ERASE_WRITE_CYCLE_MAX           (1000) // Maximum erase cycle per page
 #define NUMBER_OF_INSTRUCTIONS_IN_PAGE  (1024) // number of 32-bit word instructions per page
 #define DATA_OFFSET                     (1360) // The point where address starts
 #define PIC32MX_PAGE_SIZE               (NUMBER_OF_INSTRUCTIONS_IN_PAGE*4) // Total page size in bytes
+#define DATA_EE_SLOTS_IN_PAGE           (DATA_OFFSET/2) // address/data entries per page
 
 #define PAGE_CURRENT                    1 // Indicate the page status
 #define PAGE_NOT_CURRENT                0 // Indicate the page status
@@ -82,6 +86,19 @@ typedef union
     
 extern DATA_EE_FLAGS dataEEFlags; //Flags for the error/warning condition.
 
+//Counters for the write buffer and the flash wear.
+typedef struct
+{
+   unsigned int writes;     // DataEEWrite calls, DataEEWriteArray words included
+   unsigned int coalesced;  // writes replacing one still in the write buffer
+   unsigned int unchanged;  // writes skipped, the value being already programmed
+   unsigned int programmed; // entries programmed, packs included
+   unsigned int packs;      // pages packed
+   unsigned int eraseCount[NUM_DATA_EE_PAGES]; // erase count of each page
+} DATA_EE_STATS;
+
+extern DATA_EE_STATS dataEEStats; //Counters for the write buffer and the flash wear.
+
 #define GetaddrNotFound() dataEEFlags.addrNotFound  //Get the flag address not found
 #define SetaddrNotFound(x) dataEEFlags.addrNotFound = x // Set the flag address not found
 
@@ -154,7 +171,9 @@ unsigned int GetNextAvailCount(void);
  *                  first unexpired page is initialized for emulation. If one or two active pages
  *                  found, it assumes a reset occurred and the function does nothing. If
  *                  three active pages are found, it is assumes a reset occurred during a pack.
- *                  The page after current is erased and a pack is called. This
+ *                  The page after current is erased and a pack is called. The RAM index
+ *                  of the entry holding each address is then built from the active
+ *                  pages, so that reads and writes do not search the pages. This
  *                  function must be called prior to any other operation.
  *
  * Note:            This is a public function.
@@ -179,10 +198,11 @@ unsigned int   DataEEInit(void);
  * Overview:        This routine verifies whether the address is valid. If not, the Illegal Address
  *                  flag is set and 0 is returned. It then finds the active page. If an
  *                  active page can not be found, the Page Corrupt status bit is set and
- *                  0 is returned. A reverse search of the active page attempts to find
- *                  the matching address in the program memory. If a match is found,
- *                  the corresponding data EEPROM data is returned, otherwise 0
- *                  is returned. This function can be called by the user.
+ *                  0 is returned. A value still in the write buffer is returned first,
+ *                  otherwise the RAM index gives the entry holding the address in the
+ *                  program memory. If there is one, the corresponding data EEPROM data
+ *                  is returned after checking its checksum, otherwise 1 is returned.
+ *                  This function can be called by the user.
  *
  * Note:            This is a public function.
  *****************************************************************************/
@@ -208,16 +228,13 @@ unsigned int DataEERead(unsigned int *data, unsigned int addr);
  *                  programming. Pack may be generated.
  *
  * Overview:        This routine verifies the address is valid. If not, the Illegal Address
- *                  flag is set and an error code is returned. It then finds the active page.
- *                  If an active page can not be found, the Page Corrupt status bit is set
- *                  and an error code is returned. A read is performed, if the data was not
- *                  changed, the function exits. If the last location is programmed, the Pack
- *                  Skipped error flag is set (one location should always be available). The
- *                  data EE information address and data is programmed and verified. The data
- *                  checksum is written along with the address. 10 LSBits are allocated for 
- *                  address and 6 bits are allotted for checksum. If the verify fails, 
- *                  the Write Error flag is set. If the write went into the last location 
- *                  of the page, pack is called. This function can be called by the user.
+ *                  flag is set and an error code is returned. A write to an address still
+ *                  in the write buffer replaces its value there. Otherwise, if the data
+ *                  was not changed, the function exits, else it is added to the write
+ *                  buffer. A full buffer is programmed by DataEEFlush. Unless
+ *                  DATA_EE_WRITE_BACK is defined, DataEEFlush is also called before
+ *                  returning, so the data is programmed as it used to be. This function
+ *                  can be called by the user.
  *
  * Note:            This is a public function.
  *****************************************************************************/
@@ -241,7 +258,8 @@ unsigned int DataEEWrite(unsigned int data, unsigned int addr);
  *
  * Overview:        This routine finds the active page and an unexpired packed page. The most
  *                  recent data EEPROM values are located for each address will be read and 
- *                  written into pack page. Page status is read from active
+ *                  written into pack page, with the values in the write buffer replacing
+ *                  them, which empties the buffer. Page status is read from active
  *                  page and erase/write count is incremented if page 0 is packed. After all
  *                  information is programmed and verified, the current page is erased. The
  *                  packed page becomes the current page. This function can be called at any-
@@ -251,6 +269,37 @@ unsigned int DataEEWrite(unsigned int data, unsigned int addr);
  *****************************************************************************/
 unsigned int PackEE(void);
 
+/****************************************************************************
+ * Function:        DataEEFlush
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          Check the dataEEFlags for the error status.
+ *                  value 0 for success.
+ *                  Value 5 for Illegal address.
+ *                  Value 6 for page corrupt status.
+ *                  Value 7 for write error.
+ *                  Value 8 for Low voltage operation.
+ *
+ * Side Effects:    Data EE flags may be updated. CPU stall occurs for flash
+ *                  programming. Pack may be generated.
+ *
+ * Overview:        This routine programs the write buffer. Values equal to the programmed
+ *                  ones are dropped. If the rest does not fit in the free entries of the
+ *                  active pages, a single pack writes them with the other addresses,
+ *                  instead of filling the page and packing it. Otherwise each address and
+ *                  data is programmed into the next free entry and verified, the data
+ *                  checksum being written along with the address (10 LSBits for the
+ *                  address, 6 bits for the checksum). If the verify fails, the Write
+ *                  Error flag is set. With DATA_EE_WRITE_BACK defined, the user must call
+ *                  it before the values written have to survive a reset.
+ *
+ * Note:            This is a public function.
+ *****************************************************************************/
+unsigned int DataEEFlush(void);
+
 /****************************************************************************
  * Function:        DataEEWriteArray
  *
@@ -272,6 +321,8 @@ unsigned int PackEE(void);
  *
  * Overview:        This routine will write a char array of data with a given 
  *                  starting address upto the array size specified by the user.
+ *                  The words go through the write buffer and are programmed by
+ *                  DataEEFlush before returning, whether DATA_EE_WRITE_BACK is defined or not.
  *                  Use DataEEWriteArray function to read the data written using this function
  *                  This is solely designed to write char array.
  *
@@ -303,4 +354,4 @@ unsigned int DataEEWriteArray(unsigned char *data, unsigned int addr, unsigned i
  *****************************************************************************/
 unsigned int DataEEReadArray(unsigned char *data, unsigned int addr, unsigned int size);
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,686 @@
+// *****************************************************************************
+// Flash programmer host simulation
+// Serial link between a host programming tool and the flash programmer
+// *****************************************************************************
+// FileName:        HostLink.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The programmer (flash_programmer_MLA.c, comm_pkt_MLA.c) runs on a simulated
+// clock with a 2 MB SPI flash model: 1 us per byte read, 5 us per byte
+// programmed, 25 ms per sector erase, 50 ms per chip erase. The link is a
+// UART, 8N1, with a receive queue of -f bytes on the board (the bytes past
+// it are lost) and the latency of a USB serial adapter on the host side.
+// The host tool is the state machine below, run each time the programmer
+// polls the link, and programs a 512 KB image:
+//  - legacy: MAX_PAYLOAD_SIZE, chip ERASE, one MEMORY_WRITE at a time,
+//    VERIFY with the additive checksum
+//  - window: WINDOW_INFO, CRC32 of each sector, MEMORY_WRITE_SEQ packets
+//    for the sectors that differ, CRC32 of the image; the window halves
+//    on a NACK or a timeout and grows back by one for each window acked
+// on a blank chip, then as a field update of -c changed sectors over the
+// previous image, then on a blank chip again with a byte in -e corrupted
+// or lost on the link. The flash must end up holding the image, else the
+// tool exits with 2.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -o HostLink HostLink.c ../MLA/flash_programmer_MLA.c ../MLA/comm_pkt_MLA.c
+//
+// Usage:
+//   HostLink [-b baud] [-l ms] [-f bytes] [-c sectors] [-e bytes] [-s seed]
+//     -b  UART baud rate (default 115200)
+//     -l  host adapter latency, each way (default 4 ms)
+//     -f  board UART receive queue (default 128 bytes)
+//     -c  sectors changed by the field update (default 8)
+//     -e  one byte in that many corrupted or lost (default 20000, 0 = none)
+//     -s  random seed (default 1)
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	No memcpy() from a NULL payload
+//  2026/10/17	-c changes -c distinct sectors, each write inside its sector
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "system.h"
+#include "comm_pkt.h"
+#include "comm_pkt_callback.h"
+#include "flash_programmer.h"
+
+#define FLASH_SIZE          (2ul * 1024 * 1024)
+#define IMAGE_SIZE          (512ul * 1024)
+#define SECTOR_SIZE         FLASH_PROGRAMMER_SECTOR_SIZE
+#define SECTORS             (IMAGE_SIZE / SECTOR_SIZE)
+
+#define US                  1000ull             // ns
+#define MS                  (1000 * US)
+#define READ_NS             (1 * US)            // per byte read from the flash
+#define PROGRAM_NS          (5 * US)            // per byte programmed
+#define SECTOR_ERASE_NS     (25 * MS)
+#define CHIP_ERASE_NS       (50 * MS)
+#define POLL_NS             (2 * US)            // main loop turn of the programmer
+#define RX_BYTE_NS          (US / 4)            // per byte taken from the UART queue
+#define COMMAND_TIMEOUT_NS  (3000 * MS)         // reply to a stop and wait command
+#define TIME_LIMIT_NS       (3600000 * MS)
+
+#define LINK_SIZE           (1ul << 22)
+#define PC_RX_SIZE          (2 * COMM_PKT_RX_MAX_SIZE)
+
+typedef struct {
+    uint8_t data[LINK_SIZE];
+    uint64_t time[LINK_SIZE];               // arrival of each byte
+    uint32_t head, tail;
+} HOST_LINK;
+
+typedef enum {
+    PC_MAX_PAYLOAD, PC_ERASE, PC_WRITE, PC_VERIFY,
+    PC_WINDOW_INFO, PC_SECTOR_CRC, PC_SEQ, PC_IMAGE_CRC,
+    PC_DONE, PC_FINISHED, PC_FAILED
+} PC_STATE;
+
+typedef struct {
+    uint32_t addr;
+    uint16_t length;
+    uint16_t flags;
+} PC_SEQ_PACKET;
+
+static uint64_t Now;                        // programmer clock
+static uint64_t ByteNs;
+static uint64_t Latency = 4 * MS;
+static uint32_t ErrorRate;
+static uint32_t FifoSize = 128;
+static jmp_buf AbortProgrammer;
+
+static uint8_t Flash[FLASH_SIZE];
+static uint8_t Image[IMAGE_SIZE];
+
+static HOST_LINK ToBoard, ToHost;
+static uint8_t Fifo[4096];
+static uint32_t FifoCount, FifoHead;
+
+// Host tool
+static bool PcWindowed;
+static PC_STATE PcState;
+static uint64_t PcTime, PcLinkFree, PcDeadline;
+static uint8_t PcRx[PC_RX_SIZE];
+static uint32_t PcRxCount;
+static uint8_t PcLast[COMM_PKT_RX_MAX_SIZE + 8];    // command waiting for its reply
+static uint16_t PcLastLength;
+static uint32_t PcAddr;
+static uint16_t PcMaxData, PcWindow, PcCwnd, PcAcked;
+static uint32_t PcSectorSize;
+static bool PcChipErase;                    // chip erased, all the sectors sent
+static uint32_t PcSectorCrc[SECTORS];
+static PC_SEQ_PACKET PcPackets[IMAGE_SIZE / 64];
+static uint32_t PcTotal, PcBase, PcNext;
+static uint64_t PcSeqTimeout;
+
+static struct {
+    uint32_t BytesSent;
+    uint32_t Commands;
+    uint32_t Resent;
+    uint32_t Timeouts;
+    uint32_t Nacks;
+    uint32_t Overruns;
+    uint32_t LinkErrors;
+    uint32_t SectorsSent;
+} Stats;
+
+static uint32_t HostCrc32(uint32_t crc, const uint8_t *data, uint32_t length) {
+    int bit;
+
+    crc = ~crc;
+    while (length--) {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void HostPut16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void HostPut32(uint8_t *p, uint32_t v) {
+    HostPut16(p, v);
+    HostPut16(p + 2, v >> 16);
+}
+
+static uint16_t HostGet16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t HostGet32(const uint8_t *p) {
+    return HostGet16(p) | ((uint32_t) HostGet16(p + 2) << 16);
+}
+
+// -----------------------------------------------------------------------------
+// Flash model
+
+static void HostFlashRead(uint32_t addr, uint8_t *buffer, uint16_t count) {
+    memcpy(buffer, Flash + addr, count);
+    Now += count * READ_NS;
+}
+
+static uint8_t HostFlashWrite(uint32_t addr, uint8_t *buffer, uint16_t count) {
+    uint16_t i;
+
+    // programming only clears bits, then the data is read back
+    for (i = 0; i < count; i++)
+        Flash[addr + i] &= buffer[i];
+    Now += count * (PROGRAM_NS + READ_NS);
+    return memcmp(Flash + addr, buffer, count) == 0;
+}
+
+static void HostFlashChipErase(void) {
+    memset(Flash, 0xFF, sizeof (Flash));
+    Now += CHIP_ERASE_NS;
+}
+
+static void HostFlashSectorErase(uint32_t addr) {
+    memset(Flash + addr, 0xFF, SECTOR_SIZE);
+    Now += SECTOR_ERASE_NS;
+}
+
+// -----------------------------------------------------------------------------
+// Link
+
+// Queues a byte arriving at time, corrupted or lost now and then
+static void HostLinkPut(HOST_LINK *pLink, uint8_t data, uint64_t time) {
+    if (ErrorRate && rand() % ErrorRate == 0) {
+        Stats.LinkErrors++;
+        if (rand() & 1)
+            return;
+        data ^= 1 << (rand() % 8);
+    }
+    pLink->data[pLink->tail % LINK_SIZE] = data;
+    pLink->time[pLink->tail % LINK_SIZE] = time;
+    pLink->tail++;
+}
+
+static void PcRun(void);
+
+// Bytes arrived at the board UART, lost once its queue is full
+static void HostUartReceive(void) {
+    while (ToBoard.head != ToBoard.tail && ToBoard.time[ToBoard.head % LINK_SIZE] <= Now) {
+        if (FifoCount < FifoSize)
+            Fifo[(FifoHead + FifoCount++) % sizeof (Fifo)] = ToBoard.data[ToBoard.head % LINK_SIZE];
+        else
+            Stats.Overruns++;
+        ToBoard.head++;
+    }
+}
+
+// comm_pkt callbacks for the programmer
+bool COMM_PKT_DataAvailable(COMM_PKT_MEDIA media) {
+    Now += POLL_NS;
+    PcRun();
+    if (PcState == PC_FAILED || Now > TIME_LIMIT_NS)
+        longjmp(AbortProgrammer, 1);
+    HostUartReceive();
+    return FifoCount > 0;
+}
+
+uint16_t COMM_PKT_GetData(COMM_PKT_MEDIA media, uint8_t *buffer, uint16_t offset) {
+    HostUartReceive();
+    while (FifoCount && offset < COMM_PKT_RX_BUFFER_SIZE) {
+        buffer[offset++] = Fifo[FifoHead];
+        FifoHead = (FifoHead + 1) % sizeof (Fifo);
+        FifoCount--;
+        Now += RX_BYTE_NS;
+    }
+    return offset;
+}
+
+void COMM_PKT_SendData(COMM_PKT_MEDIA media, uint8_t *data, uint16_t size) {
+    // one byte at a time, waiting for the transmitter to be empty
+    while (size--) {
+        Now += ByteNs;
+        HostLinkPut(&ToHost, *data++, Now + Latency);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Host tool
+
+static void PcSend(uint8_t cmd, const uint8_t *payload, uint16_t length) {
+    uint8_t packet[COMM_PKT_RX_MAX_SIZE + 8];
+    uint8_t sum = 0xFF;
+    uint64_t time;
+    uint16_t i, size = length + (COMM_PKT_HAS_CRC(cmd) ? COMM_PKT_CRC_SIZE : 0);
+
+    packet[0] = cmd;
+    packet[1] = 0;
+    HostPut16(packet + 2, size);
+    if (length)
+        memcpy(packet + 4, payload, length);
+    if (COMM_PKT_HAS_CRC(cmd))
+        HostPut32(packet + 4 + length, HostCrc32(0, packet, 4 + length));
+    for (i = 0; i < size; i++)
+        sum += packet[4 + i];
+    packet[1] = -sum;
+
+    // the adapter starts sending after its latency, then back to back
+    time = PcTime + Latency;
+    if (time < PcLinkFree)
+        time = PcLinkFree;
+    for (i = 0; i < 4 + size; i++) {
+        time += ByteNs;
+        HostLinkPut(&ToBoard, packet[i], time);
+    }
+    PcLinkFree = time;
+    Stats.BytesSent += 4 + size;
+}
+
+// Stop and wait command, sent again if no reply comes
+static void PcCommand(uint8_t cmd, const uint8_t *payload, uint16_t length) {
+    PcLast[0] = cmd;
+    if (length)
+        memcpy(PcLast + 1, payload, length);
+    PcLastLength = length;
+    PcSend(cmd, payload, length);
+    PcDeadline = PcTime + COMMAND_TIMEOUT_NS;
+    Stats.Commands++;
+}
+
+static void PcLegacyWrite(void) {
+    uint8_t payload[COMM_PKT_RX_MAX_SIZE];
+    uint16_t length = PcMaxData;
+
+    if (length > IMAGE_SIZE - PcAddr)
+        length = IMAGE_SIZE - PcAddr;
+    HostPut32(payload, PcAddr);
+    memcpy(payload + 4, Image + PcAddr, length);
+    PcCommand(COMM_PKT_MEMORY_WRITE, payload, 4 + length);
+}
+
+static void PcVerify(uint8_t cmd) {
+    uint8_t payload[12];
+
+    HostPut32(payload, 0);
+    HostPut32(payload + 4, IMAGE_SIZE);
+    HostPut32(payload + 8, 0);
+    PcState = (cmd == COMM_PKT_MEMORY_VERIFY) ? PC_VERIFY : PC_IMAGE_CRC;
+    PcCommand(cmd, payload, cmd == COMM_PKT_MEMORY_VERIFY ? 8 : 12);
+}
+
+static void PcDone(void) {
+    PcState = PC_DONE;
+    PcCommand(COMM_PKT_MEMORY_DONE, NULL, 0);
+}
+
+// Sends the packets the window allows, not past an erase still unacked
+static void PcSeqPump(void) {
+    uint8_t payload[COMM_PKT_RX_MAX_SIZE];
+    PC_SEQ_PACKET *pPacket;
+    uint32_t i;
+
+    while (PcNext < PcTotal && PcNext < PcBase + PcCwnd) {
+        for (i = PcBase; i < PcNext; i++) {
+            if (PcPackets[i].flags & COMM_PKT_SEQ_ERASE)
+                return;
+        }
+        pPacket = &PcPackets[PcNext];
+        HostPut16(payload, (uint16_t) PcNext);
+        HostPut16(payload + 2, pPacket->flags);
+        HostPut32(payload + 4, pPacket->addr);
+        memcpy(payload + 8, Image + pPacket->addr, pPacket->length);
+        PcSend(COMM_PKT_MEMORY_WRITE_SEQ, payload, 8 + pPacket->length);
+        PcNext++;
+    }
+}
+
+static void PcSeqStart(void) {
+    uint32_t sector, addr, length;
+
+    PcTotal = 0;
+    for (sector = 0; sector < SECTORS; sector++) {
+        if (!PcChipErase && PcSectorCrc[sector] == HostCrc32(0, Image + sector * SECTOR_SIZE, SECTOR_SIZE))
+            continue;
+        Stats.SectorsSent++;
+        for (addr = 0; addr < SECTOR_SIZE; addr += length) {
+            length = SECTOR_SIZE - addr;
+            if (length > PcMaxData)
+                length = PcMaxData;
+            PcPackets[PcTotal].addr = sector * SECTOR_SIZE + addr;
+            PcPackets[PcTotal].length = length;
+            PcPackets[PcTotal].flags = (addr == 0 && !PcChipErase) ? COMM_PKT_SEQ_ERASE : 0;
+            PcTotal++;
+        }
+    }
+    PcBase = PcNext = 0;
+    PcCwnd = PcWindow;
+    PcAcked = 0;
+    PcState = PC_SEQ;
+    if (PcTotal == 0) {
+        PcVerify(COMM_PKT_MEMORY_CRC);
+        return;
+    }
+    // a window of packets, an erase and the latency
+    PcSeqTimeout = (PcWindow + 1) * (PcMaxData + 16) * ByteNs + SECTOR_ERASE_NS + 4 * Latency + 50 * MS;
+    PcDeadline = PcTime + PcSeqTimeout;
+    PcSeqPump();
+}
+
+static void PcSectorCrcs(void) {
+    uint8_t payload[12];
+
+    HostPut32(payload, 0);
+    HostPut32(payload + 4, IMAGE_SIZE);
+    HostPut32(payload + 8, SECTOR_SIZE);
+    PcState = PC_SECTOR_CRC;
+    PcCommand(COMM_PKT_MEMORY_CRC, payload, 12);
+}
+
+static void PcSeqReply(bool ack, const uint8_t *payload) {
+    uint32_t next = PcBase + (int16_t) (HostGet16(payload) - (uint16_t) PcBase);
+
+    if (HostGet16(payload + 2) != COMM_PKT_SEQ_STATUS_OK) {
+        printf("programming error %u\n", HostGet16(payload + 2));
+        PcState = PC_FAILED;
+        return;
+    }
+    if (next < PcBase || next > PcTotal)
+        return;
+    if (!ack) {
+        // lost on the way: again from there, with a smaller window
+        Stats.Nacks++;
+        Stats.Resent += PcNext - next;
+        PcBase = PcNext = next;
+        PcCwnd = PcCwnd > 1 ? PcCwnd / 2 : 1;
+        PcAcked = 0;
+    } else if (next > PcBase) {
+        PcAcked += next - PcBase;
+        PcBase = next;
+        if (PcNext < PcBase)
+            PcNext = PcBase;
+        if (PcAcked >= PcCwnd && PcCwnd < PcWindow) {
+            PcCwnd++;
+            PcAcked = 0;
+        }
+    } else
+        return;
+    PcDeadline = PcTime + PcSeqTimeout;
+    if (PcBase == PcTotal)
+        PcVerify(COMM_PKT_MEMORY_CRC);
+    else
+        PcSeqPump();
+}
+
+static void PcReply(uint8_t cmd, bool ack, const uint8_t *payload, uint16_t length) {
+    uint32_t sum, i;
+
+    if (PcState == PC_SEQ) {
+        if (cmd == COMM_PKT_MEMORY_WRITE_SEQ && length >= 4)
+            PcSeqReply(ack, payload);
+        return;
+    }
+    // replies to a command sent again, or late ones
+    if (PcState == PC_FINISHED || cmd != PcLast[0])
+        return;
+    if (!ack) {
+        printf("command 0x%02X refused\n", cmd);
+        PcState = PC_FAILED;
+        return;
+    }
+    PcDeadline = 0;
+    switch (PcState) {
+        case PC_MAX_PAYLOAD:
+            PcMaxData = HostGet16(payload) - 4;
+            PcState = PC_ERASE;
+            PcCommand(COMM_PKT_MEMORY_ERASE, NULL, 0);
+            break;
+        case PC_ERASE:
+            if (PcWindowed) {
+                PcSeqStart();
+                break;
+            }
+            PcState = PC_WRITE;
+            PcAddr = 0;
+            PcLegacyWrite();
+            break;
+        case PC_WRITE:
+            PcAddr += PcLastLength - 4;
+            if (PcAddr < IMAGE_SIZE)
+                PcLegacyWrite();
+            else
+                PcVerify(COMM_PKT_MEMORY_VERIFY);
+            break;
+        case PC_VERIFY:
+            for (i = 0, sum = 0xFFFFFFFF; i < IMAGE_SIZE; i++)
+                sum += Image[i];
+            if (HostGet32(payload) != (uint32_t) -sum) {
+                printf("verify failed\n");
+                PcState = PC_FAILED;
+            } else
+                PcDone();
+            break;
+        case PC_WINDOW_INFO:
+            PcMaxData = HostGet16(payload);
+            PcWindow = HostGet16(payload + 2);
+            PcSectorSize = HostGet32(payload + 4);
+            if (PcSectorSize != 0 && PcSectorSize != SECTOR_SIZE) {
+                printf("sector size %u not expected\n", PcSectorSize);
+                PcState = PC_FAILED;
+            } else if (PcSectorSize == 0) {
+                PcChipErase = true;
+                PcState = PC_ERASE;
+                PcCommand(COMM_PKT_MEMORY_ERASE, NULL, 0);
+            } else
+                PcSectorCrcs();
+            break;
+        case PC_SECTOR_CRC:
+            for (i = 0, sum = 0; i < SECTORS; i++) {
+                PcSectorCrc[i] = HostGet32(payload + 4 * i);
+                if (PcSectorCrc[i] != HostCrc32(0, Image + i * SECTOR_SIZE, SECTOR_SIZE))
+                    sum++;
+            }
+            // most of them changed: one chip erase is quicker
+            if (sum * SECTOR_ERASE_NS > 2 * CHIP_ERASE_NS + SECTORS / 2 * SECTOR_ERASE_NS) {
+                PcChipErase = true;
+                PcState = PC_ERASE;
+                PcCommand(COMM_PKT_MEMORY_ERASE, NULL, 0);
+            } else
+                PcSeqStart();
+            break;
+        case PC_IMAGE_CRC:
+            if (HostGet32(payload) != HostCrc32(0, Image, IMAGE_SIZE)) {
+                printf("image CRC does not match\n");
+                PcState = PC_FAILED;
+            } else
+                PcDone();
+            break;
+        case PC_DONE:
+            PcState = PC_FINISHED;
+            break;
+        default:
+            break;
+    }
+}
+
+// Takes the replies out of the received bytes, one byte at a time past
+// anything that is not one
+static void PcParse(void) {
+    uint16_t length;
+    uint8_t sum;
+    uint32_t i;
+    bool valid;
+
+    while (PcRxCount >= 4) {
+        length = HostGet16(PcRx + 2);
+        valid = (PcRx[0] & 0x40) && length <= COMM_PKT_RX_MAX_SIZE &&
+                (!COMM_PKT_HAS_CRC(PcRx[0] & 0x3F) || length >= COMM_PKT_CRC_SIZE);
+        if (valid && PcRxCount < 4u + length)
+            return;
+        if (valid) {
+            for (i = 0, sum = 0xFF; i < length; i++)
+                sum += PcRx[4 + i];
+            valid = (uint8_t) -sum == PcRx[1];
+        }
+        if (valid && COMM_PKT_HAS_CRC(PcRx[0] & 0x3F)) {
+            uint8_t hdr[4] = {PcRx[0], 0, PcRx[2], PcRx[3]};
+
+            valid = HostGet32(PcRx + 4 + length - 4) ==
+                    HostCrc32(HostCrc32(0, hdr, 4), PcRx + 4, length - 4);
+        }
+        if (!valid) {
+            memmove(PcRx, PcRx + 1, --PcRxCount);
+            continue;
+        }
+        PcReply(PcRx[0] & 0x3F, (PcRx[0] & 0x80) != 0, PcRx + 4,
+                COMM_PKT_HAS_CRC(PcRx[0] & 0x3F) ? length - 4 : length);
+        PcRxCount -= 4 + length;
+        memmove(PcRx, PcRx + 4 + length, PcRxCount);
+    }
+}
+
+static void PcTimeout(void) {
+    Stats.Timeouts++;
+    if (PcState == PC_SEQ) {
+        Stats.Resent += PcNext - PcBase;
+        PcNext = PcBase;
+        PcCwnd = PcCwnd > 1 ? PcCwnd / 2 : 1;
+        PcAcked = 0;
+        PcDeadline = PcTime + PcSeqTimeout;
+        PcSeqPump();
+        return;
+    }
+    PcSend(PcLast[0], PcLast + 1, PcLastLength);
+    PcDeadline = PcTime + COMMAND_TIMEOUT_NS;
+}
+
+// Host events up to the programmer clock, in their order
+static void PcRun(void) {
+    while (PcState != PC_FINISHED && PcState != PC_FAILED) {
+        if (ToHost.head != ToHost.tail && ToHost.time[ToHost.head % LINK_SIZE] <= Now &&
+                (PcDeadline == 0 || ToHost.time[ToHost.head % LINK_SIZE] <= PcDeadline)) {
+            PcTime = ToHost.time[ToHost.head % LINK_SIZE];
+            if (PcRxCount < PC_RX_SIZE)
+                PcRx[PcRxCount++] = ToHost.data[ToHost.head % LINK_SIZE];
+            ToHost.head++;
+            PcParse();
+        } else if (PcDeadline != 0 && PcDeadline <= Now) {
+            PcTime = PcDeadline;
+            PcTimeout();
+        } else
+            break;
+    }
+}
+
+static void PcStart(bool windowed) {
+    PcWindowed = windowed;
+    PcChipErase = false;
+    PcTime = PcLinkFree = PcDeadline = 0;
+    PcRxCount = 0;
+    if (windowed) {
+        PcState = PC_WINDOW_INFO;
+        PcCommand(COMM_PKT_WINDOW_INFO, NULL, 0);
+    } else {
+        PcState = PC_MAX_PAYLOAD;
+        PcCommand(COMM_PKT_MAX_PAYLOAD_SIZE, NULL, 0);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// One programming of the image, returns the time taken in ms, 0 on errors
+static double HostRun(const char *name, bool windowed, uint32_t errorRate) {
+    memset(&Stats, 0, sizeof (Stats));
+    memset(&ToBoard, 0, sizeof (ToBoard));
+    memset(&ToHost, 0, sizeof (ToHost));
+    FifoCount = FifoHead = 0;
+    ErrorRate = errorRate;
+    Now = 0;
+    PcStart(windowed);
+
+    if (setjmp(AbortProgrammer) == 0)
+        ProgramExternalMemorySectors(HostFlashRead, HostFlashWrite, HostFlashChipErase, HostFlashSectorErase);
+
+    // the reply to MEMORY_DONE
+    while (PcState != PC_FINISHED && PcState != PC_FAILED && Now < TIME_LIMIT_NS) {
+        Now += MS;
+        PcRun();
+    }
+
+    printf("%-26s %9.1f s  %8u bytes  %4u sectors  %4u resent  %3u nacks  %3u timeouts  %3u overruns  %3u link errors\n",
+            name, Now / 1e9, Stats.BytesSent, windowed ? Stats.SectorsSent : (unsigned) SECTORS,
+            Stats.Resent, Stats.Nacks, Stats.Timeouts, Stats.Overruns, Stats.LinkErrors);
+    if (PcState != PC_FINISHED || memcmp(Flash, Image, IMAGE_SIZE) != 0) {
+        printf("%s: the flash does not hold the image\n", name);
+        return 0;
+    }
+    return Now / 1e6;
+}
+
+static void HostRandom(uint8_t *data, uint32_t length) {
+    while (length--)
+        *data++ = rand();
+}
+
+int main(int argc, char **argv) {
+    uint32_t baud = 115200, changed = 8, errorRate = 20000, seed = 1, i, sector;
+    double legacy, full, update, noisy;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (a + 1 < argc && !strcmp(argv[a], "-b"))
+            baud = strtoul(argv[++a], NULL, 0);
+        else if (a + 1 < argc && !strcmp(argv[a], "-l"))
+            Latency = strtoul(argv[++a], NULL, 0) * MS;
+        else if (a + 1 < argc && !strcmp(argv[a], "-f"))
+            FifoSize = strtoul(argv[++a], NULL, 0);
+        else if (a + 1 < argc && !strcmp(argv[a], "-c"))
+            changed = strtoul(argv[++a], NULL, 0);
+        else if (a + 1 < argc && !strcmp(argv[a], "-e"))
+            errorRate = strtoul(argv[++a], NULL, 0);
+        else if (a + 1 < argc && !strcmp(argv[a], "-s"))
+            seed = strtoul(argv[++a], NULL, 0);
+        else {
+            fprintf(stderr, "Usage: HostLink [-b baud] [-l ms] [-f bytes] [-c sectors] [-e bytes] [-s seed]\n");
+            return 1;
+        }
+    }
+    if (FifoSize > sizeof (Fifo))
+        FifoSize = sizeof (Fifo);
+    if (changed > SECTORS)
+        changed = SECTORS;
+    srand(seed);
+    ByteNs = 10 * 1000000000ull / baud;
+    printf("%u baud, %u ms latency each way, %u byte UART queue, %u byte packets, window %u\n",
+            baud, (unsigned) (Latency / MS), FifoSize, COMM_PKT_RX_MAX_SIZE, COMM_PKT_WINDOW);
+
+    HostRandom(Image, IMAGE_SIZE);
+    HostRandom(Flash, FLASH_SIZE);
+    legacy = HostRun("legacy, stop and wait", false, 0);
+
+    HostRandom(Flash, FLASH_SIZE);
+    memset(Flash, 0xFF, IMAGE_SIZE);
+    full = HostRun("window, blank chip", true, 0);
+
+    // the board holds the image, the new one differs in -c sectors: 16 bytes
+    // changed in each, never across a sector boundary
+    for (i = 0; i < changed; i++) {
+        do
+            sector = rand() % SECTORS;
+        while (memcmp(Image + sector * SECTOR_SIZE, Flash + sector * SECTOR_SIZE, SECTOR_SIZE) != 0);
+        HostRandom(Image + sector * SECTOR_SIZE + rand() % (SECTOR_SIZE - 16 + 1), 16);
+    }
+    update = HostRun("window, field update", true, 0);
+
+    HostRandom(Image, IMAGE_SIZE);
+    memset(Flash, 0xFF, IMAGE_SIZE);
+    noisy = errorRate ? HostRun("window, link errors", true, errorRate) : 1;
+
+    if (legacy == 0 || full == 0 || update == 0 || noisy == 0) {
+        printf("FAILED\n");
+        return 2;
+    }
+    printf("speed-up over stop and wait: %.2fx blank chip, %.1fx field update\n", legacy / full, legacy / update);
+    return 0;
+}
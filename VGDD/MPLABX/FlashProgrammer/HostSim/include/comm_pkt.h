@@ -0,0 +1,14 @@
+// *****************************************************************************
+// Flash programmer host simulation
+// comm_pkt.h as the VGDD project templates name it
+// *****************************************************************************
+// FileName:        comm_pkt.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#include "../../MLA/comm_pkt_MLA.h"
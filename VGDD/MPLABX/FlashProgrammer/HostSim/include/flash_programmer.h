@@ -0,0 +1,14 @@
+// *****************************************************************************
+// Flash programmer host simulation
+// flash_programmer.h as the VGDD project templates name it
+// *****************************************************************************
+// FileName:        flash_programmer.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#include "../../MLA/flash_programmer_MLA.h"
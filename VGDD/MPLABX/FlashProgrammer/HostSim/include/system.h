@@ -0,0 +1,32 @@
+// *****************************************************************************
+// Flash programmer host simulation
+// Stand-in for the application system.h
+// *****************************************************************************
+// FileName:        system.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// No communication medium is defined: HostLink.c provides the comm_pkt
+// callbacks in place of comm_pkt_callback_MLA.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _SYSTEM_H
+#define _SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define COMM_PKT_RX_MAX_SIZE    (1024)
+
+#define Nop()
+
+typedef struct {
+    int dummy;
+} DRV_SPI_INIT_DATA;
+
+#endif
@@ -33,6 +33,41 @@
  
  This module is used by serval different Graphics demos and is part of the 
  common directory under the Graphics demo.
+
+ Windowed transfer
+
+ A host that sends COMM_PKT_WINDOW_INFO may then send up to COMM_PKT_WINDOW
+ COMM_PKT_MEMORY_WRITE_SEQ packets without waiting for their replies.  The
+ packets are numbered from 0 after each COMM_PKT_WINDOW_INFO and the reply
+ to each one carries the number of the next packet expected: an ACK once a
+ packet is taken for programming (or was already), a single NACK when a
+ packet is out of order, after which the host sends again from that number.
+ Packets and replies of these commands, and of COMM_PKT_MEMORY_CRC, end
+ with the CRC32 of their header, check_sum taken as 0, and of the payload
+ before it.  A packet that fails the CRC is skipped one byte at a time
+ until a valid one is found, so the stream gets back in step by itself.
+
+ Payloads (little endian), the CRC32 not shown:
+   COMM_PKT_WINDOW_INFO        command: none
+                               reply:   uint16_t max data bytes per packet,
+                                        uint16_t window, uint32_t erase
+                                        sector size (0 = no sector erase)
+   COMM_PKT_MEMORY_WRITE_SEQ   command: uint16_t number, uint16_t flags,
+                                        uint32_t address, data
+                               reply:   uint16_t next number expected,
+                                        uint16_t COMM_PKT_SEQ_STATUS_...
+   COMM_PKT_MEMORY_CRC         command: uint32_t address, uint32_t range,
+                                        uint32_t block (0 = whole range)
+                               reply:   uint32_t CRC32 of each block
+
+ Together with COMM_PKT_SEQ_ERASE, the CRC of each erase sector lets the
+ host program only the sectors that changed, without a chip erase.  A packet
+ with COMM_PKT_SEQ_ERASE is acknowledged once the sector is erased, and the
+ host sends nothing past it until then.
+
+ Over the serial port the UART receive queue must hold the bytes that come
+ in while FLASH_PROGRAMMER_WRITE_CHUNK bytes are programmed: about 20 at
+ 115200 baud for 256 bytes at 5 us each.
  *****************************************************************************/
 #ifndef COMM_PKT_HEADER_FILE
 #define COMM_PKT_HEADER_FILE
@@ -54,10 +89,32 @@
 #define COMM_PKT_MAX_PAYLOAD_SIZE            (0x05)
 #define COMM_PKT_MEMORY_VERIFY               (0x06)
 #define COMM_PKT_MEMORY_DONE                 (0x07)
+#define COMM_PKT_WINDOW_INFO                 (0x08)
+#define COMM_PKT_MEMORY_WRITE_SEQ            (0x09)
+#define COMM_PKT_MEMORY_CRC                  (0x0A)
+
+#define COMM_PKT_HAS_CRC(cmd)               (((cmd) >= COMM_PKT_WINDOW_INFO) && ((cmd) <= COMM_PKT_MEMORY_CRC))
+#define COMM_PKT_CRC_SIZE                   (4)
+
+// COMM_PKT_MEMORY_WRITE_SEQ packets the host may send ahead of the replies
+#ifndef COMM_PKT_WINDOW
+#define COMM_PKT_WINDOW                     (4)
+#endif
+
+// COMM_PKT_MEMORY_WRITE_SEQ flags
+#define COMM_PKT_SEQ_ERASE                  (0x0001)    // erase the sector at the address first
+
+// COMM_PKT_MEMORY_WRITE_SEQ reply status, kept until the next COMM_PKT_WINDOW_INFO
+#define COMM_PKT_SEQ_STATUS_OK              (0)
+#define COMM_PKT_SEQ_STATUS_WRITE_ERROR     (1)
+#define COMM_PKT_SEQ_STATUS_ERASE_ERROR     (2)
 
 #define COMM_PKT_REPLY                      1
 #define COMM_PKT_ACK                        1
 #define COMM_PKT_NACK                       0
+
+// Received bytes not handled yet: the window of packets and one USB packet
+#define COMM_PKT_RX_BUFFER_SIZE             (COMM_PKT_WINDOW * (COMM_PKT_RX_MAX_SIZE + sizeof(COMM_PKT_HDR)) + 64)
 /*****************************************************************************
  * Section: Structures
  *****************************************************************************/
@@ -105,8 +162,21 @@ uint8_t *COMM_PKT_GetRxPacket(void);
 bool COMM_PKT_IsPacketValid(
                                 uint8_t *packet);
 
+/*****************************************************************************
+ * COMM_PKT_CRC32
+ *
+ * CRC32 (IEEE 802.3) of length bytes, continuing from crc: pass 0 to start.
+ *****************************************************************************/
+uint32_t COMM_PKT_CRC32(
+                                uint32_t crc,
+                                uint8_t *data,
+                                uint32_t length);
+
 /*****************************************************************************
  * COMM_PKT_SendCommand
+ *
+ * For the commands with a CRC32, payload must have room for it after
+ * payloadSize bytes.
  *****************************************************************************/
 void COMM_PKT_SendCommand(
                                 COMM_PKT_MEDIA media,
@@ -116,6 +186,9 @@ void COMM_PKT_SendCommand(
 
 /*****************************************************************************
  * COMM_PKT_SendReply
+ *
+ * For the commands with a CRC32, payload must have room for it after
+ * payloadSize bytes.
  *****************************************************************************/
 void COMM_PKT_SendReply(
                                 COMM_PKT_MEDIA media,
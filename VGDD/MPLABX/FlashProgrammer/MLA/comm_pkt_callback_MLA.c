@@ -93,7 +93,7 @@ bool COMM_PKT_DataAvailable(COMM_PKT_MEDIA media)
  *****************************************************************************/
 uint16_t COMM_PKT_GetData(COMM_PKT_MEDIA media, uint8_t *buffer, uint16_t offset)
 {
-    if(offset >= (COMM_PKT_RX_MAX_SIZE + sizeof(COMM_PKT_HDR)))
+    if(offset >= COMM_PKT_RX_BUFFER_SIZE)
         return offset;
 
 #ifdef USE_COMM_PKT_MEDIA_SERIAL_PORT
@@ -103,7 +103,7 @@ uint16_t COMM_PKT_GetData(COMM_PKT_MEDIA media, uint8_t *buffer, uint16_t offset
     {
         status = DRV_UART2_TransferStatus();
 
-        while (status & DRV_UART2_TRANSFER_STATUS_RX_DATA_PRESENT)
+        while ((status & DRV_UART2_TRANSFER_STATUS_RX_DATA_PRESENT) && (offset < COMM_PKT_RX_BUFFER_SIZE))
         {
             buffer[offset] = DRV_UART2_ReadByte() ;
             offset++;
@@ -119,6 +119,10 @@ uint16_t COMM_PKT_GetData(COMM_PKT_MEDIA media, uint8_t *buffer, uint16_t offset
         while(!USBHandleBusy(USBGenericOutHandle))
         {
             uint16_t len = USBHandleGetLength(USBGenericOutHandle);
+
+            // no room: the packet waits in OUTPacket
+            if((offset + len) > COMM_PKT_RX_BUFFER_SIZE)
+                break;
     
             if(len > 0)
             {
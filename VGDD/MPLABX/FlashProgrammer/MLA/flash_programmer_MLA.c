@@ -34,6 +34,7 @@
 /*****************************************************************************
  * Section: Includes
  *****************************************************************************/
+#include <string.h>
 #include "comm_pkt.h"
 #include "system.h"
 #include "flash_programmer.h"
@@ -60,7 +61,10 @@
  *****************************************************************************/
 void     BinaryMemoryUpload(void);
 bool     BinaryHandlePacket(void);
+void     BinaryEraseSeq(uint32_t addr);
+void     BinaryWriteSeq(uint32_t addr, uint8_t *data, uint16_t length);
 uint32_t CalculateCheckSum(uint32_t addr, uint8_t *buffer, uint32_t range);
+uint32_t CalculateCRC(uint32_t addr, uint32_t range);
 
 /*****************************************************************************
  * Section: Function Pointers
@@ -69,6 +73,14 @@ FLASH_INIT_FUNC           pFlashInitFunc     = NULL; // function pointer to init
 FLASH_READ_FUNC           pDataReadFunc      = NULL; // function pointer to data read
 FLASH_WRITE_FUNC          pDataWriteFunc     = NULL; // function pointer to data write
 FLASH_CHIPERASE_FUNC      pDataChipEraseFunc = NULL; // function pointer to erase chip
+FLASH_SECTORERASE_FUNC    pDataSectorEraseFunc = NULL; // function pointer to erase sector
+
+/*****************************************************************************
+ * Section: Variables
+ *****************************************************************************/
+uint16_t seqExpected;       // number of the next COMM_PKT_MEMORY_WRITE_SEQ packet
+uint16_t seqStatus;         // COMM_PKT_SEQ_STATUS_... since COMM_PKT_WINDOW_INFO
+bool     seqNackSent;       // a NACK was sent for seqExpected
 
 /*****************************************************************************
  * Section: Externs
@@ -96,6 +108,40 @@ typedef struct
     uint32_t range __attribute__((packed));
 }COMM_PKT_VERIFY_PAYLOAD;
 
+typedef struct
+{
+    uint16_t maxData;
+    uint16_t window;
+    uint32_t sectorSize __attribute__((packed));
+}COMM_PKT_WINDOW_PAYLOAD;
+
+typedef struct
+{
+    uint16_t seq;
+    uint16_t flags;
+    uint32_t addr __attribute__((packed));
+    uint8_t data;
+}COMM_PKT_SEQ_PAYLOAD;
+
+typedef struct
+{
+    uint16_t nextSeq;
+    uint16_t status;
+}COMM_PKT_SEQ_REPLY_PAYLOAD;
+
+typedef struct
+{
+    uint32_t addr __attribute__((packed));
+    uint32_t range __attribute__((packed));
+    uint32_t block __attribute__((packed));
+}COMM_PKT_CRC_PAYLOAD;
+
+// data bytes in a COMM_PKT_MEMORY_WRITE_SEQ packet
+#define SEQ_DATA_MAX        (COMM_PKT_RX_MAX_SIZE - 8 - COMM_PKT_CRC_SIZE)
+
+// bytes read at a time for the CRC
+#define CRC_READ_SIZE       (128)
+
 /*****************************************************************************
  * Section: Functions
  *****************************************************************************/
@@ -112,11 +158,29 @@ int ProgramExternalMemory(
                                 FLASH_WRITE_FUNC pWriteFunc,
                                 FLASH_CHIPERASE_FUNC pChipErase)
 
+{
+    return ProgramExternalMemorySectors(pReadFunc, pWriteFunc, pChipErase, NULL);
+}
+
+/*****************************************************************************
+    int ProgramExternalMemorySectors(
+                                FLASH_READ_FUNC pReadFunc,
+                                FLASH_WRITE_FUNC pWriteFunc,
+                                FLASH_CHIPERASE_FUNC pChipErase,
+                                FLASH_SECTORERASE_FUNC pSectorErase)
+ *****************************************************************************/
+int ProgramExternalMemorySectors(
+                                FLASH_READ_FUNC pReadFunc,
+                                FLASH_WRITE_FUNC pWriteFunc,
+                                FLASH_CHIPERASE_FUNC pChipErase,
+                                FLASH_SECTORERASE_FUNC pSectorErase)
+
 {
 
     pDataReadFunc       = pReadFunc;
     pDataWriteFunc      = pWriteFunc;
     pDataChipEraseFunc  = pChipErase;
+    pDataSectorEraseFunc = pSectorErase;
 
 #ifdef USE_COMM_PKT_MEDIA_USB
     USBGenericOutHandle = 0;
@@ -235,6 +299,10 @@ bool BinaryHandlePacket(void)
     COMM_PKT_HDR *hdr;
     uint8_t ack_nack;
     bool result = false;
+    bool reply = true;
+    uint8_t *writeData = NULL;
+    uint32_t writeAddr = 0;
+    uint16_t writeLength = 0;
 
     if(COMM_PKT_RxPacketAvailable() == false)
         return result; 
@@ -264,6 +332,114 @@ bool BinaryHandlePacket(void)
     	pDataChipEraseFunc();
         break;
 
+    case COMM_PKT_MEMORY_SECTOR_ERASE:
+        {
+            COMM_PKT_MEMORY_PAYLOAD *memPayload = (COMM_PKT_MEMORY_PAYLOAD *)payload;
+
+            if((pDataSectorEraseFunc == NULL) || (hdr->length < 4))
+                ack_nack = COMM_PKT_NACK;
+            else
+                pDataSectorEraseFunc(memPayload->addr & ~(uint32_t)(FLASH_PROGRAMMER_SECTOR_SIZE - 1));
+
+            hdr->length = 4;
+        }
+        break;
+
+    case COMM_PKT_WINDOW_INFO:
+        {
+            COMM_PKT_WINDOW_PAYLOAD *windowPayload = (COMM_PKT_WINDOW_PAYLOAD *)payload;
+
+            seqExpected = 0;
+            seqStatus = COMM_PKT_SEQ_STATUS_OK;
+            seqNackSent = false;
+
+            windowPayload->maxData = SEQ_DATA_MAX;
+            windowPayload->window = COMM_PKT_WINDOW;
+            windowPayload->sectorSize = (pDataSectorEraseFunc == NULL) ? 0 : FLASH_PROGRAMMER_SECTOR_SIZE;
+            hdr->length = sizeof(COMM_PKT_WINDOW_PAYLOAD);
+        }
+        break;
+
+    case COMM_PKT_MEMORY_WRITE_SEQ:
+        {
+            COMM_PKT_SEQ_PAYLOAD *seqPayload = (COMM_PKT_SEQ_PAYLOAD *)payload;
+            COMM_PKT_SEQ_REPLY_PAYLOAD *seqReply = (COMM_PKT_SEQ_REPLY_PAYLOAD *)payload;
+            int16_t ahead = (int16_t)(seqPayload->seq - seqExpected);
+
+            if(hdr->length < (8 + COMM_PKT_CRC_SIZE))
+            {
+                ack_nack = COMM_PKT_NACK;
+            }
+            else if(ahead == 0)
+            {
+                // programmed once the reply is sent: the reply and its
+                // CRC32 only overwrite the number, flags and address
+                writeData = (uint8_t *)&seqPayload->data;
+                writeAddr = seqPayload->addr;
+                writeLength = hdr->length - 8 - COMM_PKT_CRC_SIZE;
+                seqExpected++;
+                seqNackSent = false;
+
+                // the erase is done before the reply: the host sends
+                // nothing more until then
+                if(seqPayload->flags & COMM_PKT_SEQ_ERASE)
+                    BinaryEraseSeq(writeAddr);
+            }
+            else if(ahead > 0)
+            {
+                // a packet was lost: the host sends again from seqExpected,
+                // the ones already on their way are dropped quietly
+                ack_nack = COMM_PKT_NACK;
+                reply = !seqNackSent;
+                seqNackSent = true;
+            }
+
+            // ahead < 0: sent again after a lost reply, acknowledged again
+
+            seqReply->nextSeq = seqExpected;
+            seqReply->status = seqStatus;
+            hdr->length = sizeof(COMM_PKT_SEQ_REPLY_PAYLOAD);
+        }
+        break;
+
+    case COMM_PKT_MEMORY_CRC:
+        {
+            COMM_PKT_CRC_PAYLOAD *crcPayload = (COMM_PKT_CRC_PAYLOAD *)payload;
+            uint32_t addr = crcPayload->addr;
+            uint32_t range = crcPayload->range;
+            uint32_t block = crcPayload->block;
+            uint32_t crc;
+            uint16_t count = 0;
+
+            if((block == 0) || (block > range))
+                block = range;
+
+            if((hdr->length < (12 + COMM_PKT_CRC_SIZE)) ||
+               ((block != 0) && (((range - 1) / block) >= ((COMM_PKT_RX_MAX_SIZE - COMM_PKT_CRC_SIZE) / 4))))
+            {
+                ack_nack = COMM_PKT_NACK;
+                hdr->length = 0;
+                break;
+            }
+
+            // the results overwrite the request, already read
+            do
+            {
+                if(block > range)
+                    block = range;
+
+                crc = CalculateCRC(addr, block);
+                memcpy(payload + (count * 4), &crc, 4);
+                count++;
+
+                addr += block;
+                range -= block;
+            } while(range > 0);
+
+            hdr->length = count * 4;
+        }
+        break;
+
     case COMM_PKT_MEMORY_WRITE:
         {    
             COMM_PKT_MEMORY_PAYLOAD *memPayload = (COMM_PKT_MEMORY_PAYLOAD *)payload;
@@ -303,15 +479,64 @@ bool BinaryHandlePacket(void)
         break;
     }
 
-    COMM_PKT_SendReply( FLASH_PROGRAMMER_COMMUNICATION_MEDIUM,
-                        hdr->cmd,
-                        ack_nack,
-                        payload,
-                        hdr->length);
+    if(reply)
+    {
+        COMM_PKT_SendReply( FLASH_PROGRAMMER_COMMUNICATION_MEDIUM,
+                            hdr->cmd,
+                            ack_nack,
+                            payload,
+                            hdr->length);
+    }
+
+    // The packet is acknowledged before it is programmed, so that the
+    // next ones come in while the memory is busy
+    if(writeData != NULL)
+        BinaryWriteSeq(writeAddr, writeData, writeLength);
 
     return result;
 }
 
+/*****************************************************************************
+ * void BinaryEraseSeq(uint32_t addr)
+ *****************************************************************************/
+void BinaryEraseSeq(uint32_t addr)
+{
+    // the host stops at the first error it is told about
+    if(seqStatus != COMM_PKT_SEQ_STATUS_OK)
+        return;
+
+    if(pDataSectorEraseFunc == NULL)
+        seqStatus = COMM_PKT_SEQ_STATUS_ERASE_ERROR;
+    else
+        pDataSectorEraseFunc(addr & ~(uint32_t)(FLASH_PROGRAMMER_SECTOR_SIZE - 1));
+}
+
+/*****************************************************************************
+ * void BinaryWriteSeq(uint32_t addr, uint8_t *data, uint16_t length)
+ *****************************************************************************/
+void BinaryWriteSeq(uint32_t addr, uint8_t *data, uint16_t length)
+{
+    uint16_t chunk;
+
+    while((length > 0) && (seqStatus == COMM_PKT_SEQ_STATUS_OK))
+    {
+        chunk = FLASH_PROGRAMMER_WRITE_CHUNK;
+        if(chunk > length)
+            chunk = length;
+
+        if(!pDataWriteFunc(addr, data, chunk))
+            seqStatus = COMM_PKT_SEQ_STATUS_WRITE_ERROR;
+
+        addr += chunk;
+        data += chunk;
+        length -= chunk;
+
+        // the next packets keep coming in: take them before the UART
+        // receive queue fills up
+        COMM_PKT_Update(FLASH_PROGRAMMER_COMMUNICATION_MEDIUM);
+    }
+}
+
 /*****************************************************************************
  * uint32_t CalculateCheckSum(uint32_t addr, uint8_t *buffer, uint32_t range)
  *****************************************************************************/
@@ -343,3 +568,28 @@ uint32_t CalculateCheckSum(uint32_t addr, uint8_t *buffer, uint32_t range)
     return checksum;
 
 }
+
+/*****************************************************************************
+ * uint32_t CalculateCRC(uint32_t addr, uint32_t range)
+ *****************************************************************************/
+uint32_t CalculateCRC(uint32_t addr, uint32_t range)
+{
+    uint8_t    buffer[CRC_READ_SIZE];
+    uint32_t   crc = 0;
+
+    while(range > 0)
+    {
+        uint16_t readSize = CRC_READ_SIZE;
+
+        if(readSize > range)
+            readSize = range;
+
+        pDataReadFunc(addr, buffer, readSize);
+        crc = COMM_PKT_CRC32(crc, buffer, readSize);
+
+        range -= readSize;
+        addr += (uint32_t)readSize;
+    }
+
+    return crc;
+}
@@ -48,9 +48,23 @@ typedef void (*FLASH_READ_FUNC     )(uint32_t, uint8_t*, uint16_t);
 // typedef for write function pointer
 typedef uint8_t (*FLASH_WRITE_FUNC    )(uint32_t, uint8_t*, uint16_t);
 
-// typedef for sector erase function pointer
+// typedef for chip erase function pointer
 typedef void (*FLASH_CHIPERASE_FUNC)(void);
 
+// typedef for sector erase function pointer
+typedef void (*FLASH_SECTORERASE_FUNC)(uint32_t);
+
+// size of the sectors erased by the sector erase function
+#ifndef FLASH_PROGRAMMER_SECTOR_SIZE
+#define FLASH_PROGRAMMER_SECTOR_SIZE    (4096)
+#endif
+
+// bytes programmed between two reads of the communication medium, while
+// the packets of a window come in
+#ifndef FLASH_PROGRAMMER_WRITE_CHUNK
+#define FLASH_PROGRAMMER_WRITE_CHUNK    (256)
+#endif
+
 /*****************************************************************************
  * Section: Function Prototypes
  *****************************************************************************/
@@ -64,6 +78,22 @@ int ProgramExternalMemory(
                                 FLASH_READ_FUNC pReadFunc,
                                 FLASH_WRITE_FUNC pWriteFunc,
                                 FLASH_CHIPERASE_FUNC pChipErase);
+
+/*****************************************************************************
+ * int ProgramExternalMemorySectors(
+                                FLASH_READ_FUNC pReadFunc,
+                                FLASH_WRITE_FUNC pWriteFunc,
+                                FLASH_CHIPERASE_FUNC pChipErase,
+                                FLASH_SECTORERASE_FUNC pSectorErase)
+
+ Same as ProgramExternalMemory, with the sector erase used by the host to
+ program only the sectors that changed.
+ *****************************************************************************/
+int ProgramExternalMemorySectors(
+                                FLASH_READ_FUNC pReadFunc,
+                                FLASH_WRITE_FUNC pWriteFunc,
+                                FLASH_CHIPERASE_FUNC pChipErase,
+                                FLASH_SECTORERASE_FUNC pSectorErase);
     
     
     
@@ -157,6 +157,8 @@
 
 //#define USE_BITMAP_EXTERNAL   // Support for bitmaps located in external memory
 
+//#define USE_BITMAP_RLE        // Support for RLE bitmaps (R61509V driver, see R61509V.h)
+
 
 /*********************************************************************
  * Overview: Define the malloc() and free() for versatility on OS
@@ -0,0 +1,337 @@
+// *****************************************************************************
+// PCAP host simulation
+// Synthetic MTCH6301 report streams through the touch sample queue
+// *****************************************************************************
+// FileName:        HostTouch.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Plays random taps and drags as MTCH6301 reports, 100 per second while a
+// finger is down, with a second finger now and then. Each report raises
+// INT0: _PCAPHandler() runs and the core software interrupt it requests
+// runs _PCAPReadHandler(), which reads the report through I2C_ReadBlock().
+// With PCAP_DEFER_POLLED a task calls TouchReadReports() instead, when the
+// interrupt would have run. Sometimes the reader is held back as a higher
+// priority interrupt would, so that it finds more than one report pending.
+// Meanwhile the main loop calls TouchGetMsg() once per GOL frame, the frames
+// taking from 1 to 120 ms to draw, with a few stalls of up to a second.
+//
+// The GOL messages are checked against the gestures played:
+//  - every press and release reaches GOL, in order, at the reported position
+//  - moves and still presses only come between a press and its release
+//  - the message before a release is at the last reported position, unless
+//    moves of that touch were dropped
+// A mismatch makes the tool exit with 2. The same stream is also sampled as
+// the previous driver did (the last point, read by TouchGetMsg() once per
+// frame) to count the taps it missed.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -I.. -o HostTouch HostTouch.c ../TouchScreenCapacitive.c
+// with -DPCAP_DEFER_VECTOR=_CORE_SOFTWARE_1_VECTOR or
+// -DPCAP_DEFER_VECTOR=PCAP_DEFER_POLLED for the other readers.
+//
+// Usage:
+//   HostTouch [-g gestures] [-s seed] [-q]
+//     -g  number of gestures played (default 2000)
+//     -s  random seed (default 1)
+//     -q  no stall of the main loop
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	PCAP_DEFER_VECTOR
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HardwareProfile.h"
+#include "Graphics/Graphics.h"
+#include "TouchScreenCapacitive.h"
+
+#define TICKS_PER_MS        (GetSystemClock() / 2000ul)    // Core timer
+#define REPORT_PERIOD_MS    10u                             // MTCH6301 report rate while touched
+#define MAX_EVENTS          (1ul << 20)
+
+void _PCAPHandler(void);
+void _PCAPReadHandler(void);
+
+#if (PCAP_DEFER_VECTOR == PCAP_DEFER_POLLED)
+#define HostReaderDue()     TRUE
+#define HostReader()        TouchReadReports()
+#else
+#define HostReaderDue()     (HostSoftInt && HostSoftIntEnabled)
+#define HostReader()        _PCAPReadHandler()
+#endif
+
+typedef struct {
+    DWORD time;             // ms
+    BYTE report[6];         // MTCH6301 touch report
+    BOOL press;             // first report of a touch
+} HOST_REPORT;
+
+typedef struct {
+    BYTE event;             // EVENT_PRESS or EVENT_RELEASE
+    SHORT x, y;
+    BOOL movesDropped;      // release: moves of this touch were dropped
+} HOST_STATE;
+
+volatile HOST_IFS0BITS IFS0bits;
+
+static DWORD HostTime;                  // core timer
+static BOOL HostSoftInt;                // core software interrupt requested
+static BOOL HostSoftIntEnabled;
+static const BYTE *HostReport;          // report returned by the controller
+
+static HOST_REPORT *Reports;
+static DWORD ReportCount;
+static HOST_STATE *States;              // presses and releases of touch 0 played
+static DWORD StateCount;
+
+DWORD ReadCoreTimer(void) {
+    return HostTime;
+}
+
+void CoreSetSoftwareInterrupt0(void) {
+    HostSoftInt = TRUE;
+}
+
+void CoreClearSoftwareInterrupt0(void) {
+    HostSoftInt = FALSE;
+}
+
+void CoreSetSoftwareInterrupt1(void) {
+    HostSoftInt = TRUE;
+}
+
+void CoreClearSoftwareInterrupt1(void) {
+    HostSoftInt = FALSE;
+}
+
+void INTSetVectorPriority(int vector, int priority) {
+}
+
+void INTClearFlag(int source) {
+}
+
+void INTEnable(int source, int enable) {
+    if (source == INT_CS0 || source == INT_CS1)
+        HostSoftIntEnabled = enable;
+}
+
+BYTE I2C_ReadBlock(BYTE deviceID, BYTE offset, BYTE *buffer, WORD length) {
+    memcpy(buffer, HostReport, length);
+    return 0;
+}
+
+// Screen position of a controller coordinate, as TouchScreenCapacitive.c
+// computes it
+static SHORT HostScreenX(WORD raw) {
+    return (SHORT) (((raw * (GetMaxX() + 1)) >> 10) - ((GetMaxX() + 1) * 10) / 100);
+}
+
+static SHORT HostScreenY(WORD raw) {
+    return (SHORT) ((raw * (GetMaxY() + 1)) >> 10);
+}
+
+static void HostAddReport(DWORD time, BYTE touch, BOOL down, WORD rawX, WORD rawY) {
+    HOST_REPORT *pReport;
+
+    if (ReportCount == MAX_EVENTS)
+        return;
+    pReport = &Reports[ReportCount++];
+    pReport->time = time;
+    pReport->press = FALSE;
+    pReport->report[0] = 0x81;
+    pReport->report[1] = (BYTE) ((touch << 3) | (down ? 1 : 0));
+    pReport->report[2] = rawX & 0x7F;
+    pReport->report[3] = (BYTE) (rawX >> 7);
+    pReport->report[4] = rawY & 0x7F;
+    pReport->report[5] = (BYTE) (rawY >> 7);
+}
+
+static void HostAddState(BYTE event, WORD rawX, WORD rawY) {
+    States[StateCount].event = event;
+    States[StateCount].x = HostScreenX(rawX);
+    States[StateCount].y = HostScreenY(rawY);
+    States[StateCount].movesDropped = FALSE;
+    StateCount++;
+}
+
+static WORD HostWalk(WORD v, int step, WORD min) {
+    int n = (int) v + (rand() % (2 * step + 1)) - step;
+
+    if (n < min)
+        n = min;
+    if (n > 1023)
+        n = 1023;
+    return (WORD) n;
+}
+
+// TRUE if report n moves touch 0
+static BOOL HostMoveOf0(DWORD n) {
+    return n < ReportCount && Reports[n].report[1] == 0x01 && !Reports[n].press;
+}
+
+// Random taps (1 to 3 reports) and drags (up to 2 s), touch 1 sometimes down
+// during a drag of touch 0
+static void HostMakeGestures(DWORD gestures) {
+    DWORD time = 5, g, i, length;
+    WORD x, y, x1 = 0, y1 = 0, minX = 110;    // screen x of raw 110 clears the inset
+    BOOL second;
+
+    for (g = 0; g < gestures; g++) {
+        x = HostWalk(512, 400, minX);
+        y = HostWalk(512, 400, 0);
+        length = (rand() % 3) ? 1 + rand() % 3 : 5 + rand() % 200;
+        second = length > 20 && rand() % 4 == 0;
+        if (second) {
+            x1 = HostWalk(300, 200, minX);
+            y1 = HostWalk(300, 200, 0);
+        }
+        HostAddState(EVENT_PRESS, x, y);
+        for (i = 0; i < length; i++) {
+            if (i)
+                x = HostWalk(x, 6, minX), y = HostWalk(y, 6, 0);
+            HostAddReport(time, 0, TRUE, x, y);
+            if (i == 0)
+                Reports[ReportCount - 1].press = TRUE;
+            if (second && i >= 5 && i < length - 5)
+                HostAddReport(time + 4, 1, TRUE, x1 = HostWalk(x1, 6, minX), y1 = HostWalk(y1, 6, 0));
+            time += REPORT_PERIOD_MS;
+        }
+        if (second)
+            HostAddReport(time - 6, 1, FALSE, 0, 0);
+        HostAddReport(time, 0, FALSE, 0, 0);
+        HostAddState(EVENT_RELEASE, x, y);
+        time += 30 + rand() % 400;
+    }
+}
+
+int main(int argc, char **argv) {
+    DWORD gestures = 2000, seed = 1, next = 0, frameEnd = 0, frames = 0;
+    DWORD state = 0, messages[EVENT_CLR_STATE + 1] = {0}, legacyTaps = 0, errors = 0;
+    DWORD heldReads = 0, released = 0, pressDropped = 0;
+    BOOL noStall = FALSE, down = FALSE, legacyDown = FALSE, legacySeenDown = FALSE, held = FALSE;
+    SHORT lastX = -1, lastY = -1;
+    GOL_MSG msg;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "-g") && a + 1 < argc)
+            gestures = strtoul(argv[++a], NULL, 0);
+        else if (!strcmp(argv[a], "-s") && a + 1 < argc)
+            seed = strtoul(argv[++a], NULL, 0);
+        else if (!strcmp(argv[a], "-q"))
+            noStall = TRUE;
+        else {
+            fprintf(stderr, "Usage: HostTouch [-g gestures] [-s seed] [-q]\n");
+            return 1;
+        }
+    }
+    srand(seed);
+    Reports = calloc(MAX_EVENTS, sizeof (HOST_REPORT));
+    States = calloc(2 * gestures, sizeof (HOST_STATE));
+    HostMakeGestures(gestures);
+    TouchHardwareInit(NULL);
+
+    while (next < ReportCount || state < StateCount) {
+        // Reports up to the end of the frame being drawn
+        while (next < ReportCount && Reports[next].time <= frameEnd) {
+            HostTime = Reports[next].time * TICKS_PER_MS;
+            HostReport = Reports[next].report;
+            if (Reports[next].press)
+                pressDropped = TouchQueueStats.Dropped;
+            IFS0bits.INT0IF = 1;
+            _PCAPHandler();
+            // The reader runs at once, or after the next report when a
+            // higher priority interrupt holds it. The controller returns its
+            // last report, so a held reader loses one: only a move of touch 0
+            // followed by another one is held
+            held = !held && rand() % 8 == 0 && HostMoveOf0(next) && HostMoveOf0(next + 1);
+            if (held)
+                heldReads++;
+            if (HostReaderDue() && !held)
+                HostReader();
+            if (Reports[next].report[1] == 0x00)
+                States[2 * released++ + 1].movesDropped = TouchQueueStats.Dropped != pressDropped;
+            next++;
+        }
+        if (HostReaderDue())
+            HostReader();
+
+        // One GOL frame: one message, then drawing
+        TouchGetMsg(&msg);
+        frames++;
+        messages[msg.uiEvent]++;
+        switch (msg.uiEvent) {
+            case EVENT_PRESS:
+            case EVENT_RELEASE:
+                if (state == StateCount || States[state].event != msg.uiEvent ||
+                        States[state].x != msg.param1 || States[state].y != msg.param2) {
+                    printf("frame %lu: %s at %d,%d not expected\n", (unsigned long) frames,
+                            msg.uiEvent == EVENT_PRESS ? "press" : "release", msg.param1, msg.param2);
+                    errors++;
+                }
+                if (msg.uiEvent == EVENT_RELEASE && !States[state].movesDropped &&
+                        (lastX != msg.param1 || lastY != msg.param2)) {
+                    printf("frame %lu: release at %d,%d, last move to %d,%d\n", (unsigned long) frames,
+                            msg.param1, msg.param2, lastX, lastY);
+                    errors++;
+                }
+                down = msg.uiEvent == EVENT_PRESS;
+                state++;
+                break;
+            case EVENT_MOVE:
+            case EVENT_STILLPRESS:
+                if (!down) {
+                    printf("frame %lu: move without a press\n", (unsigned long) frames);
+                    errors++;
+                }
+                break;
+        }
+        if (down) {
+            lastX = msg.param1;
+            lastY = msg.param2;
+        }
+
+        // Previous driver: last point of touch 0 sampled once per frame
+        legacySeenDown = PCapX[0].Val != 0xFFFF;
+        if (legacySeenDown && !legacyDown)
+            legacyTaps++;
+        legacyDown = legacySeenDown;
+
+        if (!noStall && rand() % 200 == 0)
+            frameEnd += 200 + rand() % 800;
+        else
+            frameEnd += 1 + rand() % 120;
+        if (frames > 50 * MAX_EVENTS)
+            break;
+    }
+
+    // Nothing may be left once every report was read
+    if (TouchGetSample(&(TOUCH_SAMPLE){0})) {
+        printf("samples left in the queue\n");
+        errors++;
+    }
+    if (state != StateCount) {
+        printf("%lu of %lu presses and releases reached GOL\n", (unsigned long) state, (unsigned long) StateCount);
+        errors++;
+    }
+
+    printf("gestures %lu, reports %lu (reader held back %lu times), frames %lu\n",
+            (unsigned long) gestures, (unsigned long) ReportCount, (unsigned long) heldReads, (unsigned long) frames);
+    printf("reports read %lu, samples queued %lu, coalesced %lu, dropped %lu, max depth %u of %u\n",
+            (unsigned long) TouchQueueStats.Reports, (unsigned long) TouchQueueStats.Queued,
+            (unsigned long) TouchQueueStats.Coalesced, (unsigned long) TouchQueueStats.Dropped,
+            TouchQueueStats.MaxDepth, TOUCH_QUEUE_SIZE);
+    printf("GOL messages: press %lu, move %lu, still %lu, release %lu\n",
+            (unsigned long) messages[EVENT_PRESS], (unsigned long) messages[EVENT_MOVE],
+            (unsigned long) messages[EVENT_STILLPRESS], (unsigned long) messages[EVENT_RELEASE]);
+    printf("presses seen by sampling the last point once per frame: %lu of %lu\n",
+            (unsigned long) legacyTaps, (unsigned long) gestures);
+    printf("%s\n", errors ? "FAILED" : "All presses and releases delivered");
+    free(Reports);
+    free(States);
+    return errors ? 2 : 0;
+}
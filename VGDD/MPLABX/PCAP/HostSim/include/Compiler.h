@@ -0,0 +1,54 @@
+// *****************************************************************************
+// PCAP host simulation
+// Stand-in for Microchip's Compiler.h and the PIC32 interrupt library
+// *****************************************************************************
+// FileName:        Compiler.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The interrupt handlers are plain functions: HostTouch.c calls them when it
+// raises INT0 or the core software interrupt 0 or 1. The core timer, the
+// software interrupts and the interrupt controller calls are implemented
+// there.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Core software interrupt 1
+// *****************************************************************************
+#ifndef __COMPILER_H
+#define __COMPILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GenericTypeDefs.h"
+
+#define __ISR(vector, ipl)
+
+#define _EXTERNAL_0_VECTOR          3
+#define _CORE_SOFTWARE_0_VECTOR     1
+#define _CORE_SOFTWARE_1_VECTOR     2
+
+enum { INT_CORE_SOFTWARE_0_VECTOR = 1, INT_CORE_SOFTWARE_1_VECTOR = 2 };
+enum { INT_CS0 = 1, INT_CS1 = 2 };
+enum { INT_DISABLED = 0, INT_ENABLED = 1 };
+enum { INT_PRIORITY_LEVEL_1 = 1 };
+
+typedef struct {
+    unsigned INT0IF : 1;
+} HOST_IFS0BITS;
+
+extern volatile HOST_IFS0BITS IFS0bits;
+
+DWORD ReadCoreTimer(void);
+void CoreSetSoftwareInterrupt0(void);
+void CoreClearSoftwareInterrupt0(void);
+void CoreSetSoftwareInterrupt1(void);
+void CoreClearSoftwareInterrupt1(void);
+void INTSetVectorPriority(int vector, int priority);
+void INTClearFlag(int source);
+void INTEnable(int source, int enable);
+
+#endif
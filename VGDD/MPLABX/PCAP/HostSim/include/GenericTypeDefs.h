@@ -0,0 +1,39 @@
+// *****************************************************************************
+// PCAP host simulation
+// Stand-in for Microchip's GenericTypeDefs.h
+// *****************************************************************************
+// FileName:        GenericTypeDefs.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Only the types used by TouchScreenCapacitive.c are defined here, with the
+// same widths they have on PIC32.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GENERICTYPEDEFS_H_
+#define _GENERICTYPEDEFS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum _BOOL { FALSE = 0, TRUE } BOOL;
+
+typedef unsigned char   BYTE;
+typedef unsigned short  WORD;
+typedef uint32_t        DWORD;
+typedef signed short    SHORT;
+
+typedef union {
+    WORD Val;
+    BYTE v[2];
+    struct {
+        BYTE LB;
+        BYTE HB;
+    } byte;
+} WORD_VAL;
+
+#endif // _GENERICTYPEDEFS_H_
@@ -0,0 +1,57 @@
+// *****************************************************************************
+// PCAP host simulation
+// Stand-in for the Graphics Library headers
+// *****************************************************************************
+// FileName:        Graphics.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The GOL message and the screen size used by TouchScreenCapacitive.c, with
+// the values of the Graphics Library.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GRAPHICS_H
+#define _GRAPHICS_H
+
+#include "GenericTypeDefs.h"
+
+typedef enum {
+    TYPE_UNKNOWN = 0,
+    TYPE_KEYBOARD,
+    TYPE_TOUCHSCREEN,
+    TYPE_MOUSE,
+    TYPE_TIMER,
+    TYPE_SYSTEM
+} INPUT_DEVICE_TYPE;
+
+typedef enum {
+    EVENT_INVALID = 0,
+    EVENT_MOVE,
+    EVENT_PRESS,
+    EVENT_STILLPRESS,
+    EVENT_RELEASE,
+    EVENT_KEYSCAN,
+    EVENT_CHARCODE,
+    EVENT_SET,
+    EVENT_SET_STATE,
+    EVENT_CLR_STATE
+} INPUT_DEVICE_EVENT;
+
+typedef struct {
+    BYTE type;
+    BYTE uiEvent;
+    SHORT param1;
+    SHORT param2;
+} GOL_MSG;
+
+#define GetMaxX()   (DISP_HOR_RESOLUTION - 1)
+#define GetMaxY()   (DISP_VER_RESOLUTION - 1)
+
+void TouchHardwareInit(void *initValues);
+void TouchGetMsg(GOL_MSG *pMsg);
+
+#endif
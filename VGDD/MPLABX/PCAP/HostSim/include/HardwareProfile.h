@@ -0,0 +1,31 @@
+// *****************************************************************************
+// PCAP host simulation
+// Stand-in for the board HardwareProfile.h
+// *****************************************************************************
+// FileName:        HardwareProfile.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The PIC32 PCAP board: 480x272 display and MTCH6301 controller, FT5x06
+// when USE_CAPACITIVE_CONTROLLER_FT5x06 is defined on the command line.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef HARDWARE_PROFILE_H
+#define HARDWARE_PROFILE_H
+
+#include "Compiler.h"
+
+#ifndef USE_CAPACITIVE_CONTROLLER_FT5x06
+#define USE_CAPACITIVE_CONTROLLER_MTCH6301
+#endif
+
+#define DISP_HOR_RESOLUTION     480
+#define DISP_VER_RESOLUTION     272
+
+#define GetSystemClock()        80000000ul
+
+#endif
@@ -0,0 +1,19 @@
+// *****************************************************************************
+// PCAP host simulation
+// Stand-in for Microchip's TimeDelay.h
+// *****************************************************************************
+// FileName:        TimeDelay.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef TIMEDELAY_H
+#define TIMEDELAY_H
+
+#define DelayMs(ms)
+
+#endif
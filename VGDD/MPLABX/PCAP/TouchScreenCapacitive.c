@@ -33,6 +33,10 @@
 // Microchip         2011/01/21     Original release
 // VirtualFab        2014/02/22     Added FT5x06 support - Thanks David!
 // VirtualFab        2015/07/02     Fixed MTCH6301 support
+// VirtualFab        2026/10/17     Reports read out of the INT0 interrupt into a
+//                                  queue of timestamped samples, coalesced moves
+// VirtualFab        2026/10/17     Reader interrupt set by PCAP_DEFER_VECTOR, or
+//                                  polled with PCAP_DEFER_POLLED
 // ----------------------------------------------------------------------------
 
 #include "HardwareProfile.h"
@@ -41,91 +45,224 @@
 #include "TouchScreenCapacitive.h"
 #include "Compiler.h"
 
+#if (TOUCH_QUEUE_SIZE & (TOUCH_QUEUE_SIZE - 1)) || (TOUCH_QUEUE_SIZE > 128)
+    #error TOUCH_QUEUE_SIZE must be a power of 2, up to 128
+#endif
+#if (TOUCH_QUEUE_RESERVE >= TOUCH_QUEUE_SIZE)
+    #error TOUCH_QUEUE_RESERVE must be less than TOUCH_QUEUE_SIZE
+#endif
+
+#if (PCAP_DEFER_VECTOR == PCAP_DEFER_POLLED)
+    #define PCAP_DEFER_REQUEST()
+#elif (PCAP_DEFER_VECTOR == _CORE_SOFTWARE_0_VECTOR)
+    #define PCAP_DEFER_PRIORITY     INT_CORE_SOFTWARE_0_VECTOR
+    #define PCAP_DEFER_SOURCE       INT_CS0
+    #define PCAP_DEFER_REQUEST()    CoreSetSoftwareInterrupt0()
+    #define PCAP_DEFER_CLEAR()      CoreClearSoftwareInterrupt0()
+#elif (PCAP_DEFER_VECTOR == _CORE_SOFTWARE_1_VECTOR)
+    #define PCAP_DEFER_PRIORITY     INT_CORE_SOFTWARE_1_VECTOR
+    #define PCAP_DEFER_SOURCE       INT_CS1
+    #define PCAP_DEFER_REQUEST()    CoreSetSoftwareInterrupt1()
+    #define PCAP_DEFER_CLEAR()      CoreClearSoftwareInterrupt1()
+#else
+    #error PCAP_DEFER_VECTOR must be _CORE_SOFTWARE_0_VECTOR, _CORE_SOFTWARE_1_VECTOR or PCAP_DEFER_POLLED
+#endif
+
+#define TOUCH_INT_TIMES     4   // INT0 times kept for the reports not read yet (power of 2)
+
 WORD_VAL PCapX[5]= {-1,-1,-1,-1,-1};
 WORD_VAL PCapY[5]= {-1,-1,-1,-1,-1};
 
+TOUCH_QUEUE_STATS TouchQueueStats;
+
+// Queue of the samples of touch 0: the reader interrupt writes the sample and
+// then moves _touchHead, TouchGetMsg()/TouchGetSample() read it and then move
+// _touchTail. Both indexes run freely, the sample is at index & (size - 1).
+static TOUCH_SAMPLE _touchQueue[TOUCH_QUEUE_SIZE];
+static volatile BYTE _touchHead = 0;
+static volatile BYTE _touchTail = 0;
+
+// INT0 interrupts (written by _PCAPHandler) and reports read (written by
+// TouchReadReports): the reports pending are the difference
+static volatile BYTE _pcapInts = 0;
+static volatile BYTE _pcapReads = 0;
+static volatile DWORD _pcapIntTime[TOUCH_INT_TIMES];
+
+// Touch 0 as last queued by the reader
+static BOOL _readerDown = FALSE;
+static SHORT _readerX, _readerY;
+
 /*********************************************************************
-* Function: void TouchGetMsg(GOL_MSG* pMsg)
+* Function: static void TouchQueuePut(BYTE event, SHORT x, SHORT y, DWORD time)
 *
-* PreCondition: none
+* PreCondition: called by TouchReadReports()
 *
-* Input: pointer to the message structure to be populated
+* Input: event - EVENT_PRESS, EVENT_MOVE or EVENT_RELEASE
+*        x, y - position
+*        time - core timer count of the report
 *
 * Output: none
 *
 * Side Effects: none
 *
-* Overview: populates GOL message structure
+* Overview: appends a sample to the queue. A move is dropped when no more
+*           than TOUCH_QUEUE_RESERVE entries are free, so that the
+*           free entries are left to the presses and releases.
 *
 * Note: none
 *
 ********************************************************************/
-void TouchGetMsg(GOL_MSG *pMsg)
+static void TouchQueuePut(BYTE event, SHORT x, SHORT y, DWORD time)
 {
-    static SHORT    prevX = -1;
-    static SHORT    prevY = -1;
+    BYTE            used = _touchHead - _touchTail;
+    TOUCH_SAMPLE    *pSample;
+
+    if((used == TOUCH_QUEUE_SIZE) || ((event == EVENT_MOVE) && (TOUCH_QUEUE_SIZE - used <= TOUCH_QUEUE_RESERVE)))
+    {
+        TouchQueueStats.Dropped++;
+        return;
+    }
 
-    SHORT           x, y;
+    pSample = &_touchQueue[_touchHead & (TOUCH_QUEUE_SIZE - 1)];
+    pSample->time = time;
+    pSample->x = x;
+    pSample->y = y;
+    pSample->event = event;
+    _touchHead++;
 
-    x = TouchGetX(0);
-    y = TouchGetY(0);
-    pMsg->type = TYPE_TOUCHSCREEN;
-    pMsg->uiEvent = EVENT_INVALID;
+    TouchQueueStats.Queued++;
+    if(++used > TouchQueueStats.MaxDepth)
+        TouchQueueStats.MaxDepth = used;
+}
 
-    if((x == -1) || (y == -1))
+/*********************************************************************
+* Function: static void TouchQueueState(BOOL down, SHORT x, SHORT y, DWORD time)
+*
+* PreCondition: called by TouchReadReports()
+*
+* Input: down - touch 0 is pressed
+*        x, y - position when pressed
+*        time - core timer count of the report
+*
+* Output: none
+*
+* Side Effects: none
+*
+* Overview: queues the press, move or release that takes touch 0 from
+*           its last queued state to the reported one. A report that
+*           does not change it queues nothing.
+*
+* Note: none
+*
+********************************************************************/
+static void TouchQueueState(BOOL down, SHORT x, SHORT y, DWORD time)
+{
+    if(down)
     {
-        y = -1;
-        x = -1;
+        if(!_readerDown)
+            TouchQueuePut(EVENT_PRESS, x, y, time);
+        else if((x != _readerX) || (y != _readerY))
+            TouchQueuePut(EVENT_MOVE, x, y, time);
+        _readerX = x;
+        _readerY = y;
     }
-
-    if((prevX == x) && (prevY == y) && (x != -1) && (y != -1))
+    else if(_readerDown)
     {
-        pMsg->uiEvent = EVENT_STILLPRESS;
-        pMsg->param1 = x;
-        pMsg->param2 = y;
-        return;
+        // The release is reported where the touch was last seen
+        TouchQueuePut(EVENT_RELEASE, _readerX, _readerY, time);
     }
+    _readerDown = down;
+}
 
-    if((prevX != -1) || (prevY != -1))
-    {
-        if((x != -1) && (y != -1))
-        {
+/*********************************************************************
+* Function: BOOL TouchGetSample(TOUCH_SAMPLE *pSample)
+*
+* PreCondition: none
+*
+* Input: pSample - destination
+*
+* Output: TRUE if a sample was taken from the queue, FALSE if empty
+*
+* Side Effects: none
+*
+* Overview: takes the oldest sample of touch 0 from the queue, for the
+*           applications that want every move (TouchGetMsg() and this
+*           function share the queue)
+*
+* Note: none
+*
+********************************************************************/
+BOOL TouchGetSample(TOUCH_SAMPLE *pSample)
+{
+    BYTE    tail;
 
-            // Move
-            pMsg->uiEvent = EVENT_MOVE;
-        }
-        else
-        {
+#if (PCAP_DEFER_VECTOR == PCAP_DEFER_POLLED)
+    TouchReadReports();
+#endif
+    tail = _touchTail;
+    if(tail == _touchHead)
+        return (FALSE);
+    *pSample = _touchQueue[tail & (TOUCH_QUEUE_SIZE - 1)];
+    _touchTail = tail + 1;
+    return (TRUE);
+}
 
-            // Released
-            pMsg->uiEvent = EVENT_RELEASE;
-            pMsg->param1 = prevX;
-            pMsg->param2 = prevY;
-            prevX = x;
-            prevY = y;
-            return;
-        }
-    }
-    else
+/*********************************************************************
+* Function: void TouchGetMsg(GOL_MSG* pMsg)
+*
+* PreCondition: none
+*
+* Input: pointer to the message structure to be populated
+*
+* Output: none
+*
+* Side Effects: none
+*
+* Overview: populates GOL message structure from the queue: presses and
+*           releases one by one, the moves queued in a row as one move
+*           to the last position, EVENT_STILLPRESS while the touch is
+*           held with nothing queued
+*
+* Note: called once per GOL frame, so GOL gets at most one move a frame
+*
+********************************************************************/
+void TouchGetMsg(GOL_MSG *pMsg)
+{
+    static BOOL     msgDown = FALSE;
+    static SHORT    msgX = -1;
+    static SHORT    msgY = -1;
+
+    TOUCH_SAMPLE    sample;
+    BYTE            tail;
+
+    pMsg->type = TYPE_TOUCHSCREEN;
+
+    if(!TouchGetSample(&sample))
     {
-        if((x != -1) && (y != -1))
-        {
+        pMsg->uiEvent = msgDown ? EVENT_STILLPRESS : EVENT_INVALID;
+        pMsg->param1 = msgX;
+        pMsg->param2 = msgY;
+        return;
+    }
 
-            // Pressed
-            pMsg->uiEvent = EVENT_PRESS;
-        }
-        else
+    if(sample.event == EVENT_MOVE)
+    {
+        // Only the last of the moves in a row reaches GOL
+        tail = _touchTail;
+        while((tail != _touchHead) && (_touchQueue[tail & (TOUCH_QUEUE_SIZE - 1)].event == EVENT_MOVE))
         {
-
-            // No message
-            pMsg->uiEvent = EVENT_INVALID;
+            sample = _touchQueue[tail & (TOUCH_QUEUE_SIZE - 1)];
+            _touchTail = ++tail;
+            TouchQueueStats.Coalesced++;
         }
     }
 
-    pMsg->param1 = x;
-    pMsg->param2 = y;
-    prevX = x;
-    prevY = y;
+    pMsg->uiEvent = sample.event;
+    pMsg->param1 = sample.x;
+    pMsg->param2 = sample.y;
+    msgDown = (sample.event != EVENT_RELEASE);
+    msgX = msgDown ? sample.x : -1;
+    msgY = msgDown ? sample.y : -1;
 }
 
 /*********************************************************************
@@ -139,14 +276,20 @@ void TouchGetMsg(GOL_MSG *pMsg)
 *
 * Side Effects: none
 *
-* Overview: Initializes touch screen module.
+* Overview: Initializes touch screen module: the interrupt set by
+*           PCAP_DEFER_VECTOR, at the lowest priority, reads the reports
+*           signalled by INT0. Nothing to do with PCAP_DEFER_POLLED.
 *
-* Note: none
+* Note: INT0 and the I2C bus are set up by the application
 *
 ********************************************************************/
 void TouchHardwareInit(void *initValues)
 {
-
+#if (PCAP_DEFER_VECTOR != PCAP_DEFER_POLLED)
+    INTSetVectorPriority(PCAP_DEFER_PRIORITY, INT_PRIORITY_LEVEL_1);
+    INTClearFlag(PCAP_DEFER_SOURCE);
+    INTEnable(PCAP_DEFER_SOURCE, INT_ENABLED);
+#endif
 }
 
 /*********************************************************************
@@ -199,10 +342,25 @@ SHORT TouchGetY(BYTE touchNumber)
     return ((SHORT)result);
 }
 
-//****************************************************************************
-//Touch Int Handler
-//Triggered by the INT0 external interrupt pin
-void __ISR(_EXTERNAL_0_VECTOR, ipl4) _PCAPHandler(void) {
+/*********************************************************************
+* Function: static void TouchReadReport(DWORD time)
+*
+* PreCondition: none
+*
+* Input: time - core timer count of the INT0 interrupt
+*
+* Output: none
+*
+* Side Effects: none
+*
+* Overview: reads one report from the controller, updates PCapX/PCapY
+*           and queues the change of touch 0
+*
+* Note: none
+*
+********************************************************************/
+static void TouchReadReport(DWORD time)
+{
 #if defined(USE_CAPACITIVE_CONTROLLER_MTCH6301)  //When using MTCH6301
 // Default Calibration Inset Value (percentage of vertical or horizontal resolution)
 // Calibration Inset = ( CALIBRATIONINSET / 2 ) % , Range of 0?20% with 0.5% resolution
@@ -221,6 +379,8 @@ void __ISR(_EXTERNAL_0_VECTOR, ipl4) _PCAPHandler(void) {
 
      penstatus = data[1] & 0x01;	//Pen down
      touchpoint = (data[1]&0x78)>>3;
+     if(touchpoint >= 5)
+        return;
 
     if(penstatus == 1)
     {
@@ -240,6 +400,9 @@ void __ISR(_EXTERNAL_0_VECTOR, ipl4) _PCAPHandler(void) {
       PCapY[touchpoint].Val = -1;
     }
 
+    if(touchpoint == 0)
+        TouchQueueState(penstatus == 1, (SHORT)PCapX[0].Val, (SHORT)PCapY[0].Val, time);
+
 #elif defined(USE_CAPACITIVE_CONTROLLER_FT5x06) // When Using the NHD with FT5x06 Touch Controller
 
 /********************************************************
@@ -304,8 +467,69 @@ typedef enum  	ft5x06_touchEvent { FT5X06_EVENT_putDown = 0, FT5X06_EVENT_putUp
         }
         penstatus = 99; //Resets so that the next one is evaluated correctly.
     }
+
+    TouchQueueState(PCapX[0].Val != 0xFFFF, (SHORT)PCapX[0].Val, (SHORT)PCapY[0].Val, time);
 #else
     #error No Capacitive Controller defined in HardwareProfile.h - Please use either #define USE_CAPACITIVE_CONTROLLER_MTCH6301 or #define USE_CAPACITIVE_CONTROLLER_FT5x06
 #endif
+}
+
+//****************************************************************************
+//Touch Int Handler
+//Triggered by the INT0 external interrupt pin. The report is not read here:
+//the time is taken and the PCAP_DEFER_VECTOR interrupt reads it
+void __ISR(_EXTERNAL_0_VECTOR, ipl4) _PCAPHandler(void) {
+    _pcapIntTime[_pcapInts & (TOUCH_INT_TIMES - 1)] = ReadCoreTimer();
+    _pcapInts++;
+    PCAP_DEFER_REQUEST();
         IFS0bits.INT0IF = 0; // clear the interrupt flag
 }
+
+#if (PCAP_DEFER_VECTOR != PCAP_DEFER_POLLED)
+//****************************************************************************
+//Touch report reader
+//PCAP_DEFER_VECTOR interrupt at priority 1: the I2C transfers only delay the
+//main loop, and GOL drawing does not hold the reports back
+void __ISR(PCAP_DEFER_VECTOR, ipl1) _PCAPReadHandler(void) {
+    PCAP_DEFER_CLEAR();
+    INTClearFlag(PCAP_DEFER_SOURCE);
+    TouchReadReports();
+}
+#endif
+
+/*********************************************************************
+* Function: void TouchReadReports(void)
+*
+* PreCondition: none
+*
+* Input: none
+*
+* Output: none
+*
+* Side Effects: none
+*
+* Overview: reads the reports signalled by INT0 since the last call and
+*           queues the changes of touch 0
+*
+* Note: called by the PCAP_DEFER_VECTOR interrupt only, unless
+*       PCAP_DEFER_POLLED: then by TouchGetSample() and by the task
+*       that polls the touch screen, which must not preempt each other
+*
+********************************************************************/
+void TouchReadReports(void)
+{
+    BYTE    pending;
+
+    while(_pcapReads != _pcapInts)
+    {
+        // Only the last TOUCH_INT_TIMES interrupts have their time, and
+        // the controller returns its last report anyway
+        pending = _pcapInts - _pcapReads;
+        if(pending > TOUCH_INT_TIMES)
+            _pcapReads += pending - TOUCH_INT_TIMES;
+
+        TouchReadReport(_pcapIntTime[_pcapReads & (TOUCH_INT_TIMES - 1)]);
+        _pcapReads++;
+        TouchQueueStats.Reports++;
+    }
+}
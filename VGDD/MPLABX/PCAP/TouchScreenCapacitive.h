@@ -31,6 +31,8 @@
  * Date        	Comment
  *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * 01/19/11		Ported from TouchScreen.h.
+ * 10/17/26		Queue of timestamped touch samples, TouchGetSample().
+ * 10/17/26		PCAP_DEFER_VECTOR, TouchReadReports().
  *****************************************************************************/
 
 /*****************************************************************************
@@ -50,6 +52,9 @@
 			   This driver assumes that the Graphics Library is initialized
 			   and will be using the default font of the library.
  *****************************************************************************/
+#ifndef _TOUCHSCREENCAPACITIVE_H
+#define _TOUCHSCREENCAPACITIVE_H
+
 #include "GenericTypeDefs.h"
 
 // Default calibration points
@@ -62,8 +67,49 @@
 #define TOUCHCAL_LRX 0x2A
 #define TOUCHCAL_LRY 0xE67E
 
+// Samples of touch 0 queued by the report reader, can be overridden in
+// HardwareProfile.h. The last TOUCH_QUEUE_RESERVE entries are kept for
+// presses and releases: moves are dropped first when the main loop stalls,
+// a press or release only once the reserve is full of them.
+#ifndef TOUCH_QUEUE_SIZE
+#define TOUCH_QUEUE_SIZE    32      // power of 2, up to 128
+#endif
+#ifndef TOUCH_QUEUE_RESERVE
+#define TOUCH_QUEUE_RESERVE 16
+#endif
+
+// Interrupt reading the reports signalled by INT0, at priority 1, can be
+// overridden in HardwareProfile.h: _CORE_SOFTWARE_0_VECTOR or
+// _CORE_SOFTWARE_1_VECTOR. RTOS ports switch context on core software
+// interrupt 0; with PCAP_DEFER_POLLED no interrupt is taken and the reports
+// are read by TouchReadReports(). TouchGetSample() and TouchGetMsg() call it,
+// but once per GOL frame the controller has overwritten the reports of a
+// short tap: call it as well from a task every report period (10 ms).
+#define PCAP_DEFER_POLLED   (-1)
+#ifndef PCAP_DEFER_VECTOR
+#define PCAP_DEFER_VECTOR   _CORE_SOFTWARE_0_VECTOR
+#endif
+
+typedef struct
+{
+    DWORD   time;       // core timer count (SYS_CLK / 2) at the INT0 interrupt
+    SHORT   x;
+    SHORT   y;
+    BYTE    event;      // EVENT_PRESS, EVENT_MOVE or EVENT_RELEASE
+} TOUCH_SAMPLE;
+
+typedef struct
+{
+    DWORD   Reports;    // reports read from the controller
+    DWORD   Queued;     // samples queued
+    DWORD   Coalesced;  // moves replaced by a later one in TouchGetMsg()
+    DWORD   Dropped;    // samples not queued, the queue being full
+    BYTE    MaxDepth;   // most samples in the queue
+} TOUCH_QUEUE_STATS;
+
 extern WORD_VAL PCapX[5];
 extern WORD_VAL PCapY[5];
+extern TOUCH_QUEUE_STATS TouchQueueStats;
 
 BYTE I2C_ReadBlock(BYTE deviceID, BYTE offset, BYTE *buffer, WORD length);
 BYTE I2C_WriteBlock(BYTE deviceID, BYTE offset, BYTE *buffer, WORD length);
@@ -71,8 +117,12 @@ void I2C_Init(void);
 
 SHORT TouchGetX(BYTE touchNumber);
 SHORT TouchGetY(BYTE touchNumber);
+BOOL  TouchGetSample(TOUCH_SAMPLE *pSample);
+void  TouchReadReports(void);
 void    TouchGetCalPoints(void);
 void 	TouchStoreCalibration(void);
 void 	TouchCheckForCalibration(void);
 void 	TouchLoadCalibration(void);
 void    TouchCalculateCalPoints(void);
+
+#endif
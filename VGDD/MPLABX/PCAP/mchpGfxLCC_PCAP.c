@@ -37,6 +37,7 @@
 #include "HardwareProfile.h"
 
 #if defined (GFX_USE_DISPLAY_CONTROLLER_DMA)
+#include <string.h>
 #include "Compiler.h"
 #include "TimeDelay.h"
 #include "Graphics/DisplayDriver.h"
@@ -894,59 +895,292 @@ short _GFXDestinationPage = 0;
 short _GFXForegroundPage = 2;
 
 /*********************************************************************
-* Function: void AlphaBlendWindow(DWORD foregroundArea, SHORT foregroundLeft, SHORT foregroundTop,
-                                  DWORD backgroundArea, SHORT backgroundLeft, SHORT backgroundTop,
-					    DWORD destinationArea, SHORT destinationLeft, SHORT destinationTop,
-					    WORD  width, WORD height,
-					    BYTE  alphaPercentage)
+* Window line engine
+*
+* AlphaBlendWindow() and CopyPageWindow() convert their windows once to
+* physical coordinates and move them one line at a time through
+* LineBuffer. With LCC_INTERNAL_MEMORY the lines are read and written
+* straight in GraphicsFrame (straight copies with a single memmove).
+* With external memory each line is moved in bursts of up to
+* LCC_BURST_LENGTH pixels with PMP address auto-increment, suspending the
+* display DMA once per burst instead of once per pixel.
 ********************************************************************/
-WORD AlphaBlendWindow(DWORD foregroundArea, SHORT foregroundLeft, SHORT foregroundTop,
-                      DWORD backgroundArea, SHORT backgroundLeft, SHORT backgroundTop,
-					  DWORD destinationArea, SHORT destinationLeft, SHORT destinationTop,
-					  WORD  width, WORD height,
-					  BYTE  alphaPercentage)
+#ifndef LCC_BURST_LENGTH
+#define LCC_BURST_LENGTH    16
+#endif
+
+static GFX_COLOR LineBuffer[2][LINE_LENGTH];
+
+#ifndef LCC_INTERNAL_MEMORY
+/*********************************************************************
+* Function: static void ExternalBurst(WORD page, DWORD address, GFX_COLOR *pBuffer,
+*                                     WORD count, BYTE write)
+*
+* Overview: Reads (write == 0) or writes count pixels of page from address
+*           on in the external SRAM. The pixels must not cross a
+*           PMADDR_OVERFLOW boundary.
+*
+********************************************************************/
+static void ExternalBurst(WORD page, DWORD address, GFX_COLOR *pBuffer, WORD count, BYTE write)
 {
+    DWORD prevaddr;
+
+    DrawCount++;
+
+    while(DrawCount>PIXEL_DRAW_PER_DMA_TX){}   //Same refresh budget as PutPixel, per burst
+
+    IEC0bits.INT0IE =   0;   // clear the interrupt flag
+
+    //Suspend DMA
+    DMACONbits.SUSPEND = 1;
+
+    while(PMMODEbits.BUSY == 1);
+
+    if(write)
+        PMCONCLR=0x8000;
+    else
+        PMCONCLR=0x8100;   //  PMCONbits.PTRDEN=0;
+    PMMODESET = 0x0C00;    // PMMODEbits.MODE16 = 1, PMMODEbits.INCM = 1
+    PMCONSET=0x8000;
+
+    ADDR16 = address>>16;
+    #ifdef GFX_USE_DISPLAY_PANEL_TFT_640480_8_E
+    ADDR17 = address>>17;
+    ADDR18 = address>>18;
+    #else
+    ADDR17 = page;
+    ADDR18 = page>>1;
+    #endif
+
+    //Save previous address value
+    prevaddr = PMADDR;
+    PMADDR = address;
 
-WORD x,y;
-WORD bcolor;
-WORD currentPage = _GFXActivePage;
+    if(write)
+    {
+        while(count--)
+        {
+            PMDIN = *pBuffer++;
+            while(PMMODEbits.BUSY == 1);
+        }
+    }
+    else
+    {
+        //The first read only starts the read cycle of the first pixel
+        *pBuffer = PMDIN;
+        while(PMMODEbits.BUSY == 1);
+        while(count--)
+        {
+            *pBuffer++ = PMDIN;
+            while(PMMODEbits.BUSY == 1);
+        }
+        PMCONSET = 0x100; //PMCONbits.PTRDEN=1;
+    }
 
-for(y=0;y<height;y++)
+    //Clean-up Address Lines
+    ADDR16 = overflowcount.Val;
+    #ifdef GFX_USE_DISPLAY_PANEL_TFT_640480_8_E
+    ADDR17 = overflowcount.bits.b2;
+    ADDR18 = overflowcount.bits.b3;
+    #else
+#ifdef USE_PIP
+    if(PipActive == 1)
+    {
+      ADDR17=_GFXPIPPage;
+      ADDR18=_GFXPIPPage>>1;
+    }
+   else
+#endif
+    {
+    ADDR17 = VisualPage;
+    ADDR18 = VisualPage>>1;
+    }
+    #endif
+
+    PMADDR = prevaddr;
+    PMMODECLR = 0x0C00;
+
+    //Restart DMA
+    DMACONbits.SUSPEND = 0;
+
+    IEC0bits.INT0IE = 1;   // clear the interrupt flag
+}
+#endif
+
+/*********************************************************************
+* Function: static void MoveLine(WORD page, WORD x, WORD y, GFX_COLOR *pBuffer,
+*                                WORD width, BYTE write)
+*
+* Overview: Reads (write == 0) or writes width pixels of the physical
+*           line y of page, from x on.
+*
+********************************************************************/
+static void MoveLine(WORD page, WORD x, WORD y, GFX_COLOR *pBuffer, WORD width, BYTE write)
 {
-    for(x=0;x<width;x++)
+#ifdef LCC_INTERNAL_MEMORY
+    BYTE *pFrame = &GraphicsFrame[y][x];
+
+    if(write)
+        while(width--) *pFrame++ = *pBuffer++;
+    else
+        while(width--) *pBuffer++ = *pFrame++;
+#else
+    DWORD address = (DWORD)y*DISP_HOR_RESOLUTION+x;
+    WORD count;
+
+    while(width)
     {
+        count = (width > LCC_BURST_LENGTH)? LCC_BURST_LENGTH: width;
+        if((address % PMADDR_OVERFLOW) + count > PMADDR_OVERFLOW)
+            count = PMADDR_OVERFLOW - (address % PMADDR_OVERFLOW);
+        ExternalBurst(page, address, pBuffer, count, write);
+        address += count;
+        pBuffer += count;
+        width -= count;
+    }
+#endif
+}
 
-        SetActivePage(foregroundArea);
-        _color = GetPixel(foregroundLeft++,foregroundTop);
-       if(alphaPercentage != 100)
-       {
-        SetActivePage(backgroundArea);
-        bcolor = GetPixel(backgroundLeft++,backgroundTop);
+/*********************************************************************
+* Function: static void BlendLine(GFX_COLOR *pFore, GFX_COLOR *pBack, WORD width,
+*                                 BYTE alphaPercentage)
+*
+* Overview: Blends width pixels of pBack into pFore, other percentages than
+*           25, 50 and 75 leave pFore unchanged.
+*           The pointers are advanced outside the ConvertColor macros,
+*           which evaluate their argument more than once.
+*
+********************************************************************/
+static void BlendLine(GFX_COLOR *pFore, GFX_COLOR *pBack, WORD width, BYTE alphaPercentage)
+{
+    switch(alphaPercentage)
+    {
+    case 50:
+        for(;width;width--,pFore++,pBack++) *pFore = ConvertColor50(*pFore)+ ConvertColor50(*pBack);
+        break;
+    case 75:
+        for(;width;width--,pFore++,pBack++) *pFore = ConvertColor75(*pFore)+ ConvertColor25(*pBack);
+        break;
+    case 25:
+        for(;width;width--,pFore++,pBack++) *pFore = ConvertColor25(*pFore)+ ConvertColor75(*pBack);
+        break;
+    default: break;
+    }
+}
 
+/*********************************************************************
+* Function: static void BlendPhysicalWindow(WORD fgPage, WORD fgX, WORD fgY,
+*                                           WORD bgPage, WORD bgX, WORD bgY,
+*                                           WORD dstPage, WORD dstX, WORD dstY,
+*                                           WORD width, WORD height,
+*                                           BYTE alphaPercentage)
+*
+* Overview: Line by line AlphaBlendWindow() on physical coordinates.
+*           The lines are processed bottom up when the destination is below
+*           the foreground, so overlapping windows in the same page are
+*           copied correctly.
+*
+********************************************************************/
+static void BlendPhysicalWindow(WORD fgPage, WORD fgX, WORD fgY,
+                                WORD bgPage, WORD bgX, WORD bgY,
+                                WORD dstPage, WORD dstX, WORD dstY,
+                                WORD width, WORD height,
+                                BYTE alphaPercentage)
+{
+    SHORT step = 1;
 
-        switch(alphaPercentage)
+    if(width == 0 || height == 0)
+        return;
+
+    if(dstY > fgY)
+    {
+        fgY  += height-1;
+        bgY  += height-1;
+        dstY += height-1;
+        step = -1;
+    }
+
+    for(;height;height--,fgY+=step,bgY+=step,dstY+=step)
+    {
+        #ifdef LCC_INTERNAL_MEMORY
+        if(alphaPercentage == 100)
         {
-        case 50: _color = ConvertColor50(_color)+ ConvertColor50(bcolor);break;
-        case 75: _color = ConvertColor75(_color)+ ConvertColor25(bcolor);break;
-        case 25: _color = ConvertColor25(_color)+ ConvertColor75(bcolor);break;
-        default: break;
+            memmove(&GraphicsFrame[dstY][dstX], &GraphicsFrame[fgY][fgX], width);
+            continue;
         }
+        #endif
+        MoveLine(fgPage, fgX, fgY, LineBuffer[0], width, 0);
+        if(alphaPercentage != 100)
+        {
+            MoveLine(bgPage, bgX, bgY, LineBuffer[1], width, 0);
+            BlendLine(LineBuffer[0], LineBuffer[1], width, alphaPercentage);
         }
-        SetActivePage(destinationArea);
-        PutPixel(destinationLeft++,destinationTop);
-     }
+        MoveLine(dstPage, dstX, dstY, LineBuffer[0], width, 1);
+    }
+}
 
-    foregroundLeft -= width;
-    backgroundLeft -= width;
-    destinationLeft -= width;
+/*********************************************************************
+* Function: static BYTE PhysicalWindow(SHORT *pLeft, SHORT *pTop, WORD width, WORD height)
+*
+* Overview: Converts the top left corner of a width x height window from
+*           screen to physical coordinates (same rotation as PutPixel).
+*
+* Output: 0 if the window does not fit the screen
+*
+********************************************************************/
+static BYTE PhysicalWindow(SHORT *pLeft, SHORT *pTop, WORD width, WORD height)
+{
+    SHORT left = *pLeft, top = *pTop;
+
+    if(left < 0 || top < 0 || left + width > GetMaxX()+1 || top + height > GetMaxY()+1)
+        return 0;
 
-    foregroundTop++;
-    backgroundTop++;
-    destinationTop++;
+    #if (DISP_ORIENTATION == 270)
+    *pLeft = DISP_HOR_RESOLUTION - top - height;
+    *pTop  = left;
+    #elif (DISP_ORIENTATION == 90)
+    *pLeft = top;
+    *pTop  = DISP_VER_RESOLUTION - left - width;
+    #elif (DISP_ORIENTATION == 180)
+    *pLeft = DISP_HOR_RESOLUTION - left - width;
+    *pTop  = DISP_VER_RESOLUTION - top - height;
+    #endif
+    return 1;
 }
 
-SetActivePage(currentPage);
-return (1);
+/*********************************************************************
+* Function: void AlphaBlendWindow(DWORD foregroundArea, SHORT foregroundLeft, SHORT foregroundTop,
+                                  DWORD backgroundArea, SHORT backgroundLeft, SHORT backgroundTop,
+					    DWORD destinationArea, SHORT destinationLeft, SHORT destinationTop,
+					    WORD  width, WORD height,
+					    BYTE  alphaPercentage)
+*
+* Overview: Windows that do not fit the screen are not drawn, the clipping
+*           region is not applied.
+********************************************************************/
+WORD AlphaBlendWindow(DWORD foregroundArea, SHORT foregroundLeft, SHORT foregroundTop,
+                      DWORD backgroundArea, SHORT backgroundLeft, SHORT backgroundTop,
+					  DWORD destinationArea, SHORT destinationLeft, SHORT destinationTop,
+					  WORD  width, WORD height,
+					  BYTE  alphaPercentage)
+{
+    if(!PhysicalWindow(&foregroundLeft, &foregroundTop, width, height) ||
+       !PhysicalWindow(&backgroundLeft, &backgroundTop, width, height) ||
+       !PhysicalWindow(&destinationLeft, &destinationTop, width, height))
+        return (1);
+
+    #if (DISP_ORIENTATION == 90) || (DISP_ORIENTATION == 270)
+    BlendPhysicalWindow(foregroundArea, foregroundLeft, foregroundTop,
+                        backgroundArea, backgroundLeft, backgroundTop,
+                        destinationArea, destinationLeft, destinationTop,
+                        height, width, alphaPercentage);
+    #else
+    BlendPhysicalWindow(foregroundArea, foregroundLeft, foregroundTop,
+                        backgroundArea, backgroundLeft, backgroundTop,
+                        destinationArea, destinationLeft, destinationTop,
+                        width, height, alphaPercentage);
+    #endif
+    return (1);
 }
 
 /*********************************************************************
@@ -1174,14 +1408,15 @@ void UpdateDisplayNow(void)
     {
         blInvalidateAll = 0;
         NoOfInvalidatedRectangleAreas = 0;
-        CopyPageWindow( SourceBuffer, DestBuffer, 0, 0,0, 0,GetMaxX()+1, GetMaxY()+1);
+        BlendPhysicalWindow( SourceBuffer, 0, 0, SourceBuffer, 0, 0, DestBuffer, 0, 0, DISP_HOR_RESOLUTION, DISP_VER_RESOLUTION, 100);
     }
     else if(NoOfInvalidatedRectangleAreas)
     {
         while(NoOfInvalidatedRectangleAreas)
         {
             NoOfInvalidatedRectangleAreas--;
-            CopyPageWindow( SourceBuffer, DestBuffer, InvalidatedArea[NoOfInvalidatedRectangleAreas].X, InvalidatedArea[NoOfInvalidatedRectangleAreas].Y,InvalidatedArea[NoOfInvalidatedRectangleAreas].X, InvalidatedArea[NoOfInvalidatedRectangleAreas].Y,InvalidatedArea[NoOfInvalidatedRectangleAreas].W, InvalidatedArea[NoOfInvalidatedRectangleAreas].H);
+            // InvalidateRectangle() stores physical coordinates
+            BlendPhysicalWindow( SourceBuffer, InvalidatedArea[NoOfInvalidatedRectangleAreas].X, InvalidatedArea[NoOfInvalidatedRectangleAreas].Y, SourceBuffer, InvalidatedArea[NoOfInvalidatedRectangleAreas].X, InvalidatedArea[NoOfInvalidatedRectangleAreas].Y, DestBuffer, InvalidatedArea[NoOfInvalidatedRectangleAreas].X, InvalidatedArea[NoOfInvalidatedRectangleAreas].Y, InvalidatedArea[NoOfInvalidatedRectangleAreas].W, InvalidatedArea[NoOfInvalidatedRectangleAreas].H, 100);
         }
     }
 
@@ -13,6 +13,13 @@
  * #include "PutImageFromSD.h"
  * #endif
  *
+ * Optional defines (see below for the defaults):
+ *  SD_IMG_CACHE_ENTRIES - number of images kept open
+ *  SD_IMG_READAHEAD     - read-ahead buffer of each open image, in bytes
+ *  SD_IMG_LINKMAP_SIZE  - FatFs cluster link map of each open image, in DWORDs
+ *                         (used only if _USE_FASTSEEK is set to 1 in ffconf.h,
+ *                         it is 0 by default)
+ *
  *****************************************************************************
  * FileName:        PutImageFromSD.c
  * Dependencies:    Graphics.h HardwareProfile.h FSIO.h
@@ -45,13 +52,114 @@
  *                      2012/04/23      Version 1.1 Release - not failing if media not mounted
  *                      2012/10/17      Version 1.2 Release - Working flawlessly with latest MAL
  *                      2012/05/17      Version 1.3 Release - Integrated with FileSystem.c to support FSIO/FatFs/USB
+ *                      2026/10/17      Version 1.4 Release - Open image cache, sector aligned read-ahead, FatFs fast seek
+ *                      2026/10/17      Version 1.4.1 - One cached image by default, cache closed when no file can be opened
  *****************************************************************************/
 
+#include <string.h>
 #include "FileSystem.h"
 #include "PutImageFromSD.h"
 
-FILE_HANDLE SDImgFileHandler = NULL;
-IMAGE_ON_SD *SDImgCurrent = NULL;
+// Images kept open at the same time. Each one takes a file slot (FS_MAX_FILES_OPEN)
+// and SD_IMG_READAHEAD bytes of RAM
+#ifndef SD_IMG_CACHE_ENTRIES
+#define SD_IMG_CACHE_ENTRIES    1
+#endif
+
+// Read-ahead buffer of each open image, in bytes: a multiple of MEDIA_SECTOR_SIZE
+#ifndef SD_IMG_READAHEAD
+#define SD_IMG_READAHEAD        (2 * MEDIA_SECTOR_SIZE)
+#endif
+
+// Cluster link map of each open image, in DWORDs: (fragments + 1) * 2 are needed
+#ifndef SD_IMG_LINKMAP_SIZE
+#define SD_IMG_LINKMAP_SIZE     32
+#endif
+
+#if defined(FILESYSTEM_USE_FATFS) && _USE_FASTSEEK
+#define SD_IMG_FASTSEEK
+#endif
+
+typedef struct {
+    IMAGE_ON_SD *img; // Image read through this entry, NULL if free
+    FILE_HANDLE fh; // Image file
+    WORD LastUse; // Value of SDImgUseCount when last read, to replace the least recently used entry
+    DWORD BufStart; // Offset in the file of Buf[0]
+    WORD BufLen; // Valid bytes in Buf, 0 if empty
+    BYTE Buf[SD_IMG_READAHEAD];
+#if defined(SD_IMG_FASTSEEK)
+    DWORD LinkMap[SD_IMG_LINKMAP_SIZE];
+#endif
+} SD_IMG_ENTRY;
+
+static SD_IMG_ENTRY SDImgCache[SD_IMG_CACHE_ENTRIES];
+static WORD SDImgUseCount = 0;
+
+/*********************************************************************
+ * Function: static void SDImgCacheFlush(void)
+ *
+ * Overview: Closes all the cached images, e.g. when the media has been removed
+ *
+ ********************************************************************/
+static void SDImgCacheFlush(void) {
+    BYTE i;
+
+    for (i = 0; i < SD_IMG_CACHE_ENTRIES; i++) {
+        if (SDImgCache[i].img != NULL) {
+            FileClose(SDImgCache[i].fh);
+            SDImgCache[i].img = NULL;
+        }
+    }
+}
+
+/*********************************************************************
+ * Function: static SD_IMG_ENTRY *SDImgCacheOpen(IMAGE_ON_SD *img)
+ *
+ * Output: cache entry for img, NULL if the file cannot be opened
+ *
+ * Overview: Returns the entry of img if it is already open, otherwise
+ *           opens the file in place of the least recently used entry.
+ *           If no file slot is left, the other cached images are closed
+ *           and the file is opened again.
+ *           With FatFs fast seek, the cluster chain of the file is walked
+ *           once here and later seeks do not follow the FAT anymore.
+ *
+ ********************************************************************/
+static SD_IMG_ENTRY *SDImgCacheOpen(IMAGE_ON_SD *img) {
+    SD_IMG_ENTRY *pEntry = &SDImgCache[0];
+    BYTE i;
+
+    for (i = 0; i < SD_IMG_CACHE_ENTRIES; i++) {
+        if (SDImgCache[i].img == img)
+            return &SDImgCache[i];
+        if (pEntry->img != NULL && (SDImgCache[i].img == NULL || (WORD) (SDImgUseCount - SDImgCache[i].LastUse) > (WORD) (SDImgUseCount - pEntry->LastUse)))
+            pEntry = &SDImgCache[i];
+    }
+    if (pEntry->img != NULL) {
+        FileClose(pEntry->fh);
+        pEntry->img = NULL;
+    }
+    if (FileChDir(SD_IMAGEDIR) != 0)
+        return NULL;
+    // Open image file on SD
+    pEntry->fh = FileOpen(img->filename, "r");
+    if (pEntry->fh == NULL) {
+        // The slots may be held by the cache: give them back and retry
+        SDImgCacheFlush();
+        pEntry->fh = FileOpen(img->filename, "r");
+        if (pEntry->fh == NULL)
+            return NULL;
+    }
+#if defined(SD_IMG_FASTSEEK)
+    pEntry->LinkMap[0] = SD_IMG_LINKMAP_SIZE;
+    pEntry->fh->cltbl = pEntry->LinkMap;
+    if (f_lseek(pEntry->fh, CREATE_LINKMAP) != FR_OK)
+        pEntry->fh->cltbl = NULL; // Too fragmented for the map: normal seek
+#endif
+    pEntry->img = img;
+    pEntry->BufLen = 0;
+    return pEntry;
+}
 
 /*********************************************************************
  * Function: WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer)
@@ -64,43 +172,65 @@ IMAGE_ON_SD *SDImgCurrent = NULL;
  *        buffer - Pointer to the buffer
  *
  * Output: number of bytes read
- *         If error: returns 0xffff
+ *         If error: returns 0
  *
  * Side Effects: none
  *
  * Overview: Reads image from SD and outputs image starting from left,top coordinates
  *
- * Note: image must be located on SD card
+ * Note: image must be located on SD card.
+ *       The last SD_IMG_CACHE_ENTRIES images used are kept open. Small
+ *       requests, such as the lines of PutImage, are served from a sector
+ *       aligned read-ahead buffer; larger ones are read straight into the
+ *       caller's buffer, which FatFs does with multiple sector reads.
  *
  ********************************************************************/
 WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer) {
-    IMAGE_ON_SD *img;
-    char *ImageName;
+    SD_IMG_ENTRY *pEntry;
+    BYTE *pDest = (BYTE *) buffer;
+    WORD n, left = nCount;
+    DWORD start;
 
     if (FileMediaDetect()==0) {
+        SDImgCacheFlush();
         return 0;
     }
 
-    img = (IMAGE_ON_SD *) memory;
-    if (SDImgCurrent != img) {
-        SDImgCurrent = img;
-        if (SDImgFileHandler != NULL) {
-            FileClose(SDImgFileHandler);
-        }
-        ImageName = img->filename;
-        if (FileChDir(SD_IMAGEDIR) != 0) {
-            return 0;
-        }
-        // Open image file on SD
-        SDImgFileHandler = FileOpen(ImageName, "r");
-        if (SDImgFileHandler == NULL)
-            return 0;
-    }
-    if (FileSeek(SDImgFileHandler, offset, SEEK_SET) != 0) // Seek from start of file
+    pEntry = SDImgCacheOpen((IMAGE_ON_SD *) memory);
+    if (pEntry == NULL)
         return 0;
+    pEntry->LastUse = ++SDImgUseCount;
 
-    if (FileRead(buffer, 1, nCount, SDImgFileHandler) != nCount)
-        return 0;
+    while (left) {
+        if ((DWORD) offset >= pEntry->BufStart && (DWORD) offset < pEntry->BufStart + pEntry->BufLen) {
+            // Served from the read-ahead buffer
+            n = pEntry->BufStart + pEntry->BufLen - offset;
+            if (n > left)
+                n = left;
+            memcpy(pDest, &pEntry->Buf[offset - pEntry->BufStart], n);
+        } else if (left >= SD_IMG_READAHEAD) {
+            // Too large to be buffered: read directly
+            if (FileSeek(pEntry->fh, offset, SEEK_SET) != 0)
+                return 0;
+            if (FileRead(pDest, 1, left, pEntry->fh) != left)
+                return 0;
+            n = left;
+        } else {
+            // Refill the buffer from the sector holding offset
+            start = offset & ~(DWORD) (MEDIA_SECTOR_SIZE - 1);
+            pEntry->BufLen = 0;
+            if (FileSeek(pEntry->fh, start, SEEK_SET) != 0)
+                return 0;
+            pEntry->BufLen = FileRead(pEntry->Buf, 1, SD_IMG_READAHEAD, pEntry->fh);
+            pEntry->BufStart = start;
+            if (offset >= start + pEntry->BufLen)
+                return 0; // Past the end of the file
+            continue;
+        }
+        pDest += n;
+        offset += n;
+        left -= n;
+    }
 
     return (nCount);
 }
@@ -48,6 +48,7 @@
  * Aseem Swalah         7/31/08         Original
  * Amit Shirbhate       7/18/09         Modified
  * VirtualFab           5/19/2013       Modified for FatFs support + added various missing functions
+ * VirtualFab           10/17/2026      FatFs byte counts read into UINT
  ********************************************************************/
 #include "FileSystem.h"
 BOOL FileSysInitLock=FALSE;
@@ -243,12 +244,12 @@ int FileClose(FILE_HANDLE fh) {
 
 size_t FileRead(void *ptr, size_t size, size_t n, FILE_HANDLE stream) {
 #if defined(FILESYSTEM_USE_FATFS)
-    size_t BytesRead;
+    UINT BytesRead;
     FRESULT result;
     if (stream == NULL) {
         return 0;
     } else {
-        result = f_read(stream, ptr, (UINT) (n * size), (UINT *) & BytesRead);
+        result = f_read(stream, ptr, (UINT) (n * size), & BytesRead);
         if (result == FR_OK) {
             return BytesRead;
         } else {
@@ -376,12 +377,12 @@ size_t FileReadUInt32(DWORD *ptr, FILE_HANDLE stream) {
     *ptr = 0x00000000;
 
 #if defined(FILESYSTEM_USE_FATFS)
-    size_t BytesRead;
+    UINT BytesRead;
     FRESULT result;
     if (stream == NULL) {
         return 0;
     } else {
-        result = f_read(stream, databuff, (UINT) 4, (UINT *) & BytesRead);
+        result = f_read(stream, databuff, (UINT) 4, & BytesRead);
         if (result == FR_OK) {
             ((BYTE*) ptr)[3] = databuff[3];
             ((BYTE*) ptr)[2] = databuff[2];
@@ -434,12 +435,12 @@ size_t FileReadUInt16(WORD *ptr, FILE_HANDLE stream) {
     *ptr = 0x0000;
 
 #if defined(FILESYSTEM_USE_FATFS)
-    size_t BytesRead;
+    UINT BytesRead;
     FRESULT result;
     if (stream == NULL) {
         return 0;
     } else {
-        result = f_read(stream, databuff, (UINT) 2, (UINT *) & BytesRead);
+        result = f_read(stream, databuff, (UINT) 2, & BytesRead);
         if (result == FR_OK) {
             ((BYTE*) ptr)[1] = databuff[1];
             ((BYTE*) ptr)[0] = databuff[0];
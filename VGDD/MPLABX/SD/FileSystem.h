@@ -48,6 +48,7 @@
  * Aseem Swalah         7/31/08         Original
  * Amit Shirbhate       7/18/09         Modified
  * VirtualFab           5/19/2013       Modified for FatFs support + added various missing functions
+ * VirtualFab           10/17/2026      FileGetFileSize and FileDirExists prototypes
  ********************************************************************/
 #ifndef _FILE_SYSTEM_HEADER_FILE
 #define _FILE_SYSTEM_HEADER_FILE
@@ -124,5 +125,11 @@ BYTE FileMediaDetect(void);
 
 void FileCheckMedia(void);
 
+#if defined(FILESYSTEM_USE_MDD) || defined(FILESYSTEM_USE_FATFS)
+DWORD FileGetFileSize(FILE_HANDLE fh);
+
+int FileDirExists(char *path);
+#endif
+
 #endif
 
@@ -51,6 +51,8 @@
  *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * Elliott Wood     	6/18/07	   Original
  * VirtualFab           5/19/2013  Modified for VGDD Demo + added HTTPPostUpload (HTTP 1.1 file upload support)
+ * VirtualFab           10/17/2026 HTTPPostUpload parses the multipart data as it arrives (Horspool
+ *                                 delimiter search), writes whole sectors, reports errors as HTTP statuses
  ********************************************************************/
 #define __CUSTOMHTTPAPP_C
 
@@ -1026,7 +1028,6 @@ void HttpConnResetSm(void){
     curHTTP.CurWorkDirChangedToMddRootPath=FALSE;
     curHTTP.directoryPtr=NULL;
     curHTTP.smHTTPSendFile=SM_IDLE;
-    curHTTP.lock=0;
     curHTTP.nameHashMatched=0;
     curHTTP.numBytes=0;
     curHTTP.dynVarCntr=0;
@@ -1038,24 +1039,37 @@ void HttpConnResetSm(void){
 
 /*****************************************************************************
   Function:
-    static HTTP_IO_RESULT HTTPPostUpload(void)
+    HTTP_IO_RESULT HTTPPostUpload(void)
 
   Summary:
     Processes the file upload form on upload.htm
 
   Description:
-    This function demonstrates the processing of file uploads:
-    the file is read 64 bytes at a time and stored on SD card
+    This function demonstrates the processing of file uploads.
 
     It handles HTTP 1.1 multipart/form-data uploads in which POSTed data is separated
     by boundary tags. Boundaries are detected and file data is parsed and stored
     on configured media via FileXXXX functions (see FileSystem.c)
 
+    The POSTed data is parsed as it arrives:
+    - part headers are read one line at a time
+    - field values and file data are peeked from the socket into uploadBuffer
+      and scanned for the delimiter (CRLF--boundary) with a Horspool skip
+      table, computed once per upload. Only the bytes that cannot be the start
+      of a delimiter are removed from the socket, so a delimiter split between
+      two TCP segments is found on the next call
+    - file data is written in whole sectors (HTTP_UPLOAD_SECTOR_LEN) at sector
+      aligned file offsets, that FatFs writes straight to the card; only the
+      last partial sector goes through the FatFs sector buffer
+
+    Malformed POSTed data is answered with 400 Bad Request, media errors
+    with 500 (the upload error page for HTTP_FAT_UPLOAD).
+
   Precondition:
     In the POSTed data the following fields are expected:
     upddir - The upload folder where the file will be stored. It can be OUT
              of the MDD_ROOT_DIR_PATH (WebPages) path. You can upload even in the root
-             folder of the mounted media.
+             folder of the mounted media. If missing, the root folder is used.
 
   Parameters:
     None
@@ -1064,93 +1078,158 @@ void HttpConnResetSm(void){
     HTTP_IO_DONE - all parameters have been processed
     HTTP_IO_WAITING - the function is pausing to continue later
     HTTP_IO_NEED_DATA - data needed by this function has not yet arrived
+
+  Remarks:
+    The parser state is static: one upload at a time.
  ***************************************************************************/
 #if defined(STACK_USE_MDD) && (defined(STACK_USE_HTTP_UPLOADS) || defined(HTTP_FAT_UPLOAD))
 
+#define HTTP_UPLOAD_SECTOR_LEN  (512u)                              // Media sector size
+#define HTTP_UPLOAD_DELIM_MAX   (sizeof (curHTTP.Boundary) + 4u)    // CRLF + "--" + boundary
+
+static BYTE uploadBuffer[HTTP_UPLOAD_SECTOR_LEN + HTTP_UPLOAD_DELIM_MAX]; // File sector being filled or part header line
+static WORD uploadUsed;                         // Bytes of file data or field value in uploadBuffer
+static BYTE uploadDelim[HTTP_UPLOAD_DELIM_MAX]; // Delimiter ending every field value
+static BYTE uploadDelimLen;
+static BYTE uploadSkip[256];                    // Horspool shift for each byte value
+static BOOL uploadInPart;                       // Between a boundary line and the end of its part headers
+static BOOL uploadIsFile;                       // Current part has a filename
+
+// Builds the delimiter from curHTTP.Boundary and the Horspool shift of each
+// byte value: the distance from its last occurrence in the delimiter (last
+// byte excluded) to the end of the delimiter
+static void HTTPUploadInitScan(void) {
+    WORD i;
+
+    uploadDelim[0] = '\r';
+    uploadDelim[1] = '\n';
+    uploadDelim[2] = '-';
+    uploadDelim[3] = '-';
+    memcpy(&uploadDelim[4], curHTTP.Boundary, curHTTP.BoundaryLen);
+    uploadDelimLen = curHTTP.BoundaryLen + 4u;
+    for (i = 0; i < sizeof (uploadSkip); i++)
+        uploadSkip[i] = uploadDelimLen;
+    for (i = 0; i < uploadDelimLen - 1u; i++)
+        uploadSkip[uploadDelim[i]] = uploadDelimLen - 1u - i;
+}
+
+// Returns the offset of the first delimiter in data (*pFound TRUE), or else
+// how many bytes cannot be the start of a delimiter (*pFound FALSE): the
+// bytes after them may start a delimiter completed by the next TCP segment
+static WORD HTTPUploadScan(BYTE *data, WORD len, BOOL *pFound) {
+    WORD pos = 0;
+    BYTE i, last = uploadDelimLen - 1u;
+
+    while (pos + uploadDelimLen <= len) {
+        for (i = last; data[pos + i] == uploadDelim[i]; i--) {
+            if (i == 0u) {
+                *pFound = TRUE;
+                return pos;
+            }
+        }
+        pos += uploadSkip[data[pos + last]];
+    }
+    *pFound = FALSE;
+    return pos;
+}
+
 HTTP_IO_RESULT HTTPPostUpload(void) {
-    UINT16 lenA, lenB, lenC;
+    WORD lenA, lenB;
+    BOOL found;
+    char *pValue, *pEnd;
     static char strFieldName[32];
     static char strUploadedFileName[32];
     static char strUploadFolder[32];
     static char strUploadPathName[64];
-    char strBigBuffer[256];
 
-    #define SM_UPD_PARSE_FIELDNAME	(0u)
-    #define SM_UPD_PARSE_FIELDVALUE	(1u)
-    #define SM_UPD_OPEN_FILE		(2u)
-    #define SM_UPD_READ_DATA		(3u)
+    #define SM_UPD_START            (0u)    // smPost is reset to 0 for every request
+    #define SM_UPD_PARSE_HEADERS    (1u)
+    #define SM_UPD_PARSE_FIELDVALUE (2u)
+    #define SM_UPD_OPEN_FILE        (3u)
+    #define SM_UPD_READ_DATA        (4u)
+    #define SM_UPD_DONE             (5u)
 
     while(curHTTP.byteCount>0) {
         // Read all browser POST data
         switch (curHTTP.smPost) {
-            case SM_UPD_PARSE_FIELDNAME:
+            case SM_UPD_START:
+                if (curHTTP.BoundaryLen == 0u) { // Not a multipart/form-data POST
+                    goto UploadBadRequest;
+                }
+                HTTPUploadInitScan();
                 curHTTP.pFhStoredFile=NULL;
-                // See if a CRLF is in the buffer
-                lenA = TCPFindROMArray(sktHTTP, "\r\n", 2, 0, FALSE);
+                strcpy(strUploadFolder, "/");
+                uploadInPart = FALSE;
+                curHTTP.smPost = SM_UPD_PARSE_HEADERS;
+                // No break
+
+            case SM_UPD_PARSE_HEADERS:
+                // Read a whole line of the part headers
+                lenA = TCPFindROMArray(sktHTTP, (ROM BYTE*) "\r\n", 2, 0, FALSE);
                 if (lenA == 0xffff) { //if not, ask for more data
+                    lenB = TCPIsGetReady(sktHTTP);
+                    if (lenB >= curHTTP.byteCount || lenB >= sizeof (uploadBuffer)) { // No more data or line too long
+                        goto UploadBadRequest;
+                    }
                     return HTTP_IO_NEED_DATA;
                 }
-                // See if a field name is in the buffer
-                lenB = TCPFindROMArray(sktHTTP, " name=", 2, 0, FALSE);
-                if (lenB == 0xffff) { //if not, discard all data up to and including
-                    lenA = TCPGetArray(sktHTTP, NULL, lenA + 4);
-                    curHTTP.byteCount -= lenA;
+                if (lenA >= sizeof (uploadBuffer) || lenA + 2u > curHTTP.byteCount) {
+                    goto UploadBadRequest;
+                }
+                curHTTP.byteCount -= TCPGetArray(sktHTTP, uploadBuffer, lenA + 2);
+                uploadBuffer[lenA] = 0; // replace CR with NULL to terminate string
+
+                if (lenA >= curHTTP.BoundaryLen + 2u && uploadBuffer[0] == '-' && uploadBuffer[1] == '-'
+                        && memcmp(&uploadBuffer[2], curHTTP.Boundary, curHTTP.BoundaryLen) == 0) {
+                    // Boundary line: a final "--" closes the last part, else a new part starts
+                    if (uploadBuffer[curHTTP.BoundaryLen + 2] == '-' && uploadBuffer[curHTTP.BoundaryLen + 3] == '-') {
+                        curHTTP.smPost = SM_UPD_DONE;
+                        break;
+                    }
+                    uploadInPart = TRUE;
+                    uploadIsFile = FALSE;
+                    strFieldName[0] = 0;
                     break;
                 }
-                // Found name tag, find closing quote
-                lenC = TCPFindROMArray(sktHTTP, "\"", 1, lenB+1, FALSE);
-                if (lenC == 0xffff) { //if not, error
-                    while(1);
+                if (!uploadInPart) { // Preamble before the first boundary
+                    break;
                 }
-                lenC-=lenB; // Found it, compute field name length
-                lenA = TCPGetArray(sktHTTP, NULL, lenB + 7); //  discard up to field name+starting quote
-                curHTTP.byteCount -= lenA;
-
-                // Get field name
-                lenA = TCPGetArray(sktHTTP, strFieldName, lenC);
-                strFieldName[lenC]=0; // NULL-terminate string
-                curHTTP.byteCount -= lenA;
-
-                // Locate end of field data (double CRLF, it's a multipart/form-data)
-                lenA = TCPFindROMArray(sktHTTP, "\r\n\r\n", 4, 0, FALSE);
-                // See if a filename is in the buffer, on current row
-                lenB = TCPFindROMArray(sktHTTP, "filename=", 9, 0, FALSE);
-                if ((lenB != 0xffff) && (lenB<lenA)) { // Found it, so discard data up to field name
-                    lenB = TCPGetArray(sktHTTP, NULL, lenB + 10);
-                    curHTTP.byteCount -= lenB;
-                    lenA-=lenB;
-                    lenB = TCPFindROMArray(sktHTTP, "\"", 1, 0, FALSE); // Find closing quote
-                    TCPGetArray(sktHTTP, strUploadedFileName, lenB);
-                    curHTTP.byteCount -= lenB;
-                    strUploadedFileName[lenB]=0; // replace closing quote with NULL to terminate string
-                    lenA-=lenB;
-                    lenA = TCPGetArray(sktHTTP, NULL, lenA + 4); //  discard rest of field headers up to its value
-                    curHTTP.byteCount -= lenA;
-                    curHTTP.smPost = SM_UPD_OPEN_FILE; // Move to next state
+                if (lenA == 0u) { // Empty line: end of the part headers, the value follows
+                    uploadInPart = FALSE;
+                    uploadUsed = 0;
+                    curHTTP.smPost = uploadIsFile ? SM_UPD_OPEN_FILE : SM_UPD_PARSE_FIELDVALUE;
                     break;
                 }
-                lenA = TCPGetArray(sktHTTP, NULL, lenA + 4); //  discard rest of field headers up to its value
-                curHTTP.byteCount -= lenA;
-
-                curHTTP.smPost=SM_UPD_PARSE_FIELDVALUE;
-                // No break if we found the field name
-
-            case SM_UPD_PARSE_FIELDVALUE:
-                // See if a CRLF is in the buffer
-                lenA = TCPFindROMArray(sktHTTP, "\r\n", 2, 0, FALSE);
-                if (lenA == 0xffff) { //if not, ask for more data
-                    return HTTP_IO_NEED_DATA;
+                // Content-Disposition: form-data; name="updfile"; filename="image.bin"
+                pValue = strstr((char*) uploadBuffer, " name=\"");
+                if (pValue != NULL) {
+                    pValue += 7;
+                    pEnd = strchr(pValue, '"'); // Find closing quote
+                    if (pEnd == NULL || pEnd - pValue >= sizeof (strFieldName)) {
+                        goto UploadBadRequest;
+                    }
+                    memcpy(strFieldName, pValue, pEnd - pValue);
+                    strFieldName[pEnd - pValue] = 0;
                 }
-                // Get field value
-                if (!strcmppgm2ram(strFieldName, (ROM char*) "upddir")) { // Read destination folder name
-                    lenA = TCPGetArray(sktHTTP, strUploadFolder, lenA );
-                    strUploadFolder[lenA]=0;
-                    TCPGetArray(sktHTTP, NULL, 2); //  discard final CRLF
-                    curHTTP.byteCount -= lenA+2;
+                pValue = strstr((char*) uploadBuffer, "filename=\"");
+                if (pValue != NULL) {
+                    pValue += 10;
+                    pEnd = strchr(pValue, '"'); // Find closing quote
+                    if (pEnd == NULL) {
+                        goto UploadBadRequest;
+                    }
+                    *pEnd = 0;
+                    // Some browsers send the full path of the file: keep only its name
+                    while (pEnd > pValue && pEnd[-1] != '/' && pEnd[-1] != '\\')
+                        pEnd--;
+                    if (*pEnd == 0 || strlen(pEnd) >= sizeof (strUploadedFileName)) { // No file chosen or name too long
+                        goto UploadBadRequest;
+                    }
+                    strcpy(strUploadedFileName, pEnd);
+                    uploadIsFile = TRUE;
                 }
-                curHTTP.smPost=SM_UPD_PARSE_FIELDNAME; // Parse next field
                 break;
-                
+
             case SM_UPD_OPEN_FILE: // Try to open file for storage
                 strUploadPathName[0] = 0;
 #if defined(STACK_USE_MDD) && !defined(STACK_USE_FATFS)
@@ -1168,12 +1247,13 @@ HTTP_IO_RESULT HTTPPostUpload(void) {
                         *pUploadFolder++=c;
                     }
                 }
+                *pUploadFolder=0;
                 if(FileChDir(strUploadPathName)!=0) {
                     if(FileMkDir(strUploadPathName)!=0) {
-                        goto UploadFailure;
+                        goto UploadMediaError;
                     }
                     if(FileChDir(strUploadPathName)!=0) {
-                        goto UploadFailure;
+                        goto UploadMediaError;
                     }
                 }
                 curHTTP.pFhStoredFile = FileOpen(strUploadedFileName, "w");
@@ -1186,93 +1266,116 @@ HTTP_IO_RESULT HTTPPostUpload(void) {
                 strcat(strUploadPathName, strUploadedFileName);
                 if(FileDirExists(strUploadFolder)!=0) {
                     if(FileMkDir(strUploadFolder)!=0) {
-                        goto UploadFailure;
+                        goto UploadMediaError;
                     }
                 }
                 curHTTP.pFhStoredFile = FileOpen(strUploadPathName, "w");
 #endif
                 if (curHTTP.pFhStoredFile == NULL) {
-                    goto UploadFailure;
+                    goto UploadMediaError;
                 }
                 curHTTP.smPost = SM_UPD_READ_DATA;
                 // No break if we successfully opened file for writing
 
-                // Read and store file data
+            case SM_UPD_PARSE_FIELDVALUE:
             case SM_UPD_READ_DATA:
-                // Find out how many bytes are available to be read
-                // Locate end of file data (boundary tag, it's a multipart/form-data)
-                lenC=0xffff;
-                lenA=0;
-                // Check only if the buffer has enough data and there is a CRLF in the buffer
-                if(TCPIsGetReady(sktHTTP)>=curHTTP.BoundaryLen+2 && TCPFindROMArray(sktHTTP, (ROM BYTE*) "\r\n", 2, 0, FALSE)!=0xffff) {
-                    lenC = TCPFindROMArray(sktHTTP, (ROM BYTE*) curHTTP.Boundary, curHTTP.BoundaryLen, 0, FALSE);
-                    if(lenC!=0xffff) { // If found, Try to find start of boundary tag CRLF--------
-                        lenB=TCPFindROMArray(sktHTTP, (ROM BYTE*) "\r\n----------", 12, 0, FALSE);
-                        if(lenB==0xffff){ // Not found?
-                            // Workaround: TCPFindROMArray does give up looking for "\r\n----" if "\r\n\r\n-----" is present (Content-Type: text/html)
-                            // so let's retry with CRLFCRLF...
-                            lenB=TCPFindROMArray(sktHTTP, (ROM BYTE*) "\r\n\r\n----------", 14, 0, FALSE);
+                // Peek as much data as fits in uploadBuffer after the data already there
+                lenA = TCPIsGetReady(sktHTTP);
+                if (lenA > curHTTP.byteCount)
+                    lenA = curHTTP.byteCount;
+                if (lenA > sizeof (uploadBuffer) - uploadUsed)
+                    lenA = sizeof (uploadBuffer) - uploadUsed;
+                if (lenA < uploadDelimLen) {
+                    if (lenA == curHTTP.byteCount) { // The data ends without delimiter
+                        goto UploadBadRequest;
+                    }
+                    return HTTP_IO_NEED_DATA;
+                }
+                lenA = TCPPeekArray(sktHTTP, &uploadBuffer[uploadUsed], lenA, 0);
+                lenB = HTTPUploadScan(&uploadBuffer[uploadUsed], lenA, &found);
+                if (!found && lenA == curHTTP.byteCount) {
+                    goto UploadBadRequest;
+                }
+                // Remove the value bytes from the socket, and the CRLF of the delimiter:
+                // the boundary line is read with the next part headers
+                curHTTP.byteCount -= TCPGetArray(sktHTTP, NULL, found ? lenB + 2 : lenB);
+                uploadUsed += lenB;
+
+                if (curHTTP.smPost == SM_UPD_READ_DATA) {
+                    if (found) { // Last sector of the file
+                        if (uploadUsed != 0u && FileWrite(uploadBuffer, 1, uploadUsed, curHTTP.pFhStoredFile) != uploadUsed) {
+                            goto UploadMediaError; // File write error
                         }
-                        if(lenB!=0xffff){ // FOUND!
-                            lenA=lenB; // Use data only up to the boundary
-                            // And compute complete boundary len to discard
-                            lenC=lenB+(lenC-lenB)+curHTTP.BoundaryLen+2+2; // ------...-----<boundary>--CRLF
-                        } else { // No CRLF---- but boundary IS in the buffer????
-                            while(1);
+                        FileClose(curHTTP.pFhStoredFile);
+                        curHTTP.pFhStoredFile=NULL;
+                    } else if (uploadUsed >= HTTP_UPLOAD_SECTOR_LEN) { // Whole sector, at a sector aligned file offset
+                        if (FileWrite(uploadBuffer, 1, HTTP_UPLOAD_SECTOR_LEN, curHTTP.pFhStoredFile) != HTTP_UPLOAD_SECTOR_LEN) {
+                            goto UploadMediaError; // File write error
                         }
+                        uploadUsed -= HTTP_UPLOAD_SECTOR_LEN;
+                        memmove(uploadBuffer, &uploadBuffer[HTTP_UPLOAD_SECTOR_LEN], uploadUsed);
                     }
-                }
-                if(lenA==0) { // If no boundary found
-                    // Try to find a CR at end of buffer
-                    lenA=TCPFindROMArray(sktHTTP, (ROM BYTE*) "\r", 1, TCPIsGetReady(sktHTTP)- 2, FALSE);
-                    if(lenA==0xffff) { // If no CR at the end of the buffer
-                        lenA=TCPIsGetReady(sktHTTP); // Then use all available bytes
+                } else if (!strcmppgm2ram(strFieldName, (ROM char*) "upddir")) { // Read destination folder name
+                    if (uploadUsed >= sizeof (strUploadFolder)) {
+                        goto UploadBadRequest;
                     }
-                }
-
-                if (lenA > curHTTP.byteCount)
-                    lenA = curHTTP.byteCount;
-
-                while (lenA > 0u) {
-                    //lenB = TCPGetArray(sktHTTP, strBigBuffer, (lenA < HTTP_MAX_DATA_LEN) ? lenA : HTTP_MAX_DATA_LEN);
-                    lenB = TCPGetArray(sktHTTP, strBigBuffer, (lenA < sizeof(strBigBuffer)) ? lenA : sizeof(strBigBuffer));
-                    if(lenB==0)
-                        //goto UploadFailure;
-                        break;
-                    curHTTP.byteCount -= lenB;
-                    lenA -= lenB;
-                    if (FileWrite(strBigBuffer, 1, lenB, curHTTP.pFhStoredFile) != lenB) {
-                        goto UploadFailure; // File write error
+                    if (found && uploadUsed != 0u) {
+                        memcpy(strUploadFolder, uploadBuffer, uploadUsed);
+                        strUploadFolder[uploadUsed] = 0;
                     }
+                } else if (uploadUsed >= HTTP_UPLOAD_SECTOR_LEN) { // Other fields are not used
+                    uploadUsed = 0;
+                }
+                if (found) {
+                    curHTTP.smPost = SM_UPD_PARSE_HEADERS; // Parse next part
                 }
+                break;
 
-                if (lenC != 0xffff) {
-                    lenC = TCPGetArray(sktHTTP, strBigBuffer, lenC); //  discard boundary tag up to final CRLF
-                    curHTTP.byteCount -= lenC;
+            case SM_UPD_DONE: // Discard anything after the last boundary
+                lenA = TCPIsGetReady(sktHTTP);
+                if (lenA == 0u) {
+                    return HTTP_IO_NEED_DATA;
                 }
-                if (curHTTP.byteCount > 0u)
-                    return HTTP_IO_NEED_DATA; // Ask for more data
+                if (lenA > curHTTP.byteCount)
+                    lenA = curHTTP.byteCount;
+                curHTTP.byteCount -= TCPGetArray(sktHTTP, NULL, lenA);
+                break;
         }
     }
-    if(curHTTP.pFhStoredFile!=NULL) // Close file
-        FileClose(curHTTP.pFhStoredFile);
-    curHTTP.pFhStoredFile=NULL;
-    curHTTP.smPost = SM_UPD_PARSE_FIELDNAME; // Reset state machine for further uploads
+    if (curHTTP.smPost != SM_UPD_DONE) { // The data ends before the last boundary
+        goto UploadBadRequest;
+    }
+    lastSuccess = TRUE;
+    curHTTP.smPost = SM_UPD_START; // Reset state machine for further uploads
     httpStubs[curHTTPID].sm = SM_HTTP_SERVE_HEADERS;
     HttpConnResetSm();
     return HTTP_IO_DONE;
 
+UploadMediaError:
+#if defined(HTTP_FAT_UPLOAD)
+    if (curHTTP.httpStatus == HTTP_FAT_UPLOAD_UP) { // The upload form has its own error page
+        curHTTP.httpStatus = HTTP_FAT_UPLOAD_ERROR;
+        goto UploadFailure;
+    }
+#endif
+    curHTTP.httpStatus = HTTP_INTERNAL_SERVER_ERROR;
+    goto UploadFailure;
+
+UploadBadRequest:
+    curHTTP.httpStatus = HTTP_BAD_REQUEST;
+
 UploadFailure:
     lastFailure = TRUE;
-    curHTTP.byteCount -= TCPIsGetReady(sktHTTP);
-    TCPDiscard(sktHTTP);
-    if (curHTTP.byteCount < 100u || curHTTP.byteCount > 0x80000000u) {// If almost all data was read, or if we overflowed, then return
-        httpStubs[curHTTPID].sm = SM_HTTP_SERVE_HEADERS;
-    }
+    lenA = TCPIsGetReady(sktHTTP);
+    if (lenA > curHTTP.byteCount)
+        lenA = curHTTP.byteCount;
+    curHTTP.byteCount -= TCPGetArray(sktHTTP, NULL, lenA);
+    httpStubs[curHTTPID].sm = SM_HTTP_SERVE_HEADERS;
     if(curHTTP.pFhStoredFile!=NULL) {
         FileClose(curHTTP.pFhStoredFile);
         curHTTP.pFhStoredFile=NULL;
     }
+    curHTTP.smPost = SM_UPD_START;
     HttpConnResetSm();
     return HTTP_IO_DONE;
 }
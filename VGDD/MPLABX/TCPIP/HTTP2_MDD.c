@@ -51,6 +51,15 @@
  * Author               Date        Comment
  *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * Amit Shirbhate	7/18/09     Modified original for MDD FAT support.(Beta Release)
+ * VirtualFab		2026/10/17  Dynamic variable records looked up through DynIdx.bin
+ *                                  and a RAM cache, callbacks without directory changes
+ * VirtualFab		2026/10/17  Pages and included files sent in blocks between the
+ *                                  dynamic variable offsets, callbacks through
+ *                                  SM_HTTP_SEND_FROM_CALLBACK
+ * VirtualFab		2026/10/17  Exact multipart boundary kept for the streaming upload
+ *                                  parser, upload errors keep their HTTP status
+ * VirtualFab		2026/10/17  DynIdx.bin version 2: buckets keyed by the name hash
+ *                                  and a 32 bit FNV-1a of the page name
  ***************************************************************************************/
 
 #define __HTTP2_C
@@ -164,16 +173,56 @@ static ROM char * ROM HTTPRequestHeaders[] ={
 //BYTE sendDataBuffer[64];
 //BOOL CurWorkDirChangedToMddRootPath = FALSE;
 //BYTE * directoryPtr = NULL;
-BYTE EndOfCallBackFileFlag = FALSE;
 BYTE dirlen;
 extern volatile BOOL MemInterfaceAttached;
 
 //Name of file having log of "Files with Dynamic Variables" Sorted in Ascending order using hash name
 const char filename[] = "FileRcrd.bin"; //File Record
 const char dynVarRcrdFileName[] = "DynRcrd.bin"; //Dynamic variable Record
+const char dynVarIndexFileName[] = "DynIdx.bin"; //Hash index of the File Record
 FILE_HANDLE FileRcrdPtr = NULL;
 //static FILE_HANDLE DynVarRcrdFilePtr = NULL;
 
+// Number of pages whose dynamic variable record position is kept in RAM
+        #if !defined(HTTP_DYNVAR_CACHE_SIZE)
+            #define HTTP_DYNVAR_CACHE_SIZE      4
+        #endif
+
+// DynIdx.bin layout (little endian), written by the MPFS generator next to FileRcrd.bin:
+//   "DVIX", BYTE version, BYTE bucket bits, WORD number of pages
+//   (1 << bucket bits) buckets of {WORD nameHash, WORD dynVarCntr, DWORD position
+//   of the first offset/callback ID pair in DynRcrd.bin, DWORD nameKey}, dynVarCntr = 0
+//   for empty buckets, collisions stored in the following buckets (linear probing).
+//   nameKey is the 32 bit FNV-1a of the page name: pages sharing the 16 bit nameHash
+//   (e.g. protect/upload.htm and noupload.htm) are told apart by it
+        #define HTTP_DYNIDX_HEADER_LEN      8u
+        #define HTTP_DYNIDX_BUCKET_LEN      12u
+        #define HTTP_DYNIDX_VERSION         2u
+        #define HTTP_DYNIDX_BUCKET(h, bits) ((WORD)((WORD)((h) * 0x9E37u) >> (16 - (bits))))
+        #define HTTP_NAMEKEY_BASIS          0x811C9DC5ul
+        #define HTTP_NAMEKEY_PRIME          0x01000193ul
+
+typedef struct {
+    WORD nameHash;
+    DWORD nameKey;
+    WORD dynVarCntr;        // 0 for pages without dynamic variables
+    DWORD dynVarRcrdPos;    // First offset/callback ID pair in DynRcrd.bin
+} HTTP_DYNVAR_CACHE;
+
+// Most recently used first
+static HTTP_DYNVAR_CACHE httpDynVarCache[HTTP_DYNVAR_CACHE_SIZE];
+static BYTE httpDynVarCacheUsed = 0;
+
+// Pages and included files are read in blocks of this size (a power of 2),
+// aligned to the file start so that whole media sectors are read at once
+        #if !defined(HTTP_SEND_BLOCK_LEN)
+            #define HTTP_SEND_BLOCK_LEN         512u
+        #endif
+
+// Only used within a single HTTPSendFile()/HTTPIncFile() call, so it is
+// shared by all the connections
+static BYTE httpSendBlock[HTTP_SEND_BLOCK_LEN];
+
     #endif
 
 /****************************************************************************
@@ -212,6 +261,10 @@ static BOOL HTTPSendFile(void);
 static void HTTPLoadConn(BYTE hHTTP);
 static FILE_HANDLE FileOpenIndex(FILE_HANDLE hFile, BYTE * fileName);
 static WORD FileGetFlags(FILE_HANDLE hFile);
+    #ifdef STACK_USE_MDD
+static BOOL HTTPDynVarLookup(WORD nameHash, DWORD nameKey, DWORD *pDynVarCntr, DWORD *pDynVarRcrdPos);
+static BOOL HTTPSendFileSpan(DWORD end);
+    #endif
 
     #if defined(HTTP_MPFS_UPLOAD)
 static HTTP_IO_RESULT HTTPMPFSUpload(void);
@@ -433,6 +486,7 @@ static void HTTPProcess(void) {
     if (!MemInterfaceAttached) {
         curHTTP.httpStatus = HTTP_NOT_FOUND;
         curHTTP.CurWorkDirChangedToMddRootPath = FALSE;
+        httpDynVarCacheUsed = 0;
         smHTTP = SM_HTTP_SERVE_HEADERS;
 
         // Check for 404. File Not Found
@@ -470,6 +524,10 @@ static void HTTPProcess(void) {
                     curHTTP.byteCount = 0;
     #if defined(HTTP_USE_POST)
                     curHTTP.smPost = 0x00;
+                    curHTTP.BoundaryLen = 0;
+    #endif
+    #ifdef STACK_USE_MDD
+                    curHTTP.smHTTPSendFile = SM_IDLE;
     #endif
 
                     // Adjust the TCP FIFOs for optimal reception of
@@ -734,11 +792,14 @@ static void HTTPProcess(void) {
     #ifdef STACK_USE_MDD
 
                 //Calculate 2 Bytes HashIndex for  curHTTP.file->name
-                // Calculate the name hash to speed up searching
+                // Calculate the name hash to speed up searching, and the FNV-1a
+                // name key that tells apart the pages sharing the hash
+                curHTTP.nameKey = HTTP_NAMEKEY_BASIS;
                 for (curHTTP.nameHash = 0, ptr = (BYTE*) (&curHTTP.data[1]); ptr != (BYTE*) (&curHTTP.data[lenB]); ptr++) {
                     if (*ptr != 0x20) {
                         curHTTP.nameHash += *ptr;
                         curHTTP.nameHash <<= 1;
+                        curHTTP.nameKey = (curHTTP.nameKey ^ *ptr) * HTTP_NAMEKEY_PRIME;
                     }
                 }
     #endif
@@ -949,7 +1010,13 @@ static void HTTPProcess(void) {
                     if (curHTTP.httpStatus >= HTTP_FAT_UPLOAD_UP && curHTTP.httpStatus <= HTTP_FAT_UPLOAD_ERROR) {
                         c = HTTPPostUpload();
                         if (c == (BYTE) HTTP_IO_DONE) {
-                            curHTTP.httpStatus=HTTP_FAT_UPLOAD_OK;
+        #ifdef STACK_USE_MDD
+                            // The upload may have replaced the pages or their records
+                            httpDynVarCacheUsed = 0;
+        #endif
+                            // HTTPPostUpload() sets the error status when the upload fails
+                            if (curHTTP.httpStatus == HTTP_FAT_UPLOAD_UP)
+                                curHTTP.httpStatus = HTTP_FAT_UPLOAD_OK;
                             smHTTP = SM_HTTP_SERVE_HEADERS;
                             isDone = FALSE;
                             break;
@@ -1196,314 +1263,359 @@ static void HTTPProcess(void) {
 
 }
 
+    #ifdef STACK_USE_MDD
 /*****************************************************************************
   Function:
-    static BOOL HTTPSendFile(void)
+    static BOOL HTTPDynVarIndexRead(HTTP_DYNVAR_CACHE *pEntry)
 
   Description:
-    Serves up the next chunk of curHTTP's file, up to a) available TX FIFO
-    space or b) the next callback index, whichever comes first.
+    Looks up pEntry->nameHash in DynIdx.bin. The bucket of the hash is
+    usually the only one read; a bucket matches only when its name key is
+    pEntry->nameKey too. Read in bytes: FileRead() returns the bytes read
+    on FatFs, the items read on MDD.
 
   Precondition:
-    curHTTP.file and curHTTP.offsets have both been opened for reading.
+    The working directory is MDD_ROOT_DIR_PATH.
 
   Parameters:
-    None
+    pEntry - nameHash and nameKey to look up, filled with the record found
 
   Return Values:
-    TRUE - the end of the file was reached and reading is done
-    FALSE - more data remains to be read
+    TRUE - DynIdx.bin was read, pEntry->dynVarCntr is 0 if the page has
+           no dynamic variables
+    FALSE - DynIdx.bin is missing or invalid
  ***************************************************************************/
-static BOOL HTTPSendFile(void) {
-
-    #ifdef STACK_USE_MDD
+static BOOL HTTPDynVarIndexRead(HTTP_DYNVAR_CACHE *pEntry) {
+    FILE_HANDLE hIndex;
+    BYTE buf[HTTP_DYNIDX_BUCKET_LEN];
+    WORD bucket, mask, probes;
+    BOOL valid = FALSE;
+
+    hIndex = FileOpen(dynVarIndexFileName, "r");
+    if (hIndex == INVALID_FILE_HANDLE)
+        return FALSE;
+
+    if (FileRead(buf, 1, HTTP_DYNIDX_HEADER_LEN, hIndex) == HTTP_DYNIDX_HEADER_LEN &&
+            buf[0] == 'D' && buf[1] == 'V' && buf[2] == 'I' && buf[3] == 'X' &&
+            buf[4] == HTTP_DYNIDX_VERSION && buf[5] >= 2u && buf[5] <= 15u) {
+        valid = TRUE;
+        mask = (1u << buf[5]) - 1;
+        bucket = HTTP_DYNIDX_BUCKET(pEntry->nameHash, buf[5]);
+        FileSeek(hIndex, HTTP_DYNIDX_HEADER_LEN + (DWORD) bucket * HTTP_DYNIDX_BUCKET_LEN, SEEK_SET);
+        for (probes = 0; probes <= mask; probes++) {
+            if (FileRead(buf, 1, HTTP_DYNIDX_BUCKET_LEN, hIndex) != HTTP_DYNIDX_BUCKET_LEN) {
+                valid = FALSE;
+                break;
+            }
+            pEntry->dynVarCntr = ((WORD) buf[3] << 8) | buf[2];
+            if (pEntry->dynVarCntr == 0)
+                break; // empty bucket, the page has no dynamic variables
+            if ((((WORD) buf[1] << 8) | buf[0]) == pEntry->nameHash &&
+                    (((DWORD) buf[11] << 24) | ((DWORD) buf[10] << 16) | ((WORD) buf[9] << 8) | buf[8]) == pEntry->nameKey) {
+                pEntry->dynVarRcrdPos = ((DWORD) buf[7] << 24) | ((DWORD) buf[6] << 16) | ((WORD) buf[5] << 8) | buf[4];
+                break;
+            }
+            pEntry->dynVarCntr = 0;
+            bucket = (bucket + 1) & mask;
+            if (bucket == 0)
+                FileSeek(hIndex, HTTP_DYNIDX_HEADER_LEN, SEEK_SET);
+        }
+    }
+    FileClose(hIndex);
+    return valid;
+}
 
-    DWORD availbleTcpBuffSize, len;
-    DWORD cntr = 0;
-    DWORD UInt32DataFromBinFile;
-    WORD UInt16DataFromBinFile, nameHashRcrd;
-    DWORD recrdcntr = 0;
+/*****************************************************************************
+  Function:
+    static void HTTPDynVarRecordScan(HTTP_DYNVAR_CACHE *pEntry)
 
-    switch (curHTTP.smHTTPSendFile) {
-        case SM_IDLE:
+  Description:
+    Looks up pEntry->nameHash scanning FileRcrd.bin, for pages generated
+    without DynIdx.bin. FileRcrd.bin has no name key: of the pages sharing
+    a name hash, the first one's record is returned.
 
-            if (ChangeToRootPath() == FALSE) {
-                if (curHTTP.directoryPtr != NULL)
-                    free(curHTTP.directoryPtr);
-                return TRUE;
-            }
-            curHTTP.numBytes = FileGetFileSize(curHTTP.file);
+  Precondition:
+    The working directory is MDD_ROOT_DIR_PATH.
 
-        case SM_GET_NO_OF_FILES:
-            FileRcrdPtr = FileOpen(filename, "r");
-            cntr = FileReadUInt32(&recrdcntr, FileRcrdPtr); //Reading Number of files in record
+  Parameters:
+    pEntry - nameHash to look up, filled with the record found
+ ***************************************************************************/
+static void HTTPDynVarRecordScan(HTTP_DYNVAR_CACHE *pEntry) {
+    DWORD recrdcntr = 0, UInt32DataFromBinFile, dynVarCntr;
+    WORD nameHashRcrd;
 
-            //Continue to next state
-            curHTTP.smHTTPSendFile = SM_GET_HASH_RCRD;
+    FileRcrdPtr = FileOpen(filename, "r");
+    if (FileRcrdPtr == INVALID_FILE_HANDLE)
+        return;
+    FileReadUInt32(&recrdcntr, FileRcrdPtr); //Reading Number of files in record
+
+    while (recrdcntr) {
+        FileReadUInt16(&nameHashRcrd, FileRcrdPtr); //Reading HashName record
+        //Reading OFFSET of dynvar records in dynvarrcrd.bin
+        FileReadUInt32(&UInt32DataFromBinFile, FileRcrdPtr);
+        //Reading Number dynamic variables in the file
+        FileReadUInt32(&dynVarCntr, FileRcrdPtr);
+
+        if (pEntry->nameHash == nameHashRcrd) {
+            //Skip the record length and flags
+            pEntry->dynVarRcrdPos = UInt32DataFromBinFile + 6;
+            pEntry->dynVarCntr = (WORD) dynVarCntr;
+            break;
+        }
+        if (nameHashRcrd > pEntry->nameHash)
+            break; // records are sorted by hash name
+        recrdcntr -= 1;
+    }
 
-        case SM_GET_HASH_RCRD:
+    FileClose(FileRcrdPtr);
+    FileRcrdPtr = INVALID_FILE_HANDLE;
+}
 
-            while (recrdcntr) {
-                cntr = FileReadUInt16(&nameHashRcrd, FileRcrdPtr); //Reading HashName record
+/*****************************************************************************
+  Function:
+    static BOOL HTTPDynVarLookup(WORD nameHash, DWORD nameKey, DWORD *pDynVarCntr, DWORD *pDynVarRcrdPos)
 
-                if (curHTTP.nameHash == nameHashRcrd) {
-                    curHTTP.nameHashMatched = TRUE;
-                    curHTTP.DynVarRcrdFilePtr = FileOpen(dynVarRcrdFileName, "r");
+  Description:
+    Finds the dynamic variable record of the page with the given name hash
+    and name key.
+    The last HTTP_DYNVAR_CACHE_SIZE pages looked up, with or without dynamic
+    variables, are answered from RAM; the others are read from DynIdx.bin,
+    or from FileRcrd.bin when the index is missing.
 
-                    //Reading OFFSET of dynvar records in dynvarrcrd.bin
-                    cntr = FileReadUInt32(&UInt32DataFromBinFile, FileRcrdPtr);
+  Precondition:
+    The working directory is MDD_ROOT_DIR_PATH.
 
-                    FileSeek(curHTTP.DynVarRcrdFilePtr, UInt32DataFromBinFile, SEEK_SET);
+  Parameters:
+    nameHash - name hash of the page
+    nameKey - FNV-1a of the page name
+    pDynVarCntr - receives the number of dynamic variables in the page
+    pDynVarRcrdPos - receives the position of the first offset/callback ID
+                     pair in DynRcrd.bin
 
-                    //Reading Number dynamic variables in the file
-                    cntr = FileReadUInt32(&curHTTP.dynVarCntr, FileRcrdPtr);
-                    break;
-                } else //Dummy Read..to hop to next hash name or HOP by "FileSeek" in file handle
-                {
-                    cntr = FileReadUInt32(&UInt32DataFromBinFile, FileRcrdPtr);
-                    cntr = FileReadUInt32(&UInt32DataFromBinFile, FileRcrdPtr);
-                }
-                recrdcntr -= 1;
+  Return Values:
+    TRUE - the page has dynamic variables
+    FALSE - the page can be served as it is
+ ***************************************************************************/
+static BOOL HTTPDynVarLookup(WORD nameHash, DWORD nameKey, DWORD *pDynVarCntr, DWORD *pDynVarRcrdPos) {
+    HTTP_DYNVAR_CACHE entry;
+    BYTE i;
 
-            }
+    for (i = 0; i < httpDynVarCacheUsed; i++) {
+        if (httpDynVarCache[i].nameHash == nameHash && httpDynVarCache[i].nameKey == nameKey)
+            break;
+    }
 
-            if (FileRcrdPtr != INVALID_FILE_HANDLE) {
-                FileClose(FileRcrdPtr);
-                FileRcrdPtr = INVALID_FILE_HANDLE;
-            }
+    if (i < httpDynVarCacheUsed) {
+        entry = httpDynVarCache[i];
+    } else {
+        entry.nameHash = nameHash;
+        entry.nameKey = nameKey;
+        entry.dynVarCntr = 0;
+        entry.dynVarRcrdPos = 0;
+        if (!HTTPDynVarIndexRead(&entry))
+            HTTPDynVarRecordScan(&entry);
+        if (httpDynVarCacheUsed < HTTP_DYNVAR_CACHE_SIZE)
+            httpDynVarCacheUsed++;
+        i = httpDynVarCacheUsed - 1;
+    }
 
-            if (curHTTP.nameHashMatched == TRUE) {
-                //Continue to next state
-                curHTTP.smHTTPSendFile = SM_GET_DYN_VAR_FILE_RCRD;
-            }
+    // Move to the front, dropping the least recently used entry on a miss
+    for (; i > 0; i--)
+        httpDynVarCache[i] = httpDynVarCache[i - 1];
+    httpDynVarCache[0] = entry;
 
-            //If NO HashName record matched means the requrested webpage do not have dynamic variables
-            if (recrdcntr == 0 && curHTTP.nameHashMatched != TRUE) {
-                curHTTP.smHTTPSendFile = SM_SERVE_TEXT_DATA;
+    *pDynVarCntr = entry.dynVarCntr;
+    *pDynVarRcrdPos = entry.dynVarRcrdPos;
+    return entry.dynVarCntr != 0;
+}
 
-                if (curHTTP.DynVarRcrdFilePtr != INVALID_FILE_HANDLE) {
-                    FileClose(curHTTP.DynVarRcrdFilePtr);
-                    curHTTP.DynVarRcrdFilePtr = INVALID_FILE_HANDLE;
-                }
-                break;
-            }
+/*****************************************************************************
+  Function:
+    static BOOL HTTPSendFileSpan(DWORD end)
 
-        case SM_GET_DYN_VAR_FILE_RCRD:
+  Description:
+    Sends curHTTP.file from curHTTP.bytesReadCount up to end, as far as the
+    TCP transmit FIFO allows. The file is read in HTTP_SEND_BLOCK_LEN blocks
+    aligned to its start, each one put in the FIFO with a single call.
 
-            if (curHTTP.lock == 0) {
-                cntr = FileReadUInt32(&UInt32DataFromBinFile, curHTTP.DynVarRcrdFilePtr); //Reading Record Length
-                cntr = FileReadUInt16(&UInt16DataFromBinFile, curHTTP.DynVarRcrdFilePtr); //Reading Flags
-                curHTTP.lock = 1;
-            }
+  Precondition:
+    curHTTP.file is positioned at curHTTP.bytesReadCount.
 
-            cntr = FileReadUInt32(&curHTTP.dynVarRcrdOffset, curHTTP.DynVarRcrdFilePtr); //Reading dynamic variable offset in webpage
-            cntr = FileReadUInt32(&curHTTP.dynVarCallBackID, curHTTP.DynVarRcrdFilePtr); //Reading dynamic variable call back ID
+  Parameters:
+    end - offset in the file where the span ends
 
+  Return Values:
+    TRUE - end was reached (or the file ended before it)
+    FALSE - the TCP transmit FIFO is full, call again later
+ ***************************************************************************/
+static BOOL HTTPSendFileSpan(DWORD end) {
+    WORD len, avail;
 
-            //Continue to next state
-            curHTTP.smHTTPSendFile = SM_PARSE_TILL_DYN_VAR;
+    while (curHTTP.bytesReadCount < end) {
+        avail = TCPIsPutReady(sktHTTP);
+        if (avail == 0u)
+            return FALSE;
 
-        case SM_PARSE_TILL_DYN_VAR:
+        len = HTTP_SEND_BLOCK_LEN - (WORD) (curHTTP.bytesReadCount & (HTTP_SEND_BLOCK_LEN - 1));
+        if (len > end - curHTTP.bytesReadCount)
+            len = end - curHTTP.bytesReadCount;
+        if (len > avail)
+            len = avail;
 
-            //If the dynamic variable starts at the begining of any file, Parse the dynamic var string
-            if (curHTTP.dynVarRcrdOffset == 0x00) {
-                curHTTP.smHTTPSendFile = SM_PARSE_DYN_VAR_STRING;
-            } else {
-
-                // Determine and keep parsing data depending on the number of bytes available in the TCP transmit buffer
-                availbleTcpBuffSize = TCPIsPutReady(sktHTTP);
-
-                if (availbleTcpBuffSize >= 64) {
-                    if ((curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount) >= 64) {
-                        len = FileRead(curHTTP.sendDataBuffer, 64, 1, curHTTP.file);
-                        TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, 64);
-                        curHTTP.numBytes -= 64;
-                        curHTTP.bytesReadCount += 64;
-                    } else {
-                        len = FileRead(curHTTP.sendDataBuffer, (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount), 1, curHTTP.file);
-
-                        TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount));
-                        curHTTP.numBytes -= (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount);
-                        curHTTP.bytesReadCount += (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount);
-                    }
-                } else if (availbleTcpBuffSize != 0) {
-                    if (curHTTP.bytesReadCount != curHTTP.dynVarRcrdOffset) {
-                        if ((curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount) >= availbleTcpBuffSize) {
-                            len = FileRead(curHTTP.sendDataBuffer, availbleTcpBuffSize, 1, curHTTP.file);
-                            TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, availbleTcpBuffSize);
-                            curHTTP.numBytes -= availbleTcpBuffSize;
-                            curHTTP.bytesReadCount += availbleTcpBuffSize;
-                        } else {
-                            len = FileRead(curHTTP.sendDataBuffer, (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount), 1, curHTTP.file);
-                            TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount));
-                            curHTTP.numBytes -= (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount);
-                            curHTTP.bytesReadCount += (curHTTP.dynVarRcrdOffset - curHTTP.bytesReadCount);
-                        }
-                    }
-                }
-            }
+        len = FileRead(httpSendBlock, 1, len, curHTTP.file);
+        if (len == 0u) {
+            //The file is shorter than expected
+            curHTTP.numBytes = curHTTP.bytesReadCount;
+            return TRUE;
+        }
+        TCPPutArray(sktHTTP, httpSendBlock, len);
+        curHTTP.bytesReadCount += len;
+    }
+    return TRUE;
+}
+    #endif
 
-            if (curHTTP.dynVarRcrdOffset == curHTTP.bytesReadCount) {
-                //Continue to next state
-                curHTTP.smHTTPSendFile = SM_PARSE_DYN_VAR_STRING;
-            }
+/*****************************************************************************
+  Function:
+    static BOOL HTTPSendFile(void)
 
-            break;
+  Description:
+    Serves up the next chunk of curHTTP's file, up to a) available TX FIFO
+    space or b) the next callback index, whichever comes first.
 
-        case SM_PARSE_DYN_VAR_STRING:
+  Precondition:
+    curHTTP.file and curHTTP.offsets have both been opened for reading.
 
-            len = FileRead(curHTTP.sendDataBuffer, 1, 1, curHTTP.file);
-            curHTTP.numBytes -= 1;
-            curHTTP.bytesReadCount += 1;
-            if (curHTTP.sendDataBuffer[0] == '~') {
-                do {
-                    len = FileRead(curHTTP.sendDataBuffer, 1, 1, curHTTP.file);
-                    curHTTP.numBytes -= 1;
-                    curHTTP.bytesReadCount += 1;
-                } while (curHTTP.sendDataBuffer[0] != '~');
-            }
+  Parameters:
+    None
 
-            //Continue to next state to process the dynamic variable callback
-            curHTTP.smHTTPSendFile = SM_PROCESS_DYN_VAR_CALLBACK;
+  Return Values:
+    TRUE - the end of the file was reached and reading is done
+    FALSE - more data remains to be read
+ ***************************************************************************/
+static BOOL HTTPSendFile(void) {
 
+    #ifdef STACK_USE_MDD
 
-        case SM_PROCESS_DYN_VAR_CALLBACK:
+    DWORD UInt32DataFromBinFile;
+    WORD len;
 
-            EndOfCallBackFileFlag = TRUE;
+    switch (curHTTP.smHTTPSendFile) {
+        case SM_IDLE:
 
             if (ChangeToRootPath() == FALSE) {
                 if (curHTTP.directoryPtr != NULL)
                     free(curHTTP.directoryPtr);
-                return;
-            }
-
-            if (curHTTP.dynVarCallBackID == 2) {
-                curHTTP.dynVarCallBackID = curHTTP.dynVarCallBackID;
+                return TRUE;
             }
+            curHTTP.numBytes = FileGetFileSize(curHTTP.file);
+            curHTTP.bytesReadCount = 0;
 
-            HTTPPrint(curHTTP.dynVarCallBackID);
-            TCPFlush(sktHTTP);
-
-            if (ChangeToRootPath() == TRUE && curHTTP.directoryPtr != NULL) {
-                //Change working directory to client request directory
-                if (FileChDir((char *) (curHTTP.directoryPtr + 2)) == 0) {
-                    curHTTP.CurWorkDirChangedToMddRootPath = FALSE;
-                } else {
-                    free(curHTTP.directoryPtr);
-                    return TRUE;
-                }
+        case SM_GET_NO_OF_FILES:
+            if (!HTTPDynVarLookup(curHTTP.nameHash, curHTTP.nameKey, &curHTTP.dynVarCntr, &UInt32DataFromBinFile)) {
+                //No record means the requested webpage does not have dynamic variables
+                curHTTP.smHTTPSendFile = SM_SERVE_TEXT_DATA;
+                return FALSE;
             }
 
-            if (EndOfCallBackFileFlag == TRUE) {
-                curHTTP.dynVarCntr -= 1;
-                curHTTP.smHTTPSendFile = SM_GET_DYN_VAR_FILE_RCRD;
-                if (curHTTP.dynVarCntr == 0) {
-                    if ((!FileEOF(curHTTP.file)) || (curHTTP.numBytes != 0)) {
-                        curHTTP.smHTTPSendFile = SM_SERVE_TEXT_DATA;
-
-                    }
+            curHTTP.nameHashMatched = TRUE;
+            curHTTP.DynVarRcrdFilePtr = FileOpen(dynVarRcrdFileName, "r");
+            FileSeek(curHTTP.DynVarRcrdFilePtr, UInt32DataFromBinFile, SEEK_SET);
 
-                    curHTTP.lock = 0;
+            //Continue to next state
+            curHTTP.smHTTPSendFile = SM_GET_DYN_VAR_FILE_RCRD;
 
-                }
+        case SM_GET_DYN_VAR_FILE_RCRD:
 
+            if (curHTTP.dynVarCntr == 0 ||
+                    FileReadUInt32(&curHTTP.dynVarRcrdOffset, curHTTP.DynVarRcrdFilePtr) == 0 || //Reading dynamic variable offset in webpage
+                    FileReadUInt32(&curHTTP.dynVarCallBackID, curHTTP.DynVarRcrdFilePtr) == 0 || //Reading dynamic variable call back ID
+                    curHTTP.dynVarRcrdOffset < curHTTP.bytesReadCount || curHTTP.dynVarRcrdOffset >= curHTTP.numBytes) {
+                //No more dynamic variables: the rest of the page is plain text
+                curHTTP.smHTTPSendFile = SM_SERVE_TEXT_DATA;
+                return FALSE;
             }
+            curHTTP.dynVarCntr -= 1;
 
-            break;
-
-        case SM_SERVE_TEXT_DATA:
+            //Continue to next state
+            curHTTP.smHTTPSendFile = SM_PARSE_TILL_DYN_VAR;
 
-            // If HashIndex do not match,that means no entry in the "FilRcrd.bin", means no dynamic variables for this wepage,
-            //then proceed to serve the page as normal HTML text
+        case SM_PARSE_TILL_DYN_VAR:
 
-            availbleTcpBuffSize = TCPIsPutReady(sktHTTP);
+            //Send the text up to the dynamic variable, as far as the TCP transmit buffer allows
+            if (!HTTPSendFileSpan(curHTTP.dynVarRcrdOffset))
+                return FALSE;
 
-            if (availbleTcpBuffSize >= 64) {
-                if (curHTTP.numBytes >= 64) {
-                    len = FileRead(curHTTP.sendDataBuffer, 64, 1, curHTTP.file);
-                    TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, 64);
-                    curHTTP.numBytes -= 64;
-                } else {
-                    len = FileRead(curHTTP.sendDataBuffer, curHTTP.numBytes, 1, curHTTP.file);
-                    TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, curHTTP.numBytes);
-                    curHTTP.numBytes = 0;
+            //Continue to next state
+            curHTTP.smHTTPSendFile = SM_PARSE_DYN_VAR_STRING;
 
-                }
-            } else if (availbleTcpBuffSize != 0) {
-                if (curHTTP.numBytes >= availbleTcpBuffSize) {
-                    len = FileRead(curHTTP.sendDataBuffer, availbleTcpBuffSize, 1, curHTTP.file);
-                    TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, availbleTcpBuffSize);
-                    curHTTP.numBytes -= availbleTcpBuffSize;
-                } else {
-                    len = FileRead(curHTTP.sendDataBuffer, curHTTP.numBytes, 1, curHTTP.file);
-                    TCPPutArray(sktHTTP, curHTTP.sendDataBuffer, curHTTP.numBytes);
-                    curHTTP.numBytes = 0;
+        case SM_PARSE_DYN_VAR_STRING:
 
+            //Skip the ~name~ string: find the closing '~' and seek right after it
+            do {
+                len = FileRead(httpSendBlock, 1, 64u, curHTTP.file);
+                if (curHTTP.bytesReadCount == curHTTP.dynVarRcrdOffset && (len == 0u || httpSendBlock[0] != '~')) {
+                    //The record is of another page with the same name hash: send the rest as it is
+                    FileSeek(curHTTP.file, curHTTP.bytesReadCount, SEEK_SET);
+                    curHTTP.smHTTPSendFile = SM_SERVE_TEXT_DATA;
+                    return FALSE;
                 }
-            }
-//            if (numBytes <= 100) {
-//                numBytes = numBytes;
-//            }
-            if (curHTTP.numBytes == 0) {
-                TCPFlush(sktHTTP);
-
-
-                if (curHTTP.offsets != INVALID_FILE_HANDLE) {
-                    FileClose(curHTTP.offsets);
-                    curHTTP.offsets = INVALID_FILE_HANDLE;
+                for (UInt32DataFromBinFile = 0; UInt32DataFromBinFile < len; UInt32DataFromBinFile++) {
+                    if (httpSendBlock[UInt32DataFromBinFile] == '~' && (curHTTP.bytesReadCount != curHTTP.dynVarRcrdOffset || UInt32DataFromBinFile != 0))
+                        break;
                 }
-                curHTTP.nameHashMatched = FALSE;
-
-                if (curHTTP.DynVarRcrdFilePtr != INVALID_FILE_HANDLE) {
-                    FileClose(curHTTP.DynVarRcrdFilePtr);
-                    curHTTP.DynVarRcrdFilePtr = INVALID_FILE_HANDLE;
+                if (UInt32DataFromBinFile < len) {
+                    curHTTP.bytesReadCount += UInt32DataFromBinFile + 1;
+                    FileSeek(curHTTP.file, curHTTP.bytesReadCount, SEEK_SET);
+                    break;
                 }
+                curHTTP.bytesReadCount += len;
+            } while (len != 0u);
 
-                if (ChangeToRootPath()==FALSE) {
-                    if (curHTTP.directoryPtr != NULL) {
-                        free(curHTTP.directoryPtr);
-                    }
-                    return TRUE;
-                }
+            //Continue to next state to process the dynamic variable callback
+            curHTTP.smHTTPSendFile = SM_PROCESS_DYN_VAR_CALLBACK;
 
-                curHTTP.smHTTPSendFile = SM_IDLE;
-                curHTTP.bytesReadCount = 0;
-                return TRUE;
-            }
-            break;
+        case SM_PROCESS_DYN_VAR_CALLBACK:
 
-        default:
+            //Let the HTTP state machine call HTTPPrint() until the callback has
+            //written all its output (curHTTP.callbackPos back to 0), then come
+            //back here for the next dynamic variable.
+            //The working directory stays MDD_ROOT_DIR_PATH from SM_IDLE on, as the page
+            //and DynRcrd.bin are read through their handles: callbacks opening files
+            //must use paths relative to MDD_ROOT_DIR_PATH
+            curHTTP.callbackID = curHTTP.dynVarCallBackID;
+            curHTTP.callbackPos = 0;
+            smHTTP = SM_HTTP_SEND_FROM_CALLBACK;
+            curHTTP.smHTTPSendFile = SM_GET_DYN_VAR_FILE_RCRD;
             return FALSE;
 
-    }
+        case SM_SERVE_TEXT_DATA:
 
-    if ((FileEOF(curHTTP.file) || (curHTTP.numBytes == 0)) && EndOfCallBackFileFlag == TRUE) {
-        TCPFlush(sktHTTP);
+            //Send the rest of the page
+            if (!HTTPSendFileSpan(curHTTP.numBytes))
+                return FALSE;
 
-        if (curHTTP.offsets != INVALID_FILE_HANDLE) {
-            FileClose(curHTTP.offsets);
-            curHTTP.offsets = INVALID_FILE_HANDLE;
-        }
-        curHTTP.nameHashMatched = FALSE;
-        curHTTP.lock = 0;
+            TCPFlush(sktHTTP);
 
-        if (curHTTP.DynVarRcrdFilePtr != INVALID_FILE_HANDLE) {
-            FileClose(curHTTP.DynVarRcrdFilePtr);
-            curHTTP.DynVarRcrdFilePtr = INVALID_FILE_HANDLE;
-        }
+            if (curHTTP.offsets != INVALID_FILE_HANDLE) {
+                FileClose(curHTTP.offsets);
+                curHTTP.offsets = INVALID_FILE_HANDLE;
+            }
+            curHTTP.nameHashMatched = FALSE;
 
-        if (ChangeToRootPath() == FALSE) {
-            if(curHTTP.directoryPtr != NULL) {
-                free(curHTTP.directoryPtr);
+            if (curHTTP.DynVarRcrdFilePtr != INVALID_FILE_HANDLE) {
+                FileClose(curHTTP.DynVarRcrdFilePtr);
+                curHTTP.DynVarRcrdFilePtr = INVALID_FILE_HANDLE;
             }
+
+            curHTTP.smHTTPSendFile = SM_IDLE;
             return TRUE;
-        }
 
-        curHTTP.smHTTPSendFile = SM_IDLE;
-        return TRUE;
+        default:
+            return FALSE;
+
     }
 
-    return FALSE;
     #else
 
     WORD numBytes, len;
@@ -1793,8 +1905,11 @@ static void HTTPHeaderParseLookup(BYTE i) {
 
   Description:
     Parses the "Content-Type:" header to determine the boundary tag
-    for a multipart/form-data POSTed.  This value is stored in
-    curHTTP.Boundary and its length in curHTTP.BoundaryLen.
+    for a multipart/form-data POSTed.  This value is stored as sent,
+    without quotes, in curHTTP.Boundary and its length in curHTTP.BoundaryLen,
+    so the delimiters in the POSTed data are CRLF + "--" + curHTTP.Boundary.
+    curHTTP.BoundaryLen is left to 0 if there is no boundary or if it does
+    not fit in curHTTP.Boundary.
 
   Precondition:
     None
@@ -1811,30 +1926,43 @@ static void HTTPHeaderParseLookup(BYTE i) {
     #if defined(HTTP_USE_POST)
 
     static void HTTPHeaderParseContentType(void) {
-    WORD len;
-    char buf[64];
-    BYTE i=0,j=0;
+    WORD len, lineLen;
+    char buf[sizeof (curHTTP.Boundary) + 2];
+    BYTE i, j = 0, quoted;
 
-    // See if a boundary header is in the buffer
-    len = TCPFindROMArray(sktHTTP, (ROM BYTE*) " boundary=", 10, 0, FALSE);
-    if (len == 0xffff) { //if not, exit
+    curHTTP.BoundaryLen = 0;
+
+    // The boundary parameter must be on this header line
+    lineLen = TCPFindROMArray(sktHTTP, HTTP_CRLF, HTTP_CRLF_LEN, 0, FALSE);
+    if (lineLen == 0xffff) { //if not, exit
         return;
     }
-    // If found, discard header up to boundary start
-    len = TCPGetArray(sktHTTP, NULL, len+10);
-
-    // Read up to the CRLF
-    len = TCPFindROMArray(sktHTTP, HTTP_CRLF, HTTP_CRLF_LEN, 0, FALSE);
+    len = TCPFindROMArrayEx(sktHTTP, (ROM BYTE*) "boundary=", 9, 0, lineLen, TRUE);
     if (len == 0xffff) { //if not, exit
         return;
     }
-    len = TCPGetArray(sktHTTP, buf, len);
-    while(buf[++i]=='-')
-        len--;
-    curHTTP.BoundaryLen = len-1;
-    while(len--)
-        curHTTP.Boundary[j++]=buf[i++];
-    curHTTP.Boundary[curHTTP.BoundaryLen] = '\0'; // Terminate string
+    // If found, discard header up to boundary start
+    TCPGetArray(sktHTTP, NULL, len + 9);
+
+    // Read up to the CRLF, the caller discards the rest of the line
+    len = lineLen - len - 9;
+    if (len > sizeof (buf))
+        len = sizeof (buf);
+    len = TCPGetArray(sktHTTP, (BYTE*) buf, len);
+
+    // Copy the boundary, removing the quotes if it is a quoted-string
+    quoted = (len != 0u && buf[0] == '"');
+    for (i = quoted; i < len; i++) {
+        if (quoted ? buf[i] == '"' : (buf[i] == ';' || buf[i] == ' '))
+            break;
+        if (j == sizeof (curHTTP.Boundary) - 1u) // Too long, leave BoundaryLen to 0
+            return;
+        curHTTP.Boundary[j++] = buf[i];
+    }
+    if (quoted && i == len) // Closing quote not found
+        return;
+    curHTTP.Boundary[j] = '\0'; // Terminate string
+    curHTTP.BoundaryLen = j;
 }
     #endif
 
@@ -2350,79 +2478,38 @@ void HTTPIncFile(ROM BYTE* cFile) {
     #ifdef STACK_USE_MDD
 
     FILE_HANDLE fp;
-    static DWORD availbleTcpBuffSize, len, numBytes;
-    static BYTE lock = 0;
-    BYTE incDataBuffer[64];
+    DWORD pos;
+    WORD len, avail;
 
     if ((fp = FileOpenROM((const char *) cFile, "r")) == INVALID_FILE_HANDLE) {// File not found, so abort
         curHTTP.callbackPos = 0x00;
         return;
-    } else {// The file opened successfully, so seek the file
-        if (lock == 0) {
-            numBytes = FileGetFileSize(fp);
-            lock = 1;
-        } else {
-            FileSeek(fp, ((DWORD_VAL*) & curHTTP.callbackPos)->w[1], FILE_SEEK_FORWARD);
-        }
     }
 
-    availbleTcpBuffSize = TCPIsPutReady(sktHTTP);
-
-    if (availbleTcpBuffSize == 0) {
-        // Save the new address and close the file
-        ((DWORD_VAL*) & curHTTP.callbackPos)->w[1] = FileTell(fp);
-
-        if (fp != INVALID_FILE_HANDLE) {
-            FileClose(fp);
-            fp = INVALID_FILE_HANDLE;
-        }
-        EndOfCallBackFileFlag = FALSE;
-        return;
+    // curHTTP.callbackPos holds the position reached plus one
+    if (curHTTP.callbackPos == 0x00u) {
+        pos = 0;
+    } else {
+        pos = curHTTP.callbackPos - 1;
+        FileSeek(fp, pos, SEEK_SET);
     }
 
-    if (availbleTcpBuffSize >= 64) {
-        if (numBytes <= 64) {
-            len = FileRead(incDataBuffer, numBytes, 1, fp);
-            TCPPutArray(sktHTTP, incDataBuffer, numBytes);
-            numBytes = 0;
-        }
-        else {
-            len = FileRead(incDataBuffer, 64, 1, fp);
-            TCPPutArray(sktHTTP, incDataBuffer, 64);
-            numBytes -= 64;
-        }
-    } else //if(availbleTcpBuffSize != 0)
-    {
-        if (numBytes <= availbleTcpBuffSize) {
-            len = FileRead(incDataBuffer, numBytes, 1, fp);
-            TCPPutArray(sktHTTP, incDataBuffer, numBytes);
-            numBytes = 0;
-        }
-        else {
-            len = FileRead(incDataBuffer, availbleTcpBuffSize, 1, fp);
-            TCPPutArray(sktHTTP, incDataBuffer, availbleTcpBuffSize);
-            numBytes -= availbleTcpBuffSize;
-        }
-    }
-    //	if(numBytes == 0)
-    if (FileEOF(fp)) {// If no bytes were read, an EOF was reached
-        if (fp != INVALID_FILE_HANDLE) {
-            FileClose(fp);
-            fp = INVALID_FILE_HANDLE;
-        }
-        curHTTP.callbackPos = 0x00;
-        EndOfCallBackFileFlag = TRUE;
-        lock = 0;
-        return;
+    // Send as much as possible in blocks aligned to the file start
+    len = 1;
+    while (len != 0u && (avail = TCPIsPutReady(sktHTTP)) != 0u) {
+        len = HTTP_SEND_BLOCK_LEN - (WORD) (pos & (HTTP_SEND_BLOCK_LEN - 1));
+        if (len > avail)
+            len = avail;
+        len = FileRead(httpSendBlock, 1, len, fp);
+        TCPPutArray(sktHTTP, httpSendBlock, len);
+        pos += len;
     }
 
-    // Save the new address and close the file
-    ((DWORD_VAL*) & curHTTP.callbackPos)->w[1] = FileTell(fp);
-    if (fp != INVALID_FILE_HANDLE) {
-        FileClose(fp);
-        fp = INVALID_FILE_HANDLE;
-    }
-    EndOfCallBackFileFlag = FALSE;
+    if (len == 0u || FileEOF(fp))
+        curHTTP.callbackPos = 0x00;
+    else
+        curHTTP.callbackPos = pos + 1;
+    FileClose(fp);
 
     #else
 
@@ -0,0 +1,401 @@
+// *****************************************************************************
+// TCPIP host simulation
+// RAM card with the web pages and the MDD dynamic variable records
+// *****************************************************************************
+// FileName:        HostDisk.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The FileSystem.c calls made by the HTTP server are counted through the
+// linker (-Wl,--wrap=FileOpen,--wrap=FileOpenROM,--wrap=FileRead,--wrap=FileSeek).
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	DynIdx.bin version 2, buckets keyed by the name hash and name key
+//  2026/10/17	Paths longer than HOSTDISK_PATH_LEN fail the import
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+// FatFs has its own DIR
+#define DIR HOST_DIR
+#include <dirent.h>
+#undef DIR
+#include "HostDisk.h"
+#include "diskio.h"
+
+#define HOSTDISK_SECTOR_SIZE    512u
+#define HOSTDISK_PATH_LEN       256u
+
+// Dynamic variables of a page, as MPFSlib collects them for DynRcrd.bin
+typedef struct {
+    WORD NameHash;
+    DWORD NameKey;          // FNV-1a of the name, second key of the DynIdx.bin buckets
+    DWORD DynVarCntr;
+    DWORD *pPairs;          // Offset of the variable in the page, callback ID
+    DWORD RecordOffset;     // Position of the record in DynRcrd.bin
+} HOST_PAGE_RECORD;
+
+HOSTDISK_STATS HostDiskStats;
+extern BOOL FileSysInitLock;    // FileSystem.c
+
+static BYTE *HostDiskData;
+static char *HostPages[HOSTDISK_MAX_PAGES];
+static WORD HostPageCount;
+static char *HostVars[HOSTDISK_MAX_VARS];
+static WORD HostVarCount;
+static HOST_PAGE_RECORD HostRecords[HOSTDISK_MAX_PAGES];
+static WORD HostRecordCount;
+static char *HostSharedHash[HOSTDISK_MAX_PAGES];
+static WORD HostSharedHashCount;
+
+// File types parsed for dynamic variables (MPFSlib DynamicTypes)
+static const char *HostDynamicTypes[] = {"htm", "html", "cgi", "xml", NULL};
+
+DSTATUS disk_initialize(BYTE drv) {
+    return (drv == 0 && HostDiskData != NULL) ? 0 : STA_NOINIT;
+}
+
+DSTATUS disk_status(BYTE drv) {
+    return disk_initialize(drv);
+}
+
+DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, BYTE count) {
+    if (drv != 0 || sector + count > HOSTDISK_SECTORS)
+        return RES_PARERR;
+    HostDiskStats.DiskReads++;
+    HostDiskStats.SectorsRead += count;
+    memcpy(buff, HostDiskData + sector * HOSTDISK_SECTOR_SIZE, count * HOSTDISK_SECTOR_SIZE);
+    return RES_OK;
+}
+
+DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, BYTE count) {
+    if (drv != 0 || sector + count > HOSTDISK_SECTORS)
+        return RES_PARERR;
+    memcpy(HostDiskData + sector * HOSTDISK_SECTOR_SIZE, buff, count * HOSTDISK_SECTOR_SIZE);
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff) {
+    switch (ctrl) {
+        case CTRL_SYNC:
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *(DWORD *) buff = HOSTDISK_SECTORS;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *(WORD *) buff = HOSTDISK_SECTOR_SIZE;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *(DWORD *) buff = 1;
+            return RES_OK;
+    }
+    return RES_PARERR;
+}
+
+DWORD get_fattime(void) {
+    return ((DWORD) (2026 - 1980) << 25) | ((DWORD) 10 << 21) | ((DWORD) 17 << 16);
+}
+
+FILE_HANDLE __real_FileOpen(const char *fileName, const char *mode);
+FILE_HANDLE __real_FileOpenROM(const char *fileName, const char *mode);
+size_t __real_FileRead(void *ptr, size_t size, size_t n, FILE_HANDLE stream);
+int __real_FileSeek(FILE_HANDLE stream, long offset, int whence);
+
+FILE_HANDLE __wrap_FileOpen(const char *fileName, const char *mode) {
+    HostDiskStats.FileOpens++;
+    return __real_FileOpen(fileName, mode);
+}
+
+FILE_HANDLE __wrap_FileOpenROM(const char *fileName, const char *mode) {
+    HostDiskStats.FileOpens++;
+    return __real_FileOpenROM(fileName, mode);
+}
+
+size_t __wrap_FileRead(void *ptr, size_t size, size_t n, FILE_HANDLE stream) {
+    HostDiskStats.FileReads++;
+    return __real_FileRead(ptr, size, n, stream);
+}
+
+int __wrap_FileSeek(FILE_HANDLE stream, long offset, int whence) {
+    HostDiskStats.FileSeeks++;
+    return __real_FileSeek(stream, offset, whence);
+}
+
+static BOOL HostIsNameChar(BYTE c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// [A-Za-z0-9\ \.-_\\/] of the MPFSlib parser: '.'-'_' is a range
+static BOOL HostIsIncChar(BYTE c) {
+    return HostIsNameChar(c) || c == ' ' || (c >= '.' && c <= '_') || c == '/';
+}
+
+// ~(inc:[A-Za-z0-9\ \.-_\\/]{1,60}|[A-Za-z0-9_]{0,40}(\([A-Za-z0-9_,\ ]*\))?)~
+WORD HostDiskMatchVar(const BYTE *p, DWORD len) {
+    DWORD i, j;
+
+    if (len < 2 || p[0] != '~')
+        return 0;
+    if (len > 5 && memcmp(p + 1, "inc:", 4) == 0) {
+        for (i = 5; i < len && i < 5 + 60 && HostIsIncChar(p[i]); i++);
+        if (i > 5 && i < len && p[i] == '~')
+            return (WORD) (i + 1);
+    }
+    for (i = 1; i < len && i < 1 + 40 && HostIsNameChar(p[i]); i++);
+    if (i < len && p[i] == '(') {
+        for (j = i + 1; j < len && (HostIsNameChar(p[j]) || p[j] == ',' || p[j] == ' '); j++);
+        if (j < len && p[j] == ')')
+            i = j + 1;
+    }
+    if (i < len && p[i] == '~')
+        return (WORD) (i + 1);
+    return 0;
+}
+
+const char *HostDiskVarName(DWORD callbackID) {
+    return callbackID < HostVarCount ? HostVars[callbackID] : "";
+}
+
+WORD HostDiskPageCount(void) {
+    return HostPageCount;
+}
+
+const char *HostDiskPageName(WORD page) {
+    return page < HostPageCount ? HostPages[page] : NULL;
+}
+
+// Callback IDs are given in order of first appearance
+DWORD HostDiskVarID(const BYTE *p, WORD len) {
+    char name[64];
+    WORD i, n = 0;
+
+    for (i = 1; i + 1 < len && n < sizeof (name) - 1; i++) {
+        if (p[i] != ' ')
+            name[n++] = p[i];
+    }
+    name[n] = '\0';
+    for (i = 0; i < HostVarCount; i++) {
+        if (strcmp(HostVars[i], name) == 0)
+            return i;
+    }
+    if (HostVarCount == HOSTDISK_MAX_VARS)
+        return 0;
+    HostVars[HostVarCount] = strdup(name);
+    return HostVarCount++;
+}
+
+BOOL HostDiskIsDynamic(const char *name) {
+    const char *ext = strrchr(name, '.');
+    WORD i;
+
+    if (ext == NULL)
+        return FALSE;
+    for (i = 0; HostDynamicTypes[i] != NULL; i++) {
+        if (strcasecmp(ext + 1, HostDynamicTypes[i]) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+// Records the dynamic variables of a page, its name hashed as by MPFSlib
+// (nameHash and nameKey)
+static void HostParsePage(const char *name, const BYTE *data, DWORD len) {
+    HOST_PAGE_RECORD *pRecord;
+    const char *pChar;
+    DWORD pos;
+    WORD varLen;
+
+    if (!HostDiskIsDynamic(name) || HostRecordCount == HOSTDISK_MAX_PAGES)
+        return;
+    pRecord = &HostRecords[HostRecordCount];
+    memset(pRecord, 0, sizeof (HOST_PAGE_RECORD));
+    pRecord->NameKey = 0x811C9DC5ul;
+    for (pChar = name; *pChar; pChar++) {
+        pRecord->NameHash += (BYTE) * pChar;
+        pRecord->NameHash <<= 1;
+        pRecord->NameKey = (pRecord->NameKey ^ (BYTE) * pChar) * 0x01000193ul;
+    }
+    for (pos = 0; pos < len; pos++) {
+        if ((varLen = HostDiskMatchVar(data + pos, len - pos)) == 0u)
+            continue;
+        pRecord->pPairs = (DWORD *) realloc(pRecord->pPairs, (pRecord->DynVarCntr + 1) * 2 * sizeof (DWORD));
+        pRecord->pPairs[pRecord->DynVarCntr * 2] = pos;
+        pRecord->pPairs[pRecord->DynVarCntr * 2 + 1] = HostDiskVarID(data + pos, varLen);
+        pRecord->DynVarCntr++;
+        pos += varLen - 1;
+    }
+    if (pRecord->DynVarCntr == 0)
+        return;
+    for (pos = 0; pos < HostRecordCount; pos++) {
+        if (HostRecords[pos].NameHash == pRecord->NameHash && HostRecords[pos].NameKey == pRecord->NameKey) {
+            HostSharedHash[HostSharedHashCount++] = strdup(name);
+            break;
+        }
+    }
+    HostRecordCount++;
+}
+
+BOOL HostDiskHashShared(const char *name) {
+    WORD i;
+
+    for (i = 0; i < HostSharedHashCount; i++) {
+        if (strcmp(HostSharedHash[i], name) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static BOOL HostWriteFile(const char *name, const void *data, DWORD len) {
+    char path[HOSTDISK_PATH_LEN];
+    FIL file;
+    UINT written;
+    FRESULT result;
+
+    if (snprintf(path, sizeof (path), "%s/%s", MDD_ROOT_DIR_PATH, name) >= (int) sizeof (path) ||
+            f_open(&file, path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)
+        return FALSE;
+    result = f_write(&file, data, len, &written);
+    f_close(&file);
+    return result == FR_OK && written == len;
+}
+
+static int HostCompareNames(const void *a, const void *b) {
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+// Copies the host directory path/rel to the card, entries in name order.
+// A path that does not fit in HOSTDISK_PATH_LEN fails the import
+static BOOL HostImportDir(const char *path, const char *rel) {
+    char hostPath[HOSTDISK_PATH_LEN], name[HOSTDISK_PATH_LEN], *entries[HOSTDISK_MAX_PAGES];
+    WORD count = 0, i;
+    struct dirent *pEntry;
+    struct stat st;
+    HOST_DIR *pDir;
+    FILE *fp;
+    BYTE *data;
+    long len;
+    BOOL ok = TRUE;
+
+    if (snprintf(hostPath, sizeof (hostPath), "%s/%s", path, rel) >= (int) sizeof (hostPath) ||
+            (pDir = opendir(hostPath)) == NULL)
+        return FALSE;
+    while ((pEntry = readdir(pDir)) != NULL && count < HOSTDISK_MAX_PAGES) {
+        if (pEntry->d_name[0] != '.')
+            entries[count++] = strdup(pEntry->d_name);
+    }
+    closedir(pDir);
+    qsort(entries, count, sizeof (char *), HostCompareNames);
+
+    for (i = 0; i < count && ok; i++) {
+        if (snprintf(name, sizeof (name), "%s%s%s", rel, rel[0] ? "/" : "", entries[i]) >= (int) sizeof (name) ||
+                snprintf(hostPath, sizeof (hostPath), "%s/%s", path, name) >= (int) sizeof (hostPath) ||
+                stat(hostPath, &st) != 0) {
+            ok = FALSE;
+        } else if (S_ISDIR(st.st_mode)) {
+            ok = snprintf(hostPath, sizeof (hostPath), "%s/%s", MDD_ROOT_DIR_PATH, name) < (int) sizeof (hostPath) &&
+                    f_mkdir(hostPath) == FR_OK && HostImportDir(path, name);
+        } else if ((fp = fopen(hostPath, "rb")) == NULL || HostPageCount == HOSTDISK_MAX_PAGES) {
+            ok = FALSE;
+        } else {
+            fseek(fp, 0, SEEK_END);
+            len = ftell(fp);
+            fseek(fp, 0, SEEK_SET);
+            data = (BYTE *) malloc(len + 1);
+            ok = fread(data, 1, len, fp) == (size_t) len && HostWriteFile(name, data, len);
+            fclose(fp);
+            HostParsePage(name, data, len);
+            HostPages[HostPageCount++] = strdup(name);
+            free(data);
+        }
+        free(entries[i]);
+    }
+    for (; i < count; i++)
+        free(entries[i]);
+    return ok;
+}
+
+static void HostPutLE(BYTE *p, DWORD v, BYTE len) {
+    while (len--) {
+        *p++ = (BYTE) v;
+        v >>= 8;
+    }
+}
+
+static int HostCompareRecords(const void *a, const void *b) {
+    const HOST_PAGE_RECORD *pA = (const HOST_PAGE_RECORD *) a, *pB = (const HOST_PAGE_RECORD *) b;
+
+    if (pA->NameHash != pB->NameHash)
+        return pA->NameHash < pB->NameHash ? -1 : 1;
+    return pA->RecordOffset < pB->RecordOffset ? -1 : 1; // Keep the DynRcrd.bin order
+}
+
+// DynRcrd.bin, FileRcrd.bin and DynIdx.bin, laid out as MPFSlib MDDWriter()
+// and DynVarIndexWriter() write them
+static BOOL HostWriteRecords(void) {
+    BYTE *buf, bits = 2;
+    DWORD len = 0, size = 0, i, j;
+    WORD bucket, buckets;
+    BOOL ok;
+
+    for (i = 0; i < HostRecordCount; i++)
+        size += 4 + 2 + HostRecords[i].DynVarCntr * 8;
+    buf = (BYTE *) malloc(size + 1);
+    for (i = 0; i < HostRecordCount; i++) {
+        HostRecords[i].RecordOffset = len;
+        HostPutLE(buf + len, 4 + 2 + HostRecords[i].DynVarCntr * 8, 4);
+        HostPutLE(buf + len + 4, 0, 2);
+        len += 6;
+        for (j = 0; j < HostRecords[i].DynVarCntr * 2; j++, len += 4)
+            HostPutLE(buf + len, HostRecords[i].pPairs[j], 4);
+    }
+    ok = HostWriteFile("DynRcrd.bin", buf, len);
+    free(buf);
+
+    qsort(HostRecords, HostRecordCount, sizeof (HOST_PAGE_RECORD), HostCompareRecords);
+    buf = (BYTE *) malloc(4 + HostRecordCount * 10);
+    HostPutLE(buf, HostRecordCount, 4);
+    for (i = 0; i < HostRecordCount; i++) {
+        HostPutLE(buf + 4 + i * 10, HostRecords[i].NameHash, 2);
+        HostPutLE(buf + 4 + i * 10 + 2, HostRecords[i].RecordOffset, 4);
+        HostPutLE(buf + 4 + i * 10 + 6, HostRecords[i].DynVarCntr, 4);
+    }
+    ok = ok && HostWriteFile("FileRcrd.bin", buf, 4 + HostRecordCount * 10);
+    free(buf);
+
+    while ((1u << bits) < HostRecordCount * 2u && bits < 15)
+        bits++;
+    buckets = 1u << bits;
+    buf = (BYTE *) calloc(8 + buckets * 12, 1);
+    memcpy(buf, "DVIX", 4);
+    buf[4] = 2;
+    buf[5] = bits;
+    HostPutLE(buf + 6, HostRecordCount, 2);
+    for (i = 0; i < HostRecordCount; i++) {
+        bucket = (WORD) ((WORD) (HostRecords[i].NameHash * 0x9E37u) >> (16 - bits));
+        while (buf[8 + bucket * 12 + 2] | buf[8 + bucket * 12 + 3])
+            bucket = (bucket + 1) & (buckets - 1);
+        HostPutLE(buf + 8 + bucket * 12, HostRecords[i].NameHash, 2);
+        HostPutLE(buf + 8 + bucket * 12 + 2, HostRecords[i].DynVarCntr, 2);
+        HostPutLE(buf + 8 + bucket * 12 + 4, HostRecords[i].RecordOffset + 4 + 2, 4);
+        HostPutLE(buf + 8 + bucket * 12 + 8, HostRecords[i].NameKey, 4);
+    }
+    ok = ok && HostWriteFile("DynIdx.bin", buf, 8 + buckets * 12);
+    free(buf);
+    return ok;
+}
+
+BOOL HostDiskCreate(const char *path) {
+    if (HostDiskData == NULL)
+        HostDiskData = (BYTE *) calloc(HOSTDISK_SECTORS, HOSTDISK_SECTOR_SIZE);
+
+    // Mounts the card as the server will find it, then formats it
+    FileCheckMedia();
+    if (!FileSysInitLock || f_mkfs(0, 1, 0) != FR_OK || f_mkdir(MDD_ROOT_DIR_PATH) != FR_OK)
+        return FALSE;
+    return HostImportDir(path, "") && HostWriteRecords();
+}
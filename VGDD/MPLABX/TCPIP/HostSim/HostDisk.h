@@ -0,0 +1,63 @@
+// *****************************************************************************
+// TCPIP host simulation
+// RAM card with the web pages and the MDD dynamic variable records
+// *****************************************************************************
+// FileName:        HostDisk.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The card is a RAM disk behind the FatFs disk_* functions. HostDiskCreate()
+// formats it, copies a WebPages tree from the host into MDD_ROOT_DIR_PATH and
+// writes FileRcrd.bin, DynRcrd.bin and DynIdx.bin as MPFSlib does for the
+// MDD targets, so HTTP2_MDD.c serves the pages as it would from the SD card.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _HOSTDISK_H
+#define _HOSTDISK_H
+
+#include "TCPIP Stack/TCPIP.h"
+
+#define HOSTDISK_SECTORS        16384u  // 8 MB card
+#define HOSTDISK_MAX_PAGES      256u
+#define HOSTDISK_MAX_VARS       256u
+
+typedef struct {
+    DWORD DiskReads;        // disk_read calls
+    DWORD SectorsRead;
+    DWORD FileOpens;        // FileOpen calls made by the HTTP server
+    DWORD FileReads;        // FileRead calls made by the HTTP server
+    DWORD FileSeeks;        // FileSeek calls made by the HTTP server
+} HOSTDISK_STATS;
+
+extern HOSTDISK_STATS HostDiskStats;
+
+// Builds the card from the WebPages tree at path, FALSE on errors
+BOOL HostDiskCreate(const char *path);
+
+// Pages copied to the card, as paths relative to MDD_ROOT_DIR_PATH
+WORD HostDiskPageCount(void);
+const char *HostDiskPageName(WORD page);
+
+// TRUE if the dynamic variables of a page cannot be served because another
+// page with variables has the same name hash and name key (the first one gets
+// the records)
+BOOL HostDiskHashShared(const char *name);
+
+// TRUE for the file types parsed for dynamic variables
+BOOL HostDiskIsDynamic(const char *name);
+
+// Length of the dynamic variable (~name~) starting at p, 0 if there is none,
+// as matched by the MPFSlib parser
+WORD HostDiskMatchVar(const BYTE *p, DWORD len);
+
+// Callback ID of the dynamic variable of length len starting at p
+DWORD HostDiskVarID(const BYTE *p, WORD len);
+
+// Dynamic variable name of a callback ID, without the '~' delimiters
+const char *HostDiskVarName(DWORD callbackID);
+
+#endif
@@ -0,0 +1,294 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Replay of a WebPages tree through the MDD HTTP server
+// *****************************************************************************
+// FileName:        HostHttp.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Copies a WebPages tree to the RAM card of HostDisk.c, then requests every
+// page from HTTP2_MDD.c through a loopback socket (see HostTcp.h), calling
+// HTTPServer() and draining the TX FIFO in turn as the main loop and the
+// network would on the target.
+//
+// The dynamic variable callbacks print "$" and their callback ID, ~inc:file~
+// goes through HTTPIncFile() and ~~ prints '~'. Every response body is
+// checked against the page expanded the same way; a mismatch makes the tool
+// exit with 2. Pages sharing both the name hash and the name key of an earlier
+// page with dynamic variables fail as "hash": the server cannot tell their
+// records apart.
+//
+// For each page it reports the bytes sent, and per request the HTTPServer()
+// calls, TCP put calls, FileRead calls, disk reads and sectors read and
+// dynamic variable callbacks, then the overall throughput.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -I../../SD -I../.. -o HostHttp HostHttp.c HostTcp.c HostDisk.c ../HTTP2_MDD.c ../../SD/FileSystem.c ../../SD/ff.c ../../SD/ccsbcs.c -Wl,--wrap=FileOpen,--wrap=FileOpenROM,--wrap=FileRead,--wrap=FileSeek
+//
+// Usage:
+//   HostHttp [-t txFifoSize] [-n repeat] [webPagesPath]
+//     -t  TX FIFO size of the socket (default 1024, at least HTTP_MIN_TX_FIFO:
+//         the server writes the response headers without checking the space)
+//     -n  number of times every page is requested for the throughput (default 20)
+//     webPagesPath  default ../WebPages
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HostTcp.h"
+#include "HostDisk.h"
+
+#define HTTP_MAX_SERVER_CALLS   1000000ul   // HTTPServer() calls allowed to serve a page
+#define HTTP_SOCKET             0u          // Loopback socket used for the requests
+#define HTTP_MIN_TX_FIFO        256u
+
+typedef struct {
+    DWORD Bytes;
+    DWORD ServerCalls;
+    DWORD Callbacks;
+    HOSTTCP_STATS Tcp;
+    HOSTDISK_STATS Disk;
+} HTTP_RESULT;
+
+static const char *HttpPath = "../WebPages";
+static DWORD HttpCallbacks;
+
+// Dynamic variable callbacks of the replayed pages
+void HTTPPrint(DWORD callbackID) {
+    const char *name = HostDiskVarName(callbackID);
+    char text[16];
+
+    if (curHTTP.callbackPos == 0u)
+        HttpCallbacks++;
+    if (strncmp(name, "inc:", 4) == 0) {
+        HTTPIncFile((ROM BYTE *) name + 4);
+    } else if (name[0] == '\0') {
+        TCPPut(sktHTTP, '~');
+    } else {
+        sprintf(text, "$%lu", (unsigned long) callbackID);
+        TCPPutString(sktHTTP, (BYTE *) text);
+    }
+}
+
+HTTP_IO_RESULT HTTPExecuteGet(void) {
+    return HTTP_IO_DONE;
+}
+
+HTTP_IO_RESULT HTTPExecutePost(void) {
+    return HTTP_IO_DONE;
+}
+
+HTTP_IO_RESULT HTTPPostUpload(void) {
+    return HTTP_IO_DONE;
+}
+
+BYTE HTTPNeedsAuth(BYTE *cFile) {
+    return 0x80;
+}
+
+BYTE HTTPCheckAuth(BYTE *cUser, BYTE *cPass) {
+    return 0x80;
+}
+
+static BYTE *HttpLoad(const char *name, DWORD *pLen) {
+    char path[512];
+    BYTE *data;
+    FILE *fp;
+    long len;
+
+    snprintf(path, sizeof (path), "%s/%s", HttpPath, name);
+    if ((fp = fopen(path, "rb")) == NULL)
+        return NULL;
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data = (BYTE *) malloc(len + 1);
+    *pLen = (DWORD) fread(data, 1, len, fp);
+    fclose(fp);
+    return data;
+}
+
+// Body the server must send for a page: the dynamic variables replaced by the
+// output of HTTPPrint()
+static BYTE *HttpExpected(WORD page, DWORD *pLen) {
+    const char *name = HostDiskPageName(page), *var;
+    BYTE *data, *inc, *out;
+    DWORD len, incLen, outLen = 0, pos;
+    char text[16];
+    WORD varLen;
+
+    if ((data = HttpLoad(name, &len)) == NULL)
+        return NULL;
+    out = (BYTE *) malloc(len + 1);
+    for (pos = 0; pos < len; pos += varLen) {
+        varLen = HostDiskIsDynamic(name) ? HostDiskMatchVar(data + pos, len - pos) : 0;
+        if (varLen == 0u) {
+            out[outLen++] = data[pos++];
+            continue;
+        }
+        var = HostDiskVarName(HostDiskVarID(data + pos, varLen));
+        inc = NULL;
+        if (strncmp(var, "inc:", 4) == 0) {
+            if ((inc = HttpLoad(var + 4, &incLen)) == NULL)
+                incLen = 0;
+        } else {
+            if (var[0] == '\0')
+                strcpy(text, "~");
+            else
+                sprintf(text, "$%lu", (unsigned long) HostDiskVarID(data + pos, varLen));
+            incLen = (DWORD) strlen(text);
+        }
+        out = (BYTE *) realloc(out, outLen + incLen + len - pos + 1);
+        memcpy(out + outLen, inc ? inc : (BYTE *) text, incLen);
+        outLen += incLen;
+        free(inc);
+    }
+    free(data);
+    *pLen = outLen;
+    return out;
+}
+
+// Serves one request, counting what it cost
+static BOOL HttpRequest(const char *name, HTTP_RESULT *pResult) {
+    char request[300];
+    DWORD calls = 0;
+
+    snprintf(request, sizeof (request), "GET /%s HTTP/1.1\r\nHost: hostsim\r\n\r\n", name);
+    HostTcpStats = (HOSTTCP_STATS) {0};
+    HostDiskStats = (HOSTDISK_STATS) {0};
+    HttpCallbacks = 0;
+    if (!HostTcpConnect(HTTP_SOCKET, request))
+        return FALSE;
+    while (!HostTcpClosed(HTTP_SOCKET) && calls < HTTP_MAX_SERVER_CALLS) {
+        HTTPServer();
+        HostTcpDrain();
+        calls++;
+    }
+    pResult->ServerCalls += calls;
+    pResult->Callbacks += HttpCallbacks;
+    pResult->Tcp.PutCalls += HostTcpStats.PutCalls;
+    pResult->Tcp.PutBytes += HostTcpStats.PutBytes;
+    pResult->Tcp.FullFifo += HostTcpStats.FullFifo;
+    pResult->Disk.DiskReads += HostDiskStats.DiskReads;
+    pResult->Disk.SectorsRead += HostDiskStats.SectorsRead;
+    pResult->Disk.FileOpens += HostDiskStats.FileOpens;
+    pResult->Disk.FileReads += HostDiskStats.FileReads;
+    pResult->Disk.FileSeeks += HostDiskStats.FileSeeks;
+
+    // Let the server see the reset, as it would before the next connection
+    HTTPServer();
+    return HostTcpClosed(HTTP_SOCKET);
+}
+
+// TRUE if the body of the last response is the expected one
+static BOOL HttpCheck(WORD page, DWORD *pBodyLen) {
+    const BYTE *resp, *body;
+    BYTE *expected;
+    DWORD len, expectedLen, i;
+    BOOL ok;
+
+    resp = HostTcpResponse(HTTP_SOCKET, &len);
+    for (i = 0; i + 4 <= len && memcmp(resp + i, "\r\n\r\n", 4) != 0; i++);
+    if (i + 4 > len || (expected = HttpExpected(page, &expectedLen)) == NULL)
+        return FALSE;
+    body = resp + i + 4;
+    *pBodyLen = len - (DWORD) (body - resp);
+    ok = *pBodyLen == expectedLen && memcmp(body, expected, expectedLen) == 0;
+    free(expected);
+    return ok;
+}
+
+static void HttpPrintHeader(void) {
+    printf("  %-28s %8s %8s | %7s %7s %6s %6s %6s %6s %6s | %s\n",
+            "Page", "Bytes", "Body", "Server", "Put", "Full", "Read", "Disk", "Sect", "Cbk", "Check");
+}
+
+static void HttpPrint(const char *label, DWORD bytes, DWORD body, HTTP_RESULT *pResult, DWORD n, const char *check) {
+    printf("  %-28s %8lu %8lu | %7lu %7lu %6lu %6lu %6lu %6lu %6lu | %s\n",
+            label, (unsigned long) bytes, (unsigned long) body,
+            (unsigned long) (pResult->ServerCalls / n),
+            (unsigned long) (pResult->Tcp.PutCalls / n),
+            (unsigned long) (pResult->Tcp.FullFifo / n),
+            (unsigned long) (pResult->Disk.FileReads / n),
+            (unsigned long) (pResult->Disk.DiskReads / n),
+            (unsigned long) (pResult->Disk.SectorsRead / n),
+            (unsigned long) (pResult->Callbacks / n),
+            check);
+}
+
+int main(int argc, char **argv) {
+    HTTP_RESULT result, total;
+    DWORD repeat = 20, bytes, body, i, totalBytes = 0, totalBody = 0;
+    WORD page, failures = 0;
+    const char *check;
+    clock_t start;
+    double seconds;
+    BOOL ok;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-t") == 0 && a < argc - 1)
+            HostTcpTxSize = (WORD) atoi(argv[++a]);
+        else if (strcmp(argv[a], "-n") == 0 && a < argc - 1)
+            repeat = (DWORD) atol(argv[++a]);
+        else
+            HttpPath = argv[a];
+    }
+    if (repeat == 0)
+        repeat = 1;
+    if (HostTcpTxSize < HTTP_MIN_TX_FIFO)
+        HostTcpTxSize = HTTP_MIN_TX_FIFO;
+
+    if (!HostDiskCreate(HttpPath)) {
+        fprintf(stderr, "Cannot copy %s to the card\n", HttpPath);
+        return 1;
+    }
+    HTTPInit();
+
+    printf("TX FIFO %u bytes, per request averages\n", HostTcpTxSize);
+    HttpPrintHeader();
+    memset(&total, 0, sizeof (total));
+    for (page = 0; page < HostDiskPageCount(); page++) {
+        memset(&result, 0, sizeof (result));
+        ok = HttpRequest(HostDiskPageName(page), &result);
+        HostTcpResponse(HTTP_SOCKET, &bytes);
+        body = 0;
+        ok = ok && HttpCheck(page, &body);
+        if (HostDiskHashShared(HostDiskPageName(page)))
+            check = "hash";
+        else
+            check = ok ? "ok" : "MISMATCH";
+        failures += check[0] != 'o';
+        HttpPrint(HostDiskPageName(page), bytes, body, &result, 1, check);
+        totalBytes += bytes;
+        totalBody += body;
+        total.ServerCalls += result.ServerCalls;
+        total.Callbacks += result.Callbacks;
+        total.Tcp.PutCalls += result.Tcp.PutCalls;
+        total.Tcp.FullFifo += result.Tcp.FullFifo;
+        total.Disk.FileReads += result.Disk.FileReads;
+        total.Disk.DiskReads += result.Disk.DiskReads;
+        total.Disk.SectorsRead += result.Disk.SectorsRead;
+    }
+    HttpPrint("All pages", totalBytes, totalBody, &total, 1, failures ? "MISMATCH" : "ok");
+
+    // Throughput of the server code, card and socket stand-ins included
+    memset(&result, 0, sizeof (result));
+    start = clock();
+    for (i = 0; i < repeat; i++) {
+        for (page = 0; page < HostDiskPageCount(); page++)
+            HttpRequest(HostDiskPageName(page), &result);
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%lu requests, %lu bytes in %.3f s: %.0f requests/s, %.0f bytes/s\n",
+            (unsigned long) (repeat * HostDiskPageCount()), (unsigned long) result.Tcp.PutBytes, seconds,
+            seconds > 0 ? repeat * HostDiskPageCount() / seconds : 0.0,
+            seconds > 0 ? result.Tcp.PutBytes / seconds : 0.0);
+    return failures ? 2 : 0;
+}
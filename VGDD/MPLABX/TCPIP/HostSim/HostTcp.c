@@ -0,0 +1,312 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Loopback TCP sockets, MAC buffer RAM, tick and stack helpers
+// *****************************************************************************
+// FileName:        HostTcp.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "HostTcp.h"
+
+typedef struct {
+    BOOL Open;
+    BOOL Closed;            // TCPDisconnect called, response complete
+    BOOL Reset;             // Reported once by TCPWasReset
+    BYTE Rx[HOSTTCP_RX_SIZE];
+    WORD RxHead, RxLen;
+    WORD TxUsed;            // Bytes in the TX FIFO, not drained yet
+    BYTE *pResp;
+    DWORD RespLen, RespSize;
+} HOST_SOCKET;
+
+HOSTTCP_STATS HostTcpStats;
+WORD HostTcpTxSize = 1024;
+
+static HOST_SOCKET HostSockets[MAX_HTTP_CONNECTIONS];
+static BYTE HostMacRam[MAX_HTTP_CONNECTIONS * sizeof (HTTP_CONN)];
+static PTR_BASE HostMacReadPtr, HostMacWritePtr;
+static DWORD HostTick;
+
+static HOST_SOCKET *HostSocket(TCP_SOCKET hTCP) {
+    if (hTCP >= MAX_HTTP_CONNECTIONS || !HostSockets[hTCP].Open)
+        return NULL;
+    return &HostSockets[hTCP];
+}
+
+// Appends len bytes to the response capture, as far as the TX FIFO allows
+static WORD HostPut(HOST_SOCKET *pSkt, const BYTE *data, WORD len) {
+    WORD room = pSkt->Closed ? 0 : HostTcpTxSize - pSkt->TxUsed;
+
+    if (len > room)
+        len = room;
+    if (pSkt->RespLen + len > pSkt->RespSize) {
+        pSkt->RespSize = (pSkt->RespLen + len) * 2;
+        pSkt->pResp = (BYTE *) realloc(pSkt->pResp, pSkt->RespSize);
+    }
+    memcpy(pSkt->pResp + pSkt->RespLen, data, len);
+    pSkt->RespLen += len;
+    pSkt->TxUsed += len;
+    HostTcpStats.PutBytes += len;
+    return len;
+}
+
+BOOL HostTcpConnect(TCP_SOCKET hTCP, const char *request) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+    WORD len = (WORD) strlen(request);
+
+    if (pSkt == NULL || len > HOSTTCP_RX_SIZE)
+        return FALSE;
+    memcpy(pSkt->Rx, request, len);
+    pSkt->RxHead = 0;
+    pSkt->RxLen = len;
+    pSkt->TxUsed = 0;
+    pSkt->RespLen = 0;
+    pSkt->Closed = FALSE;
+    return TRUE;
+}
+
+void HostTcpDrain(void) {
+    BYTE i;
+
+    for (i = 0; i < MAX_HTTP_CONNECTIONS; i++)
+        HostSockets[i].TxUsed = 0;
+}
+
+BOOL HostTcpClosed(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    return pSkt == NULL || pSkt->Closed;
+}
+
+const BYTE *HostTcpResponse(TCP_SOCKET hTCP, DWORD *pLen) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    *pLen = pSkt ? pSkt->RespLen : 0;
+    return pSkt ? pSkt->pResp : NULL;
+}
+
+// Tick: one millisecond per call, so the HTTP timeouts never expire while a
+// request is replayed
+DWORD TickGet(void) {
+    return ++HostTick;
+}
+
+TCP_SOCKET TCPOpen(DWORD dwRemoteHost, BYTE vRemoteHostType, WORD wPort, BYTE vSocketPurpose) {
+    BYTE i;
+
+    for (i = 0; i < MAX_HTTP_CONNECTIONS; i++) {
+        if (!HostSockets[i].Open) {
+            memset(&HostSockets[i], 0, sizeof (HOST_SOCKET));
+            HostSockets[i].Open = TRUE;
+            HostSockets[i].Closed = TRUE;
+            return i;
+        }
+    }
+    return INVALID_SOCKET;
+}
+
+BOOL TCPWasReset(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+    BOOL reset;
+
+    if (pSkt == NULL)
+        return TRUE;
+    reset = pSkt->Reset;
+    pSkt->Reset = FALSE;
+    return reset;
+}
+
+void TCPDisconnect(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    if (pSkt == NULL)
+        return;
+    pSkt->Closed = TRUE;
+    pSkt->Reset = TRUE;
+    pSkt->RxHead = pSkt->RxLen = 0;
+}
+
+BOOL TCPAdjustFIFOSize(TCP_SOCKET hTCP, WORD wMinRXSize, WORD wMinTXSize, BYTE vFlags) {
+    return TRUE;
+}
+
+WORD TCPIsPutReady(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+    WORD room;
+
+    if (pSkt == NULL || pSkt->Closed)
+        return 0;
+    room = HostTcpTxSize - pSkt->TxUsed;
+    if (room == 0u)
+        HostTcpStats.FullFifo++;
+    return room;
+}
+
+BOOL TCPPut(TCP_SOCKET hTCP, BYTE byte) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    HostTcpStats.PutCalls++;
+    return pSkt != NULL && HostPut(pSkt, &byte, 1) == 1u;
+}
+
+WORD TCPPutArray(TCP_SOCKET hTCP, BYTE *Data, WORD Len) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    HostTcpStats.PutCalls++;
+    return pSkt ? HostPut(pSkt, Data, Len) : 0;
+}
+
+BYTE *TCPPutString(TCP_SOCKET hTCP, BYTE *Data) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    HostTcpStats.PutCalls++;
+    if (pSkt != NULL)
+        Data += HostPut(pSkt, Data, (WORD) strlen((char *) Data));
+    return Data;
+}
+
+void TCPFlush(TCP_SOCKET hTCP) {
+    HostTcpStats.FlushCalls++;
+}
+
+WORD TCPIsGetReady(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    return pSkt ? pSkt->RxLen - pSkt->RxHead : 0;
+}
+
+WORD TCPGetRxFIFOFree(TCP_SOCKET hTCP) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    return pSkt ? HOSTTCP_RX_SIZE - (pSkt->RxLen - pSkt->RxHead) : 0;
+}
+
+BOOL TCPGet(TCP_SOCKET hTCP, BYTE *byte) {
+    return TCPGetArray(hTCP, byte, 1) == 1u;
+}
+
+WORD TCPGetArray(TCP_SOCKET hTCP, BYTE *buffer, WORD count) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+
+    if (pSkt == NULL)
+        return 0;
+    if (count > pSkt->RxLen - pSkt->RxHead)
+        count = pSkt->RxLen - pSkt->RxHead;
+    if (buffer != NULL)
+        memcpy(buffer, pSkt->Rx + pSkt->RxHead, count);
+    pSkt->RxHead += count;
+    return count;
+}
+
+WORD TCPDiscard(TCP_SOCKET hTCP) {
+    return TCPGetArray(hTCP, NULL, TCPIsGetReady(hTCP));
+}
+
+// Offset of the first match starting from wStart and within wSearchLen bytes
+// (0 = the whole FIFO), 0xFFFF if not found
+WORD TCPFindArrayEx(TCP_SOCKET hTCP, BYTE *cFindArray, WORD wLen, WORD wStart, WORD wSearchLen, BOOL bTextCompare) {
+    HOST_SOCKET *pSkt = HostSocket(hTCP);
+    WORD ready, pos, i;
+    BYTE *p;
+
+    if (pSkt == NULL || wLen == 0u)
+        return 0xFFFF;
+    ready = pSkt->RxLen - pSkt->RxHead;
+    p = pSkt->Rx + pSkt->RxHead;
+    for (pos = wStart; pos + wLen <= ready && (wSearchLen == 0u || pos < wStart + wSearchLen); pos++) {
+        for (i = 0; i < wLen; i++) {
+            if (bTextCompare ? tolower(p[pos + i]) != tolower(cFindArray[i]) : p[pos + i] != cFindArray[i])
+                break;
+        }
+        if (i == wLen)
+            return pos;
+    }
+    return 0xFFFF;
+}
+
+WORD TCPFindEx(TCP_SOCKET hTCP, BYTE cFind, WORD wStart, WORD wSearchLen, BOOL bTextCompare) {
+    return TCPFindArrayEx(hTCP, &cFind, 1, wStart, wSearchLen, bTextCompare);
+}
+
+PTR_BASE MACSetWritePtr(PTR_BASE address) {
+    PTR_BASE old = HostMacWritePtr;
+
+    HostMacWritePtr = address;
+    return old;
+}
+
+PTR_BASE MACSetReadPtr(PTR_BASE address) {
+    PTR_BASE old = HostMacReadPtr;
+
+    HostMacReadPtr = address;
+    return old;
+}
+
+void MACPutArray(BYTE *val, WORD len) {
+    if (HostMacWritePtr + len <= sizeof (HostMacRam))
+        memcpy(HostMacRam + HostMacWritePtr, val, len);
+    HostMacWritePtr += len;
+}
+
+WORD MACGetArray(BYTE *val, WORD len) {
+    if (HostMacReadPtr + len <= sizeof (HostMacRam) && val != NULL)
+        memcpy(val, HostMacRam + HostMacReadPtr, len);
+    HostMacReadPtr += len;
+    return len;
+}
+
+static BYTE HostBase64Value(BYTE c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return 0xFF;
+}
+
+WORD Base64Decode(BYTE *cSourceData, WORD wSourceLen, BYTE *cDestData, WORD wDestLen) {
+    DWORD acc = 0;
+    BYTE bits = 0, v;
+    WORD len = 0;
+
+    while (wSourceLen--) {
+        v = HostBase64Value(*cSourceData++);
+        if (v == 0xFF)
+            continue;
+        acc = (acc << 6) | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (len == wDestLen)
+                break;
+            cDestData[len++] = (BYTE) (acc >> bits);
+        }
+    }
+    return len;
+}
+
+BYTE btohexa_high(BYTE b) {
+    b >>= 4;
+    return (b > 9u) ? b + 'A' - 10 : b + '0';
+}
+
+BYTE btohexa_low(BYTE b) {
+    b &= 0x0F;
+    return (b > 9u) ? b + 'A' - 10 : b + '0';
+}
+
+BYTE hexatob(WORD_VAL AsciiChars) {
+    BYTE hi = AsciiChars.v[0], lo = AsciiChars.v[1];
+
+    hi = (hi <= '9') ? hi - '0' : (hi & 0x0F) + 9;
+    lo = (lo <= '9') ? lo - '0' : (lo & 0x0F) + 9;
+    return (hi << 4) | lo;
+}
@@ -0,0 +1,49 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Loopback TCP sockets and call counters
+// *****************************************************************************
+// FileName:        HostTcp.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Every socket opened by the HTTP server is a loopback: the request is loaded
+// in its RX FIFO by HostTcpConnect(), the server writes the response in a TX
+// FIFO of HostTcpTxSize bytes, and HostTcpDrain() empties that FIFO into the
+// captured response, as the remote end acknowledging the data would.
+// So the server sees a full TX FIFO as often as it would on the target.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _HOSTTCP_H
+#define _HOSTTCP_H
+
+#include "TCPIP Stack/TCPIP.h"
+
+#define HOSTTCP_RX_SIZE     1024u   // RX FIFO of each socket
+
+typedef struct {
+    DWORD PutCalls;         // TCPPut, TCPPutArray and TCPPutString calls
+    DWORD PutBytes;         // Bytes put in the TX FIFOs
+    DWORD FullFifo;         // TCPIsPutReady calls that found the TX FIFO full
+    DWORD FlushCalls;
+} HOSTTCP_STATS;
+
+extern HOSTTCP_STATS HostTcpStats;
+extern WORD HostTcpTxSize;  // TX FIFO size, default 1024
+
+// Loads request in the RX FIFO of hTCP and starts a new response capture
+BOOL HostTcpConnect(TCP_SOCKET hTCP, const char *request);
+
+// Moves what the server wrote in the TX FIFOs to the response captures
+void HostTcpDrain(void);
+
+// TRUE once the server has called TCPDisconnect
+BOOL HostTcpClosed(TCP_SOCKET hTCP);
+
+// Response captured since the last HostTcpConnect
+const BYTE *HostTcpResponse(TCP_SOCKET hTCP, DWORD *pLen);
+
+#endif
@@ -0,0 +1,42 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Stand-in for Microchip's Compiler.h
+// *****************************************************************************
+// FileName:        Compiler.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// On the host, as on PIC32, ROM data is ordinary const data and the pgm
+// string functions are the standard ones.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef __COMPILER_H
+#define __COMPILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "GenericTypeDefs.h"
+
+#define ROM                     const
+#define PTR_BASE                uintptr_t
+#define ROM_PTR_BASE            uintptr_t
+
+#define memcmppgm2ram(a, b, c)  memcmp(a, b, c)
+#define memcpypgm2ram(a, b, c)  memcpy(a, b, c)
+#define strcpypgm2ram(a, b)     strcpy((char *) (a), (const char *) (b))
+#define strcmppgm2ram(a, b)     strcmp((const char *) (a), (const char *) (b))
+#define stricmppgm2ram(a, b)    strcasecmp((const char *) (a), (const char *) (b))
+#define strlenpgm(a)            strlen((const char *) (a))
+#define strchrpgm               strchr
+#define strstrrampgm(a, b)      strstr((const char *) (a), (const char *) (b))
+
+#define Nop()
+#define ClrWdt()
+
+#endif
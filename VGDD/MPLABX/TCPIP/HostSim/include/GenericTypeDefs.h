@@ -0,0 +1,61 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Stand-in for Microchip's GenericTypeDefs.h
+// *****************************************************************************
+// FileName:        GenericTypeDefs.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Only the types used by HTTP2_MDD.c, FileSystem.c and FatFs are defined
+// here, with the same widths they have on PIC24/PIC32.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GENERICTYPEDEFS_H_
+#define _GENERICTYPEDEFS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum _BOOL { FALSE = 0, TRUE } BOOL;
+
+typedef unsigned char   BYTE;
+typedef unsigned short  WORD;
+typedef uint32_t        DWORD;
+typedef uint64_t        QWORD;
+typedef signed char     CHAR;
+typedef signed short    SHORT;
+typedef int32_t         LONG;
+
+typedef int8_t          INT8;
+typedef int16_t         INT16;
+typedef int32_t         INT32;
+typedef uint8_t         UINT8;
+typedef uint16_t        UINT16;
+typedef uint32_t        UINT32;
+typedef unsigned int    UINT;
+typedef int             INT;
+
+typedef union {
+    WORD Val;
+    BYTE v[2];
+    struct {
+        BYTE LB;
+        BYTE HB;
+    } byte;
+} WORD_VAL;
+
+typedef union {
+    DWORD Val;
+    WORD w[2];
+    BYTE v[4];
+    struct {
+        WORD LW;
+        WORD HW;
+    } word;
+} DWORD_VAL;
+
+#endif // _GENERICTYPEDEFS_H_
@@ -0,0 +1,27 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Stand-in for the board HardwareProfile.h
+// *****************************************************************************
+// FileName:        HardwareProfile.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// HTTP2_MDD.c is built with the MDD server code paths on top of FatFs, as on
+// the boards, and the card is the RAM disk of HostDisk.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef HARDWARE_PROFILE_H
+#define HARDWARE_PROFILE_H
+
+#include "GenericTypeDefs.h"
+
+#define STACK_USE_MDD
+#define STACK_USE_FATFS
+
+#define SD_CD                   0   // Card always present
+
+#endif
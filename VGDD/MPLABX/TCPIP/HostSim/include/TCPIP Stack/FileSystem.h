@@ -0,0 +1,2 @@
+// Stand-in: the real FileSystem.h of VGDD/MPLABX/SD
+#include "../../../../SD/FileSystem.h"
@@ -0,0 +1,90 @@
+// *****************************************************************************
+// TCPIP host simulation
+// Stand-in for the Microchip TCP/IP Stack TCPIP.h
+// *****************************************************************************
+// FileName:        TCPIP.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Declares the part of the stack HTTP2_MDD.c uses. The TCP sockets, the MAC
+// buffer where the HTTP connections are swapped and the tick are implemented
+// by HostTcp.c; the configuration is the real TCPIPConfig.h.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef __TCPIP_HITECH_WORKAROUND_H
+#define __TCPIP_HITECH_WORKAROUND_H
+
+#include "HardwareProfile.h"
+#include "Compiler.h"
+#include "../../../TCPIPConfig.h"
+
+typedef BYTE TCP_SOCKET;
+#define INVALID_SOCKET          (0xFE)
+
+#define TCP_OPEN_SERVER         0u
+#define TCP_ADJUST_GIVE_REST_TO_RX  0x01u
+#define TCP_ADJUST_GIVE_REST_TO_TX  0x02u
+#define TCP_ADJUST_PRESERVE_RX      0x04u
+#define TCP_ADJUST_PRESERVE_TX      0x08u
+
+// Tick
+typedef DWORD TICK;
+#define TICK_SECOND             1000ul
+DWORD TickGet(void);
+
+// TCP
+TCP_SOCKET TCPOpen(DWORD dwRemoteHost, BYTE vRemoteHostType, WORD wPort, BYTE vSocketPurpose);
+BOOL TCPWasReset(TCP_SOCKET hTCP);
+void TCPDisconnect(TCP_SOCKET hTCP);
+BOOL TCPAdjustFIFOSize(TCP_SOCKET hTCP, WORD wMinRXSize, WORD wMinTXSize, BYTE vFlags);
+WORD TCPIsPutReady(TCP_SOCKET hTCP);
+BOOL TCPPut(TCP_SOCKET hTCP, BYTE byte);
+WORD TCPPutArray(TCP_SOCKET hTCP, BYTE *Data, WORD Len);
+BYTE *TCPPutString(TCP_SOCKET hTCP, BYTE *Data);
+#define TCPPutROMArray(s, d, l)     TCPPutArray(s, (BYTE *) (d), l)
+#define TCPPutROMString(s, d)       ((ROM BYTE *) TCPPutString(s, (BYTE *) (d)))
+void TCPFlush(TCP_SOCKET hTCP);
+WORD TCPIsGetReady(TCP_SOCKET hTCP);
+BOOL TCPGet(TCP_SOCKET hTCP, BYTE *byte);
+WORD TCPGetArray(TCP_SOCKET hTCP, BYTE *buffer, WORD count);
+WORD TCPFindArrayEx(TCP_SOCKET hTCP, BYTE *cFindArray, WORD wLen, WORD wStart, WORD wSearchLen, BOOL bTextCompare);
+WORD TCPFindEx(TCP_SOCKET hTCP, BYTE cFind, WORD wStart, WORD wSearchLen, BOOL bTextCompare);
+#define TCPFind(a, b, c, d)                 TCPFindEx(a, b, c, 0, d)
+#define TCPFindArray(a, b, c, d, e)         TCPFindArrayEx(a, b, c, d, 0, e)
+#define TCPFindROMArrayEx(a, b, c, d, e, f) TCPFindArrayEx(a, (BYTE *) (b), c, d, e, f)
+#define TCPFindROMArray(a, b, c, d, e)      TCPFindArrayEx(a, (BYTE *) (b), c, d, 0, e)
+
+// MAC buffer RAM holding the HTTP connections that are not loaded
+#define BASE_HTTPB_ADDR         0u
+PTR_BASE MACSetWritePtr(PTR_BASE address);
+PTR_BASE MACSetReadPtr(PTR_BASE address);
+void MACPutArray(BYTE *val, WORD len);
+WORD MACGetArray(BYTE *val, WORD len);
+
+WORD TCPGetRxFIFOFree(TCP_SOCKET hTCP);
+WORD TCPDiscard(TCP_SOCKET hTCP);
+
+// Helpers
+WORD Base64Decode(BYTE *cSourceData, WORD wSourceLen, BYTE *cDestData, WORD wDestLen);
+BYTE btohexa_high(BYTE b);
+BYTE btohexa_low(BYTE b);
+BYTE hexatob(WORD_VAL AsciiChars);
+
+// The dynamic variable callbacks are resolved by HostHttp.c from the records
+// it generates, instead of the HTTPPrint.h generated for the demo pages
+#define __HTTPPRINT_H
+void HTTPPrint(DWORD callbackID);
+
+#if defined(STACK_USE_HTTP2_SERVER)
+    #include "TCPIP Stack/FileSystem.h"
+    #include "TCPIP Stack/_HTTP2.h"
+
+    // Declared by CustomHTTPApp.c only
+    HTTP_IO_RESULT HTTPPostUpload(void);
+#endif
+
+#endif
@@ -0,0 +1,2 @@
+// Stand-in: the real _HTTP2.h of VGDD/MPLABX/TCPIP
+#include "../../../_HTTP2.h"
@@ -49,6 +49,7 @@
  * Nilesh Rajbharti     8/14/01 Original
  * Elliott Wood			6/4/07	Complete rewrite (known as HTTP2)
  * Amit Shirbhate	11/12/09 Modified for MDD File System Support
+ * VirtualFab		2026/10/17 nameKey, second key of the DynIdx.bin buckets
 ********************************************************************/
 
 #ifndef __HTTP2_H
@@ -221,12 +222,11 @@ typedef struct {
 #if defined(STACK_USE_MDD) || defined(STACK_USE_FATFS)
     FILE_HANDLE pFhStoredFile;
     WORD nameHash ;
+    DWORD nameKey;          // FNV-1a of the page name, tells apart pages sharing nameHash
     FILE_HANDLE DynVarRcrdFilePtr;
     BOOL CurWorkDirChangedToMddRootPath;
     BYTE * directoryPtr;
-    BYTE sendDataBuffer[64];
     SMSTATES smHTTPSendFile;
-    BYTE lock;
     BYTE nameHashMatched;
     DWORD numBytes, dynVarCntr,dynVarRcrdOffset, dynVarCallBackID, bytesReadCount;
 #endif
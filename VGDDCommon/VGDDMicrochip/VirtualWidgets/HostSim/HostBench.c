@@ -0,0 +1,204 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Per-widget redraw cost benchmark
+// *****************************************************************************
+// FileName:        HostBench.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Replays a scripted value sequence through SgSetVal(), VuSetVal(), BgSetVal()
+// and D7SetVal() and measures every GOLDraw() frame the widgets need to reach
+// each value, for every display controller profile in HostGfxProfiles[].
+// Full draws of all widgets (TextEntryEx and MsgBox included) are measured too.
+//
+// For each widget and profile it reports the full draw cost and, per update
+// frame (a GOLDraw() pass that drew something), the average pixels written, primitive calls, PutPixel calls, address
+// windows (SetArea or per-row address setup) and simulated bus time, plus the
+// worst frame, and the simulated time the script took (see HostGolLoopTicks).
+// An update frame that writes more than the given share of the widget's full
+// draw pixels is reported as a full repaint and makes the tool exit with 2,
+// so it can guard against regressions in the incremental paths.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -I../Resources/Source -o HostBench HostBench.c HostScene.c HostGfx.c HostGol.c ../Resources/Source/*.c -lm
+//
+// Usage:
+//   HostBench [-p profileIndex] [-l maxUpdatePercent]
+//     -p  run a single profile (index in HostGfxProfiles[], default all)
+//     -l  update frame limit in percent of the full draw pixels (default 60)
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	SuperGauge measured with and without dial cache
+//  2026/10/17	Only passes that drew are counted as frames, script duration
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostScene.h"
+
+#define BENCH_MAX_FRAMES    1000    // GOLDraw() passes allowed to settle a single value change
+
+// Values replayed on every widget: slow ramp, single steps, jumps
+static const SHORT BenchScript[] = {
+    10, 20, 35, 50, 65, 80, 95, 100,
+    99, 98, 97, 96, 97, 98,
+    60, 30, 0,
+    1, 2, 3, 50, 75
+};
+
+typedef enum {
+    BENCH_SUPERGAUGE,
+    BENCH_SUPERGAUGE_HALF,
+    BENCH_VUMETER,
+    BENCH_BARGRAPH,
+    BENCH_DISP7SEG
+} BENCH_WIDGET;
+
+typedef struct {
+    DWORD Frames;
+    DWORD PixelsWritten;
+    DWORD Primitives;
+    DWORD SinglePixels;
+    DWORD Windows;
+    double BusTimeUs;
+    DWORD MaxFramePixels;
+    double MaxFrameBusTimeUs;
+    DWORD Ticks;
+} BENCH_RESULT;
+
+static DWORD BenchPrimitives(HOSTGFX_STATS *pStats) {
+    return pStats->BarCalls + pStats->LineCalls + pStats->ArcCalls + pStats->BevelCalls +
+            pStats->PolyCalls + pStats->TextChars + pStats->ImageCalls;
+}
+
+static void BenchSetValue(HOST_SCENE *pScene, BENCH_WIDGET widget, SHORT value) {
+    switch (widget) {
+        case BENCH_SUPERGAUGE:
+            SgSetVal(pScene->pSg, value);
+            SetState(pScene->pSg, SG_DRAW_UPDATE);
+            break;
+        case BENCH_SUPERGAUGE_HALF:
+            SgSetVal(pScene->pSgHalf, value);
+            SetState(pScene->pSgHalf, SG_DRAW_UPDATE);
+            break;
+        case BENCH_VUMETER:
+            VuSetVal(pScene->pVu, value);
+            SetState(pScene->pVu, VU_DRAW_UPDATE);
+            break;
+        case BENCH_BARGRAPH:
+            BgSetVal(pScene->pBg, value);
+            SetState(pScene->pBg, BG_DRAW_UPDATE);
+            break;
+        case BENCH_DISP7SEG:
+            D7SetVal(pScene->pD7, value * 111);
+            SetState(pScene->pD7, D7_UPDATE);
+            break;
+    }
+}
+
+// Replays BenchScript on one widget, one GOLDraw() pass per frame
+static void BenchRun(HOST_SCENE *pScene, BENCH_WIDGET widget, BENCH_RESULT *pResult) {
+    HOSTGFX_STATS frame;
+    WORD i, frames;
+    DWORD start = tick;
+
+    memset(pResult, 0, sizeof (BENCH_RESULT));
+    for (i = 0; i < sizeof (BenchScript) / sizeof (BenchScript[0]); i++) {
+        BenchSetValue(pScene, widget, BenchScript[i]);
+        for (frames = 0; frames < BENCH_MAX_FRAMES && HostGolPending(); frames++) {
+            HostSceneSettle(1, &frame);
+            if (frame.PixelsWritten == 0)
+                continue; // waiting for the next animation step
+            pResult->Frames++;
+            pResult->PixelsWritten += frame.PixelsWritten;
+            pResult->Primitives += BenchPrimitives(&frame);
+            pResult->SinglePixels += frame.SinglePixels;
+            pResult->Windows += frame.Windows;
+            pResult->BusTimeUs += frame.BusTimeNs / 1000.0;
+            if (frame.PixelsWritten > pResult->MaxFramePixels)
+                pResult->MaxFramePixels = frame.PixelsWritten;
+            if (frame.BusTimeNs / 1000.0 > pResult->MaxFrameBusTimeUs)
+                pResult->MaxFrameBusTimeUs = frame.BusTimeNs / 1000.0;
+        }
+    }
+    pResult->Ticks = tick - start;
+}
+
+static void BenchPrintHeader(void) {
+    printf("  %-14s %9s %9s | %6s %8s %6s %6s %7s %9s | %9s %9s | %6s\n",
+            "Widget", "FullPx", "FullUs", "Frames", "Px/fr", "Prim", "PPix", "Win", "Us/fr", "MaxPx", "MaxUs", "Ms");
+}
+
+static void BenchPrintFull(const char *label, HOSTGFX_STATS *pFull) {
+    printf("  %-14s %9lu %9.1f |\n", label, (unsigned long) pFull->PixelsWritten, pFull->BusTimeNs / 1000.0);
+}
+
+static WORD BenchPrint(const char *label, HOSTGFX_STATS *pFull, BENCH_RESULT *pResult, WORD limitPercent) {
+    DWORD n = pResult->Frames ? pResult->Frames : 1;
+    WORD fullRepaint = pResult->MaxFramePixels * 100 > pFull->PixelsWritten * (DWORD) limitPercent;
+
+    printf("  %-14s %9lu %9.1f | %6lu %8lu %6lu %6lu %7lu %9.1f | %9lu %9.1f | %6lu%s\n",
+            label,
+            (unsigned long) pFull->PixelsWritten, pFull->BusTimeNs / 1000.0,
+            (unsigned long) pResult->Frames,
+            (unsigned long) (pResult->PixelsWritten / n),
+            (unsigned long) (pResult->Primitives / n),
+            (unsigned long) (pResult->SinglePixels / n),
+            (unsigned long) (pResult->Windows / n),
+            pResult->BusTimeUs / n,
+            (unsigned long) pResult->MaxFramePixels, pResult->MaxFrameBusTimeUs,
+            (unsigned long) pResult->Ticks,
+            fullRepaint ? "  FULL REPAINT" : "");
+    return fullRepaint;
+}
+
+int main(int argc, char **argv) {
+    static const char *Names[] = {"SuperGauge", "SuperGaugeHalf", "VuMeter", "BarGraph", "Disp7Seg"};
+    HOST_SCENE scene;
+    HOSTGFX_STATS full[5], fullTe, fullMb, rest;
+    BENCH_RESULT result;
+    WORD limitPercent = 60, failures = 0;
+    int profile = -1, i, w;
+
+    for (i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-p") == 0)
+            profile = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0)
+            limitPercent = (WORD) atoi(argv[++i]);
+    }
+
+    for (i = 0; HostGfxProfiles[i].Name != NULL; i++) {
+        if (profile >= 0 && profile != i) continue;
+        HostGfxProfile = &HostGfxProfiles[i];
+        if (!HostSceneCreate(&scene)) {
+            fprintf(stderr, "Widget creation failed\n");
+            return 1;
+        }
+        HostGfxMeasureDraw(&scene.pSg->hdr, &full[BENCH_SUPERGAUGE]);
+        HostGfxMeasureDraw(&scene.pSgHalf->hdr, &full[BENCH_SUPERGAUGE_HALF]);
+        HostGfxMeasureDraw(&scene.pVu->hdr, &full[BENCH_VUMETER]);
+        HostGfxMeasureDraw(&scene.pBg->hdr, &full[BENCH_BARGRAPH]);
+        HostGfxMeasureDraw(&scene.pD7->hdr, &full[BENCH_DISP7SEG]);
+        HostGfxMeasureDraw(&scene.pTeEx->hdr, &fullTe);
+        HostSceneSettle(BENCH_MAX_FRAMES, &rest);
+
+        printf("%s\n", HostGfxProfile->Name);
+        BenchPrintHeader();
+        for (w = BENCH_SUPERGAUGE; w <= BENCH_DISP7SEG; w++) {
+            BenchRun(&scene, (BENCH_WIDGET) w, &result);
+            failures += BenchPrint(Names[w], &full[w], &result, limitPercent);
+        }
+        BenchPrintFull("TextEntryEx", &fullTe);
+        if (HostSceneCreateMsgBox() == NULL) {
+            fprintf(stderr, "MsgBox creation failed\n");
+            return 1;
+        }
+        HostSceneSettle(BENCH_MAX_FRAMES, &fullMb);
+        BenchPrintFull("MsgBox", &fullMb);
+        printf("\n");
+    }
+    return failures ? 2 : 0;
+}
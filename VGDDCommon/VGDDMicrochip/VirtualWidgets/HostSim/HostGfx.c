@@ -0,0 +1,603 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Headless framebuffer, Display Driver and Primitive Layer for the host PC
+// *****************************************************************************
+// FileName:        HostGfx.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Primitives are decomposed the way the Microchip Primitive Layer decomposes
+// them on the target, so that the counters in HostGfxStats are representative:
+// - horizontal and vertical lines, filled bevels, arcs and clears become Bar()
+//   spans (one address window each);
+// - diagonal lines are rasterised with PutPixel() (one window per pixel, three
+//   pixels per step for THICK_LINE);
+// - outlined bevels and circles are plotted with PutPixel();
+// - text glyphs are plotted pixel by pixel with PutPixel();
+// - images are transferred one row per window.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Writes outside the rectangle of the object being drawn (OutsideWrites)
+// *****************************************************************************
+#include <string.h>
+#include <math.h>
+#include "HostGfx.h"
+
+GFX_COLOR HostFrameBuffer[DISP_VER_RESOLUTION][DISP_HOR_RESOLUTION];
+HOSTGFX_STATS HostGfxStats;
+OBJ_HEADER *HostGfxOwner = NULL;
+HOSTGFX_OUTSIDE HostGfxOutside;
+
+// Bus models of the display controllers used by the VGDD board templates.
+// Write counts are taken from the drivers: SetArea() + CMD_WR_MEMSTART on the
+// SSD1963, SetAddress() before every row on the R61509V and ILI9320, plain
+// stores into the frame buffer on the LCC (no address setup).
+HOSTGFX_PROFILE HostGfxProfiles[] = {
+    // Name                 Row  Window Pixel Read  WrNs RdNs PartialIsFull
+    {"SSD1963 16-bit PMP",    0,     11,    1,    3,   40, 150, 0},
+    {"SSD1963 8-bit PMP",     0,     11,    3,    5,   40, 150, 0},
+    {"R61509V 16-bit PMP",    1,      6,    1,    8,   50, 250, 0},
+    {"ILI9320 8-bit PMP",     1,     12,    2,   14,   50, 250, 0},
+    {"LCC external SRAM",     0,      0,    1,    1,   25,  25, 0},
+    {NULL}
+};
+HOSTGFX_PROFILE *HostGfxProfile = &HostGfxProfiles[0];
+WORD HostGfxBusyPeriod = 0; // When non zero, IsDeviceBusy() reports busy once every HostGfxBusyPeriod calls
+
+GFX_FONT_CURRENT currentFont;
+GFX_COLOR _color;
+SHORT _cursorX, _cursorY;
+SHORT _lineType;
+BYTE _lineThickness;
+SHORT _clipRgn, _clipLeft, _clipTop, _clipRight, _clipBottom;
+
+FONT_FLASH FONTDEFAULT = {FLASH, 8, 14};
+
+// *****************************************************************************
+// Display Driver Layer
+// *****************************************************************************
+
+void ResetDevice(void) {
+    memset(HostFrameBuffer, 0, sizeof (HostFrameBuffer));
+    _color = BLACK;
+    _cursorX = _cursorY = 0;
+    _lineType = SOLID_LINE;
+    _lineThickness = NORMAL_LINE;
+    _clipRgn = CLIP_DISABLE;
+    _clipLeft = _clipTop = 0;
+    _clipRight = GetMaxX();
+    _clipBottom = GetMaxY();
+    currentFont.pFont = &FONTDEFAULT;
+    HostGfxResetStats();
+}
+
+WORD IsDeviceBusy(void) {
+    static WORD BusyCounter = 0;
+
+    if (HostGfxBusyPeriod == 0) return 0;
+    if (++BusyCounter < HostGfxBusyPeriod) return 0;
+    BusyCounter = 0;
+    return 1;
+}
+
+void SetClipRgn(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+    _clipLeft = left;
+    _clipTop = top;
+    _clipRight = right;
+    _clipBottom = bottom;
+}
+
+void SetClip(BYTE control) {
+    _clipRgn = control;
+}
+
+// Accounts the bus traffic to write a width x height rectangle with the current profile
+static void HostGfxBusRect(DWORD width, DWORD height) {
+    DWORD windows = HostGfxProfile->RowAddressing ? height : 1;
+    DWORD writes = windows * HostGfxProfile->WindowWrites + width * height * HostGfxProfile->PixelWrites;
+
+    HostGfxStats.Windows += windows;
+    HostGfxStats.BusWrites += writes;
+    HostGfxStats.BusTimeNs += writes * HostGfxProfile->WriteNs;
+}
+
+// Returns 0 if (x,y) falls outside the screen or the active clipping region
+static BYTE HostGfxVisible(SHORT x, SHORT y) {
+    if (x < 0 || y < 0 || x > GetMaxX() || y > GetMaxY()) return 0;
+    if (_clipRgn) {
+        if (x < _clipLeft || x > _clipRight || y < _clipTop || y > _clipBottom) return 0;
+    }
+    return 1;
+}
+
+// Counts the pixels of a visible rectangle that fall outside the rectangle of HostGfxOwner
+static void HostGfxCheckOwner(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+    SHORT l, t, r, b;
+    DWORD inside = 0;
+
+    if (HostGfxOwner == NULL) return;
+    l = left > HostGfxOwner->left ? left : HostGfxOwner->left;
+    t = top > HostGfxOwner->top ? top : HostGfxOwner->top;
+    r = right < HostGfxOwner->right ? right : HostGfxOwner->right;
+    b = bottom < HostGfxOwner->bottom ? bottom : HostGfxOwner->bottom;
+    if (l <= r && t <= b)
+        inside = (DWORD) (r - l + 1) * (b - t + 1);
+    if (inside == (DWORD) (right - left + 1) * (bottom - top + 1)) return;
+    HostGfxStats.OutsideWrites += (DWORD) (right - left + 1) * (bottom - top + 1) - inside;
+    if (HostGfxOutside.ID == 0) {
+        HostGfxOutside.ID = HostGfxOwner->ID;
+        HostGfxOutside.x = (left < HostGfxOwner->left || left > HostGfxOwner->right) ? left : right;
+        HostGfxOutside.y = (top < HostGfxOwner->top || top > HostGfxOwner->bottom) ? top : bottom;
+    }
+}
+
+void PutPixel(SHORT x, SHORT y) {
+    HostGfxBusRect(1, 1);
+    HostGfxStats.SinglePixels++;
+    HostGfxStats.PixelsWritten++;
+    if (HostGfxVisible(x, y)) {
+        HostGfxCheckOwner(x, y, x, y);
+        HostFrameBuffer[y][x] = _color;
+    }
+}
+
+GFX_COLOR GetPixel(SHORT x, SHORT y) {
+    HostGfxStats.Windows++;
+    HostGfxStats.PixelsRead++;
+    HostGfxStats.BusWrites += HostGfxProfile->WindowWrites;
+    HostGfxStats.BusReads += HostGfxProfile->ReadCycles;
+    HostGfxStats.BusTimeNs += HostGfxProfile->WindowWrites * HostGfxProfile->WriteNs +
+            HostGfxProfile->ReadCycles * HostGfxProfile->ReadNs;
+    if (x < 0 || y < 0 || x > GetMaxX() || y > GetMaxY()) return 0;
+    return HostFrameBuffer[y][x];
+}
+
+WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+    SHORT x, y;
+
+    if (left > right) {
+        x = left;
+        left = right;
+        right = x;
+    }
+    if (top > bottom) {
+        y = top;
+        top = bottom;
+        bottom = y;
+    }
+    if (_clipRgn) {
+        if (left < _clipLeft) left = _clipLeft;
+        if (right > _clipRight) right = _clipRight;
+        if (top < _clipTop) top = _clipTop;
+        if (bottom > _clipBottom) bottom = _clipBottom;
+    }
+    if (left < 0) left = 0;
+    if (top < 0) top = 0;
+    if (right > GetMaxX()) right = GetMaxX();
+    if (bottom > GetMaxY()) bottom = GetMaxY();
+
+    HostGfxStats.BarCalls++;
+    if (left > right || top > bottom) return 1;
+    HostGfxBusRect(right - left + 1, bottom - top + 1);
+    HostGfxStats.PixelsWritten += (DWORD) (right - left + 1) * (bottom - top + 1);
+    HostGfxCheckOwner(left, top, right, bottom);
+    for (y = top; y <= bottom; y++)
+        for (x = left; x <= right; x++)
+            HostFrameBuffer[y][x] = _color;
+    return 1;
+}
+
+void ClearDevice(void) {
+    SHORT clip = _clipRgn;
+
+    _clipRgn = CLIP_DISABLE;
+    Bar(0, 0, GetMaxX(), GetMaxY());
+    _clipRgn = clip;
+    MoveTo(0, 0);
+}
+
+// *****************************************************************************
+// Primitive Layer
+// *****************************************************************************
+
+void GetCirclePoint(SHORT radius, SHORT angle, SHORT *x, SHORT *y) {
+    double rad = (double) angle * M_PI / 180.0;
+
+    *x = (SHORT) lround(radius * cos(rad));
+    *y = (SHORT) lround(radius * sin(rad));
+}
+
+WORD Line(SHORT x1, SHORT y1, SHORT x2, SHORT y2) {
+    SHORT dx, dy, sx, sy, err, e2;
+    WORD step = 0;
+    BYTE steep;
+
+    HostGfxStats.LineCalls++;
+    if (_lineType == SOLID_LINE) {
+        if (y1 == y2) {
+            if (_lineThickness)
+                Bar(x1, y1 - 1, x2, y2 + 1);
+            else
+                Bar(x1, y1, x2, y2);
+            MoveTo(x2, y2);
+            return 1;
+        }
+        if (x1 == x2) {
+            if (_lineThickness)
+                Bar(x1 - 1, y1, x2 + 1, y2);
+            else
+                Bar(x1, y1, x2, y2);
+            MoveTo(x2, y2);
+            return 1;
+        }
+    }
+
+    dx = abs(x2 - x1);
+    dy = -abs(y2 - y1);
+    sx = x1 < x2 ? 1 : -1;
+    sy = y1 < y2 ? 1 : -1;
+    err = dx + dy;
+    steep = (-dy > dx);
+    for (;;) {
+        if (_lineType == SOLID_LINE || ((step >> 2) & 1) == 0) {
+            PutPixel(x1, y1);
+            if (_lineThickness) {
+                if (steep) {
+                    PutPixel(x1 - 1, y1);
+                    PutPixel(x1 + 1, y1);
+                } else {
+                    PutPixel(x1, y1 - 1);
+                    PutPixel(x1, y1 + 1);
+                }
+            }
+        }
+        step++;
+        if (x1 == x2 && y1 == y2) break;
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+    MoveTo(x2, y2);
+    return 1;
+}
+
+// Integer half-width of a circle of radius r at distance d from its centre
+static SHORT HostGfxHalfChord(SHORT r, SHORT d) {
+    LONG v = (LONG) r * r - (LONG) d * d;
+
+    if (v <= 0) return 0;
+    return (SHORT) sqrt((double) v);
+}
+
+WORD Bevel(SHORT x1, SHORT y1, SHORT x2, SHORT y2, SHORT rad) {
+    SHORT x, y, err;
+
+    HostGfxStats.BevelCalls++;
+    if (rad == 0) {
+        Line(x1, y1, x2, y1);
+        Line(x2, y1, x2, y2);
+        Line(x2, y2, x1, y2);
+        Line(x1, y2, x1, y1);
+        return 1;
+    }
+    if (x2 > x1) {
+        Line(x1, y1 - rad, x2, y1 - rad);
+        Line(x1, y2 + rad, x2, y2 + rad);
+    }
+    if (y2 > y1) {
+        Line(x1 - rad, y1, x1 - rad, y2);
+        Line(x2 + rad, y1, x2 + rad, y2);
+    }
+    // Midpoint circle, one pixel per octant point
+    x = rad;
+    y = 0;
+    err = 1 - rad;
+    while (x >= y) {
+        PutPixel(x2 + x, y2 + y);
+        PutPixel(x2 + y, y2 + x);
+        PutPixel(x1 - y, y2 + x);
+        PutPixel(x1 - x, y2 + y);
+        PutPixel(x1 - x, y1 - y);
+        PutPixel(x1 - y, y1 - x);
+        PutPixel(x2 + y, y1 - x);
+        PutPixel(x2 + x, y1 - y);
+        y++;
+        if (err < 0)
+            err += 2 * y + 1;
+        else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+    return 1;
+}
+
+WORD FillBevel(SHORT x1, SHORT y1, SHORT x2, SHORT y2, SHORT rad) {
+    SHORT dy, dx;
+
+    HostGfxStats.BevelCalls++;
+    if (rad == 0) return Bar(x1, y1, x2, y2);
+    for (dy = rad; dy > 0; dy--) {
+        dx = HostGfxHalfChord(rad, dy);
+        Bar(x1 - dx, y1 - dy, x2 + dx, y1 - dy);
+        Bar(x1 - dx, y2 + dy, x2 + dx, y2 + dy);
+    }
+    Bar(x1 - rad, y1, x2 + rad, y2);
+    return 1;
+}
+
+// Octant bits as in the Graphics Library: 0x01/0x02 upper right, 0x04/0x08 lower right,
+// 0x10/0x20 lower left, 0x40/0x80 upper left. The straight sections between two
+// enabled quadrants are filled too.
+WORD Arc(SHORT xL, SHORT yT, SHORT xR, SHORT yB, SHORT r1, SHORT r2, BYTE octant) {
+    SHORT d, xo, xi;
+
+    HostGfxStats.ArcCalls++;
+    for (d = r2; d >= 0; d--) {
+        xo = HostGfxHalfChord(r2, d);
+        xi = (d < r1) ? HostGfxHalfChord(r1, d) : 0;
+        if (d < r1 && xi >= xo) continue;
+        if (d >= r1) {
+            // row crosses the straight top/bottom sections
+            if ((octant & 0x03) && (octant & 0xC0) && xR > xL) Bar(xL, yT - d, xR, yT - d);
+            if ((octant & 0x0C) && (octant & 0x30) && xR > xL) Bar(xL, yB + d, xR, yB + d);
+            xi = -1;
+        }
+        if (octant & 0x03) Bar(xR + xi + 1, yT - d, xR + xo, yT - d);
+        if (octant & 0x0C) Bar(xR + xi + 1, yB + d, xR + xo, yB + d);
+        if (octant & 0x30) Bar(xL - xo, yB + d, xL - xi - 1, yB + d);
+        if (octant & 0xC0) Bar(xL - xo, yT - d, xL - xi - 1, yT - d);
+    }
+    if (yB > yT) {
+        if (octant & 0x0F) Bar(xR + r1, yT, xR + r2, yB);
+        if (octant & 0xF0) Bar(xL - r2, yT, xL - r1, yB);
+    }
+    return 1;
+}
+
+WORD DrawPoly(SHORT numPoints, SHORT *polyPoints) {
+    SHORT i;
+
+    HostGfxStats.PolyCalls++;
+    for (i = 0; i < numPoints - 1; i++)
+        Line(polyPoints[i * 2], polyPoints[i * 2 + 1], polyPoints[i * 2 + 2], polyPoints[i * 2 + 3]);
+    return 1;
+}
+
+// *****************************************************************************
+// Text
+// *****************************************************************************
+
+static FONT_FLASH *HostGfxFont(void *pFont) {
+    if (pFont == NULL) return &FONTDEFAULT;
+    return (FONT_FLASH *) pFont;
+}
+
+void SetFont(void *pFont) {
+    currentFont.pFont = pFont;
+}
+
+SHORT GetTextWidth(XCHAR *textString, void *pFont) {
+    SHORT len = 0;
+
+    while (textString != NULL && textString[len] != 0) len++;
+    return len * HostGfxFont(pFont)->width;
+}
+
+SHORT GetTextHeight(void *pFont) {
+    return HostGfxFont(pFont)->height;
+}
+
+// Glyphs are a deterministic pattern with roughly the ink density of a real
+// font, so the pixel traffic scales with text length and cell size.
+WORD OutChar(XCHAR ch) {
+    FONT_FLASH *pFont = HostGfxFont(currentFont.pFont);
+    SHORT x, y;
+
+    HostGfxStats.TextChars++;
+    if (ch != ' ') {
+        for (y = 1; y < pFont->height - 1; y++) {
+            for (x = 1; x < pFont->width - 1; x++) {
+                if (((x * 3 + y * 5 + (BYTE) ch) % 4) == 0)
+                    PutPixel(_cursorX + x, _cursorY + y);
+            }
+        }
+    }
+    _cursorX += pFont->width;
+    return 1;
+}
+
+WORD OutText(XCHAR *textString) {
+    while (*textString != 0) {
+        OutChar(*textString++);
+    }
+    return 1;
+}
+
+WORD OutTextXY(SHORT x, SHORT y, XCHAR *textString) {
+    MoveTo(x, y);
+    return OutText(textString);
+}
+
+// *****************************************************************************
+// Images
+// *****************************************************************************
+
+static BITMAP_HEADER *HostGfxImageHeader(void *image) {
+    IMAGE_FLASH *pImage = (IMAGE_FLASH *) image;
+
+    if (pImage == NULL) return NULL;
+    if (pImage->type != FLASH && pImage->type != RAM) return NULL;
+    return (BITMAP_HEADER *) pImage->address;
+}
+
+SHORT GetImageWidth(void *image) {
+    BITMAP_HEADER *pHeader = HostGfxImageHeader(image);
+
+    return pHeader ? pHeader->width : 0;
+}
+
+SHORT GetImageHeight(void *image) {
+    BITMAP_HEADER *pHeader = HostGfxImageHeader(image);
+
+    return pHeader ? pHeader->height : 0;
+}
+
+// Colour of pixel (x,y) of a flash bitmap, resolving the palette for 1, 4 and 8 bpp
+static GFX_COLOR HostGfxImagePixel(BITMAP_HEADER *pHeader, SHORT x, SHORT y) {
+    FLASH_BYTE *pData = (FLASH_BYTE *) pHeader + sizeof (BITMAP_HEADER);
+    FLASH_BYTE *pRow;
+    WORD paletteSize, index;
+    DWORD rowBytes;
+
+    if (pHeader->colorDepth == 16) {
+        pRow = pData + (DWORD) y * pHeader->width * 2;
+        return (GFX_COLOR) (pRow[x * 2] | (pRow[x * 2 + 1] << 8));
+    }
+    paletteSize = 1 << pHeader->colorDepth;
+    rowBytes = ((DWORD) pHeader->width * pHeader->colorDepth + 7) >> 3;
+    pRow = pData + paletteSize * 2 + (DWORD) y * rowBytes;
+    switch (pHeader->colorDepth) {
+        case 1:
+            index = (pRow[x >> 3] >> (7 - (x & 7))) & 0x01;
+            break;
+        case 4:
+            index = (pRow[x >> 1] >> ((x & 1) << 2)) & 0x0F;
+            break;
+        default:
+            index = pRow[x];
+            break;
+    }
+    return (GFX_COLOR) (pData[index * 2] | (pData[index * 2 + 1] << 8));
+}
+
+WORD PutImagePartial(SHORT left, SHORT top, void *image, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    BITMAP_HEADER *pHeader = HostGfxImageHeader(image);
+    GFX_COLOR color = _color;
+    SHORT x, y, sx, sy, px, py;
+
+    HostGfxStats.ImageCalls++;
+    if (pHeader == NULL) return 1;
+    if (HostGfxProfile->PartialIsFull) {
+        // The driver's PutImagePartial() ignores the offsets and blits the whole image at left,top
+        xoffset = yoffset = 0;
+        width = pHeader->width;
+        height = pHeader->height;
+    }
+    if (xoffset + width > pHeader->width) width = pHeader->width - xoffset;
+    if (yoffset + height > pHeader->height) height = pHeader->height - yoffset;
+    for (y = 0; y < height; y++) {
+        for (sy = 0; sy < stretch; sy++) {
+            HostGfxBusRect((DWORD) width * stretch, 1);
+            for (x = 0; x < width; x++) {
+                _color = HostGfxImagePixel(pHeader, xoffset + x, yoffset + y);
+                for (sx = 0; sx < stretch; sx++) {
+                    px = left + x * stretch + sx;
+                    py = top + y * stretch + sy;
+                    HostGfxStats.PixelsWritten++;
+                    HostGfxStats.ImagePixels++;
+                    if (HostGfxVisible(px, py)) {
+                        HostGfxCheckOwner(px, py, px, py);
+                        HostFrameBuffer[py][px] = _color;
+                    }
+                }
+            }
+        }
+    }
+    _color = color;
+    return 1;
+}
+
+WORD PutImage(SHORT left, SHORT top, void *image, BYTE stretch) {
+    return PutImagePartial(left, top, image, stretch, 0, 0, GetImageWidth(image), GetImageHeight(image));
+}
+
+// *****************************************************************************
+// Measurement helpers
+// *****************************************************************************
+
+void HostGfxResetStats(void) {
+    memset(&HostGfxStats, 0, sizeof (HostGfxStats));
+    memset(&HostGfxOutside, 0, sizeof (HostGfxOutside));
+}
+
+void HostGfxPrintStats(FILE *f, const char *label, HOSTGFX_STATS *pStats) {
+    fprintf(f, "%-28s calls %5lu/%-4lu win %7lu wr %8lu px1 %7lu rd %6lu bar %6lu line %5lu arc %4lu bev %4lu poly %3lu chr %4lu img %3lu/%lu bus %.1fus\n",
+            label,
+            (unsigned long) pStats->DrawCalls, (unsigned long) pStats->BusyReturns,
+            (unsigned long) pStats->Windows, (unsigned long) pStats->PixelsWritten,
+            (unsigned long) pStats->SinglePixels, (unsigned long) pStats->PixelsRead,
+            (unsigned long) pStats->BarCalls, (unsigned long) pStats->LineCalls,
+            (unsigned long) pStats->ArcCalls, (unsigned long) pStats->BevelCalls,
+            (unsigned long) pStats->PolyCalls, (unsigned long) pStats->TextChars,
+            (unsigned long) pStats->ImageCalls, (unsigned long) pStats->ImagePixels,
+            pStats->BusTimeNs / 1000.0);
+}
+
+WORD HostGfxMeasureDraw(OBJ_HEADER *pObj, HOSTGFX_STATS *pStats) {
+    HOSTGFX_STATS before = HostGfxStats;
+    DWORD *pAfter, *pBefore, *pResult;
+    WORD i, done = 0;
+    DWORD calls;
+
+    HostGfxOwner = pObj;
+    for (calls = 0; calls < 1000000L; calls++) {
+        HostGfxStats.DrawCalls++;
+        if (pObj->DrawObj(pObj)) {
+            done = 1;
+            break;
+        }
+        HostGfxStats.BusyReturns++;
+    }
+    HostGfxOwner = NULL;
+    GOLDrawComplete(pObj);
+    pAfter = (DWORD *) & HostGfxStats;
+    pBefore = (DWORD *) & before;
+    pResult = (DWORD *) pStats;
+    for (i = 0; i < sizeof (HOSTGFX_STATS) / sizeof (DWORD); i++)
+        pResult[i] = pAfter[i] - pBefore[i];
+    return done;
+}
+
+void HostGfxSnapshot(GFX_COLOR *pDest) {
+    memcpy(pDest, HostFrameBuffer, sizeof (HostFrameBuffer));
+}
+
+DWORD HostGfxCompare(GFX_COLOR *pReference) {
+    GFX_COLOR *pFrame = &HostFrameBuffer[0][0];
+    DWORD i, diff = 0;
+
+    for (i = 0; i < (DWORD) DISP_HOR_RESOLUTION * DISP_VER_RESOLUTION; i++)
+        if (pFrame[i] != pReference[i]) diff++;
+    return diff;
+}
+
+WORD HostGfxSavePPM(const char *fileName) {
+    FILE *f = fopen(fileName, "wb");
+    SHORT x, y;
+    GFX_COLOR c;
+    BYTE rgb[3];
+
+    if (f == NULL) return 0;
+    fprintf(f, "P6\n%d %d\n255\n", DISP_HOR_RESOLUTION, DISP_VER_RESOLUTION);
+    for (y = 0; y < DISP_VER_RESOLUTION; y++) {
+        for (x = 0; x < DISP_HOR_RESOLUTION; x++) {
+            c = HostFrameBuffer[y][x];
+            rgb[0] = (BYTE) (((c >> 11) & 0x1F) << 3);
+            rgb[1] = (BYTE) (((c >> 5) & 0x3F) << 2);
+            rgb[2] = (BYTE) ((c & 0x1F) << 3);
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+    return 1;
+}
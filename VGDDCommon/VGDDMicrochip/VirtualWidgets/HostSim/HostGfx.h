@@ -0,0 +1,104 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Headless framebuffer and primitive cost counters
+// *****************************************************************************
+// FileName:        HostGfx.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The host display is a DISP_HOR_RESOLUTION x DISP_VER_RESOLUTION RGB565
+// framebuffer. Every primitive reaches it through the same driver entry points
+// the Microchip library uses on the target (PutPixel, GetPixel, Bar and the
+// image blitters), so the counters below reflect what a real display
+// controller would see: how many address windows are opened, how many pixels
+// are written or read back and how many of them were written one at a time.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Writes outside the rectangle of the object being drawn (OutsideWrites)
+// *****************************************************************************
+#ifndef _HOSTGFX_H
+#define _HOSTGFX_H
+
+#include <stdio.h>
+#include "Graphics/Graphics.h"
+
+typedef struct {
+    DWORD PixelsWritten;    // Pixels sent to the display
+    DWORD PixelsRead;       // Pixels read back from the display (GetPixel)
+    DWORD SinglePixels;     // Pixels written with PutPixel (one address window each)
+    DWORD Windows;          // Address windows opened (PutPixel, GetPixel, each Bar and each image row)
+    DWORD BarCalls;
+    DWORD LineCalls;
+    DWORD ArcCalls;
+    DWORD BevelCalls;
+    DWORD PolyCalls;
+    DWORD TextChars;
+    DWORD ImageCalls;
+    DWORD ImagePixels;      // Pixels transferred by PutImage/PutImagePartial
+    DWORD DrawCalls;        // DrawObj invocations
+    DWORD BusyReturns;      // DrawObj invocations that returned 0 (not finished)
+    DWORD OutsideWrites;    // Pixels written outside the rectangle of the object being drawn
+    DWORD BusWrites;        // Bus write strobes with the current profile (commands, addresses and pixel data)
+    DWORD BusReads;         // Bus read strobes with the current profile (including dummy reads)
+    DWORD BusTimeNs;        // Simulated bus time with the current profile
+} HOSTGFX_STATS;
+
+// Display controller/bus model used to turn primitive traffic into bus time
+typedef struct {
+    const char *Name;
+    BYTE RowAddressing;     // 1: the controller has no usable window, the address is set before every row
+    BYTE WindowWrites;      // Bus writes to open a window (or to set the address of one row)
+    BYTE PixelWrites;       // Bus writes per pixel
+    BYTE ReadCycles;        // Bus reads per GetPixel (dummy reads included)
+    WORD WriteNs;           // Duration of a write strobe
+    WORD ReadNs;            // Duration of a read strobe
+    BYTE PartialIsFull;     // 1: the driver's PutImagePartial() blits the whole image
+} HOSTGFX_PROFILE;
+
+extern HOSTGFX_PROFILE HostGfxProfiles[];   // Terminated by an entry with Name == NULL
+extern HOSTGFX_PROFILE *HostGfxProfile;     // Profile in use, defaults to HostGfxProfiles[0]
+
+extern HOSTGFX_STATS HostGfxStats;
+
+// Object being drawn, set by GOLDraw() and HostGfxMeasureDraw(). The visible
+// pixels it writes outside its own rectangle are counted in OutsideWrites and
+// the first of them is kept in HostGfxOutside until the next reset.
+extern OBJ_HEADER *HostGfxOwner;
+typedef struct {
+    WORD ID;                // ID of the object, 0 if no pixel was written outside
+    SHORT x, y;
+} HOSTGFX_OUTSIDE;
+extern HOSTGFX_OUTSIDE HostGfxOutside;
+extern GFX_COLOR HostFrameBuffer[DISP_VER_RESOLUTION][DISP_HOR_RESOLUTION];
+
+void HostGfxResetStats(void);
+void HostGfxPrintStats(FILE *f, const char *label, HOSTGFX_STATS *pStats);
+
+// Calls pObj->DrawObj until it reports completion, the same way GOLDraw does,
+// and returns the cost of that single redraw in *pStats.
+WORD HostGfxMeasureDraw(OBJ_HEADER *pObj, HOSTGFX_STATS *pStats);
+
+// Returns 1 while any object in the GOL list still has draw bits pending
+WORD HostGolPending(void);
+
+// When non zero, GOLDraw() moves on to the next object when one returns 0
+// instead of resuming it first, so partially drawn objects are interleaved
+extern WORD HostGolInterleave;
+
+// Ticks (ms) a main loop iteration takes besides drawing, added to tick by
+// every complete GOLDraw() pass together with the simulated bus time
+extern WORD HostGolLoopTicks;
+
+// Number of framebuffer pixels different from a reference copy
+DWORD HostGfxCompare(GFX_COLOR *pReference);
+void HostGfxSnapshot(GFX_COLOR *pDest);
+
+// Writes the framebuffer as a binary PPM (P6) file. Returns 0 on failure.
+WORD HostGfxSavePPM(const char *fileName);
+
+extern WORD HostGfxBusyPeriod;
+
+#endif // _HOSTGFX_H
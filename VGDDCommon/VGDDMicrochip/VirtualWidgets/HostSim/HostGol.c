@@ -0,0 +1,306 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Minimal GOL Layer for the host PC
+// *****************************************************************************
+// FileName:        HostGol.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Object list, GOLDraw() loop, panel drawing and a stub Button, enough to run
+// the VirtualWidgets DrawObj state machines exactly as the GOL does on target.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Interleaved drawing (HostGolInterleave)
+//  2026/10/17	Simulated tick, SuperGauge animation re-arm
+//  2026/10/17	Object being drawn kept in HostGfxOwner
+// *****************************************************************************
+#include <string.h>
+#include "HostGfx.h"
+#include "SuperGauge.h"
+#include "VuMeter.h"
+#include "BarGraph.h"
+
+GOL_SCHEME *_pDefaultGolScheme;
+DWORD tick = 0;
+
+static OBJ_HEADER *_pGolObjects = NULL;
+WORD HostGolInterleave = 0;
+WORD HostGolLoopTicks = 5;
+static DWORD _lastBusTimeNs = 0, _busTimeNs = 0;
+
+GOL_SCHEME *GOLCreateScheme(void) {
+    GOL_SCHEME *pScheme = (GOL_SCHEME *) GFX_malloc(sizeof (GOL_SCHEME));
+
+    if (pScheme != NULL) {
+        pScheme->EmbossDkColor = DARKGRAY;
+        pScheme->EmbossLtColor = LIGHTGRAY;
+        pScheme->TextColor0 = BLACK;
+        pScheme->TextColor1 = WHITE;
+        pScheme->TextColorDisabled = GRAY;
+        pScheme->Color0 = RGBConvert(0, 64, 128);
+        pScheme->Color1 = RGBConvert(255, 128, 0);
+        pScheme->ColorDisabled = GRAY;
+        pScheme->CommonBkColor = RGBConvert(32, 32, 32);
+        pScheme->pFont = &FONTDEFAULT;
+        pScheme->AlphaValue = 100;
+    }
+    return pScheme;
+}
+
+void GOLInit(void) {
+    ResetDevice();
+    _pGolObjects = NULL;
+    if (_pDefaultGolScheme == NULL)
+        _pDefaultGolScheme = GOLCreateScheme();
+}
+
+void GOLAddObject(OBJ_HEADER *object) {
+    OBJ_HEADER *pCurr;
+
+    object->pNxtObj = NULL;
+    if (_pGolObjects == NULL) {
+        _pGolObjects = object;
+        return;
+    }
+    pCurr = _pGolObjects;
+    while (pCurr->pNxtObj != NULL)
+        pCurr = (OBJ_HEADER *) pCurr->pNxtObj;
+    pCurr->pNxtObj = (void *) object;
+}
+
+OBJ_HEADER *GOLFindObject(WORD ID) {
+    OBJ_HEADER *pCurr = _pGolObjects;
+
+    while (pCurr != NULL) {
+        if (pCurr->ID == ID) return pCurr;
+        pCurr = (OBJ_HEADER *) pCurr->pNxtObj;
+    }
+    return NULL;
+}
+
+void GOLFree(void) {
+    OBJ_HEADER *pCurr = _pGolObjects, *pNext;
+
+    while (pCurr != NULL) {
+        pNext = (OBJ_HEADER *) pCurr->pNxtObj;
+        if (pCurr->FreeObj != NULL)
+            pCurr->FreeObj(pCurr);
+        GFX_free(pCurr);
+        pCurr = pNext;
+    }
+    _pGolObjects = NULL;
+}
+
+// Draws every object with pending draw bits. Like GOLDraw() on target it returns 0
+// while an object is still in progress and resumes from it on the next call.
+// With HostGolInterleave set, the other objects are given a turn first.
+// The animation re-arm of the generated ScreenCode is reproduced here so that
+// animating widgets keep being redrawn until they settle.
+// Each complete pass advances tick by HostGolLoopTicks plus the bus time spent
+// drawing, as the 1ms timer of the target would.
+WORD GOLDraw(void) {
+    static OBJ_HEADER *pCurrentObj = NULL;
+    static WORD inProgress = 0;
+    WORD done;
+
+    if (pCurrentObj == NULL)
+        pCurrentObj = _pGolObjects;
+    while (pCurrentObj != NULL) {
+        if (IsObjUpdated(pCurrentObj)) {
+            HostGfxStats.DrawCalls++;
+            HostGfxOwner = pCurrentObj;
+            done = pCurrentObj->DrawObj(pCurrentObj);
+            HostGfxOwner = NULL;
+            if (done == 0) {
+                HostGfxStats.BusyReturns++;
+                if (!HostGolInterleave)
+                    return 0;
+                inProgress = 1;
+            } else
+                GOLDrawComplete(pCurrentObj);
+        }
+        pCurrentObj = (OBJ_HEADER *) pCurrentObj->pNxtObj;
+    }
+    if (inProgress) {
+        inProgress = 0;
+        return 0;
+    }
+    if (HostGfxStats.BusTimeNs < _lastBusTimeNs) // counters reset
+        _lastBusTimeNs = 0;
+    _busTimeNs += HostGfxStats.BusTimeNs - _lastBusTimeNs;
+    _lastBusTimeNs = HostGfxStats.BusTimeNs;
+    tick += HostGolLoopTicks + _busTimeNs / 1000000L;
+    _busTimeNs %= 1000000L;
+
+    for (pCurrentObj = _pGolObjects; pCurrentObj != NULL; pCurrentObj = (OBJ_HEADER *) pCurrentObj->pNxtObj) {
+        if (pCurrentObj->DrawObj == SgDraw && GetState(pCurrentObj, SG_DRAW_ANIMATING))
+            SetState(pCurrentObj, SG_DRAW_UPDATE);
+        else if (pCurrentObj->DrawObj == VuDraw && GetState(pCurrentObj, VU_DRAW_ANIMATING))
+            SetState(pCurrentObj, VU_DRAW_UPDATE);
+        else if (pCurrentObj->DrawObj == BgDraw && GetState(pCurrentObj, BG_DRAW_ANIMATING))
+            SetState(pCurrentObj, BG_DRAW_UPDATE);
+    }
+    pCurrentObj = NULL;
+    return 1;
+}
+
+WORD HostGolPending(void) {
+    OBJ_HEADER *pCurr;
+
+    for (pCurr = _pGolObjects; pCurr != NULL; pCurr = (OBJ_HEADER *) pCurr->pNxtObj)
+        if (IsObjUpdated(pCurr)) return 1;
+    return 0;
+}
+
+void GOLMsg(GOL_MSG *pMsg) {
+    OBJ_HEADER *pCurr;
+    WORD translatedMsg;
+
+    for (pCurr = _pGolObjects; pCurr != NULL; pCurr = (OBJ_HEADER *) pCurr->pNxtObj) {
+        if (pCurr->MsgObj == NULL) continue;
+        translatedMsg = pCurr->MsgObj(pCurr, pMsg);
+        if (translatedMsg == OBJ_MSG_INVALID) continue;
+        if (pCurr->MsgDefaultObj != NULL)
+            pCurr->MsgDefaultObj(translatedMsg, pCurr, pMsg);
+    }
+}
+
+char *myitoa(char *buffer, INT32 value, BYTE radix) {
+    char tmp[12];
+    BYTE i = 0, j = 0;
+    DWORD v = value < 0 ? -(DWORD) value : (DWORD) value;
+
+    do {
+        BYTE d = v % radix;
+        tmp[i++] = d < 10 ? '0' + d : 'A' + d - 10;
+        v /= radix;
+    } while (v);
+    if (value < 0) buffer[j++] = '-';
+    while (i) buffer[j++] = tmp[--i];
+    buffer[j] = 0;
+    return buffer;
+}
+
+// *****************************************************************************
+// Panel
+// *****************************************************************************
+
+static SHORT _panelLeft, _panelTop, _panelRight, _panelBottom, _panelRadius, _panelEmbossSize;
+static GFX_COLOR _panelFaceColor, _panelEmbossLtColor, _panelEmbossDkColor;
+static void *_panelBitmap;
+
+void GOLPanelDraw(SHORT left, SHORT top, SHORT right, SHORT bottom, SHORT radius,
+        GFX_COLOR faceClr, GFX_COLOR embossLtClr, GFX_COLOR embossDkClr, void *pBitmap, SHORT embossSize) {
+    _panelLeft = left;
+    _panelTop = top;
+    _panelRight = right;
+    _panelBottom = bottom;
+    _panelRadius = radius;
+    _panelFaceColor = faceClr;
+    _panelEmbossLtColor = embossLtClr;
+    _panelEmbossDkColor = embossDkClr;
+    _panelBitmap = pBitmap;
+    _panelEmbossSize = embossSize;
+}
+
+WORD GOLPanelDrawTsk(void) {
+    SHORT i;
+
+    if (_panelEmbossSize > 0) {
+        SetColor(_panelEmbossLtColor);
+        for (i = 0; i < _panelEmbossSize; i++) {
+            Bar(_panelLeft + i, _panelTop + i, _panelRight - i, _panelTop + i);
+            Bar(_panelLeft + i, _panelTop + i, _panelLeft + i, _panelBottom - i);
+        }
+        SetColor(_panelEmbossDkColor);
+        for (i = 0; i < _panelEmbossSize; i++) {
+            Bar(_panelLeft + i, _panelBottom - i, _panelRight - i, _panelBottom - i);
+            Bar(_panelRight - i, _panelTop + i, _panelRight - i, _panelBottom - i);
+        }
+    }
+    SetColor(_panelFaceColor);
+    if (_panelRadius)
+        FillBevel(_panelLeft + _panelRadius, _panelTop + _panelRadius,
+            _panelRight - _panelRadius, _panelBottom - _panelRadius, _panelRadius);
+    else
+        Bar(_panelLeft + _panelEmbossSize, _panelTop + _panelEmbossSize,
+            _panelRight - _panelEmbossSize, _panelBottom - _panelEmbossSize);
+    if (_panelBitmap != NULL)
+        PutImage(((_panelLeft + _panelRight) - GetImageWidth(_panelBitmap)) >> 1,
+            ((_panelTop + _panelBottom) - GetImageHeight(_panelBitmap)) >> 1, _panelBitmap, IMAGE_NORMAL);
+    return 1;
+}
+
+// *****************************************************************************
+// Button (used by MsgBox)
+// *****************************************************************************
+
+WORD BtnDraw(void *pObj) {
+    BUTTON *pB = (BUTTON *) pObj;
+    GOL_SCHEME *pScheme = pB->hdr.pGolScheme;
+
+    if (GetState(pB, BTN_HIDE)) {
+        SetColor(pScheme->CommonBkColor);
+        return Bar(pB->hdr.left, pB->hdr.top, pB->hdr.right, pB->hdr.bottom);
+    }
+    if (pB->pBitmap != NULL && GetState(pB, BTN_NOPANEL))
+        PutImage(pB->hdr.left, pB->hdr.top, pB->pBitmap, IMAGE_NORMAL);
+    else {
+        GOLPanelDraw(pB->hdr.left, pB->hdr.top, pB->hdr.right, pB->hdr.bottom, pB->radius,
+                GetState(pB, BTN_PRESSED) ? pScheme->Color1 : pScheme->Color0,
+                pScheme->EmbossLtColor, pScheme->EmbossDkColor, pB->pBitmap, GOL_EMBOSS_SIZE);
+        GOLPanelDrawTsk();
+    }
+    if (pB->pText != NULL) {
+        SetFont(pScheme->pFont);
+        SetColor(GetState(pB, BTN_PRESSED) ? pScheme->TextColor1 : pScheme->TextColor0);
+        OutTextXY((pB->hdr.left + pB->hdr.right - pB->textWidth) >> 1,
+                (pB->hdr.top + pB->hdr.bottom - pB->textHeight) >> 1, pB->pText);
+    }
+    return 1;
+}
+
+WORD BtnTranslateMsg(void *pObj, GOL_MSG *pMsg) {
+    BUTTON *pB = (BUTTON *) pObj;
+
+    if (pMsg->type != TYPE_TOUCHSCREEN || GetState(pB, BTN_DISABLED)) return OBJ_MSG_INVALID;
+    if (pMsg->param1 < pB->hdr.left || pMsg->param1 > pB->hdr.right ||
+            pMsg->param2 < pB->hdr.top || pMsg->param2 > pB->hdr.bottom) {
+        if (GetState(pB, BTN_PRESSED)) return BTN_MSG_CANCELPRESS;
+        return OBJ_MSG_INVALID;
+    }
+    if (pMsg->uiEvent == EVENT_PRESS) return BTN_MSG_PRESSED;
+    if (pMsg->uiEvent == EVENT_STILLPRESS) return BTN_MSG_STILLPRESSED;
+    if (pMsg->uiEvent == EVENT_RELEASE) return BTN_MSG_RELEASED;
+    return OBJ_MSG_INVALID;
+}
+
+BUTTON *BtnCreate(WORD ID, SHORT left, SHORT top, SHORT right, SHORT bottom, SHORT radius,
+        WORD state, void *pBitmap, XCHAR *pText, GOL_SCHEME *pScheme) {
+    BUTTON *pB = (BUTTON *) GFX_malloc(sizeof (BUTTON));
+
+    if (pB == NULL) return NULL;
+    memset(pB, 0, sizeof (BUTTON));
+    pB->hdr.ID = ID;
+    pB->hdr.type = OBJ_BUTTON;
+    pB->hdr.state = state;
+    pB->hdr.left = left;
+    pB->hdr.top = top;
+    pB->hdr.right = right;
+    pB->hdr.bottom = bottom;
+    pB->hdr.pGolScheme = pScheme != NULL ? pScheme : _pDefaultGolScheme;
+    pB->hdr.DrawObj = BtnDraw;
+    pB->hdr.MsgObj = BtnTranslateMsg;
+    pB->radius = radius;
+    pB->pBitmap = pBitmap;
+    pB->pText = pText;
+    if (pText != NULL) {
+        pB->textWidth = GetTextWidth(pText, pB->hdr.pGolScheme->pFont);
+        pB->textHeight = GetTextHeight(pB->hdr.pGolScheme->pFont);
+    }
+    GOLAddObject((OBJ_HEADER *) pB);
+    return pB;
+}
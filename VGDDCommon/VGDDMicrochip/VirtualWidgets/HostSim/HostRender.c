@@ -0,0 +1,201 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Headless render of every VirtualWidget with per-redraw cost counters
+// *****************************************************************************
+// FileName:        HostRender.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Creates one instance of each VirtualWidget on a 480x272 screen, draws it,
+// then drives value changes through the GOL loop and prints what every redraw
+// costs in terms of driver traffic (see HostGfx.h).
+// Optionally writes the final framebuffer to a PPM file.
+// Exits with 2 if a widget wrote any pixel outside its own rectangle.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -I../Resources/Source -o HostRender HostRender.c HostScene.c HostGfx.c HostGol.c ../Resources/Source/*.c -lm
+//
+// Usage:
+//   HostRender [-o screen.ppm] [-b busyPeriod] [-i]
+//     -o  write the final screen to screen.ppm
+//     -b  let IsDeviceBusy() report busy once every busyPeriod calls, to
+//         exercise the re-entrant paths of the DrawObj state machines
+//     -i  let GOLDraw() draw the other objects while one is busy
+//   With -b or -i the whole sequence is first drawn without them, quietly,
+//   and the tool exits with 3 if the final screens differ in any pixel.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	SuperGauge with and without dial cache
+//  2026/10/17	Interleaved drawing option
+//  2026/10/17	Single steps settled through GOLDraw(), animations are tick driven
+//  2026/10/17	Fails on writes outside the widget rectangles
+//  2026/10/17	-b and -i checked against a reference render
+//  2026/10/17	SuperGauge without sub-divisions
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostScene.h"
+
+static WORD HostQuiet = 0; // Reference render: no report
+
+static void HostReport(const char *label, OBJ_HEADER *pObj) {
+    HOSTGFX_STATS stats;
+
+    HostGfxMeasureDraw(pObj, &stats);
+    if (!HostQuiet)
+        HostGfxPrintStats(stdout, label, &stats);
+}
+
+static void HostSettle(const char *label) {
+    HOSTGFX_STATS stats;
+    WORD frames;
+
+    frames = HostSceneSettle(1000, &stats);
+    if (HostQuiet)
+        return;
+    HostGfxPrintStats(stdout, label, &stats);
+    printf("%-28s frames %u\n", "", frames);
+}
+
+static void HostTitle(const char *title) {
+    if (!HostQuiet)
+        printf("%s\n", title);
+}
+
+// Draws the whole sequence. Returns 1 on success, 0 if a widget cannot be created.
+static int HostRun(void) {
+    HOST_SCENE scene;
+
+    if (!HostSceneCreate(&scene)) {
+        fprintf(stderr, "Widget creation failed\n");
+        return 0;
+    }
+
+    HostTitle("Full draw");
+    HostReport("SuperGauge", &scene.pSg->hdr);
+    HostReport("SuperGaugeHalf", &scene.pSgHalf->hdr);
+    HostReport("SuperGaugeNoSub", &scene.pSgNoSub->hdr);
+    HostReport("VuMeter", &scene.pVu->hdr);
+    HostReport("BarGraph", &scene.pBg->hdr);
+    HostReport("Disp7Seg", &scene.pD7->hdr);
+    HostReport("Indicator", &scene.pInd->hdr);
+    HostReport("StaticTextEx", &scene.pSt->hdr);
+    HostReport("TextEntryEx", &scene.pTeEx->hdr);
+
+    // StaticTextEx still keeps its drawing progress and clipping across busy
+    // returns in static variables, so it is left out of the interleaved redraw
+    if (HostGolInterleave) {
+        HostTitle("Full redraw, interleaved");
+        SetState(scene.pSg, SG_DRAW);
+        SetState(scene.pSgHalf, SG_DRAW);
+        SetState(scene.pSgNoSub, SG_DRAW);
+        SetState(scene.pVu, VU_DRAWALL);
+        SetState(scene.pBg, BG_DRAWALL);
+        SetState(scene.pD7, D7_DRAW);
+        SetState(scene.pInd, IND_DRAW);
+        SetState(scene.pTeEx, TEEX_DRAW);
+        HostSettle("All");
+    }
+
+    HostTitle("Value update 0 -> 75 (until settled)");
+    SgSetVal(scene.pSg, 75);
+    SetState(scene.pSg, SG_DRAW_UPDATE);
+    HostSettle("SuperGauge");
+    SgSetVal(scene.pSgHalf, 75);
+    SetState(scene.pSgHalf, SG_DRAW_UPDATE);
+    HostSettle("SuperGaugeHalf");
+    SgSetVal(scene.pSgNoSub, 75);
+    SetState(scene.pSgNoSub, SG_DRAW_UPDATE);
+    HostSettle("SuperGaugeNoSub");
+    VuSetVal(scene.pVu, 75);
+    SetState(scene.pVu, VU_DRAW_UPDATE);
+    HostSettle("VuMeter");
+    BgSetVal(scene.pBg, 75);
+    SetState(scene.pBg, BG_DRAW_UPDATE);
+    HostSettle("BarGraph");
+    D7SetVal(scene.pD7, 5678);
+    SetState(scene.pD7, D7_UPDATE);
+    HostSettle("Disp7Seg");
+
+    // The animations only move at their next step (see WidgetAnim.h), so single
+    // steps go through GOLDraw() too
+    HostTitle("Single step update 75 -> 76");
+    SgSetVal(scene.pSg, 76);
+    SetState(scene.pSg, SG_DRAW_UPDATE);
+    HostSettle("SuperGauge");
+    SgSetVal(scene.pSgHalf, 76);
+    SetState(scene.pSgHalf, SG_DRAW_UPDATE);
+    HostSettle("SuperGaugeHalf");
+    VuSetVal(scene.pVu, 76);
+    SetState(scene.pVu, VU_DRAW_UPDATE);
+    HostSettle("VuMeter");
+    BgSetVal(scene.pBg, 76);
+    SetState(scene.pBg, BG_DRAW_UPDATE);
+    HostSettle("BarGraph");
+    D7SetVal(scene.pD7, 5679);
+    SetState(scene.pD7, D7_UPDATE);
+    HostReport("Disp7Seg", &scene.pD7->hdr);
+
+    HostTitle("Popup");
+    HostGolInterleave = 0; // the MsgBox buttons overlap the MsgBox and must be drawn after it
+    if (HostSceneCreateMsgBox() == NULL) {
+        fprintf(stderr, "MsgBox creation failed\n");
+        return 0;
+    }
+    HostSettle("MsgBox");
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    const char *ppmFile = NULL;
+    GFX_COLOR *pReference = NULL;
+    WORD busyPeriod = 0, interleave = 0;
+    DWORD diff;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0)
+            interleave = 1;
+        else if (i == argc - 1)
+            break;
+        else if (strcmp(argv[i], "-o") == 0)
+            ppmFile = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0)
+            busyPeriod = (WORD) atoi(argv[++i]);
+    }
+
+    if (busyPeriod || interleave) {
+        pReference = (GFX_COLOR *) malloc(sizeof (HostFrameBuffer));
+        HostQuiet = 1;
+        if (pReference == NULL || !HostRun())
+            return 1;
+        HostGfxSnapshot(pReference);
+        HostQuiet = 0;
+    }
+    HostGfxBusyPeriod = busyPeriod;
+    HostGolInterleave = interleave;
+    if (!HostRun())
+        return 1;
+
+    if (HostGfxStats.OutsideWrites) {
+        fprintf(stderr, "%lu pixels written outside their widget, the first by ID %u at %d,%d\n",
+                (unsigned long) HostGfxStats.OutsideWrites, HostGfxOutside.ID, HostGfxOutside.x, HostGfxOutside.y);
+        return 2;
+    }
+    if (ppmFile != NULL && !HostGfxSavePPM(ppmFile)) {
+        fprintf(stderr, "Cannot write %s\n", ppmFile);
+        return 1;
+    }
+    if (pReference != NULL) {
+        diff = HostGfxCompare(pReference);
+        free(pReference);
+        printf("Pixels different from the reference render: %lu\n", (unsigned long) diff);
+        if (diff)
+            return 3;
+    }
+    return 0;
+}
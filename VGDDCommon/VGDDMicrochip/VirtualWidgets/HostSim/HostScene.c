@@ -0,0 +1,123 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Reference screen shared by the host tools
+// *****************************************************************************
+// FileName:        HostScene.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Second SuperGauge without dial cache
+//  2026/10/17	Third SuperGauge without sub-divisions
+// *****************************************************************************
+#include <stdlib.h>
+#include "HostScene.h"
+
+#define W(v)    (BYTE)(((v) >> 8) & 0xff), (BYTE)((v) & 0xff)
+
+// Widget parameter blocks as emitted by the code generator: length, big-endian
+// fields, XOR checksum. The checksum is filled in by HostSealParams().
+static BYTE SgParams[] = {29, W(0), W(0), W(100), SUPERGAUGE_FULL360, SG_POINTER_NORMAL,
+    W(135), W(405), 10, 5, W(0), W(20), W(60), 10, 3, 8, 14, W(0), W(30), 0};
+static BYTE SgHalfParams[] = {29, W(0), W(0), W(100), SUPERGAUGE_HALF180UP, SG_POINTER_NORMAL,
+    W(180), W(360), 5, 4, W(0), W(20), W(60), 10, 0, 8, 14, W(0), W(0), 0};
+static BYTE SgNoSubParams[] = {29, W(0), W(0), W(100), SUPERGAUGE_FULL360, SG_POINTER_NORMAL,
+    W(135), W(405), 5, 0, W(0), W(10), W(30), 6, 0, 8, 14, W(0), W(0), 0};
+static BYTE VuParams[] = {23, W(0), W(0), W(100), VU_POINTER_NORMAL, W(200), W(340),
+    W(50), W(5), W(85), 6, 1, 2, W(10), 0};
+static BYTE BgParams[] = {13, W(0), W(0), W(100), 1, BARGRPHSTYLE_BLOCK, W(20), W(5), 0};
+static BYTE TeExParams[] = {21, W(4), W(12), W(0), W(0), W(0), W(4), W(3), W(16), W(3), W(3), 0};
+
+static WORD SgSegments[] = {0, 60, RGBConvert(0, 160, 0), 60, 85, RGBConvert(220, 200, 0), 85, 100, RGBConvert(200, 0, 0)};
+static BgSegment BgSegments[] = {
+    {0, 70, RGBConvert(0, 160, 0)},
+    {70, 90, RGBConvert(220, 200, 0)},
+    {90, 100, RGBConvert(200, 0, 0)}
+};
+
+static XCHAR *TeExKeys[] = {"1", "2", "3", "4", "5", "6", "7", "8", "9", "*", "0", "<"};
+static SHORT TeExCommandKeys[] = {12, 0, 0, 0, 0};
+static XCHAR TeExBuffer[17];
+
+static FONT_FLASH ScaleFont = {FLASH, 6, 10};
+static IMAGE_FLASH *VuBitmap = NULL;
+
+static void *HostSealParams(BYTE *p) {
+    BYTE i, cs = 0;
+
+    for (i = 0; i < p[0]; i++) cs ^= p[i];
+    p[p[0]] = cs;
+    return p;
+}
+
+// Builds a 16bpp gradient bitmap in RAM, laid out as the Graphics Resource Converter would in flash
+static IMAGE_FLASH *HostMakeBitmap(SHORT width, SHORT height) {
+    IMAGE_FLASH *pImage = (IMAGE_FLASH *) malloc(sizeof (IMAGE_FLASH));
+    BYTE *pData = (BYTE *) malloc(sizeof (BITMAP_HEADER) + (DWORD) width * height * 2);
+    BITMAP_HEADER *pHeader = (BITMAP_HEADER *) pData;
+    BYTE *pPixel = pData + sizeof (BITMAP_HEADER);
+    GFX_COLOR c;
+    SHORT x, y;
+
+    pHeader->compression = 0;
+    pHeader->colorDepth = 16;
+    pHeader->width = width;
+    pHeader->height = height;
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            c = RGBConvert(240 - y, 230 - (x >> 2), 180);
+            *pPixel++ = (BYTE) c;
+            *pPixel++ = (BYTE) (c >> 8);
+        }
+    }
+    pImage->type = FLASH;
+    pImage->address = pData;
+    return pImage;
+}
+
+WORD HostSceneCreate(HOST_SCENE *pScene) {
+    GOLFree();
+    GOLInit();
+    SetColor(_pDefaultGolScheme->CommonBkColor);
+    ClearDevice();
+    if (VuBitmap == NULL)
+        VuBitmap = HostMakeBitmap(160, 100);
+
+    pScene->pSg = SgCreate(ID_SUPERGAUGE, 0, 0, 159, 159, SG_DRAW | SG_DIAL_CACHE, &ScaleFont, "km/h",
+            sizeof (SgSegments) / sizeof (SgSegment), SgSegments, HostSealParams(SgParams), NULL);
+    pScene->pSgHalf = SgCreate(ID_SUPERGAUGE_HALF, 0, 185, 159, 264, SG_DRAW, &ScaleFont, "rpm",
+            sizeof (SgSegments) / sizeof (SgSegment), SgSegments, HostSealParams(SgHalfParams), NULL);
+    pScene->pSgNoSub = SgCreate(ID_SUPERGAUGE_NOSUB, 165, 140, 244, 219, SG_DRAW, &ScaleFont, "bar",
+            sizeof (SgSegments) / sizeof (SgSegment), SgSegments, HostSealParams(SgNoSubParams), NULL);
+    pScene->pVu = VuCreate(ID_VUMETER, 165, 0, 324, 99, VU_DRAWALL | VU_POINTER_THICK,
+            HostSealParams(VuParams), VuBitmap, NULL);
+    pScene->pBg = BgCreate(ID_BARGRAPH, 165, 105, 324, 135, BG_DRAWALL,
+            sizeof (BgSegments) / sizeof (BgSegment), BgSegments, HostSealParams(BgParams), NULL);
+    pScene->pD7 = D7Create(ID_DISP7SEG, 330, 0, 479, 49, D7_DRAW | D7_FRAME, 1234, 5, 0, 3, _pDefaultGolScheme);
+    pScene->pInd = IndCreate(ID_INDICATOR, 330, 55, 479, 79, IND_DRAW, 1, 0, RGBConvert(0, 200, 0), "Ready", _pDefaultGolScheme);
+    pScene->pSt = StExCreate(ID_STATICTEXTEX, 330, 85, 479, 109, STEX_DRAW | STEX_FRAME, "VirtualWidgets", NULL);
+    pScene->pTeEx = TeExCreate(ID_TEXTENTRYEX, 250, 140, 479, 271, TEEX_DRAW, TeExKeys, TeExKeys, TeExKeys, TeExKeys,
+            TeExCommandKeys, TeExBuffer, NULL, NULL, NULL, HostSealParams(TeExParams), NULL);
+    return pScene->pSg && pScene->pSgHalf && pScene->pSgNoSub && pScene->pVu && pScene->pBg && pScene->pD7 && pScene->pInd && pScene->pSt && pScene->pTeEx;
+}
+
+MSGBOX *HostSceneCreateMsgBox(void) {
+    return MsgBoxCreate(ID_MSGBOX, 120, 60, 360, 200, 8, BTN_YES_NO, "Save changes?", "VGDD",
+            MSGBOX_DRAW, NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+WORD HostSceneSettle(WORD maxFrames, HOSTGFX_STATS *pStats) {
+    HOSTGFX_STATS before = HostGfxStats;
+    DWORD *pAfter = (DWORD *) & HostGfxStats, *pBefore = (DWORD *) & before, *pResult = (DWORD *) pStats;
+    WORD i, frames;
+
+    for (frames = 0; frames < maxFrames && HostGolPending(); frames++) {
+        while (!GOLDraw());
+    }
+    for (i = 0; i < sizeof (HOSTGFX_STATS) / sizeof (DWORD); i++)
+        pResult[i] = pAfter[i] - pBefore[i];
+    return frames;
+}
@@ -0,0 +1,71 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Reference screen shared by the host tools
+// *****************************************************************************
+// FileName:        HostScene.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// One instance of every VirtualWidget laid out on a 480x272 screen, created
+// with parameter blocks in the same format the code generator emits.
+// The full SuperGauge keeps a dial cache (SG_DIAL_CACHE), the half one does not.
+// The third SuperGauge has no sub-divisions (DialScaleNumSubDivisions 0).
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Second SuperGauge without dial cache
+//  2026/10/17	Third SuperGauge without sub-divisions
+// *****************************************************************************
+#ifndef _HOSTSCENE_H
+#define _HOSTSCENE_H
+
+#include "HostGfx.h"
+#include "SuperGauge.h"
+#include "VuMeter.h"
+#include "BarGraph.h"
+#include "Disp7Seg.h"
+#include "Indicator.h"
+#include "StaticTextEx.h"
+#include "TextEntryEx.h"
+#include "MsgBox.h"
+
+enum {
+    ID_SUPERGAUGE = 1,
+    ID_SUPERGAUGE_HALF,
+    ID_SUPERGAUGE_NOSUB,
+    ID_VUMETER,
+    ID_BARGRAPH,
+    ID_DISP7SEG,
+    ID_INDICATOR,
+    ID_STATICTEXTEX,
+    ID_TEXTENTRYEX,
+    ID_MSGBOX
+};
+
+typedef struct {
+    SUPERGAUGE *pSg;
+    SUPERGAUGE *pSgHalf;
+    SUPERGAUGE *pSgNoSub;
+    VUMETER *pVu;
+    BARGRAPH *pBg;
+    DISP7SEG *pD7;
+    INDICATOR *pInd;
+    STATICTEXTEX *pSt;
+    TEXTENTRYEX *pTeEx;
+} HOST_SCENE;
+
+// Resets the GOL and the screen, then creates every widget with its draw bit set.
+// Returns 0 if any of the widgets could not be created.
+WORD HostSceneCreate(HOST_SCENE *pScene);
+
+// Creates the popup used to measure MsgBox over the other widgets
+MSGBOX *HostSceneCreateMsgBox(void);
+
+// Runs GOLDraw() until no object has draw bits pending (animations included)
+// or maxFrames complete passes have been made. Returns the number of passes and
+// the cost of all of them in *pStats.
+WORD HostSceneSettle(WORD maxFrames, HOSTGFX_STATS *pStats);
+
+#endif // _HOSTSCENE_H
@@ -0,0 +1 @@
+#include "Graphics/Button.h"
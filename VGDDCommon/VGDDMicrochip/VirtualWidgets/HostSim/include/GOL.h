@@ -0,0 +1 @@
+#include "Graphics/GOL.h"
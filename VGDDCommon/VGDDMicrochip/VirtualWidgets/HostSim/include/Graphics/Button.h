@@ -0,0 +1,50 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Stand-in for the Microchip Graphics Library Button widget
+// *****************************************************************************
+// FileName:        Button.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Only what MsgBox needs to create and draw its buttons.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _BUTTON_H
+#define _BUTTON_H
+
+#include "Graphics/GOL.h"
+
+#define BTN_FOCUSED     0x0001
+#define BTN_DISABLED    0x0002
+#define BTN_PRESSED     0x0004
+#define BTN_NOPANEL     0x0010
+#define BTN_DRAW_FOCUS  0x2000
+#define BTN_DRAW        0x4000
+#define BTN_HIDE        0x8000
+
+#define BTN_MSG_PRESSED     (OBJ_MSG_PASSIVE + 1)
+#define BTN_MSG_STILLPRESSED (OBJ_MSG_PASSIVE + 2)
+#define BTN_MSG_RELEASED    (OBJ_MSG_PASSIVE + 3)
+#define BTN_MSG_CANCELPRESS (OBJ_MSG_PASSIVE + 4)
+
+typedef struct {
+    OBJ_HEADER hdr;
+    SHORT radius;
+    SHORT textWidth;
+    SHORT textHeight;
+    XCHAR *pText;
+    void *pBitmap;
+} BUTTON;
+
+BUTTON *BtnCreate(WORD ID, SHORT left, SHORT top, SHORT right, SHORT bottom, SHORT radius,
+        WORD state, void *pBitmap, XCHAR *pText, GOL_SCHEME *pScheme);
+WORD BtnDraw(void *pObj);
+WORD BtnTranslateMsg(void *pObj, GOL_MSG *pMsg);
+
+#define BtnSetBitmap(pB, pBtmap)    (((BUTTON *)(pB))->pBitmap = (pBtmap))
+
+#endif // _BUTTON_H
@@ -0,0 +1,48 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Stand-in for the Microchip Graphics Library Display Driver Layer
+// *****************************************************************************
+// FileName:        DisplayDriver.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The host display is an in-memory RGB565 framebuffer (see HostGfx.h).
+// GetPixel() reads it back (GFX_DRV_GETPIXEL), unless HOST_NO_GETPIXEL is
+// defined on the command line to build as for a driver that cannot.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	GFX_DRV_GETPIXEL
+// *****************************************************************************
+#ifndef _DISPLAYDRIVER_H
+#define _DISPLAYDRIVER_H
+
+#include "GenericTypeDefs.h"
+#include "Graphics/Primitive.h"
+
+#ifndef DISP_HOR_RESOLUTION
+#define DISP_HOR_RESOLUTION 480
+#endif
+#ifndef DISP_VER_RESOLUTION
+#define DISP_VER_RESOLUTION 272
+#endif
+
+#define GetMaxX()   (DISP_HOR_RESOLUTION - 1)
+#define GetMaxY()   (DISP_VER_RESOLUTION - 1)
+
+#ifndef HOST_NO_GETPIXEL
+#define GFX_DRV_GETPIXEL
+#endif
+
+void ResetDevice(void);
+void PutPixel(SHORT x, SHORT y);
+GFX_COLOR GetPixel(SHORT x, SHORT y);
+WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom);
+void ClearDevice(void);
+WORD IsDeviceBusy(void);
+void SetClipRgn(SHORT left, SHORT top, SHORT right, SHORT bottom);
+void SetClip(BYTE control);
+
+#endif // _DISPLAYDRIVER_H
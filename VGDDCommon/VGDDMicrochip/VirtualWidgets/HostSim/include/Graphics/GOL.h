@@ -0,0 +1,148 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Stand-in for the Microchip Graphics Library GOL Layer
+// *****************************************************************************
+// FileName:        GOL.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Object header, schemes, messages and the GOL list/draw API, laid out as in
+// Graphics Library v3.x so the VirtualWidgets compile unchanged.
+// The implementation lives in HostGol.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GOL_H
+#define _GOL_H
+
+#include <stdlib.h>
+#include "GenericTypeDefs.h"
+#include "Graphics/Primitive.h"
+#include "Graphics/DisplayDriver.h"
+
+#define GOL_EMBOSS_SIZE 3
+
+// Object types
+typedef enum {
+    OBJ_BUTTON,
+    OBJ_WINDOW,
+    OBJ_CHECKBOX,
+    OBJ_RADIOBUTTON,
+    OBJ_EDITBOX,
+    OBJ_LISTBOX,
+    OBJ_SLIDER,
+    OBJ_PROGRESSBAR,
+    OBJ_STATICTEXT,
+    OBJ_PICTURE,
+    OBJ_GROUPBOX,
+    OBJ_CUSTOM,
+    OBJ_ROUNDDIAL,
+    OBJ_METER,
+    OBJ_GRID,
+    OBJ_CHART,
+    OBJ_TEXTENTRY,
+    OBJ_DIGITALMETER,
+    OBJ_ANALOGCLOCK,
+    OBJ_UNKNOWN
+} GOL_OBJ_TYPE;
+
+// Translated messages
+#define OBJ_MSG_INVALID 0
+#define OBJ_MSG_PASSIVE 0x1000
+
+// Input device types
+typedef enum {
+    TYPE_UNKNOWN = 0,
+    TYPE_KEYBOARD,
+    TYPE_TOUCHSCREEN,
+    TYPE_MOUSE,
+    TYPE_TIMER,
+    TYPE_SYSTEM
+} INPUT_DEVICE_TYPE;
+
+// Input device events
+typedef enum {
+    EVENT_INVALID = 0,
+    EVENT_MOVE,
+    EVENT_PRESS,
+    EVENT_STILLPRESS,
+    EVENT_RELEASE,
+    EVENT_KEYSCAN,
+    EVENT_CHARCODE,
+    EVENT_SET,
+    EVENT_SET_STATE,
+    EVENT_CLR_STATE
+} INPUT_DEVICE_EVENT;
+
+typedef struct {
+    BYTE type;      // Type of input device (INPUT_DEVICE_TYPE)
+    BYTE uiEvent;   // The generic events for input device (INPUT_DEVICE_EVENT)
+    SHORT param1;   // Parameter 1 meaning is dependent on the type of input device
+    SHORT param2;   // Parameter 2 meaning is dependent on the type of input device
+} GOL_MSG;
+
+typedef struct {
+    GFX_COLOR EmbossDkColor;
+    GFX_COLOR EmbossLtColor;
+    GFX_COLOR TextColor0;
+    GFX_COLOR TextColor1;
+    GFX_COLOR TextColorDisabled;
+    GFX_COLOR Color0;
+    GFX_COLOR Color1;
+    GFX_COLOR ColorDisabled;
+    GFX_COLOR CommonBkColor;
+    void *pFont;
+    BYTE AlphaValue;
+} GOL_SCHEME;
+
+typedef WORD (*DRAW_FUNC)(void *);
+typedef void (*FREE_FUNC)(void *);
+typedef WORD (*MSG_FUNC)(void *, GOL_MSG *);
+typedef void (*MSG_DEFAULT_FUNC)(WORD, void *, GOL_MSG *);
+
+typedef struct {
+    WORD ID;                        // Unique id assigned for referencing
+    void *pNxtObj;                  // A pointer to the next object
+    GOL_OBJ_TYPE type;              // Identifies the type of GOL object
+    WORD state;                     // State of object
+    SHORT left;                     // Left position of the Object
+    SHORT top;                      // Top position of the Object
+    SHORT right;                    // Right position of the Object
+    SHORT bottom;                   // Bottom position of the Object
+    GOL_SCHEME *pGolScheme;         // Pointer to the scheme used by the Object
+    DRAW_FUNC DrawObj;              // Function pointer to the object draw function
+    FREE_FUNC FreeObj;              // Function pointer to the object free function
+    MSG_FUNC MsgObj;                // Function pointer to the object message function
+    MSG_DEFAULT_FUNC MsgDefaultObj; // Function pointer to the object default message function
+} OBJ_HEADER;
+
+#define GetState(pObj, stateBits)   (((OBJ_HEADER *)(pObj))->state & (stateBits))
+#define SetState(pObj, stateBits)   (((OBJ_HEADER *)(pObj))->state |= (stateBits))
+#define ClrState(pObj, stateBits)   (((OBJ_HEADER *)(pObj))->state &= (~(stateBits)))
+#define IsObjUpdated(pObj)          (((OBJ_HEADER *)(pObj))->state & 0xfc00)
+#define GOLDrawComplete(pObj)       (((OBJ_HEADER *)(pObj))->state &= 0x03ff)
+
+#define GFX_malloc(size)            malloc(size)
+#define GFX_free(pObj)              free(pObj)
+
+extern GOL_SCHEME *_pDefaultGolScheme;
+extern FONT_FLASH FONTDEFAULT;
+
+void GOLInit(void);
+void GOLAddObject(OBJ_HEADER *object);
+OBJ_HEADER *GOLFindObject(WORD ID);
+void GOLFree(void);
+WORD GOLDraw(void);
+void GOLMsg(GOL_MSG *pMsg);
+GOL_SCHEME *GOLCreateScheme(void);
+
+void GOLPanelDraw(SHORT left, SHORT top, SHORT right, SHORT bottom, SHORT radius,
+        GFX_COLOR faceClr, GFX_COLOR embossLtClr, GFX_COLOR embossDkClr, void *pBitmap, SHORT embossSize);
+WORD GOLPanelDrawTsk(void);
+
+char *myitoa(char *buffer, INT32 value, BYTE radix);
+
+#endif // _GOL_H
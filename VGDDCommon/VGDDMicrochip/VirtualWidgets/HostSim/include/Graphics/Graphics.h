@@ -0,0 +1,35 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Stand-in for the Microchip Graphics Library umbrella header
+// *****************************************************************************
+// FileName:        Graphics.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GRAPHICS_H
+#define _GRAPHICS_H
+
+#include "GenericTypeDefs.h"
+#include "Graphics/Primitive.h"
+#include "Graphics/DisplayDriver.h"
+#include "Graphics/GOL.h"
+#include "Graphics/Button.h"
+
+// All VirtualWidgets are built by the host harness
+#define USE_SUPERGAUGE
+#define USE_VUMETER
+#define USE_BARGRAPH
+#define USE_DISP7SEG
+#define USE_INDICATOR
+#define USE_MSGBOX
+#define USE_STATICTEXTEX
+#define USE_TEXTENTRYEX
+#define USE_TOUCHSCREEN
+#define USE_NONBLOCKING_CONFIG
+
+#endif // _GRAPHICS_H
@@ -0,0 +1,152 @@
+// *****************************************************************************
+// VirtualWidgets host simulation
+// Stand-in for the Microchip Graphics Library Primitive Layer
+// *****************************************************************************
+// FileName:        Primitive.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Declares the subset of the Primitive Layer API (Graphics Library v3.x) used
+// by the VirtualWidgets. Signatures and return conventions match the library:
+// drawing functions return 0 when the device is busy and must be called again,
+// 1 when the shape has been completely rendered.
+// The implementation lives in HostGfx.c and renders into an RGB565 framebuffer.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _PRIMITIVE_H
+#define _PRIMITIVE_H
+
+#include "GenericTypeDefs.h"
+
+#ifndef COLOR_DEPTH
+#define COLOR_DEPTH 16
+#endif
+
+typedef WORD GFX_COLOR;
+typedef const BYTE FLASH_BYTE;
+typedef const WORD FLASH_WORD;
+
+#ifdef USE_MULTIBYTECHAR
+typedef WORD XCHAR;
+#else
+typedef char XCHAR;
+#endif
+
+#define RGBConvert(red, green, blue)    (GFX_COLOR) (((((GFX_COLOR)(red) & 0xF8) >> 3) << 11) | ((((GFX_COLOR)(green) & 0xFC) >> 2) << 5) | (((GFX_COLOR)(blue) & 0xF8) >> 3))
+
+#define BLACK       RGBConvert(0, 0, 0)
+#define WHITE       RGBConvert(255, 255, 255)
+#define RED         RGBConvert(255, 0, 0)
+#define GREEN       RGBConvert(0, 255, 0)
+#define BLUE        RGBConvert(0, 0, 255)
+#define YELLOW      RGBConvert(255, 255, 0)
+#define GRAY        RGBConvert(128, 128, 128)
+#define LIGHTGRAY   RGBConvert(192, 192, 192)
+#define DARKGRAY    RGBConvert(64, 64, 64)
+
+// Line types and thickness
+#define SOLID_LINE  0
+#define DOTTED_LINE 1
+#define DASHED_LINE 4
+#define NORMAL_LINE 0
+#define THICK_LINE  1
+
+// Clipping
+#define CLIP_DISABLE    0
+#define CLIP_ENABLE     1
+
+// Image stretch
+#define IMAGE_NORMAL    1
+#define IMAGE_X2        2
+
+// Memory types for images and fonts
+typedef enum {
+    FLASH = 0,
+    EXTERNAL = 1,
+    RAM = 2,
+    EDS_EPMP = 3,
+    VIRTUAL_MEMORY = 4,
+} TYPE_MEMORY;
+
+// Header of the bitmaps generated by the Graphics Resource Converter / VGDD
+typedef struct {
+    BYTE compression;   // Compression setting
+    BYTE colorDepth;    // Color depth used
+    SHORT height;       // Image height
+    SHORT width;        // Image width
+} BITMAP_HEADER;
+
+// Structure for images stored in FLASH memory
+typedef struct {
+    TYPE_MEMORY type;   // must be FLASH
+    FLASH_BYTE *address; // bitmap image address
+} IMAGE_FLASH;
+
+typedef IMAGE_FLASH BITMAP_FLASH;
+
+// Structure for images and fonts located in EXTERNAL memory
+typedef struct {
+    TYPE_MEMORY type;   // must be EXTERNAL
+    WORD ID;            // memory ID
+    DWORD address;      // bitmap or font image address
+} GFX_EXTDATA;
+
+typedef GFX_EXTDATA IMAGE_EXTERNAL;
+typedef GFX_EXTDATA BITMAP_EXTERNAL;
+
+// Host font: glyphs are rendered as a fixed-pitch deterministic pattern, so text
+// costs the same number of pixel writes a real bitmapped font of that cell size would.
+typedef struct {
+    TYPE_MEMORY type;
+    BYTE width;         // Character cell width
+    BYTE height;        // Character cell height
+} FONT_FLASH;
+
+typedef struct {
+    void *pFont;
+} GFX_FONT_CURRENT;
+
+extern GFX_FONT_CURRENT currentFont;
+extern GFX_COLOR _color;
+extern SHORT _cursorX, _cursorY;
+extern SHORT _lineType;
+extern BYTE _lineThickness;
+extern SHORT _clipRgn, _clipLeft, _clipTop, _clipRight, _clipBottom;
+
+#define SetColor(color)             (_color = (color))
+#define GetColor()                  (_color)
+#define SetLineType(lnType)         (_lineType = (lnType))
+#define SetLineThickness(lnThick)   (_lineThickness = (lnThick))
+#define MoveTo(x, y)                { _cursorX = (x); _cursorY = (y); }
+#define GetX()                      (_cursorX)
+#define GetY()                      (_cursorY)
+
+void SetFont(void *pFont);
+SHORT GetTextWidth(XCHAR *textString, void *pFont);
+SHORT GetTextHeight(void *pFont);
+
+void GetCirclePoint(SHORT radius, SHORT angle, SHORT *x, SHORT *y);
+
+WORD Line(SHORT x1, SHORT y1, SHORT x2, SHORT y2);
+WORD Bevel(SHORT x1, SHORT y1, SHORT x2, SHORT y2, SHORT rad);
+WORD FillBevel(SHORT x1, SHORT y1, SHORT x2, SHORT y2, SHORT rad);
+WORD Arc(SHORT xL, SHORT yT, SHORT xR, SHORT yB, SHORT r1, SHORT r2, BYTE octant);
+WORD DrawPoly(SHORT numPoints, SHORT *polyPoints);
+WORD OutChar(XCHAR ch);
+WORD OutText(XCHAR *textString);
+WORD OutTextXY(SHORT x, SHORT y, XCHAR *textString);
+WORD PutImage(SHORT left, SHORT top, void *image, BYTE stretch);
+WORD PutImagePartial(SHORT left, SHORT top, void *image, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+SHORT GetImageWidth(void *image);
+SHORT GetImageHeight(void *image);
+
+#define LineTo(x, y)                        Line(_cursorX, _cursorY, x, y)
+#define Rectangle(left, top, right, bottom) Bevel(left, top, right, bottom, 0)
+#define Circle(x, y, radius)                Bevel(x, y, x, y, radius)
+#define FillCircle(x1, y1, rad)             FillBevel(x1, y1, x1, y1, rad)
+
+#endif // _PRIMITIVE_H
@@ -0,0 +1 @@
+#include "BarGraph.h"
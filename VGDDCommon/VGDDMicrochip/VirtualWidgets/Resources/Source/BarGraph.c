@@ -54,6 +54,7 @@
 // Date         Comment
 // *****************************************************************************
 // 2013/09/29   Fabio Violino - Initial release
+// 2026/10/17   Bar animated by tick (WidgetAnim) instead of by draw call
 // *****************************************************************************
 #include "Graphics/Graphics.h"
 
@@ -113,8 +114,8 @@ BARGRAPH *BgCreate(
     pBG->Segments = Segments;
     pBG->minValue = (INT16) (*(p + 3) << 8)+*(p + 4); // minValue
     pBG->maxValue = (INT16) (*(p + 5) << 8)+*(p + 6); // maxValue
-    pBG->currentValue = -1;
     pBG->newValue = (INT16) (*(p + 1) << 8)+*(p + 2); //value;
+    pBG->currentValue = pBG->newValue;
     pBG->previousValue = 0xffff;
     pBG->hdr.state = state; // state
     pBG->hdr.DrawObj = BgDraw; // draw function
@@ -122,6 +123,7 @@ BARGRAPH *BgCreate(
     pBG->hdr.MsgDefaultObj = BgMsgDefault; // default message function
     pBG->hdr.FreeObj = NULL; // free function
     pBG->state = BG_STATE_IDLE;
+    AnimInit(&pBG->Anim, pBG->newValue, pBG->BarSpeed, pBG->BarSpeed);
 
     // Set the color scheme to be used
     if (pScheme == NULL)
@@ -178,20 +180,18 @@ void BgCalcDimensions(BARGRAPH *pBG) {
  * Notes: Sets the value of the BARGRAPH to newVal. if newVal is less
  *		 than 0, 0 is assigned. if newVal is greater than range,
  *		 range is assigned.
+ *		 The bar moves towards the last value set at the next
+ *		 animation step, see WidgetAnim.h.
  *
  ********************************************************************/
 void BgSetVal(BARGRAPH *pBG, INT16 newVal) {
-    if (newVal < pBG->minValue) {
-        pBG->newValue = pBG->minValue;
-        return;
-    }
-
-    if (newVal > pBG->maxValue) {
-        pBG->newValue = pBG->maxValue;
-        return;
-    }
+    if (newVal < pBG->minValue)
+        newVal = pBG->minValue;
+    else if (newVal > pBG->maxValue)
+        newVal = pBG->maxValue;
 
     pBG->newValue = newVal;
+    AnimSetTarget(&pBG->Anim, newVal);
 }
 
 /*********************************************************************
@@ -265,7 +265,7 @@ WORD BgDraw(void *pObj) {
     volatile BARGRAPH *pBG;
     INT16 intXorY, intBarValue, intBarWorH;
     INT16 Xn1, Yn1, Xn2, Yn2;
-    BYTE i, j;
+    BYTE i, j, anim;
     char ScaleText[10];
 
     pBG = (BARGRAPH *) pObj;
@@ -280,9 +280,19 @@ WORD BgDraw(void *pObj) {
                 if (!Bar(pBG->hdr.left, pBG->hdr.top, pBG->hdr.right, pBG->hdr.bottom)) // TODO: sostituire Bar con Bevel per hiding
                     return (0);
                 return (1); // Finished!
-            } else if (GetState(pBG, BG_DRAWALL)) { // Check if we need to draw the whole object
+            }
+            // Take the animation steps due since the last redraw
+            anim = AnimStep((WIDGET_ANIM *) &pBG->Anim);
+            if (anim & ANIM_RUNNING)
+                SetState(pBG, BG_DRAW_ANIMATING);
+            else
+                ClrState(pBG, BG_DRAW_ANIMATING);
+            pBG->currentValue = AnimGetValue(&pBG->Anim);
+            if (GetState(pBG, BG_DRAWALL)) { // Check if we need to draw the whole object
                 pBG->state = BG_STATE_DRAW_BACKGROUND;
             } else if (GetState(pBG, BG_DRAW_UPDATE)) { // Or only the blocks
+                if (!(anim & ANIM_MOVED))
+                    return (1); // Bar still in place
                 pBG->state = BG_STATE_DRAW_BLOCKS;
                 goto blocks_erase_here;
             } else {
@@ -294,6 +304,7 @@ WORD BgDraw(void *pObj) {
             SetColor(pBG->hdr.pGolScheme->CommonBkColor);
             if (Bar(pBG->hdr.left, pBG->hdr.top, pBG->hdr.right, pBG->hdr.bottom) == 0)
                 return (0);
+            pBG->previousValue = -1; // the background covered the blocks: draw all of them
             if (GetState(pBG, BG_FRAME)) {
                 // Draw frame if specif(ied to be shown
                 SetLineType(SOLID_LINE);
@@ -415,25 +426,7 @@ WORD BgDraw(void *pObj) {
             pBG->state = BG_STATE_IDLE;
             pBG->previousValue = pBG->currentValue;
             ClrState(pBG, BG_DRAW_UPDATE | BG_DRAWALL);
-            if (pBG->currentValue == pBG->newValue) {
-                ClrState(pBG, BG_DRAW_ANIMATING);
-                return (1); // Finished updating!
-            } else if (pBG->BarSpeed == 0) {
-                pBG->currentValue = pBG->newValue;
-            } else {
-                INT16 AnimationIncrement=0;
-                if (pBG->currentValue < pBG->newValue) {
-                    AnimationIncrement = ((pBG->newValue - pBG->currentValue) >> pBG->BarSpeed);
-                    if (AnimationIncrement == 0)
-                        AnimationIncrement = 1;
-                } else if (pBG->currentValue > pBG->newValue) {
-                    AnimationIncrement = -((pBG->currentValue - pBG->newValue) >> pBG->BarSpeed);
-                    if (AnimationIncrement == 0)
-                        AnimationIncrement = -1;
-                }
-                pBG->currentValue += AnimationIncrement;
-            }
-            SetState(pBG, BG_DRAW_ANIMATING);
+            return (1); // Finished updating!
     }
 
     return (1);
@@ -48,6 +48,7 @@
 // Date         Comment
 // *****************************************************************************
 //  2013/09/25	Initial Release
+//  2026/10/17	Tick driven bar animation (WidgetAnim)
 // *****************************************************************************
 #ifndef _BARGRAPH_H
 #define _BARGRAPH_H
@@ -55,6 +56,7 @@
 //#include "Graphics/GOL.h"
 //#include "GenericTypeDefs.h"
 //#include "Graphics/DisplayDriver.h"
+#include "WidgetAnim.h"
 
 /*********************************************************************
  * Object States Definition:
@@ -65,6 +67,7 @@
 
 #define BG_FRAME          0x0010      // Bit to indicate frame is to be drawn around the BarGraph.
 #define BG_DRAW_ANIMATING 0x0100      // Bit to indicate that the BarGraph is being drawn one block after the other
+                                      // Set while Anim has not reached the value, see WidgetAnim.h
 #define BG_DRAW_UPDATE    0x1000      // Bit to indicate an update. Only blocks are drawn.
 #define BG_DRAWALL        0x4000      // Bit to indicate object must be completely redrawn.
 #define BG_HIDE           0x8000      // Bit to indicate object must be removed from screen.
@@ -127,6 +130,7 @@ typedef struct {
     INT16 intScaleWorH;
     INT16 intScaleInterval;
     INT16 intBarInterval;
+    WIDGET_ANIM Anim;     // Bar animation. BarSpeed is its easing shift
 
 } BARGRAPH;
 
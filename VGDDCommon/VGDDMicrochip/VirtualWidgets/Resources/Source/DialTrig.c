@@ -0,0 +1,121 @@
+// *****************************************************************************
+// Module for Microchip Graphics Library
+// GOL Layer
+// DialTrig - Fixed point trigonometry for dial widgets
+// *****************************************************************************
+// FileName:        DialTrig.c
+// Processor:       PIC24F, PIC24H, dsPIC, PIC32
+// Compiler:        MPLAB C30/XC16, MPLAB C32/XC32
+// Company:         VirtualFab, parts from Microchip Technology Incorporated
+//
+// VirtualFab's Software License Agreement:
+// Copyright 2013-2016 Virtualfab - All rights reserved.
+// VirtualFab licenses to you the right to use, modify, copy and distribute
+// this software only in the event that you purchased at least one license of the VirtualFab's
+// Visual Graphics Display Designer (VGDD) software.
+//
+// Usage of this software without owning a License for VGDD is explicitly forbidden.
+//
+// The Demo version of VGDD, from which this source may come, doesn't allow you to use it
+// in any projects other than those created for test purposes, even if the code is manually created.
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+// OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Microchip's Software License Agreement:
+//
+// Copyright 2012 Microchip Technology Inc.  All rights reserved.
+// Microchip licenses to you the right to use, modify, copy and distribute
+// Software only when embedded on a Microchip microcontroller or digital
+// signal controller, which is integrated into your product or third party
+// product (pursuant to the sublicense terms in the accompanying license
+// agreement).
+//
+// You should refer to the license agreement accompanying this Software
+// for additional information regarding your rights and obligations.
+//
+// SOFTWARE AND DOCUMENTATION ARE PROVIDED "AS IS" WITHOUT WARRANTY OF ANY
+// KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY
+// OF MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR
+// PURPOSE. IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR
+// OBLIGATED UNDER CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION,
+// BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT
+// DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL,
+// INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA,
+// COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY
+// CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF),
+// OR OTHER SIMILAR COSTS.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	DialCos() reduces the angle first, DIAL_DEG() without shifts
+// *****************************************************************************
+
+#include "DialTrig.h"
+
+// sin(0..90 degrees) in Q15
+static const INT16 DialSineTable[91] = {
+    0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+    5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14365, 14876, 15384, 15886,
+    16384, 16877, 17364, 17847, 18324, 18795, 19261, 19720, 20174, 20622,
+    21063, 21498, 21926, 22348, 22763, 23170, 23571, 23965, 24351, 24730,
+    25102, 25466, 25822, 26170, 26510, 26842, 27166, 27482, 27789, 28088,
+    28378, 28660, 28932, 29197, 29452, 29698, 29935, 30163, 30382, 30592,
+    30792, 30983, 31164, 31336, 31499, 31651, 31795, 31928, 32052, 32166,
+    32270, 32365, 32449, 32524, 32588, 32643, 32688, 32723, 32748, 32763,
+    32767
+};
+
+// Reduces angle to 0..360 degrees
+static INT16 DialReduce(INT16 angle) {
+    while (angle < 0)
+        angle += DIAL_DEG(360);
+    while (angle >= DIAL_DEG(360))
+        angle -= DIAL_DEG(360);
+    return angle;
+}
+
+INT16 DialSin(INT16 angle) {
+    INT16 i, f, s;
+    BOOL negative = FALSE;
+
+    // Reduce to 0..180 degrees, then to the first quadrant
+    angle = DialReduce(angle);
+    if (angle >= DIAL_DEG(180)) {
+        angle -= DIAL_DEG(180);
+        negative = TRUE;
+    }
+    if (angle > DIAL_DEG(90))
+        angle = DIAL_DEG(180) - angle;
+
+    i = angle >> DIAL_ANGLE_SHIFT;
+    f = angle & ((1 << DIAL_ANGLE_SHIFT) - 1);
+    s = DialSineTable[i];
+    if (f)
+        s += ((DialSineTable[i + 1] - s) * f + (1 << (DIAL_ANGLE_SHIFT - 1))) >> DIAL_ANGLE_SHIFT;
+    return negative ? -s : s;
+}
+
+INT16 DialCos(INT16 angle) {
+    // Reduced first, so that adding 90 degrees cannot overflow
+    return DialSin(DialReduce(angle) + DIAL_DEG(90));
+}
+
+void DialCirclePoint(INT16 radius, INT16 angle, INT16 *x, INT16 *y) {
+    *x = (INT16) (((INT32) radius * DialCos(angle) + 0x4000) >> 15);
+    *y = (INT16) (((INT32) radius * DialSin(angle) + 0x4000) >> 15);
+}
+
+INT32 DialAngleScale(INT16 angleFrom, INT16 angleTo, INT16 minValue, INT16 maxValue) {
+    if (maxValue == minValue)
+        return 0;
+    return ((INT32) DIAL_DEG(angleTo - angleFrom) * 65536L) / ((INT32) maxValue - minValue);
+}
@@ -0,0 +1,126 @@
+// *****************************************************************************
+// Module for Microchip Graphics Library
+// GOL Layer
+// DialTrig - Fixed point trigonometry for dial widgets
+// *****************************************************************************
+// FileName:        DialTrig.h
+// Processor:       PIC24F, PIC24H, dsPIC, PIC32
+// Compiler:        MPLAB C30/XC16, MPLAB C32/XC32
+// Company:         VirtualFab, parts from Microchip Technology Incorporated
+//
+// VirtualFab's Software License Agreement:
+// Copyright 2013-2016 Virtualfab - All rights reserved.
+// VirtualFab licenses to you the right to use, modify, copy and distribute
+// this software only in the event that you purchased at least one license of the VirtualFab's
+// Visual Graphics Display Designer (VGDD) software.
+//
+// Usage of this software without owning a License for VGDD is explicitly forbidden.
+//
+// The Demo version of VGDD, from which this source may come, doesn't allow you to use it
+// in any projects other than those created for test purposes, even if the code is manually created.
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+// OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Microchip's Software License Agreement:
+//
+// Copyright 2012 Microchip Technology Inc.  All rights reserved.
+// Microchip licenses to you the right to use, modify, copy and distribute
+// Software only when embedded on a Microchip microcontroller or digital
+// signal controller, which is integrated into your product or third party
+// product (pursuant to the sublicense terms in the accompanying license
+// agreement).
+//
+// You should refer to the license agreement accompanying this Software
+// for additional information regarding your rights and obligations.
+//
+// SOFTWARE AND DOCUMENTATION ARE PROVIDED "AS IS" WITHOUT WARRANTY OF ANY
+// KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY
+// OF MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR
+// PURPOSE. IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR
+// OBLIGATED UNDER CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION,
+// BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT
+// DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL,
+// INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA,
+// COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY
+// CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF),
+// OR OTHER SIMILAR COSTS.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	DialCos() reduces the angle first, DIAL_DEG() without shifts
+// *****************************************************************************
+#ifndef _DIALTRIG_H
+#define _DIALTRIG_H
+
+#include "GenericTypeDefs.h"
+
+/*********************************************************************
+ * Angles used by the dial widgets are expressed in 1/16 of degree, so
+ * that a pointer can move by less than one degree per step.
+ * As for GetCirclePoint(), angles grow clockwise from the positive x axis.
+ * Any angle within +/-2047 degrees is accepted.
+ *********************************************************************/
+#define DIAL_ANGLE_SHIFT    4                                   // Fraction bits of a dial angle
+#define DIAL_DEG(d)         ((INT16) ((d) * (1 << DIAL_ANGLE_SHIFT))) // Degrees to dial angle
+
+/*********************************************************************
+ * Macro: DIAL_VALUE_ANGLE(angleFrom, scale, offset)
+ *
+ * Overview: Converts a value to a dial angle with one multiplication,
+ *           scale being the factor returned by DialAngleScale().
+ *
+ * Input: angleFrom - Angle of minValue, in degrees
+ *        scale - Factor computed by DialAngleScale()
+ *        offset - Value minus minValue
+ *
+ * Output: Dial angle of the value
+ *
+ ********************************************************************/
+#define DIAL_VALUE_ANGLE(angleFrom, scale, offset) \
+        (DIAL_DEG(angleFrom) + (INT16) (((INT32) (offset) * (scale) + 0x8000L) >> 16))
+
+/*********************************************************************
+ * Function: INT16 DialSin(INT16 angle)
+ *
+ * Overview: Returns the sine of angle in Q15, from a quarter wave table
+ *           with linear interpolation between degrees.
+ *
+ ********************************************************************/
+INT16 DialSin(INT16 angle);
+
+/*********************************************************************
+ * Function: INT16 DialCos(INT16 angle)
+ *
+ * Overview: Returns the cosine of angle in Q15.
+ *
+ ********************************************************************/
+INT16 DialCos(INT16 angle);
+
+/*********************************************************************
+ * Function: void DialCirclePoint(INT16 radius, INT16 angle, INT16 *x, INT16 *y)
+ *
+ * Overview: Like GetCirclePoint(), with a dial angle: returns in *x, *y the
+ *           point of the circle of the given radius centered at 0,0.
+ *
+ ********************************************************************/
+void DialCirclePoint(INT16 radius, INT16 angle, INT16 *x, INT16 *y);
+
+/*********************************************************************
+ * Function: INT32 DialAngleScale(INT16 angleFrom, INT16 angleTo, INT16 minValue, INT16 maxValue)
+ *
+ * Overview: Computes once, usually when the widget is created, the factor
+ *           used by DIAL_VALUE_ANGLE() to turn values into angles without
+ *           divisions. Returns 0 for an empty range.
+ *
+ ********************************************************************/
+INT32 DialAngleScale(INT16 angleFrom, INT16 angleTo, INT16 minValue, INT16 maxValue);
+
+#endif // _DIALTRIG_H
@@ -48,6 +48,7 @@
 // Date         Comment
 // *****************************************************************************
 //  2012/03/15	Start of Developing
+//  2026/10/17  On D7_UPDATE only the segments that changed are repainted
 // *****************************************************************************
 //#include "Graphics/Graphics.h"
 //#include <math.h>
@@ -105,6 +106,7 @@ DISP7SEG *D7Create(
     pDisp7Seg->CurrentValue = Value;
     pDisp7Seg->DotPos = DotPos;
     pDisp7Seg->Thickness = Thickness;
+    FontLed7SegInit(&pDisp7Seg->Font);
 
     pDisp7Seg->DigitWidth = (right-left-Thickness)/NoOfDigits-Thickness;
     pDisp7Seg->DigitHeight=bottom-top-(Thickness<<1);
@@ -211,8 +213,10 @@ WORD D7Draw(void *pObj) {
                     return (0);
             }
             // if the draw state was to hide then state is still IDLE STATE so no need to change state
-            if (GetState(pD7, D7_HIDE))
+            if (GetState(pD7, D7_HIDE)) {
+                pD7->Font.ShownDigits = 0;
                 return (1);
+            }
             state = D7_STATE_FRAME;
 
         case D7_STATE_FRAME:
@@ -238,10 +242,12 @@ WORD D7Draw(void *pObj) {
             PosX = pD7->hdr.left+pD7->Thickness;
             PosY = pD7->hdr.top+pD7->Thickness;
             if (GetState(pD7, D7_DRAW) || GetState(pD7, D7_UPDATE)) {
-                FontLed7SegSetSize(pD7->DigitHeight, pD7->DigitWidth, pD7->Thickness, GetState(pD7, D7_DRAWPOLY) ? FontLed7SegPoly : FontLed7SegBar);
-                if(!FontLed7SegPrintValue(pD7->CurrentValue, pD7->PreviousValue, PosX, PosY,
-                    pD7->NoOfDigits, pD7->Thickness, pD7->hdr.pGolScheme->CommonBkColor, pD7->hdr.pGolScheme->TextColor0, GetState(pD7, D7_UPDATE)))
+                FontLed7SegSetSize(&pD7->Font, pD7->DigitHeight, pD7->DigitWidth, pD7->Thickness, GetState(pD7, D7_DRAWPOLY) ? FontLed7SegPoly : FontLed7SegBar);
+                // After a full draw the background has been cleared, so all the segments are drawn
+                if(!FontLed7SegPrintValue(&pD7->Font, pD7->CurrentValue, PosX, PosY,
+                    pD7->NoOfDigits, pD7->Thickness, pD7->hdr.pGolScheme->CommonBkColor, pD7->hdr.pGolScheme->TextColor0, !GetState(pD7, D7_DRAW)))
                     return(0);
+                pD7->PreviousValue = pD7->CurrentValue;
             }
     }
 
@@ -55,6 +55,7 @@
 // Date         Comment
 // *****************************************************************************
 //  2012/02/26	Start of Developing
+//  2026/10/17  Digits drawn by a FONTLED7SEG renderer owned by the object
 // *****************************************************************************
 #ifndef _DISP7SEG_H
 #define _DISP7SEG_H
@@ -62,6 +63,7 @@
 #include "Graphics/GOL.h"
 #include "GenericTypeDefs.h"
 #include "Graphics/DisplayDriver.h"
+#include "FontLed7Seg.h"
 
 /* User should change this value depending on the number of digits he wants to display */
     #define D7_WIDTH    0x0A        // This value should be more than the no of digits displayed
@@ -97,6 +99,7 @@ typedef struct {
     BYTE        DigitWidth;     // Width for the digits - based on object's Width / NoOfDigits
     BYTE        Thickness;      // Thickness for the drawing of segments
     BYTE        DotPos;         // Position of decimal point
+    FONTLED7SEG Font;           // Digit geometry and segments shown
 } DISP7SEG;
 
 /*********************************************************************
@@ -57,14 +57,14 @@
 //  2012/03/04	Start of Developing
 //  2012/03/10  Merged with FontSeg - Now it is a Vector Font that renders with Bar or DrawPoly
 //  2013/12/29  Removed DeviceIsBusy() in FontLed7SegPrintDigit 
+//  2026/10/17  Geometry cached per instance without float math, only changed segments are repainted
+//  2026/10/17  Digits beyond FONTLED7SEG_MAX_DIGITS no longer move the value to the right
 // *****************************************************************************
 
 #include "FontLed7Seg.h"
 #include "Graphics/GOL.h"
 #include "Graphics/DisplayDriver.h"
 
-UINT8 FontLed7SegCurrentSizeX, FontLed7SegCurrentSizeY;
-
 const unsigned char aLed7SegSegments[11] = {
     //GFEDCBA
     0b0000000, // Blank
@@ -80,203 +80,195 @@ const unsigned char aLed7SegSegments[11] = {
     0b1101111 // 9
 };
 
-BYTE aLed7SegCoords[7][14];
-FontLed7SegStyle Led7SegCurrentStyle;
-
-void FontLed7SegSetSize(UINT8 sizeY, UINT8 sizeX, UINT8 thickness, FontLed7SegStyle Style) {
-    //UINT8 sizeX = sizeY * 5 / 7;
-    FontLed7SegCurrentSizeX = sizeX;
-    FontLed7SegCurrentSizeY = sizeY;
-    Led7SegCurrentStyle = Style;
-
-    switch (Style) {
-        case FontLed7SegBar:
-            // Segment A
-            aLed7SegCoords[0][0] = 0;
-            aLed7SegCoords[0][1] = 0;
-            aLed7SegCoords[0][2] = FontLed7SegCurrentSizeX;
-            aLed7SegCoords[0][3] = thickness;
+// Segments touching each segment: erasing a segment clears their ends too
+static const unsigned char aLed7SegNeighbours[7] = {
+    //GFEDCBA
+    0b0100010, // A
+    0b1000101, // B
+    0b1001010, // C
+    0b0010100, // D
+    0b1101000, // E
+    0b1010001, // F
+    0b0110110 // G
+};
 
-            // Segment B
-            aLed7SegCoords[1][0] = FontLed7SegCurrentSizeX - thickness;
-            aLed7SegCoords[1][1] = 0;
-            aLed7SegCoords[1][2] = FontLed7SegCurrentSizeX;
-            aLed7SegCoords[1][3] = (FontLed7SegCurrentSizeY >>1) - (thickness>>1);
+// Outlines for FontLed7SegPoly, in percent of the digit width (x) and of 70% of its height (y)
+static const unsigned char aLed7SegPolyScale[7][14] = {
+    {28, 10, 100, 10, 88, 20, 38, 20, 28, 10}, // A
+    {100, 14, 93, 68, 84, 64, 90, 22, 100, 14}, // B
+    {92, 72, 85, 127, 77, 119, 82, 77, 92, 72}, // C
+    {74, 121, 84, 130, 11, 130, 22, 121, 74, 121}, // D
+    {22, 118, 10, 127, 18, 72, 28, 77, 22, 118}, // E
+    {30, 62, 19, 68, 27, 13, 36, 22, 30, 62}, // F
+    {20, 70, 31, 65, 83, 65, 90, 70, 82, 75, 29, 75, 20, 70} // G
+};
 
-            // Segment C
-            aLed7SegCoords[2][0] = FontLed7SegCurrentSizeX - thickness;
-            aLed7SegCoords[2][1] = (FontLed7SegCurrentSizeY >>1) -(thickness>>1);
-            aLed7SegCoords[2][2] = FontLed7SegCurrentSizeX;
-            aLed7SegCoords[2][3] = FontLed7SegCurrentSizeY;
+void FontLed7SegInit(FONTLED7SEG *pFont) {
+    UINT8 i, j;
 
-            // Segment D
-            aLed7SegCoords[3][0] = 0;
-            aLed7SegCoords[3][1] = FontLed7SegCurrentSizeY - thickness;
-            aLed7SegCoords[3][2] = FontLed7SegCurrentSizeX;
-            aLed7SegCoords[3][3] = FontLed7SegCurrentSizeY;
+    // All-zero geometry is what FontLed7SegSetSize() computes for a 0x0 FontLed7SegBar font
+    pFont->SizeX = 0;
+    pFont->SizeY = 0;
+    pFont->Thickness = 0;
+    pFont->Style = FontLed7SegBar;
+    for (i = 0; i < 7; i++)
+        for (j = 0; j < 14; j++)
+            pFont->Coords[i][j] = 0;
+    pFont->ShownDigits = 0;
+}
 
-            // Segment E
-            aLed7SegCoords[4][0] = 0;
-            aLed7SegCoords[4][1] = (FontLed7SegCurrentSizeY >>1)-(thickness>>1);
-            aLed7SegCoords[4][2] = thickness;
-            aLed7SegCoords[4][3] = FontLed7SegCurrentSizeY;
+void FontLed7SegSetSize(FONTLED7SEG *pFont, UINT8 sizeY, UINT8 sizeX, UINT8 thickness, FontLed7SegStyle Style) {
+    UINT8 i, j, half;
+    UINT16 polySizeY;
 
-            // Segment F
-            aLed7SegCoords[5][0] = 0;
-            aLed7SegCoords[5][1] = 0;
-            aLed7SegCoords[5][2] = thickness;
-            aLed7SegCoords[5][3] = (FontLed7SegCurrentSizeY >>1)-(thickness>>1);
+    if (pFont->SizeX == sizeX && pFont->SizeY == sizeY && pFont->Thickness == thickness && pFont->Style == Style)
+        return; // Geometry already computed
+    pFont->SizeX = sizeX;
+    pFont->SizeY = sizeY;
+    pFont->Thickness = thickness;
+    pFont->Style = Style;
+    pFont->ShownDigits = 0;
 
-            // Segment G
-            aLed7SegCoords[6][0] = 0;
-            aLed7SegCoords[6][1] = (FontLed7SegCurrentSizeY >>1)-(thickness>>1);
-            aLed7SegCoords[6][2] = FontLed7SegCurrentSizeX ;
-            aLed7SegCoords[6][3] = (FontLed7SegCurrentSizeY >>1) + (thickness>>1);
-
-            break;
+    switch (Style) {
+        case FontLed7SegBar:
+            half = (sizeY >> 1) - (thickness >> 1);
 
-        case FontLed7SegPoly:
-            FontLed7SegCurrentSizeY=FontLed7SegCurrentSizeY*0.7;
-            
             // Segment A
-            aLed7SegCoords[0][0] = FontLed7SegCurrentSizeX * 2.8 / 10;
-            aLed7SegCoords[0][1] = FontLed7SegCurrentSizeY / 10;
-            aLed7SegCoords[0][2] = FontLed7SegCurrentSizeX * 10 / 10;
-            aLed7SegCoords[0][3] = FontLed7SegCurrentSizeY / 10;
-            aLed7SegCoords[0][4] = FontLed7SegCurrentSizeX * 8.8 / 10;
-            aLed7SegCoords[0][5] = FontLed7SegCurrentSizeY * 2.0 / 10;
-            aLed7SegCoords[0][6] = FontLed7SegCurrentSizeX * 3.8 / 10;
-            aLed7SegCoords[0][7] = FontLed7SegCurrentSizeY * 2.0 / 10;
-            aLed7SegCoords[0][8] = FontLed7SegCurrentSizeX * 2.8 / 10;
-            aLed7SegCoords[0][9] = FontLed7SegCurrentSizeY / 10;
+            pFont->Coords[0][0] = 0;
+            pFont->Coords[0][1] = 0;
+            pFont->Coords[0][2] = sizeX;
+            pFont->Coords[0][3] = thickness;
 
             // Segment B
-            aLed7SegCoords[1][0] = FontLed7SegCurrentSizeX * 10 / 10;
-            aLed7SegCoords[1][1] = FontLed7SegCurrentSizeY * 1.4 / 10;
-            aLed7SegCoords[1][2] = FontLed7SegCurrentSizeX * 9.3 / 10;
-            aLed7SegCoords[1][3] = FontLed7SegCurrentSizeY * 6.8 / 10;
-            aLed7SegCoords[1][4] = FontLed7SegCurrentSizeX * 8.4 / 10;
-            aLed7SegCoords[1][5] = FontLed7SegCurrentSizeY * 6.4 / 10;
-            aLed7SegCoords[1][6] = FontLed7SegCurrentSizeX * 9.0 / 10;
-            aLed7SegCoords[1][7] = FontLed7SegCurrentSizeY * 2.2 / 10;
-            aLed7SegCoords[1][8] = FontLed7SegCurrentSizeX * 10 / 10;
-            aLed7SegCoords[1][9] = FontLed7SegCurrentSizeY * 1.4 / 10;
+            pFont->Coords[1][0] = sizeX - thickness;
+            pFont->Coords[1][1] = 0;
+            pFont->Coords[1][2] = sizeX;
+            pFont->Coords[1][3] = half;
 
             // Segment C
-            aLed7SegCoords[2][0] = FontLed7SegCurrentSizeX * 9.2 / 10;
-            aLed7SegCoords[2][1] = FontLed7SegCurrentSizeY * 7.2 / 10;
-            aLed7SegCoords[2][2] = FontLed7SegCurrentSizeX * 8.5 / 10;
-            aLed7SegCoords[2][3] = FontLed7SegCurrentSizeY * 12.7 / 10;
-            aLed7SegCoords[2][4] = FontLed7SegCurrentSizeX * 7.7 / 10;
-            aLed7SegCoords[2][5] = FontLed7SegCurrentSizeY * 11.9 / 10;
-            aLed7SegCoords[2][6] = FontLed7SegCurrentSizeX * 8.2 / 10;
-            aLed7SegCoords[2][7] = FontLed7SegCurrentSizeY * 7.7 / 10;
-            aLed7SegCoords[2][8] = FontLed7SegCurrentSizeX * 9.2 / 10;
-            aLed7SegCoords[2][9] = FontLed7SegCurrentSizeY * 7.2 / 10;
+            pFont->Coords[2][0] = sizeX - thickness;
+            pFont->Coords[2][1] = half;
+            pFont->Coords[2][2] = sizeX;
+            pFont->Coords[2][3] = sizeY;
 
             // Segment D
-            aLed7SegCoords[3][0] = FontLed7SegCurrentSizeX * 7.4 / 10;
-            aLed7SegCoords[3][1] = FontLed7SegCurrentSizeY * 12.1 / 10;
-            aLed7SegCoords[3][2] = FontLed7SegCurrentSizeX * 8.4 / 10;
-            aLed7SegCoords[3][3] = FontLed7SegCurrentSizeY * 13.0 / 10;
-            aLed7SegCoords[3][4] = FontLed7SegCurrentSizeX * 1.1 / 10;
-            aLed7SegCoords[3][5] = FontLed7SegCurrentSizeY * 13.0 / 10;
-            aLed7SegCoords[3][6] = FontLed7SegCurrentSizeX * 2.2 / 10;
-            aLed7SegCoords[3][7] = FontLed7SegCurrentSizeY * 12.1 / 10;
-            aLed7SegCoords[3][8] = FontLed7SegCurrentSizeX * 7.4 / 10;
-            aLed7SegCoords[3][9] = FontLed7SegCurrentSizeY * 12.1 / 10;
+            pFont->Coords[3][0] = 0;
+            pFont->Coords[3][1] = sizeY - thickness;
+            pFont->Coords[3][2] = sizeX;
+            pFont->Coords[3][3] = sizeY;
 
             // Segment E
-            aLed7SegCoords[4][0] = FontLed7SegCurrentSizeX * 2.2 / 10;
-            aLed7SegCoords[4][1] = FontLed7SegCurrentSizeY * 11.8 / 10;
-            aLed7SegCoords[4][2] = FontLed7SegCurrentSizeX * 1.0 / 10;
-            aLed7SegCoords[4][3] = FontLed7SegCurrentSizeY * 12.7 / 10;
-            aLed7SegCoords[4][4] = FontLed7SegCurrentSizeX * 1.8 / 10;
-            aLed7SegCoords[4][5] = FontLed7SegCurrentSizeY * 7.2 / 10;
-            aLed7SegCoords[4][6] = FontLed7SegCurrentSizeX * 2.8 / 10;
-            aLed7SegCoords[4][7] = FontLed7SegCurrentSizeY * 7.7 / 10;
-            aLed7SegCoords[4][8] = FontLed7SegCurrentSizeX * 2.2 / 10;
-            aLed7SegCoords[4][9] = FontLed7SegCurrentSizeY * 11.8 / 10;
+            pFont->Coords[4][0] = 0;
+            pFont->Coords[4][1] = half;
+            pFont->Coords[4][2] = thickness;
+            pFont->Coords[4][3] = sizeY;
 
-            // Segment
-            aLed7SegCoords[5][0] = FontLed7SegCurrentSizeX * 3.0 / 10;
-            aLed7SegCoords[5][1] = FontLed7SegCurrentSizeY * 6.2 / 10;
-            aLed7SegCoords[5][2] = FontLed7SegCurrentSizeX * 1.9 / 10;
-            aLed7SegCoords[5][3] = FontLed7SegCurrentSizeY * 6.8 / 10;
-            aLed7SegCoords[5][4] = FontLed7SegCurrentSizeX * 2.7 / 10;
-            aLed7SegCoords[5][5] = FontLed7SegCurrentSizeY * 1.3 / 10;
-            aLed7SegCoords[5][6] = FontLed7SegCurrentSizeX * 3.6 / 10;
-            aLed7SegCoords[5][7] = FontLed7SegCurrentSizeY * 2.2 / 10;
-            aLed7SegCoords[5][8] = FontLed7SegCurrentSizeX * 3.0 / 10;
-            aLed7SegCoords[5][9] = FontLed7SegCurrentSizeY * 6.2 / 10;
+            // Segment F
+            pFont->Coords[5][0] = 0;
+            pFont->Coords[5][1] = 0;
+            pFont->Coords[5][2] = thickness;
+            pFont->Coords[5][3] = half;
 
             // Segment G
-            aLed7SegCoords[6][0] = FontLed7SegCurrentSizeX * 2.0 / 10;
-            aLed7SegCoords[6][1] = FontLed7SegCurrentSizeY * 7.0 / 10;
-            aLed7SegCoords[6][2] = FontLed7SegCurrentSizeX * 3.1 / 10;
-            aLed7SegCoords[6][3] = FontLed7SegCurrentSizeY * 6.5 / 10;
-            aLed7SegCoords[6][4] = FontLed7SegCurrentSizeX * 8.3 / 10;
-            aLed7SegCoords[6][5] = FontLed7SegCurrentSizeY * 6.5 / 10;
-            aLed7SegCoords[6][6] = FontLed7SegCurrentSizeX * 9.0 / 10;
-            aLed7SegCoords[6][7] = FontLed7SegCurrentSizeY * 7.0 / 10;
-            aLed7SegCoords[6][8] = FontLed7SegCurrentSizeX * 8.2 / 10;
-            aLed7SegCoords[6][9] = FontLed7SegCurrentSizeY * 7.5 / 10;
-            aLed7SegCoords[6][10] = FontLed7SegCurrentSizeX * 2.9 / 10;
-            aLed7SegCoords[6][11] = FontLed7SegCurrentSizeY * 7.5 / 10;
-            aLed7SegCoords[6][12] = FontLed7SegCurrentSizeX * 2.0 / 10;
-            aLed7SegCoords[6][13] = FontLed7SegCurrentSizeY * 7.0 / 10;
-
+            pFont->Coords[6][0] = 0;
+            pFont->Coords[6][1] = half;
+            pFont->Coords[6][2] = sizeX;
+            pFont->Coords[6][3] = (sizeY >> 1) + (thickness >> 1);
             break;
-    }
-}
-
 
-WORD FontLed7SegPrintValue(INT16 Value, INT16 LastValue, UINT16 x, UINT16 y, BYTE MaxDigits, BYTE gap, WORD BackColor, WORD ForeColor, BOOL OnlyUpdate) {
-    BYTE Digit;//, OldDigit;
-    BYTE CurrentDigit = 0;
-    UINT16 TotalWidth = (FontLed7SegCurrentSizeX + gap) * MaxDigits;//+gap<<1);
-
-    while (1) {
-        CurrentDigit++;
-        //OldDigit = (LastValue % 10);
-        Digit = (Value % 10);
-        //if (OldDigit != Digit || !OnlyUpdate) {
-        SetColor(BackColor);
-        if (!FontLed7SegPrintDigit('8', x + TotalWidth - (FontLed7SegCurrentSizeX + gap) * CurrentDigit, y))
-            return (0);
-        SetColor(ForeColor);
-        if (CurrentDigit == 1 || Digit > 0||Value>9) {
-            if (!FontLed7SegPrintDigit(Digit + '0', x + TotalWidth - (FontLed7SegCurrentSizeX + gap) * CurrentDigit, y))
-                return (0);
-        }
-        //}
-        Value /= 10;
-        if (/*(Value == 0) ||*/ (CurrentDigit >= MaxDigits))
-            return (1);
+        case FontLed7SegPoly:
+            polySizeY = (UINT16) sizeY * 7 / 10;
+            for (i = 0; i < 7; i++) {
+                for (j = 0; j < 14; j += 2) {
+                    pFont->Coords[i][j] = (UINT16) sizeX * aLed7SegPolyScale[i][j] / 100;
+                    pFont->Coords[i][j + 1] = polySizeY * aLed7SegPolyScale[i][j + 1] / 100;
+                }
+            }
+            break;
     }
 }
 
-WORD FontLed7SegPrintDigit(char d, UINT16 x, UINT16 y) {
-    UINT8 segs, i, j, numPoints;
+// Draws the segments set in segs with the current color
+static void FontLed7SegDrawSegments(FONTLED7SEG *pFont, BYTE segs, UINT16 x, UINT16 y) {
+    UINT8 i, j, numPoints;
     SHORT aSegPoly[14];
-    segs = d - '0' + 1;
-    if (segs > 10) segs = 0;
+
     for (i = 0; i < 7; i++) {
-        if (aLed7SegSegments[segs] & (1 << i)) {
-            switch (Led7SegCurrentStyle) {
+        if (segs & (1 << i)) {
+            switch (pFont->Style) {
                 case FontLed7SegBar:
-                    while (!Bar(x + aLed7SegCoords[i][0], y + aLed7SegCoords[i][1], x + aLed7SegCoords[i][2], y + aLed7SegCoords[i][3]));
+                    while (!Bar(x + pFont->Coords[i][0], y + pFont->Coords[i][1], x + pFont->Coords[i][2], y + pFont->Coords[i][3]));
                     break;
                 case FontLed7SegPoly:
                     numPoints = (i == 6 ? 7 : 5);
                     for (j = 0; j < (numPoints << 1); j += 2) {
-                        aSegPoly[j] = aLed7SegCoords[i][j] + x;
-                        aSegPoly[j + 1] = aLed7SegCoords[i][j + 1] + y;
+                        aSegPoly[j] = pFont->Coords[i][j] + x;
+                        aSegPoly[j + 1] = pFont->Coords[i][j + 1] + y;
                     }
                     while (!DrawPoly(numPoints, aSegPoly));
                     break;
             }
         }
     }
+}
+
+WORD FontLed7SegPrintValue(FONTLED7SEG *pFont, INT16 Value, UINT16 x, UINT16 y, BYTE MaxDigits, BYTE gap, WORD BackColor, WORD ForeColor, BOOL OnlyUpdate) {
+    BYTE Digit, segs, lastSegs, off, redraw, i;
+    BYTE CurrentDigit = 0;
+    BOOL Known;
+    UINT16 DigitX;
+
+    if (MaxDigits > FONTLED7SEG_MAX_DIGITS)
+        MaxDigits = FONTLED7SEG_MAX_DIGITS;
+    DigitX = x + (pFont->SizeX + gap) * (MaxDigits - 1);
+    // The segments shown can only be trusted if nothing else has been drawn over them
+    Known = OnlyUpdate && pFont->ShownDigits == MaxDigits && pFont->x == x && pFont->y == y && pFont->gap == gap &&
+            pFont->BackColor == BackColor && pFont->ForeColor == ForeColor;
+    pFont->x = x;
+    pFont->y = y;
+    pFont->gap = gap;
+    pFont->BackColor = BackColor;
+    pFont->ForeColor = ForeColor;
+    pFont->ShownDigits = MaxDigits;
+
+    while (CurrentDigit < MaxDigits) {
+        Digit = (Value % 10);
+        segs = Digit + 1;
+        if (segs > 10 || !(CurrentDigit == 0 || Digit > 0 || Value > 9)) segs = 0;
+        segs = aLed7SegSegments[segs];
+
+        // Segments going off are erased first, as they overlap the ends of their neighbours
+        lastSegs = Known ? pFont->Shown[CurrentDigit] : 0x7F;
+        off = lastSegs & ~segs;
+        redraw = segs;
+        if (Known) {
+            redraw = 0;
+            for (i = 0; i < 7; i++)
+                if (off & (1 << i)) redraw |= aLed7SegNeighbours[i];
+            redraw = segs & (redraw | ~lastSegs);
+        }
+        if (off) {
+            SetColor(BackColor);
+            FontLed7SegDrawSegments(pFont, off, DigitX, y);
+        }
+        if (redraw) {
+            SetColor(ForeColor);
+            FontLed7SegDrawSegments(pFont, redraw, DigitX, y);
+        }
+        pFont->Shown[CurrentDigit] = segs;
+
+        Value /= 10;
+        DigitX -= pFont->SizeX + gap;
+        CurrentDigit++;
+    }
+    return (1);
+}
+
+WORD FontLed7SegPrintDigit(FONTLED7SEG *pFont, char d, UINT16 x, UINT16 y) {
+    UINT8 segs;
+
+    segs = d - '0' + 1;
+    if (segs > 10) segs = 0;
+    FontLed7SegDrawSegments(pFont, aLed7SegSegments[segs], x, y);
     return (1);
 }
@@ -1,12 +1,32 @@
+#ifndef _FONTLED7SEG_H
+#define _FONTLED7SEG_H
+
 #include "GenericTypeDefs.h"
 
-extern UINT8 FontLed7SegCurrentSizeX, FontLed7SegCurrentSizeY;
+#define FONTLED7SEG_MAX_DIGITS  10  // Digits whose segments are remembered by FontLed7SegPrintValue()
 
 typedef enum {
     FontLed7SegBar,
     FontLed7SegPoly
 } FontLed7SegStyle;
 
-void FontLed7SegSetSize(UINT8 sizeY, UINT8 sizeX, UINT8 thickness, FontLed7SegStyle Style);
-WORD FontLed7SegPrintValue(INT16 Value, INT16 LastValue, UINT16 x, UINT16 y, BYTE MaxDigits, BYTE gap, WORD BackColor, WORD ForeColor,BOOL OnlyUpdate);
-WORD FontLed7SegPrintDigit(char d, UINT16 x, UINT16 y);
+// Renderer state: each object drawing 7 segment digits owns one
+typedef struct {
+    UINT8 SizeX; // Digit width
+    UINT8 SizeY; // Digit height
+    UINT8 Thickness; // Segment thickness (FontLed7SegBar)
+    FontLed7SegStyle Style;
+    BYTE Coords[7][14]; // Segment rectangles (FontLed7SegBar) or outlines (FontLed7SegPoly), relative to the digit origin
+    UINT16 x, y; // Position of the value last printed
+    BYTE gap; // Space between digits of the value last printed
+    WORD BackColor, ForeColor; // Colors of the value last printed
+    BYTE ShownDigits; // Number of valid entries in Shown, 0 if the screen content is unknown
+    BYTE Shown[FONTLED7SEG_MAX_DIGITS]; // Segments lit in each digit, rightmost first
+} FONTLED7SEG;
+
+void FontLed7SegInit(FONTLED7SEG *pFont);
+void FontLed7SegSetSize(FONTLED7SEG *pFont, UINT8 sizeY, UINT8 sizeX, UINT8 thickness, FontLed7SegStyle Style);
+WORD FontLed7SegPrintValue(FONTLED7SEG *pFont, INT16 Value, UINT16 x, UINT16 y, BYTE MaxDigits, BYTE gap, WORD BackColor, WORD ForeColor, BOOL OnlyUpdate);
+WORD FontLed7SegPrintDigit(FONTLED7SEG *pFont, char d, UINT16 x, UINT16 y);
+
+#endif // _FONTLED7SEG_H
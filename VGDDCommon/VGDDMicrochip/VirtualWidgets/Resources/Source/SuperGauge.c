@@ -55,6 +55,14 @@
 // Date         Comment
 // *****************************************************************************
 //  2012/02/26	Start of Developing
+//  2026/10/17  FreeArc and pointer filled with horizontal spans, dial cache (SG_DIAL_CACHE)
+//  2026/10/17  Drawing progress kept in the object, no static state
+//  2026/10/17  Fixed point trigonometry (DialTrig), scale computed once
+//  2026/10/17  Pointer animated by tick (WidgetAnim), SgDraw() returns after each step
+//  2026/10/17  Only the value digit segments that changed are repainted
+//  2026/10/17  Drawing clipped to the object rectangle
+//  2026/10/17  Scale table overrun without sub-divisions fixed
+//  2026/10/17  No RAM dial cache when the driver cannot read pixels back
 // *****************************************************************************
 #include "Graphics/Graphics.h"
 #include <stdlib.h>
@@ -128,7 +136,7 @@ SUPERGAUGE *SgCreate(
     pSG->DigitsOffsetX = (INT16) (*(p + 25) << 8)+*(p + 26); // DigitsOffsetX;
     pSG->DigitsOffsetY = (INT16) (*(p + 27) << 8)+*(p + 28); // DigitsOffsetY;
 
-    pSG->value = -1;
+    pSG->value = pSG->newValue;
     pSG->lastValue = 0xffff;
     pSG->SegmentsCount = SegmentsCount;
     pSG->Segments = pSegments;
@@ -138,9 +146,19 @@ SUPERGAUGE *SgCreate(
     pSG->hdr.DrawObj = SgDraw; // draw function
     pSG->hdr.MsgObj = SgTranslateMsg; // message function
     pSG->hdr.MsgDefaultObj = SgMsgDefault; // default message function
-    pSG->hdr.FreeObj = NULL; // free function
+    pSG->hdr.FreeObj = SgFree; // free function
 
     pSG->state= SG_STATE_IDLE;
+    pSG->Arc.state = FREEARC_BEGIN;
+    pSG->pDialCache = NULL;
+    pSG->DialCacheOwned = FALSE;
+    pSG->DialCacheValid = FALSE;
+    pSG->DialCacheRow = SG_RESTORE_START;
+    pSG->DigitsCovered = FALSE;
+    FontLed7SegInit(&pSG->DigitsFont);
+    pSG->pScalePoints = NULL;
+    pSG->ScalePointsCount = 0;
+    AnimInit(&pSG->Anim, pSG->newValue, 2, 2);
 
     // Set the color scheme to be used
     if (pScheme == NULL)
@@ -157,7 +175,8 @@ SUPERGAUGE *SgCreate(
     // calculate dimensions of the SUPERGAUGE
     SgCalcDimensions(pSG);
     // Thanks Wolli:
-    GetCirclePoint(pSG->radius, pSG->degAngle % 360, &pSG->xLastPos, &pSG->yLastPos);
+    pSG->degAngle = DIAL_DEG(pSG->AngleFrom);
+    DialCirclePoint(pSG->radius, pSG->degAngle, &pSG->xLastPos, &pSG->yLastPos);
     pSG->xLastPos += pSG->xCenter;
     pSG->yLastPos += pSG->yCenter;
 
@@ -166,6 +185,87 @@ SUPERGAUGE *SgCreate(
     return (pSG);
 }
 
+// *********************************************************************
+// * Function: static void SgScalePoints(SUPERGAUGE *pSGauge, INT16 Division, BYTE SubDivision, SG_POINT *pPoints)
+// *
+// * Notes: Computes the points of the scale for the tick of Division
+// *        (SubDivision 0, three points) or for one of its sub-divisions
+// *        (two points). See SG_DIVISION_POINTS().
+// *
+// *********************************************************************
+static void SgScalePoints(SUPERGAUGE *pSGauge, INT16 Division, BYTE SubDivision, SG_POINT *pPoints) {
+    INT16 angle, radius;
+    WORD steps;
+
+    radius = (pSGauge->RectImgVirtualWidth >> 1) - (pSGauge->RectImgVirtualWidth * 10 / 100);
+    steps = pSGauge->DialScaleNumDivisions;
+    if (pSGauge->DialScaleNumSubDivisions)
+        steps *= pSGauge->DialScaleNumSubDivisions;
+    angle = DIAL_DEG(pSGauge->AngleFrom) + (INT16) ((INT32) DIAL_DEG(pSGauge->AngleTo - pSGauge->AngleFrom) *
+            ((WORD) Division * (steps / pSGauge->DialScaleNumDivisions) + SubDivision) / steps);
+    DialCirclePoint(radius, angle, &pPoints[0].x, &pPoints[0].y);
+    if (SubDivision == 0) {
+        DialCirclePoint(radius - pSGauge->RectImgWidth / 20, angle, &pPoints[1].x, &pPoints[1].y);
+        DialCirclePoint(radius + (pSGauge->RectImgWidth >> 5), angle, &pPoints[2].x, &pPoints[2].y);
+    } else {
+        DialCirclePoint(radius - (pSGauge->RectImgWidth >> 6), angle, &pPoints[1].x, &pPoints[1].y);
+    }
+}
+
+// *********************************************************************
+// * Function: static void SgCalcScale(SUPERGAUGE *pSGauge)
+// *
+// * Notes: Computes all the points of the scale once, so that no
+// *        trigonometry is left for SgDraw(). Without memory for them
+// *        pScalePoints stays NULL and each tick is computed when drawn.
+// *
+// *********************************************************************
+static void SgCalcScale(SUPERGAUGE *pSGauge) {
+    WORD count = SG_SCALE_POINTS(pSGauge);
+    INT16 division;
+    BYTE subDivision;
+    SG_POINT *pPoints;
+
+    if (pSGauge->pScalePoints != NULL && pSGauge->ScalePointsCount != count) {
+        GFX_free(pSGauge->pScalePoints);
+        pSGauge->pScalePoints = NULL;
+    }
+    if (count == 0)
+        return;
+    if (pSGauge->pScalePoints == NULL) {
+        pSGauge->pScalePoints = (SG_POINT *) GFX_malloc(count * sizeof (SG_POINT));
+        if (pSGauge->pScalePoints == NULL)
+            return;
+        pSGauge->ScalePointsCount = count;
+    }
+    pPoints = pSGauge->pScalePoints;
+    for (division = 0; division <= pSGauge->DialScaleNumDivisions; division++) {
+        SgScalePoints(pSGauge, division, 0, pPoints);
+        pPoints += 3;
+        if (division == pSGauge->DialScaleNumDivisions)
+            break;
+        for (subDivision = 1; subDivision < pSGauge->DialScaleNumSubDivisions; subDivision++) {
+            SgScalePoints(pSGauge, division, subDivision, pPoints);
+            pPoints += 2;
+        }
+    }
+}
+
+// *********************************************************************
+// * Function: static SG_POINT *SgGetScalePoints(SUPERGAUGE *pSGauge, INT16 Division, BYTE SubDivision, SG_POINT *pPoints)
+// *
+// * Notes: Returns the points of a tick of the scale, from pScalePoints
+// *        or computed in pPoints (three points long) if there is no table.
+// *
+// *********************************************************************
+static SG_POINT *SgGetScalePoints(SUPERGAUGE *pSGauge, INT16 Division, BYTE SubDivision, SG_POINT *pPoints) {
+    if (pSGauge->pScalePoints == NULL) {
+        SgScalePoints(pSGauge, Division, SubDivision, pPoints);
+        return pPoints;
+    }
+    return pSGauge->pScalePoints + Division * SG_DIVISION_POINTS(pSGauge) + (SubDivision ? 1 + 2 * SubDivision : 0);
+}
+
 // *********************************************************************
 // * Function: SuperGaugeCalcDimensions(void)
 // *
@@ -280,7 +380,8 @@ void SgCalcDimensions(SUPERGAUGE *pSGauge) {
         pSGauge->DrawStep = 1;
     pSGauge->DrawRadius = (pSGauge->RectImgWidth * (pSGauge->PointerCenterSize + 1) / 100);
     //pSGauge->RectImgWidth * pSGauge->PointerCenterSize / 100 + 1;
-
+    pSGauge->AngleScale = DialAngleScale(pSGauge->AngleFrom, pSGauge->AngleTo, pSGauge->minValue, pSGauge->maxValue);
+    SgCalcScale(pSGauge);
 }
 
 // *********************************************************************
@@ -292,17 +393,13 @@ void SgCalcDimensions(SUPERGAUGE *pSGauge) {
 // *
 // *********************************************************************
 void SgSetVal(SUPERGAUGE *pSGauge, INT16 newVal) {
-    if ((newVal < 0) || (newVal < pSGauge->minValue)) {
-        pSGauge->newValue = pSGauge->minValue;
-        return;
-    }
-
-    if (newVal > pSGauge->maxValue) {
-        pSGauge->newValue = pSGauge->maxValue;
-        return;
-    }
+    if ((newVal < 0) || (newVal < pSGauge->minValue))
+        newVal = pSGauge->minValue;
+    else if (newVal > pSGauge->maxValue)
+        newVal = pSGauge->maxValue;
 
     pSGauge->newValue = newVal;
+    AnimSetTarget(&pSGauge->Anim, newVal);
 }
 
 // *********************************************************************
@@ -366,6 +463,269 @@ WORD SgTranslateMsg(void *pObj, GOL_MSG *pMsg) {
     return (OBJ_MSG_INVALID);
 }
 
+// *********************************************************************
+// * Function: void SgSetDialCache(SUPERGAUGE *pSGauge, void *pBuffer)
+// *
+// * Notes: Sets the buffer for the copy of the dial (NULL to allocate it
+// *        at the next full draw).
+// *
+// *********************************************************************
+void SgSetDialCache(SUPERGAUGE *pSGauge, void *pBuffer) {
+    SgFreeDialCache(pSGauge);
+    pSGauge->pDialCache = pBuffer;
+}
+
+// *********************************************************************
+// * Function: void SgFreeDialCache(void *pObj)
+// *
+// * Notes: Frees the copy of the dial if it has been allocated here.
+// *
+// *********************************************************************
+void SgFreeDialCache(void *pObj) {
+    SUPERGAUGE *pSGauge = (SUPERGAUGE *) pObj;
+
+    if (pSGauge->DialCacheOwned)
+        GFX_free(pSGauge->pDialCache);
+    pSGauge->pDialCache = NULL;
+    pSGauge->DialCacheOwned = FALSE;
+    pSGauge->DialCacheValid = FALSE;
+}
+
+// *********************************************************************
+// * Function: void SgFree(void *pObj)
+// *
+// * Notes: Frees the scale and the copy of the dial.
+// *
+// *********************************************************************
+void SgFree(void *pObj) {
+    SUPERGAUGE *pSGauge = (SUPERGAUGE *) pObj;
+
+    if (pSGauge->pScalePoints != NULL)
+        GFX_free(pSGauge->pScalePoints);
+    pSGauge->pScalePoints = NULL;
+    pSGauge->ScalePointsCount = 0;
+    SgFreeDialCache(pSGauge);
+}
+
+// *********************************************************************
+// * Function: static WORD SgDialCacheSave(SUPERGAUGE *pSGauge)
+// *
+// * Notes: Copies the dial just drawn, one row per call of IsDeviceBusy().
+// *        When no memory is available, or the driver cannot read pixels
+// *        back (no GFX_DRV_GETPIXEL), the dial is not cached and the
+// *        pointer is erased as usual.
+// *
+// *********************************************************************
+static WORD SgDialCacheSave(SUPERGAUGE *pSGauge) {
+#ifdef SG_DIAL_CACHE_PAGE
+    CopyPageWindow(_GFXActivePage, SG_DIAL_CACHE_PAGE,
+            pSGauge->hdr.left, pSGauge->hdr.top, pSGauge->hdr.left, pSGauge->hdr.top,
+            pSGauge->hdr.right - pSGauge->hdr.left + 1, pSGauge->hdr.bottom - pSGauge->hdr.top + 1);
+    pSGauge->DialCacheValid = TRUE;
+#elif (COLOR_DEPTH == 16) && defined (GFX_DRV_GETPIXEL)
+    BITMAP_HEADER *pHeader;
+    WORD *pPixel;
+    INT16 x;
+
+    if (pSGauge->pDialCache == NULL) {
+        pSGauge->pDialCache = (BYTE *) GFX_malloc(SG_DIAL_CACHE_SIZE(pSGauge));
+        if (pSGauge->pDialCache == NULL)
+            return (1);
+        pSGauge->DialCacheOwned = TRUE;
+    }
+    for (; pSGauge->DialCacheRow <= pSGauge->hdr.bottom; pSGauge->DialCacheRow++) {
+        if (IsDeviceBusy())
+            return (0);
+        pPixel = (WORD *) (pSGauge->pDialCache + sizeof (BITMAP_HEADER)) +
+                (DWORD) (pSGauge->DialCacheRow - pSGauge->hdr.top) * (pSGauge->hdr.right - pSGauge->hdr.left + 1);
+        for (x = pSGauge->hdr.left; x <= pSGauge->hdr.right; x++)
+            *pPixel++ = GetPixel(x, pSGauge->DialCacheRow);
+    }
+    pHeader = (BITMAP_HEADER *) pSGauge->pDialCache;
+    pHeader->compression = 0;
+    pHeader->colorDepth = 16;
+    pHeader->width = pSGauge->hdr.right - pSGauge->hdr.left + 1;
+    pHeader->height = pSGauge->hdr.bottom - pSGauge->hdr.top + 1;
+    pSGauge->DialCacheImage.type = FLASH;
+    pSGauge->DialCacheImage.address = pSGauge->pDialCache;
+    pSGauge->DialCacheValid = TRUE;
+#endif
+    return (1);
+}
+
+// *********************************************************************
+// * Function: static void SgDigitsRect(SUPERGAUGE *pSGauge, INT16 *left, INT16 *top, INT16 *right, INT16 *bottom)
+// *
+// * Notes: Area of the value digits, with the sizes given to FontLed7SegSetSize()
+// *
+// *********************************************************************
+static void SgDigitsRect(SUPERGAUGE *pSGauge, INT16 *left, INT16 *top, INT16 *right, INT16 *bottom) {
+    UINT8 sizeX = pSGauge->RectImgHeight * pSGauge->DigitsSizeX / 100;
+    UINT8 sizeY = pSGauge->RectImgHeight * pSGauge->DigitsSizeY / 100;
+    INT16 gap = pSGauge->DigitsSizeX / 10;
+
+    *left = pSGauge->xCenter - (((sizeX + gap) * pSGauge->DigitsNumber) >> 1) + (pSGauge->RectImgWidth * pSGauge->DigitsOffsetX / 100);
+    *top = pSGauge->yCenter + ((INT32) (pSGauge->RectImgHeight * pSGauge->DigitsOffsetY) / 100);
+    *right = *left + (sizeX + gap) * pSGauge->DigitsNumber + 1;
+    *bottom = *top + sizeY + 1;
+}
+
+// *********************************************************************
+// * Function: static BOOL SgPointerOverDigits(SUPERGAUGE *pSGauge)
+// *
+// * Notes: TRUE if the pointer drawn at xLastPos, yLastPos may cross the
+// *        value digits. The pointer lies between its tip and the base
+// *        points, which are DrawRadius away from the center.
+// *
+// *********************************************************************
+static BOOL SgPointerOverDigits(SUPERGAUGE *pSGauge) {
+    INT16 dLeft, dTop, dRight, dBottom;
+    INT16 left = pSGauge->xCenter - pSGauge->DrawRadius, right = pSGauge->xCenter + pSGauge->DrawRadius;
+    INT16 top = pSGauge->yCenter - pSGauge->DrawRadius, bottom = pSGauge->yCenter + pSGauge->DrawRadius;
+
+    if (pSGauge->xLastPos < left) left = pSGauge->xLastPos;
+    if (pSGauge->xLastPos > right) right = pSGauge->xLastPos;
+    if (pSGauge->yLastPos < top) top = pSGauge->yLastPos;
+    if (pSGauge->yLastPos > bottom) bottom = pSGauge->yLastPos;
+    SgDigitsRect(pSGauge, &dLeft, &dTop, &dRight, &dBottom);
+    return (dLeft <= right + SG_RESTORE_MARGIN && dRight >= left - SG_RESTORE_MARGIN &&
+            dTop <= bottom + SG_RESTORE_MARGIN && dBottom >= top - SG_RESTORE_MARGIN);
+}
+
+// *********************************************************************
+// * Function: static WORD SgDialCacheRestore(SUPERGAUGE *pSGauge)
+// *
+// * Notes: Restores the dial under the pointer drawn at degAngle, xLastPos,
+// *        yLastPos and under the center circle, in bands of SG_RESTORE_BAND
+// *        rows each as wide as the part of the pointer that crosses it.
+// *        DialCacheRow must be set to SG_RESTORE_START before the first call.
+// *
+// *********************************************************************
+static WORD SgDialCacheRestore(SUPERGAUGE *pSGauge) {
+    INT16 px[3], py[3]; // Pointer outline: the two base points and the tip
+    INT16 r, yFrom, yTo, y, bottom, left, right, x, i, j, k;
+    INT16 dLeft, dTop, dRight, dBottom;
+
+    r = pSGauge->RectImgWidth * pSGauge->PointerCenterSize / 100;
+    DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle + DIAL_DEG(pSGauge->PointerWidth), &px[0], &py[0]);
+    DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle - DIAL_DEG(pSGauge->PointerWidth), &px[1], &py[1]);
+    px[0] += pSGauge->xCenter;
+    py[0] += pSGauge->yCenter;
+    px[1] += pSGauge->xCenter;
+    py[1] += pSGauge->yCenter;
+    px[2] = pSGauge->xLastPos;
+    py[2] = pSGauge->yLastPos;
+    yFrom = pSGauge->yCenter - r;
+    yTo = pSGauge->yCenter + r;
+    for (i = 0; i < 3; i++) {
+        if (py[i] < yFrom) yFrom = py[i];
+        if (py[i] > yTo) yTo = py[i];
+    }
+    yFrom -= SG_RESTORE_MARGIN;
+    yTo += SG_RESTORE_MARGIN;
+
+    if (pSGauge->DialCacheRow == SG_RESTORE_START)
+        pSGauge->DialCacheRow = yFrom;
+    if (pSGauge->DialCacheRow < pSGauge->hdr.top)
+        pSGauge->DialCacheRow = pSGauge->hdr.top;
+    SgDigitsRect(pSGauge, &dLeft, &dTop, &dRight, &dBottom);
+
+    for (; pSGauge->DialCacheRow <= yTo && pSGauge->DialCacheRow <= pSGauge->hdr.bottom;
+            pSGauge->DialCacheRow += SG_RESTORE_BAND) {
+        bottom = pSGauge->DialCacheRow + SG_RESTORE_BAND - 1;
+        if (bottom > pSGauge->hdr.bottom)
+            bottom = pSGauge->hdr.bottom;
+        // Horizontal extent of the outline between the band limits (widened by the margin)
+        left = pSGauge->hdr.right + 1;
+        right = pSGauge->hdr.left - 1;
+        for (i = 0; i < 3; i++) {
+            if (py[i] >= pSGauge->DialCacheRow - SG_RESTORE_MARGIN && py[i] <= bottom + SG_RESTORE_MARGIN) {
+                if (px[i] < left) left = px[i];
+                if (px[i] > right) right = px[i];
+            }
+            j = (i + 1) % 3;
+            for (k = 0; k < 2; k++) {
+                y = k ? bottom + SG_RESTORE_MARGIN : pSGauge->DialCacheRow - SG_RESTORE_MARGIN;
+                if ((y - py[i]) * (y - py[j]) < 0) {
+                    x = px[i] + (INT32) (px[j] - px[i]) * (y - py[i]) / (py[j] - py[i]);
+                    if (x < left) left = x;
+                    if (x > right) right = x;
+                }
+            }
+        }
+        if (pSGauge->DialCacheRow <= pSGauge->yCenter + r + SG_RESTORE_MARGIN && bottom >= pSGauge->yCenter - r - SG_RESTORE_MARGIN) {
+            if (pSGauge->xCenter - r < left) left = pSGauge->xCenter - r;
+            if (pSGauge->xCenter + r > right) right = pSGauge->xCenter + r;
+        }
+        left -= SG_RESTORE_MARGIN;
+        right += SG_RESTORE_MARGIN;
+        if (left < pSGauge->hdr.left) left = pSGauge->hdr.left;
+        if (right > pSGauge->hdr.right) right = pSGauge->hdr.right;
+        if (left > right)
+            continue;
+#ifdef SG_DIAL_CACHE_PAGE
+        CopyPageWindow(SG_DIAL_CACHE_PAGE, _GFXActivePage, left, pSGauge->DialCacheRow, left, pSGauge->DialCacheRow,
+                right - left + 1, bottom - pSGauge->DialCacheRow + 1);
+#else
+        if (!PutImagePartial(left, pSGauge->DialCacheRow, &pSGauge->DialCacheImage, 1,
+                left - pSGauge->hdr.left, pSGauge->DialCacheRow - pSGauge->hdr.top,
+                right - left + 1, bottom - pSGauge->DialCacheRow + 1))
+            return (0);
+#endif
+        if (left <= dRight && right >= dLeft && pSGauge->DialCacheRow <= dBottom && bottom >= dTop)
+            pSGauge->DigitsCovered = TRUE;
+    }
+    pSGauge->DialCacheRow = SG_RESTORE_START;
+    return (1);
+}
+
+// *********************************************************************
+// * Function: static WORD SgFillTriangle(INT16 x0, INT16 y0, INT16 x1, INT16 y1, INT16 x2, INT16 y2)
+// *
+// * Notes: Fills a triangle with the current color, one Bar() per row.
+// *        Returns 0 if the device got busy: the next call draws it again.
+// *
+// *********************************************************************
+static WORD SgFillTriangle(INT16 x0, INT16 y0, INT16 x1, INT16 y1, INT16 x2, INT16 y2) {
+    INT16 px[3], py[3];
+    INT16 y, yMin, yMax, xl, xr, x;
+    BYTE i, j;
+
+    px[0] = x0;
+    py[0] = y0;
+    px[1] = x1;
+    py[1] = y1;
+    px[2] = x2;
+    py[2] = y2;
+    yMin = yMax = y0;
+    for (i = 1; i < 3; i++) {
+        if (py[i] < yMin) yMin = py[i];
+        if (py[i] > yMax) yMax = py[i];
+    }
+    for (y = yMin; y <= yMax; y++) {
+        xl = 0x7fff;
+        xr = -0x7fff;
+        // Crossings of the three edges with this row
+        for (i = 0; i < 3; i++) {
+            j = (i + 1) % 3;
+            if ((y < py[i] && y < py[j]) || (y > py[i] && y > py[j]))
+                continue;
+            if (py[i] == py[j]) {
+                if (px[i] < xl) xl = px[i];
+                if (px[i] > xr) xr = px[i];
+                x = px[j];
+            } else {
+                x = px[i] + ((INT32) (px[j] - px[i]) * (y - py[i]) * 2 + (py[j] - py[i])) / ((py[j] - py[i]) * 2);
+            }
+            if (x < xl) xl = x;
+            if (x > xr) xr = x;
+        }
+        if (!Bar(xl, y, xr, y))
+            return (0);
+    }
+    return (1);
+}
+
 // *********************************************************************
 // * Function: BYTE SgDrawPointerSUPERGAUGE *pSGauge, WORD cColor1, WORD cColor2, BOOL Erasing)
 // *
@@ -373,42 +733,39 @@ WORD SgTranslateMsg(void *pObj, GOL_MSG *pMsg) {
 // *
 // *********************************************************************
 BYTE SgDrawPointer(SUPERGAUGE *pSGauge, WORD cColor1, WORD cColor2, BOOL Erasing) {
-    INT16 k = 0;
-    INT16 x1, y1, x2, y2;
+    INT16 x1, y1, x2, y2, xm, ym;
 
     if (IsDeviceBusy())
         return (0);
     switch (pSGauge->PointerType) {
         case SG_POINTER_NORMAL:
         case SG_POINTER_3D:
-            for (k = pSGauge->PointerWidth; k > 0; k -= pSGauge->DrawStep) {
-                GetCirclePoint(pSGauge->DrawRadius, (pSGauge->degAngle + k - 1) % 360, &x1, &y1);
-                SetColor(GetState(pSGauge, SG_POINTER_NORMAL) ? cColor1 : cColor2);
-                if (!Line(x1 + pSGauge->xCenter, y1 + pSGauge->yCenter,
-                        pSGauge->xLastPos, pSGauge->yLastPos))
-                    return (0);
-
-                GetCirclePoint(pSGauge->DrawRadius, (pSGauge->degAngle - k + 1) % 360, &x1, &y1);
-                SetColor(cColor1);
-                if (!Line(x1 + pSGauge->xCenter, y1 + pSGauge->yCenter,
-                        pSGauge->xLastPos, pSGauge->yLastPos))
-                    return (0);
-            }
+            // Two halves from the base chord to the tip, each filled with spans
+            DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle + DIAL_DEG(pSGauge->PointerWidth - 1), &x1, &y1);
+            DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle - DIAL_DEG(pSGauge->PointerWidth - 1), &x2, &y2);
+            xm = ((x1 + x2) >> 1) + pSGauge->xCenter;
+            ym = ((y1 + y2) >> 1) + pSGauge->yCenter;
+            SetColor(cColor2);
+            if (!SgFillTriangle(x1 + pSGauge->xCenter, y1 + pSGauge->yCenter, xm, ym, pSGauge->xLastPos, pSGauge->yLastPos))
+                return (0);
+            SetColor(cColor1);
+            if (!SgFillTriangle(x2 + pSGauge->xCenter, y2 + pSGauge->yCenter, xm, ym, pSGauge->xLastPos, pSGauge->yLastPos))
+                return (0);
             break;
 
         case SG_POINTER_NEEDLE:
             SetColor(cColor1);
-            GetCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle % 360, &x1, &y1);
+            DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle, &x1, &y1);
             if (!Line(x1 + pSGauge->xCenter, y1 + pSGauge->yCenter, pSGauge->xLastPos, pSGauge->yLastPos))
                 return (0);
             break;
 
         case SG_POINTER_WIREFRAME:
             SetColor(cColor1);
-            GetCirclePoint(pSGauge->DrawRadius, (pSGauge->degAngle + pSGauge->PointerWidth) % 360, &x1, &y1);
+            DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle + DIAL_DEG(pSGauge->PointerWidth), &x1, &y1);
             if (!Line(x1 + pSGauge->xCenter, y1 + pSGauge->yCenter, pSGauge->xLastPos, pSGauge->yLastPos))
                 return (0);
-            GetCirclePoint(pSGauge->DrawRadius, (pSGauge->degAngle - pSGauge->PointerWidth) % 360, &x2, &y2);
+            DialCirclePoint(pSGauge->DrawRadius, pSGauge->degAngle - DIAL_DEG(pSGauge->PointerWidth), &x2, &y2);
             if (!Line(x2 + pSGauge->xCenter, y2 + pSGauge->yCenter, pSGauge->xLastPos, pSGauge->yLastPos))
                 return (0);
             break;
@@ -427,29 +784,22 @@ BYTE SgDrawPointer(SUPERGAUGE *pSGauge, WORD cColor1, WORD cColor2, BOOL Erasing
 }
 
 // *********************************************************************
-// * Function: WORD SgDraw(void *pObj)
+// * Function: static WORD SgDrawStates(void *pObj)
 // *
 // * Notes: This is the state machine to draw the SUPERGAUGE.
 // *
 // *********************************************************************
-WORD SgDraw(void *pObj) {
-    static INT16 x1, y1, x2, y2;
-    static INT16 temp, j;
-    static INT16 CurrentDivision;
-    static XCHAR strVal[SCALECHARCOUNT + 1]; // add one more space here for the NULL character
-    //static XCHAR tempXchar[2] = {'8', 0}; // NULL is pre-defined here
-    //static float radian;
-    //static DWORD_VAL dTemp, dRes;
-    static INT16 rulerValue = 0;
-    static INT16 currentScaleDegAngle = 0;
-    static INT16 ArcAngleFrom;
-    static INT16 ArcAngleTo;
-    static BYTE CurrentSegment;
+static WORD SgDrawStates(void *pObj) {
+    INT16 x1, y1, x3, y3;
+    INT16 temp, j;
+    INT16 ArcAngleFrom;
+    INT16 ArcAngleTo;
+    SG_POINT points[3], *pPoints;
 
     SUPERGAUGE *pSG;
-    static SgSegment *Seg;
-    INT16 subDegAngle;
+    SgSegment *Seg;
     INT16 textSizeWidth;
+    BYTE anim;
 
     pSG = (SUPERGAUGE *) pObj;
 
@@ -459,23 +809,39 @@ WORD SgDraw(void *pObj) {
     switch (pSG->state) {
         case SG_STATE_IDLE:
             if (GetState(pSG, SG_HIDE)) { // Hide the SUPERGAUGE (remove from screen)
+                pSG->DialCacheValid = FALSE;
                 SetColor(pSG->hdr.pGolScheme->CommonBkColor);
                 if (!Bar(pSG->hdr.left, pSG->hdr.top, pSG->hdr.right, pSG->hdr.bottom)) // TODO: sostituire Bar con Bevel per hiding
                     return (0);
                 return (1);
             }
 
+            // Take the animation steps due since the last redraw. The old pointer
+            // position is kept in degAngle until it has been erased.
+            anim = AnimStep(&pSG->Anim);
+            if (anim & ANIM_RUNNING)
+                SetState(pSG, SG_DRAW_ANIMATING);
+            else
+                ClrState(pSG, SG_DRAW_ANIMATING);
+            pSG->value = AnimGetValue(&pSG->Anim);
+
             // Check if we need to draw the whole object
             SetLineThickness(NORMAL_LINE);
             SetLineType(SOLID_LINE);
             if (GetState(pSG, SG_DRAW)) {
+                // radius is left at the center circle size by the previous pointer draw
+                pSG->radius = pSG->RectImgVirtualWidth >> 1;
                 pSG->state = SG_STATE_DIAL_DRAW;
             } else {
+                if (!(anim & ANIM_MOVED))
+                    return (1); // Pointer still in place
                 pSG->state = SG_STATE_POINTER_ERASE;
                 goto pointer_draw_here;
             }
 
         case SG_STATE_DIAL_DRAW:
+            pSG->DialCacheValid = FALSE;
+            pSG->DigitsCovered = TRUE;
             if (GetState(pSG, SG_NOPANEL) == 0) {
                 SetColor(pSG->hdr.pGolScheme->CommonBkColor);
                 switch (pSG->GaugeType) {
@@ -485,7 +851,7 @@ WORD SgDraw(void *pObj) {
                         break;
                     case SUPERGAUGE_HALF180DOWN:
                     case SUPERGAUGE_HALF180UP:
-                        if (!FreeArc(pSG->xCenter, pSG->yCenter, 1, pSG->radius - pSG->BorderWidth, pSG->MainAngleFrom, pSG->MainAngleTo))
+                        if (!FreeArc(&pSG->Arc, pSG->xCenter, pSG->yCenter, 1, pSG->radius - pSG->BorderWidth, pSG->MainAngleFrom, pSG->MainAngleTo))
                             return (0);
                         break;
                 }
@@ -496,7 +862,7 @@ WORD SgDraw(void *pObj) {
             if (GetState(pSG, SG_NOPANEL) == 0) {
             SetColor(pSG->hdr.pGolScheme->Color1);
             //if (!Bevel(pSGauge->xCenter, pSGauge->yCenter, pSGauge->xCenter, pSGauge->yCenter, pSGauge->radius - j))
-            if (!FreeArc(pSG->xCenter, pSG->yCenter, pSG->radius, pSG->radius - pSG->BorderWidth, pSG->MainAngleFrom, pSG->MainAngleTo))
+            if (!FreeArc(&pSG->Arc, pSG->xCenter, pSG->yCenter, pSG->radius, pSG->radius - pSG->BorderWidth, pSG->MainAngleFrom, pSG->MainAngleTo))
                 return (0);
             //            SetLineThickness(THICK_LINE);
             //            if (!Bevel(pSGauge->xCenter, pSGauge->yCenter, pSGauge->xCenter, pSGauge->yCenter, pSGauge->radius - pSGauge->BorderWidth + 1))
@@ -506,17 +872,11 @@ WORD SgDraw(void *pObj) {
 
         case SG_STATE_SEGMENTS_DRAW_SETUP:
             pSG->radius = (pSG->RectImgVirtualWidth >> 1) - (pSG->RectImgVirtualWidth * 10 / 100);
-            CurrentSegment = 0;
+            pSG->CurrentSegment = 0;
             pSG->state = SG_STATE_SEGMENTS_DRAW;
 
         case SG_STATE_SEGMENTS_DRAW:
-            if (CurrentSegment < pSG->SegmentsCount) {
-                Seg = (void *) ((pSG->Segments)+(sizeof (SgSegment)) * CurrentSegment);
-                ArcAngleFrom = (Seg->StartValue - pSG->minValue) * 100 / (pSG->maxValue - pSG->minValue);
-                ArcAngleFrom = pSG->AngleFrom + (INT32) ((pSG->AngleTo - pSG->AngleFrom) * ArcAngleFrom) / 100;
-
-                ArcAngleTo = (Seg->EndValue - pSG->minValue) * 100 / (pSG->maxValue - pSG->minValue);
-                ArcAngleTo = pSG->AngleFrom + (INT32) ((pSG->AngleTo - pSG->AngleFrom) * ArcAngleTo) / 100;
+            if (pSG->CurrentSegment < pSG->SegmentsCount) {
                 pSG->state = SG_STATE_SEGMENT_DRAW;
                 goto draw_segment_here;
                 return 0;
@@ -527,10 +887,13 @@ WORD SgDraw(void *pObj) {
 
         case SG_STATE_SEGMENT_DRAW:
             draw_segment_here :
+            Seg = (void *) ((pSG->Segments)+(sizeof (SgSegment)) * pSG->CurrentSegment);
+            ArcAngleFrom = DIAL_VALUE_ANGLE(pSG->AngleFrom, pSG->AngleScale, (INT16) Seg->StartValue - pSG->minValue) >> DIAL_ANGLE_SHIFT;
+            ArcAngleTo = DIAL_VALUE_ANGLE(pSG->AngleFrom, pSG->AngleScale, (INT16) Seg->EndValue - pSG->minValue) >> DIAL_ANGLE_SHIFT;
             SetColor(Seg->SegmentColour);
-            if (FreeArc(pSG->xCenter, pSG->yCenter, pSG->radius, pSG->radius - pSG->RectImgWidth / 20,
+            if (FreeArc(&pSG->Arc, pSG->xCenter, pSG->yCenter, pSG->radius, pSG->radius - pSG->RectImgWidth / 20,
                     ArcAngleFrom, ArcAngleTo)) {
-                CurrentSegment++;
+                pSG->CurrentSegment++;
                 pSG->state = SG_STATE_SEGMENTS_DRAW;
             }
             return 0;
@@ -538,42 +901,37 @@ WORD SgDraw(void *pObj) {
         case SG_STATE_SCALE_COMPUTE:
             scale_compute_here :
 
-            rulerValue = pSG->minValue;
-            if (pSG->DialScaleNumDivisions && pSG->DialScaleNumSubDivisions)
-                pSG->subIncrDeg = ((((UINT32)(pSG->AngleTo - pSG->AngleFrom)) << 8) / pSG->DialScaleNumDivisions) / pSG->DialScaleNumSubDivisions;
-            pSG->subDivHeight = pSG->RectImgWidth >> 6;
-            CurrentDivision = 0;
+            pSG->rulerValue = pSG->minValue;
+            pSG->CurrentDivision = 0;
             //const XCHAR strMeasureString[] = {'0', 0};
             for (j = 0; j < SCALECHARCOUNT; j++) {
-                strVal[j] = (XCHAR) ' ';
+                pSG->strVal[j] = (XCHAR) ' ';
             }
-            strVal[SCALECHARCOUNT] = 0;
+            pSG->strVal[SCALECHARCOUNT] = 0;
             pSG->state = SG_STATE_SCALE_DRAW;
             return (0);
 
         case SG_STATE_SCALE_DRAW:
 //            scale_draw_here :
-            if (pSG->DialScaleNumDivisions==0 || CurrentDivision > pSG->DialScaleNumDivisions) {
+            if (pSG->DialScaleNumDivisions==0 || pSG->CurrentDivision > pSG->DialScaleNumDivisions) {
                 pSG->state = SG_STATE_CENTER_DRAW;
                 return (0);
             }
-            currentScaleDegAngle = (pSG->AngleFrom + (INT32) ((pSG->AngleTo - pSG->AngleFrom) * CurrentDivision) / pSG->DialScaleNumDivisions) % 360;
+            pPoints = SgGetScalePoints(pSG, pSG->CurrentDivision, 0, points);
 
             // Draw Thick Line
-            GetCirclePoint(pSG->radius, currentScaleDegAngle, &x1, &y1);
-            GetCirclePoint(pSG->radius - pSG->RectImgWidth / 20, currentScaleDegAngle, &x2, &y2);
             SetColor(pSG->hdr.pGolScheme->Color0);
             SetLineThickness(THICK_LINE);
-            if (!Line(x1 + pSG->xCenter, y1 + pSG->yCenter, x2 + pSG->xCenter, y2 + pSG->yCenter))
+            if (!Line(pPoints[0].x + pSG->xCenter, pPoints[0].y + pSG->yCenter, pPoints[1].x + pSG->xCenter, pPoints[1].y + pSG->yCenter))
                 return (0);
 
             //Draw Strings
             // this implements sprintf(strVal, "%d", temp); faster
             // note that this is just for values >= 0, while sprintf covers negative values.
             j = 1;
-            temp = rulerValue;
+            temp = pSG->rulerValue;
             do {
-                strVal[SCALECHARCOUNT - j] = (temp % 10) + '0';
+                pSG->strVal[SCALECHARCOUNT - j] = (temp % 10) + '0';
                 if (((temp /= 10) == 0) || (j >= SCALECHARCOUNT))
                     break;
                 j++;
@@ -585,32 +943,33 @@ WORD SgDraw(void *pObj) {
             SetFont(pSG->hdr.pGolScheme->pFont);
             SetColor(pSG->hdr.pGolScheme->TextColor0); // TODO: Textcolordisabled
             SetLineThickness(THICK_LINE);
-            GetCirclePoint(pSG->radius + (pSG->RectImgWidth>>5), currentScaleDegAngle, &x1, &y1);
-            textSizeWidth = GetTextWidth(&strVal[SCALECHARCOUNT - j], pSG->hdr.pGolScheme->pFont);
+            x1 = pPoints[2].x;
+            y1 = pPoints[2].y;
+            textSizeWidth = GetTextWidth(&pSG->strVal[SCALECHARCOUNT - j], pSG->hdr.pGolScheme->pFont);
             INT16 textSizeHeight=GetTextHeight(pSG->hdr.pGolScheme->pFont);
             if(x1<0) x1-=(textSizeWidth);
             if(x1==0) x1-=(textSizeWidth>>1);
             if(y1<0) y1-=(textSizeHeight>>2);
             MoveTo(x1 + pSG->xCenter, y1 + pSG->yCenter-(textSizeHeight>>1));
-            if (!OutText(&strVal[SCALECHARCOUNT - j]))
+            if (!OutText(&pSG->strVal[SCALECHARCOUNT - j]))
                 return (0);
-            rulerValue += (pSG->maxValue - pSG->minValue) / pSG->DialScaleNumDivisions;
-            if (++CurrentDivision >= pSG->DialScaleNumDivisions) {
+            pSG->rulerValue += (pSG->maxValue - pSG->minValue) / pSG->DialScaleNumDivisions;
+            if (++pSG->CurrentDivision >= pSG->DialScaleNumDivisions) {
                 return (0);
             }
-
-            //Draw thin lines
-            if (pSG->DialScaleNumSubDivisions) {
-                for (j = 1; j <= pSG->DialScaleNumSubDivisions - 1; j++) {
-                    subDegAngle = currentScaleDegAngle + ((((UINT32)pSG->subIncrDeg) * j) >> 8);
-                    GetCirclePoint(pSG->radius, subDegAngle, &x1, &y1);
-                    GetCirclePoint(pSG->radius - pSG->subDivHeight, subDegAngle, &x2, &y2);
-                    SetColor(pSG->hdr.pGolScheme->Color1); // TODO: _Scheme.Textcolordisabled
-                    SetLineThickness(THICK_LINE);
-                    if (!Line(x1 + pSG->xCenter, y1 + pSG->yCenter, x2 + pSG->xCenter, y2 + pSG->yCenter))
-                        return (0);
-                }
+            pSG->CurrentSubDivision = 1;
+            pSG->state = SG_STATE_SUBDIVISIONS_DRAW;
+
+        case SG_STATE_SUBDIVISIONS_DRAW:
+            //Draw thin lines after the division just drawn
+            for (; pSG->CurrentSubDivision < pSG->DialScaleNumSubDivisions; pSG->CurrentSubDivision++) {
+                pPoints = SgGetScalePoints(pSG, pSG->CurrentDivision - 1, pSG->CurrentSubDivision, points);
+                SetColor(pSG->hdr.pGolScheme->Color1); // TODO: _Scheme.Textcolordisabled
+                SetLineThickness(THICK_LINE);
+                if (!Line(pPoints[0].x + pSG->xCenter, pPoints[0].y + pSG->yCenter, pPoints[1].x + pSG->xCenter, pPoints[1].y + pSG->yCenter))
+                    return (0);
             }
+            pSG->state = SG_STATE_SCALE_DRAW;
             return (0);
 
 
@@ -643,21 +1002,38 @@ WORD SgDraw(void *pObj) {
         case SG_STATE_TEXT_DRAW_RUN:
             if (!OutText(pSG->pDialText))
                 return (0);
+            pSG->DialCacheRow = pSG->hdr.top;
+            pSG->state = SG_STATE_DIAL_CACHE;
+
+        case SG_STATE_DIAL_CACHE:
+            // The dial is complete: keep a copy to restore it under the pointer
+            if (GetState(pSG, SG_DIAL_CACHE)) {
+                if (!SgDialCacheSave(pSG))
+                    return (0);
+                pSG->DialCacheRow = SG_RESTORE_START;
+            }
             pSG->state = SG_STATE_POINTER_ERASE;
 
         case SG_STATE_POINTER_ERASE:
             pointer_draw_here :
             if (GetState(pSG, SG_DRAW_UPDATE)) {
-                // to update the pointer, redraw the old position with background color
-                SetLineThickness(THICK_LINE);
-                if (!SgDrawPointer(pSG, pSG->hdr.pGolScheme->CommonBkColor, pSG->hdr.pGolScheme->CommonBkColor, TRUE))
-                    return (0);
+                if (pSG->DialCacheValid && GetState(pSG, SG_DIAL_CACHE)) {
+                    // to update the pointer, restore the dial around the old position
+                    if (!SgDialCacheRestore(pSG))
+                        return (0);
+                } else {
+                    // to update the pointer, redraw the old position with background color
+                    SetLineThickness(THICK_LINE);
+                    if (!SgDrawPointer(pSG, pSG->hdr.pGolScheme->CommonBkColor, pSG->hdr.pGolScheme->CommonBkColor, TRUE))
+                        return (0);
+                    if (SgPointerOverDigits(pSG))
+                        pSG->DigitsCovered = TRUE;
+                }
             }
 
             pSG->radius = (pSG->RectImgWidth >> 1) - ((UINT32) (pSG->RectImgWidth * 16) / 100);
             //pSGauge->radius = (pSGauge->RectImgWidth >> 1) - (pSGauge->RectImgWidth * pSGauge->PointerCenterSize / 100);
-            pSG->degAngle = (pSG->value - pSG->minValue) * 100 / (pSG->maxValue - pSG->minValue);
-            pSG->degAngle = pSG->AngleFrom + (INT32) ((pSG->AngleTo - pSG->AngleFrom) * pSG->degAngle) / 100;
+            pSG->degAngle = DIAL_VALUE_ANGLE(pSG->AngleFrom, pSG->AngleScale, pSG->value - pSG->minValue);
             if (pSG->value != pSG->newValue)
                 pSG->state = SG_STATE_POINTER_DRAW;
             else
@@ -666,29 +1042,29 @@ WORD SgDraw(void *pObj) {
 
         case SG_STATE_VALUE_DRAW: // display the current value
 //            value_draw_here :
-            if (pSG->DigitsNumber & (pSG->value != pSG->lastValue)) {
+            // Digits are drawn again when the value changed or when their area has been repainted
+            SgDigitsRect(pSG, &x1, &y1, &x3, &y3);
+            if (pSG->DigitsNumber && ((pSG->value != pSG->lastValue) || pSG->DigitsCovered)) {
                 if (IsDeviceBusy())
                     return (0);
-                // The first time (or anytime, if other SegDigits objects are used) let's calculate segment sizes
-                //            if (FontLed7SegCurrentSizeX != pSGauge->DigitsSizeX || FontLed7SegCurrentSizeY != pSGauge->DigitsSizeY) {
-                FontLed7SegSetSize(pSG->RectImgHeight * pSG->DigitsSizeY / 100,
+                // Segment geometry is only computed again when the size changes
+                FontLed7SegSetSize(&pSG->DigitsFont, pSG->RectImgHeight * pSG->DigitsSizeY / 100,
                         pSG->RectImgHeight * pSG->DigitsSizeX / 100, 0, FontLed7SegPoly);
-                //            }
 
                 temp = pSG->DigitsSizeX / 10; // gap
-                x1 = pSG->xCenter - (((FontLed7SegCurrentSizeX + temp) * pSG->DigitsNumber) >> 1) + (pSG->RectImgWidth * pSG->DigitsOffsetX / 100);
-                y1 = ((INT32) (pSG->RectImgHeight * pSG->DigitsOffsetY) / 100);
-                y1 = pSG->yCenter + y1;
                 SetLineThickness(THICK_LINE);
-                FontLed7SegPrintValue(pSG->value, pSG->lastValue, x1, y1, pSG->DigitsNumber, temp, pSG->hdr.pGolScheme->CommonBkColor, pSG->hdr.pGolScheme->TextColor1, TRUE);
+                // Segments painted over by the dial must all be drawn again
+                FontLed7SegPrintValue(&pSG->DigitsFont, pSG->value, x1, y1, pSG->DigitsNumber, temp,
+                        pSG->hdr.pGolScheme->CommonBkColor, pSG->hdr.pGolScheme->TextColor1, !pSG->DigitsCovered);
             }
             pSG->lastValue = pSG->value;
+            pSG->DigitsCovered = FALSE;
             pSG->state = SG_STATE_POINTER_DRAW;
 
             //return (1);
 
         case SG_STATE_POINTER_DRAW: // Draw Pointer
-            GetCirclePoint(pSG->radius, pSG->degAngle % 360, &pSG->xLastPos, &pSG->yLastPos);
+            DialCirclePoint(pSG->radius, pSG->degAngle, &pSG->xLastPos, &pSG->yLastPos);
             pSG->xLastPos += pSG->xCenter;
             pSG->yLastPos += pSG->yCenter;
             SetLineThickness(GetState(pSG, SG_POINTER_THICK) ? THICK_LINE : NORMAL_LINE);
@@ -701,115 +1077,194 @@ WORD SgDraw(void *pObj) {
             if (!Bevel(pSG->xCenter, pSG->yCenter, pSG->xCenter, pSG->yCenter, pSG->radius))
                 return (0);
 
-            if (pSG->value == pSG->newValue) {
-                pSG->state = SG_STATE_IDLE;
-                ClrState(pSG, SG_DRAW_UPDATE);
-                //goto value_draw_here;
-                return (1);
-            } else {
-                if (pSG->value < pSG->newValue) {
-                    temp = ((pSG->newValue - pSG->value) >> 2);
-                    if (temp == 0)
-                        temp = 1;
-                } else {
-                    temp = -((pSG->value - pSG->newValue) >> 2);
-                    if (temp == 0)
-                        temp = -1;
-                }
-                pSG->value += temp;
-            }
-
-            SetLineThickness(NORMAL_LINE);
-            SetState(pSG, SG_DRAW_UPDATE);
-            pSG->state = SG_STATE_POINTER_ERASE;
-            return (0);
+            // One step drawn: the next one, if any, comes with the next SG_DRAW_UPDATE
+            pSG->state = SG_STATE_IDLE;
+            ClrState(pSG, SG_DRAW_UPDATE);
+            //goto value_draw_here;
+            return (1);
 
     }
 
     return (0);
 }
 
+// *********************************************************************
+// * Function: WORD SgDraw(void *pObj)
+// *
+// * Notes: Draws the SUPERGAUGE clipped to its rectangle: the scale
+// *        labels, the center and the pointer of a gauge whose dial
+// *        reaches its border (SUPERGAUGE_HALF180UP...) would otherwise
+// *        be drawn over the objects around it. The clipping is removed
+// *        on every return, busy ones included, so the objects the GOL
+// *        draws in between are not clipped.
+// *
+// *********************************************************************
+WORD SgDraw(void *pObj) {
+    SUPERGAUGE *pSG = (SUPERGAUGE *) pObj;
+    WORD done;
+
+    SetClipRgn(pSG->hdr.left, pSG->hdr.top, pSG->hdr.right, pSG->hdr.bottom);
+    SetClip(CLIP_ENABLE);
+    done = SgDrawStates(pObj);
+    SetClip(CLIP_DISABLE);
+    return (done);
+}
+
+// Integer square root (floor)
+static INT16 SgISqrt(INT32 n) {
+    UINT32 root = 0, bit = 1UL << 30, v = (UINT32) n;
+
+    if (n <= 0)
+        return 0;
+    while (bit > v)
+        bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return (INT16) root;
+}
+
+// Restricts the span [*lo, *hi] to the x satisfying a * x <= b
+static void SgRowLimit(INT32 a, INT32 b, INT16 *lo, INT16 *hi) {
+    INT32 q;
+
+    if (a > 0) {
+        q = (b >= 0) ? b / a : -((-b + a - 1) / a); // floor(b / a)
+        if (q < *hi)
+            *hi = (INT16) ((q < *lo - 1) ? *lo - 1 : q);
+    } else if (a < 0) {
+        a = -a;
+        q = (b >= 0) ? b / a : -((-b + a - 1) / a); // x >= -floor(b / -a)
+        q = -q;
+        if (q > *lo)
+            *lo = (INT16) ((q > *hi + 1) ? *hi + 1 : q);
+    } else if (b < 0) {
+        *hi = *lo - 1;
+    }
+}
+
 /*********************************************************************
- * Function: WORD FreeArc(INT16 xL, INT16 yT, INT16 xR, INT16 yB, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo);
+ * Function: WORD FreeArc(FREEARC_STATE *pArc, INT16 xc, INT16 yc, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo);
  *
  * PreCondition: none
  *
- * Input: xL, yT - location of the upper left center in the x,y coordinate
- *		 xc, yc - center x,y coordinate
- *		 r1, r2 - the two concentric circle radii, r1 as the radius
- *                         of the smaller circle and and r2 as the radius of the larger circle.
- *             AngleFrom - Angle in degrees to start drawing from
- *               AngleTo - Angle in degrees to end drawing
+ * Input:   pArc - progress of the drawing, state set to FREEARC_BEGIN before the first call
+ *        xc, yc - center x,y coordinate
+ *        r1, r2 - the two concentric circle radii, in any order
+ *     AngleFrom - Angle in degrees to start drawing from
+ *       AngleTo - Angle in degrees to end drawing
  *
  * Output: - Returns 0 when device is busy and the shape is not yet completely drawn.
  *         - Returns 1 when the shape is completely drawn.
  *
  * Side Effects: none
  *
- * Overview: Draws the arc of a beveled figure with given centers, radii, start and ending angles.
- *	    When r1 is zero and r2 has some value, a filled circle is drawn;
- *           When the radii have values, an arc of thickness (r2-r1) is drawn;
+ * Overview: Fills the sector of the ring between the two radii and the two angles
+ *           with the current color, one horizontal Bar() per span, top to bottom.
+ *           When the smaller radius is 0 or 1, a filled circle sector is drawn.
  *
- * Note: none
+ * Note: A sweep of 360 degrees or more draws the whole ring.
  *
  ********************************************************************/
-WORD FreeArc(INT16 xc, INT16 yc, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo) {
-
-    typedef enum {
-        BEGIN,
-        DRAWARC,
-    } FREEARC_STATES;
-
-    INT16 x1, y1, x2, y2;
-    static INT16 xo1, yo1, xo2, yo2;
-    static FREEARC_STATES state = BEGIN;
-    static INT16 currentDegAngle;
-    static INT16 currentSubArc;
-
-    if (IsDeviceBusy())
-        return (0);
-    switch (state) {
-        case BEGIN:
-            currentDegAngle = AngleFrom;
-            SetLineType(SOLID_LINE);
-            SetLineThickness(THICK_LINE);
-            xo1=0;
-            yo1=0;
-            xo2=0;
-            yo2=0;
-            state = DRAWARC;
-
-        case DRAWARC:
-            for(currentSubArc=0;currentSubArc < 10;currentSubArc++) {
-                GetCirclePoint(r1, currentDegAngle % 360, &x1, &y1);
-                GetCirclePoint(r2, currentDegAngle % 360, &x2, &y2);
-                x1+=xc;
-                y1+=yc;
-                x2+=xc;
-                y2+=yc;
-                if (!Line(x1, y1, x2, y2))
-                    return (0);
-                if(xo1>0 && yo1>0) {
-                    if (!Line(xo1, yo1, x1, y1))
-                        return (0);
-                    if (!Line(xo1, yo1, x2, y2))
-                        return (0);
-                    if (!Line(xo2, yo2, x2, y2))
-                        return (0);
-                    if (!Line(xo2, yo2, x1, y1))
-                        return (0);
+WORD FreeArc(FREEARC_STATE *pArc, INT16 xc, INT16 yc, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo) {
+    INT16 xo, xi, lo, hi, clo, chi, k;
+    INT16 segLo[2], segHi[2];
+    INT32 t;
+
+    switch (pArc->state) {
+        case FREEARC_BEGIN:
+            if (AngleTo < AngleFrom)
+                return 1;
+            pArc->rIn = (r1 < r2) ? r1 : r2;
+            pArc->rOut = (r1 < r2) ? r2 : r1;
+            if (pArc->rIn <= 1)
+                pArc->rIn = 0;
+            if (AngleTo - AngleFrom >= 360) {
+                pArc->sector = 0;
+            } else {
+                pArc->sector = (AngleTo - AngleFrom <= 180) ? 1 : 2;
+                DialCirclePoint(1024, DIAL_DEG(AngleFrom), &pArc->d0x, &pArc->d0y);
+                DialCirclePoint(1024, DIAL_DEG(AngleTo), &pArc->d1x, &pArc->d1y);
+                DialCirclePoint(1024, DIAL_DEG(AngleFrom + 90), &xo, &xi);
+                // Let the sector always run counterclockwise from d0 to d1
+                if ((INT32) pArc->d0x * xi - (INT32) pArc->d0y * xo < 0) {
+                    k = pArc->d0x; pArc->d0x = pArc->d1x; pArc->d1x = k;
+                    k = pArc->d0y; pArc->d0y = pArc->d1y; pArc->d1y = k;
+                }
+            }
+            pArc->y = -pArc->rOut;
+            pArc->state = FREEARC_DRAW;
+
+        case FREEARC_DRAW:
+            for (; pArc->y <= pArc->rOut; pArc->y++) {
+                // Outer circle: x*x + y*y < (rOut + 1/2)^2
+                t = (INT32) (2 * pArc->rOut + 1) * (2 * pArc->rOut + 1) - 4 * (INT32) pArc->y * pArc->y - 1;
+                xo = SgISqrt(t >> 2);
+                // Inner circle: x*x + y*y >= (rIn - 1/2)^2
+                xi = 0;
+                if (pArc->rIn) {
+                    t = (INT32) (2 * pArc->rIn - 1) * (2 * pArc->rIn - 1) - 4 * (INT32) pArc->y * pArc->y;
+                    if (t > 0) {
+                        t = (t + 3) >> 2;
+                        xi = SgISqrt(t);
+                        if ((INT32) xi * xi < t)
+                            xi++;
+                    }
                 }
-                xo1=x1;
-                yo1=y1;
-                xo2=x2;
-                yo2=y2;
-                currentDegAngle += 1;
-                if (currentDegAngle > AngleTo) {
-                    state = BEGIN;
-                    return 1;
+                if (xi == 0) {
+                    segLo[0] = -xo;
+                    segHi[0] = xo;
+                    segLo[1] = 1;
+                    segHi[1] = 0;
+                } else {
+                    segLo[0] = -xo;
+                    segHi[0] = -xi;
+                    segLo[1] = xi;
+                    segHi[1] = xo;
+                }
+                for (k = 0; k < 2; k++) {
+                    if (segLo[k] > segHi[k])
+                        continue;
+                    if (pArc->sector == 0) {
+                        lo = segLo[k];
+                        hi = segHi[k];
+                        if (!Bar(xc + lo, yc + pArc->y, xc + hi, yc + pArc->y))
+                            return (0);
+                    } else if (pArc->sector == 1) {
+                        lo = segLo[k];
+                        hi = segHi[k];
+                        SgRowLimit(pArc->d0y, (INT32) pArc->d0x * pArc->y, &lo, &hi);
+                        SgRowLimit(-pArc->d1y, -(INT32) pArc->d1x * pArc->y, &lo, &hi);
+                        if (lo <= hi && !Bar(xc + lo, yc + pArc->y, xc + hi, yc + pArc->y))
+                            return (0);
+                    } else {
+                        // Drawn part is the segment minus the span of the missing sector
+                        clo = segLo[k];
+                        chi = segHi[k];
+                        SgRowLimit(pArc->d1y, (INT32) pArc->d1x * pArc->y - 1, &clo, &chi);
+                        SgRowLimit(-pArc->d0y, -(INT32) pArc->d0x * pArc->y - 1, &clo, &chi);
+                        if (clo > chi) {
+                            clo = segHi[k] + 1;
+                            chi = segHi[k];
+                        }
+                        lo = segLo[k];
+                        hi = clo - 1;
+                        if (lo <= hi && !Bar(xc + lo, yc + pArc->y, xc + hi, yc + pArc->y))
+                            return (0);
+                        lo = chi + 1;
+                        hi = segHi[k];
+                        if (lo <= hi && !Bar(xc + lo, yc + pArc->y, xc + hi, yc + pArc->y))
+                            return (0);
+                    }
                 }
             }
-            break;
+            pArc->state = FREEARC_BEGIN;
+            return 1;
     } // end of switch
     return 0;
 }
@@ -55,6 +55,12 @@
 // Date         Comment
 // *****************************************************************************
 //  2012/02/26	Start of Developing
+//  2026/10/17  Span filled arcs and pointer, dial cache (SG_DIAL_CACHE)
+//  2026/10/17  Drawing progress kept in the object, no static state
+//  2026/10/17  Fixed point trigonometry (DialTrig), scale computed once
+//  2026/10/17  Tick driven pointer animation (WidgetAnim), one step per SgDraw()
+//  2026/10/17  Value digits drawn by a FONTLED7SEG renderer owned by the object
+//  2026/10/17  RAM dial cache only with drivers reading pixels back (GFX_DRV_GETPIXEL)
 // *****************************************************************************
 #ifndef _SUPERGAUGE_H
 #define _SUPERGAUGE_H
@@ -62,6 +68,9 @@
 #include "Graphics/GOL.h"
 #include "GenericTypeDefs.h"
 #include "Graphics/DisplayDriver.h"
+#include "DialTrig.h"
+#include "WidgetAnim.h"
+#include "FontLed7Seg.h"
 
 /*********************************************************************
  * Object States Definition:
@@ -70,6 +79,8 @@
 
 #define SG_POINTER_THICK    0x0004      // Pointer line drawn as THICK_LINE
 #define SG_NOPANEL          0x0020      // Bit to indicate bacground panel is disabled.
+#define SG_DIAL_CACHE       0x0040      // Bit to keep a copy of the dial and restore it under the pointer instead of erasing it.
+#define SG_DRAW_ANIMATING   0x0100      // Bit to indicate that the pointer is being animated and object needs a SG_DRAW_UPDATE.
 
 #define SG_DRAW_UPDATE      0x1000      // Bit to indicate an update only.
 #define SG_DRAW             0x4000      // Bit to indicate object must be redrawn.
@@ -110,9 +121,11 @@ typedef enum {
     SG_STATE_SCALE_COMPUTE,
     //SG_STATE_SCALE_LABEL_DRAW,
     SG_STATE_SCALE_DRAW,
+    SG_STATE_SUBDIVISIONS_DRAW,
     SG_STATE_CENTER_DRAW,
     SG_STATE_TEXT_DRAW,
     SG_STATE_TEXT_DRAW_RUN,
+    SG_STATE_DIAL_CACHE,
     SG_STATE_POINTER_ERASE,
     SG_STATE_POINTER_DRAW,
     //SG_STATE_VALUE_ERASE,
@@ -130,6 +143,66 @@ typedef enum {
                                     // You must include the decimal point if this
                                     // feature is enabled (see MTR_ACCURACY state bit).
 
+// *********************************************************************
+// * Dial cache (SG_DIAL_CACHE state bit)
+// * Once the dial (rim, segments, scale, labels and center) is drawn it is
+// * copied away, and every pointer update restores the area under
+// * the old pointer from the copy instead of drawing the pointer again in
+// * the background colour. The area is restored in bands of SG_RESTORE_BAND
+// * rows, each only as wide as the pointer where it crosses the band.
+// * - Define SG_DIAL_CACHE_PAGE in GraphicsConfig.h to a free display page
+// *   to keep the copy there (drivers with GFX_DRV_PAGE_COUNT, CopyPageWindow()).
+// * - Otherwise the copy is a 16bpp bitmap of SG_DIAL_CACHE_SIZE(pSG) bytes in RAM,
+// *   allocated with GFX_malloc() at the first draw unless a buffer (for example
+// *   in external memory mapped RAM) is given with SgSetDialCache().
+// *   The dial is read back with GetPixel(), so the display driver must define
+// *   GFX_DRV_GETPIXEL: the SSD1963 drivers do with USE_GFX_PMP (and
+// *   USE_16BIT_PMP for the MPP one), the R61509V and ILI9320 drivers always.
+// *   Define it in GraphicsConfig.h for another driver whose GetPixel() works.
+// *   Without it SG_DIAL_CACHE is ignored and the pointer is erased with the
+// *   background colour.
+// **********************************************************************
+#ifndef SG_RESTORE_BAND
+#define SG_RESTORE_BAND     8           // Rows restored with a single PutImagePartial()/CopyPageWindow()
+#endif
+#define SG_RESTORE_MARGIN   2           // Pixels restored around the pointer outline (thick lines, rounding)
+#define SG_RESTORE_START    (-32768)    // DialCacheRow value when no restore is in progress
+
+#define SG_DIAL_CACHE_SIZE(pSGauge) (sizeof (BITMAP_HEADER) + \
+        (DWORD) ((pSGauge)->hdr.right - (pSGauge)->hdr.left + 1) * ((pSGauge)->hdr.bottom - (pSGauge)->hdr.top + 1) * 2)
+
+// *********************************************************************
+// * Overview: Progress of FreeArc() while an arc is drawn.
+// *           Every object drawing arcs needs its own, so that objects
+// *           can be drawn interleaved when the device is busy.
+// *
+// **********************************************************************
+typedef enum {
+    FREEARC_BEGIN,
+    FREEARC_DRAW,
+} FREEARC_STATES;
+
+typedef struct {
+    FREEARC_STATES state;
+    BYTE sector; // 0 = full ring, 1 = up to 180 degrees, 2 = more than 180 degrees
+    INT16 rIn; // Inner and outer radius
+    INT16 rOut;
+    INT16 y; // Next row, relative to the center
+    INT16 d0x, d0y; // Directions of the start and end of the sector
+    INT16 d1x, d1y;
+} FREEARC_STATE;
+
+typedef struct {
+    INT16 x; // Relative to the center of the SuperGauge
+    INT16 y;
+} SG_POINT;
+
+// Points of the scale for each division: outer and inner end of the tick and
+// position of the label, then outer and inner end of each sub-division tick
+#define SG_DIVISION_POINTS(pSGauge) (1 + 2 * ((pSGauge)->DialScaleNumSubDivisions ? (pSGauge)->DialScaleNumSubDivisions : 1))
+#define SG_SCALE_POINTS(pSGauge)    ((pSGauge)->DialScaleNumDivisions ? \
+                                     (WORD) (pSGauge)->DialScaleNumDivisions * SG_DIVISION_POINTS(pSGauge) + 3 : 0)
+
 // *********************************************************************
 // * Overview: Defines the parameters required for a SuperGauge Object.
 // *           Depending on the type selected the SuperGauge is drawn with
@@ -187,10 +260,28 @@ typedef struct {
     INT16 PointerWidth;
     INT16 DrawStep;
     INT16 DrawRadius;
-    INT16 degAngle;
-    INT16 subDivHeight;
-    INT16 subIncrDeg;
+    INT16 degAngle; // Angle of the pointer, in 1/16 degree (see DialTrig.h)
+    INT32 AngleScale; // Value to angle factor for DIAL_VALUE_ANGLE()
+    SG_POINT *pScalePoints; // Scale computed by SgCalcDimensions(), SG_SCALE_POINTS(pSGauge) points. NULL if out of memory
+    WORD ScalePointsCount; // Number of points allocated in pScalePoints
     SG_DRAW_STATES state;
+
+    BYTE *pDialCache; // Copy of the dial as a 16bpp bitmap (SG_DIAL_CACHE in RAM)
+    IMAGE_FLASH DialCacheImage; // pDialCache as seen by PutImagePartial()
+    BOOL DialCacheOwned; // pDialCache has been allocated by the SuperGauge
+    BOOL DialCacheValid; // The copy matches the dial on the screen
+    INT16 DialCacheRow; // Next row to copy or to restore
+    BOOL DigitsCovered; // The value digits have been painted over and must be drawn again
+    WIDGET_ANIM Anim; // Pointer animation, see WidgetAnim.h
+    FONTLED7SEG DigitsFont; // Value digits geometry and segments shown
+
+    // Drawing progress of SgDraw()
+    FREEARC_STATE Arc; // Rim or segment being drawn
+    BYTE CurrentSegment; // Segment being drawn
+    INT16 CurrentDivision; // Scale division being drawn
+    BYTE CurrentSubDivision; // Scale sub-division being drawn
+    INT16 rulerValue; // Value of the current scale division
+    XCHAR strVal[SCALECHARCOUNT + 1]; // Label of the current scale division
 } SUPERGAUGE;
 
 typedef struct {
@@ -244,6 +335,62 @@ SUPERGAUGE *SgCreate(
 
 void SgCalcDimensions(SUPERGAUGE *pSGauge);
 
+/*********************************************************************
+ * Function: void SgSetDialCache(SUPERGAUGE *pSGauge, void *pBuffer)
+ *
+ * Overview: This function sets the buffer used to keep the copy of the dial
+ *           when SG_DIAL_CACHE is set and no SG_DIAL_CACHE_PAGE is defined.
+ *           The buffer must be SG_DIAL_CACHE_SIZE(pSGauge) bytes long.
+ *           Passing NULL lets the SuperGauge allocate it with GFX_malloc().
+ *           The copy is taken again at the next full draw (SG_DRAW).
+ *
+ * PreCondition: Object must be created before this function is called.
+ *
+ * Input: pSGauge - Pointer to the object.
+ *        pBuffer - Buffer for the copy of the dial, or NULL.
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void SgSetDialCache(SUPERGAUGE *pSGauge, void *pBuffer);
+
+/*********************************************************************
+ * Function: void SgFreeDialCache(void *pObj)
+ *
+ * Overview: Frees the copy of the dial if it was allocated by the SuperGauge.
+ *           Called by GOLFree() through the FreeObj member of the object.
+ *
+ * PreCondition: none
+ *
+ * Input: pObj - Pointer to the object.
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void SgFreeDialCache(void *pObj);
+
+/*********************************************************************
+ * Function: void SgFree(void *pObj)
+ *
+ * Overview: Frees the memory allocated by the SuperGauge: the scale computed
+ *           by SgCalcDimensions() and the copy of the dial.
+ *           Called by GOLFree() through the FreeObj member of the object.
+ *
+ * PreCondition: none
+ *
+ * Input: pObj - Pointer to the object.
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void SgFree(void *pObj);
+
 /*********************************************************************
  * Function: WORD SgTranslateMsg(void *pObj, GOL_MSG *pMsg)
  *
@@ -325,6 +472,10 @@ void SgMsgDefault(WORD translatedMsg, void *pObj, GOL_MSG *pMsg);
  *			range inclusive. If newVal is not in the range, minValue
  *			maxValue is assigned depending on the given newVal
  *			if less than minValue or above maxValue.
+ *			The pointer moves towards the last value set at the next
+ *			animation step: while it moves SgDraw() keeps the
+ *			SG_DRAW_ANIMATING bit set, and SG_DRAW_UPDATE must be set
+ *			again as long as it is.
  *
  * PreCondition: none
  *
@@ -491,6 +642,6 @@ WORD SgDraw(void *pObj);
  *
  ********************************************************************/
 #define SgSetValueFont(pSGauge, pNewFont) (((SUPERGAUGE *)pSGauge)->pValueFont = pNewFont)
-WORD FreeArc(INT16 xc, INT16 yc, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo);
+WORD FreeArc(FREEARC_STATE *pArc, INT16 xc, INT16 yc, INT16 r1, INT16 r2, INT16 AngleFrom, INT16 AngleTo);
 
 #endif // _SuperGauge_H
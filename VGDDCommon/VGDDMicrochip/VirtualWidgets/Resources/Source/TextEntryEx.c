@@ -56,6 +56,7 @@
 // *****************************************************************************
 //  2013/10/20	Initial release
 //  2014/10/19  Fixed TeExTranslateMsg bug with capacitive touchscreen
+//  2026/10/17  Drawing progress kept in the object, no static state
 // *****************************************************************************
 
 #include "Graphics/Graphics.h"
@@ -63,6 +64,16 @@
 
 #ifdef USE_TEXTENTRYEX
 
+XCHAR TeExNullString[] = {0, 0};
+XCHAR TeExSpaceString[] = {' ', 0};
+XCHAR TeExOkString[] = {'O', 'K', 0};
+XCHAR TeExBkString[] = {'B', 'K', 0};
+XCHAR TeExShString[] = {'S', 'H', 0};
+XCHAR TeExAlString[] = {'A', 'L', 0};
+XCHAR TeExSpString[] = {'S', 'P', 0};
+XCHAR TeExAlternateString[] = {'?', '1', '2', '3', 0};
+XCHAR TeExNormalString[] = {' ', 'a', 'b', 'c', 0};
+
 /*********************************************************************
  * Function: TEXTENTRYEX *TeExCreate(WORD ID, SHORT left, SHORT top, SHORT right, SHORT bottom, WORD state
  *					SHORT horizontalKeys, SHORT verticalKeys, XCHAR *pText[],
@@ -127,6 +138,7 @@ TEXTENTRYEX *TeExCreate (
     TeExSetBuffer(pTeEx, pBuffer, (INT16) (p[15] << 8) + p[16]); // set the text to be displayed buffer length is also initialized in this call
             pTeEx->pActiveKey = NULL;
     pTeEx->hdr.DrawObj = TeExDraw; // draw function
+    pTeEx->drawState = TEEX_START; // no drawing in progress
     pTeEx->hdr.MsgObj = TeExTranslateMsg; // message function
     pTeEx->hdr.MsgDefaultObj = TeExMsgDefault; // default message function
     pTeEx->hdr.FreeObj = TeExDelKeyMembers; // free function
@@ -204,37 +216,15 @@ void DrawPolyPathClose(void) {
  *
  ********************************************************************/
 WORD TeExDraw(void *pObj) {
-    static GFX_COLOR faceClr, embossLtClr, embossDkClr;
-    static WORD xText, yText;
-    static XCHAR XcharTmp;
-    static TEEX_KEYMEMBER *pKeyTemp = NULL;
-
-    static WORD CountOfKeys = 0;
-    static WORD counter = 0;
+    GFX_COLOR faceClr, embossLtClr, embossDkClr;
+    WORD xText, yText;
+    XCHAR XcharTmp;
     static XCHAR hideChar[2] = {0x2A, 0x00};
-    static WORD bitmapLeft,bitmapTop;
+    WORD bitmapLeft,bitmapTop;
     XCHAR *KeyText;
 
     GFX_COLOR color1, color2;
 
-    typedef enum {
-        TEEX_START,
-        TEEX_HIDE_WIDGET,
-        TEEX_DRAW_PANEL,
-        TEEX_INIT_DRAW_EDITBOX,
-        TEEX_DRAW_EDITBOX,
-        TEEX_DRAW_KEY_INIT,
-        TEEX_DRAW_KEY_SET_PANEL,
-        TEEX_DRAW_KEY_DRAW_PANEL,
-        TEEX_DRAW_KEY_TEXT,
-        TEEX_DRAW_KEY_UPDATE,
-        TEEX_UPDATE_STRING_INIT,
-        TEEX_UPDATE_STRING,
-        TEEX_WAIT_ERASE_EBOX_AREA,
-        TEEX_UPDATE_CHARACTERS,
-    } TEEX_DRAW_STATES;
-
-    static TEEX_DRAW_STATES state = TEEX_START;
     TEXTENTRYEX *pTeEx;
 
     pTeEx = (TEXTENTRYEX *) pObj;
@@ -243,12 +233,12 @@ WORD TeExDraw(void *pObj) {
         if (IsDeviceBusy())
             return (0);
 
-        switch (state) {
+        switch (pTeEx->drawState) {
             case TEEX_START:
 
                 if (GetState(pTeEx, TEEX_HIDE)) {
                     SetColor(pTeEx->hdr.pGolScheme->CommonBkColor);
-                    state = TEEX_HIDE_WIDGET;
+                    pTeEx->drawState = TEEX_HIDE_WIDGET;
                     // no break here so it falls through to the TEEX_HIDE_WIDGET state.
                 } else {
                     if (GetState(pTeEx, TEEX_DRAW)) {
@@ -274,24 +264,24 @@ WORD TeExDraw(void *pObj) {
                                 NULL,
                                 GOL_EMBOSS_SIZE
                                 );
-                        state = TEEX_DRAW_PANEL;
+                        pTeEx->drawState = TEEX_DRAW_PANEL;
                         break;
                     }
                         // update the keys (if TEEX_UPDATEEX_TEXT is also set it will also be redrawn)
                         // at the states after the keys are updated
                     else if (GetState(pTeEx, TEEX_DRAW_UPDATE)) {
                         ClrState(pTeEx, TEEX_KEY_PRESSED);
-                        state = TEEX_DRAW_KEY_INIT;
+                        pTeEx->drawState = TEEX_DRAW_KEY_INIT;
                         break;
                     }
                     else if (GetState(pTeEx, TEEX_UPDATE_KEY)) {
-                        state = TEEX_DRAW_KEY_INIT;
+                        pTeEx->drawState = TEEX_DRAW_KEY_INIT;
                         break;
                     }
 
                         // check if updating only the text displayed
                     else if (GetState(pTeEx, TEEX_UPDATE_TEXT)) {
-                        state = TEEX_UPDATE_STRING_INIT;
+                        pTeEx->drawState = TEEX_UPDATE_STRING_INIT;
                         break;
                     }
                 }
@@ -302,7 +292,7 @@ WORD TeExDraw(void *pObj) {
                 if (!Bar(pTeEx->hdr.left, pTeEx->hdr.top, pTeEx->hdr.right, pTeEx->hdr.bottom))
                     return (0);
                 else {
-                    state = TEEX_START;
+                    pTeEx->drawState = TEEX_START;
                     return (1);
                 }
 
@@ -310,7 +300,7 @@ WORD TeExDraw(void *pObj) {
             case TEEX_DRAW_PANEL:
                 if (!GOLPanelDrawTsk())
                     return (0);
-                state = TEEX_INIT_DRAW_EDITBOX;
+                pTeEx->drawState = TEEX_INIT_DRAW_EDITBOX;
 
             case TEEX_INIT_DRAW_EDITBOX:
 
@@ -322,56 +312,55 @@ WORD TeExDraw(void *pObj) {
                         pTeEx->hdr.right,
                         pTeEx->hdr.top + GetTextHeight(pTeEx->pDisplayFont) + GOL_EMBOSS_SIZE,
                         0,
-                        pTeEx->hdr.pGolScheme->Color1;,
+                        pTeEx->hdr.pGolScheme->Color1,
                         pTeEx->hdr.pGolScheme->EmbossDkColor,
                         pTeEx->hdr.pGolScheme->EmbossLtColor,
                         NULL,
                         GOL_EMBOSS_SIZE
                         );
 
-                state = TEEX_DRAW_EDITBOX;
+                pTeEx->drawState = TEEX_DRAW_EDITBOX;
 
             case TEEX_DRAW_EDITBOX:
                 if (!GOLPanelDrawTsk())
                     return (0);
-                state = TEEX_DRAW_KEY_INIT;
+                pTeEx->drawState = TEEX_DRAW_KEY_INIT;
 
                 /* ********************************************************************* */
                 /*                  Update the keys                                      */
                 /* ********************************************************************* */
             case TEEX_DRAW_KEY_INIT:
-                embossLtClr = pTeEx->hdr.pGolScheme->EmbossLtColor;
-                embossDkClr = pTeEx->hdr.pGolScheme->EmbossDkColor;
-                faceClr = pTeEx->hdr.pGolScheme->Color0;
-
                 if (GetState(pTeEx, TEEX_DRAW_UPDATE)) {
-                    CountOfKeys = 0;
-                    pKeyTemp = pTeEx->pHeadOfList;
+                    pTeEx->drawKeyCount = 0;
+                    pTeEx->pDrawKey = pTeEx->pHeadOfList;
                 } else if ((GetState(pTeEx, TEEX_DRAW) != TEEX_DRAW) && (pTeEx->pActiveKey->update == TRUE)) {
                     // if the active key update flag is set, only one needs to be redrawn
-                    CountOfKeys = pTeEx->totalKeys  - 1;
-                    pKeyTemp = pTeEx->pActiveKey;
+                    pTeEx->drawKeyCount = pTeEx->totalKeys  - 1;
+                    pTeEx->pDrawKey = pTeEx->pActiveKey;
                 } else {
-                    CountOfKeys = 0;
-                    pKeyTemp = pTeEx->pHeadOfList;
+                    pTeEx->drawKeyCount = 0;
+                    pTeEx->pDrawKey = pTeEx->pHeadOfList;
                 }
 
-                state = TEEX_DRAW_KEY_SET_PANEL;
+                pTeEx->drawState = TEEX_DRAW_KEY_SET_PANEL;
 
             case TEEX_DRAW_KEY_SET_PANEL:
-                if (CountOfKeys < pTeEx->totalKeys) {
-                    bitmapLeft=((pKeyTemp->right-pKeyTemp->left)-pTeEx->bitmapWidth)>>1;
-                    bitmapTop=((pKeyTemp->bottom-pKeyTemp->top)-pTeEx->bitmapHeight)>>1;
+                if (pTeEx->drawKeyCount < pTeEx->totalKeys) {
+                    embossLtClr = pTeEx->hdr.pGolScheme->EmbossLtColor;
+                    embossDkClr = pTeEx->hdr.pGolScheme->EmbossDkColor;
+                    faceClr = pTeEx->hdr.pGolScheme->Color0;
+                    bitmapLeft=((pTeEx->pDrawKey->right-pTeEx->pDrawKey->left)-pTeEx->bitmapWidth)>>1;
+                    bitmapTop=((pTeEx->pDrawKey->bottom-pTeEx->pDrawKey->top)-pTeEx->bitmapHeight)>>1;
                     // check if we need to draw the panel
                     if (GetState(pTeEx, TEEX_DRAW) != TEEX_DRAW && GetState(pTeEx, TEEX_DRAW_UPDATE) != TEEX_DRAW_UPDATE) {
-                        if (pKeyTemp->update == TRUE || GetState(pTeEx, TEEX_DRAW_UPDATE)) {
+                        if (pTeEx->pDrawKey->update == TRUE || GetState(pTeEx, TEEX_DRAW_UPDATE)) {
                             // set the colors needed
                             if (GetState(pTeEx, TEEX_KEY_PRESSED)) {
                                 // If a bitmap has been specified, then draw it and skip Panel settings
                                 if(pTeEx->pBitmapPressedKey!=NULL){
-                                    if(!PutImage(pKeyTemp->left+bitmapLeft, pKeyTemp->top+bitmapTop,pTeEx->pBitmapPressedKey,1))
+                                    if(!PutImage(pTeEx->pDrawKey->left+bitmapLeft, pTeEx->pDrawKey->top+bitmapTop,pTeEx->pBitmapPressedKey,1))
                                         return (0);
-                                    state = TEEX_DRAW_KEY_DRAW_PANEL;
+                                    pTeEx->drawState = TEEX_DRAW_KEY_DRAW_PANEL;
                                     break;
                                 }
                                 embossLtClr = pTeEx->hdr.pGolScheme->EmbossDkColor;
@@ -380,9 +369,9 @@ WORD TeExDraw(void *pObj) {
                             } else {
                                 // If a bitmap has been specified, then draw it and skip Panel settings
                                 if(pTeEx->pBitmapReleasedKey!=NULL){
-                                    if(!PutImage(pKeyTemp->left+bitmapLeft, pKeyTemp->top+bitmapTop,pTeEx->pBitmapReleasedKey,1))
+                                    if(!PutImage(pTeEx->pDrawKey->left+bitmapLeft, pTeEx->pDrawKey->top+bitmapTop,pTeEx->pBitmapReleasedKey,1))
                                         return (0);
-                                    state = TEEX_DRAW_KEY_DRAW_PANEL;
+                                    pTeEx->drawState = TEEX_DRAW_KEY_DRAW_PANEL;
                                     break;
                                 }
                                 embossLtClr = pTeEx->hdr.pGolScheme->EmbossLtColor;
@@ -390,16 +379,16 @@ WORD TeExDraw(void *pObj) {
                                 faceClr = pTeEx->hdr.pGolScheme->Color0;
                             }
                         } else {
-                            state = TEEX_DRAW_KEY_UPDATE;
+                            pTeEx->drawState = TEEX_DRAW_KEY_UPDATE;
                             break;
                         }
                     }
 
                     // If a bitmap has been specified as ReleasedKey, then draw it and skip Panel settings
                     if(pTeEx->pBitmapReleasedKey!=NULL){
-                        if(!PutImage(pKeyTemp->left+bitmapLeft, pKeyTemp->top+bitmapTop,pTeEx->pBitmapReleasedKey,1))
+                        if(!PutImage(pTeEx->pDrawKey->left+bitmapLeft, pTeEx->pDrawKey->top+bitmapTop,pTeEx->pBitmapReleasedKey,1))
                             return (0);
-                        state = TEEX_DRAW_KEY_DRAW_PANEL;
+                        pTeEx->drawState = TEEX_DRAW_KEY_DRAW_PANEL;
                         break;
                     }
 
@@ -415,10 +404,10 @@ WORD TeExDraw(void *pObj) {
                     // set up the panel
                     GOLPanelDraw
                             (
-                            pKeyTemp->left + pTeEx->radius,
-                            pKeyTemp->top + pTeEx->radius,
-                            pKeyTemp->right - pTeEx->radius,
-                            pKeyTemp->bottom - pTeEx->radius,
+                            pTeEx->pDrawKey->left + pTeEx->radius,
+                            pTeEx->pDrawKey->top + pTeEx->radius,
+                            pTeEx->pDrawKey->right - pTeEx->radius,
+                            pTeEx->pDrawKey->bottom - pTeEx->radius,
                             pTeEx->radius,
                             faceClr,
                             embossLtClr,
@@ -427,11 +416,11 @@ WORD TeExDraw(void *pObj) {
                             GOL_EMBOSS_SIZE
                             );
 
-                    state = TEEX_DRAW_KEY_DRAW_PANEL;
+                    pTeEx->drawState = TEEX_DRAW_KEY_DRAW_PANEL;
                 } else { // End of key drawing
                     TeExDrawCapsLock(pTeEx);
                     ClrState(pTeEx, TEEX_DRAW_UPDATE);
-                    state = TEEX_UPDATE_STRING_INIT;
+                    pTeEx->drawState = TEEX_UPDATE_STRING_INIT;
                     break;
                 }
 
@@ -443,22 +432,22 @@ WORD TeExDraw(void *pObj) {
                 }
 
                 // reset the update flag since the key panel is already redrawn
-                pKeyTemp->update = FALSE;
+                pTeEx->pDrawKey->update = FALSE;
 
                 //set the text coordinates of the drawn key
                 SHORT textWidth;
-                textWidth=pKeyTemp->textWidth;
+                textWidth=pTeEx->pDrawKey->textWidth;
                 if (GetState(pTeEx, TEEX_ALT_ACTIVE)) {
-                    if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pKeyTemp->pKeyNameShiftAlternate) != 0)
-                        textWidth = pKeyTemp->textWidthShiftAlternate;
-                    else if (*(pKeyTemp->pKeyNameAlternate) != 0)
-                        textWidth = pKeyTemp->textWidthAlternate;
-                } else if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pKeyTemp->pKeyNameShift) != 0) {
-                    textWidth = pKeyTemp->textWidthShift;
+                    if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pTeEx->pDrawKey->pKeyNameShiftAlternate) != 0)
+                        textWidth = pTeEx->pDrawKey->textWidthShiftAlternate;
+                    else if (*(pTeEx->pDrawKey->pKeyNameAlternate) != 0)
+                        textWidth = pTeEx->pDrawKey->textWidthAlternate;
+                } else if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pTeEx->pDrawKey->pKeyNameShift) != 0) {
+                    textWidth = pTeEx->pDrawKey->textWidthShift;
                 }
 
-                xText = ((pKeyTemp->left) + (pKeyTemp->right) - (textWidth)) >> 1;
-                yText = ((pKeyTemp->bottom) + (pKeyTemp->top) - (pKeyTemp->textHeight)) >> 1;
+                xText = ((pTeEx->pDrawKey->left) + (pTeEx->pDrawKey->right) - (textWidth)) >> 1;
+                yText = ((pTeEx->pDrawKey->bottom) + (pTeEx->pDrawKey->top) - (pTeEx->pDrawKey->textHeight)) >> 1;
 
                 //set color of text
                 // if the object is disabled, draw the disabled colors
@@ -478,15 +467,15 @@ WORD TeExDraw(void *pObj) {
                 // set the font to be used
                 SetFont(pTeEx->hdr.pGolScheme->pFont);
 
-                state = TEEX_DRAW_KEY_TEXT;
+                pTeEx->drawState = TEEX_DRAW_KEY_TEXT;
 
             case TEEX_DRAW_KEY_TEXT:
-                switch (pKeyTemp->command) {
+                switch (pTeEx->pDrawKey->command) {
                     case TEEX_BKSP_COM:
                         KeyText = NULLSTRING;
                         // d="m 90,20 20,-20 80,0 0,40 -80,0 z"
                         SetLineThickness(THICK_LINE);
-                        DrawPolyPathInit(pKeyTemp->left,pKeyTemp->top,pKeyTemp->right,pKeyTemp->bottom,14,64);
+                        DrawPolyPathInit(pTeEx->pDrawKey->left,pTeEx->pDrawKey->top,pTeEx->pDrawKey->right,pTeEx->pDrawKey->bottom,14,64);
                         DrawPolyPath(24,-24);
                         DrawPolyPath(68,0);
                         DrawPolyPath(0,48);
@@ -494,10 +483,10 @@ WORD TeExDraw(void *pObj) {
                         DrawPolyPath(-24,-24);
                         DrawPolyPathClose();
 
-                        DrawPolyPathInit(pKeyTemp->left,pKeyTemp->top,pKeyTemp->right,pKeyTemp->bottom,70,53);
+                        DrawPolyPathInit(pTeEx->pDrawKey->left,pTeEx->pDrawKey->top,pTeEx->pDrawKey->right,pTeEx->pDrawKey->bottom,70,53);
                         DrawPolyPath(22,22);
 
-                        DrawPolyPathInit(pKeyTemp->left,pKeyTemp->top,pKeyTemp->right,pKeyTemp->bottom,70,75);
+                        DrawPolyPathInit(pTeEx->pDrawKey->left,pTeEx->pDrawKey->top,pTeEx->pDrawKey->right,pTeEx->pDrawKey->bottom,70,75);
                         DrawPolyPath(22,-22);
                         SetLineThickness(NORMAL_LINE);
 
@@ -512,7 +501,7 @@ WORD TeExDraw(void *pObj) {
                         KeyText = NULLSTRING;
                         // m 30,0 -30,40 20,0 0,30 20,0 0,-30 20,0 z
                         SetLineThickness(THICK_LINE);
-                        DrawPolyPathInit(pKeyTemp->left,pKeyTemp->top,pKeyTemp->right,pKeyTemp->bottom,64,30);
+                        DrawPolyPathInit(pTeEx->pDrawKey->left,pTeEx->pDrawKey->top,pTeEx->pDrawKey->right,pTeEx->pDrawKey->bottom,64,30);
                         DrawPolyPath(-30,40);
                         DrawPolyPath(20,0);
                         DrawPolyPath(0,30);
@@ -530,29 +519,29 @@ WORD TeExDraw(void *pObj) {
                             KeyText = ALTERNATESTRING;
                         break;
                     default: {
-                        KeyText = pKeyTemp->pKeyName;
+                        KeyText = pTeEx->pDrawKey->pKeyName;
                         if (GetState(pTeEx, TEEX_ALT_ACTIVE)) {
-                            if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pKeyTemp->pKeyNameShiftAlternate) != 0)
-                                KeyText = pKeyTemp->pKeyNameShiftAlternate;
-                            else if (*(pKeyTemp->pKeyNameAlternate) != 0)
-                                KeyText = pKeyTemp->pKeyNameAlternate;
-                        } else if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pKeyTemp->pKeyNameShift) != 0) {
-                            KeyText = pKeyTemp->pKeyNameShift;
+                            if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pTeEx->pDrawKey->pKeyNameShiftAlternate) != 0)
+                                KeyText = pTeEx->pDrawKey->pKeyNameShiftAlternate;
+                            else if (*(pTeEx->pDrawKey->pKeyNameAlternate) != 0)
+                                KeyText = pTeEx->pDrawKey->pKeyNameAlternate;
+                        } else if (GetState(pTeEx, TEEX_SHIFT_ACTIVE) && *(pTeEx->pDrawKey->pKeyNameShift) != 0) {
+                            KeyText = pTeEx->pDrawKey->pKeyNameShift;
                         }
                     }
                 }
                 if (!OutText(KeyText))
                     return (0);
 
-                state = TEEX_DRAW_KEY_UPDATE;
+                pTeEx->drawState = TEEX_DRAW_KEY_UPDATE;
 
             case TEEX_DRAW_KEY_UPDATE:
 
                 // update loop variables
-                CountOfKeys++;
-                pKeyTemp = pKeyTemp->pNextKey;
+                pTeEx->drawKeyCount++;
+                pTeEx->pDrawKey = pTeEx->pDrawKey->pNextKey;
 
-                state = TEEX_DRAW_KEY_SET_PANEL;
+                pTeEx->drawState = TEEX_DRAW_KEY_SET_PANEL;
                 break;
 
                 /* ********************************************************************* */
@@ -564,7 +553,7 @@ WORD TeExDraw(void *pObj) {
                 if (pTeEx->pActiveKey != NULL) {
                     if (pTeEx->pActiveKey->command == TEEX_BKSP_COM) {
                         if (pTeEx->CurrentLength == 0) {
-                            state = TEEX_START;
+                            pTeEx->drawState = TEEX_START;
                             return (1);
                         }
                     }
@@ -572,21 +561,11 @@ WORD TeExDraw(void *pObj) {
 
                     // check if text indeed needs to be updated
                     if ((pTeEx->CurrentLength == pTeEx->outputLenMax) && (GetState(pTeEx, TEEX_UPDATE_TEXT))) {
-                        state = TEEX_START;
+                        pTeEx->drawState = TEEX_START;
                         return (1);
                     }
                 }
 
-                //set the clipping region
-                SetClipRgn
-                        (
-                        pTeEx->hdr.left + GOL_EMBOSS_SIZE,
-                        pTeEx->hdr.top + GOL_EMBOSS_SIZE,
-                        pTeEx->hdr.right - GOL_EMBOSS_SIZE,
-                        pTeEx->hdr.top + GOL_EMBOSS_SIZE + GetTextHeight(pTeEx->pDisplayFont)
-                        );
-
-                SetClip(1); //set the clipping
                 if (GetState(pTeEx, TEEX_DRAW)) {
 
                     // update only the displayed text
@@ -612,16 +591,16 @@ WORD TeExDraw(void *pObj) {
                     SetColor(pTeEx->hdr.pGolScheme->Color1);
 
                     // we have to make sure we finish the Bar() first before we continue.
-                    state = TEEX_WAIT_ERASE_EBOX_AREA;
+                    pTeEx->drawState = TEEX_WAIT_ERASE_EBOX_AREA;
                     break;
                 } else {
-                    SetClip(0); //reset the clipping
-                    state = TEEX_START;
+                    pTeEx->drawState = TEEX_START;
                     return (1);
                 }
 
-                counter = 0;
-                state = TEEX_UPDATE_STRING;
+                pTeEx->drawTextX = GetX();
+                pTeEx->drawCharCount = 0;
+                pTeEx->drawState = TEEX_UPDATE_STRING;
                 break;
 
             case TEEX_WAIT_ERASE_EBOX_AREA:
@@ -658,8 +637,9 @@ WORD TeExDraw(void *pObj) {
                             );
                 }
 
-                counter = 0;
-                state = TEEX_UPDATE_STRING;
+                pTeEx->drawTextX = GetX();
+                pTeEx->drawCharCount = 0;
+                pTeEx->drawState = TEEX_UPDATE_STRING;
                 // add a break here to force a check of IsDeviceBusy() so when last Bar() function is still
                 // ongoing it will wait for it to finish.
                 break;
@@ -672,25 +652,37 @@ WORD TeExDraw(void *pObj) {
 
                 // this is manually doing the OutText() function but with the capability to replace the
                 // characters to the * character when hide echo is enabled.
-                XcharTmp = *((pTeEx->pTeOutput) + counter);
+                XcharTmp = *((pTeEx->pTeOutput) + pTeEx->drawCharCount);
                 if (XcharTmp < (XCHAR) 15) {
 
                     // update is done time to return to start and exit with success
-                    SetClip(0); //reset the clipping
-                    state = TEEX_START;
+                    pTeEx->drawState = TEEX_START;
                     return (1);
                 } else {
+                    // cursor and clipping region are shared with the other objects, which
+                    // may have been drawn since the last character: set them for this one only
+                    MoveTo(pTeEx->drawTextX, pTeEx->hdr.top + GOL_EMBOSS_SIZE);
+                    SetClipRgn
+                            (
+                            pTeEx->hdr.left + GOL_EMBOSS_SIZE,
+                            pTeEx->hdr.top + GOL_EMBOSS_SIZE,
+                            pTeEx->hdr.right - GOL_EMBOSS_SIZE,
+                            pTeEx->hdr.top + GOL_EMBOSS_SIZE + GetTextHeight(pTeEx->pDisplayFont)
+                            );
+                    SetClip(1); //set the clipping
                     if (GetState(pTeEx, TEEX_ECHO_HIDE))
                         OutChar(0x2A);
                     else
                         OutChar(XcharTmp);
-                    state = TEEX_UPDATE_CHARACTERS;
+                    SetClip(0); //reset the clipping
+                    pTeEx->drawTextX = GetX();
+                    pTeEx->drawState = TEEX_UPDATE_CHARACTERS;
                 }
 
             case TEEX_UPDATE_CHARACTERS:
                 if (IsDeviceBusy()) return (0);
-                counter++;
-                state = TEEX_UPDATE_STRING;
+                pTeEx->drawCharCount++;
+                pTeEx->drawState = TEEX_UPDATE_STRING;
                 break;
         } //end switch
     } // end of while(1)
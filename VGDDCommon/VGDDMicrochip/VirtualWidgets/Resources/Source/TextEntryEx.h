@@ -55,6 +55,7 @@
 // Date         Comment
 // *****************************************************************************
 //  2013/10/20	Initial release
+//  2026/10/17  Drawing progress kept in the object, no static state
 // *****************************************************************************
 
 #ifndef _TEXTENTRYEX_H
@@ -95,16 +96,20 @@ extern DWORD tick;
 // callback function. Use the returned translated TEEX_MSG_ENTER to detect the key
 // pressed was assigned the enter command. Refer to TeTranslateMsg() for details.
 
+// Key captions live in TextEntryEx.c: compound literals used inside TeExDraw()
+// and TeExCreateKeyMembers() would go out of scope while still referenced.
+extern XCHAR TeExNullString[], TeExSpaceString[], TeExOkString[], TeExBkString[], TeExShString[],
+             TeExAlString[], TeExSpString[], TeExAlternateString[], TeExNormalString[];
 //#if defined(USE_MULTIBYTECHAR)
-#define NULLSTRING (XCHAR []){0,0} // ""
-#define SPACESTRING (XCHAR []){' ',0} // " "
-#define OKSTRING (XCHAR []){'O','K',0} // "OK"
-#define BKSTRING (XCHAR []){'B','K',0} // "BK"
-#define SHSTRING (XCHAR []){'S','H',0} // "SH"
-#define ALSTRING (XCHAR []){'A','L',0} // "AL"
-#define SPSTRING (XCHAR []){'S','P',0} // "SP"
-#define ALTERNATESTRING (XCHAR []){'?','1','2','3',0} // "?123"
-#define NORMALSTRING (XCHAR []){' ','a','b','c',0} // " abc"
+#define NULLSTRING TeExNullString // ""
+#define SPACESTRING TeExSpaceString // " "
+#define OKSTRING TeExOkString // "OK"
+#define BKSTRING TeExBkString // "BK"
+#define SHSTRING TeExShString // "SH"
+#define ALSTRING TeExAlString // "AL"
+#define SPSTRING TeExSpString // "SP"
+#define ALTERNATESTRING TeExAlternateString // "?123"
+#define NORMALSTRING TeExNormalString // " abc"
 //#else
 //#define NULLSTRING ""
 //#define SPACESTRING " "
@@ -142,6 +147,27 @@ typedef struct
     void    *pNextKey;               // Pointer to the next key parameters.
 } TEEX_KEYMEMBER;
 
+/*********************************************************************
+* Overview: States of the TeExDraw() state machine, kept in each object
+*           so that several TextEntryEx can be drawn at the same time.
+*********************************************************************/
+typedef enum {
+    TEEX_START,
+    TEEX_HIDE_WIDGET,
+    TEEX_DRAW_PANEL,
+    TEEX_INIT_DRAW_EDITBOX,
+    TEEX_DRAW_EDITBOX,
+    TEEX_DRAW_KEY_INIT,
+    TEEX_DRAW_KEY_SET_PANEL,
+    TEEX_DRAW_KEY_DRAW_PANEL,
+    TEEX_DRAW_KEY_TEXT,
+    TEEX_DRAW_KEY_UPDATE,
+    TEEX_UPDATE_STRING_INIT,
+    TEEX_UPDATE_STRING,
+    TEEX_WAIT_ERASE_EBOX_AREA,
+    TEEX_UPDATE_CHARACTERS,
+} TEEX_DRAW_STATES;
+
 /*********************************************************************
 * Overview: Defines the parameters required for a TextEntry Object.
 *********************************************************************/
@@ -176,6 +202,11 @@ typedef struct
     SHORT       bitmapHeight;         // Height of pBitmapReleasedKey, computed on TeExCreate. pBitmapPressedKey height is assumed to be the same
     SHORT       VerticalKeySpacing;   // Vertical spacing (in pixels) between keys and from widget's edges
     SHORT       HorizontalKeySpacing; // Horizontal spacing (in pixels) between keys and from widget's edges
+    TEEX_DRAW_STATES drawState;       // Current state of TeExDraw(). Used only by the Widget
+    TEEX_KEYMEMBER   *pDrawKey;       // Key being drawn by TeExDraw()
+    WORD        drawKeyCount;         // Number of keys already drawn by TeExDraw()
+    WORD        drawCharCount;        // Number of characters of pTeOutput already drawn by TeExDraw()
+    SHORT       drawTextX;            // Position of the next character of pTeOutput drawn by TeExDraw()
 } TEXTENTRYEX;
 
 /*********************************************************************
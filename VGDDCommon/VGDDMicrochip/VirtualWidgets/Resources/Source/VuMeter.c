@@ -56,6 +56,8 @@
 // *****************************************************************************
 //  2013/10/14	Initial release
 //  2013/12/31  Added different inertia for up/down (PointerSpeedDelay)
+//  2026/10/17  Fixed point trigonometry (DialTrig), no divisions per step
+//  2026/10/17  Pointer animated by tick (WidgetAnim) instead of by draw call
 // *****************************************************************************
 #include "Graphics/Graphics.h"
 
@@ -110,8 +112,8 @@ VUMETER *VuCreate(
     pVuMeter->AngleTo = (INT16)(*(p+10)<<8)+*(p+11);  // AngleTo;
     pVuMeter->minValue = (INT16)(*(p+3)<<8)+*(p+4); // minValue;
     pVuMeter->maxValue = (INT16)(*(p+5)<<8)+*(p+6); // maxValue;
-    pVuMeter->currentValue = -1;
     pVuMeter->newValue = (INT16)(*(p+1)<<8)+*(p+2); // value;
+    pVuMeter->currentValue = pVuMeter->newValue;
     pVuMeter->previousValue = 0xffff;
     pVuMeter->hdr.state = state; // state
     pVuMeter->PointerCenterOffsetX=(INT16)(*(p+12)<<8)+*(p+13); // PointerCenterOffsetX;
@@ -121,6 +123,7 @@ VUMETER *VuCreate(
     pVuMeter->PointerSpeed=(BYTE)*(p+19); //PointerSpeed;
     pVuMeter->PointerSpeedDecay=(BYTE)*(p+20); //PointerSpeed;
     pVuMeter->PointerStart=(INT16)(*(p+21)<<8)+*(p+22); //PointerStart;
+    AnimInit(&pVuMeter->Anim, pVuMeter->newValue, pVuMeter->PointerSpeed, pVuMeter->PointerSpeedDecay);
     pVuMeter->pBitmap=pBitmap;
     pVuMeter->hdr.DrawObj = VuDraw; // draw function
     pVuMeter->hdr.MsgObj = VuTranslateMsg; // message function
@@ -155,6 +158,7 @@ void VuCalcDimensions(VUMETER *pVuMeter) {
       pVuMeter->RectImgHeight = pVuMeter->hdr.bottom - pVuMeter->hdr.top - 1 - (pVuMeter->BorderWidth << 1);
       pVuMeter->Xcenter = pVuMeter->RectImgWidth * pVuMeter->PointerCenterOffsetX / 100;
       pVuMeter->Ycenter = pVuMeter->RectImgHeight - pVuMeter->RectImgHeight * pVuMeter->PointerCenterOffsetY / 100;
+      pVuMeter->AngleScale = DialAngleScale(pVuMeter->AngleFrom, pVuMeter->AngleTo, pVuMeter->minValue, pVuMeter->maxValue);
 }
 
 /*********************************************************************
@@ -163,24 +167,18 @@ void VuCalcDimensions(VUMETER *pVuMeter) {
  * Notes: Sets the value of the VUMETER to newVal. If newVal is less
  *		 than 0, 0 is assigned. If newVal is greater than range,
  *		 range is assigned.
+ *		 The pointer moves towards the last value set at the next
+ *		 animation step, see WidgetAnim.h.
  *
  ********************************************************************/
 void VuSetVal(VUMETER *pVuMeter, INT16 newVal) {
-    if (newVal < pVuMeter->minValue) {
-        pVuMeter->newValue = pVuMeter->minValue;
-        return;
-    }
-
-    if (newVal > pVuMeter->maxValue) {
-        pVuMeter->newValue = pVuMeter->maxValue;
-        return;
-    }
+    if (newVal < pVuMeter->minValue)
+        newVal = pVuMeter->minValue;
+    else if (newVal > pVuMeter->maxValue)
+        newVal = pVuMeter->maxValue;
 
     pVuMeter->newValue = newVal;
-    if((pVuMeter->currentValue<newVal && pVuMeter->PointerSpeed==0) ||
-       (pVuMeter->currentValue>newVal && pVuMeter->PointerSpeedDecay==0))
-        pVuMeter->currentValue=pVuMeter->newValue;
-
+    AnimSetTarget(&pVuMeter->Anim, newVal);
 }
 
 /*********************************************************************
@@ -284,6 +282,7 @@ WORD VuDraw(void *pObj) {
     VUMETER *pVuMeter;
     INT16  Xn2, Yn2, Xn3, Yn3;
     INT16 k = 0;
+    BYTE anim;
 
     pVuMeter = (VUMETER *) pObj;
 
@@ -297,9 +296,19 @@ WORD VuDraw(void *pObj) {
                 if (!Bar(pVuMeter->hdr.left, pVuMeter->hdr.top, pVuMeter->hdr.right, pVuMeter->hdr.bottom)) // TODO: sostituire Bar con Bevel per hiding
                     return (0);
                 return (1); // Finished!
-            } else if (GetState(pVuMeter, VU_DRAWALL)) { // Check if we need to draw the whole object
+            }
+            // Take the animation steps due since the last redraw
+            anim = AnimStep(&pVuMeter->Anim);
+            if (anim & ANIM_RUNNING)
+                SetState(pVuMeter, VU_DRAW_ANIMATING);
+            else
+                ClrState(pVuMeter, VU_DRAW_ANIMATING);
+            pVuMeter->currentValue = AnimGetValue(&pVuMeter->Anim);
+            if (GetState(pVuMeter, VU_DRAWALL)) { // Check if we need to draw the whole object
                 pVuMeter->state = VU_STATE_BACKGROUND_DRAW;
             } else if (GetState(pVuMeter, VU_DRAW_UPDATE)) { // Or only the pointer
+                if (!(anim & ANIM_MOVED))
+                    return (1); // Pointer still in place
                 pVuMeter->state = VU_STATE_POINTER_ERASE;
                 goto pointer_erase_here;
             } else {
@@ -362,9 +371,8 @@ WORD VuDraw(void *pObj) {
             pVuMeter->yo2 = 0;
 
             // Compute the pointer's vertex coordinates
-            pVuMeter->degAngle = (pVuMeter->currentValue - pVuMeter->minValue) * 100 / (pVuMeter->maxValue - pVuMeter->minValue);
-            pVuMeter->degAngle = pVuMeter->AngleFrom + (INT32) ((pVuMeter->AngleTo - pVuMeter->AngleFrom)) * pVuMeter->degAngle / 100;
-            GetCirclePoint(pVuMeter->PointerLength, pVuMeter->degAngle % 360, &pVuMeter->xStart, &pVuMeter->yStart);
+            pVuMeter->degAngle = DIAL_VALUE_ANGLE(pVuMeter->AngleFrom, pVuMeter->AngleScale, pVuMeter->currentValue - pVuMeter->minValue);
+            DialCirclePoint(pVuMeter->PointerLength, pVuMeter->degAngle, &pVuMeter->xStart, &pVuMeter->yStart);
             pVuMeter->xStart += pVuMeter->Xcenter;
             pVuMeter->yStart += pVuMeter->Ycenter;
             VuCheckCoords(pVuMeter, &pVuMeter->xStart, &pVuMeter->yStart);
@@ -378,8 +386,8 @@ WORD VuDraw(void *pObj) {
                 case VU_POINTER_NORMAL:
                 case VU_POINTER_3D:
                     for (k = 1; k<=(pVuMeter->PointerWidth >> 1); k++) { //GetState(pVuMeter, VU_POINTER_THICK) ?  2 :  1) {
-                        GetCirclePoint(pVuMeter->PointerStart, (pVuMeter->degAngle - k) % 360, &Xn2, &Yn2);
-                        GetCirclePoint(pVuMeter->PointerStart, (pVuMeter->degAngle + k) % 360, &Xn3, &Yn3);
+                        DialCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle - DIAL_DEG(k), &Xn2, &Yn2);
+                        DialCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle + DIAL_DEG(k), &Xn3, &Yn3);
                         Xn2 += pVuMeter->Xcenter;
                         Yn2 += pVuMeter->Ycenter;
                         Xn3 += pVuMeter->Xcenter;
@@ -401,8 +409,8 @@ WORD VuDraw(void *pObj) {
                     break;
 
                 case VU_POINTER_WIREFRAME:
-                    GetCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle - (pVuMeter->PointerWidth >> 1) % 360, &Xn2, &Yn2);
-                    GetCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle + (pVuMeter->PointerWidth >> 1) % 360, &Xn3, &Yn3);
+                    DialCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle - DIAL_DEG(pVuMeter->PointerWidth >> 1), &Xn2, &Yn2);
+                    DialCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle + DIAL_DEG(pVuMeter->PointerWidth >> 1), &Xn3, &Yn3);
                     Xn2 += pVuMeter->Xcenter;
                     Yn2 += pVuMeter->Ycenter;
                     Xn3 += pVuMeter->Xcenter;
@@ -425,7 +433,7 @@ WORD VuDraw(void *pObj) {
 
                 case VU_POINTER_NEEDLE:
                     SetColor(pVuMeter->hdr.pGolScheme->EmbossDkColor);
-                    GetCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle % 360, &Xn2, &Yn2);
+                    DialCirclePoint(pVuMeter->PointerStart, pVuMeter->degAngle, &Xn2, &Yn2);
                     Xn2 += pVuMeter->Xcenter;
                     Yn2 += pVuMeter->Ycenter;
                     VuCheckCoords(pVuMeter, &Xn2, &Yn2);
@@ -439,32 +447,8 @@ WORD VuDraw(void *pObj) {
 
             SetLineThickness(NORMAL_LINE);
             pVuMeter->state = VU_STATE_IDLE;
-            if (pVuMeter->currentValue == pVuMeter->newValue) {
-                ClrState(pVuMeter, VU_DRAW_UPDATE | VU_DRAWALL | VU_DRAW_ANIMATING);
-                return (1); // Finished updating!
-            } else {
-                INT16 AnimationIncrement;
-                if (pVuMeter->currentValue < pVuMeter->newValue) {
-                    if(pVuMeter->PointerSpeed==0) {
-                        pVuMeter->currentValue = pVuMeter->newValue;
-                    } else {
-                        AnimationIncrement = ((pVuMeter->newValue - pVuMeter->currentValue) >> pVuMeter->PointerSpeed);
-                        if (AnimationIncrement == 0)
-                            AnimationIncrement = 1;
-                        pVuMeter->currentValue += AnimationIncrement;
-                    }
-                } else if (pVuMeter->currentValue > pVuMeter->newValue) {
-                    if(pVuMeter->PointerSpeedDecay==0) {
-                        pVuMeter->currentValue = pVuMeter->newValue;
-                    } else {
-                        AnimationIncrement = -((pVuMeter->currentValue - pVuMeter->newValue) >> pVuMeter->PointerSpeedDecay);
-                        if (AnimationIncrement == 0)
-                            AnimationIncrement = -1;
-                        pVuMeter->currentValue += AnimationIncrement;
-                    }
-                }
-            }
-            SetState(pVuMeter, VU_DRAW_ANIMATING);
+            ClrState(pVuMeter, VU_DRAW_UPDATE | VU_DRAWALL);
+            return (1); // Finished updating!
     }
 
     return (1);
@@ -55,6 +55,8 @@
 // Date         Comment
 // *****************************************************************************
 //  2013/08/18	Start of Developing
+//  2026/10/17  Fixed point trigonometry (DialTrig)
+//  2026/10/17  Tick driven pointer animation (WidgetAnim)
 // *****************************************************************************
 #ifndef _VUMETER_H
 #define _VUMETER_H
@@ -62,6 +64,8 @@
 #include "Graphics/GOL.h"
 #include "GenericTypeDefs.h"
 #include "Graphics/DisplayDriver.h"
+#include "DialTrig.h"
+#include "WidgetAnim.h"
 
 /*********************************************************************
  * Object States Definition:
@@ -72,6 +76,7 @@
 
 #define VU_FRAME        0x0010      // Bit to indicate frame is to be drawn around the VuMeter.
 #define VU_DRAW_ANIMATING 0x0100      // Bit to indicate that needle is being animated and object needs a VU_DRAW_UPDATE.
+                                    // Set while Anim has not reached the value, see WidgetAnim.h
 #define VU_DRAW_UPDATE  0x1000      // Bit to indicate an update only.
 #define VU_DRAWALL      0x4000      // Bit to indicate object must be redrawn.
 #define VU_HIDE         0x8000      // Bit to indicate object must be removed from screen.
@@ -133,7 +138,9 @@ typedef struct {
 
     INT16 RectImgWidth;
     INT16 RectImgHeight;
-    INT16 degAngle;
+    INT16 degAngle; // Angle of the pointer, in 1/16 degree (see DialTrig.h)
+    INT32 AngleScale; // Value to angle factor for DIAL_VALUE_ANGLE(). Computed automatically
+    WIDGET_ANIM Anim; // Pointer animation. PointerSpeed and PointerSpeedDecay are its easing shifts
 
 } VUMETER;
 
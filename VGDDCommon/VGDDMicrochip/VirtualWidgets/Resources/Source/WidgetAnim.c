@@ -0,0 +1,160 @@
+// *****************************************************************************
+// Module for Microchip Graphics Library
+// GOL Layer
+// WidgetAnim - Tick driven value animation for gauges and bars
+// *****************************************************************************
+// FileName:        WidgetAnim.c
+// Processor:       PIC24F, PIC24H, dsPIC, PIC32
+// Compiler:        MPLAB C30/XC16, MPLAB C32/XC32
+// Company:         VirtualFab, parts from Microchip Technology Incorporated
+//
+// VirtualFab's Software License Agreement:
+// Copyright 2013-2016 Virtualfab - All rights reserved.
+// VirtualFab licenses to you the right to use, modify, copy and distribute
+// this software only in the event that you purchased at least one license of the VirtualFab's
+// Visual Graphics Display Designer (VGDD) software.
+//
+// Usage of this software without owning a License for VGDD is explicitly forbidden.
+//
+// The Demo version of VGDD, from which this source may come, doesn't allow you to use it
+// in any projects other than those created for test purposes, even if the code is manually created.
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+// OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Microchip's Software License Agreement:
+//
+// Copyright 2012 Microchip Technology Inc.  All rights reserved.
+// Microchip licenses to you the right to use, modify, copy and distribute
+// Software only when embedded on a Microchip microcontroller or digital
+// signal controller, which is integrated into your product or third party
+// product (pursuant to the sublicense terms in the accompanying license
+// agreement).
+//
+// You should refer to the license agreement accompanying this Software
+// for additional information regarding your rights and obligations.
+//
+// SOFTWARE AND DOCUMENTATION ARE PROVIDED "AS IS" WITHOUT WARRANTY OF ANY
+// KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY
+// OF MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR
+// PURPOSE. IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR
+// OBLIGATED UNDER CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION,
+// BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT
+// DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL,
+// INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA,
+// COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY
+// CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF),
+// OR OTHER SIMILAR COSTS.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+
+#include "WidgetAnim.h"
+
+void AnimInit(WIDGET_ANIM *pAnim, INT16 value, BYTE speed, BYTE speedDecay) {
+    pAnim->Pos = (INT32) value << 8;
+    pAnim->Target = value;
+    pAnim->Peak = value;
+    pAnim->Easing = ANIM_EASE_OUT;
+    pAnim->Speed = speed;
+    pAnim->SpeedDecay = speedDecay;
+    pAnim->PeakHold = 0;
+    pAnim->MaxRate = 0;
+    pAnim->MaxStep = 0;
+    pAnim->FrameTicks = ANIM_FRAME_TICKS;
+    pAnim->Running = FALSE;
+    pAnim->LastTick = tick - ANIM_FRAME_TICKS;
+    pAnim->PeakTick = tick;
+}
+
+void AnimSetTarget(WIDGET_ANIM *pAnim, INT16 value) {
+    pAnim->Target = value;
+    if (pAnim->PeakHold && (value >= pAnim->Peak || tick - pAnim->PeakTick >= pAnim->PeakHold)) {
+        pAnim->Peak = value;
+        pAnim->PeakTick = tick;
+    }
+}
+
+void AnimSetMaxRate(WIDGET_ANIM *pAnim, WORD maxRate) {
+    pAnim->MaxRate = maxRate;
+    pAnim->MaxStep = ((DWORD) maxRate << 8) * pAnim->FrameTicks / ANIM_TICKS_PER_SECOND;
+    if (maxRate && pAnim->MaxStep == 0)
+        pAnim->MaxStep = 1;
+}
+
+void AnimSetFrameTicks(WIDGET_ANIM *pAnim, WORD frameTicks) {
+    pAnim->FrameTicks = frameTicks ? frameTicks : 1;
+    AnimSetMaxRate(pAnim, pAnim->MaxRate);
+}
+
+// Position reached from pos towards goal in one step
+static INT32 AnimMove(WIDGET_ANIM *pAnim, INT32 pos, INT32 goal) {
+    INT32 dist, delta;
+    BYTE shift;
+
+    dist = goal - pos;
+    if (dist < 0)
+        dist = -dist;
+    shift = goal > pos ? pAnim->Speed : pAnim->SpeedDecay;
+    switch (pAnim->Easing) {
+        case ANIM_EASE_OUT:
+            delta = dist >> shift;
+            if (delta < 0x100)
+                delta = 0x100; // at least one unit per step, as before
+            break;
+        case ANIM_EASE_LINEAR:
+            delta = pAnim->MaxStep ? pAnim->MaxStep : dist;
+            break;
+        default:
+            delta = dist;
+            break;
+    }
+    if (pAnim->MaxStep && delta > pAnim->MaxStep)
+        delta = pAnim->MaxStep;
+    if (delta >= dist)
+        return goal;
+    return goal > pos ? pos + delta : pos - delta;
+}
+
+BYTE AnimStep(WIDGET_ANIM *pAnim) {
+    DWORD now = tick, elapsed = now - pAnim->LastTick;
+    INT16 shown = AnimGetValue(pAnim);
+    INT32 goal;
+    BYTE steps, held;
+
+    if (elapsed < pAnim->FrameTicks) {
+        // Too early: the values set in the meantime will be drawn at the next step
+        if (pAnim->Running || pAnim->Target != shown)
+            return (ANIM_RUNNING);
+        return (0);
+    }
+
+    // An animation that was at rest starts with a single step, whatever the time elapsed
+    steps = 1;
+    if (pAnim->Running) {
+        while (steps < ANIM_MAX_SKIP && elapsed >= (DWORD) pAnim->FrameTicks * (steps + 1))
+            steps++;
+    }
+    if (steps == ANIM_MAX_SKIP || !pAnim->Running)
+        pAnim->LastTick = now;
+    else
+        pAnim->LastTick += (DWORD) pAnim->FrameTicks * steps;
+
+    held = pAnim->PeakHold && pAnim->Peak > pAnim->Target && now - pAnim->PeakTick < pAnim->PeakHold;
+    if (!held)
+        pAnim->Peak = pAnim->Target;
+    goal = (INT32) (held ? pAnim->Peak : pAnim->Target) << 8;
+    while (steps-- && pAnim->Pos != goal)
+        pAnim->Pos = AnimMove(pAnim, pAnim->Pos, goal);
+
+    pAnim->Running = pAnim->Pos != goal || held;
+    return (AnimGetValue(pAnim) != shown ? ANIM_MOVED : 0) | (pAnim->Running ? ANIM_RUNNING : 0);
+}
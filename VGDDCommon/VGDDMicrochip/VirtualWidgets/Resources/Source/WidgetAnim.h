@@ -0,0 +1,179 @@
+// *****************************************************************************
+// Module for Microchip Graphics Library
+// GOL Layer
+// WidgetAnim - Tick driven value animation for gauges and bars
+// *****************************************************************************
+// FileName:        WidgetAnim.h
+// Processor:       PIC24F, PIC24H, dsPIC, PIC32
+// Compiler:        MPLAB C30/XC16, MPLAB C32/XC32
+// Company:         VirtualFab, parts from Microchip Technology Incorporated
+//
+// VirtualFab's Software License Agreement:
+// Copyright 2013-2016 Virtualfab - All rights reserved.
+// VirtualFab licenses to you the right to use, modify, copy and distribute
+// this software only in the event that you purchased at least one license of the VirtualFab's
+// Visual Graphics Display Designer (VGDD) software.
+//
+// Usage of this software without owning a License for VGDD is explicitly forbidden.
+//
+// The Demo version of VGDD, from which this source may come, doesn't allow you to use it
+// in any projects other than those created for test purposes, even if the code is manually created.
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+// OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Microchip's Software License Agreement:
+//
+// Copyright 2012 Microchip Technology Inc.  All rights reserved.
+// Microchip licenses to you the right to use, modify, copy and distribute
+// Software only when embedded on a Microchip microcontroller or digital
+// signal controller, which is integrated into your product or third party
+// product (pursuant to the sublicense terms in the accompanying license
+// agreement).
+//
+// You should refer to the license agreement accompanying this Software
+// for additional information regarding your rights and obligations.
+//
+// SOFTWARE AND DOCUMENTATION ARE PROVIDED "AS IS" WITHOUT WARRANTY OF ANY
+// KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY
+// OF MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR
+// PURPOSE. IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR
+// OBLIGATED UNDER CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION,
+// BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT
+// DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL,
+// INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA,
+// COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY
+// CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF),
+// OR OTHER SIMILAR COSTS.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _WIDGETANIM_H
+#define _WIDGETANIM_H
+
+#include "GenericTypeDefs.h"
+
+extern DWORD tick;
+
+/*********************************************************************
+ * The animation advances in steps of ANIM_FRAME_TICKS ticks of the
+ * global tick counter, whatever the number of GOLDraw() calls in
+ * between, so the pointer speed does not depend on the CPU load.
+ * Values set between two steps are merged: only the last one is used.
+ * When a redraw took longer than one step, the missed steps are applied
+ * together (at most ANIM_MAX_SKIP of them) and drawn once.
+ * These can be overridden in GraphicsConfig.h.
+ *********************************************************************/
+#ifndef ANIM_TICKS_PER_SECOND
+    #define ANIM_TICKS_PER_SECOND   1000    // Rate of the tick counter
+#endif
+#ifndef ANIM_FRAME_TICKS
+    #define ANIM_FRAME_TICKS        20      // Ticks per animation step (default 50 steps per second)
+#endif
+#ifndef ANIM_MAX_SKIP
+    #define ANIM_MAX_SKIP           8       // Steps applied at most in a single redraw
+#endif
+
+// Easing curves
+typedef enum {
+    ANIM_EASE_NONE,     // Jump to the value at the next step
+    ANIM_EASE_OUT,      // Move by 1/2^Speed of the remaining distance per step, decelerating
+    ANIM_EASE_LINEAR    // Move at the maximum rate set with AnimSetMaxRate()
+} ANIM_EASING;
+
+// AnimStep() result bits
+#define ANIM_MOVED      0x01    // The displayed value changed: redraw
+#define ANIM_RUNNING    0x02    // The target is not reached yet: call AnimStep() again later
+
+/*********************************************************************
+ * Overview: Animation state of one widget value. Positions are kept
+ *           with 8 fraction bits so that slow rates still progress.
+ *
+ *********************************************************************/
+typedef struct {
+    INT32 Pos;          // Current position, value << 8
+    INT32 MaxStep;      // Largest move per step, value << 8 (0: unlimited). Computed automatically
+    INT16 Target;       // Last value set
+    INT16 Peak;         // Highest value set, held for PeakHold ticks
+    DWORD LastTick;     // Tick of the last step
+    DWORD PeakTick;     // Tick when Peak was set
+    WORD PeakHold;      // Ticks the pointer stays on a peak before falling (0: no peak hold)
+    WORD MaxRate;       // Maximum speed in values per second (0: unlimited)
+    WORD FrameTicks;    // Ticks per step
+    BYTE Easing;        // One of ANIM_EASING
+    BYTE Speed;         // ANIM_EASE_OUT shift when rising, 0: immediate
+    BYTE SpeedDecay;    // ANIM_EASE_OUT shift when falling, 0: immediate
+    BYTE Running;       // Not at the target at the last step
+} WIDGET_ANIM;
+
+/*********************************************************************
+ * Function: void AnimInit(WIDGET_ANIM *pAnim, INT16 value, BYTE speed, BYTE speedDecay)
+ *
+ * Overview: Sets the animation at value, with ANIM_EASE_OUT easing, the
+ *           given shifts, ANIM_FRAME_TICKS per step, no rate limit and
+ *           no peak hold.
+ *
+ ********************************************************************/
+void AnimInit(WIDGET_ANIM *pAnim, INT16 value, BYTE speed, BYTE speedDecay);
+
+/*********************************************************************
+ * Function: void AnimSetTarget(WIDGET_ANIM *pAnim, INT16 value)
+ *
+ * Overview: Sets the value to reach. It can be called at any rate: the
+ *           widget moves towards the last value set at the next step.
+ *
+ ********************************************************************/
+void AnimSetTarget(WIDGET_ANIM *pAnim, INT16 value);
+
+/*********************************************************************
+ * Function: BYTE AnimStep(WIDGET_ANIM *pAnim)
+ *
+ * Overview: Called by the widget when an update is requested. Applies
+ *           the steps due since the last one and returns ANIM_MOVED if
+ *           the displayed value changed and ANIM_RUNNING while the
+ *           target (or the end of a peak hold) has not been reached.
+ *           Returns 0 when there is nothing to draw and nothing to wait for.
+ *
+ ********************************************************************/
+BYTE AnimStep(WIDGET_ANIM *pAnim);
+
+/*********************************************************************
+ * Function: void AnimSetMaxRate(WIDGET_ANIM *pAnim, WORD maxRate)
+ *
+ * Overview: Limits the speed to maxRate values per second, 0 to remove the
+ *           limit. On dials, angles are proportional to values, so this
+ *           is also the maximum angular velocity of the pointer.
+ *
+ ********************************************************************/
+void AnimSetMaxRate(WIDGET_ANIM *pAnim, WORD maxRate);
+
+/*********************************************************************
+ * Function: void AnimSetFrameTicks(WIDGET_ANIM *pAnim, WORD frameTicks)
+ *
+ * Overview: Sets the ticks between two steps, i.e. the highest redraw rate
+ *           of the widget.
+ *
+ ********************************************************************/
+void AnimSetFrameTicks(WIDGET_ANIM *pAnim, WORD frameTicks);
+
+/*********************************************************************
+ * Macros: AnimGetValue(pAnim), AnimSetEasing(pAnim, easing),
+ *         AnimSetPeakHold(pAnim, ticks)
+ *
+ * Overview: Value to display, easing curve (see ANIM_EASING) and time
+ *           the pointer is held on a peak before falling.
+ *
+ ********************************************************************/
+#define AnimGetValue(pAnim)             ((INT16) (((pAnim)->Pos + 0x80) >> 8))
+#define AnimSetEasing(pAnim, easing)    ((pAnim)->Easing = (easing))
+#define AnimSetPeakHold(pAnim, ticks)   ((pAnim)->PeakHold = (ticks))
+
+#endif // _WIDGETANIM_H
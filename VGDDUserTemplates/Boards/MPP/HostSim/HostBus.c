@@ -0,0 +1,596 @@
+// *****************************************************************************
+// MPP host simulation
+// Bus trace of the SSD1963 driver on line heavy screens
+// *****************************************************************************
+// FileName:        HostBus.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// drvSSD1963.c is built against a model of the SSD1963 parallel bus: every
+// DeviceWrite() is counted as a command (RS low) or a data word, and the data
+// words are split in command parameters and pixels written after
+// CMD_WR_MEMSTART. The model keeps the column and page addresses and the
+// memory write position as the SSD1963 does, so the pixels land in a model of
+// its frame memory.
+//
+// The screens are drawn the way the Primitive Layer draws them: diagonal
+// lines with PutPixel() (Bresenham), horizontal and vertical lines with Bar(),
+// circles with PutPixel() in eight octants, text glyphs with PutPixel(), row
+// by row. The same pixels are set in a reference frame; any difference with
+// the model frame memory, or a bus write with the SSD1963 not selected, makes
+// the tool exit with 2.
+//
+// For each screen it reports the PutPixel() calls and the commands, parameter
+// words and pixel words they wrote, then the bus writes per PutPixel(). Built
+// against an earlier drvSSD1963.c it gives the figures to compare with.
+//
+// The save-under screen reads the frame memory back: the box under each needle
+// is saved with GetRow(), checked against the reference, then restored with
+// PutPixel() once the needle has been drawn. The same box is also read with
+// GetPixel(), and the bus cycles of both reads are reported.
+//
+// The image screens draw random 1, 4, 8 and 16 bpp images, normal and
+// stretched, from a model of the external memory. The second one puts them
+// across the edges of the screen and of a clipping region. For each screen the
+// bus writes per image pixel drawn and the external memory reads are reported.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Iinclude -I.. -o HostBus HostBus.c ../drvSSD1963.c
+//
+// Usage:
+//   HostBus [-s seed] [-p page]
+//     -s  random seed (default 1)
+//     -p  active page drawn on, 0 or 1 (default 0)
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Frame memory reads, save-under screen
+//  2026/10/17	Image screens
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HardwareProfile.h"
+#include "Graphics/Graphics.h"
+#include "Graphics/gfxpmp.h"
+#include "drvSSD1963.h"
+
+#define SCREEN_W        (DISP_HOR_RESOLUTION)
+#define SCREEN_H        (DISP_VER_RESOLUTION)
+#define MEMORY_ROWS     (2 * SCREEN_H)          // two pages
+
+typedef struct {
+    DWORD commands;         // RS low
+    DWORD params;           // data words after other commands
+    DWORD pixels;           // data words after CMD_WR_MEMSTART
+    DWORD reads;            // read cycles
+} BUS_COUNT;
+
+// PMP and control lines
+BYTE HostRS, HostCS = 1, HostRST = 1;
+__PMMODEbits_t PMMODEbits;
+__PMCONbits_t PMCONbits;
+DWORD PMDIN, PMMODE, PMAEN, PMCON;
+WORD HostPmpLatch;
+
+// SSD1963 model
+static WORD Memory[MEMORY_ROWS][SCREEN_W];
+static WORD Reference[MEMORY_ROWS][SCREEN_W];
+static BYTE Command;
+static BYTE Params[4];
+static int ParamCount;
+static int ColStart, ColEnd, PageStart, PageEnd;
+static int MemX, MemY;
+static BOOL MemWrite, MemRead;
+
+static BUS_COUNT Bus;
+static DWORD NotSelected, Outside, ReadErrors;
+
+// Per screen
+static BUS_COUNT PixelBus;  // bus writes of the PutPixel() calls
+static DWORD PutPixels, Bars;
+
+// External memory model
+#define IMAGE_SIZE      (sizeof (BITMAP_HEADER) + 256 * sizeof (WORD) + 320 * 200 * sizeof (WORD))
+static BYTE ImageMemory[4][IMAGE_SIZE];
+static DWORD ExtReads, ExtBytes;
+
+/*********************************************************************
+ * SSD1963 bus model
+ ********************************************************************/
+void HostBusWrite(WORD data) {
+    if (HostCS)
+        NotSelected++;
+    if (!HostRS) {
+        Bus.commands++;
+        Command = (BYTE) data;
+        ParamCount = 0;
+        MemWrite = (Command == CMD_WR_MEMSTART);
+        MemRead = (Command == CMD_RD_MEMSTART);
+        if (MemWrite || MemRead) {
+            MemX = ColStart;
+            MemY = PageStart;
+        }
+        return;
+    }
+    if (MemWrite) {
+        Bus.pixels++;
+        if (MemX > ColEnd || MemY > PageEnd || MemX >= SCREEN_W || MemY >= MEMORY_ROWS) {
+            Outside++;
+            return;
+        }
+        Memory[MemY][MemX] = data;
+        if (++MemX > ColEnd) {
+            MemX = ColStart;
+            MemY++;
+        }
+        return;
+    }
+    Bus.params++;
+    if (ParamCount < 4)
+        Params[ParamCount] = (BYTE) data;
+    if (++ParamCount == 4) {
+        if (Command == CMD_SET_COLUMN) {
+            ColStart = (Params[0] << 8) | Params[1];
+            ColEnd = (Params[2] << 8) | Params[3];
+        } else if (Command == CMD_SET_PAGE) {
+            PageStart = (Params[0] << 8) | Params[1];
+            PageEnd = (Params[2] << 8) | Params[3];
+        }
+    }
+}
+
+WORD HostBusRead(void) {
+    WORD data;
+
+    Bus.reads++;
+    if (HostCS)
+        NotSelected++;
+    if (!MemRead)
+        return 0;
+    // The read started after the last pixel of a burst is dropped by the driver
+    if (MemX > ColEnd || MemY > PageEnd || MemX >= SCREEN_W || MemY >= MEMORY_ROWS)
+        return 0;
+    data = Memory[MemY][MemX];
+    if (++MemX > ColEnd) {
+        MemX = ColStart;
+        MemY++;
+    }
+    return data;
+}
+
+/*********************************************************************
+ * External memory model, the images are stored as on PIC32
+ ********************************************************************/
+WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer) {
+    ExtReads++;
+    ExtBytes += nCount;
+    if (offset < 0 || offset + nCount > (LONG) IMAGE_SIZE) {
+        Outside++;
+        return 0;
+    }
+    memcpy(buffer, ImageMemory[memory->ID] + offset, nCount);
+    return nCount;
+}
+
+static void MakeImage(WORD id, BYTE colorDepth, SHORT width, SHORT height) {
+    BITMAP_HEADER bmp = {0, colorDepth, height, width};
+    BYTE *pData = ImageMemory[id];
+    DWORD i, size;
+
+    memcpy(pData, &bmp, sizeof (bmp));
+    pData += sizeof (bmp);
+    if (colorDepth != 16) {
+        for (i = 0; i < (1UL << colorDepth); i++) {
+            WORD color = (WORD) rand();
+            memcpy(pData, &color, sizeof (color));
+            pData += sizeof (color);
+        }
+    }
+    size = (((DWORD) width * colorDepth + 7) >> 3) * height;
+    for (i = 0; i < size; i++)
+        *pData++ = (BYTE) rand();
+}
+
+static WORD ImagePixel(WORD id, SHORT x, SHORT y) {
+    BITMAP_HEADER bmp;
+    BYTE *pData = ImageMemory[id];
+    BYTE *pLine;
+    WORD color, index;
+
+    memcpy(&bmp, pData, sizeof (bmp));
+    pData += sizeof (bmp);
+    pLine = pData + (bmp.colorDepth == 16 ? 0 : (2 << bmp.colorDepth)) +
+            (((DWORD) bmp.width * bmp.colorDepth + 7) >> 3) * y;
+    switch (bmp.colorDepth) {
+        case 1: index = (pLine[x >> 3] >> (7 - (x & 7))) & 1; break;
+        case 4: index = (x & 1) ? pLine[x >> 1] >> 4 : pLine[x >> 1] & 0x0F; break;
+        case 8: index = pLine[x]; break;
+        default:
+            memcpy(&color, pLine + 2 * x, sizeof (color));
+            return color;
+    }
+    memcpy(&color, pData + 2 * index, sizeof (color));
+    return color;
+}
+
+/*********************************************************************
+ * Primitives, as the Primitive Layer decomposes them
+ ********************************************************************/
+static void Plot(SHORT x, SHORT y) {
+    BUS_COUNT before = Bus;
+
+    PutPixel(x, y);
+    PutPixels++;
+    PixelBus.commands += Bus.commands - before.commands;
+    PixelBus.params += Bus.params - before.params;
+    PixelBus.pixels += Bus.pixels - before.pixels;
+
+    if (x < 0 || x > GetMaxX() || y < 0 || y > GetMaxY())
+        return;
+    if (_clipRgn && (x < _clipLeft || x > _clipRight || y < _clipTop || y > _clipBottom))
+        return;
+    Reference[_activePage * SCREEN_H + y][x] = _color;
+}
+
+static void Fill(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+    SHORT x, y;
+
+    Bar(left, top, right, bottom);
+    Bars++;
+    if (_clipRgn) {
+        if (left < _clipLeft) left = _clipLeft;
+        if (right > _clipRight) right = _clipRight;
+        if (top < _clipTop) top = _clipTop;
+        if (bottom > _clipBottom) bottom = _clipBottom;
+    }
+    for (y = top; y <= bottom; y++)
+        for (x = left; x <= right; x++)
+            Reference[_activePage * SCREEN_H + y][x] = _color;
+}
+
+static void Image(SHORT left, SHORT top, WORD id, BYTE stretch) {
+    static void (*const putImage[])(SHORT, SHORT, void*, BYTE) = {
+        PutImage1BPPExt, PutImage4BPPExt, PutImage8BPPExt, PutImage16BPPExt
+    };
+    IMAGE_EXTERNAL image = {0, id, 0};
+    BITMAP_HEADER bmp;
+    LONG x, y;
+
+    memcpy(&bmp, ImageMemory[id], sizeof (bmp));
+    putImage[id](left, top, &image, stretch);
+    for (y = top; y < top + (LONG) bmp.height * stretch; y++)
+        for (x = left; x < left + (LONG) bmp.width * stretch; x++) {
+            if (x < 0 || x > GetMaxX() || y < 0 || y > GetMaxY())
+                continue;
+            if (_clipRgn && (x < _clipLeft || x > _clipRight || y < _clipTop || y > _clipBottom))
+                continue;
+            Reference[_activePage * SCREEN_H + y][x] = ImagePixel(id, (SHORT) ((x - left) / stretch), (SHORT) ((y - top) / stretch));
+            PutPixels++;
+        }
+}
+
+static void DrawLine(SHORT x1, SHORT y1, SHORT x2, SHORT y2) {
+    SHORT dx, dy, sx, sy, err, e2;
+
+    if (x1 == x2 || y1 == y2) {
+        Fill(x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2, x1 < x2 ? x2 : x1, y1 < y2 ? y2 : y1);
+        return;
+    }
+    dx = abs(x2 - x1);
+    dy = -abs(y2 - y1);
+    sx = x1 < x2 ? 1 : -1;
+    sy = y1 < y2 ? 1 : -1;
+    err = dx + dy;
+    for (;;) {
+        Plot(x1, y1);
+        if (x1 == x2 && y1 == y2)
+            break;
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+static void DrawCircle(SHORT cx, SHORT cy, SHORT r) {
+    SHORT x = 0, y = r, d = 1 - r;
+
+    while (x <= y) {
+        Plot(cx + x, cy - y);
+        Plot(cx - x, cy - y);
+        Plot(cx + y, cy - x);
+        Plot(cx - y, cy - x);
+        Plot(cx + y, cy + x);
+        Plot(cx - y, cy + x);
+        Plot(cx + x, cy + y);
+        Plot(cx - x, cy + y);
+        if (d < 0) {
+            d += 2 * x + 3;
+        } else {
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
+
+static void DrawText(SHORT left, SHORT top, int chars) {
+    static BYTE font[96][12];
+    static BOOL fontReady = FALSE;
+    int c, row, col;
+
+    if (!fontReady) {
+        for (c = 0; c < 96; c++)
+            for (row = 1; row < 11; row++)
+                font[c][row] = (BYTE) (rand() & 0x7E);
+        fontReady = TRUE;
+    }
+    for (c = 0; c < chars; c++) {
+        BYTE *glyph = font[rand() % 96];
+        for (row = 0; row < 12; row++)
+            for (col = 0; col < 8; col++)
+                if (glyph[row] & (0x80 >> col))
+                    Plot(left + c * 8 + col, top + row);
+    }
+}
+
+/*********************************************************************
+ * Screens
+ ********************************************************************/
+static void ScreenChart(void) {
+    int i, k;
+    SHORT x, y, ny;
+
+    SetColor(0x4208);
+    for (i = 0; i <= 10; i++) {
+        DrawLine(20, 20 + i * 44, 779, 20 + i * 44);
+        DrawLine(20 + i * 76, 20, 20 + i * 76, 460);
+    }
+    for (k = 0; k < 4; k++) {
+        SetColor((WORD) (0xF800 >> (k * 4)) | 0x001F);
+        y = 60 + rand() % 360;
+        for (x = 20; x < 775; x += 5) {
+            ny = y + rand() % 61 - 30;
+            if (ny < 21) ny = 21;
+            if (ny > 459) ny = 459;
+            DrawLine(x, y, x + 5, ny);
+            y = ny;
+        }
+    }
+}
+
+static void ScreenGauges(void) {
+    int g, t;
+    SHORT cx, cy;
+
+    for (g = 0; g < 6; g++) {
+        cx = 140 + (g % 3) * 260;
+        cy = 120 + (g / 3) * 240;
+        SetColor(0xFFFF);
+        DrawCircle(cx, cy, 110);
+        DrawCircle(cx, cy, 100);
+        SetColor(0xFFE0);
+        for (t = 0; t < 32; t++) {
+            // ticks from 100 to 90 pixels on 32 directions
+            static const signed char dir[8][2] = {{100,0},{92,38},{71,71},{38,92},{0,100},{-38,92},{-71,71},{-92,38}};
+            int sx = (t < 8 || t >= 24) ? 1 : -1;
+            int a = t % 8;
+            SHORT dx = (SHORT) (dir[a][0] * sx), dy = (SHORT) (t < 16 ? dir[a][1] : -dir[a][1]);
+            DrawLine(cx + dx * 9 / 10, cy + dy * 9 / 10, cx + dx, cy + dy);
+        }
+        SetColor(0xF800);
+        DrawLine(cx, cy, cx + rand() % 181 - 90, cy - 20 - rand() % 70);
+    }
+}
+
+static void ScreenText(void) {
+    int row;
+
+    SetColor(0x07E0);
+    for (row = 0; row < 36; row++)
+        DrawText(8, 6 + row * 13, 98);
+}
+
+static void ScreenSteep(void) {
+    int i;
+    SHORT x, y, h;
+
+    for (i = 0; i < 300; i++) {
+        SetColor((WORD) rand());
+        x = 40 + rand() % 720;
+        y = 5 + rand() % 200;
+        h = 60 + rand() % 200;
+        DrawLine(x, y, x + rand() % (h / 4 + 1) - h / 8, y + h);
+    }
+}
+
+static void ScreenClipped(void) {
+    int i;
+
+    SetClipRgn(100, 80, 699, 399);
+    SetClip(CLIP_ENABLE);
+    for (i = 0; i < 200; i++) {
+        SetColor((WORD) rand());
+        DrawLine(rand() % 800, rand() % 480, rand() % 800, rand() % 480);
+    }
+    SetColor(0xFFFF);
+    DrawCircle(400, 240, 230);
+    SetClip(CLIP_DISABLE);
+}
+
+static DWORD BusCycles(const BUS_COUNT *pFrom) {
+    return (Bus.commands - pFrom->commands) + (Bus.params - pFrom->params) +
+            (Bus.pixels - pFrom->pixels) + (Bus.reads - pFrom->reads);
+}
+
+static void ScreenSaveUnder(void) {
+    static GFX_COLOR saved[64][64];
+    DWORD rowCycles = 0, pixelCycles = 0, pixels = 0;
+    BUS_COUNT before;
+    WORD page = _activePage * SCREEN_H;
+    int n, x, y;
+    SHORT cx, cy, left, top;
+
+    ScreenChart();
+    for (n = 0; n < 40; n++) {
+        cx = 40 + rand() % 720;
+        cy = 40 + rand() % 400;
+        left = cx - 32;
+        top = cy - 32;
+
+        before = Bus;
+        for (y = 0; y < 64; y++)
+            if (GetRow(left, top + y, left + 63, saved[y]) != 64)
+                ReadErrors++;
+        rowCycles += BusCycles(&before);
+        before = Bus;
+        for (y = 0; y < 64; y += 8)
+            for (x = 0; x < 64; x++)
+                if (GetPixel(left + x, top + y) != saved[y][x])
+                    ReadErrors++;
+        pixelCycles += BusCycles(&before) * 8;
+        pixels += 64 * 64;
+
+        for (y = 0; y < 64; y++)
+            for (x = 0; x < 64; x++)
+                if (saved[y][x] != Reference[page + top + y][left + x])
+                    ReadErrors++;
+
+        SetColor(0xF800);
+        DrawLine(cx, cy, cx + rand() % 61 - 30, cy - 31);
+        for (y = 0; y < 64; y++)
+            for (x = 0; x < 64; x++) {
+                SetColor(saved[y][x]);
+                Plot(left + x, top + y);
+            }
+    }
+    printf("  %lu pixels saved: %.2f bus cycles per pixel with GetRow(), %.2f with GetPixel()\n",
+            (unsigned long) pixels, (double) rowCycles / pixels, (double) pixelCycles / pixels);
+}
+
+static void ScreenImages(BOOL across) {
+    static const BYTE depth[4] = {1, 4, 8, 16};
+    BUS_COUNT before = Bus;
+    DWORD reads = ExtReads, bytes = ExtBytes;
+    int n;
+    WORD id;
+    BYTE stretch;
+    SHORT width, height;
+
+    if (across) {
+        SetClipRgn(60, 40, 739, 439);
+        SetClip(CLIP_ENABLE);
+    }
+    for (n = 0; n < 24; n++) {
+        id = n % 4;
+        stretch = 1 + (n / 4) % 3;
+        width = (SHORT) (8 + rand() % (320 / stretch - 8));
+        height = (SHORT) (8 + rand() % (200 / stretch - 8));
+        MakeImage(id, depth[id], width, height);
+        if (across) {
+            Image((SHORT) (rand() % 1000 - 200), (SHORT) (rand() % 680 - 200), id, stretch);
+        } else {
+            Image((SHORT) (rand() % (SCREEN_W - width * stretch + 1)),
+                    (SHORT) (rand() % (SCREEN_H - height * stretch + 1)), id, stretch);
+        }
+    }
+    SetClip(CLIP_DISABLE);
+    printf("  %lu image pixels: %.2f bus writes per pixel, %lu external memory reads of %lu bytes\n",
+            (unsigned long) PutPixels, (double) BusCycles(&before) / PutPixels,
+            (unsigned long) (ExtReads - reads), (unsigned long) (ExtBytes - bytes));
+    PutPixels = 0;
+}
+
+static void ScreenImagesOnScreen(void) {
+    ScreenImages(FALSE);
+}
+
+static void ScreenImagesAcross(void) {
+    ScreenImages(TRUE);
+}
+
+typedef struct {
+    const char *name;
+    void (*draw)(void);
+} SCREEN;
+
+static const SCREEN Screens[] = {
+    {"chart", ScreenChart},
+    {"gauges", ScreenGauges},
+    {"text", ScreenText},
+    {"steep lines", ScreenSteep},
+    {"clipped lines", ScreenClipped},
+    {"save-under", ScreenSaveUnder},
+    {"images", ScreenImagesOnScreen},
+    {"clipped images", ScreenImagesAcross},
+};
+
+int main(int argc, char **argv) {
+    int i, page = 0, errors = 0;
+    unsigned seed = 1;
+    int x, y;
+    BUS_COUNT total = {0, 0, 0, 0};
+    DWORD totalPixels = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            seed = (unsigned) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            page = atoi(argv[++i]) & 1;
+        } else {
+            fprintf(stderr, "Usage: HostBus [-s seed] [-p page]\n");
+            return 1;
+        }
+    }
+    srand(seed);
+
+    ResetDevice();
+    SetActivePage((WORD) page);
+
+    printf("%-14s %9s %9s %9s %9s %9s %8s\n", "screen", "PutPixel", "commands", "params", "pixels", "writes", "per pixel");
+    for (i = 0; i < (int) (sizeof (Screens) / sizeof (Screens[0])); i++) {
+        SetColor(0);
+        Fill(0, 0, GetMaxX(), GetMaxY());
+        memset(&PixelBus, 0, sizeof (PixelBus));
+        PutPixels = Bars = 0;
+
+        Screens[i].draw();
+
+        printf("%-14s %9lu %9lu %9lu %9lu %9lu %8.2f\n", Screens[i].name, (unsigned long) PutPixels,
+                (unsigned long) PixelBus.commands, (unsigned long) PixelBus.params, (unsigned long) PixelBus.pixels,
+                (unsigned long) (PixelBus.commands + PixelBus.params + PixelBus.pixels),
+                PutPixels ? (double) (PixelBus.commands + PixelBus.params + PixelBus.pixels) / PutPixels : 0.0);
+        total.commands += PixelBus.commands;
+        total.params += PixelBus.params;
+        total.pixels += PixelBus.pixels;
+        totalPixels += PutPixels;
+
+        for (y = 0; y < MEMORY_ROWS; y++)
+            for (x = 0; x < SCREEN_W; x++)
+                if (Memory[y][x] != Reference[y][x]) {
+                    if (errors++ < 5)
+                        printf("  pixel %d,%d of the frame memory is %04X instead of %04X\n", x, y, Memory[y][x], Reference[y][x]);
+                }
+    }
+    printf("%-14s %9lu %9lu %9lu %9lu %9lu %8.2f\n", "all", (unsigned long) totalPixels,
+            (unsigned long) total.commands, (unsigned long) total.params, (unsigned long) total.pixels,
+            (unsigned long) (total.commands + total.params + total.pixels),
+            (double) (total.commands + total.params + total.pixels) / totalPixels);
+
+    if (NotSelected || Outside)
+        printf("%lu bus writes with the SSD1963 not selected, %lu pixels outside the window\n",
+                (unsigned long) NotSelected, (unsigned long) Outside);
+    if (ReadErrors)
+        printf("%lu pixels read back differ from the reference\n", (unsigned long) ReadErrors);
+    if (errors)
+        printf("%d pixels differ from the reference\n", errors);
+    return (errors || NotSelected || Outside || ReadErrors) ? 2 : 0;
+}
@@ -0,0 +1,39 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for Microchip's GenericTypeDefs.h
+// *****************************************************************************
+// FileName:        GenericTypeDefs.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Only the types used by drvSSD1963.c are defined here, with the same widths
+// they have on PIC32.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	LONG
+//  2026/10/17	Hi() and Lo() left to drvSSD1963.h
+// *****************************************************************************
+#ifndef _GENERICTYPEDEFS_H_
+#define _GENERICTYPEDEFS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum _BOOL { FALSE = 0, TRUE } BOOL;
+
+typedef unsigned char   BYTE;
+typedef unsigned short  WORD;
+typedef uint32_t        DWORD;
+typedef short           SHORT;
+typedef int32_t         LONG;
+
+typedef union
+{
+    WORD Val;
+    BYTE v[2];
+} WORD_VAL;
+
+#endif
@@ -0,0 +1,55 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the Graphics Library DisplayDriver.h
+// *****************************************************************************
+// FileName:        DisplayDriver.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The Display Driver Layer API of the Graphics Library v3.x used by
+// drvSSD1963.c and HostBus.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _DISPLAYDRIVER_H
+#define _DISPLAYDRIVER_H
+
+#include "HardwareProfile.h"
+
+#define COLOR_DEPTH     16
+
+typedef WORD GFX_COLOR;
+typedef const BYTE FLASH_BYTE;
+
+#define GetMaxX()       (DISP_HOR_RESOLUTION - 1)
+#define GetMaxY()       (DISP_VER_RESOLUTION - 1)
+#define SetColor(c)     _color = (c)
+#define GetColor()      _color
+
+#define CLIP_DISABLE    0
+#define CLIP_ENABLE     1
+
+extern GFX_COLOR _color;
+extern SHORT _clipRgn;
+extern SHORT _clipLeft;
+extern SHORT _clipTop;
+extern SHORT _clipRight;
+extern SHORT _clipBottom;
+extern BYTE _activePage;
+extern BYTE _visualPage;
+
+WORD IsDeviceBusy(void);
+void ResetDevice(void);
+void PutPixel(SHORT x, SHORT y);
+WORD GetPixel(SHORT x, SHORT y);
+WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom);
+void ClearDevice(void);
+void SetActivePage(WORD page);
+void SetVisualPage(WORD page);
+void SetClipRgn(SHORT left, SHORT top, SHORT right, SHORT bottom);
+void SetClip(BYTE control);
+
+#endif
@@ -0,0 +1,24 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the Graphics Library headers
+// *****************************************************************************
+// FileName:        Graphics.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Graphics.h and DisplayDriver.h both lead to the Display Driver Layer API
+// implemented by drvSSD1963.c; Graphics.h adds the images of Primitive.h.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Primitive.h
+// *****************************************************************************
+#ifndef _GRAPHICS_H
+#define _GRAPHICS_H
+
+#include "Graphics/DisplayDriver.h"
+#include "Graphics/Primitive.h"
+
+#endif
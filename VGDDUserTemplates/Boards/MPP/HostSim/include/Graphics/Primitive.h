@@ -0,0 +1,46 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the Graphics Library Primitive.h
+// *****************************************************************************
+// FileName:        Primitive.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The external memory images of the Graphics Library v3.x drawn by the
+// PutImage*Ext() functions of drvSSD1963.c. ExternalMemoryCallback() is
+// implemented by HostBus.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _PRIMITIVE_H
+#define _PRIMITIVE_H
+
+#include "GenericTypeDefs.h"
+
+#define IMAGE_NORMAL    1
+#define IMAGE_X2        2
+
+typedef struct {
+    BYTE compression;   // Compression setting
+    BYTE colorDepth;    // Color depth used
+    SHORT height;       // Image height
+    SHORT width;        // Image width
+} BITMAP_HEADER;
+
+typedef struct {
+    SHORT type;         // Resource type
+    WORD ID;            // Memory ID
+    DWORD address;      // Data offset
+} IMAGE_EXTERNAL;
+
+WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer);
+
+void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
+void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
+void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
+void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
+
+#endif
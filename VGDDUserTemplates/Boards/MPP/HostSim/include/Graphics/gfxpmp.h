@@ -0,0 +1,56 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the Graphics Library gfxpmp.h
+// *****************************************************************************
+// FileName:        gfxpmp.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The chip select, RS and reset lines are variables; DeviceWrite() and
+// DeviceRead() go to the SSD1963 model in HostBus.c.
+// Reads are pipelined as on the PIC32 PMP: SingleDeviceRead() returns the word
+// of the previous read and starts the next one, DeviceRead() returns the word
+// of the read it starts.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Pipelined reads
+// *****************************************************************************
+#ifndef _GFXPMP_H
+#define _GFXPMP_H
+
+#include "HardwareProfile.h"
+
+void HostBusWrite(WORD data);
+WORD HostBusRead(void);
+extern WORD HostPmpLatch;
+
+static inline WORD HostPmpRead(void) {
+    WORD value = HostPmpLatch;
+
+    HostPmpLatch = HostBusRead();
+    return value;
+}
+
+#define DisplayEnable()         HostCS = 0
+#define DisplayDisable()        HostCS = 1
+#define DisplaySetCommand()     HostRS = 0
+#define DisplaySetData()        HostRS = 1
+#define DisplayResetEnable()    HostRST = 0
+#define DisplayResetDisable()   HostRST = 1
+#define DisplayResetConfig()
+#define DisplayCmdDataConfig()
+#define DisplayConfig()
+#define DisplayBacklightOn()
+#define DisplayBacklightOff()
+#define DisplayBacklightConfig()
+
+#define DeviceWrite(data)       HostBusWrite(data)
+#define DeviceRead()            (HostPmpRead(), HostPmpLatch)
+#define SingleDeviceRead()      HostPmpRead()
+
+void DriverInterfaceInit(void);
+
+#endif
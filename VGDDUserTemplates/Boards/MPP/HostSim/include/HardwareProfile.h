@@ -0,0 +1,52 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the board HardwareProfile.h
+// *****************************************************************************
+// FileName:        HardwareProfile.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The MPP board: TY700TFT800480 panel on a SSD1963 with a 16 bit PMP, as set
+// by Disp_MPP.xml. The PMP control lines are plain variables; DeviceWrite()
+// in Graphics/gfxpmp.h hands the bus writes to HostBus.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	USE_BITMAP_EXTERNAL
+// *****************************************************************************
+#ifndef HARDWARE_PROFILE_H
+#define HARDWARE_PROFILE_H
+
+#include "GenericTypeDefs.h"
+
+#define __PIC32MX
+
+#define DISPLAY_CONTROLLER          SSD1963
+#define TY700TFT800480              1
+#define DISPLAY_PANEL               TY700TFT800480
+#define USE_DRV_BAR
+#define USE_DRV_CLEARDEVICE
+#define USE_16BIT_PMP
+#define USE_GFX_PMP
+#define USE_BITMAP_EXTERNAL
+
+#define DISP_ORIENTATION            0
+#define DISP_HOR_RESOLUTION         800
+#define DISP_VER_RESOLUTION         480
+#define DISP_HOR_PULSE_WIDTH        1
+#define DISP_HOR_BACK_PORCH         210
+#define DISP_HOR_FRONT_PORCH        45
+#define DISP_VER_PULSE_WIDTH        1
+#define DISP_VER_BACK_PORCH         34
+#define DISP_VER_FRONT_PORCH        10
+
+#define LCD_RESET                   0
+#define LCD_SPENA                   0
+#define LCD_SPCLK                   0
+#define LCD_SPDAT                   0
+
+extern BYTE HostRS, HostCS, HostRST;
+
+#endif
@@ -0,0 +1,34 @@
+// *****************************************************************************
+// MPP host simulation
+// Stand-in for the PIC32 peripheral library
+// *****************************************************************************
+// FileName:        plib.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The PMP registers written by ResetDevice(); the PMP never reports busy.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _PLIB_H
+#define _PLIB_H
+
+#include "GenericTypeDefs.h"
+
+typedef struct {
+    unsigned BUSY : 1, IRQM : 2, MODE16 : 1, INCM : 2, WAITB : 2, WAITM : 4, WAITE : 2, MODE : 2;
+} __PMMODEbits_t;
+typedef struct {
+    unsigned PMPEN : 1, PTWREN : 1, PTRDEN : 1, WRSP : 1, RDSP : 1;
+} __PMCONbits_t;
+
+extern __PMMODEbits_t PMMODEbits;
+extern __PMCONbits_t PMCONbits;
+extern DWORD PMDIN, PMMODE, PMAEN, PMCON;
+
+#define Nop()
+
+#endif
@@ -91,6 +91,78 @@
  ******************************************************************************
  */
 
+/*
+ ******************************************************************************
+ * Revision:
+ * (1) Bar() and ClearDevice() write the pixels with an unrolled loop
+ *	  through FillWindow(), RS set once for the whole window
+ * (2) With SSD1963_DMA_CHANNEL (16 bit PMP on PIC32) a DMA channel
+ *	  started by the PMP interrupt writes the fill; IsDeviceBusy()
+ *	  reports it and WriteCommand() waits for its end
+ * (3) The default DMA block is 127 pixels on PIC32MX3xx/4xx, whose DMA
+ *	  blocks are 255 bytes at most; a larger SSD1963_FILL_BLOCK is an
+ *	  error there
+ *
+ * VirtualFab @ www.Virtualfab.it			17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * (1) RequestDisplayUpdate() flips the pages in the vertical blank, from
+ *	  the TE interrupt (SSD1963_TE_INT) or after polling the scan line
+ * (2) SSD1963_FLIP_FRAMES caps the flip rate, GetFrameStats() reports
+ *	  the panel refreshes between the flips
+ * (3) A flip the TE interrupt does not do within SSD1963_FLIP_TIMEOUT ms
+ *	  is done by the waiting code
+ *
+ * VirtualFab @ www.Virtualfab.it			17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * (1) SetArea() writes only the column or the page addresses that change
+ * (2) PutPixel() keeps its memory write open: a pixel at the next
+ *	  position of the window is written without any command, and a
+ *	  pixel right below the previous one opens a one column window so
+ *	  that vertical runs are written the same way
+ *
+ * VirtualFab @ www.Virtualfab.it			17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * (1) GetPixel() implemented, reading the SSD1963 memory back with
+ *	  CMD_RD_MEMSTART (USE_GFX_PMP and USE_16BIT_PMP only, the 74HC573
+ *	  latch of the 8 bit interface cannot be read)
+ * (2) New GetRow() reads a whole row in one burst, for the functions
+ *	  that save and restore the screen under a needle or a popup
+ * (3) GFX_DRV_GETPIXEL defined in drvSSD1963.h when the memory can be
+ *	  read back
+ *
+ * VirtualFab @ www.Virtualfab.it			17th Oct 2026
+ ******************************************************************************
+ */
+
+/*
+ ******************************************************************************
+ * Revision:
+ * (1) PutImage1BPPExt() to PutImage16BPPExt() share PutImageExt(): the
+ *	  image is clipped to the screen and the clipping region once and
+ *	  its window set once, each line is converted to colors in a line
+ *	  buffer and written with an unrolled loop
+ * (2) An image running off the right edge of the screen is clipped
+ *	  instead of wrapping onto the next rows
+ *
+ * VirtualFab @ www.Virtualfab.it			17th Oct 2026
+ ******************************************************************************
+ */
+
 #include "HardwareProfile.h"
 #include "Graphics/Graphics.h"
 #include "Graphics/gfxpmp.h"
@@ -104,6 +176,57 @@ RectangleArea InvalidatedArea[GFX_MAX_INVALIDATE_AREAS];
 volatile DWORD _drawbuffer;
 volatile BYTE blDisplayUpdatePending;
 static void ExchangeDrawAndFrameBuffers(void);
+
+#if !defined (SSD1963_FLIP_FRAMES)
+    #define SSD1963_FLIP_FRAMES 1           // Panel refreshes between two flips, at least
+#endif
+#if !defined (SSD1963_FLIP_TIMEOUT)
+    #define SSD1963_FLIP_TIMEOUT 100        // ms a queued flip waits for the TE interrupt
+#endif
+
+#if defined (SSD1963_TE_INT)
+    #if !defined (__PIC32MX)
+        #error SSD1963_TE_INT needs a PIC32
+    #endif
+    #if (SSD1963_TE_INT == 0)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_0_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_0_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT0
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT0EP_MASK
+    #elif (SSD1963_TE_INT == 1)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_1_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_1_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT1
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT1EP_MASK
+    #elif (SSD1963_TE_INT == 2)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_2_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_2_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT2
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT2EP_MASK
+    #elif (SSD1963_TE_INT == 3)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_3_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_3_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT3
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT3EP_MASK
+    #elif (SSD1963_TE_INT == 4)
+        #define SSD1963_TE_VECTOR       _EXTERNAL_4_VECTOR
+        #define SSD1963_TE_INT_VECTOR   INT_EXTERNAL_4_VECTOR
+        #define SSD1963_TE_SOURCE       INT_INT4
+        #define SSD1963_TE_EDGE_MASK    _INTCON_INT4EP_MASK
+    #else
+        #error SSD1963_TE_INT must be 0 to 4
+    #endif
+static volatile WORD _framesSinceFlip = 0;  // TE pulses since the last flip
+#elif defined (USE_GFX_PMP) && defined (USE_16BIT_PMP)
+    // No TE interrupt: the scan line is read back through the PMP
+    #define SSD1963_TE_POLL
+    // Scan line 0 is the first line of the vertical sync pulse; the lines
+    // outside the active area are the vertical blank
+    #define VBLANK_END      (DISP_VER_PULSE_WIDTH + DISP_VER_BACK_PORCH)
+    #define InVBlank(line)  ((line) < VBLANK_END || (line) >= VBLANK_END + DISP_VER_RESOLUTION)
+#endif
+
+static volatile SSD1963_FRAME_STATS _frameStats;
 #endif //USE_DOUBLE_BUFFERING
 
 // Color
@@ -133,6 +256,62 @@ BYTE _visualPage;
 // ssd1963 specific
 BYTE _gpioStatus = 0;
 
+// Window of the last SetArea(), page offset included
+static BOOL _areaValid = FALSE;
+static SHORT _areaLeft, _areaTop, _areaRight, _areaBottom;
+// Next pixel of the memory write opened by PutPixel(); any command closes it
+static volatile BOOL _cursorValid = FALSE;
+static SHORT _cursorX, _cursorY;
+// Previous PutPixel() pixel, page offset included
+static SHORT _lastX = -1, _lastY = -1;
+
+#if defined (SSD1963_DMA_CHANNEL)
+    #if !defined (__PIC32MX) || !defined (USE_GFX_PMP) || !defined (USE_16BIT_PMP)
+        #error SSD1963_DMA_CHANNEL needs a PIC32 with a 16 bit PMP driving the WR line (USE_GFX_PMP)
+    #endif
+    // The DMA blocks are 255 bytes at most on PIC32MX3xx/4xx
+    #if (defined (__PIC32_FEATURE_SET__) && (__PIC32_FEATURE_SET__ >= 300) && (__PIC32_FEATURE_SET__ < 500)) || \
+        defined (__32MX360F512L__) || defined (__32MX460F512L__)
+        #define SSD1963_DMA_MAX_BYTES   255
+    #else
+        #define SSD1963_DMA_MAX_BYTES   65535
+    #endif
+    #if !defined (SSD1963_FILL_BLOCK)
+        #if (SSD1963_DMA_MAX_BYTES < 512)
+            #define SSD1963_FILL_BLOCK  (SSD1963_DMA_MAX_BYTES / 2) // Pixels written by each DMA block
+        #else
+            #define SSD1963_FILL_BLOCK  256
+        #endif
+    #endif
+    #if (SSD1963_FILL_BLOCK * 2 > SSD1963_DMA_MAX_BYTES)
+        #error SSD1963_FILL_BLOCK does not fit a DMA block of this PIC32
+    #endif
+    #if (SSD1963_DMA_CHANNEL == 0)
+        #define SSD1963_DMA_VECTOR  _DMA0_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 1)
+        #define SSD1963_DMA_VECTOR  _DMA1_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 2)
+        #define SSD1963_DMA_VECTOR  _DMA2_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 3)
+        #define SSD1963_DMA_VECTOR  _DMA3_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 4)
+        #define SSD1963_DMA_VECTOR  _DMA4_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 5)
+        #define SSD1963_DMA_VECTOR  _DMA5_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 6)
+        #define SSD1963_DMA_VECTOR  _DMA6_VECTOR
+    #elif (SSD1963_DMA_CHANNEL == 7)
+        #define SSD1963_DMA_VECTOR  _DMA7_VECTOR
+    #else
+        #error SSD1963_DMA_CHANNEL must be 0 to 7
+    #endif
+
+static WORD _fillBuffer[SSD1963_FILL_BLOCK];
+static GFX_COLOR _fillColor;                // Color in _fillBuffer
+static BOOL _fillValid = FALSE;
+static volatile DWORD _fillBlocks = 0;      // DMA blocks left to write, 0 when idle
+#endif
+
 void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
 void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
 void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch);
@@ -148,6 +327,9 @@ void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch);
 /**************** LOCAL FUNCTION PROTOTYPE (SSD1963 SPECIFIC) ****************/
 static void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y);
 static void GPIO_WR(BYTE pin, BOOL state);
+#if defined (SSD1963_TE_POLL)
+static WORD GetScanLine(void);
+#endif
 void SPI_Write(BYTE byte);
 void SPI_SetReg(BYTE reg, WORD cmd);
 
@@ -163,11 +345,16 @@ void SPI_SetReg(BYTE reg, WORD cmd);
  *
  * Output: Busy status.
  *
- * Remarks: Not implemented yet
+ * Remarks: Non-zero while the DMA channel writes a Bar() or ClearDevice()
+ *          fill (SSD1963_DMA_CHANNEL), else always 0
  *
  ********************************************************************/
 WORD IsDeviceBusy() {
+#if defined (SSD1963_DMA_CHANNEL)
+    return (_fillBlocks != 0);
+#else
     return 0;
+#endif
 }
 
 #ifdef USE_TRANSPARENT_COLOR
@@ -286,9 +473,11 @@ void SwitchOffDoubleBuffering(void) {
 }
 
 /*********************************************************************
- * Function:  void UpdateDisplayNow(void)
+ * Function:  static void FlipPages(void)
  *
- * Overview: Synchronizes the draw and frame buffers immediately
+ * Overview: Shows the draw buffer by moving the scroll start to it and
+ *			swaps the role of DrawBuffer with FrameBuffer with
+ *			ExchangeDrawAndFrameBuffers()
  *
  * PreCondition: none
  *
@@ -296,13 +485,11 @@ void SwitchOffDoubleBuffering(void) {
  *
  * Output: none
  *
- * Side Effects: none
+ * Side Effects: clears blDisplayUpdatePending
  *
- * Remarks:	For SSD1963, this is equivalent to updating the pointer
- *			to the DrawBuffer and swap the role of DrawBuffer with
- *			FrameBuffer with ExchangeDrawAndFrameBuffers()
  ********************************************************************/
-void UpdateDisplayNow(void) {
+static void FlipPages(void) {
+    blDisplayUpdatePending = 0;
     SetScrollArea(0, GetMaxY() + 1, 0);
     if (_drawbuffer == GFX_BUFFER1) {
         SetScrollStart(0);
@@ -310,6 +497,147 @@ void UpdateDisplayNow(void) {
         SetScrollStart(GetMaxY() + 1);
     }
     ExchangeDrawAndFrameBuffers();
+
+    _frameStats.Flips++;
+#if defined (SSD1963_TE_INT)
+    _frameStats.LastFrame = _framesSinceFlip;
+    if (_framesSinceFlip > _frameStats.MaxFrame)
+        _frameStats.MaxFrame = _framesSinceFlip;
+    _framesSinceFlip = 0;
+#endif
+}
+
+#if defined (SSD1963_TE_INT)
+
+/*********************************************************************
+ * Function:  SSD1963TeHandler()
+ *
+ * Overview: TE rising edge, start of the vertical blank. Applies the
+ *			flip queued by RequestDisplayUpdate() once SSD1963_FLIP_FRAMES
+ *			panel refreshes passed since the last one.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Remarks:	WriteCommand() holds the main code while a flip is pending,
+ *			so the bus is free here unless a DMA fill is running; the
+ *			flip then waits for the next blank.
+ ********************************************************************/
+void __ISR(SSD1963_TE_VECTOR, ipl4) SSD1963TeHandler(void) {
+    INTClearFlag(SSD1963_TE_SOURCE);
+    _frameStats.Refreshes++;
+    if (_framesSinceFlip != 0xFFFF)
+        _framesSinceFlip++;
+
+    if (blDisplayUpdatePending && _framesSinceFlip >= SSD1963_FLIP_FRAMES) {
+        if (IsDeviceBusy()) {
+            _frameStats.Deferred++;
+            return;
+        }
+        FlipPages();
+    }
+}
+
+/*********************************************************************
+ * Function:  static void WaitFlip(void)
+ *
+ * Overview: Waits for the TE interrupt to do the flip queued by
+ *			RequestDisplayUpdate(). If it is not done within
+ *			SSD1963_FLIP_TIMEOUT ms (interrupts disabled, TE not wired)
+ *			the pages are flipped here, out of the vertical blank, and
+ *			the flip is counted in Timeouts.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+static void WaitFlip(void) {
+    DWORD start = ReadCoreTimer();
+
+    while (blDisplayUpdatePending) {
+        // The core timer counts at half the system clock
+        if (ReadCoreTimer() - start >= SSD1963_FLIP_TIMEOUT * (GetSystemClock() / 2000)) {
+            INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+            if (blDisplayUpdatePending) {
+                _frameStats.Timeouts++;
+                FlipPages();
+            }
+            INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+        }
+    }
+}
+#endif // SSD1963_TE_INT
+
+#if defined (SSD1963_TE_POLL)
+
+/*********************************************************************
+ * Function:  static void WaitVBlank(void)
+ *
+ * Overview: Polls the scan line until the vertical blank. With
+ *			SSD1963_FLIP_FRAMES above 1 it waits for as many blanks.
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+static void WaitVBlank(void) {
+    WORD frames;
+
+    for (frames = SSD1963_FLIP_FRAMES; frames > 1; frames--) {
+        while (InVBlank(GetScanLine()));
+        while (!InVBlank(GetScanLine()));
+        _frameStats.Refreshes++;
+    }
+    while (!InVBlank(GetScanLine()));
+    _frameStats.Refreshes++;
+}
+#endif // SSD1963_TE_POLL
+
+/*********************************************************************
+ * Function:  void UpdateDisplayNow(void)
+ *
+ * Overview: Synchronizes the draw and frame buffers immediately
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Remarks:	For SSD1963, this is equivalent to updating the pointer
+ *			to the DrawBuffer and swap the role of DrawBuffer with
+ *			FrameBuffer with ExchangeDrawAndFrameBuffers().
+ *			The flip is still done in the vertical blank: the function
+ *			returns after it, or after SSD1963_FLIP_TIMEOUT ms without
+ *			the TE interrupt (see WaitFlip()).
+ ********************************************************************/
+void UpdateDisplayNow(void) {
+#if defined (SSD1963_TE_INT)
+    blDisplayUpdatePending = 1;
+    WaitFlip();
+#else
+#if defined (SSD1963_TE_POLL)
+    WaitVBlank();
+#endif
+    FlipPages();
+#endif
 }
 
 /*********************************************************************
@@ -324,10 +652,75 @@ void UpdateDisplayNow(void) {
  * Output: none
  *
  * Side Effects: none
- * Remarks: Not implemented yet, may use tearing effect to achieve this
+ * Remarks: With SSD1963_TE_INT the flip is queued and done by the TE
+ *			interrupt: IsDisplayUpdatePending() is set until then and
+ *			the next command waits for it. Otherwise the scan line is
+ *			polled and the flip done before returning (immediately
+ *			without USE_GFX_PMP and USE_16BIT_PMP, as the scan line
+ *			cannot be read).
  ********************************************************************/
 void RequestDisplayUpdate(void) {
-    //use tearing effect!
+    if (blEnableDoubleBuffering == 0) {
+        return;
+    }
+#if defined (SSD1963_TE_INT)
+    blDisplayUpdatePending = 1;
+#else
+    UpdateDisplayNow();
+#endif
+}
+
+/*********************************************************************
+ * Function:  void GetFrameStats(SSD1963_FRAME_STATS *pStats)
+ *
+ * Overview: Copies the page flip statistics
+ *
+ * PreCondition: none
+ *
+ * Input: pStats - destination
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void GetFrameStats(SSD1963_FRAME_STATS *pStats) {
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+#endif
+    *pStats = _frameStats;
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
+}
+
+/*********************************************************************
+ * Function:  void ResetFrameStats(void)
+ *
+ * Overview: Clears the page flip statistics
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ ********************************************************************/
+void ResetFrameStats(void) {
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_DISABLED);
+#endif
+    _frameStats.Flips = 0;
+    _frameStats.Refreshes = 0;
+    _frameStats.Deferred = 0;
+    _frameStats.Timeouts = 0;
+    _frameStats.LastFrame = 0;
+    _frameStats.MaxFrame = 0;
+#if defined (SSD1963_TE_INT)
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
 }
 
 #endif	//USE_DOUBLE_BUFFERING
@@ -357,6 +750,52 @@ void RequestDisplayUpdate(void) {
 #endif
 #endif
 
+/*********************************************************************
+ * Macros:  WaitFillDone()
+ *
+ * Overview: waits for the end of the DMA fill started by FillWindow(),
+ *			so that no command is written while it runs
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Note: nothing to wait for without SSD1963_DMA_CHANNEL
+ ********************************************************************/
+#if defined (SSD1963_DMA_CHANNEL)
+#define WaitFillDone()  while(_fillBlocks);
+#else
+#define WaitFillDone()
+#endif
+
+/*********************************************************************
+ * Macros:  WaitFlipDone()
+ *
+ * Overview: waits for the page flip queued by RequestDisplayUpdate(),
+ *			so that the TE interrupt has the bus and nothing is drawn
+ *			on the page about to be shown
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Note: nothing to wait for without SSD1963_TE_INT; bounded by
+ *		SSD1963_FLIP_TIMEOUT
+ ********************************************************************/
+#if defined (USE_DOUBLE_BUFFERING) && defined (SSD1963_TE_INT)
+#define WaitFlipDone()  WaitFlip();
+#else
+#define WaitFlipDone()
+#endif
+
 /*********************************************************************
  * Macros:  WriteCommand(cmd)
  *
@@ -374,6 +813,9 @@ void RequestDisplayUpdate(void) {
  ********************************************************************/
 //#define WriteCommand(cmd) {RS_LAT_BIT = 0; PMDIN1 = cmd; DisplayEnable(); WR_LAT_BIT = 0; WR_LAT_BIT = 1; DisplayDisable();};
 #define WriteCommand(cmd) { \
+            WaitFillDone(); \
+            WaitFlipDone(); \
+            _cursorValid = FALSE; \
             DisplaySetCommand(); \
             DisplayEnable(); \
             DeviceWrite(cmd); \
@@ -404,6 +846,138 @@ void RequestDisplayUpdate(void) {
 #define WriteData(data)	{RS_LAT_BIT = 1; PMDIN1 = Hi(data); LE_LAT_BIT = 0; PMPWaitBusy(); PMDIN1 = Lo(data); WR_LAT_BIT = 0; WR_LAT_BIT = 1; LE_LAT_BIT = 1;}
 #endif
 
+#if defined (SSD1963_DMA_CHANNEL)
+
+/*********************************************************************
+ * Function:  static void FillStartDma(DWORD blocks)
+ *
+ * PreCondition: FillWindow() conditions, RS set for data
+ *
+ * Input: blocks - number of SSD1963_FILL_BLOCK pixel blocks to write
+ *
+ * Output: none
+ *
+ * Side Effects: the SSD1963 stays selected until the DMA interrupt
+ *
+ * Overview: writes the blocks with the DMA channel. Each PMP write cycle
+ *			raises the PMP interrupt flag, which starts the next cell
+ *			transfer; the channel is auto-enabled between the blocks
+ *			and SSD1963FillHandler() counts them.
+ *
+ * Note: SSD1963_FILL_BLOCK is checked against SSD1963_DMA_MAX_BYTES
+ ********************************************************************/
+static void FillStartDma(DWORD blocks) {
+    WORD i;
+
+    // The block is filled again only when the color changes
+    if (!_fillValid || _fillColor != _color) {
+        for (i = 0; i < SSD1963_FILL_BLOCK; i++)
+            _fillBuffer[i] = _color;
+        _fillColor = _color;
+        _fillValid = TRUE;
+    }
+
+    PMPWaitBusy();
+    PMMODEbits.IRQM = 1; // PMP interrupt flag at the end of each write cycle
+    _fillBlocks = blocks;
+    DmaChnOpen(SSD1963_DMA_CHANNEL, DMA_CHN_PRI2, (blocks > 1) ? DMA_OPEN_AUTO : DMA_OPEN_DEFAULT);
+    DmaChnSetEventControl(SSD1963_DMA_CHANNEL, DMA_EV_START_IRQ(_PMP_IRQ));
+    DmaChnSetTxfer(SSD1963_DMA_CHANNEL, _fillBuffer, (void*) &PMDIN, sizeof (_fillBuffer), 2, 2);
+    DmaChnSetEvEnableFlags(SSD1963_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+    INTSetVectorPriority(INT_VECTOR_DMA(SSD1963_DMA_CHANNEL), INT_PRIORITY_LEVEL_5);
+    INTClearFlag(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL));
+    INTEnable(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL), INT_ENABLED);
+    DmaChnStartTxfer(SSD1963_DMA_CHANNEL, DMA_WAIT_NOT, 0); // Forces the first write
+}
+
+/*********************************************************************
+ * Function:  SSD1963FillHandler()
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: DMA block done interrupt. When only the last block is left
+ *			the auto-enable is removed, so the channel stops after it;
+ *			after the last block the SSD1963 is deselected.
+ *
+ * Note: it must run before the last block ends, SSD1963_FILL_BLOCK
+ *		PMP write cycles after the previous one
+ ********************************************************************/
+void __ISR(SSD1963_DMA_VECTOR, ipl5) SSD1963FillHandler(void) {
+    DmaChnClrEvFlags(SSD1963_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+    INTClearFlag(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL));
+    if (--_fillBlocks == 1) {
+        DmaChnClrControlFlags(SSD1963_DMA_CHANNEL, DMA_CTL_AUTO_EN);
+    } else if (_fillBlocks == 0) {
+        INTEnable(INT_SOURCE_DMA(SSD1963_DMA_CHANNEL), INT_DISABLED);
+        PMPWaitBusy();
+        PMMODEbits.IRQM = 0; // PMP interrupt flag off again
+        DisplayDisable();
+    }
+}
+#endif // SSD1963_DMA_CHANNEL
+
+#if defined (USE_DRV_BAR) || defined (USE_DRV_CLEARDEVICE)
+
+/*********************************************************************
+ * Function:  static void FillWindow(DWORD count)
+ *
+ * PreCondition: Window set by SetArea(), CMD_WR_MEMSTART written and
+ *				SSD1963 selected by DisplayEnable()
+ *
+ * Input: count - number of pixels to write with the current color
+ *
+ * Output: none
+ *
+ * Side Effects: deselects the SSD1963, at the end of the DMA transfer
+ *				with SSD1963_DMA_CHANNEL
+ *
+ * Overview: writes the pixels with a loop unrolled by 8. With
+ *			SSD1963_DMA_CHANNEL only the pixels that do not make a whole
+ *			block are written so, then the DMA channel writes the
+ *			blocks while the function returns.
+ *
+ * Note: on the 8 bit PMP each pixel still strobes the latch
+ ********************************************************************/
+static void FillWindow(DWORD count) {
+    DWORD n;
+    WORD color = _color;
+#if defined (SSD1963_DMA_CHANNEL)
+    DWORD blocks = count / SSD1963_FILL_BLOCK;
+
+    count -= blocks * SSD1963_FILL_BLOCK;
+#endif
+
+#ifdef USE_16BIT_PMP
+    DisplaySetData();
+    #define FillPixel() DeviceWrite(color)
+#else
+    #define FillPixel() WriteData(color)
+#endif
+    for (n = count >> 3; n; n--) {
+        FillPixel(); FillPixel(); FillPixel(); FillPixel();
+        FillPixel(); FillPixel(); FillPixel(); FillPixel();
+    }
+    for (n = count & 7; n; n--) {
+        FillPixel();
+    }
+#undef FillPixel
+
+#if defined (SSD1963_DMA_CHANNEL)
+    if (blocks) {
+        FillStartDma(blocks);
+        return;
+    }
+#endif
+    DisplayDisable();
+}
+#endif
+
 /*********************************************************************
  * Function: Set a GPIO pin to state high(1) or low(0)
  *
@@ -570,50 +1144,72 @@ static void SPI_SetReg(BYTE reg, WORD cmd) {
  */
 
 /*********************************************************************
- * Function:  SetArea(start_x,start_y,end_x,end_y)
+ * Macros:  PageOffset()
  *
- * PreCondition: SetActivePage(page)
+ * Overview: first row of the page drawn on in the SSD1963 memory
  *
- * Input: start_x, end_x	- start column and end column
- *		 start_y,end_y 	- start row and end row position (i.e. page address)
+ * PreCondition: none
  *
- * Output: none
+ * Input: none
+ *
+ * Output: row of the draw buffer or of the active page
  *
  * Side Effects: none
  *
- * Overview: defines start/end columns and start/end rows for memory access
- *			from host to SSD1963
  * Note: none
  ********************************************************************/
-void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y) {
-    DWORD offset;
-
 #if defined (USE_DOUBLE_BUFFERING)
-    if (_drawbuffer == GFX_BUFFER1)
-        offset = 0;
-    else
-        offset = (DWORD) (GetMaxY() + 1);
+#define PageOffset()    ((_drawbuffer == GFX_BUFFER1) ? 0 : (SHORT) (GetMaxY() + 1))
 #else
-    offset = (DWORD) _activePage * (GetMaxY() + 1);
+#define PageOffset()    ((SHORT) _activePage * (SHORT) (GetMaxY() + 1))
 #endif
 
+/*********************************************************************
+ * Function:  SetArea(start_x,start_y,end_x,end_y)
+ *
+ * PreCondition: SetActivePage(page)
+ *
+ * Input: start_x, end_x	- start column and end column
+ *		 start_y,end_y 	- start row and end row position (i.e. page address)
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: defines start/end columns and start/end rows for memory access
+ *			from host to SSD1963
+ * Note: the SSD1963 keeps the column and page addresses, so only
+ *		the ones different from the previous window are written
+ ********************************************************************/
+void SetArea(SHORT start_x, SHORT start_y, SHORT end_x, SHORT end_y) {
+    SHORT offset = PageOffset();
+
     start_y = offset + start_y;
     end_y = offset + end_y;
 
-    WriteCommand(CMD_SET_COLUMN);
-    DisplayEnable();
-    WriteData(start_x >> 8);
-    WriteData(start_x);
-    WriteData(end_x >> 8);
-    WriteData(end_x);
-    DisplayDisable();
-    WriteCommand(CMD_SET_PAGE);
-    DisplayEnable();
-    WriteData(start_y >> 8);
-    WriteData(start_y);
-    WriteData(end_y >> 8);
-    WriteData(end_y);
-    DisplayDisable();
+    if (!_areaValid || start_x != _areaLeft || end_x != _areaRight) {
+        WriteCommand(CMD_SET_COLUMN);
+        DisplayEnable();
+        WriteData(start_x >> 8);
+        WriteData(start_x);
+        WriteData(end_x >> 8);
+        WriteData(end_x);
+        DisplayDisable();
+        _areaLeft = start_x;
+        _areaRight = end_x;
+    }
+    if (!_areaValid || start_y != _areaTop || end_y != _areaBottom) {
+        WriteCommand(CMD_SET_PAGE);
+        DisplayEnable();
+        WriteData(start_y >> 8);
+        WriteData(start_y);
+        WriteData(end_y >> 8);
+        WriteData(end_y);
+        DisplayDisable();
+        _areaTop = start_y;
+        _areaBottom = end_y;
+    }
+    _areaValid = TRUE;
 }
 
 /*********************************************************************
@@ -678,6 +1274,36 @@ void SetScrollStart(SHORT line) {
     DisplayDisable();
 }
 
+#if defined (SSD1963_TE_POLL)
+
+/*********************************************************************
+ * Function:  static WORD GetScanLine(void)
+ *
+ * Overview: Reads the line the SSD1963 is scanning out to the panel
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: scan line, 0 at the start of the vertical sync pulse
+ *
+ * Side Effects: none
+ *
+ * Note: Reference: get_scanline (0x45), SSD1963 datasheet
+ ********************************************************************/
+static WORD GetScanLine(void) {
+    WORD line;
+
+    WriteCommand(CMD_GET_SCANLINE);
+    DisplaySetData();
+    DisplayEnable();
+    line = (DeviceRead() & 0xFF) << 8;
+    line |= DeviceRead() & 0xFF;
+    DisplayDisable();
+    return (line);
+}
+#endif
+
 /*********************************************************************
  * Function:  void EnterSleepMode (void)
  * PreCondition: none
@@ -824,6 +1450,7 @@ void SetTearingCfg(BOOL state, BOOL mode) {
  *
  ********************************************************************/
 void ResetDevice(void) {
+    _areaValid = FALSE; // the reset clears the window
     DisplayResetConfig(); //TFT_RST_LAT_BIT = 0;
     DisplayResetEnable(); //TFT_RST_TRIS_BIT = 0; // enable RESET line
 #if defined (USE_8BIT_PMP)
@@ -1083,6 +1710,15 @@ void ResetDevice(void) {
     NoOfInvalidatedRectangleAreas = 0;
     _drawbuffer = GFX_BUFFER1;
     SwitchOnDoubleBuffering();
+
+#if defined (SSD1963_TE_INT)
+    // TE output high in the vertical blank, rising edge interrupt
+    SetTearingCfg(1, 0);
+    INTCONSET = SSD1963_TE_EDGE_MASK;
+    INTSetVectorPriority(SSD1963_TE_INT_VECTOR, INT_PRIORITY_LEVEL_4);
+    INTClearFlag(SSD1963_TE_SOURCE);
+    INTEnable(SSD1963_TE_SOURCE, INT_ENABLED);
+#endif
 #endif //USE_DOUBLE_BUFFERING
 
 
@@ -1117,11 +1753,18 @@ void ResetDevice(void) {
  *
  * Side Effects: none
  *
- * Overview: puts pixel
+ * Overview: puts pixel. A pixel at the next position of the memory
+ *			write opened by the previous PutPixel() is written as data
+ *			only, so horizontal runs (text, horizontal steps of lines)
+ *			cost one bus write per pixel. A pixel right below the
+ *			previous one opens a one column window, so that the rest
+ *			of a vertical run is written the same way.
  *
- * Note:
+ * Note: any command closes the memory write
  ********************************************************************/
 void PutPixel(SHORT x, SHORT y) {
+    SHORT row;
+
     if (_clipRgn) {
         if (x < _clipLeft)
             return;
@@ -1133,11 +1776,31 @@ void PutPixel(SHORT x, SHORT y) {
             return;
     }
 
-    SetArea(x, y, GetMaxX(), GetMaxY());
-    WriteCommand(CMD_WR_MEMSTART);
+    row = PageOffset() + y;
+    WaitFillDone();
+    WaitFlipDone();
+    if (!_cursorValid || x != _cursorX || row != _cursorY) {
+        if (x == _lastX && row == _lastY + 1)
+            SetArea(x, y, x, GetMaxY());
+        else
+            SetArea(x, y, GetMaxX(), GetMaxY());
+        WriteCommand(CMD_WR_MEMSTART);
+        _cursorX = x;
+        _cursorY = row;
+        _cursorValid = TRUE;
+    }
     DisplayEnable();
     WriteData(_color);
     DisplayDisable();
+
+    _lastX = x;
+    _lastY = row;
+    // The SSD1963 moves to the next column, then to the next row of the window
+    if (++_cursorX > _areaRight) {
+        _cursorX = _areaLeft;
+        if (++_cursorY > _areaBottom)
+            _cursorValid = FALSE;
+    }
 }
 
 /*********************************************************************
@@ -1153,11 +1816,59 @@ void PutPixel(SHORT x, SHORT y) {
  *
  * Overview: returns pixel color at x,y position
  *
- * Note: none
+ * Note: 0 when the memory cannot be read back, see GetRow()
  *
  ********************************************************************/
 WORD GetPixel(SHORT x, SHORT y) {
-    return 0; // TODO: implementare GetPixel!
+    GFX_COLOR color;
+
+    if (GetRow(x, y, x, &color) == 0)
+        return (0);
+    return (color);
+}
+
+/*********************************************************************
+ * Function: WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer)
+ *
+ * PreCondition: none
+ *
+ * Input: left,right - first and last column
+ *        y - row
+ *        pBuffer - destination of the right-left+1 pixels
+ *
+ * Output: number of pixels read, 0 if they are not all on the screen
+ *         or the memory cannot be read back
+ *
+ * Side Effects: none
+ *
+ * Overview: reads a row of the active page (of the draw buffer with
+ *           double buffering) with a single CMD_RD_MEMSTART
+ *
+ * Note: The PMP read is pipelined: each read returns the word of the
+ *       previous one and starts the next, so a first read only starts
+ *       the burst. The memory is read with USE_GFX_PMP and
+ *       USE_16BIT_PMP only.
+ *
+ ********************************************************************/
+WORD GetRow(SHORT left, SHORT y, SHORT right, GFX_COLOR *pBuffer) {
+#if defined (USE_GFX_PMP) && defined (USE_16BIT_PMP)
+    WORD count;
+
+    if (left < 0 || right > GetMaxX() || left > right || y < 0 || y > GetMaxY())
+        return (0);
+
+    SetArea(left, y, right, y);
+    WriteCommand(CMD_RD_MEMSTART);
+    DisplaySetData();
+    DisplayEnable();
+    SingleDeviceRead(); // starts the read of the first pixel
+    for (count = right - left + 1; count; count--)
+        *pBuffer++ = SingleDeviceRead();
+    DisplayDisable();
+    return (right - left + 1);
+#else
+    return (0);
+#endif
 }
 
 /*********************************************************************
@@ -1181,7 +1892,10 @@ WORD GetPixel(SHORT x, SHORT y) {
 #ifdef USE_DRV_BAR
 
 WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
-    register SHORT x, y;
+#ifdef USE_NONBLOCKING_CONFIG
+    if (IsDeviceBusy())
+        return (0);
+#endif
 
     if (_clipRgn) {
         if (left < _clipLeft)
@@ -1193,17 +1907,14 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
         if (bottom > _clipBottom)
             bottom = _clipBottom;
     }
+    if (left > right || top > bottom)
+        return (1);
 
     SetArea(left, top, right, bottom);
     WriteCommand(CMD_WR_MEMSTART);
 
     DisplayEnable();
-    for (y = top; y < bottom + 1; y++) {
-        for (x = left; x < right + 1; x++) {
-            WriteData(_color);
-        }
-    }
-    DisplayDisable();
+    FillWindow((DWORD) (right - left + 1) * (DWORD) (bottom - top + 1));
     return (1);
 }
 #endif
@@ -1227,21 +1938,12 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
  *
  ********************************************************************/
 void ClearDevice(void) {
-    //DWORD counter;
-    DWORD xcounter, ycounter;
-
     SetArea(0, 0, GetMaxX(), GetMaxY());
 
     WriteCommand(CMD_WR_MEMSTART);
 
     DisplayEnable();
-    for (ycounter = 0; ycounter < GetMaxY() + 1; ycounter++) {
-        for (xcounter = 0; xcounter < GetMaxX() + 1; xcounter++) {
-            WriteData(_color);
-        }
-    }
-
-    DisplayDisable();
+    FillWindow((DWORD) (GetMaxX() + 1) * (DWORD) (GetMaxY() + 1));
 }
 #endif
 
@@ -1616,96 +2318,195 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch) {
 
 #ifdef USE_BITMAP_EXTERNAL
 
+// Part of a stretched image left on the screen by the clipping
+typedef struct {
+    SHORT left, top, right, bottom; // Screen window
+    WORD x, y;                      // First image column and line drawn
+    WORD columns;                   // Image columns drawn
+    BYTE skipX, skipY;              // Copies of the first column and line clipped away
+} IMAGE_CLIP;
+
 /*********************************************************************
- * Function: void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static BOOL ClipImage(SHORT left, SHORT top, WORD width,
+ *                                 WORD height, BYTE stretch, IMAGE_CLIP *pClip)
  *
  * PreCondition: none
  *
- * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ * Input: left,top - left top image corner, width,height - image size,
+ *        stretch - image stretch factor, pClip - part drawn
  *
- * Output: none
+ * Output: FALSE if no pixel of the image is on the screen
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: clips the stretched image once to the screen and to the
+ *           clipping region, and finds the image pixels left
  *
- * Note: image must be located in external memory
+ * Note: none
  *
  ********************************************************************/
-void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
-    register DWORD memOffset;
-    BITMAP_HEADER bmp;
-    WORD pallete[2];
-    BYTE lineBuffer[((GetMaxX() + 1) / 8) + 1];
-    BYTE* pData;
-    SHORT byteWidth;
-    BYTE temp;
-    BYTE mask;
-    WORD sizeX, sizeY;
-    WORD x, y, y_inc;
-    BYTE stretchX, stretchY;
-
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-
-    // Get pallete (2 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 2 * sizeof (WORD), pallete);
+static BOOL ClipImage(SHORT left, SHORT top, WORD width, WORD height, BYTE stretch, IMAGE_CLIP *pClip) {
+    LONG right = left + (LONG) width * stretch - 1;
+    LONG bottom = top + (LONG) height * stretch - 1;
+    SHORT minX = 0, minY = 0, maxX = GetMaxX(), maxY = GetMaxY();
 
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 2 * sizeof (WORD);
-
-    // Line width in bytes
-    byteWidth = bmp.width >> 3;
-    if (bmp.width & 0x0007)
-        byteWidth++;
-
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
+    if (_clipRgn) {
+        if (_clipLeft > minX)
+            minX = _clipLeft;
+        if (_clipTop > minY)
+            minY = _clipTop;
+        if (_clipRight < maxX)
+            maxX = _clipRight;
+        if (_clipBottom < maxY)
+            maxY = _clipBottom;
+    }
+    if (right < minX || bottom < minY || left > maxX || top > maxY)
+        return (FALSE);
+
+    pClip->left = (left < minX) ? minX : left;
+    pClip->top = (top < minY) ? minY : top;
+    pClip->right = (right > maxX) ? maxX : (SHORT) right;
+    pClip->bottom = (bottom > maxY) ? maxY : (SHORT) bottom;
+    if (pClip->left > pClip->right || pClip->top > pClip->bottom)
+        return (FALSE);
+
+    pClip->x = (pClip->left - left) / stretch;
+    pClip->skipX = (pClip->left - left) % stretch;
+    pClip->y = (pClip->top - top) / stretch;
+    pClip->skipY = (pClip->top - top) % stretch;
+    pClip->columns = (pClip->right - left) / stretch - pClip->x + 1;
+    return (TRUE);
+}
 
-    y_inc = 0; // Y-counter, in case stretch > 1
-    for (y = 0; y < sizeY; y++) {
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-        memOffset += byteWidth;
+/*********************************************************************
+ * Function: static void ExpandLine(BYTE *pData, BYTE colorDepth, WORD x,
+ *                                  WORD count, WORD *pPallete, WORD *pLine)
+ *
+ * PreCondition: none
+ *
+ * Input: pData - image line bytes, from the byte of column x,
+ *        colorDepth - 1, 4 or 8 bits per pixel, x - first image column,
+ *        count - number of pixels, pPallete - image pallete,
+ *        pLine - line buffer
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: converts the pallete indexes of a line to colors
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void ExpandLine(BYTE *pData, BYTE colorDepth, WORD x, WORD count, WORD *pPallete, WORD *pLine) {
+    BYTE temp = 0;
+    BYTE mask;
 
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-            SetArea(left, top + y_inc, GetMaxX(), GetMaxY());
-            y_inc++;
-            WriteCommand(CMD_WR_MEMSTART);
-            mask = 0;
-            DisplayEnable();
-            for (x = 0; x < sizeX; x++) {
-                // Read 8 pixels from flash
+    switch (colorDepth) {
+        case 1:
+            mask = 0x80 >> (x & 0x07);
+            temp = *pData++;
+            while (count--) {
                 if (mask == 0) {
                     temp = *pData++;
                     mask = 0x80;
                 }
+                *pLine++ = pPallete[(temp & mask) ? 1 : 0];
+                mask >>= 1;
+            }
+            break;
 
-                // Set color
-                if (mask & temp) {
-                    SetColor(pallete[1]);
+        case 4:
+            // First pixel in the low nibble
+            if (x & 0x0001)
+                temp = *pData++;
+            while (count--) {
+                if (x++ & 0x0001) {
+                    *pLine++ = pPallete[temp >> 4];
                 } else {
-                    SetColor(pallete[0]);
+                    temp = *pData++;
+                    *pLine++ = pPallete[temp & 0x0f];
                 }
+            }
+            break;
 
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-                    WriteData(_color);
-                }
+        case 8:
+            while (count--)
+                *pLine++ = pPallete[*pData++];
+            break;
+    }
+}
 
-                // Shift to the next pixel
-                mask >>= 1;
-            }
-            DisplayDisable();
+/*********************************************************************
+ * Function: static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip)
+ *
+ * PreCondition: none
+ *
+ * Input: pLine - image pixels, stretched in place, width - screen pixels,
+ *        stretch - image stretch factor, skip - copies of the first
+ *        pixel clipped away
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: repeats each pixel stretch times, from the end of the line
+ *           so that no pixel is overwritten before it is copied
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip) {
+    WORD src = (width - 1 + skip) / stretch;
+    BYTE copies = (width - 1 + skip) % stretch + 1;
+
+    while (width) {
+        pLine[--width] = pLine[src];
+        if (--copies == 0) {
+            src--;
+            copies = stretch;
         }
     }
 }
 
 /*********************************************************************
- * Function: void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static void WriteLine(WORD *pLine, WORD count)
+ *
+ * PreCondition: Window set by SetArea(), CMD_WR_MEMSTART written and
+ *               SSD1963 selected by DisplayEnable()
+ *
+ * Input: pLine - pixels, count - number of pixels
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: writes the pixels with a loop unrolled by 8
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void WriteLine(WORD *pLine, WORD count) {
+    WORD n;
+
+#ifdef USE_16BIT_PMP
+    DisplaySetData();
+    #define LinePixel(i) DeviceWrite(pLine[i])
+#else
+    #define LinePixel(i) WriteData(pLine[i])
+#endif
+    for (n = count >> 3; n; n--, pLine += 8) {
+        LinePixel(0); LinePixel(1); LinePixel(2); LinePixel(3);
+        LinePixel(4); LinePixel(5); LinePixel(6); LinePixel(7);
+    }
+    for (n = count & 7; n; n--, pLine++) {
+        LinePixel(0);
+    }
+#undef LinePixel
+}
+
+/*********************************************************************
+ * Function: static void PutImageExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
  *
  * PreCondition: none
  *
@@ -1716,76 +2517,75 @@ void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: outputs an image of any color depth. The image is clipped
+ *           once and its window set once; each line is read, converted
+ *           to colors and stretched in a line buffer, then written
+ *           stretch times.
  *
  * Note: image must be located in external memory
  *
  ********************************************************************/
-void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
+static void PutImageExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
     register DWORD memOffset;
     BITMAP_HEADER bmp;
-    WORD pallete[16];
-    BYTE lineBuffer[((GetMaxX() + 1) / 2) + 1];
-    BYTE* pData;
-    SHORT byteWidth;
-    BYTE temp;
-    WORD sizeX, sizeY;
-    WORD x, y, y_inc;
-    BYTE stretchX, stretchY;
+    IMAGE_CLIP clip;
+    WORD pallete[256];
+    BYTE byteBuffer[(GetMaxX() + 1)];
+    WORD lineBuffer[(GetMaxX() + 1)];
+    DWORD byteWidth;
+    WORD colors, firstByte, readWidth;
+    WORD width, rows;
+    BYTE copies;
 
     // Get bitmap header
     ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
+    if (!ClipImage(left, top, bmp.width, bmp.height, stretch, &clip))
+        return;
 
-    // Get pallete (16 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 16 * sizeof (WORD), pallete);
+    // Get pallete
+    colors = (bmp.colorDepth == 16) ? 0 : 1 << bmp.colorDepth;
+    if (colors)
+        ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), colors * sizeof (WORD), pallete);
 
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 16 * sizeof (WORD);
+    // Line width in bytes, and bytes of the columns drawn
+    byteWidth = ((DWORD) bmp.width * bmp.colorDepth + 7) >> 3;
+    firstByte = ((DWORD) clip.x * bmp.colorDepth) >> 3;
+    readWidth = ((((DWORD) clip.x + clip.columns) * bmp.colorDepth + 7) >> 3) - firstByte;
 
-    // Line width in bytes
-    byteWidth = bmp.width >> 1;
-    if (bmp.width & 0x0001)
-        byteWidth++;
+    // Set offset to the first line drawn
+    memOffset = sizeof (BITMAP_HEADER) + colors * sizeof (WORD) + clip.y * byteWidth + firstByte;
 
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
+    width = clip.right - clip.left + 1;
+    rows = clip.bottom - clip.top + 1;
+    copies = stretch - clip.skipY;
 
-    y_inc = 0; // Y-counter, in case stretch > 1
-    for (y = 0; y < sizeY; y++) {
+    SetArea(clip.left, clip.top, clip.right, clip.bottom);
+    WriteCommand(CMD_WR_MEMSTART);
+    while (rows) {
         // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
+        if (colors) {
+            ExternalMemoryCallback(bitmap, memOffset, readWidth, byteBuffer);
+            ExpandLine(byteBuffer, bmp.colorDepth, clip.x, clip.columns, pallete, lineBuffer);
+        } else {
+            ExternalMemoryCallback(bitmap, memOffset, readWidth, lineBuffer);
+        }
         memOffset += byteWidth;
+        if (stretch > 1)
+            StretchLine(lineBuffer, width, stretch, clip.skipX);
 
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-            SetArea(left, top + y_inc, GetMaxX(), GetMaxY());
-            y_inc++;
-            WriteCommand(CMD_WR_MEMSTART);
-            DisplayEnable();
-            for (x = 0; x < sizeX; x++) {
-                // Read 2 pixels from flash
-                if (x & 0x0001) {
-                    // second pixel in byte
-                    SetColor(pallete[temp >> 4]);
-                } else {
-                    temp = *pData++;
-                    // first pixel in byte
-                    SetColor(pallete[temp & 0x0f]);
-                }
-
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-                    WriteData(_color);
-                }
-            }
-            DisplayDisable();
-        }
+        // Write line to screen, the memory write goes on between the lines
+        DisplayEnable();
+        do {
+            WriteLine(lineBuffer, width);
+            rows--;
+        } while (--copies && rows);
+        DisplayDisable();
+        copies = stretch;
     }
 }
 
 /*********************************************************************
- * Function: void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
  *
  * PreCondition: none
  *
@@ -1801,54 +2601,50 @@ void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
  * Note: image must be located in external memory
  *
  ********************************************************************/
-void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
-    register DWORD memOffset;
-    BITMAP_HEADER bmp;
-    WORD pallete[256];
-    BYTE lineBuffer[(GetMaxX() + 1)];
-    BYTE* pData;
-    BYTE temp;
-    WORD sizeX, sizeY;
-    WORD x, y, y_inc;
-    BYTE stretchX, stretchY;
-
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-
-    // Get pallete (256 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 256 * sizeof (WORD), pallete);
-
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 256 * sizeof (WORD);
-
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
-
-    y_inc = 0; // Y-counter, in case stretch > 1
-    for (y = 0; y < sizeY; y++) {
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, sizeX, lineBuffer);
-        memOffset += sizeX;
+void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
+    PutImageExt(left, top, bitmap, stretch);
+}
 
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-            SetArea(left, top + y_inc, GetMaxX(), GetMaxY());
-            y_inc++;
-            WriteCommand(CMD_WR_MEMSTART);
-            DisplayEnable();
-            for (x = 0; x < sizeX; x++) {
-                temp = *pData++;
-                SetColor(pallete[temp]);
+/*********************************************************************
+ * Function: void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs 16 color image starting from left,top coordinates
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
+    PutImageExt(left, top, bitmap, stretch);
+}
 
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-                    WriteData(_color);
-                }
-            }
-            DisplayDisable();
-        }
-    }
+/*********************************************************************
+ * Function: void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs 256 color image starting from left,top coordinates
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
+    PutImageExt(left, top, bitmap, stretch);
 }
 
 /*********************************************************************
@@ -1863,58 +2659,13 @@ void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: outputs hicolor image starting from left,top coordinates
  *
  * Note: image must be located in external memory
  *
  ********************************************************************/
 void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch) {
-    register DWORD memOffset;
-    BITMAP_HEADER bmp;
-    WORD lineBuffer[(GetMaxX() + 1)];
-    WORD* pData;
-    WORD byteWidth;
-    WORD temp;
-    WORD sizeX, sizeY;
-    WORD x, y, y_inc;
-    BYTE stretchX, stretchY;
-
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER);
-
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
-
-    byteWidth = sizeX << 1;
-
-    y_inc = 0; // Y-counter, in case stretch > 1
-    for (y = 0; y < sizeY; y++) {
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-        memOffset += byteWidth;
-
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-            SetArea(left, top + y_inc, GetMaxX(), GetMaxY());
-            y_inc++;
-            WriteCommand(CMD_WR_MEMSTART);
-            DisplayEnable();
-            for (x = 0; x < sizeX; x++) {
-                temp = *pData++;
-                SetColor(temp);
-
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-                    WriteData(_color);
-                }
-            }
-            DisplayDisable();
-        }
-    }
+    PutImageExt(left, top, bitmap, stretch);
 }
 
 #endif
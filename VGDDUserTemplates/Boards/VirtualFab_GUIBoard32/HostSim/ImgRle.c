@@ -0,0 +1,448 @@
+// *****************************************************************************
+// GUIBoard32 host tool
+// RLE encoder for the images drawn by the R61509V driver
+// *****************************************************************************
+// FileName:        ImgRle.c
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// Reads an uncompressed 1, 4, 8 or 16 bpp image, as stored on the SD card
+// (BINBMP_ON_SDFAT) or in the array of a flash image: the 6 byte BITMAP_HEADER,
+// the pallete, then the lines. It writes the same image in the RLE format
+// described in R61509V.h, drawn when USE_BITMAP_RLE is defined.
+//
+// Each row is coded alone. A run is coded when it saves bytes over the
+// packed pixels: from 2 pixels at 16 bpp, 3 at 8 bpp, 4 at 4 bpp, 16 at 1 bpp.
+// A skip table entry is written every -r rows (16 by default), so that a
+// partial blit decodes at most -r - 1 rows it does not draw.
+//
+// The RLE image is drawn back by the R61509V driver, built into the tool over
+// a model of the GRAM, and compared with the input: in tiles whose first rows
+// fall between two skip table entries and in random partial blits, from flash
+// and from external memory. Any pixel that differs makes the tool exit with
+// 2. The sizes and the compression ratio are reported. With -c the output is a C source with the image as a flash
+// array and its IMAGE_FLASH, instead of the binary file for the SD card.
+//
+// Build (from this directory):
+//   gcc -std=gnu99 -O2 -Wall -Iinclude -I.. -o ImgRle ImgRle.c ../R61509V.c
+// Use:
+//   ImgRle [-r rows] [-c name] input.bin output
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+//  2026/10/17	Verified with the decoder of the R61509V driver
+// *****************************************************************************
+#include "Compiler.h"
+#include "Graphics/Graphics.h"
+#include "Graphics/gfxpmp.h"
+#include "R61509V.h"
+
+#define BITMAP_HEADER_SIZE  6u
+#define RLE_MAX_PACKET      128u
+#define VERIFY_BLITS        256         // Random partial blits drawn by Verify()
+
+typedef struct {
+    BYTE compression;
+    BYTE colorDepth;
+    WORD height;
+    WORD width;
+    WORD colors;                        // Pallete entries, 0 for 16 bpp
+    DWORD lineBytes;
+    const BYTE *pPallete;
+    const BYTE *pLines;
+} IMAGE;
+
+// Output buffer, grown as needed
+typedef struct {
+    BYTE *pData;
+    DWORD size;
+    DWORD alloc;
+} OUTPUT;
+
+static void PutByte(OUTPUT *pOut, BYTE value) {
+    if (pOut->size == pOut->alloc) {
+        pOut->alloc = pOut->alloc ? pOut->alloc * 2 : 4096;
+        pOut->pData = realloc(pOut->pData, pOut->alloc);
+        if (pOut->pData == NULL) {
+            fprintf(stderr, "ImgRle: out of memory\n");
+            exit(1);
+        }
+    }
+    pOut->pData[pOut->size++] = value;
+}
+
+static void PutWord(OUTPUT *pOut, WORD value) {
+    PutByte(pOut, (BYTE) value);
+    PutByte(pOut, (BYTE) (value >> 8));
+}
+
+static void PutDword(OUTPUT *pOut, DWORD offset, DWORD value) {
+    pOut->pData[offset] = (BYTE) value;
+    pOut->pData[offset + 1] = (BYTE) (value >> 8);
+    pOut->pData[offset + 2] = (BYTE) (value >> 16);
+    pOut->pData[offset + 3] = (BYTE) (value >> 24);
+}
+
+static WORD GetWord(const BYTE *pData) {
+    return (WORD) (pData[0] | (pData[1] << 8));
+}
+
+// Pallete index or color of a pixel of an uncompressed image
+static WORD RawPixel(const IMAGE *pImage, DWORD x, DWORD y) {
+    const BYTE *pLine = pImage->pLines + y * pImage->lineBytes;
+
+    switch (pImage->colorDepth) {
+        case 1:
+            return (pLine[x >> 3] & (0x80 >> (x & 7))) ? 1 : 0;
+        case 4:
+            return (x & 1) ? pLine[x >> 1] >> 4 : pLine[x >> 1] & 0x0f;
+        case 8:
+            return pLine[x];
+        default:
+            return GetWord(pLine + x * 2);
+    }
+}
+
+static DWORD MinRun(BYTE colorDepth) {
+    switch (colorDepth) {
+        case 1: return 16;
+        case 4: return 4;
+        case 8: return 3;
+        default: return 2;
+    }
+}
+
+static void PutValue(OUTPUT *pOut, BYTE colorDepth, WORD value) {
+    if (colorDepth == 16)
+        PutWord(pOut, value);
+    else
+        PutByte(pOut, (BYTE) value);
+}
+
+// Literal pixels, packed from a new byte as in an uncompressed line
+static void PutLiteral(OUTPUT *pOut, BYTE colorDepth, const WORD *pRow, DWORD count) {
+    DWORD n;
+    BYTE temp = 0;
+
+    PutByte(pOut, (BYTE) (count - 1));
+    for (n = 0; n < count; n++) {
+        switch (colorDepth) {
+            case 1:
+                if (pRow[n])
+                    temp |= 0x80 >> (n & 7);
+                if ((n & 7) == 7 || n == count - 1) {
+                    PutByte(pOut, temp);
+                    temp = 0;
+                }
+                break;
+            case 4:
+                if (n & 1) {
+                    PutByte(pOut, temp | (pRow[n] << 4));
+                    temp = 0;
+                } else {
+                    temp = (BYTE) pRow[n];
+                    if (n == count - 1)
+                        PutByte(pOut, temp);
+                }
+                break;
+            default:
+                PutValue(pOut, colorDepth, pRow[n]);
+                break;
+        }
+    }
+}
+
+static DWORD RunLength(const WORD *pRow, DWORD count) {
+    DWORD n = 1;
+
+    while (n < count && n < RLE_MAX_PACKET && pRow[n] == pRow[0])
+        n++;
+    return n;
+}
+
+static void EncodeRow(OUTPUT *pOut, BYTE colorDepth, const WORD *pRow, DWORD width) {
+    DWORD x = 0, n, run, minRun = MinRun(colorDepth);
+
+    while (x < width) {
+        run = RunLength(pRow + x, width - x);
+        if (run >= minRun) {
+            PutByte(pOut, (BYTE) (0x80 | (run - 1)));
+            PutValue(pOut, colorDepth, pRow[x]);
+            x += run;
+            continue;
+        }
+
+        // Literal up to the next run worth coding
+        for (n = run; x + n < width && n < RLE_MAX_PACKET; ) {
+            run = RunLength(pRow + x + n, width - x - n);
+            if (run >= minRun)
+                break;
+            n += run;
+        }
+        if (n > RLE_MAX_PACKET)
+            n = RLE_MAX_PACKET;
+        PutLiteral(pOut, colorDepth, pRow + x, n);
+        x += n;
+    }
+}
+
+static void Encode(const IMAGE *pImage, const BYTE *pFile, WORD rowStep, OUTPUT *pOut) {
+    DWORD palleteBytes = pImage->colors * 2u;
+    DWORD table, x, y;
+    WORD *pRow = malloc(pImage->width * sizeof (WORD));
+
+    // Header and pallete as in the input, then the row step and skip table
+    PutByte(pOut, BITMAP_COMP_RLE);
+    for (x = 1; x < BITMAP_HEADER_SIZE + palleteBytes; x++)
+        PutByte(pOut, pFile[x]);
+    PutWord(pOut, rowStep);
+    table = pOut->size;
+    for (y = 0; y < (pImage->height + rowStep - 1u) / rowStep; y++) {
+        PutWord(pOut, 0);
+        PutWord(pOut, 0);
+    }
+
+    for (y = 0; y < pImage->height; y++) {
+        if (y % rowStep == 0)
+            PutDword(pOut, table + (y / rowStep) * 4, pOut->size);
+        for (x = 0; x < pImage->width; x++)
+            pRow[x] = RawPixel(pImage, x, y);
+        EncodeRow(pOut, pImage->colorDepth, pRow, pImage->width);
+    }
+    free(pRow);
+}
+
+// Host side of the driver: the PMP bus, the GRAM and the external memory
+BYTE HostRS, HostCS;
+__PMMODEbits_t PMMODEbits;
+__PMCONbits_t PMCONbits;
+volatile WORD PMDIN1;
+
+static WORD hostIndex, hostAddrLo, hostAddrHi;
+static DWORD hostAddr;
+static WORD hostGram[DISP_VER_RESOLUTION][LINE_MEM_PITCH];
+static BYTE hostWritten[DISP_VER_RESOLUTION][LINE_MEM_PITCH];
+static const OUTPUT *pHostImage;        // Image read by ExternalMemoryCallback()
+
+WORD PutImagePartial(SHORT left, SHORT top, void *image, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+
+// R61509V registers 0x200 and 0x201 set the GRAM address, 0x202 writes it
+void DeviceWrite(WORD data) {
+    DWORD x, y;
+
+    if (!HostRS) {
+        hostIndex = data;
+        if (data == 0x202)
+            hostAddr = ((DWORD) hostAddrHi << 8) | hostAddrLo;
+        return;
+    }
+    switch (hostIndex) {
+        case 0x200:
+            hostAddrLo = data;
+            break;
+        case 0x201:
+            hostAddrHi = data;
+            break;
+        case 0x202:
+            y = hostAddr / LINE_MEM_PITCH;
+            x = hostAddr % LINE_MEM_PITCH;
+            if (y < DISP_VER_RESOLUTION) {
+                hostGram[y][x] = data;
+                hostWritten[y][x]++;
+            }
+            hostAddr++;
+            break;
+    }
+}
+
+// The driver reads ahead, past the end of the image too: those bytes are 0
+WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer) {
+    WORD n = 0;
+
+    memset(buffer, 0, nCount);
+    if (offset >= 0 && (DWORD) offset < pHostImage->size) {
+        n = (pHostImage->size - offset < nCount) ? (WORD) (pHostImage->size - offset) : nCount;
+        memcpy(buffer, pHostImage->pData + offset, n);
+    }
+    return n;
+}
+
+// Color of a pixel of an uncompressed image
+static WORD RawColor(const IMAGE *pImage, DWORD x, DWORD y) {
+    WORD value = RawPixel(pImage, x, y);
+
+    return pImage->colors ? GetWord(pImage->pPallete + value * 2u) : value;
+}
+
+// Draws a part of the image at left,top and counts the pixels that differ,
+// or are written more than once or outside the part
+static DWORD Blit(const IMAGE *pImage, void *pRle, SHORT left, SHORT top, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    DWORD errors = 0;
+    SHORT x, y;
+
+    memset(hostWritten, 0, sizeof (hostWritten));
+    if (!PutImagePartial(left, top, pRle, IMAGE_NORMAL, xoffset, yoffset, width, height))
+        return (DWORD) width * height;
+    for (y = 0; y < DISP_VER_RESOLUTION; y++) {
+        for (x = 0; x < LINE_MEM_PITCH; x++) {
+            if (x >= left && x < left + width && y >= top && y < top + height)
+                errors += hostWritten[y][x] != 1 || hostGram[y][x] != RawColor(pImage, xoffset + x - left, yoffset + y - top);
+            else
+                errors += hostWritten[y][x] != 0;
+        }
+    }
+    return errors;
+}
+
+// Draws the RLE image with the driver, from flash and from external memory,
+// and counts the pixels that differ from the input
+static DWORD Verify(const IMAGE *pImage, const OUTPUT *pOut) {
+    IMAGE_FLASH flash = {FLASH, pOut->pData};
+    IMAGE_EXTERNAL external = {EXTERNAL, 0, 0};
+    void *pSource[2] = {&flash, &external};
+    WORD rowStep = GetWord(pOut->pData + BITMAP_HEADER_SIZE + pImage->colors * 2u);
+    WORD tileHeight = rowStep + rowStep / 2 + 1;
+    WORD width, height;
+    SHORT xoffset, yoffset;
+    DWORD errors = 0;
+    int n, s;
+
+    pHostImage = pOut;
+    if (tileHeight > DISP_VER_RESOLUTION)
+        tileHeight = DISP_VER_RESOLUTION;
+
+    // Whole image, in tiles starting at the rows 0, tileHeight, 2 * tileHeight...
+    for (s = 0; s < 2; s++) {
+        for (yoffset = 0; yoffset < pImage->height; yoffset += tileHeight) {
+            height = (pImage->height - yoffset < tileHeight) ? pImage->height - yoffset : tileHeight;
+            for (xoffset = 0; xoffset < pImage->width; xoffset += DISP_HOR_RESOLUTION) {
+                width = (pImage->width - xoffset < DISP_HOR_RESOLUTION) ? pImage->width - xoffset : DISP_HOR_RESOLUTION;
+                errors += Blit(pImage, pSource[s], 0, 0, xoffset, yoffset, width, height);
+            }
+        }
+    }
+
+    // Random parts, at random places
+    srand(1);
+    for (n = 0; n < VERIFY_BLITS; n++) {
+        xoffset = rand() % pImage->width;
+        yoffset = rand() % pImage->height;
+        width = 1 + rand() % (pImage->width - xoffset);
+        height = 1 + rand() % (pImage->height - yoffset);
+        if (width > DISP_HOR_RESOLUTION)
+            width = DISP_HOR_RESOLUTION;
+        if (height > DISP_VER_RESOLUTION)
+            height = DISP_VER_RESOLUTION;
+        errors += Blit(pImage, pSource[n & 1], rand() % (DISP_HOR_RESOLUTION - width + 1),
+                rand() % (DISP_VER_RESOLUTION - height + 1), xoffset, yoffset, width, height);
+    }
+    return errors;
+}
+
+static int WriteSource(FILE *fp, const char *name, const OUTPUT *pOut) {
+    DWORD n;
+
+    fprintf(fp, "// RLE image made by ImgRle, %u bytes\n", pOut->size);
+    fprintf(fp, "#include \"Graphics/Graphics.h\"\n\n");
+    fprintf(fp, "FLASH_BYTE %s_data[%u] = {", name, pOut->size);
+    for (n = 0; n < pOut->size; n++)
+        fprintf(fp, "%s0x%02X%s", (n % 16) ? "" : "\n    ", pOut->pData[n], (n + 1 < pOut->size) ? "," : "");
+    fprintf(fp, "\n};\n\n");
+    fprintf(fp, "const IMAGE_FLASH %s = {FLASH, (FLASH_BYTE *) %s_data};\n", name, name);
+    return ferror(fp);
+}
+
+int main(int argc, char **argv) {
+    const char *name = NULL, *input = NULL, *output = NULL;
+    WORD rowStep = 16;
+    IMAGE image;
+    OUTPUT out = {NULL, 0, 0};
+    BYTE *pFile;
+    long size;
+    DWORD errors;
+    FILE *fp;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            rowStep = (WORD) atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            name = argv[++i];
+        } else if (input == NULL) {
+            input = argv[i];
+        } else if (output == NULL) {
+            output = argv[i];
+        } else {
+            input = NULL;
+            break;
+        }
+    }
+    if (input == NULL || output == NULL || rowStep == 0) {
+        fprintf(stderr, "Usage: ImgRle [-r rows] [-c name] input.bin output\n");
+        return 1;
+    }
+
+    fp = fopen(input, "rb");
+    if (fp == NULL) {
+        perror(input);
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    pFile = malloc(size > 0 ? size : 1);
+    if (size < (long) BITMAP_HEADER_SIZE || fread(pFile, 1, size, fp) != (size_t) size) {
+        fprintf(stderr, "%s: not an image\n", input);
+        return 1;
+    }
+    fclose(fp);
+
+    image.compression = pFile[0];
+    image.colorDepth = pFile[1];
+    image.height = GetWord(pFile + 2);
+    image.width = GetWord(pFile + 4);
+    if (image.compression != BITMAP_COMP_NONE) {
+        fprintf(stderr, "%s: compressed image (%u)\n", input, image.compression);
+        return 1;
+    }
+    if (image.colorDepth != 1 && image.colorDepth != 4 && image.colorDepth != 8 && image.colorDepth != 16) {
+        fprintf(stderr, "%s: %u bpp not supported\n", input, image.colorDepth);
+        return 1;
+    }
+    image.colors = (image.colorDepth == 16) ? 0 : 1 << image.colorDepth;
+    image.lineBytes = ((DWORD) image.width * image.colorDepth + 7) >> 3;
+    image.pPallete = pFile + BITMAP_HEADER_SIZE;
+    image.pLines = pFile + BITMAP_HEADER_SIZE + image.colors * 2u;
+    if ((DWORD) size < BITMAP_HEADER_SIZE + image.colors * 2u + image.lineBytes * image.height) {
+        fprintf(stderr, "%s: shorter than a %ux%u %u bpp image\n", input, image.width, image.height, image.colorDepth);
+        return 1;
+    }
+
+    Encode(&image, pFile, rowStep, &out);
+    errors = Verify(&image, &out);
+    if (errors) {
+        fprintf(stderr, "%s: %u pixels differ once drawn by the driver\n", input, errors);
+        return 2;
+    }
+
+    fp = fopen(output, name ? "w" : "wb");
+    if (fp == NULL) {
+        perror(output);
+        return 1;
+    }
+    if (name ? WriteSource(fp, name, &out) : fwrite(out.pData, 1, out.size, fp) != out.size) {
+        perror(output);
+        return 1;
+    }
+    fclose(fp);
+
+    printf("%s: %ux%u %u bpp, %ld bytes, RLE %u bytes, ratio %.2f, skip table every %u rows\n",
+            input, image.width, image.height, image.colorDepth, size, out.size, (double) size / out.size, rowStep);
+    if ((DWORD) size <= out.size)
+        printf("%s: the uncompressed image is smaller\n", input);
+    free(pFile);
+    free(out.pData);
+    return 0;
+}
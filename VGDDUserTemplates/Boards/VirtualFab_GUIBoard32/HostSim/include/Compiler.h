@@ -0,0 +1,43 @@
+// *****************************************************************************
+// GUIBoard32 host simulation
+// Stand-in for Microchip's Compiler.h
+// *****************************************************************************
+// FileName:        Compiler.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The PMP registers read by R61509V.c; the PMP never reports busy.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _COMPILER_H
+#define _COMPILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GenericTypeDefs.h"
+
+#define __PIC32MX__
+
+typedef const BYTE FLASH_BYTE;
+typedef const WORD FLASH_WORD;
+
+typedef struct {
+    unsigned BUSY : 1, IRQM : 2, WAITM : 4;
+} __PMMODEbits_t;
+typedef struct {
+    unsigned PMPEN : 1;
+} __PMCONbits_t;
+
+extern __PMMODEbits_t PMMODEbits;
+extern __PMCONbits_t PMCONbits;
+extern volatile WORD PMDIN1;
+
+#define PMDIN   PMDIN1
+#define Nop()
+
+#endif
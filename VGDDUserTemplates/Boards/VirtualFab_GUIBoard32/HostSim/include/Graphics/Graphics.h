@@ -0,0 +1,56 @@
+// *****************************************************************************
+// GUIBoard32 host simulation
+// Stand-in for the Microchip Graphics Library Graphics.h
+// *****************************************************************************
+// FileName:        Graphics.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The image types and the primitives layer state used by R61509V.c.
+// ExternalMemoryCallback() is left to the host program.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GRAPHICS_H
+#define _GRAPHICS_H
+
+#include "GraphicsConfig.h"
+#include "GenericTypeDefs.h"
+
+typedef WORD GFX_COLOR;
+
+typedef struct {
+    BYTE compression;
+    BYTE colorDepth;
+    SHORT height;
+    SHORT width;
+} BITMAP_HEADER;
+
+typedef struct {
+    SHORT type;
+    FLASH_BYTE *address;
+} IMAGE_FLASH;
+
+typedef struct {
+    SHORT type;
+    WORD ID;
+    DWORD address;
+} IMAGE_EXTERNAL;
+
+#define FLASH               0
+#define EXTERNAL            1
+#define BINBMP_ON_SDFAT     0x10
+
+#define IMAGE_NORMAL        1
+#define IMAGE_X2            2
+
+#define SetColor(color)     _color = (color)
+
+extern GFX_COLOR _color;
+
+WORD ExternalMemoryCallback(IMAGE_EXTERNAL *memory, LONG offset, WORD nCount, void *buffer);
+
+#endif
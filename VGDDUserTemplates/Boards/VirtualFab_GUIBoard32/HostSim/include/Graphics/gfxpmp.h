@@ -0,0 +1,40 @@
+// *****************************************************************************
+// GUIBoard32 host simulation
+// Stand-in for the Microchip Graphics Library gfxpmp.h
+// *****************************************************************************
+// FileName:        gfxpmp.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The PMP control lines are plain variables; DeviceWrite() is left to the
+// host program.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GFXPMP_H
+#define _GFXPMP_H
+
+#include "GenericTypeDefs.h"
+#include "TimeDelay.h"
+
+extern BYTE HostRS, HostCS;
+
+#define DisplayEnable()             HostCS = 1
+#define DisplayDisable()            HostCS = 0
+#define DisplaySetCommand()         HostRS = 0
+#define DisplaySetData()            HostRS = 1
+#define DisplayResetEnable()
+#define DisplayResetDisable()
+#define DisplayResetConfig()
+#define DisplayCmdDataConfig()
+#define DisplayConfig()
+#define DisplayBacklightOn()
+#define DisplayBacklightConfig()
+#define DriverInterfaceInit()
+
+void DeviceWrite(WORD data);
+
+#endif
@@ -0,0 +1,32 @@
+// *****************************************************************************
+// GUIBoard32 host simulation
+// Stand-in for the application GraphicsConfig.h
+// *****************************************************************************
+// FileName:        GraphicsConfig.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// The R61509V on a 16 bit PMP in portrait orientation, with the RLE images
+// in flash and in external memory and without the DMA queue, so that every
+// image goes through PutImageLines().
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
+#ifndef _GRAPHICSCONFIG_H
+#define _GRAPHICSCONFIG_H
+
+#define USE_16BIT_PMP
+#define USE_GFX_PMP
+#define USE_BITMAP_FLASH
+#define USE_BITMAP_EXTERNAL
+#define USE_BITMAP_RLE
+
+#define DISP_ORIENTATION            0
+#define DISP_HOR_RESOLUTION         240
+#define DISP_VER_RESOLUTION         400
+#define COLOR_DEPTH                 16
+
+#endif
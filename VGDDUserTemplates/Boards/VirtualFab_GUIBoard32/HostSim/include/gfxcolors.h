@@ -0,0 +1,15 @@
+// *****************************************************************************
+// GUIBoard32 host simulation
+// Stand-in for Microchip's gfxcolors.h
+// *****************************************************************************
+// FileName:        gfxcolors.h
+// Processor:       Host PC (Linux/Windows)
+// Compiler:        gcc
+// Company:         VirtualFab
+//
+// No color is used by name in R61509V.c.
+//
+// Date         Comment
+// *****************************************************************************
+//  2026/10/17	Initial release
+// *****************************************************************************
@@ -41,6 +41,11 @@
  *                                  Window address implementation
  * VirtualFab           2011/07/15  Implementation of TRANSPARENT_COLOR
  * VirtualFab           2013/02/10  Integration for VGDD MplabX Wizard
+ * VirtualFab           2026/10/17  PutImagePartial draws only the requested part
+ * VirtualFab           2026/10/17  PutImage*Ext clipped once, line buffered
+ * VirtualFab           2026/10/17  RLE compressed images (USE_BITMAP_RLE)
+ * VirtualFab           2026/10/17  DMA command queue (R61509V_DMA_CHANNEL)
+ * VirtualFab           2026/10/17  PMP interrupt flag off when the queue empties
  *****************************************************************************/
 #include "Compiler.h"
 #include "Graphics/Graphics.h"
@@ -67,15 +72,73 @@ BYTE DeviceCode1, DeviceCode2;
 
 /////////////////////// LOCAL FUNCTIONS PROTOTYPES ////////////////////////////
 void SetReg(WORD index, WORD value);
-void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch);
-void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch);
-void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch);
-void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch);
+void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+
+void PutImage1BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage4BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage8BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+void PutImage16BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+
+#ifdef R61509V_DMA_CHANNEL
+    #if !defined (__PIC32MX__) || !defined (USE_GFX_PMP)
+        #error R61509V_DMA_CHANNEL needs a PIC32 with the PMP driving the WR line (USE_GFX_PMP)
+    #endif
+    #ifndef R61509V_QUEUE_SIZE
+        #define R61509V_QUEUE_SIZE  8       // Commands waiting for the DMA channel
+    #endif
+    #ifndef R61509V_DMA_BLOCK
+        #define R61509V_DMA_BLOCK   256     // Pixels written by each DMA block
+    #endif
+    #if (R61509V_DMA_CHANNEL == 0)
+        #define R61509V_DMA_VECTOR  _DMA0_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 1)
+        #define R61509V_DMA_VECTOR  _DMA1_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 2)
+        #define R61509V_DMA_VECTOR  _DMA2_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 3)
+        #define R61509V_DMA_VECTOR  _DMA3_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 4)
+        #define R61509V_DMA_VECTOR  _DMA4_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 5)
+        #define R61509V_DMA_VECTOR  _DMA5_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 6)
+        #define R61509V_DMA_VECTOR  _DMA6_VECTOR
+    #elif (R61509V_DMA_CHANNEL == 7)
+        #define R61509V_DMA_VECTOR  _DMA7_VECTOR
+    #else
+        #error R61509V_DMA_CHANNEL must be 0 to 7
+    #endif
+
+// Rectangle filled with one color, or copied from a 16 bpp image in flash,
+// written line by line from the GRAM address of each line
+typedef struct {
+    DWORD address;                  // GRAM address of the next line
+    LONG step;                      // GRAM address difference between two lines
+    WORD width;                     // Pixels of a line
+    WORD lines;                     // Lines left
+    WORD pixels;                    // Pixels left in the line being written
+    GFX_COLOR color;                // Fill color
+    FLASH_WORD *pLine;              // Next image line, NULL for a fill
+    FLASH_WORD *pPixel;             // Next image pixel of the line being written
+    WORD stride;                    // Image pixels between two lines
+} QUEUE_COMMAND;
 
-void PutImage1BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch);
-void PutImage4BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch);
-void PutImage8BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch);
-void PutImage16BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch);
+#ifdef USE_16BIT_PMP
+    #define QUEUE_CELL_SIZE 2               // Bytes of each PMP write
+static WORD _queueFill[R61509V_DMA_BLOCK];
+#else
+    #define QUEUE_CELL_SIZE 1
+static BYTE _queueFill[R61509V_DMA_BLOCK * 2];
+#endif
+static GFX_COLOR _queueFillColor;           // Color in _queueFill
+static BOOL _queueFillValid = FALSE;
+static QUEUE_COMMAND _queue[R61509V_QUEUE_SIZE];
+static WORD _queueHead = 0;                 // Command being written
+static volatile WORD _queueCount = 0;       // Commands queued, 0 when the channel is idle
+#endif
 
 /*********************************************************************
 * Function: IsDeviceBusy()
@@ -91,11 +154,41 @@ void PutImage16BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch);
 *
 * Side Effects: none
 *
+* Note: the number of commands in the DMA queue (R61509V_DMA_CHANNEL),
+*       else always 0
+*
 ********************************************************************/
 WORD IsDeviceBusy(void) {
+#ifdef R61509V_DMA_CHANNEL
+    return (_queueCount);
+#else
     return (0);
+#endif
 }
 
+/*********************************************************************
+ * Macro:  WaitQueueEmpty()
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: waits for the end of the queued commands, so that the CPU
+ *           does not access the display while the DMA channel writes
+ *
+ * Note: nothing to wait for without R61509V_DMA_CHANNEL
+ *
+ ********************************************************************/
+#ifdef R61509V_DMA_CHANNEL
+    #define WaitQueueEmpty()    while (_queueCount);
+#else
+    #define WaitQueueEmpty()
+#endif
+
 
 /*********************************************************************
  * Macro: DWORD CalcAddressXY(SHORT x, SHORT y)
@@ -196,6 +289,201 @@ WORD IsDeviceBusy(void) {
 	}
 #endif
 
+#ifdef R61509V_DMA_CHANNEL
+
+// GRAM address difference between a pixel and the one below it
+#if (DISP_ORIENTATION == 0)
+    #define LINE_ADDRESS_STEP   ((LONG) LINE_MEM_PITCH)
+#elif (DISP_ORIENTATION == 90)
+    #define LINE_ADDRESS_STEP   (-1L)
+#elif (DISP_ORIENTATION == 180)
+    #define LINE_ADDRESS_STEP   (-(LONG) LINE_MEM_PITCH)
+#elif (DISP_ORIENTATION == 270)
+    #define LINE_ADDRESS_STEP   (1L)
+#endif
+
+/*********************************************************************
+ * Function: static void QueueNext(void)
+ *
+ * PreCondition: R61509V selected, DMA channel idle
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: deselects the R61509V and turns the PMP interrupt flag
+ *               off when the queue is empty
+ *
+ * Overview: starts the next DMA block of the command at the head of the
+ *           queue, at most R61509V_DMA_BLOCK pixels of a line. The GRAM
+ *           address of each line is written by the CPU; the channel then
+ *           writes a cell each time the PMP ends a write cycle. Finished
+ *           commands are removed from the queue.
+ *
+ * Note: called by QueueCommand() and by the DMA interrupt
+ *
+ ********************************************************************/
+static void QueueNext(void) {
+    QUEUE_COMMAND *pCommand;
+    WORD count, i;
+
+    while (_queueCount) {
+        pCommand = &_queue[_queueHead];
+        if (pCommand->pixels == 0) {
+            if (pCommand->lines == 0) {
+                _queueHead = (_queueHead + 1) % R61509V_QUEUE_SIZE;
+                _queueCount--;
+                continue;
+            }
+
+            // Next line
+            while (PMMODEbits.BUSY);
+            SetAddress(pCommand->address);
+            pCommand->address += pCommand->step;
+            pCommand->pixels = pCommand->width;
+            pCommand->lines--;
+            if (pCommand->pLine != NULL) {
+                pCommand->pPixel = pCommand->pLine;
+                pCommand->pLine += pCommand->stride;
+            } else if (!_queueFillValid || _queueFillColor != pCommand->color) {
+                // The block is filled again only when the color changes
+                for (i = 0; i < R61509V_DMA_BLOCK; i++) {
+#ifdef USE_16BIT_PMP
+                    _queueFill[i] = pCommand->color;
+#else
+                    _queueFill[2 * i] = ((WORD_VAL) pCommand->color).v[1];
+                    _queueFill[2 * i + 1] = ((WORD_VAL) pCommand->color).v[0];
+#endif
+                }
+                _queueFillColor = pCommand->color;
+                _queueFillValid = TRUE;
+            }
+        }
+
+        count = (pCommand->pixels < R61509V_DMA_BLOCK) ? pCommand->pixels : R61509V_DMA_BLOCK;
+        pCommand->pixels -= count;
+        while (PMMODEbits.BUSY);
+        INTClearFlag(INT_PMP);
+        if (pCommand->pLine != NULL) {
+            DmaChnSetTxfer(R61509V_DMA_CHANNEL, (void *) pCommand->pPixel, (void *) &PMDIN, count * 2, QUEUE_CELL_SIZE, QUEUE_CELL_SIZE);
+            pCommand->pPixel += count;
+        } else {
+            DmaChnSetTxfer(R61509V_DMA_CHANNEL, _queueFill, (void *) &PMDIN, count * 2, QUEUE_CELL_SIZE, QUEUE_CELL_SIZE);
+        }
+        DmaChnStartTxfer(R61509V_DMA_CHANNEL, DMA_WAIT_NOT, 0); // Forces the first write
+        return;
+    }
+
+    // Queue empty
+    while (PMMODEbits.BUSY);
+    PMMODEbits.IRQM = 0; // PMP interrupt flag off again
+    DisplayDisable();
+}
+
+/*********************************************************************
+ * Function: static WORD QueueCommand(QUEUE_COMMAND *pCommand)
+ *
+ * PreCondition: none
+ *
+ * Input: pCommand - command, with pixels 0
+ *
+ * Output: For NON-Blocking configuration:
+ *         - Returns 0 when the queue is full and the command not queued.
+ *         - Returns 1 when the command is queued.
+ *         For Blocking configuration:
+ *         - Waits for room in the queue and always returns 1.
+ *
+ * Side Effects: none
+ *
+ * Overview: adds the command to the queue, starting the DMA channel
+ *           when it is idle. The DMA interrupt is disabled meanwhile,
+ *           so the queue is not changed under it.
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static WORD QueueCommand(QUEUE_COMMAND *pCommand) {
+#ifdef USE_NONBLOCKING_CONFIG
+    if (_queueCount == R61509V_QUEUE_SIZE)
+        return (0);
+#else
+    while (_queueCount == R61509V_QUEUE_SIZE);
+#endif
+
+    INTEnable(INT_SOURCE_DMA(R61509V_DMA_CHANNEL), INT_DISABLED);
+    _queue[(_queueHead + _queueCount) % R61509V_QUEUE_SIZE] = *pCommand;
+    if (_queueCount++ == 0) {
+        // Channel idle
+        PMMODEbits.IRQM = 1; // PMP interrupt flag at the end of each write cycle
+        DmaChnOpen(R61509V_DMA_CHANNEL, DMA_CHN_PRI2, DMA_OPEN_DEFAULT);
+        DmaChnSetEventControl(R61509V_DMA_CHANNEL, DMA_EV_START_IRQ(_PMP_IRQ));
+        DmaChnSetEvEnableFlags(R61509V_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+        INTSetVectorPriority(INT_VECTOR_DMA(R61509V_DMA_CHANNEL), INT_PRIORITY_LEVEL_5);
+        INTClearFlag(INT_SOURCE_DMA(R61509V_DMA_CHANNEL));
+        DisplayEnable();
+        QueueNext();
+    }
+    INTEnable(INT_SOURCE_DMA(R61509V_DMA_CHANNEL), INT_ENABLED);
+    return (1);
+}
+
+/*********************************************************************
+ * Function: R61509VQueueHandler()
+ *
+ * PreCondition: none
+ *
+ * Input: none
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: DMA block done interrupt, starts the next block
+ *
+ * Note: none
+ *
+ ********************************************************************/
+void __ISR(R61509V_DMA_VECTOR, ipl5) R61509VQueueHandler(void) {
+    DmaChnClrEvFlags(R61509V_DMA_CHANNEL, DMA_EV_BLOCK_DONE);
+    INTClearFlag(INT_SOURCE_DMA(R61509V_DMA_CHANNEL));
+    QueueNext();
+}
+
+/*********************************************************************
+ * Function: static WORD QueueRectangle(SHORT left, SHORT top, SHORT right,
+ *                                      SHORT bottom, FLASH_WORD *pImage, WORD stride)
+ *
+ * PreCondition: rectangle on the screen
+ *
+ * Input: left,top - top left corner coordinates,
+ *        right,bottom - bottom right corner coordinates,
+ *        pImage - first image pixel, NULL to fill with the current color,
+ *        stride - image pixels between two lines
+ *
+ * Output: as QueueCommand()
+ *
+ * Side Effects: none
+ *
+ * Overview: queues a rectangle fill or copy
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static WORD QueueRectangle(SHORT left, SHORT top, SHORT right, SHORT bottom, FLASH_WORD *pImage, WORD stride) {
+    QUEUE_COMMAND command;
+
+    command.address = CalcAddressXY(left, top);
+    command.step = LINE_ADDRESS_STEP;
+    command.width = right - left + 1;
+    command.lines = bottom - top + 1;
+    command.pixels = 0;
+    command.color = _color;
+    command.pLine = pImage;
+    command.stride = stride;
+    return (QueueCommand(&command));
+}
+#endif // R61509V_DMA_CHANNEL
+
 /*********************************************************************
  * Function:  void  SetReg(WORD index, WORD value)
  *
@@ -214,6 +502,7 @@ WORD IsDeviceBusy(void) {
  *
  ********************************************************************/
 void SetReg(WORD index, WORD value) {
+    WaitQueueEmpty();
 #ifdef USE_16BIT_PMP
     DisplayEnable();
     DisplaySetCommand();
@@ -234,6 +523,7 @@ void SetReg(WORD index, WORD value) {
 }
 
 void TransferSync(void) {
+    WaitQueueEmpty();
     DisplayEnable();
     DisplaySetCommand();
     DeviceWrite(0x00);
@@ -496,6 +786,7 @@ void TransparentColorEnable(GFX_COLOR color) {
  *
  ********************************************************************/
 void SetAddressXY(SHORT x, SHORT y) {
+    WaitQueueEmpty();
     DisplayEnable();
     SetAddress(CalcAddressXY(x, y));
 }
@@ -680,12 +971,15 @@ WORD GetPixel(SHORT x, SHORT y) {
  *
  * Side Effects: none
  *
- * Overview: draws rectangle filled with current color
+ * Overview: draws rectangle filled with current color. With
+ *           R61509V_DMA_CHANNEL the rectangle is queued for the DMA
+ *           channel; busy then means the queue is full.
  *
  * Note: none
  *
  ********************************************************************/
 WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+#ifndef R61509V_DMA_CHANNEL
     DWORD address;
     register SHORT x, y;
 
@@ -696,6 +990,7 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
 #else
     if (IsDeviceBusy() != 0)
         return (0);
+#endif
 #endif
     if (_clipRgn) {
         if (left < _clipLeft)
@@ -708,6 +1003,19 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
             bottom = _clipBottom;
     }
 
+#ifdef R61509V_DMA_CHANNEL
+    if (left < 0)
+        left = 0;
+    if (top < 0)
+        top = 0;
+    if (right > GetMaxX())
+        right = GetMaxX();
+    if (bottom > GetMaxY())
+        bottom = GetMaxY();
+    if (left > right || top > bottom)
+        return (1);
+    return (QueueRectangle(left, top, right, bottom, NULL, 0));
+#else
 #if (DISP_ORIENTATION == 0)
     address = (DWORD) LINE_MEM_PITCH * top + left;
     DisplayEnable();
@@ -767,6 +1075,7 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
 
 #endif
     return (1);
+#endif // R61509V_DMA_CHANNEL
 }
 
 /*********************************************************************
@@ -782,10 +1091,13 @@ WORD Bar(SHORT left, SHORT top, SHORT right, SHORT bottom) {
  *
  * Overview: clears screen with current color
  *
- * Note: none
+ * Note: queued for the DMA channel with R61509V_DMA_CHANNEL
  *
  ********************************************************************/
 void ClearDevice(void) {
+#ifdef R61509V_DMA_CHANNEL
+    while (!QueueRectangle(0, 0, GetMaxX(), GetMaxY(), NULL, 0));
+#else
     DWORD counter;
 
     DisplayEnable();
@@ -795,18 +1107,130 @@ void ClearDevice(void) {
     }
 
     DisplayDisable();
+#endif
 }
 
 //#ifdef USE_DRV_PUTIMAGE
 
 /*********************************************************************
- * Function: WORD PutImage(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static WORD ClipImagePartial(WORD sizeX, WORD sizeY, SHORT *xoffset, SHORT *yoffset, WORD *width, WORD *height)
+ *
+ * PreCondition: none
+ *
+ * Input: sizeX,sizeY - image size,
+ *        xoffset,yoffset - left top corner of the requested part,
+ *        width,height - size of the requested part
+ *
+ * Output: Returns 0 when there is nothing to draw
+ *
+ * Side Effects: none
+ *
+ * Overview: clips the requested part to the image. Width and height
+ *           both 0 select the whole image (PutImage()).
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static WORD ClipImagePartial(WORD sizeX, WORD sizeY, SHORT *xoffset, SHORT *yoffset, WORD *width, WORD *height) {
+    if ((*width == 0) && (*height == 0)) {
+        *xoffset = 0;
+        *yoffset = 0;
+        *width = sizeX;
+        *height = sizeY;
+    }
+    if (*xoffset < 0)
+        *xoffset = 0;
+    if (*yoffset < 0)
+        *yoffset = 0;
+    if ((*xoffset >= sizeX) || (*yoffset >= sizeY))
+        return (0);
+    if (*width > sizeX - *xoffset)
+        *width = sizeX - *xoffset;
+    if (*height > sizeY - *yoffset)
+        *height = sizeY - *yoffset;
+    return ((*width != 0) && (*height != 0));
+}
+
+#if defined(R61509V_DMA_CHANNEL) && defined(USE_BITMAP_FLASH) && defined(USE_16BIT_PMP)
+
+/*********************************************************************
+ * Function: static SHORT QueueImage(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                                   SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: -1 when the image must be drawn by the CPU, else as QueueCommand()
+ *
+ * Side Effects: none
+ *
+ * Overview: queues the part of an uncompressed 16 bpp image drawn
+ *           without stretch or transparency, clipped to the screen and
+ *           to the clipping region. The DMA channel reads its lines
+ *           straight from flash.
+ *
+ * Note: image must be located in flash
+ *
+ ********************************************************************/
+static SHORT QueueImage(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    FLASH_WORD *pImage = (FLASH_WORD *) bitmap;
+    SHORT right, bottom;
+    SHORT minX = 0, minY = 0, maxX = GetMaxX(), maxY = GetMaxY();
+
+    if (bitmap[0] != 0 || bitmap[1] != 16 || stretch != 1)
+        return (-1);
+#ifdef USE_TRANSPARENT_COLOR
+    if (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)
+        return (-1);
+#endif
+    if (!ClipImagePartial(pImage[2], pImage[1], &xoffset, &yoffset, &width, &height))
+        return (1);
+
+    if (_clipRgn) {
+        if (_clipLeft > minX)
+            minX = _clipLeft;
+        if (_clipTop > minY)
+            minY = _clipTop;
+        if (_clipRight < maxX)
+            maxX = _clipRight;
+        if (_clipBottom < maxY)
+            maxY = _clipBottom;
+    }
+    right = left + width - 1;
+    bottom = top + height - 1;
+    if (left < minX) {
+        xoffset += minX - left;
+        left = minX;
+    }
+    if (top < minY) {
+        yoffset += minY - top;
+        top = minY;
+    }
+    if (right > maxX)
+        right = maxX;
+    if (bottom > maxY)
+        bottom = maxY;
+    if (left > right || top > bottom)
+        return (1);
+
+    return (QueueRectangle(left, top, right, bottom, pImage + 3 + (DWORD) yoffset * pImage[2] + xoffset, pImage[2]));
+}
+#endif
+
+/*********************************************************************
+ * Function: WORD PutImagePartial(SHORT left, SHORT top, void* image, BYTE stretch,
+ *                                SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner,
- *        bitmap - image pointer,
- *        stretch - image stretch factor
+ *        image - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset - left top corner of the part of the image to draw,
+ *        width,height - size of the part to draw (both 0 for the whole image)
  *
  * Output: For NON-Blocking configuration:
  *         - Returns 0 when device is busy and the image is not yet completely drawn.
@@ -816,21 +1240,38 @@ void ClearDevice(void) {
  *
  * Side Effects: none
  *
- * Overview: outputs image starting from left,top coordinates
+ * Overview: outputs the xoffset,yoffset,width,height part of the image
+ *           starting from left,top coordinates. Only the rows and columns
+ *           of the part are read from the image and sent to the display.
+ *           With R61509V_DMA_CHANNEL and the 16 bit PMP, a 16 bpp flash
+ *           image drawn without stretch or transparency is queued for the
+ *           DMA channel; busy then means the queue is full.
  *
- * Note: image must be located in flash
+ * Note: image must be located in flash or external memory
  *
  ********************************************************************/
 
+#if defined(USE_BITMAP_FLASH) && defined(USE_BITMAP_RLE)
+static void PutImageFlash(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height);
+#endif
+
 /* */
 WORD __attribute__((weak)) PutImagePartial(SHORT left, SHORT top, void *image, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
-#if defined (USE_BITMAP_FLASH) || defined (USE_BITMAP_EXTERNAL)
+#if defined (USE_BITMAP_FLASH) || defined (USE_BITMAP_EXTERNAL) || defined (USE_BITMAP_SD)
     FLASH_BYTE *flashAddress;
     BYTE colorDepth;
 #endif    
     WORD colorTemp;
     WORD ret = 0;
 
+#if defined(R61509V_DMA_CHANNEL) && defined(USE_BITMAP_FLASH) && defined(USE_16BIT_PMP)
+    if (*((SHORT *) image) == FLASH) {
+        SHORT queued = QueueImage(left, top, ((IMAGE_FLASH *) image)->address, stretch, xoffset, yoffset, width, height);
+
+        if (queued >= 0)
+            return (queued);
+    }
+#endif
 #ifndef USE_NONBLOCKING_CONFIG
     while (IsDeviceBusy() != 0);
 
@@ -858,15 +1299,22 @@ WORD __attribute__((weak)) PutImagePartial(SHORT left, SHORT top, void *image, B
             // Read color depth
             colorDepth = *(flashAddress + 1);
 
+#ifdef USE_BITMAP_RLE
+            if (*flashAddress == BITMAP_COMP_RLE) {
+                PutImageFlash(left, top, flashAddress, stretch, xoffset, yoffset, width, height);
+                ret = 1;
+                break;
+            }
+#endif
             // Draw picture
             switch (colorDepth) {
-                case 1: PutImage1BPP(left, top, flashAddress, stretch);
+                case 1: PutImage1BPP(left, top, flashAddress, stretch, xoffset, yoffset, width, height);
                     break;
-                case 4: PutImage4BPP(left, top, flashAddress, stretch);
+                case 4: PutImage4BPP(left, top, flashAddress, stretch, xoffset, yoffset, width, height);
                     break;
-                case 8: PutImage8BPP(left, top, flashAddress, stretch);
+                case 8: PutImage8BPP(left, top, flashAddress, stretch, xoffset, yoffset, width, height);
                     break;
-                case 16: PutImage16BPP(left, top, flashAddress, stretch);
+                case 16: PutImage16BPP(left, top, flashAddress, stretch, xoffset, yoffset, width, height);
                     break;
             }
             ret = 1;
@@ -881,13 +1329,13 @@ WORD __attribute__((weak)) PutImagePartial(SHORT left, SHORT top, void *image, B
 
             // Draw picture
             switch (colorDepth) {
-                case 1: PutImage1BPPExt(left, top, image, stretch);
+                case 1: PutImage1BPPExt(left, top, image, stretch, xoffset, yoffset, width, height);
                     break;
-                case 4: PutImage4BPPExt(left, top, image, stretch);
+                case 4: PutImage4BPPExt(left, top, image, stretch, xoffset, yoffset, width, height);
                     break;
-                case 8: PutImage8BPPExt(left, top, image, stretch);
+                case 8: PutImage8BPPExt(left, top, image, stretch, xoffset, yoffset, width, height);
                     break;
-                case 16: PutImage16BPPExt(left, top, image, stretch);
+                case 16: PutImage16BPPExt(left, top, image, stretch, xoffset, yoffset, width, height);
                     break;
                 default: break;
             }
@@ -907,13 +1355,15 @@ WORD __attribute__((weak)) PutImagePartial(SHORT left, SHORT top, void *image, B
 #if defined(USE_BITMAP_FLASH)
 
 /*********************************************************************
- * Function: void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch)
+ * Function: void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                             SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner,
  *        bitmap - image pointer,
- *        stretch - image stretch factor
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
  *
  * Output: none
  *
@@ -924,14 +1374,15 @@ WORD __attribute__((weak)) PutImagePartial(SHORT left, SHORT top, void *image, B
  * Note: image must be located in flash
  *
  ********************************************************************/
-void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
+void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
     register FLASH_BYTE *flashAddress;
-    register FLASH_BYTE *tempFlashAddress;
-#ifndef USE_WINDOWADDRESS
+    register FLASH_BYTE *lineAddress;
+#if !defined(USE_WINDOWADDRESS) || defined(USE_TRANSPARENT_COLOR)
     DWORD address;
 #endif
     BYTE temp = 0;
     WORD sizeX, sizeY;
+    WORD byteWidth;
     WORD x, y;
     BYTE stretchX, stretchY;
     WORD pallete[2];
@@ -950,22 +1401,35 @@ void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
     pallete[1] = *((FLASH_WORD *) flashAddress);
     flashAddress += 2;
 
+    if (!ClipImagePartial(sizeX, sizeY, &xoffset, &yoffset, &width, &height))
+        return;
+
+    // Line width in bytes
+    byteWidth = sizeX >> 3;
+    if (sizeX & 0x0007)
+        byteWidth++;
+
+    // Move to the first byte of the part
+    lineAddress = flashAddress + (DWORD) yoffset * byteWidth + (xoffset >> 3);
+
 #ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
+    DispEnableWindow(left, top, left + width * stretch - 1, top + height * stretch - 1);
     SetAddress(0);
 #endif
 
     DisplayEnable();
-    for (y = 0; y < sizeY; y++) {
-        tempFlashAddress = flashAddress;
+    for (y = 0; y < height; y++) {
         for (stretchY = 0; stretchY < stretch; stretchY++) {
-            flashAddress = tempFlashAddress;
+            flashAddress = lineAddress;
 #ifndef USE_WINDOWADDRESS
             address = CalcAddressXY(left, top + y * stretch + stretchY);
             SetAddress(address);
 #endif
-            mask = 0;
-            for (x = 0; x < sizeX; x++) {
+            // Read the first 8 pixels and skip the ones left of the part
+            temp = *flashAddress;
+            flashAddress++;
+            mask = 0x80 >> (xoffset & 0x0007);
+            for (x = 0; x < width; x++) {
 
                 // Read 8 pixels from flash
                 if (mask == 0) {
@@ -1001,6 +1465,7 @@ void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
                 mask >>= 1;
             }
         }
+        lineAddress += byteWidth;
     }
 
     DisplayDisable();
@@ -1010,12 +1475,14 @@ void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
 }
 
 /*********************************************************************
- * Function: void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch)
+ * Function: void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                             SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
  *
  * Output: none
  *
@@ -1026,13 +1493,14 @@ void PutImage1BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
  * Note: image must be located in flash
  *
  ********************************************************************/
-void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
+void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
     register FLASH_BYTE *flashAddress;
-    register FLASH_BYTE *tempFlashAddress;
-#ifndef USE_WINDOWADDRESS
+    register FLASH_BYTE *lineAddress;
+#if !defined(USE_WINDOWADDRESS) || defined(USE_TRANSPARENT_COLOR)
     DWORD address;
 #endif
     WORD sizeX, sizeY;
+    WORD byteWidth;
     register WORD x, y;
     BYTE temp = 0;
     register BYTE stretchX, stretchY;
@@ -1054,25 +1522,40 @@ void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
         flashAddress += 2;
     }
 
+    if (!ClipImagePartial(sizeX, sizeY, &xoffset, &yoffset, &width, &height))
+        return;
+
+    // Line width in bytes
+    byteWidth = sizeX >> 1;
+    if (sizeX & 0x0001)
+        byteWidth++;
+
+    // Move to the first byte of the part
+    lineAddress = flashAddress + (DWORD) yoffset * byteWidth + (xoffset >> 1);
+
 #ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
+    DispEnableWindow(left, top, left + width * stretch - 1, top + height * stretch - 1);
     SetAddress(0);
 #endif
 
     DisplayEnable();
-    for (y = 0; y < sizeY; y++) {
-        tempFlashAddress = flashAddress;
+    for (y = 0; y < height; y++) {
         for (stretchY = 0; stretchY < stretch; stretchY++) {
-            flashAddress = tempFlashAddress;
+            flashAddress = lineAddress;
 
             // Set start address
 #ifndef USE_WINDOWADDRESS
             address = CalcAddressXY(left, top + y * stretch + stretchY);
             SetAddress(address);
 #endif
-            for (x = 0; x < sizeX; x++) {
+            // A part starting on an odd column begins with the second pixel of a byte
+            temp = *flashAddress;
+            if (xoffset & 0x0001)
+                flashAddress++;
+
+            for (x = 0; x < width; x++) {
                 // Read 2 pixels from flash
-                if (x & 0x0001) {
+                if ((xoffset + x) & 0x0001) {
                     // second pixel in byte
                     SetColor(pallete[temp >> 4]);
                 } else {
@@ -1098,11 +1581,9 @@ void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
 #endif
                         WritePixel(_color);
                 }
-
-                // Shift to the next pixel
-                //temp >>= 4;
             }
         }
+        lineAddress += byteWidth;
     }
 
     DisplayDisable();
@@ -1112,12 +1593,14 @@ void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
 }
 
 /*********************************************************************
- * Function: void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch)
+ * Function: void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                             SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
  *
  * Output: none
  *
@@ -1128,10 +1611,10 @@ void PutImage4BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
  * Note: image must be located in flash
  *
  ********************************************************************/
-void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
+void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
     register FLASH_BYTE *flashAddress;
-    register FLASH_BYTE *tempFlashAddress;
-#ifndef USE_WINDOWADDRESS
+    register FLASH_BYTE *lineAddress;
+#if !defined(USE_WINDOWADDRESS) || defined(USE_TRANSPARENT_COLOR)
     DWORD address;
 #endif
     WORD sizeX, sizeY;
@@ -1150,29 +1633,34 @@ void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
     sizeX = *((FLASH_WORD *) flashAddress);
     flashAddress += 2;
 
+    if (!ClipImagePartial(sizeX, sizeY, &xoffset, &yoffset, &width, &height))
+        return;
+
     // Read pallete
     for (counter = 0; counter < 256; counter++) {
         pallete[counter] = *((FLASH_WORD *) flashAddress);
         flashAddress += 2;
     }
 
+    // Move to the first pixel of the part
+    lineAddress = flashAddress + (DWORD) yoffset * sizeX + xoffset;
+
 #ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
+    DispEnableWindow(left, top, left + width * stretch - 1, top + height * stretch - 1);
     SetAddress(0);
 #endif
 
     DisplayEnable();
-    for (y = 0; y < sizeY; y++) {
-        tempFlashAddress = flashAddress;
+    for (y = 0; y < height; y++) {
         for (stretchY = 0; stretchY < stretch; stretchY++) {
-            flashAddress = tempFlashAddress;
+            flashAddress = lineAddress;
 
             // Set start address
 #ifndef USE_WINDOWADDRESS
             address = CalcAddressXY(left, top + y * stretch + stretchY);
             SetAddress(address);
 #endif
-            for (x = 0; x < sizeX; x++) {
+            for (x = 0; x < width; x++) {
 
                 // Read pixels from flash
                 PaletteIndex = *flashAddress;
@@ -1198,6 +1686,7 @@ void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
                 }
             }
         }
+        lineAddress += sizeX;
     }
     DisplayDisable();
 #ifdef USE_WINDOWADDRESS
@@ -1206,12 +1695,14 @@ void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
 }
 
 /*********************************************************************
- * Function: void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch)
+ * Function: void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                              SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
  *
  * Output: none
  *
@@ -1222,10 +1713,10 @@ void PutImage8BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
  * Note: image must be located in flash
  *
  ********************************************************************/
-void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
+void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
     register FLASH_WORD *flashAddress;
-    register FLASH_WORD *tempFlashAddress;
-#ifndef USE_WINDOWADDRESS
+    register FLASH_WORD *lineAddress;
+#if !defined(USE_WINDOWADDRESS) || defined(USE_TRANSPARENT_COLOR)
     DWORD address;
 #endif
     WORD sizeX, sizeY;
@@ -1242,16 +1733,21 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
     sizeX = *flashAddress;
     flashAddress++;
 
+    if (!ClipImagePartial(sizeX, sizeY, &xoffset, &yoffset, &width, &height))
+        return;
+
+    // Move to the first pixel of the part
+    lineAddress = flashAddress + (DWORD) yoffset * sizeX + xoffset;
+
 #ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
+    DispEnableWindow(left, top, left + width * stretch - 1, top + height * stretch - 1);
     SetAddress(0);
 #endif
 
     DisplayEnable();
-    for (y = 0; y < sizeY; y++) {
-        tempFlashAddress = flashAddress;
+    for (y = 0; y < height; y++) {
         for (stretchY = 0; stretchY < stretch; stretchY++) {
-            flashAddress = tempFlashAddress;
+            flashAddress = lineAddress;
 
             // Set start address
 #ifndef USE_WINDOWADDRESS
@@ -1259,7 +1755,7 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
             SetAddress(address);
 #endif
 
-            for (x = 0; x < sizeX; x++) {
+            for (x = 0; x < width; x++) {
 
                 // Read pixels from flash
                 PicPixelColor = *flashAddress;
@@ -1282,6 +1778,7 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
                 }
             }
         }
+        lineAddress += sizeX;
     }
 
     DisplayDisable();
@@ -1292,386 +1789,668 @@ void PutImage16BPP(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch) {
 
 #endif //USE_BITMAP_FLASH
 
-#if defined(USE_BITMAP_EXTERNAL) || defined(USE_BITMAP_SD)
+#if defined(USE_BITMAP_EXTERNAL) || defined(USE_BITMAP_SD) || (defined(USE_BITMAP_FLASH) && defined(USE_BITMAP_RLE))
+
+// Part of a stretched image left on the screen by the clipping
+typedef struct {
+    SHORT left, top, right, bottom; // Screen window
+    WORD x, y;                      // First image column and line drawn
+    WORD columns;                   // Image columns drawn
+    BYTE skipX, skipY;              // Copies of the first column and line clipped away
+} IMAGE_CLIP;
 
 /*********************************************************************
- * Function: void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static BOOL ClipImage(SHORT left, SHORT top, WORD width,
+ *                                 WORD height, BYTE stretch, IMAGE_CLIP *pClip)
  *
  * PreCondition: none
  *
- * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ * Input: left,top - left top image corner, width,height - image size,
+ *        stretch - image stretch factor, pClip - part drawn
  *
- * Output: none
+ * Output: FALSE if no pixel of the image is on the screen
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: clips the stretched image once to the screen and to the
+ *           clipping region, and finds the image pixels left
  *
- * Note: image must be located in external memory
+ * Note: none
  *
  ********************************************************************/
-void PutImage1BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch) {
-    register DWORD memOffset;
-#ifndef USE_WINDOWADDRESS
-    DWORD address;
-#endif
-    BITMAP_HEADER bmp;
-    WORD pallete[2];
-    BYTE lineBuffer[((GetMaxX() + 1) / 8) + 1];
-    BYTE *pData;
-    SHORT byteWidth;
+static BOOL ClipImage(SHORT left, SHORT top, WORD width, WORD height, BYTE stretch, IMAGE_CLIP *pClip) {
+    LONG right = left + (LONG) width * stretch - 1;
+    LONG bottom = top + (LONG) height * stretch - 1;
+    SHORT minX = 0, minY = 0, maxX = GetMaxX(), maxY = GetMaxY();
+
+    if (_clipRgn) {
+        if (_clipLeft > minX)
+            minX = _clipLeft;
+        if (_clipTop > minY)
+            minY = _clipTop;
+        if (_clipRight < maxX)
+            maxX = _clipRight;
+        if (_clipBottom < maxY)
+            maxY = _clipBottom;
+    }
+    if (right < minX || bottom < minY || left > maxX || top > maxY)
+        return (FALSE);
+
+    pClip->left = (left < minX) ? minX : left;
+    pClip->top = (top < minY) ? minY : top;
+    pClip->right = (right > maxX) ? maxX : (SHORT) right;
+    pClip->bottom = (bottom > maxY) ? maxY : (SHORT) bottom;
+    if (pClip->left > pClip->right || pClip->top > pClip->bottom)
+        return (FALSE);
+
+    pClip->x = (pClip->left - left) / stretch;
+    pClip->skipX = (pClip->left - left) % stretch;
+    pClip->y = (pClip->top - top) / stretch;
+    pClip->skipY = (pClip->top - top) % stretch;
+    pClip->columns = (pClip->right - left) / stretch - pClip->x + 1;
+    return (TRUE);
+}
 
+/*********************************************************************
+ * Function: static void ExpandLine(BYTE *pData, BYTE colorDepth, WORD x,
+ *                                  WORD count, WORD *pPallete, WORD *pLine)
+ *
+ * PreCondition: none
+ *
+ * Input: pData - image line bytes, from the byte of column x,
+ *        colorDepth - 1, 4 or 8 bits per pixel, x - first image column,
+ *        count - number of pixels, pPallete - image pallete,
+ *        pLine - line buffer
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: converts the pallete indexes of a line to colors
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void ExpandLine(BYTE *pData, BYTE colorDepth, WORD x, WORD count, WORD *pPallete, WORD *pLine) {
     BYTE temp = 0;
     BYTE mask;
-    WORD sizeX, sizeY;
-    WORD x, y;
-    BYTE stretchX, stretchY;
-
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-
-    // Get pallete (2 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 2 * sizeof (WORD), pallete);
 
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 2 * sizeof (WORD);
-
-    // Line width in bytes
-    byteWidth = bmp.width >> 3;
-    if (bmp.width & 0x0007)
-        byteWidth++;
-
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
-
-#ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
-    SetAddress(0);
-#endif
-
-    for (y = 0; y < sizeY; y++) {
-
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-        memOffset += byteWidth;
-        DisplayEnable();
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-#ifndef USE_WINDOWADDRESS
-            address = CalcAddressXY(left, top + y * stretch + stretchY);
-            SetAddress(address);
-#endif
-            mask = 0;
-            for (x = 0; x < sizeX; x++) {
-
-                // Read 8 pixels from flash
+    switch (colorDepth) {
+        case 1:
+            mask = 0x80 >> (x & 0x07);
+            temp = *pData++;
+            while (count--) {
                 if (mask == 0) {
                     temp = *pData++;
                     mask = 0x80;
                 }
+                *pLine++ = pPallete[(temp & mask) ? 1 : 0];
+                mask >>= 1;
+            }
+            break;
 
-                // Set color
-                if (mask & temp) {
-                    SetColor(pallete[1]);
+        case 4:
+            // First pixel in the low nibble
+            if (x & 0x0001)
+                temp = *pData++;
+            while (count--) {
+                if (x++ & 0x0001) {
+                    *pLine++ = pPallete[temp >> 4];
                 } else {
-                    SetColor(pallete[0]);
+                    temp = *pData++;
+                    *pLine++ = pPallete[temp & 0x0f];
                 }
+            }
+            break;
 
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-#ifdef USE_TRANSPARENT_COLOR
-                    if ((GetTransparentColor() == _color) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)) {
-#ifdef USE_WINDOWADDRESS
-                        address = CalcAddressXY(x * stretch + stretchX + 1, y * stretch + stretchY);
-                        SetAddress(address);
-#else
-                        address = CalcAddressXY(x * stretch + stretchX + 1 + left, y * stretch + stretchY + top);
-                        SetAddress(address);
-#endif
-                    } else
-#endif
-                        WritePixel(_color);
-                }
+        case 8:
+            while (count--)
+                *pLine++ = pPallete[*pData++];
+            break;
+    }
+}
 
-                // Shift to the next pixel
-                mask >>= 1;
+/*********************************************************************
+ * Function: static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip)
+ *
+ * PreCondition: none
+ *
+ * Input: pLine - image pixels, stretched in place, width - screen pixels,
+ *        stretch - image stretch factor, skip - copies of the first
+ *        pixel clipped away
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: repeats each pixel stretch times, from the end of the line
+ *           so that no pixel is overwritten before it is copied
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void StretchLine(WORD *pLine, WORD width, BYTE stretch, BYTE skip) {
+    WORD src = (width - 1 + skip) / stretch;
+    BYTE copies = (width - 1 + skip) % stretch + 1;
+
+    while (width) {
+        pLine[--width] = pLine[src];
+        if (--copies == 0) {
+            src--;
+            copies = stretch;
+        }
+    }
+}
+
+/*********************************************************************
+ * Function: static void WriteLine(WORD *pLine, WORD count, SHORT x, SHORT y)
+ *
+ * PreCondition: address of the first pixel set, chip select enabled
+ *
+ * Input: pLine - pixels, count - number of pixels,
+ *        x,y - coordinates used for the address of the first pixel
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: writes the pixels with a loop unrolled by 8. The transparent
+ *           pixels are skipped, setting the address of the next opaque one.
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void WriteLine(WORD *pLine, WORD count, SHORT x, SHORT y) {
+    WORD n;
+
+#ifdef USE_TRANSPARENT_COLOR
+    if (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE) {
+        n = 0;
+        while (n < count) {
+            if (pLine[n] != GetTransparentColor()) {
+                WritePixel(pLine[n]);
+                n++;
+                continue;
             }
+            while (++n < count && pLine[n] == GetTransparentColor())
+                ;
+            if (n < count)
+                SetAddress(CalcAddressXY(x + n, y));
         }
-        DisplayDisable();
+        return;
     }
-#ifdef USE_WINDOWADDRESS
-    DispDisableWindow();
 #endif
+#define LinePixel(i) WritePixel(pLine[i])
+    for (n = count >> 3; n; n--, pLine += 8) {
+        LinePixel(0); LinePixel(1); LinePixel(2); LinePixel(3);
+        LinePixel(4); LinePixel(5); LinePixel(6); LinePixel(7);
+    }
+    for (n = count & 7; n; n--, pLine++) {
+        LinePixel(0);
+    }
+#undef LinePixel
 }
 
+// Image read by PutImageLines(), in flash or in external memory
+typedef struct {
+    FLASH_BYTE *pFlash;             // Image in flash, NULL for external memory
+    void *bitmap;                   // Image in external memory
+#ifdef USE_BITMAP_RLE
+    DWORD offset;                   // Offset of the next RLE byte not buffered
+    WORD pos, len;                  // Next byte and bytes in buffer
+    BYTE buffer[RLE_READ_BUFFER];   // RLE bytes read ahead from external memory
+#endif
+} IMAGE_READER;
+
 /*********************************************************************
- * Function: void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static void ImageRead(IMAGE_READER *pImage, DWORD offset,
+ *                                 WORD nCount, void *buffer)
  *
  * PreCondition: none
  *
- * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ * Input: pImage - image, offset - first byte, nCount - number of bytes,
+ *        buffer - destination
  *
  * Output: none
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: reads bytes of an image in flash or in external memory
  *
- * Note: image must be located in external memory
+ * Note: none
  *
  ********************************************************************/
-void PutImage4BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch) {
-    register DWORD memOffset;
-#ifndef USE_WINDOWADDRESS
-    DWORD address;
-#endif
-    BITMAP_HEADER bmp;
-    WORD pallete[16];
-    BYTE lineBuffer[((GetMaxX() + 1) / 2) + 1];
-    BYTE *pData;
-    SHORT byteWidth;
+static void ImageRead(IMAGE_READER *pImage, DWORD offset, WORD nCount, void *buffer) {
+#ifdef USE_BITMAP_FLASH
+    if (pImage->pFlash != NULL) {
+        FLASH_BYTE *pData = pImage->pFlash + offset;
+        BYTE *pDest = buffer;
 
-    BYTE temp = 0;
-    WORD sizeX, sizeY;
-    WORD x, y;
-    BYTE stretchX, stretchY;
+        while (nCount--)
+            *pDest++ = *pData++;
+        return;
+    }
+#endif
+#if defined(USE_BITMAP_EXTERNAL) || defined(USE_BITMAP_SD)
+    ExternalMemoryCallback(pImage->bitmap, offset, nCount, buffer);
+#endif
+}
 
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
+#ifdef USE_BITMAP_RLE
 
-    // Get pallete (16 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 16 * sizeof (WORD), pallete);
+/*********************************************************************
+ * Function: static BYTE RleGetByte(IMAGE_READER *pImage)
+ *
+ * PreCondition: RleSeek() called
+ *
+ * Input: pImage - image
+ *
+ * Output: next byte of the RLE rows
+ *
+ * Side Effects: none
+ *
+ * Overview: reads the RLE rows sequentially, RLE_READ_BUFFER bytes at a
+ *           time from external memory
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static BYTE RleGetByte(IMAGE_READER *pImage) {
+#ifdef USE_BITMAP_FLASH
+    if (pImage->pFlash != NULL)
+        return (pImage->pFlash[pImage->offset++]);
+#endif
+    if (pImage->pos == pImage->len) {
+        ImageRead(pImage, pImage->offset, RLE_READ_BUFFER, pImage->buffer);
+        pImage->offset += RLE_READ_BUFFER;
+        pImage->pos = 0;
+        pImage->len = RLE_READ_BUFFER;
+    }
+    return (pImage->buffer[pImage->pos++]);
+}
 
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 16 * sizeof (WORD);
+/*********************************************************************
+ * Function: static void RleDecodeLine(IMAGE_READER *pImage, BYTE colorDepth,
+ *                                     WORD *pPallete, WORD width, WORD first,
+ *                                     WORD count, WORD *pLine)
+ *
+ * PreCondition: RleSeek() called, or the previous row decoded
+ *
+ * Input: pImage - image, colorDepth - 1, 4, 8 or 16 bits per pixel,
+ *        pPallete - image pallete, width - image width,
+ *        first - first image column, count - number of pixels,
+ *        pLine - line buffer
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: decodes the next row. Only the columns first to
+ *           first + count - 1 are converted to colors; a run fills its
+ *           part of them with one color.
+ *
+ * Note: none
+ *
+ ********************************************************************/
+static void RleDecodeLine(IMAGE_READER *pImage, BYTE colorDepth, WORD *pPallete, WORD width, WORD first, WORD count, WORD *pLine) {
+    WORD x = 0, end = first + count;
+    WORD n, from, to;
+    WORD color = 0;
+    BYTE control, index = 0, temp = 0, mask;
+
+    while (x < width) {
+        control = RleGetByte(pImage);
+        n = (control & 0x7F) + 1;
+        if (control & 0x80) {
+            // Run of one pixel
+            if (colorDepth == 16) {
+                color = RleGetByte(pImage);
+                color |= (WORD) RleGetByte(pImage) << 8;
+            } else {
+                index = RleGetByte(pImage);
+                if (count)
+                    color = pPallete[index];
+            }
+            from = (x > first) ? x : first;
+            to = (x + n < end) ? x + n : end;
+            for (; from < to; from++)
+                pLine[from - first] = color;
+            x += n;
+            continue;
+        }
 
-    // Line width in bytes
-    byteWidth = bmp.width >> 1;
-    if (bmp.width & 0x0001)
-        byteWidth++;
+        // Literal pixels, packed as in an uncompressed line
+        for (mask = 0; n; n--, x++) {
+            switch (colorDepth) {
+                case 1:
+                    if (mask == 0) {
+                        temp = RleGetByte(pImage);
+                        mask = 0x80;
+                    }
+                    index = (temp & mask) ? 1 : 0;
+                    mask >>= 1;
+                    break;
 
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
+                case 4:
+                    // First pixel in the low nibble
+                    if (mask == 0) {
+                        temp = RleGetByte(pImage);
+                        index = temp & 0x0f;
+                        mask = 0xf0;
+                    } else {
+                        index = temp >> 4;
+                        mask = 0;
+                    }
+                    break;
 
-#ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
-#endif
-    SetAddress(0);
+                case 8:
+                    index = RleGetByte(pImage);
+                    break;
 
-    for (y = 0; y < sizeY; y++) {
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-        memOffset += byteWidth;
-        DisplayEnable();
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-#ifndef USE_WINDOWADDRESS
-            address = CalcAddressXY(left, top + y * stretch + stretchY);
-            SetAddress(address);
-#endif
-            for (x = 0; x < sizeX; x++) {
-                // Read 2 pixels from flash
-                if (x & 0x0001) {
-                    // second pixel in byte
-                    SetColor(pallete[temp >> 4]);
-                } else {
-                    temp = *pData++;
-                    // first pixel in byte
-                    SetColor(pallete[temp & 0x0f]);
-                }
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-#ifdef USE_TRANSPARENT_COLOR
-                    if ((GetTransparentColor() == _color) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)) {
-#ifdef USE_WINDOWADDRESS
-                        address = CalcAddressXY(x * stretch + stretchX + 1, y * stretch + stretchY);
-                        SetAddress(address);
-#else
-                        address = CalcAddressXY(x * stretch + stretchX + 1 + left, y * stretch + stretchY + top);
-                        SetAddress(address);
-#endif
-                    } else
-#endif
-                        WritePixel(_color);
-                }
+                default:
+                    color = RleGetByte(pImage);
+                    color |= (WORD) RleGetByte(pImage) << 8;
+                    break;
             }
+            if (x >= first && x < end)
+                pLine[x - first] = (colorDepth == 16) ? color : pPallete[index];
         }
-        DisplayDisable();
     }
-#ifdef USE_WINDOWADDRESS
-    DispDisableWindow();
-#endif
 }
 
 /*********************************************************************
- * Function: void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static void RleSeek(IMAGE_READER *pImage, BITMAP_HEADER *pBmp,
+ *                               WORD tableOffset, WORD row)
  *
  * PreCondition: none
  *
- * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ * Input: pImage - image, pBmp - image header, tableOffset - offset of
+ *        the row step, after the pallete, row - row to read next
  *
  * Output: none
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: starts reading at the skip table entry before row, then
+ *           decodes and drops the rows up to it
  *
- * Note: image must be located in external memory
+ * Note: none
+ *
+ ********************************************************************/
+static void RleSeek(IMAGE_READER *pImage, BITMAP_HEADER *pBmp, WORD tableOffset, WORD row) {
+    WORD rowStep;
+    DWORD rowOffset;
+
+    ImageRead(pImage, tableOffset, sizeof (WORD), &rowStep);
+    ImageRead(pImage, tableOffset + sizeof (WORD) + (row / rowStep) * sizeof (DWORD), sizeof (DWORD), &rowOffset);
+    pImage->offset = rowOffset;
+    pImage->pos = pImage->len = 0;
+    for (row %= rowStep; row; row--)
+        RleDecodeLine(pImage, pBmp->colorDepth, NULL, pBmp->width, 0, 0, NULL);
+}
+#endif // USE_BITMAP_RLE
+
+/*********************************************************************
+ * Function: static void PutImageLines(SHORT left, SHORT top, IMAGE_READER *pImage, BYTE stretch,
+ *                                     SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, pImage - image,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs the part of an image of any color depth. The part is
+ *           clipped once and, with USE_WINDOWADDRESS, its window set once.
+ *           Each line is read, converted to colors and stretched in a
+ *           line buffer, then written stretch times. The lines of an RLE
+ *           image are decoded from the skip table entry before the part.
+ *
+ * Note: none
  *
  ********************************************************************/
-void PutImage8BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch) {
+static void PutImageLines(SHORT left, SHORT top, IMAGE_READER *pImage, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
     register DWORD memOffset;
-#ifndef USE_WINDOWADDRESS
-    DWORD address;
-#endif
     BITMAP_HEADER bmp;
+    IMAGE_CLIP clip;
     WORD pallete[256];
-    BYTE lineBuffer[(GetMaxX() + 1)];
-    BYTE *pData;
-
-    BYTE temp;
-    WORD sizeX, sizeY; // TODO: rimuovere volatile
-    WORD x, y;
-    BYTE stretchX, stretchY;
+    BYTE byteBuffer[(GetMaxX() + 1)];
+    WORD lineBuffer[(GetMaxX() + 1)];
+    DWORD byteWidth;
+    WORD colors, column, firstByte, readWidth;
+    WORD count;
+    SHORT y;
+    BYTE copies;
 
     // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-    // Get pallete (256 entries)
-    ExternalMemoryCallback(bitmap, sizeof (BITMAP_HEADER), 256 * sizeof (WORD), pallete);
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER) + 256 * sizeof (WORD);
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
+    ImageRead(pImage, 0, sizeof (BITMAP_HEADER), &bmp);
+    if (!ClipImagePartial(bmp.width, bmp.height, &xoffset, &yoffset, &width, &height))
+        return;
+    if (!ClipImage(left, top, width, height, stretch, &clip))
+        return;
+
+    // Get pallete
+    colors = (bmp.colorDepth == 16) ? 0 : 1 << bmp.colorDepth;
+    if (colors)
+        ImageRead(pImage, sizeof (BITMAP_HEADER), colors * sizeof (WORD), pallete);
+
+    // Line width in bytes, and bytes holding the columns drawn
+    column = xoffset + clip.x;
+    byteWidth = ((DWORD) bmp.width * bmp.colorDepth + 7) >> 3;
+    firstByte = ((DWORD) column * bmp.colorDepth) >> 3;
+    readWidth = ((((DWORD) column + clip.columns) * bmp.colorDepth + 7) >> 3) - firstByte;
+
+    // Set offset to the first line drawn
+    memOffset = sizeof (BITMAP_HEADER) + colors * sizeof (WORD);
+#ifdef USE_BITMAP_RLE
+    if (bmp.compression == BITMAP_COMP_RLE)
+        RleSeek(pImage, &bmp, memOffset, yoffset + clip.y);
+#endif
+    memOffset += (DWORD) (yoffset + clip.y) * byteWidth + firstByte;
+
+    count = clip.right - clip.left + 1;
+    copies = stretch - clip.skipY;
+
 #ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch, top + sizeY * stretch);
-#endif
+    DispEnableWindow(clip.left, clip.top, clip.right, clip.bottom);
     SetAddress(0);
-    for (y = 0; y < sizeY; y++) {
+#endif
+
+    for (y = clip.top; y <= clip.bottom; ) {
         // Get line
-        ExternalMemoryCallback(bitmap, memOffset, sizeX, lineBuffer);
-        memOffset += sizeX;
+#ifdef USE_BITMAP_RLE
+        if (bmp.compression == BITMAP_COMP_RLE) {
+            RleDecodeLine(pImage, bmp.colorDepth, pallete, bmp.width, column, clip.columns, lineBuffer);
+        } else
+#endif
+        if (colors) {
+            ImageRead(pImage, memOffset, readWidth, byteBuffer);
+            ExpandLine(byteBuffer, bmp.colorDepth, column, clip.columns, pallete, lineBuffer);
+        } else {
+            ImageRead(pImage, memOffset, readWidth, lineBuffer);
+        }
+        memOffset += byteWidth;
+        if (stretch > 1)
+            StretchLine(lineBuffer, count, stretch, clip.skipX);
+
+        // Write line to screen
         DisplayEnable();
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-#ifndef USE_WINDOWADDRESS
-            // Set start address
-            address = CalcAddressXY(left, top + y * stretch + stretchY);
-            SetAddress(address);
-#endif
-            for (x = 0; x < sizeX; x++) {
-                temp = *pData++;
-                SetColor(pallete[temp]);
-                
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-#ifdef USE_TRANSPARENT_COLOR
-                    if ((GetTransparentColor() == _color) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)) {
+        do {
 #ifdef USE_WINDOWADDRESS
-                        address = CalcAddressXY(x * stretch + stretchX + 1, y * stretch + stretchY);
-                        SetAddress(address);
+            WriteLine(lineBuffer, count, 0, y - clip.top);
 #else
-                        address = CalcAddressXY(x * stretch + stretchX + 1 + left, y * stretch + stretchY + top);
-                        SetAddress(address);
+            SetAddress(CalcAddressXY(clip.left, y));
+            WriteLine(lineBuffer, count, clip.left, y);
 #endif
-                    } else
-#endif
-                        WritePixel(_color);
-                }
-            }
-        }
+            y++;
+        } while (--copies && y <= clip.bottom);
         DisplayDisable();
+        copies = stretch;
     }
 #ifdef USE_WINDOWADDRESS
     DispDisableWindow();
 #endif
 }
 
+#if defined(USE_BITMAP_FLASH) && defined(USE_BITMAP_RLE)
+
 /*********************************************************************
- * Function: void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch)
+ * Function: static void PutImageFlash(SHORT left, SHORT top, FLASH_BYTE* bitmap, BYTE stretch,
+ *                                     SHORT xoffset, SHORT yoffset, WORD width, WORD height)
  *
  * PreCondition: none
  *
  * Input: left,top - left top image corner, bitmap - image pointer,
- *        stretch - image stretch factor
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
  *
  * Output: none
  *
  * Side Effects: none
  *
- * Overview: outputs monochrome image starting from left,top coordinates
+ * Overview: outputs an RLE image of any color depth
  *
- * Note: image must be located in external memory
+ * Note: image must be located in flash
  *
  ********************************************************************/
-void PutImage16BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch) {
-    register DWORD memOffset;
-#ifndef USE_WINDOWADDRESS
-    volatile DWORD address;
+static void PutImageFlash(SHORT left, SHORT top, FLASH_BYTE *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    IMAGE_READER image;
+
+    image.pFlash = bitmap;
+    image.bitmap = NULL;
+    PutImageLines(left, top, &image, stretch, xoffset, yoffset, width, height);
+}
 #endif
-    BITMAP_HEADER bmp;
-    WORD lineBuffer[(GetMaxX() + 1)];
-    WORD *pData;
-    WORD byteWidth;
 
-    WORD temp;
-    WORD sizeX, sizeY;
-    WORD x, y;
-    BYTE stretchX, stretchY;
+#if defined(USE_BITMAP_EXTERNAL) || defined(USE_BITMAP_SD)
 
-    // Get bitmap header
-    ExternalMemoryCallback(bitmap, 0, sizeof (BITMAP_HEADER), &bmp);
-    // Set offset to the image data
-    memOffset = sizeof (BITMAP_HEADER);
-    // Get size
-    sizeX = bmp.width;
-    sizeY = bmp.height;
-#ifdef USE_WINDOWADDRESS
-    DispEnableWindow(left, top, left + sizeX * stretch - 1, top + sizeY * stretch - 1);
-#endif
-    SetAddress(0);
-    byteWidth = sizeX << 1;
-    for (y = 0; y < sizeY; y++) {
-        // Get line
-        ExternalMemoryCallback(bitmap, memOffset, byteWidth, lineBuffer);
-        memOffset += byteWidth;
-        DisplayEnable();
-        for (stretchY = 0; stretchY < stretch; stretchY++) {
-            pData = lineBuffer;
-#ifndef USE_WINDOWADDRESS
-            address = CalcAddressXY(left, top + y * stretch + stretchY);
-            SetAddress(address);
-#endif
-            for (x = 0; x < sizeX; x++) {
-                temp = *pData++;
-                SetColor(temp);
-                // Write pixel to screen
-                for (stretchX = 0; stretchX < stretch; stretchX++) {
-#ifdef USE_TRANSPARENT_COLOR
-                    if ((GetTransparentColor() == temp) && (GetTransparentColorStatus() == TRANSPARENT_COLOR_ENABLE)) {
-#ifdef USE_WINDOWADDRESS
-                        address = CalcAddressXY(x * stretch + stretchX + 1, y * stretch + stretchY);
-                        SetAddress(address);
-#else
-                        address = CalcAddressXY(x * stretch + stretchX + 1 + left, y * stretch + stretchY + top);
-                        SetAddress(address);
-#endif
-                    } else
-#endif
-                        WritePixel(_color);
-                }
-            }
-        }
-        DisplayDisable();
-    }
-#ifdef USE_WINDOWADDRESS
-    DispDisableWindow();
-#endif
+/*********************************************************************
+ * Function: static void PutImageExt(SHORT left, SHORT top, void* bitmap, BYTE stretch,
+ *                                   SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs the part of an uncompressed or RLE image of any
+ *           color depth
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+static void PutImageExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    IMAGE_READER image;
+
+    image.pFlash = NULL;
+    image.bitmap = bitmap;
+    PutImageLines(left, top, &image, stretch, xoffset, yoffset, width, height);
+}
+
+/*********************************************************************
+ * Function: void PutImage1BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch,
+ *                                SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs monochrome image starting from left,top coordinates.
+ *           Only the bytes holding the part are read, one line at a time.
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage1BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    PutImageExt(left, top, bitmap, stretch, xoffset, yoffset, width, height);
+}
+
+/*********************************************************************
+ * Function: void PutImage4BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch,
+ *                                SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs 16 color image starting from left,top coordinates.
+ *           Only the bytes holding the part are read, one line at a time.
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage4BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    PutImageExt(left, top, bitmap, stretch, xoffset, yoffset, width, height);
+}
+
+/*********************************************************************
+ * Function: void PutImage8BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch,
+ *                                SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs 256 color image starting from left,top coordinates.
+ *           Only the bytes holding the part are read, one line at a time.
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage8BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    PutImageExt(left, top, bitmap, stretch, xoffset, yoffset, width, height);
+}
+
+/*********************************************************************
+ * Function: void PutImage16BPPExt(SHORT left, SHORT top, void* bitmap, BYTE stretch,
+ *                                 SHORT xoffset, SHORT yoffset, WORD width, WORD height)
+ *
+ * PreCondition: none
+ *
+ * Input: left,top - left top image corner, bitmap - image pointer,
+ *        stretch - image stretch factor,
+ *        xoffset,yoffset,width,height - part of the image to draw
+ *
+ * Output: none
+ *
+ * Side Effects: none
+ *
+ * Overview: outputs hicolor image starting from left,top coordinates.
+ *           Only the pixels of the part are read, one line at a time.
+ *
+ * Note: image must be located in external memory
+ *
+ ********************************************************************/
+void PutImage16BPPExt(SHORT left, SHORT top, void *bitmap, BYTE stretch, SHORT xoffset, SHORT yoffset, WORD width, WORD height) {
+    PutImageExt(left, top, bitmap, stretch, xoffset, yoffset, width, height);
 }
 #endif // USE_BITMAP_EXTERNAL
+#endif
 //#endif // USE_DRV_PUTIMAGE
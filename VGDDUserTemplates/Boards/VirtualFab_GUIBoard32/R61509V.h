@@ -16,6 +16,9 @@
  *                                  Window address implementation
  * VirtualFab           2011/07/15  Implementation of TRANSPARENT_COLOR
  * VirtualFab           2013/02/10  Integration for VGDD MplabX Wizard
+ * VirtualFab           2026/10/17  RLE compressed images (USE_BITMAP_RLE)
+ * VirtualFab           2026/10/17  DMA command queue (R61509V_DMA_CHANNEL)
+ * VirtualFab           2026/10/17  GFX_DRV_GETPIXEL
  *****************************************************************************/
 #ifndef _R61509V_H
     #define _R61509V_H
@@ -61,6 +64,26 @@
 // Define this to implement PutImage function in the driver.
     #define USE_DRV_PUTIMAGE
 
+/*********************************************************************
+* Overview: Command queue on a DMA channel (PIC32 with USE_GFX_PMP).
+*           Define R61509V_DMA_CHANNEL (0 to 7) in HardwareProfile.h to
+*           enable it. Bar() and ClearDevice() fills, and with the 16 bit
+*           PMP the 16 bpp flash images drawn without stretch or
+*           transparency, are queued: the DMA interrupt sets the GRAM
+*           address of each line and the channel writes its pixels, while
+*           the CPU goes on. IsDeviceBusy() returns the commands queued.
+*           With USE_NONBLOCKING_CONFIG, Bar() and PutImage() return 0
+*           while the queue is full; the functions that use the CPU wait
+*           for the queue to empty.
+*           R61509V_QUEUE_SIZE sets the commands queued (default 8),
+*           R61509V_DMA_BLOCK the pixels of each DMA block (default 256);
+*           the block must fit the DMA size registers, 255 bytes on
+*           PIC32MX3xx/4xx.
+*********************************************************************/
+//#define R61509V_DMA_CHANNEL 2
+//#define R61509V_QUEUE_SIZE  8
+//#define R61509V_DMA_BLOCK   256
+
     #ifndef DISP_HOR_RESOLUTION
         //error DISP_HOR_RESOLUTION must be defined in HardwareProfile.h
     #endif
@@ -105,6 +128,31 @@
 #define CLIP_DISABLE                0   // Disables clipping.
 #define CLIP_ENABLE                 1   // Enables clipping.
 
+/*********************************************************************
+* Overview: RLE compressed images in flash and external memory, drawn
+*           by PutImagePartial() and PutImage*Ext() when USE_BITMAP_RLE
+*           is defined. HostSim/ImgRle.c makes them from uncompressed
+*           images. The bytes of an RLE image are:
+*
+*           BITMAP_HEADER   compression is BITMAP_COMP_RLE
+*           WORD[]          pallete, none for 16 bpp
+*           WORD            rows between two skip table entries
+*           DWORD[]         skip table, offsets from the image start of
+*                           the rows 0, step, 2 * step...
+*           rows            each coded alone as packets. A control byte
+*                           n < 0x80 is followed by n + 1 pixels, packed
+*                           as in an uncompressed line. A control byte
+*                           n >= 0x80 is followed by one pixel repeated
+*                           (n & 0x7F) + 1 times: a pallete index byte or
+*                           a little endian color.
+*********************************************************************/
+#define BITMAP_COMP_NONE            0       // Uncompressed image
+#define BITMAP_COMP_RLE             0x80    // RLE image, not a value of the Graphics Resource Converter
+
+#if defined(USE_BITMAP_RLE) && !defined(RLE_READ_BUFFER)
+#define RLE_READ_BUFFER             64      // Bytes of an RLE image read at a time from external memory
+#endif
+
 #ifdef USE_TRANSPARENT_COLOR
 #define TRANSPARENT_COLOR_ENABLE    1   // Check pixel if color is equal to transparent color, if equal do not render pixel
 #define TRANSPARENT_COLOR_DISABLE   0   // Check of transparent color is not performed
@@ -392,6 +440,9 @@ void    PutPixel(SHORT x, SHORT y);
 ********************************************************************/
 WORD    GetPixel(SHORT x, SHORT y);
 
+// GetPixel() reads the GRAM back, e.g. for SuperGauge SG_DIAL_CACHE
+#define GFX_DRV_GETPIXEL
+
 /*********************************************************************
 * Macros: SetClipRgn(left, top, right, bottom)
 *